@@ -358,17 +358,14 @@ std::vector<Action *> GetActionListInfo(chip::EndpointId parentId)
 }
 
 namespace {
-void CallReportingCallback(intptr_t closure)
-{
-    auto path = reinterpret_cast<app::ConcreteAttributePath *>(closure);
-    MatterReportingAttributeChangeCallback(*path);
-    Platform::Delete(path);
-}
-
 void ScheduleReportingCallback(Device * dev, ClusterId cluster, AttributeId attribute)
 {
-    auto * path = Platform::New<app::ConcreteAttributePath>(dev->GetEndpointId(), cluster, attribute);
-    PlatformMgr().ScheduleWork(CallReportingCallback, reinterpret_cast<intptr_t>(path));
+    // Device changes are notified from the polling thread, which does not hold the stack lock.
+    CHIP_ERROR err = MatterReportingAttributeChangeCallbackFromAnyThread(dev->GetEndpointId(), cluster, attribute);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DeviceLayer, "Failed to report attribute change: %" CHIP_ERROR_FORMAT, err.Format());
+    }
 }
 } // anonymous namespace
 
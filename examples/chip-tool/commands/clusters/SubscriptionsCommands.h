@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <app/FleetSubscriptionManager.h>
 #include <lib/core/CHIPError.h>
 
 #include <commands/common/CHIPCommand.h>
@@ -94,6 +95,134 @@ public:
 private:
 };
 
+class SubscribeFleet : public CHIPCommand, public chip::app::FleetSubscriptionManager::Delegate
+{
+public:
+    SubscribeFleet(CredentialIssuerCommands * credsIssuerConfig) :
+        CHIPCommand("subscribe-fleet", credsIssuerConfig,
+                    "Subscribe to an attribute of a range of nodes with consecutive node ids, and report how fast the "
+                    "subscriptions are established and how many reports they deliver.")
+    {
+        AddArgument("first-node-id", 0, UINT64_MAX, &mFirstNodeId,
+                    "The node id of the first node, scoped to the commissioner name the command is running under.");
+        AddArgument("node-count", 1, UINT32_MAX, &mNodeCount, "The number of nodes to subscribe to.");
+        AddArgument("endpoint-id", 0, UINT16_MAX, &mEndpointId);
+        AddArgument("cluster-id", 0, UINT32_MAX, &mClusterId);
+        AddArgument("attribute-id", 0, UINT32_MAX, &mAttributeId);
+        AddArgument("min-interval", 0, UINT16_MAX, &mMinInterval,
+                    "Server should not send a new report if less than this number of seconds has elapsed since the last report.");
+        AddArgument("max-interval", 0, UINT16_MAX, &mMaxInterval,
+                    "Server must send a report if this number of seconds has elapsed since the last report.");
+        AddArgument("max-concurrent", 1, UINT16_MAX, &mMaxConcurrent,
+                    "The maximum number of subscriptions being established at the same time. Defaults to 8.");
+        AddArgument("duration", 1, UINT16_MAX - kExtraWaitDuration, &mDuration,
+                    "How long to keep the subscriptions, in seconds, before reporting the throughput. Defaults to 60.");
+    }
+
+    /////////// CHIPCommand Interface /////////
+    CHIP_ERROR RunCommand() override
+    {
+        chip::app::AttributePathParams path(mEndpointId, mClusterId, mAttributeId);
+
+        chip::app::FleetSubscriptionManager::Parameters params;
+        params.attributePaths            = &path;
+        params.attributePathCount        = 1;
+        params.minIntervalFloorSeconds   = mMinInterval;
+        params.maxIntervalCeilingSeconds = mMaxInterval;
+        params.cacheData                 = false;
+        if (mMaxConcurrent.HasValue())
+        {
+            params.maxConcurrentEstablishments = mMaxConcurrent.Value();
+        }
+        ReturnErrorOnFailure(mManager.Init(CurrentCommissioner().ExchangeMgr(), *this, params));
+
+        mStartTime          = chip::System::SystemClock().GetMonotonicTimestamp();
+        mAllEstablishedTime = chip::System::Clock::kZero;
+        for (uint32_t i = 0; i < mNodeCount; i++)
+        {
+            ReturnErrorOnFailure(mManager.AddNode(chip::ScopedNodeId(mFirstNodeId + i, CurrentCommissioner().GetFabricIndex())));
+        }
+
+        return chip::DeviceLayer::SystemLayer().StartTimer(chip::System::Clock::Seconds16(mDuration.ValueOr(kDefaultDuration)),
+                                                           OnDurationElapsed, this);
+    }
+
+    chip::System::Clock::Timeout GetWaitDuration() const override
+    {
+        return chip::System::Clock::Seconds16(static_cast<uint16_t>(mDuration.ValueOr(kDefaultDuration) + kExtraWaitDuration));
+    }
+
+    void Shutdown() override
+    {
+        chip::DeviceLayer::SystemLayer().CancelTimer(OnDurationElapsed, this);
+        mManager.Shutdown();
+        mNodesGivenUp = 0;
+        CHIPCommand::Shutdown();
+    }
+
+    /////////// FleetSubscriptionManager::Delegate Interface /////////
+    void OnSubscriptionEstablished(const chip::ScopedNodeId & node, chip::SubscriptionId subscriptionId) override
+    {
+        const auto & stats = mManager.GetStats();
+        if (mAllEstablishedTime == chip::System::Clock::kZero && stats.active == stats.nodes)
+        {
+            mAllEstablishedTime = chip::System::SystemClock().GetMonotonicTimestamp();
+        }
+    }
+
+    void OnSubscriptionDone(const chip::ScopedNodeId & node, CHIP_ERROR error) override
+    {
+        ChipLogError(chipTool, "Giving up on subscribing to " ChipLogFormatScopedNodeId ": %" CHIP_ERROR_FORMAT,
+                     ChipLogValueScopedNodeId(node), error.Format());
+        mNodesGivenUp++;
+    }
+
+private:
+    static constexpr uint16_t kDefaultDuration   = 60;
+    static constexpr uint16_t kExtraWaitDuration = 10;
+
+    static void OnDurationElapsed(chip::System::Layer * layer, void * context)
+    {
+        auto * command = static_cast<SubscribeFleet *>(context);
+        command->LogThroughput();
+        command->mManager.Shutdown();
+        command->SetCommandExitStatus(command->mNodesGivenUp == 0 ? CHIP_NO_ERROR : CHIP_ERROR_NOT_CONNECTED);
+    }
+
+    void LogThroughput()
+    {
+        const auto & stats      = mManager.GetStats();
+        bool allEstablished     = mAllEstablishedTime != chip::System::Clock::kZero;
+        auto now                = chip::System::SystemClock().GetMonotonicTimestamp();
+        auto establishedTime    = allEstablished ? mAllEstablishedTime : now;
+        double elapsedSecs      = static_cast<double>((now - mStartTime).count()) / 1000;
+        double establishingSecs = static_cast<double>((establishedTime - mStartTime).count()) / 1000;
+
+        ChipLogProgress(chipTool, "Fleet of %u nodes: %u subscribed, %u given up", static_cast<unsigned>(mNodeCount),
+                        static_cast<unsigned>(stats.active), static_cast<unsigned>(mNodesGivenUp));
+        ChipLogProgress(chipTool, "  %" PRIu32 " subscriptions established in %.3fs (%.1f/s), %" PRIu32 " lost%s",
+                        stats.established, establishingSecs, establishingSecs > 0 ? stats.established / establishingSecs : 0.0,
+                        stats.lost, allEstablished ? "" : ", not all nodes subscribed");
+        ChipLogProgress(chipTool, "  %" PRIu32 " reports (%.1f/s) carrying %" PRIu32 " attribute reports over %.3fs",
+                        stats.reports, elapsedSecs > 0 ? stats.reports / elapsedSecs : 0.0, stats.attributes, elapsedSecs);
+    }
+
+    chip::NodeId mFirstNodeId;
+    uint32_t mNodeCount;
+    chip::EndpointId mEndpointId;
+    chip::ClusterId mClusterId;
+    chip::AttributeId mAttributeId;
+    uint16_t mMinInterval;
+    uint16_t mMaxInterval;
+    chip::Optional<uint16_t> mMaxConcurrent;
+    chip::Optional<uint16_t> mDuration;
+
+    chip::app::FleetSubscriptionManager mManager;
+    chip::System::Clock::Timestamp mStartTime;
+    chip::System::Clock::Timestamp mAllEstablishedTime;
+    uint32_t mNodesGivenUp = 0;
+};
+
 void registerCommandsSubscriptions(Commands & commands, CredentialIssuerCommands * credsIssuerConfig)
 {
     const char * clusterName = "Subscriptions";
@@ -102,7 +231,8 @@ void registerCommandsSubscriptions(Commands & commands, CredentialIssuerCommands
         make_unique<ShutdownSubscription>(credsIssuerConfig),         //
         make_unique<ShutdownSubscriptionsForNode>(credsIssuerConfig), //
         make_unique<ShutdownAllSubscriptions>(credsIssuerConfig),     //
+        make_unique<SubscribeFleet>(credsIssuerConfig),               //
     };
 
-    commands.RegisterCommandSet(clusterName, clusterCommands, "Commands for shutting down subscriptions.");
+    commands.RegisterCommandSet(clusterName, clusterCommands, "Commands for managing subscriptions.");
 }
@@ -0,0 +1,158 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <ota-provider-common/BdxImageCache.h>
+
+#include <lib/support/CHIPMemString.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <system/SystemError.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+BdxImageCache::~BdxImageCache()
+{
+    for (auto & entry : mEntries)
+    {
+        Unmap(entry);
+    }
+}
+
+CHIP_ERROR BdxImageCache::Acquire(const char * path, chip::ByteSpan & image)
+{
+    VerifyOrReturnError(path != nullptr && strlen(path) < sizeof(Entry::path), CHIP_ERROR_INVALID_ARGUMENT);
+
+    struct stat fileStat;
+    VerifyOrReturnError(stat(path, &fileStat) == 0, CHIP_ERROR_POSIX(errno));
+
+    Entry * entry  = nullptr;
+    Entry * victim = nullptr;
+    for (auto & candidate : mEntries)
+    {
+        if (candidate.data != nullptr && strcmp(candidate.path, path) == 0)
+        {
+            entry = &candidate;
+            break;
+        }
+        if (candidate.refCount == 0 &&
+            (victim == nullptr || (victim->data != nullptr && (candidate.data == nullptr || candidate.lastUse < victim->lastUse))))
+        {
+            victim = &candidate;
+        }
+    }
+
+    // A file that changed since it was mapped is mapped again once no transfer uses the old content.
+    if (entry != nullptr && entry->refCount == 0 &&
+        (entry->size != static_cast<size_t>(fileStat.st_size) || entry->fileMtime != fileStat.st_mtime))
+    {
+        Unmap(*entry);
+        victim = entry;
+        entry  = nullptr;
+    }
+
+    if (entry == nullptr)
+    {
+        VerifyOrReturnError(victim != nullptr, CHIP_ERROR_NO_MEMORY);
+        Unmap(*victim);
+        ReturnErrorOnFailure(Map(path, *victim));
+        entry = victim;
+    }
+
+    entry->refCount++;
+    entry->lastUse = ++mUseCounter;
+    image          = chip::ByteSpan(entry->data, entry->size);
+    return CHIP_NO_ERROR;
+}
+
+void BdxImageCache::Release(const chip::ByteSpan & image)
+{
+    for (auto & entry : mEntries)
+    {
+        if (entry.data != nullptr && entry.data == image.data())
+        {
+            VerifyOrDie(entry.refCount > 0);
+            entry.refCount--;
+            return;
+        }
+    }
+}
+
+void BdxImageCache::Clear()
+{
+    for (auto & entry : mEntries)
+    {
+        if (entry.refCount == 0)
+        {
+            Unmap(entry);
+        }
+    }
+}
+
+CHIP_ERROR BdxImageCache::Map(const char * path, Entry & entry)
+{
+    int fd = open(path, O_RDONLY);
+    VerifyOrReturnError(fd >= 0, CHIP_ERROR_POSIX(errno));
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0)
+    {
+        CHIP_ERROR err = CHIP_ERROR_POSIX(errno);
+        close(fd);
+        return err;
+    }
+
+    // An empty file cannot be mapped, and is not an image anyway.
+    if (fileStat.st_size <= 0)
+    {
+        close(fd);
+        return CHIP_ERROR_INVALID_FILE_IDENTIFIER;
+    }
+
+    size_t size    = static_cast<size_t>(fileStat.st_size);
+    void * data    = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    CHIP_ERROR err = (data == MAP_FAILED) ? CHIP_ERROR_POSIX(errno) : CHIP_NO_ERROR;
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+    ReturnErrorOnFailure(err);
+
+    // Blocks are read in order, from the start offset to the end of the file.
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    chip::Platform::CopyString(entry.path, path);
+    entry.data      = static_cast<const uint8_t *>(data);
+    entry.size      = size;
+    entry.fileMtime = fileStat.st_mtime;
+    entry.refCount  = 0;
+
+    ChipLogProgress(BDX, "Mapped OTA image %s (%u bytes)", path, static_cast<unsigned>(size));
+    return CHIP_NO_ERROR;
+}
+
+void BdxImageCache::Unmap(Entry & entry)
+{
+    VerifyOrReturn(entry.data != nullptr);
+
+    munmap(const_cast<uint8_t *>(entry.data), entry.size);
+    entry.data    = nullptr;
+    entry.size    = 0;
+    entry.path[0] = '\0';
+}
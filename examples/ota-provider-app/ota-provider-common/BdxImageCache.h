@@ -0,0 +1,77 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/Span.h>
+#include <protocols/bdx/BdxMessages.h>
+
+#include <sys/types.h>
+#include <time.h>
+
+/**
+ * Read-only memory mappings of the OTA image files being served, shared by all the BDX transfers of the same file.
+ *
+ * A file is mapped by the first transfer that asks for it and stays mapped after the last transfer releases it, so that
+ * the next requestor does not map it again unless the file changed on disk.  Unreferenced mappings are evicted, least
+ * recently used first, when all the entries are taken.
+ *
+ * The image files must not be truncated while they are being transferred.
+ */
+class BdxImageCache
+{
+public:
+    static constexpr size_t kMaxImages = 4;
+
+    BdxImageCache() = default;
+    ~BdxImageCache();
+
+    BdxImageCache(const BdxImageCache &) = delete;
+    BdxImageCache & operator=(const BdxImageCache &) = delete;
+
+    /**
+     * Get the content of the file at `path`, mapping it if needed.  Every successful call must be matched by a call to
+     * Release() with the returned span.
+     */
+    CHIP_ERROR Acquire(const char * path, chip::ByteSpan & image);
+
+    void Release(const chip::ByteSpan & image);
+
+    // Unmap the images that are not being transferred.
+    void Clear();
+
+private:
+    friend class TestBdxImageCache;
+    friend class TestBdxOtaSender;
+
+    struct Entry
+    {
+        char path[chip::bdx::kMaxFileDesignatorLen];
+        const uint8_t * data = nullptr;
+        size_t size          = 0;
+        time_t fileMtime     = 0;
+        uint32_t refCount    = 0;
+        uint32_t lastUse     = 0;
+    };
+
+    static CHIP_ERROR Map(const char * path, Entry & entry);
+    static void Unmap(Entry & entry);
+
+    Entry mEntries[kMaxImages];
+    uint32_t mUseCounter = 0;
+};
@@ -19,12 +19,13 @@
 
 #include <lib/core/CHIPError.h>
 #include <lib/support/BitFlags.h>
-#include <lib/support/CHIPMemString.h>
+#include <lib/support/CodeUtils.h>
 #include <messaging/ExchangeContext.h>
 #include <messaging/Flags.h>
 #include <protocols/bdx/BdxTransferSession.h>
 
-#include <fstream>
+#include <algorithm>
+#include <inttypes.h>
 
 using chip::bdx::StatusCode;
 using chip::bdx::TransferControlFlags;
@@ -32,36 +33,186 @@ using chip::bdx::TransferSession;
 
 BdxOtaSender::BdxOtaSender()
 {
-    memset(mFileDesignator, 0, chip::bdx::kMaxFileDesignatorLen);
+    for (auto & transfer : mTransfers)
+    {
+        transfer.Init(&mImageCache);
+    }
 }
 
 CHIP_ERROR BdxOtaSender::InitializeTransfer(chip::FabricIndex fabricIndex, chip::NodeId nodeId)
 {
-    if (mInitialized)
+    mReservedTransfer = nullptr;
+
+    // Reset stale connection from the Same Node if exists
+    Transfer * transfer = nullptr;
+    for (auto & candidate : mTransfers)
     {
-        // Reset stale connection from the Same Node if exists
-        if ((mFabricIndex.HasValue() && mFabricIndex.Value() == fabricIndex) && (mNodeId.HasValue() && mNodeId.Value() == nodeId))
+        if (candidate.IsFor(fabricIndex, nodeId))
         {
-            Reset();
+            candidate.Reset();
+            transfer = &candidate;
+            break;
         }
-        // Prevent a new node connection since another is active
-        else if ((mFabricIndex.HasValue() && mFabricIndex.Value() != fabricIndex) ||
-                 (mNodeId.HasValue() && mNodeId.Value() != nodeId))
+    }
+
+    for (auto & candidate : mTransfers)
+    {
+        if (transfer == nullptr && !candidate.IsInUse())
         {
-            return CHIP_ERROR_BUSY;
+            transfer = &candidate;
         }
-        else
+    }
+
+    // Take over a transfer that its requestor never started.
+    const chip::System::Clock::Timestamp now = chip::System::SystemClock().GetMonotonicTimestamp();
+    for (auto & candidate : mTransfers)
+    {
+        if (transfer == nullptr && candidate.IsStale(now))
         {
-            return CHIP_ERROR_INTERNAL;
+            candidate.Reset();
+            transfer = &candidate;
         }
     }
-    mFabricIndex.SetValue(fabricIndex);
-    mNodeId.SetValue(nodeId);
-    mInitialized = true;
+
+    // Prevent a new node connection since all transfers are active
+    VerifyOrReturnError(transfer != nullptr, CHIP_ERROR_BUSY);
+
+    transfer->Reserve(fabricIndex, nodeId);
+    mReservedTransfer = transfer;
     return CHIP_NO_ERROR;
 }
 
-void BdxOtaSender::HandleTransferSessionOutput(TransferSession::OutputEvent & event)
+CHIP_ERROR BdxOtaSender::PrepareForTransfer(chip::System::Layer * layer, chip::bdx::TransferRole role,
+                                            chip::BitFlags<TransferControlFlags> xferControlOpts, uint16_t maxBlockSize,
+                                            chip::System::Clock::Timeout timeout, chip::System::Clock::Timeout pollFreq)
+{
+    VerifyOrReturnError(mReservedTransfer != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(role == chip::bdx::TransferRole::kSender, CHIP_ERROR_INVALID_ARGUMENT);
+
+    Transfer * transfer = mReservedTransfer;
+    mReservedTransfer   = nullptr;
+
+    xferControlOpts.Set(TransferControlFlags::kSenderDrive);
+    CHIP_ERROR err = transfer->Prepare(layer, xferControlOpts, maxBlockSize, timeout, pollFreq);
+    if (err != CHIP_NO_ERROR)
+    {
+        transfer->Reset();
+    }
+    return err;
+}
+
+size_t BdxOtaSender::GetActiveTransferCount() const
+{
+    return static_cast<size_t>(
+        std::count_if(std::begin(mTransfers), std::end(mTransfers), [](const Transfer & transfer) { return transfer.IsInUse(); }));
+}
+
+CHIP_ERROR BdxOtaSender::OnUnsolicitedMessageReceived(const chip::PayloadHeader & payloadHeader,
+                                                      chip::Messaging::ExchangeDelegate *& newDelegate)
+{
+    newDelegate = this;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR BdxOtaSender::OnMessageReceived(chip::Messaging::ExchangeContext * ec, const chip::PayloadHeader & payloadHeader,
+                                           chip::System::PacketBufferHandle && payload)
+{
+    Transfer * transfer = FindTransfer(ec);
+    if (transfer == nullptr)
+    {
+        // First message of the exchange: hand it to the transfer prepared for this peer.
+        const chip::ScopedNodeId peer = ec->GetSessionHandle()->GetPeer();
+        for (auto & candidate : mTransfers)
+        {
+            if (candidate.IsFor(peer.GetFabricIndex(), peer.GetNodeId()) && candidate.GetExchange() == nullptr)
+            {
+                transfer = &candidate;
+                break;
+            }
+        }
+        VerifyOrReturnError(transfer != nullptr, CHIP_ERROR_INCORRECT_STATE,
+                            ChipLogError(BDX, "No transfer prepared for " ChipLogFormatScopedNodeId,
+                                         ChipLogValueScopedNodeId(peer)));
+    }
+
+    return transfer->HandleMessage(ec, payloadHeader, std::move(payload));
+}
+
+void BdxOtaSender::OnResponseTimeout(chip::Messaging::ExchangeContext * ec)
+{
+    Transfer * transfer = FindTransfer(ec);
+    VerifyOrReturn(transfer != nullptr);
+    transfer->HandleResponseTimeout(ec);
+}
+
+void BdxOtaSender::OnExchangeClosing(chip::Messaging::ExchangeContext * ec)
+{
+    Transfer * transfer = FindTransfer(ec);
+    VerifyOrReturn(transfer != nullptr);
+    transfer->HandleExchangeClosing();
+}
+
+BdxOtaSender::Transfer * BdxOtaSender::FindTransfer(chip::Messaging::ExchangeContext * ec)
+{
+    for (auto & transfer : mTransfers)
+    {
+        if (transfer.IsInUse() && transfer.GetExchange() == ec)
+        {
+            return &transfer;
+        }
+    }
+    return nullptr;
+}
+
+void BdxOtaSender::Transfer::Reserve(chip::FabricIndex fabricIndex, chip::NodeId nodeId)
+{
+    mInUse       = true;
+    mFabricIndex = fabricIndex;
+    mNodeId      = nodeId;
+    mReserveTime = chip::System::SystemClock().GetMonotonicTimestamp();
+}
+
+CHIP_ERROR BdxOtaSender::Transfer::Prepare(chip::System::Layer * layer, chip::BitFlags<TransferControlFlags> xferControlOpts,
+                                           uint16_t maxBlockSize, chip::System::Clock::Timeout timeout,
+                                           chip::System::Clock::Timeout pollFreq)
+{
+    mTimeout = timeout;
+    return PrepareForTransfer(layer, chip::bdx::TransferRole::kSender, xferControlOpts, maxBlockSize, timeout, pollFreq);
+}
+
+CHIP_ERROR BdxOtaSender::Transfer::HandleMessage(chip::Messaging::ExchangeContext * ec, const chip::PayloadHeader & payloadHeader,
+                                                 chip::System::PacketBufferHandle && payload)
+{
+    chip::Messaging::ExchangeDelegate * facilitator = this;
+    CHIP_ERROR err                                  = facilitator->OnMessageReceived(ec, payloadHeader, std::move(payload));
+
+    // Respond right away rather than at the next poll; the poll timer is left to detect timeouts.
+    ProcessOutput();
+    return err;
+}
+
+void BdxOtaSender::Transfer::HandleResponseTimeout(chip::Messaging::ExchangeContext * ec)
+{
+    LogThroughput("timed out");
+
+    chip::Messaging::ExchangeDelegate * facilitator = this;
+    facilitator->OnResponseTimeout(ec);
+    Reset();
+}
+
+void BdxOtaSender::Transfer::HandleExchangeClosing()
+{
+    mExchangeCtx = nullptr;
+}
+
+void BdxOtaSender::Transfer::ProcessOutput()
+{
+    TransferSession::OutputEvent event;
+    mTransfer.PollOutput(event, chip::System::SystemClock().GetMonotonicTimestamp());
+    HandleTransferSessionOutput(event);
+}
+
+void BdxOtaSender::Transfer::HandleTransferSessionOutput(TransferSession::OutputEvent & event)
 {
     CHIP_ERROR err = CHIP_NO_ERROR;
 
@@ -73,126 +224,84 @@ void BdxOtaSender::HandleTransferSessionOutput(TransferSession::OutputEvent & ev
     switch (event.EventType)
     {
     case TransferSession::OutputEventType::kNone:
+        // In sender drive, the first block goes out once the ReceiveAccept is acknowledged, since the exchange cannot
+        // have two reliable messages in flight.
+        if (mFirstBlockPending && mExchangeCtx != nullptr && !mExchangeCtx->IsWaitingForAck())
+        {
+            mFirstBlockPending = false;
+            SendNextBlock();
+        }
         break;
     case TransferSession::OutputEventType::kMsgToSend: {
+        const bool isAccept      = event.msgTypeData.HasMessageType(chip::bdx::MessageType::ReceiveAccept);
+        const bool isSenderDrive = mTransfer.GetControlMode() == TransferControlFlags::kSenderDrive;
+
+        VerifyOrReturn(mExchangeCtx != nullptr);
         chip::Messaging::SendFlags sendFlags;
-        if (!event.msgTypeData.HasMessageType(chip::Protocols::SecureChannel::MsgType::StatusReport))
+        if (!event.msgTypeData.HasMessageType(chip::Protocols::SecureChannel::MsgType::StatusReport) &&
+            !mExchangeCtx->IsResponseExpected())
         {
             // All messages sent from the Sender expect a response, except for a StatusReport which would indicate an error and the
-            // end of the transfer.
+            // end of the transfer. In sender drive, the first block follows the ReceiveAccept and is acked in one response.
             sendFlags.Set(chip::Messaging::SendMessageFlags::kExpectResponse);
         }
-        VerifyOrReturn(mExchangeCtx != nullptr);
         err = mExchangeCtx->SendMessage(event.msgTypeData.ProtocolId, event.msgTypeData.MessageType, std::move(event.MsgData),
                                         sendFlags);
 
-        if (err == CHIP_NO_ERROR)
-        {
-            if (!sendFlags.Has(chip::Messaging::SendMessageFlags::kExpectResponse))
-            {
-                // After sending the StatusReport, exchange context gets closed so, set mExchangeCtx to null
-                mExchangeCtx = nullptr;
-            }
-        }
-        else
+        if (err != CHIP_NO_ERROR)
         {
             ChipLogError(BDX, "SendMessage failed: %" CHIP_ERROR_FORMAT, err.Format());
+            LogThroughput("failed");
             Reset();
         }
-
-        break;
-    }
-    case TransferSession::OutputEventType::kInitReceived: {
-        // TransferSession will automatically reject a transfer if there are no
-        // common supported control modes. It will also default to the smaller
-        // block size.
-        TransferSession::TransferAcceptData acceptData;
-        acceptData.ControlMode  = TransferControlFlags::kReceiverDrive; // OTA must use receiver drive
-        acceptData.MaxBlockSize = mTransfer.GetTransferBlockSize();
-        acceptData.StartOffset  = mTransfer.GetStartOffset();
-        acceptData.Length       = mTransfer.GetTransferLength();
-        VerifyOrReturn(mTransfer.AcceptTransfer(acceptData) == CHIP_NO_ERROR,
-                       ChipLogError(BDX, "AcceptTransfer failed: %" CHIP_ERROR_FORMAT, err.Format()));
-
-        // Store the file designator used during block query
-        uint16_t fdl       = 0;
-        const uint8_t * fd = mTransfer.GetFileDesignator(fdl);
-        VerifyOrReturn(fdl < chip::bdx::kMaxFileDesignatorLen,
-                       ChipLogError(BDX, "Cannot store file designator with length = %d", fdl));
-        memcpy(mFileDesignator, fd, fdl);
-        mFileDesignator[fdl] = 0;
-
-        break;
-    }
-    case TransferSession::OutputEventType::kQueryReceived: {
-        TransferSession::BlockData blockData;
-        uint16_t blockSize   = mTransfer.GetTransferBlockSize();
-        uint16_t bytesToRead = blockSize;
-
-        // TODO: This should be a utility function in TransferSession
-        if (mTransfer.GetTransferLength() > 0 && mNumBytesSent + blockSize > mTransfer.GetTransferLength())
+        else if (event.msgTypeData.HasMessageType(chip::Protocols::SecureChannel::MsgType::StatusReport))
         {
-            // cast should be safe because of condition above
-            bytesToRead = static_cast<uint16_t>(mTransfer.GetTransferLength() - mNumBytesSent);
-        }
-
-        chip::System::PacketBufferHandle blockBuf = chip::System::PacketBufferHandle::New(bytesToRead);
-        if (blockBuf.IsNull())
-        {
-            // TODO(#13981): AbortTransfer() needs to support GeneralStatusCode failures as well as BDX specific errors.
-            mTransfer.AbortTransfer(StatusCode::kUnknown);
-            return;
+            // The transfer is over after the StatusReport, free it for the next requestor.
+            LogThroughput("aborted");
+            Reset();
         }
-
-        std::ifstream otaFile(mFileDesignator, std::ifstream::in);
-        if (!otaFile.good())
+        else if (isAccept && isSenderDrive)
         {
-            ChipLogError(BDX, "OTA file open failed");
-            mTransfer.AbortTransfer(StatusCode::kFileDesignatorUnknown);
-            return;
-        }
-
-        otaFile.seekg(mNumBytesSent);
-        otaFile.read(reinterpret_cast<char *>(blockBuf->Start()), bytesToRead);
-        if (!(otaFile.good() || otaFile.eof()))
-        {
-            ChipLogError(BDX, "OTA file read failed");
-            mTransfer.AbortTransfer(StatusCode::kFileDesignatorUnknown);
-            return;
-        }
-
-        blockData.Data   = blockBuf->Start();
-        blockData.Length = static_cast<size_t>(otaFile.gcount());
-        blockData.IsEof  = (blockData.Length < blockSize) ||
-            (mNumBytesSent + static_cast<uint64_t>(blockData.Length) == mTransfer.GetTransferLength() || (otaFile.peek() == EOF));
-        mNumBytesSent = static_cast<uint32_t>(mNumBytesSent + blockData.Length);
-        otaFile.close();
-
-        err = mTransfer.PrepareBlock(blockData);
-        if (err != CHIP_NO_ERROR)
-        {
-            ChipLogError(BDX, "PrepareBlock failed: %" CHIP_ERROR_FORMAT, err.Format());
-            mTransfer.AbortTransfer(StatusCode::kUnknown);
+            mFirstBlockPending = true;
+            ScheduleImmediatePoll();
         }
         break;
     }
+    case TransferSession::OutputEventType::kInitReceived:
+        AcceptTransfer();
+        break;
+    case TransferSession::OutputEventType::kQueryReceived:
+        SendNextBlock();
+        break;
+    case TransferSession::OutputEventType::kQueryWithSkipReceived:
+        mNumBytesSent += event.bytesToSkip.BytesToSkip;
+        SendNextBlock();
+        break;
     case TransferSession::OutputEventType::kAckReceived:
+        if (mTransfer.GetControlMode() == TransferControlFlags::kSenderDrive)
+        {
+            SendNextBlock();
+        }
         break;
     case TransferSession::OutputEventType::kAckEOFReceived:
         ChipLogDetail(BDX, "Transfer completed, got AckEOF");
+        LogThroughput("completed");
         mStopPolling = true; // Stop polling the TransferSession only after receiving BlockAckEOF
         Reset();
         break;
     case TransferSession::OutputEventType::kStatusReceived:
         ChipLogError(BDX, "Got StatusReport %x", static_cast<uint16_t>(event.statusData.statusCode));
+        LogThroughput("aborted by requestor");
         Reset();
         break;
     case TransferSession::OutputEventType::kInternalError:
         ChipLogError(BDX, "InternalError");
+        LogThroughput("failed");
         Reset();
         break;
     case TransferSession::OutputEventType::kTransferTimeout:
         ChipLogError(BDX, "Transfer timed out");
+        LogThroughput("timed out");
         Reset();
         break;
     case TransferSession::OutputEventType::kAcceptReceived:
@@ -203,15 +312,113 @@ void BdxOtaSender::HandleTransferSessionOutput(TransferSession::OutputEvent & ev
     }
 }
 
+void BdxOtaSender::Transfer::AcceptTransfer()
+{
+    char fileDesignator[chip::bdx::kMaxFileDesignatorLen];
+    uint16_t fdl       = 0;
+    const uint8_t * fd = mTransfer.GetFileDesignator(fdl);
+    if (fdl >= chip::bdx::kMaxFileDesignatorLen)
+    {
+        ChipLogError(BDX, "Cannot store file designator with length = %d", fdl);
+        mTransfer.AbortTransfer(StatusCode::kFileDesignatorUnknown);
+        ProcessOutput();
+        return;
+    }
+    memcpy(fileDesignator, fd, fdl);
+    fileDesignator[fdl] = 0;
+
+    CHIP_ERROR err = mImageCache->Acquire(fileDesignator, mImage);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(BDX, "Cannot map OTA file %s: %" CHIP_ERROR_FORMAT, fileDesignator, err.Format());
+        mImage = chip::ByteSpan();
+        mTransfer.AbortTransfer(StatusCode::kFileDesignatorUnknown);
+        ProcessOutput();
+        return;
+    }
+
+    if (mTransfer.GetStartOffset() > mImage.size())
+    {
+        ChipLogError(BDX, "Start offset 0x" ChipLogFormatX64 " is past the end of the OTA file",
+                     ChipLogValueX64(mTransfer.GetStartOffset()));
+        mTransfer.AbortTransfer(StatusCode::kStartOffsetNotSupported);
+        ProcessOutput();
+        return;
+    }
+
+    // TransferSession will automatically reject a transfer if there are no
+    // common supported control modes. It will also default to the smaller
+    // block size. Receiver drive is used whenever the requestor proposes it.
+    TransferSession::TransferAcceptData acceptData;
+    acceptData.ControlMode = mTransfer.GetProposedControlOptions().Has(TransferControlFlags::kReceiverDrive)
+        ? TransferControlFlags::kReceiverDrive
+        : TransferControlFlags::kSenderDrive;
+    acceptData.MaxBlockSize = mTransfer.GetTransferBlockSize();
+    acceptData.StartOffset  = mTransfer.GetStartOffset();
+    acceptData.Length       = mTransfer.GetTransferLength();
+    err                     = mTransfer.AcceptTransfer(acceptData);
+    VerifyOrReturn(err == CHIP_NO_ERROR, ChipLogError(BDX, "AcceptTransfer failed: %" CHIP_ERROR_FORMAT, err.Format()));
+
+    mStarted      = true;
+    mStartTime    = chip::System::SystemClock().GetMonotonicTimestamp();
+    mNumBytesSent = 0;
+
+    ProcessOutput();
+}
+
+void BdxOtaSender::Transfer::SendNextBlock()
+{
+    // Blocks are sent straight from the mapped image; PrepareBlock copies them into the message.
+    const uint64_t offset = std::min<uint64_t>(mTransfer.GetStartOffset() + mNumBytesSent, mImage.size());
+    uint64_t remaining    = mImage.size() - offset;
+    if (mTransfer.GetTransferLength() > 0)
+    {
+        const uint64_t length = mTransfer.GetTransferLength();
+        remaining             = std::min(remaining, length - std::min(mNumBytesSent, length));
+    }
+
+    TransferSession::BlockData blockData;
+    blockData.Data   = mImage.data() + offset;
+    blockData.Length = static_cast<size_t>(std::min<uint64_t>(remaining, mTransfer.GetTransferBlockSize()));
+    blockData.IsEof  = (blockData.Length == remaining);
+
+    CHIP_ERROR err = mTransfer.PrepareBlock(blockData);
+    if (err == CHIP_NO_ERROR)
+    {
+        mNumBytesSent += blockData.Length;
+    }
+    else
+    {
+        ChipLogError(BDX, "PrepareBlock failed: %" CHIP_ERROR_FORMAT, err.Format());
+        mTransfer.AbortTransfer(StatusCode::kUnknown);
+    }
+
+    ProcessOutput();
+}
+
+void BdxOtaSender::Transfer::LogThroughput(const char * outcome)
+{
+    VerifyOrReturn(mStarted);
+
+    const chip::System::Clock::Timestamp elapsed = chip::System::SystemClock().GetMonotonicTimestamp() - mStartTime;
+    const uint64_t elapsedMs                     = std::max<uint64_t>(elapsed.count(), 1);
+    const uint64_t bytesPerSecond                = mNumBytesSent * 1000 / elapsedMs;
+
+    ChipLogProgress(BDX,
+                    "Transfer to " ChipLogFormatScopedNodeId " %s: %" PRIu64 " bytes in %" PRIu64 " ms (%" PRIu64
+                    " bytes/s, %u-byte blocks, %s drive)",
+                    ChipLogValueScopedNodeId(chip::ScopedNodeId(mNodeId, mFabricIndex)), outcome, mNumBytesSent, elapsedMs,
+                    bytesPerSecond, mTransfer.GetTransferBlockSize(),
+                    mTransfer.GetControlMode() == TransferControlFlags::kSenderDrive ? "sender" : "receiver");
+}
+
 /* Reset() calls bdx::TransferSession::Reset() which sets the output event type to
  * TransferSession::OutputEventType::kNone. So, bdx::TransferFacilitator::PollForOutput()
  * will call HandleTransferSessionOutput() with event TransferSession::OutputEventType::kNone.
  * Since we are ignoring kNone events so, it is okay HandleTransferSessionOutput() being called with event kNone
  */
-void BdxOtaSender::Reset()
+void BdxOtaSender::Transfer::Reset()
 {
-    mFabricIndex.ClearValue();
-    mNodeId.ClearValue();
     Responder::ResetTransfer();
     if (mExchangeCtx != nullptr)
     {
@@ -219,7 +426,16 @@ void BdxOtaSender::Reset()
         mExchangeCtx = nullptr;
     }
 
-    mInitialized  = false;
-    mNumBytesSent = 0;
-    memset(mFileDesignator, 0, chip::bdx::kMaxFileDesignatorLen);
+    if (!mImage.empty())
+    {
+        mImageCache->Release(mImage);
+        mImage = chip::ByteSpan();
+    }
+
+    mInUse             = false;
+    mStarted           = false;
+    mFirstBlockPending = false;
+    mFabricIndex       = chip::kUndefinedFabricIndex;
+    mNodeId            = chip::kUndefinedNodeId;
+    mNumBytesSent      = 0;
 }
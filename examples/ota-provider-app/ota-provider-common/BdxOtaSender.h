@@ -15,33 +15,112 @@
  *    limitations under the License.
  */
 
+#include <messaging/ExchangeDelegate.h>
+#include <ota-provider-common/BdxImageCache.h>
 #include <protocols/bdx/BdxTransferSession.h>
 #include <protocols/bdx/TransferFacilitator.h>
+#include <system/SystemClock.h>
 
 #pragma once
 
-class BdxOtaSender : public chip::bdx::Responder
+/**
+ * Serves OTA images over BDX to several requestors at once.
+ *
+ * Each requestor that got an image URI gets its own transfer, and all the transfers read their blocks straight from a
+ * shared memory mapping of the image file.  Both receiver-driven and sender-driven transfers are supported; a transfer
+ * answers every message as soon as it is received instead of waiting for the next poll.
+ *
+ * BdxOtaSender is registered as the unsolicited message handler for the BDX protocol, and routes each exchange to the
+ * transfer prepared for the peer of the exchange.
+ */
+class BdxOtaSender : public chip::Messaging::UnsolicitedMessageHandler, public chip::Messaging::ExchangeDelegate
 {
 public:
+    static constexpr size_t kMaxTransfers = 8;
+
     BdxOtaSender();
 
-    // Initializes BDX transfer-related metadata. Should always be called first.
+    // Reserves a transfer for the given node, replacing the stale one of the same node if any. Should always be called
+    // first, and followed by PrepareForTransfer(). Returns CHIP_ERROR_BUSY if all the transfers are in use.
     CHIP_ERROR InitializeTransfer(chip::FabricIndex fabricIndex, chip::NodeId nodeId);
 
+    // Prepares the transfer reserved by the last InitializeTransfer() call to respond to the requestor. Sender drive is
+    // always offered in addition to the given control modes.
+    CHIP_ERROR PrepareForTransfer(chip::System::Layer * layer, chip::bdx::TransferRole role,
+                                  chip::BitFlags<chip::bdx::TransferControlFlags> xferControlOpts, uint16_t maxBlockSize,
+                                  chip::System::Clock::Timeout timeout, chip::System::Clock::Timeout pollFreq);
+
+    size_t GetActiveTransferCount() const;
+
 private:
-    // Inherited from bdx::TransferFacilitator
-    void HandleTransferSessionOutput(chip::bdx::TransferSession::OutputEvent & event) override;
+    friend class TestBdxOtaSender;
+
+    class Transfer : public chip::bdx::Responder
+    {
+    public:
+        void Init(BdxImageCache * imageCache) { mImageCache = imageCache; }
+
+        bool IsInUse() const { return mInUse; }
+        bool IsFor(chip::FabricIndex fabricIndex, chip::NodeId nodeId) const
+        {
+            return mInUse && mFabricIndex == fabricIndex && mNodeId == nodeId;
+        }
+        chip::Messaging::ExchangeContext * GetExchange() const { return mExchangeCtx; }
+        // Whether the requestor never started the transfer it was reserved for.
+        bool IsStale(chip::System::Clock::Timestamp now) const
+        {
+            return mInUse && !mStarted && (now - mReserveTime) >= mTimeout;
+        }
+
+        void Reserve(chip::FabricIndex fabricIndex, chip::NodeId nodeId);
+        CHIP_ERROR Prepare(chip::System::Layer * layer, chip::BitFlags<chip::bdx::TransferControlFlags> xferControlOpts,
+                           uint16_t maxBlockSize, chip::System::Clock::Timeout timeout, chip::System::Clock::Timeout pollFreq);
+
+        // Hands a message of the exchange to the TransferSession, and processes its output right away.
+        CHIP_ERROR HandleMessage(chip::Messaging::ExchangeContext * ec, const chip::PayloadHeader & payloadHeader,
+                                 chip::System::PacketBufferHandle && payload);
+        void HandleResponseTimeout(chip::Messaging::ExchangeContext * ec);
+        void HandleExchangeClosing();
+
+        void Reset();
+
+    private:
+        // Inherited from bdx::TransferFacilitator
+        void HandleTransferSessionOutput(chip::bdx::TransferSession::OutputEvent & event) override;
+
+        void ProcessOutput();
+        void AcceptTransfer();
+        void SendNextBlock();
+        void LogThroughput(const char * outcome);
+
+        BdxImageCache * mImageCache = nullptr;
+        chip::ByteSpan mImage;
 
-    void Reset();
+        uint64_t mNumBytesSent = 0;
+        chip::System::Clock::Timestamp mReserveTime;
+        chip::System::Clock::Timestamp mStartTime;
+        chip::System::Clock::Timeout mTimeout;
 
-    // Null-terminated string representing file designator
-    char mFileDesignator[chip::bdx::kMaxFileDesignatorLen];
+        bool mInUse                    = false;
+        bool mStarted                  = false;
+        bool mFirstBlockPending        = false;
+        chip::FabricIndex mFabricIndex = chip::kUndefinedFabricIndex;
+        chip::NodeId mNodeId           = chip::kUndefinedNodeId;
+    };
 
-    uint32_t mNumBytesSent = 0;
+    //// UnsolicitedMessageHandler Implementation ////
+    CHIP_ERROR OnUnsolicitedMessageReceived(const chip::PayloadHeader & payloadHeader,
+                                            chip::Messaging::ExchangeDelegate *& newDelegate) override;
 
-    bool mInitialized = false;
+    //// ExchangeDelegate Implementation ////
+    CHIP_ERROR OnMessageReceived(chip::Messaging::ExchangeContext * ec, const chip::PayloadHeader & payloadHeader,
+                                 chip::System::PacketBufferHandle && payload) override;
+    void OnResponseTimeout(chip::Messaging::ExchangeContext * ec) override;
+    void OnExchangeClosing(chip::Messaging::ExchangeContext * ec) override;
 
-    chip::Optional<chip::FabricIndex> mFabricIndex;
+    Transfer * FindTransfer(chip::Messaging::ExchangeContext * ec);
 
-    chip::Optional<chip::NodeId> mNodeId;
+    BdxImageCache mImageCache;
+    Transfer mTransfers[kMaxTransfers];
+    Transfer * mReservedTransfer = nullptr;
 };
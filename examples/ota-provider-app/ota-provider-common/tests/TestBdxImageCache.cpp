@@ -0,0 +1,324 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <ota-provider-common/BdxImageCache.h>
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/Span.h>
+#include <lib/support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace chip;
+
+namespace {
+
+/**
+ * An image file filled with a pattern derived from a seed, removed when destroyed.
+ */
+class TestImage
+{
+public:
+    ~TestImage()
+    {
+        if (mPath[0] != '\0')
+        {
+            unlink(mPath);
+        }
+    }
+
+    CHIP_ERROR Create(size_t size, uint8_t seed)
+    {
+        int fd = mkstemp(mPath);
+        VerifyOrReturnError(fd >= 0, CHIP_ERROR_OPEN_FAILED);
+        close(fd);
+        return Write(mPath, size, seed);
+    }
+
+    // Replaces the file with a new one, as an image update would, so that a mapping of the old file keeps its content.
+    CHIP_ERROR Replace(size_t size, uint8_t seed)
+    {
+        char newPath[sizeof(mPath) + 4];
+        snprintf(newPath, sizeof(newPath), "%s.new", mPath);
+        ReturnErrorOnFailure(Write(newPath, size, seed));
+        return rename(newPath, mPath) == 0 ? CHIP_NO_ERROR : CHIP_ERROR_WRITE_FAILED;
+    }
+
+    const char * GetPath() const { return mPath; }
+
+    static bool HasContent(const ByteSpan & image, size_t size, uint8_t seed)
+    {
+        VerifyOrReturnValue(image.size() == size, false);
+        for (size_t i = 0; i < size; i++)
+        {
+            VerifyOrReturnValue(image.data()[i] == Pattern(i, seed), false);
+        }
+        return true;
+    }
+
+private:
+    static uint8_t Pattern(size_t index, uint8_t seed) { return static_cast<uint8_t>(seed + index * 7); }
+
+    static CHIP_ERROR Write(const char * path, size_t size, uint8_t seed)
+    {
+        FILE * file = fopen(path, "wb");
+        VerifyOrReturnError(file != nullptr, CHIP_ERROR_OPEN_FAILED);
+
+        bool written = true;
+        for (size_t i = 0; i < size && written; i++)
+        {
+            written = fputc(Pattern(i, seed), file) != EOF;
+        }
+        written = (fclose(file) == 0) && written;
+
+        return written ? CHIP_NO_ERROR : CHIP_ERROR_WRITE_FAILED;
+    }
+
+    char mPath[32] = "/tmp/ota-image-XXXXXX";
+};
+
+constexpr size_t kImageSize = 1000;
+
+} // namespace
+
+class TestBdxImageCache
+{
+public:
+    static void TestMappingReuse(nlTestSuite * inSuite, void * inContext);
+    static void TestLruEviction(nlTestSuite * inSuite, void * inContext);
+    static void TestReferencedEntriesKept(nlTestSuite * inSuite, void * inContext);
+    static void TestChangedFile(nlTestSuite * inSuite, void * inContext);
+    static void TestInvalidFiles(nlTestSuite * inSuite, void * inContext);
+
+private:
+    static const BdxImageCache::Entry * FindEntry(const BdxImageCache & cache, const char * path)
+    {
+        for (const auto & entry : cache.mEntries)
+        {
+            if (entry.data != nullptr && strcmp(entry.path, path) == 0)
+            {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+};
+
+void TestBdxImageCache::TestMappingReuse(nlTestSuite * inSuite, void * inContext)
+{
+    TestImage file;
+    NL_TEST_ASSERT(inSuite, file.Create(kImageSize, 1) == CHIP_NO_ERROR);
+
+    BdxImageCache cache;
+    ByteSpan first;
+    ByteSpan second;
+    NL_TEST_ASSERT(inSuite, cache.Acquire(file.GetPath(), first) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, cache.Acquire(file.GetPath(), second) == CHIP_NO_ERROR);
+
+    // Both transfers read the same mapping.
+    NL_TEST_ASSERT(inSuite, first.data() == second.data());
+    NL_TEST_ASSERT(inSuite, TestImage::HasContent(first, kImageSize, 1));
+
+    const BdxImageCache::Entry * entry = FindEntry(cache, file.GetPath());
+    NL_TEST_ASSERT(inSuite, entry != nullptr && entry->refCount == 2);
+
+    cache.Release(first);
+    NL_TEST_ASSERT(inSuite, entry != nullptr && entry->refCount == 1);
+    cache.Release(second);
+
+    // The mapping outlives the last transfer, and serves the next one.
+    NL_TEST_ASSERT(inSuite, FindEntry(cache, file.GetPath()) == entry);
+    NL_TEST_ASSERT(inSuite, entry != nullptr && entry->refCount == 0);
+
+    ByteSpan third;
+    NL_TEST_ASSERT(inSuite, cache.Acquire(file.GetPath(), third) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, third.data() == first.data());
+    cache.Release(third);
+}
+
+void TestBdxImageCache::TestLruEviction(nlTestSuite * inSuite, void * inContext)
+{
+    TestImage files[BdxImageCache::kMaxImages + 1];
+    for (size_t i = 0; i < ArraySize(files); i++)
+    {
+        NL_TEST_ASSERT(inSuite, files[i].Create(kImageSize + i, static_cast<uint8_t>(i)) == CHIP_NO_ERROR);
+    }
+
+    BdxImageCache cache;
+    for (size_t i = 0; i < BdxImageCache::kMaxImages; i++)
+    {
+        ByteSpan image;
+        NL_TEST_ASSERT(inSuite, cache.Acquire(files[i].GetPath(), image) == CHIP_NO_ERROR);
+        cache.Release(image);
+    }
+
+    // Use the first image again, so that the second one is the least recently used.
+    ByteSpan image;
+    NL_TEST_ASSERT(inSuite, cache.Acquire(files[0].GetPath(), image) == CHIP_NO_ERROR);
+    cache.Release(image);
+
+    NL_TEST_ASSERT(inSuite, cache.Acquire(files[BdxImageCache::kMaxImages].GetPath(), image) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, TestImage::HasContent(image, kImageSize + BdxImageCache::kMaxImages, BdxImageCache::kMaxImages));
+    cache.Release(image);
+
+    NL_TEST_ASSERT(inSuite, FindEntry(cache, files[1].GetPath()) == nullptr);
+    for (size_t i : { 0, 2, 3 })
+    {
+        NL_TEST_ASSERT(inSuite, FindEntry(cache, files[i].GetPath()) != nullptr);
+    }
+}
+
+void TestBdxImageCache::TestReferencedEntriesKept(nlTestSuite * inSuite, void * inContext)
+{
+    TestImage files[BdxImageCache::kMaxImages + 1];
+    for (size_t i = 0; i < ArraySize(files); i++)
+    {
+        NL_TEST_ASSERT(inSuite, files[i].Create(kImageSize + i, static_cast<uint8_t>(i)) == CHIP_NO_ERROR);
+    }
+
+    BdxImageCache cache;
+    ByteSpan images[BdxImageCache::kMaxImages];
+    for (size_t i = 0; i < BdxImageCache::kMaxImages; i++)
+    {
+        NL_TEST_ASSERT(inSuite, cache.Acquire(files[i].GetPath(), images[i]) == CHIP_NO_ERROR);
+    }
+
+    // No mapping in use by a transfer is evicted, nor unmapped by Clear().
+    ByteSpan image;
+    NL_TEST_ASSERT(inSuite, cache.Acquire(files[BdxImageCache::kMaxImages].GetPath(), image) == CHIP_ERROR_NO_MEMORY);
+    cache.Clear();
+    for (size_t i = 0; i < BdxImageCache::kMaxImages; i++)
+    {
+        NL_TEST_ASSERT(inSuite, FindEntry(cache, files[i].GetPath()) != nullptr);
+        NL_TEST_ASSERT(inSuite, TestImage::HasContent(images[i], kImageSize + i, static_cast<uint8_t>(i)));
+    }
+
+    // Once released, a mapping can be evicted.
+    cache.Release(images[2]);
+    NL_TEST_ASSERT(inSuite, cache.Acquire(files[BdxImageCache::kMaxImages].GetPath(), image) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, FindEntry(cache, files[2].GetPath()) == nullptr);
+    cache.Release(image);
+
+    cache.Release(images[3]);
+    cache.Clear();
+    NL_TEST_ASSERT(inSuite, FindEntry(cache, files[3].GetPath()) == nullptr);
+    NL_TEST_ASSERT(inSuite, FindEntry(cache, files[BdxImageCache::kMaxImages].GetPath()) == nullptr);
+    NL_TEST_ASSERT(inSuite, TestImage::HasContent(images[0], kImageSize, 0));
+    NL_TEST_ASSERT(inSuite, TestImage::HasContent(images[1], kImageSize + 1, 1));
+
+    cache.Release(images[0]);
+    cache.Release(images[1]);
+}
+
+void TestBdxImageCache::TestChangedFile(nlTestSuite * inSuite, void * inContext)
+{
+    TestImage file;
+    NL_TEST_ASSERT(inSuite, file.Create(kImageSize, 1) == CHIP_NO_ERROR);
+
+    BdxImageCache cache;
+    ByteSpan first;
+    NL_TEST_ASSERT(inSuite, cache.Acquire(file.GetPath(), first) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, file.Replace(kImageSize / 2, 2) == CHIP_NO_ERROR);
+
+    // While a transfer reads the old content, the next transfers get it as well.
+    ByteSpan second;
+    NL_TEST_ASSERT(inSuite, cache.Acquire(file.GetPath(), second) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, second.data() == first.data());
+    NL_TEST_ASSERT(inSuite, TestImage::HasContent(second, kImageSize, 1));
+    cache.Release(first);
+    cache.Release(second);
+
+    ByteSpan third;
+    NL_TEST_ASSERT(inSuite, cache.Acquire(file.GetPath(), third) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, TestImage::HasContent(third, kImageSize / 2, 2));
+    cache.Release(third);
+}
+
+void TestBdxImageCache::TestInvalidFiles(nlTestSuite * inSuite, void * inContext)
+{
+    TestImage file;
+    NL_TEST_ASSERT(inSuite, file.Create(0, 0) == CHIP_NO_ERROR);
+
+    BdxImageCache cache;
+    ByteSpan image;
+    NL_TEST_ASSERT(inSuite, cache.Acquire(file.GetPath(), image) == CHIP_ERROR_INVALID_FILE_IDENTIFIER);
+    NL_TEST_ASSERT(inSuite, cache.Acquire("/tmp/ota-image-missing", image) != CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, cache.Acquire(nullptr, image) == CHIP_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, FindEntry(cache, file.GetPath()) == nullptr);
+}
+
+/**
+ *  Set up the test suite.
+ */
+int TestBdxImageCache_Setup(void * inContext)
+{
+    CHIP_ERROR error = chip::Platform::MemoryInit();
+
+    if (error != CHIP_NO_ERROR)
+    {
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ *  Tear down the test suite.
+ */
+int TestBdxImageCache_Teardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+// clang-format off
+static const nlTest sTests[] = {
+    NL_TEST_DEF("Test mapping reuse", TestBdxImageCache::TestMappingReuse),
+    NL_TEST_DEF("Test LRU eviction", TestBdxImageCache::TestLruEviction),
+    NL_TEST_DEF("Test referenced entries kept", TestBdxImageCache::TestReferencedEntriesKept),
+    NL_TEST_DEF("Test changed file", TestBdxImageCache::TestChangedFile),
+    NL_TEST_DEF("Test invalid files", TestBdxImageCache::TestInvalidFiles),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+int TestBdxImageCacheSuite()
+{
+    // clang-format off
+    nlTestSuite theSuite =
+    {
+        "BDX Image Cache",
+        &sTests[0],
+        TestBdxImageCache_Setup,
+        TestBdxImageCache_Teardown
+    };
+    // clang-format on
+    nlTestRunner(&theSuite, nullptr);
+    return (nlTestRunnerStats(&theSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestBdxImageCacheSuite);
@@ -0,0 +1,577 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <ota-provider-common/BdxImageCache.h>
+#include <ota-provider-common/BdxOtaSender.h>
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/Span.h>
+#include <lib/support/UnitTestContext.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <messaging/ExchangeContext.h>
+#include <messaging/ExchangeMgr.h>
+#include <messaging/tests/MessagingContext.h>
+#include <protocols/bdx/BdxMessages.h>
+#include <protocols/bdx/BdxTransferSession.h>
+#include <system/SystemClock.h>
+
+#include <nlunit-test.h>
+
+#include <algorithm>
+#include <functional>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+using namespace chip;
+using namespace chip::bdx;
+
+namespace {
+
+constexpr size_t kImageSize                       = 1000;
+constexpr uint16_t kMaxBlockSize                  = 1024;
+constexpr System::Clock::Timeout kTransferTimeout = System::Clock::Seconds16(30);
+constexpr System::Clock::Timeout kPollFreq        = System::Clock::Milliseconds32(10);
+constexpr System::Clock::Timeout kDriveTimeout    = System::Clock::Seconds16(5);
+constexpr NodeId kRequestorNodeIdBase             = 0x1000;
+constexpr uint16_t kRequestorSessionIdBase        = 0x100;
+constexpr uint16_t kProviderSessionIdBase         = 0x200;
+constexpr size_t kNumRequestors                   = 3;
+
+constexpr BitFlags<TransferControlFlags> kProviderModes(TransferControlFlags::kReceiverDrive);
+
+uint8_t sImageData[kImageSize];
+
+/**
+ * An image file, removed when destroyed.
+ */
+class TestImage
+{
+public:
+    ~TestImage()
+    {
+        if (mPath[0] != '\0')
+        {
+            unlink(mPath);
+        }
+    }
+
+    CHIP_ERROR Create(const ByteSpan & content)
+    {
+        int fd = mkstemp(mPath);
+        VerifyOrReturnError(fd >= 0, CHIP_ERROR_OPEN_FAILED);
+
+        FILE * file = fdopen(fd, "wb");
+        VerifyOrReturnError(file != nullptr, (close(fd), CHIP_ERROR_OPEN_FAILED));
+
+        bool written = fwrite(content.data(), 1, content.size(), file) == content.size();
+        written      = (fclose(file) == 0) && written;
+
+        return written ? CHIP_NO_ERROR : CHIP_ERROR_WRITE_FAILED;
+    }
+
+    const char * GetPath() const { return mPath; }
+
+private:
+    char mPath[32] = "/tmp/ota-image-XXXXXX";
+};
+
+/**
+ * The OTA requestor side of a transfer: receives the image in the given control mode, and can be paused after a number
+ * of blocks to keep several transfers in progress at once.
+ */
+class TestRequestor : public Messaging::ExchangeDelegate
+{
+public:
+    CHIP_ERROR Start(Messaging::ExchangeManager & exchangeMgr, const SessionHandle & session, TransferControlFlags controlMode,
+                     uint16_t maxBlockSize, uint64_t startOffset, const char * path)
+    {
+        mExchange = exchangeMgr.NewContext(session, this);
+        VerifyOrReturnError(mExchange != nullptr, CHIP_ERROR_NO_MEMORY);
+
+        TransferSession::TransferInitData initData;
+        initData.TransferCtlFlags = controlMode;
+        initData.MaxBlockSize     = maxBlockSize;
+        initData.StartOffset      = startOffset;
+        initData.FileDesignator   = Uint8::from_const_char(path);
+        initData.FileDesLength    = static_cast<uint16_t>(strlen(path));
+        ReturnErrorOnFailure(mTransfer.StartTransfer(TransferRole::kReceiver, initData, kTransferTimeout));
+
+        ProcessOutput();
+        return mError;
+    }
+
+    // Holds back the query or the ack that follows the given number of blocks, until Resume() is called.
+    void PauseAfter(uint32_t blockCount) { mPauseAfter = blockCount; }
+
+    void Resume()
+    {
+        VerifyOrReturn(mPaused);
+        mPaused     = false;
+        mPauseAfter = 0;
+        RequestNextBlock();
+        ProcessOutput();
+    }
+
+    void Abort()
+    {
+        mAborted = true;
+        mError   = mTransfer.AbortTransfer(StatusCode::kUnknown);
+        ProcessOutput();
+    }
+
+    bool IsPaused() const { return mPaused; }
+    bool IsComplete() const { return mComplete; }
+    bool HasStatus() const { return mHasStatus; }
+    CHIP_ERROR GetError() const { return mError; }
+    uint32_t GetBlockCount() const { return mBlockCount; }
+    ByteSpan GetReceivedData() const { return ByteSpan(mData, mReceived); }
+
+private:
+    CHIP_ERROR OnMessageReceived(Messaging::ExchangeContext * ec, const PayloadHeader & payloadHeader,
+                                 System::PacketBufferHandle && payload) override
+    {
+        CHIP_ERROR err =
+            mTransfer.HandleMessageReceived(payloadHeader, std::move(payload), System::SystemClock().GetMonotonicTimestamp());
+        ProcessOutput();
+        return err;
+    }
+
+    void OnResponseTimeout(Messaging::ExchangeContext * ec) override { mError = CHIP_ERROR_TIMEOUT; }
+    void OnExchangeClosing(Messaging::ExchangeContext * ec) override { mExchange = nullptr; }
+
+    void ProcessOutput()
+    {
+        TransferSession::OutputEvent event;
+        do
+        {
+            mTransfer.PollOutput(event, System::SystemClock().GetMonotonicTimestamp());
+            HandleOutput(event);
+        } while (event.EventType != TransferSession::OutputEventType::kNone);
+    }
+
+    void HandleOutput(TransferSession::OutputEvent & event)
+    {
+        switch (event.EventType)
+        {
+        case TransferSession::OutputEventType::kMsgToSend: {
+            Messaging::SendFlags sendFlags;
+            if (!event.msgTypeData.HasMessageType(Protocols::SecureChannel::MsgType::StatusReport) &&
+                !event.msgTypeData.HasMessageType(MessageType::BlockAckEOF))
+            {
+                sendFlags.Set(Messaging::SendMessageFlags::kExpectResponse);
+            }
+            VerifyOrReturn(mExchange != nullptr, mError = CHIP_ERROR_INCORRECT_STATE);
+            CHIP_ERROR err = mExchange->SendMessage(event.msgTypeData.ProtocolId, event.msgTypeData.MessageType,
+                                                    std::move(event.MsgData), sendFlags);
+            if (err != CHIP_NO_ERROR)
+            {
+                mError = err;
+            }
+            break;
+        }
+        case TransferSession::OutputEventType::kAcceptReceived:
+            if (mTransfer.GetControlMode() == TransferControlFlags::kReceiverDrive)
+            {
+                RequestNextBlock();
+            }
+            else
+            {
+                // The first block follows on the exchange.
+                mExchange->WillSendMessage();
+            }
+            break;
+        case TransferSession::OutputEventType::kBlockReceived:
+            VerifyOrReturn(mReceived + event.blockdata.Length <= sizeof(mData), mError = CHIP_ERROR_BUFFER_TOO_SMALL);
+            memcpy(mData + mReceived, event.blockdata.Data, event.blockdata.Length);
+            mReceived += event.blockdata.Length;
+            mBlockCount++;
+
+            if (event.blockdata.IsEof)
+            {
+                mError    = mTransfer.PrepareBlockAck();
+                mComplete = true;
+            }
+            else if (mBlockCount == mPauseAfter)
+            {
+                mPaused = true;
+                mExchange->WillSendMessage();
+            }
+            else
+            {
+                RequestNextBlock();
+            }
+            break;
+        case TransferSession::OutputEventType::kStatusReceived:
+            mHasStatus = true;
+            break;
+        case TransferSession::OutputEventType::kInternalError:
+        case TransferSession::OutputEventType::kTransferTimeout:
+            // The transfer is over, either aborted on purpose or failed.
+            if (!mAborted)
+            {
+                mError = CHIP_ERROR_INTERNAL;
+            }
+            mTransfer.Reset();
+            break;
+        default:
+            break;
+        }
+    }
+
+    void RequestNextBlock()
+    {
+        mError = (mTransfer.GetControlMode() == TransferControlFlags::kReceiverDrive) ? mTransfer.PrepareBlockQuery()
+                                                                                     : mTransfer.PrepareBlockAck();
+    }
+
+    TransferSession mTransfer;
+    Messaging::ExchangeContext * mExchange = nullptr;
+    CHIP_ERROR mError                      = CHIP_NO_ERROR;
+
+    uint8_t mData[kImageSize];
+    size_t mReceived     = 0;
+    uint32_t mBlockCount = 0;
+    uint32_t mPauseAfter = 0;
+    bool mPaused         = false;
+    bool mComplete       = false;
+    bool mHasStatus      = false;
+    bool mAborted        = false;
+};
+
+class TestContext : public Test::LoopbackMessagingContext
+{
+public:
+    static int SetUpTestSuite(void * context)
+    {
+        for (size_t i = 0; i < kImageSize; i++)
+        {
+            sImageData[i] = static_cast<uint8_t>(i * 7 + 1);
+        }
+        return LoopbackMessagingContext::Initialize(context);
+    }
+
+    static int TearDownTestSuite(void * context) { return LoopbackMessagingContext::Finalize(context); }
+
+    static int TearDown(void * context)
+    {
+        auto * ctx = static_cast<TestContext *>(context);
+        for (size_t i = 0; i < kNumRequestors; i++)
+        {
+            ctx->DisconnectRequestor(i);
+        }
+        ctx->DrainAndServiceIO();
+        return SUCCESS;
+    }
+
+    NodeId GetRequestorNodeId(size_t index) const { return kRequestorNodeIdBase + index; }
+
+    SessionHandle GetRequestorSession(size_t index)
+    {
+        auto sessionHandle = mRequestorSessions[index].Get();
+        return std::move(sessionHandle.Value());
+    }
+
+    /**
+     * Opens the sessions between a requestor and the provider, so that the provider sees each requestor as a distinct
+     * peer of the Alice fabric.
+     */
+    CHIP_ERROR ConnectRequestor(size_t index)
+    {
+        const uint16_t requestorSessionId = static_cast<uint16_t>(kRequestorSessionIdBase + index);
+        const uint16_t providerSessionId  = static_cast<uint16_t>(kProviderSessionIdBase + index);
+        const NodeId providerNodeId       = GetAliceFabric()->GetNodeId();
+
+        ReturnErrorOnFailure(GetSecureSessionManager().InjectCaseSessionWithTestKey(
+            mRequestorSessions[index], requestorSessionId, providerSessionId, GetRequestorNodeId(index), providerNodeId,
+            GetBobFabricIndex(), GetAliceAddress(), CryptoContext::SessionRole::kInitiator));
+        return GetSecureSessionManager().InjectCaseSessionWithTestKey(
+            mProviderSessions[index], providerSessionId, requestorSessionId, providerNodeId, GetRequestorNodeId(index),
+            GetAliceFabricIndex(), GetBobAddress(), CryptoContext::SessionRole::kResponder);
+    }
+
+    void DisconnectRequestor(size_t index)
+    {
+        for (SessionHolder * holder : { &mRequestorSessions[index], &mProviderSessions[index] })
+        {
+            if (*holder)
+            {
+                holder->Get().Value()->AsSecureSession()->MarkForEviction();
+            }
+        }
+    }
+
+    /**
+     * Runs the transfers until the condition is met.  The first block of a sender-driven transfer waits for a poll of
+     * the provider, so processing the pending messages is not enough.
+     */
+    void DriveTransfersUntil(std::function<bool()> condition)
+    {
+        GetIOContext().DriveIOUntil(kDriveTimeout, std::move(condition));
+        DrainAndServiceIO();
+    }
+
+    CHIP_ERROR PrepareTransfer(BdxOtaSender & sender, size_t index, System::Clock::Timeout timeout = kTransferTimeout)
+    {
+        ReturnErrorOnFailure(sender.InitializeTransfer(GetAliceFabricIndex(), GetRequestorNodeId(index)));
+        return sender.PrepareForTransfer(&GetSystemLayer(), TransferRole::kSender, kProviderModes, kMaxBlockSize, timeout,
+                                         kPollFreq);
+    }
+
+private:
+    SessionHolder mRequestorSessions[kNumRequestors];
+    SessionHolder mProviderSessions[kNumRequestors];
+};
+
+} // namespace
+
+class TestBdxOtaSender
+{
+public:
+    static void TestConcurrentTransfers(nlTestSuite * inSuite, void * inContext);
+    static void TestEvictionDuringTransfer(nlTestSuite * inSuite, void * inContext);
+    static void TestAllTransfersBusy(nlTestSuite * inSuite, void * inContext);
+
+private:
+    static const BdxImageCache::Entry * FindImage(const BdxOtaSender & sender, const char * path)
+    {
+        for (const auto & entry : sender.mImageCache.mEntries)
+        {
+            if (entry.data != nullptr && strcmp(entry.path, path) == 0)
+            {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    // Frees the transfers left in use, and lets their poll timers fire once more so that they stop.
+    static void FinishTransfers(TestContext & ctx, BdxOtaSender & sender)
+    {
+        for (auto & transfer : sender.mTransfers)
+        {
+            if (transfer.IsInUse())
+            {
+                transfer.Reset();
+            }
+        }
+        ctx.GetIOContext().DriveIOUntil(kPollFreq * 5, [] { return false; });
+    }
+};
+
+void TestBdxOtaSender::TestConcurrentTransfers(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+
+    TestImage image;
+    NL_TEST_ASSERT(inSuite, image.Create(ByteSpan(sImageData)) == CHIP_NO_ERROR);
+
+    BdxOtaSender sender;
+    NL_TEST_ASSERT(inSuite,
+                   ctx.GetExchangeManager().RegisterUnsolicitedMessageHandlerForProtocol(Protocols::BDX::Id, &sender) ==
+                       CHIP_NO_ERROR);
+
+    struct TransferSetup
+    {
+        TransferControlFlags controlMode;
+        uint16_t maxBlockSize;
+        uint64_t startOffset;
+    };
+    const TransferSetup kSetups[kNumRequestors] = {
+        { TransferControlFlags::kReceiverDrive, 64, 0 },
+        { TransferControlFlags::kSenderDrive, 100, 333 },
+        { TransferControlFlags::kSenderDrive, 256, 10 },
+    };
+
+    // Keep the three transfers in progress after their second block.
+    TestRequestor requestors[kNumRequestors];
+    for (size_t i = 0; i < kNumRequestors; i++)
+    {
+        NL_TEST_ASSERT(inSuite, ctx.ConnectRequestor(i) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, ctx.PrepareTransfer(sender, i) == CHIP_NO_ERROR);
+
+        requestors[i].PauseAfter(2);
+        NL_TEST_ASSERT(inSuite,
+                       requestors[i].Start(ctx.GetExchangeManager(), ctx.GetRequestorSession(i), kSetups[i].controlMode,
+                                           kSetups[i].maxBlockSize, kSetups[i].startOffset, image.GetPath()) == CHIP_NO_ERROR);
+    }
+    ctx.DriveTransfersUntil([&requestors] {
+        return std::all_of(std::begin(requestors), std::end(requestors), [](const TestRequestor & r) { return r.IsPaused(); });
+    });
+
+    // All the transfers read the same mapping, each from its own offset.
+    const BdxImageCache::Entry * entry = FindImage(sender, image.GetPath());
+    NL_TEST_ASSERT(inSuite, entry != nullptr && entry->refCount == kNumRequestors);
+    NL_TEST_ASSERT(inSuite, sender.GetActiveTransferCount() == kNumRequestors);
+    for (size_t i = 0; i < kNumRequestors; i++)
+    {
+        const ByteSpan expected(sImageData + kSetups[i].startOffset, 2u * kSetups[i].maxBlockSize);
+        NL_TEST_ASSERT(inSuite, requestors[i].IsPaused());
+        NL_TEST_ASSERT(inSuite, requestors[i].GetReceivedData().data_equal(expected));
+    }
+
+    // Aborting one transfer leaves the others going.
+    requestors[1].Abort();
+    ctx.DriveTransfersUntil([&sender] { return sender.GetActiveTransferCount() == kNumRequestors - 1; });
+    NL_TEST_ASSERT(inSuite, requestors[1].GetError() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sender.GetActiveTransferCount() == kNumRequestors - 1);
+    NL_TEST_ASSERT(inSuite, entry != nullptr && entry->refCount == kNumRequestors - 1);
+
+    for (size_t i : { 0, 2 })
+    {
+        requestors[i].Resume();
+    }
+    ctx.DriveTransfersUntil([&requestors] { return requestors[0].IsComplete() && requestors[2].IsComplete(); });
+
+    for (size_t i : { 0, 2 })
+    {
+        const ByteSpan expected(sImageData + kSetups[i].startOffset, kImageSize - kSetups[i].startOffset);
+        NL_TEST_ASSERT(inSuite, requestors[i].IsComplete());
+        NL_TEST_ASSERT(inSuite, !requestors[i].HasStatus());
+        NL_TEST_ASSERT(inSuite, requestors[i].GetError() == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, requestors[i].GetReceivedData().data_equal(expected));
+    }
+    NL_TEST_ASSERT(inSuite, !requestors[1].IsComplete());
+    NL_TEST_ASSERT(inSuite, sender.GetActiveTransferCount() == 0);
+
+    // The mapping stays after the last transfer, and serves the next one.
+    NL_TEST_ASSERT(inSuite, FindImage(sender, image.GetPath()) == entry);
+    NL_TEST_ASSERT(inSuite, entry != nullptr && entry->refCount == 0);
+    const uint8_t * mapping = (entry != nullptr) ? entry->data : nullptr;
+
+    TestRequestor nextRequestor;
+    NL_TEST_ASSERT(inSuite, ctx.PrepareTransfer(sender, 1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   nextRequestor.Start(ctx.GetExchangeManager(), ctx.GetRequestorSession(1), TransferControlFlags::kSenderDrive,
+                                       kMaxBlockSize, 0, image.GetPath()) == CHIP_NO_ERROR);
+    ctx.DriveTransfersUntil([&nextRequestor] { return nextRequestor.IsComplete(); });
+    NL_TEST_ASSERT(inSuite, nextRequestor.IsComplete());
+    NL_TEST_ASSERT(inSuite, nextRequestor.GetReceivedData().data_equal(ByteSpan(sImageData)));
+    NL_TEST_ASSERT(inSuite, FindImage(sender, image.GetPath()) == entry);
+    NL_TEST_ASSERT(inSuite, entry != nullptr && entry->data == mapping);
+
+    FinishTransfers(ctx, sender);
+    ctx.GetExchangeManager().UnregisterUnsolicitedMessageHandlerForProtocol(Protocols::BDX::Id);
+}
+
+void TestBdxOtaSender::TestEvictionDuringTransfer(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+
+    TestImage image;
+    NL_TEST_ASSERT(inSuite, image.Create(ByteSpan(sImageData)) == CHIP_NO_ERROR);
+
+    BdxOtaSender sender;
+    NL_TEST_ASSERT(inSuite,
+                   ctx.GetExchangeManager().RegisterUnsolicitedMessageHandlerForProtocol(Protocols::BDX::Id, &sender) ==
+                       CHIP_NO_ERROR);
+
+    TestRequestor requestor;
+    NL_TEST_ASSERT(inSuite, ctx.ConnectRequestor(0) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctx.PrepareTransfer(sender, 0) == CHIP_NO_ERROR);
+    requestor.PauseAfter(1);
+    NL_TEST_ASSERT(inSuite,
+                   requestor.Start(ctx.GetExchangeManager(), ctx.GetRequestorSession(0), TransferControlFlags::kReceiverDrive, 128,
+                                   0, image.GetPath()) == CHIP_NO_ERROR);
+    ctx.DriveTransfersUntil([&requestor] { return requestor.IsPaused(); });
+    NL_TEST_ASSERT(inSuite, requestor.IsPaused());
+
+    // Other images go through all the other entries of the cache, more than once.
+    TestImage otherImages[BdxImageCache::kMaxImages * 2];
+    for (size_t i = 0; i < ArraySize(otherImages); i++)
+    {
+        ByteSpan otherImage;
+        NL_TEST_ASSERT(inSuite, otherImages[i].Create(ByteSpan(sImageData, i + 1)) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, sender.mImageCache.Acquire(otherImages[i].GetPath(), otherImage) == CHIP_NO_ERROR);
+        sender.mImageCache.Release(otherImage);
+    }
+    sender.mImageCache.Clear();
+
+    const BdxImageCache::Entry * entry = FindImage(sender, image.GetPath());
+    NL_TEST_ASSERT(inSuite, entry != nullptr && entry->refCount == 1);
+    NL_TEST_ASSERT(inSuite, FindImage(sender, otherImages[ArraySize(otherImages) - 1].GetPath()) == nullptr);
+
+    requestor.Resume();
+    ctx.DriveTransfersUntil([&requestor] { return requestor.IsComplete(); });
+    NL_TEST_ASSERT(inSuite, requestor.IsComplete());
+    NL_TEST_ASSERT(inSuite, requestor.GetError() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, requestor.GetReceivedData().data_equal(ByteSpan(sImageData)));
+    NL_TEST_ASSERT(inSuite, entry != nullptr && entry->refCount == 0);
+
+    FinishTransfers(ctx, sender);
+    ctx.GetExchangeManager().UnregisterUnsolicitedMessageHandlerForProtocol(Protocols::BDX::Id);
+}
+
+void TestBdxOtaSender::TestAllTransfersBusy(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx                              = *static_cast<TestContext *>(inContext);
+    constexpr System::Clock::Timeout kShortTimeout = System::Clock::Milliseconds32(200);
+
+    BdxOtaSender sender;
+    for (size_t i = 0; i < BdxOtaSender::kMaxTransfers; i++)
+    {
+        NL_TEST_ASSERT(inSuite, ctx.PrepareTransfer(sender, i, kShortTimeout) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite, sender.GetActiveTransferCount() == BdxOtaSender::kMaxTransfers);
+    NL_TEST_ASSERT(inSuite,
+                   sender.InitializeTransfer(ctx.GetAliceFabricIndex(), ctx.GetRequestorNodeId(BdxOtaSender::kMaxTransfers)) ==
+                       CHIP_ERROR_BUSY);
+
+    // A node asking again gets its transfer back.
+    NL_TEST_ASSERT(inSuite, ctx.PrepareTransfer(sender, 0, kShortTimeout) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sender.GetActiveTransferCount() == BdxOtaSender::kMaxTransfers);
+
+    // Transfers that their requestors never started are taken over once they time out.
+    ctx.GetIOContext().DriveIOUntil(kShortTimeout * 2, [] { return false; });
+    NL_TEST_ASSERT(inSuite, ctx.PrepareTransfer(sender, BdxOtaSender::kMaxTransfers) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sender.GetActiveTransferCount() == BdxOtaSender::kMaxTransfers);
+
+    FinishTransfers(ctx, sender);
+}
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+// clang-format off
+static const nlTest sTests[] = {
+    NL_TEST_DEF("Test concurrent transfers", TestBdxOtaSender::TestConcurrentTransfers),
+    NL_TEST_DEF("Test eviction during a transfer", TestBdxOtaSender::TestEvictionDuringTransfer),
+    NL_TEST_DEF("Test all transfers busy", TestBdxOtaSender::TestAllTransfersBusy),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+// clang-format off
+static nlTestSuite sSuite =
+{
+    "TestBdxOtaSender",
+    &sTests[0],
+    TestContext::SetUpTestSuite,
+    TestContext::TearDownTestSuite,
+    nullptr,
+    TestContext::TearDown,
+};
+// clang-format on
+
+int TestBdxOtaSenderSuite()
+{
+    return chip::ExecuteTestsWithContext<TestContext>(&sSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestBdxOtaSenderSuite);
@@ -70,6 +70,24 @@ bool CheckRequestPrivilegeAgainstEntryPrivilege(Privilege requestPrivilege, Priv
     return false;
 }
 
+#if CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE > 0
+// Returns the entry privileges which allow the request privilege, as a bit mask.
+uint8_t GetPrivilegesSufficientFor(Privilege requestPrivilege)
+{
+    constexpr Privilege kPrivileges[] = { Privilege::kView, Privilege::kProxyView, Privilege::kOperate, Privilege::kManage,
+                                          Privilege::kAdminister };
+    uint8_t sufficient                = 0;
+    for (auto privilege : kPrivileges)
+    {
+        if (CheckRequestPrivilegeAgainstEntryPrivilege(requestPrivilege, privilege))
+        {
+            sufficient = static_cast<uint8_t>(sufficient | to_underlying(privilege));
+        }
+    }
+    return sufficient;
+}
+#endif // CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE > 0
+
 constexpr bool IsValidCaseNodeId(NodeId aNodeId)
 {
     if (IsOperationalNodeId(aNodeId))
@@ -190,6 +208,7 @@ CHIP_ERROR AccessControl::Init(AccessControl::Delegate * delegate, DeviceTypeRes
     {
         mDelegate           = delegate;
         mDeviceTypeResolver = &deviceTypeResolver;
+        InvalidateCompiledSubjects();
     }
 
     return retval;
@@ -201,6 +220,7 @@ void AccessControl::Finish()
     ChipLogProgress(DataManagement, "AccessControl: finishing");
     mDelegate->Finish();
     mDelegate = nullptr;
+    InvalidateCompiledSubjects();
 }
 
 CHIP_ERROR AccessControl::CreateEntry(const SubjectDescriptor * subjectDescriptor, FabricIndex fabric, size_t * index,
@@ -218,6 +238,7 @@ CHIP_ERROR AccessControl::CreateEntry(const SubjectDescriptor * subjectDescripto
     ReturnErrorCodeIf(!IsValid(entry), CHIP_ERROR_INVALID_ARGUMENT);
 
     size_t i = 0;
+    InvalidateCompiledSubjects(fabric);
     ReturnErrorOnFailure(mDelegate->CreateEntry(&i, entry, &fabric));
 
     if (index)
@@ -234,6 +255,7 @@ CHIP_ERROR AccessControl::UpdateEntry(const SubjectDescriptor * subjectDescripto
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INCORRECT_STATE);
     ReturnErrorCodeIf(!IsValid(entry), CHIP_ERROR_INVALID_ARGUMENT);
+    InvalidateCompiledSubjects(fabric);
     ReturnErrorOnFailure(mDelegate->UpdateEntry(index, entry, &fabric));
     NotifyEntryChanged(subjectDescriptor, fabric, index, &entry, EntryListener::ChangeType::kUpdated);
     return CHIP_NO_ERROR;
@@ -248,6 +270,7 @@ CHIP_ERROR AccessControl::DeleteEntry(const SubjectDescriptor * subjectDescripto
     {
         p = &entry;
     }
+    InvalidateCompiledSubjects(fabric);
     ReturnErrorOnFailure(mDelegate->DeleteEntry(index, &fabric));
     if (p && p->HasDefaultDelegate())
     {
@@ -355,6 +378,31 @@ CHIP_ERROR AccessControl::Check(const SubjectDescriptor & subjectDescriptor, con
         return CHIP_NO_ERROR;
     }
 
+    CHIP_ERROR result = CHIP_ERROR_NOT_IMPLEMENTED;
+#if CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE > 0
+    result = CheckCompiled(subjectDescriptor, requestPath, requestPrivilege);
+#endif // CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE > 0
+    if (result == CHIP_ERROR_NOT_IMPLEMENTED)
+    {
+        result = CheckEntries(subjectDescriptor, requestPath, requestPrivilege);
+    }
+
+    if (result == CHIP_NO_ERROR)
+    {
+#if CHIP_CONFIG_ACCESS_CONTROL_POLICY_LOGGING_VERBOSITY > 0
+        ChipLogProgress(DataManagement, "AccessControl: allowed");
+#endif // CHIP_CONFIG_ACCESS_CONTROL_POLICY_LOGGING_VERBOSITY > 0
+    }
+    else if (result == CHIP_ERROR_ACCESS_DENIED)
+    {
+        ChipLogProgress(DataManagement, "AccessControl: denied");
+    }
+    return result;
+}
+
+CHIP_ERROR AccessControl::CheckEntries(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
+                                       Privilege requestPrivilege)
+{
     EntryIterator iterator;
     ReturnErrorOnFailure(Entries(iterator, &subjectDescriptor.fabricIndex));
 
@@ -377,52 +425,11 @@ CHIP_ERROR AccessControl::Check(const SubjectDescriptor & subjectDescriptor, con
             continue;
         }
 
-        size_t subjectCount = 0;
-        ReturnErrorOnFailure(entry.GetSubjectCount(subjectCount));
-        if (subjectCount > 0)
+        bool subjectMatched = false;
+        ReturnErrorOnFailure(MatchSubjects(entry, authMode, subjectDescriptor, subjectMatched));
+        if (!subjectMatched)
         {
-            bool subjectMatched = false;
-            for (size_t i = 0; i < subjectCount; ++i)
-            {
-                NodeId subject = kUndefinedNodeId;
-                ReturnErrorOnFailure(entry.GetSubject(i, subject));
-                if (IsOperationalNodeId(subject))
-                {
-                    VerifyOrReturnError(authMode == AuthMode::kCase, CHIP_ERROR_INCORRECT_STATE);
-                    if (subject == subjectDescriptor.subject)
-                    {
-                        subjectMatched = true;
-                        break;
-                    }
-                }
-                else if (IsCASEAuthTag(subject))
-                {
-                    VerifyOrReturnError(authMode == AuthMode::kCase, CHIP_ERROR_INCORRECT_STATE);
-                    if (subjectDescriptor.cats.CheckSubjectAgainstCATs(subject))
-                    {
-                        subjectMatched = true;
-                        break;
-                    }
-                }
-                else if (IsGroupId(subject))
-                {
-                    VerifyOrReturnError(authMode == AuthMode::kGroup, CHIP_ERROR_INCORRECT_STATE);
-                    if (subject == subjectDescriptor.subject)
-                    {
-                        subjectMatched = true;
-                        break;
-                    }
-                }
-                else
-                {
-                    // Operational PASE not supported for v1.0.
-                    return CHIP_ERROR_INCORRECT_STATE;
-                }
-            }
-            if (!subjectMatched)
-            {
-                continue;
-            }
+            continue;
         }
 
         size_t targetCount = 0;
@@ -434,21 +441,11 @@ CHIP_ERROR AccessControl::Check(const SubjectDescriptor & subjectDescriptor, con
             {
                 Entry::Target target;
                 ReturnErrorOnFailure(entry.GetTarget(i, target));
-                if ((target.flags & Entry::Target::kCluster) && target.cluster != requestPath.cluster)
-                {
-                    continue;
-                }
-                if ((target.flags & Entry::Target::kEndpoint) && target.endpoint != requestPath.endpoint)
-                {
-                    continue;
-                }
-                if (target.flags & Entry::Target::kDeviceType &&
-                    !mDeviceTypeResolver->IsDeviceTypeOnEndpoint(target.deviceType, requestPath.endpoint))
+                if (MatchTarget(target, requestPath))
                 {
-                    continue;
+                    targetMatched = true;
+                    break;
                 }
-                targetMatched = true;
-                break;
             }
             if (!targetMatched)
             {
@@ -456,19 +453,249 @@ CHIP_ERROR AccessControl::Check(const SubjectDescriptor & subjectDescriptor, con
             }
         }
         // Entry passed all checks: access is allowed.
+        return CHIP_NO_ERROR;
+    }
 
-#if CHIP_CONFIG_ACCESS_CONTROL_POLICY_LOGGING_VERBOSITY > 0
-        ChipLogProgress(DataManagement, "AccessControl: allowed");
-#endif // CHIP_CONFIG_ACCESS_CONTROL_POLICY_LOGGING_VERBOSITY > 0
+    // No entry was found which passed all checks: access is denied.
+    return CHIP_ERROR_ACCESS_DENIED;
+}
+
+CHIP_ERROR AccessControl::MatchSubjects(const Entry & entry, AuthMode authMode, const SubjectDescriptor & subjectDescriptor,
+                                        bool & matched)
+{
+    size_t subjectCount = 0;
+    ReturnErrorOnFailure(entry.GetSubjectCount(subjectCount));
+    // An entry without subjects applies to every subject.
+    matched = (subjectCount == 0);
+    for (size_t i = 0; i < subjectCount && !matched; ++i)
+    {
+        NodeId subject = kUndefinedNodeId;
+        ReturnErrorOnFailure(entry.GetSubject(i, subject));
+        if (IsOperationalNodeId(subject))
+        {
+            VerifyOrReturnError(authMode == AuthMode::kCase, CHIP_ERROR_INCORRECT_STATE);
+            matched = (subject == subjectDescriptor.subject);
+        }
+        else if (IsCASEAuthTag(subject))
+        {
+            VerifyOrReturnError(authMode == AuthMode::kCase, CHIP_ERROR_INCORRECT_STATE);
+            matched = subjectDescriptor.cats.CheckSubjectAgainstCATs(subject);
+        }
+        else if (IsGroupId(subject))
+        {
+            VerifyOrReturnError(authMode == AuthMode::kGroup, CHIP_ERROR_INCORRECT_STATE);
+            matched = (subject == subjectDescriptor.subject);
+        }
+        else
+        {
+            // Operational PASE not supported for v1.0.
+            return CHIP_ERROR_INCORRECT_STATE;
+        }
+    }
+    return CHIP_NO_ERROR;
+}
 
+bool AccessControl::MatchTarget(const Entry::Target & target, const RequestPath & requestPath)
+{
+    if ((target.flags & Entry::Target::kCluster) && target.cluster != requestPath.cluster)
+    {
+        return false;
+    }
+    if ((target.flags & Entry::Target::kEndpoint) && target.endpoint != requestPath.endpoint)
+    {
+        return false;
+    }
+    if (target.flags & Entry::Target::kDeviceType &&
+        !mDeviceTypeResolver->IsDeviceTypeOnEndpoint(target.deviceType, requestPath.endpoint))
+    {
+        return false;
+    }
+    return true;
+}
+
+void AccessControl::InvalidateCompiledSubjects()
+{
+#if CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE > 0
+    for (auto & compiled : mCompiledSubjects)
+    {
+        compiled.inUse = false;
+    }
+#endif // CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE > 0
+}
+
+void AccessControl::InvalidateCompiledSubjects(FabricIndex fabric)
+{
+#if CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE > 0
+    for (auto & compiled : mCompiledSubjects)
+    {
+        if (compiled.subjectDescriptor.fabricIndex == fabric)
+        {
+            compiled.inUse = false;
+        }
+    }
+#endif // CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE > 0
+}
+
+#if CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE > 0
+
+CHIP_ERROR AccessControl::CheckCompiled(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
+                                        Privilege requestPrivilege)
+{
+    // Only CASE and group subjects have entries; leave anything else to the entries check, which denies it.
+    VerifyOrReturnError(subjectDescriptor.authMode == AuthMode::kCase || subjectDescriptor.authMode == AuthMode::kGroup,
+                        CHIP_ERROR_NOT_IMPLEMENTED);
+
+    CompiledSubject * compiled = GetCompiledSubject(subjectDescriptor);
+    VerifyOrReturnError(compiled != nullptr, CHIP_ERROR_NOT_IMPLEMENTED);
+
+    const uint8_t sufficientPrivileges = GetPrivilegesSufficientFor(requestPrivilege);
+    if (GetGrantedPrivileges(*compiled, requestPath) & sufficientPrivileges)
+    {
         return CHIP_NO_ERROR;
     }
 
-    // No entry was found which passed all checks: access is denied.
-    ChipLogProgress(DataManagement, "AccessControl: denied");
+    // Whether a device type is on an endpoint can change at any time, so these grants are never memoized.
+    if (compiled->hasDeviceTypeGrants)
+    {
+        for (uint8_t i = 0; i < compiled->grantCount; ++i)
+        {
+            const auto & grant = compiled->grants[i];
+            if ((grant.target.flags & Entry::Target::kDeviceType) && (to_underlying(grant.privilege) & sufficientPrivileges) &&
+                MatchTarget(grant.target, requestPath))
+            {
+                return CHIP_NO_ERROR;
+            }
+        }
+    }
+
     return CHIP_ERROR_ACCESS_DENIED;
 }
 
+AccessControl::CompiledSubject * AccessControl::GetCompiledSubject(const SubjectDescriptor & subjectDescriptor)
+{
+    CompiledSubject * victim = nullptr;
+    for (auto & compiled : mCompiledSubjects)
+    {
+        const SubjectDescriptor & cached = compiled.subjectDescriptor;
+        if (compiled.inUse && cached.fabricIndex == subjectDescriptor.fabricIndex &&
+            cached.authMode == subjectDescriptor.authMode && cached.subject == subjectDescriptor.subject &&
+            cached.cats == subjectDescriptor.cats)
+        {
+            compiled.lastUsed = ++mCompiledSubjectUseCount;
+            return compiled.tooManyGrants ? nullptr : &compiled;
+        }
+        if (victim == nullptr || (victim->inUse && (!compiled.inUse || compiled.lastUsed < victim->lastUsed)))
+        {
+            victim = &compiled;
+        }
+    }
+
+    victim->subjectDescriptor = subjectDescriptor;
+    if (CompileSubject(*victim) != CHIP_NO_ERROR)
+    {
+        // Leave it to the entries check to report the error.
+        victim->inUse = false;
+        return nullptr;
+    }
+    victim->inUse    = true;
+    victim->lastUsed = ++mCompiledSubjectUseCount;
+    return victim->tooManyGrants ? nullptr : victim;
+}
+
+CHIP_ERROR AccessControl::CompileSubject(CompiledSubject & compiled)
+{
+    const SubjectDescriptor & subjectDescriptor = compiled.subjectDescriptor;
+    compiled.grantCount                         = 0;
+    compiled.pathMemoCount                      = 0;
+    compiled.nextPathMemo                       = 0;
+    compiled.tooManyGrants                      = false;
+    compiled.hasDeviceTypeGrants                = false;
+
+    EntryIterator iterator;
+    ReturnErrorOnFailure(Entries(iterator, &subjectDescriptor.fabricIndex));
+
+    Entry entry;
+    while (iterator.Next(entry) == CHIP_NO_ERROR)
+    {
+        AuthMode authMode = AuthMode::kNone;
+        ReturnErrorOnFailure(entry.GetAuthMode(authMode));
+        VerifyOrReturnError(authMode == AuthMode::kCase || authMode == AuthMode::kGroup, CHIP_ERROR_INCORRECT_STATE);
+        if (authMode != subjectDescriptor.authMode)
+        {
+            continue;
+        }
+
+        bool subjectMatched = false;
+        ReturnErrorOnFailure(MatchSubjects(entry, authMode, subjectDescriptor, subjectMatched));
+        if (!subjectMatched)
+        {
+            continue;
+        }
+
+        Privilege privilege = Privilege::kView;
+        size_t targetCount  = 0;
+        ReturnErrorOnFailure(entry.GetPrivilege(privilege));
+        ReturnErrorOnFailure(entry.GetTargetCount(targetCount));
+
+        // An entry without targets is compiled to a single grant with empty flags, which matches every path.
+        const size_t grantCount = (targetCount > 0) ? targetCount : 1;
+        for (size_t i = 0; i < grantCount; ++i)
+        {
+            if (compiled.grantCount == CompiledSubject::kMaxGrants)
+            {
+                compiled.tooManyGrants = true;
+                return CHIP_NO_ERROR;
+            }
+            auto & grant    = compiled.grants[compiled.grantCount++];
+            grant.privilege = privilege;
+            grant.target    = Entry::Target();
+            if (targetCount > 0)
+            {
+                ReturnErrorOnFailure(entry.GetTarget(i, grant.target));
+            }
+            compiled.hasDeviceTypeGrants = compiled.hasDeviceTypeGrants || (grant.target.flags & Entry::Target::kDeviceType);
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+uint8_t AccessControl::GetGrantedPrivileges(CompiledSubject & compiled, const RequestPath & requestPath)
+{
+    for (uint8_t i = 0; i < compiled.pathMemoCount; ++i)
+    {
+        const auto & memo = compiled.pathMemos[i];
+        if (memo.cluster == requestPath.cluster && memo.endpoint == requestPath.endpoint)
+        {
+            return memo.privileges;
+        }
+    }
+
+    uint8_t privileges = 0;
+    for (uint8_t i = 0; i < compiled.grantCount; ++i)
+    {
+        const auto & grant = compiled.grants[i];
+        if (!(grant.target.flags & Entry::Target::kDeviceType) && MatchTarget(grant.target, requestPath))
+        {
+            privileges = static_cast<uint8_t>(privileges | to_underlying(grant.privilege));
+        }
+    }
+
+    // Replace the memos round robin: checks come in runs for the same path, e.g. for each attribute of a cluster.
+    auto & memo           = compiled.pathMemos[compiled.nextPathMemo];
+    memo.cluster          = requestPath.cluster;
+    memo.endpoint         = requestPath.endpoint;
+    memo.privileges       = privileges;
+    compiled.nextPathMemo = static_cast<uint8_t>((compiled.nextPathMemo + 1) % CompiledSubject::kMaxPathMemos);
+    if (compiled.pathMemoCount < CompiledSubject::kMaxPathMemos)
+    {
+        compiled.pathMemoCount++;
+    }
+    return privileges;
+}
+
+#endif // CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE > 0
+
 #if CHIP_ACCESS_CONTROL_DUMP_ENABLED
 CHIP_ERROR AccessControl::Dump(const Entry & entry)
 {
@@ -497,6 +497,7 @@ public:
     {
         ReturnErrorCodeIf(!IsValid(entry), CHIP_ERROR_INVALID_ARGUMENT);
         VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INCORRECT_STATE);
+        InvalidateCompiledSubjects();
         return mDelegate->CreateEntry(index, entry, fabricIndex);
     }
 
@@ -547,6 +548,7 @@ public:
     {
         ReturnErrorCodeIf(!IsValid(entry), CHIP_ERROR_INVALID_ARGUMENT);
         VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INCORRECT_STATE);
+        InvalidateCompiledSubjects();
         return mDelegate->UpdateEntry(index, entry, fabricIndex);
     }
 
@@ -568,6 +570,7 @@ public:
     CHIP_ERROR DeleteEntry(size_t index, const FabricIndex * fabricIndex = nullptr)
     {
         VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INCORRECT_STATE);
+        InvalidateCompiledSubjects();
         return mDelegate->DeleteEntry(index, fabricIndex);
     }
 
@@ -642,6 +645,42 @@ public:
 #endif
 
 private:
+#if CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE > 0
+    /**
+     * The entries that apply to one subject, compiled down to the targets and privileges they grant it, along with
+     * the privileges granted on the paths it most recently accessed.
+     */
+    struct CompiledSubject
+    {
+        static constexpr size_t kMaxGrants    = CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_MAX_GRANTS;
+        static constexpr size_t kMaxPathMemos = 4;
+
+        struct Grant
+        {
+            Entry::Target target; // Flags are empty if the entry has no targets, i.e. grants access to every path.
+            Privilege privilege;
+        };
+
+        struct PathMemo
+        {
+            ClusterId cluster;
+            EndpointId endpoint;
+            uint8_t privileges; // Bit mask of the privileges granted on the path by grants without a device type.
+        };
+
+        SubjectDescriptor subjectDescriptor;
+        Grant grants[kMaxGrants];
+        PathMemo pathMemos[kMaxPathMemos];
+        uint32_t lastUsed;
+        uint8_t grantCount;
+        uint8_t pathMemoCount;
+        uint8_t nextPathMemo;
+        bool inUse;
+        bool tooManyGrants; // The grants did not fit, so checks for this subject fall back to the entries.
+        bool hasDeviceTypeGrants;
+    };
+#endif // CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE > 0
+
     bool IsInitialized() const { return (mDelegate != nullptr); }
 
     bool IsValid(const Entry & entry);
@@ -649,12 +688,39 @@ private:
     void NotifyEntryChanged(const SubjectDescriptor * subjectDescriptor, FabricIndex fabric, size_t index, const Entry * entry,
                             EntryListener::ChangeType changeType);
 
+    CHIP_ERROR CheckEntries(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
+                            Privilege requestPrivilege);
+    CHIP_ERROR MatchSubjects(const Entry & entry, AuthMode authMode, const SubjectDescriptor & subjectDescriptor, bool & matched);
+    bool MatchTarget(const Entry::Target & target, const RequestPath & requestPath);
+
+    // Drop compiled subjects, of all fabrics or of one fabric, because entries changed.
+    void InvalidateCompiledSubjects();
+    void InvalidateCompiledSubjects(FabricIndex fabric);
+
+#if CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE > 0
+    /**
+     * Check against the compiled entries of the subject, compiling them first if needed.
+     *
+     * @retval #CHIP_ERROR_NOT_IMPLEMENTED if the subject cannot be compiled, and the entries must be checked instead.
+     */
+    CHIP_ERROR CheckCompiled(const SubjectDescriptor & subjectDescriptor, const RequestPath & requestPath,
+                             Privilege requestPrivilege);
+    CompiledSubject * GetCompiledSubject(const SubjectDescriptor & subjectDescriptor);
+    CHIP_ERROR CompileSubject(CompiledSubject & compiled);
+    uint8_t GetGrantedPrivileges(CompiledSubject & compiled, const RequestPath & requestPath);
+#endif // CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE > 0
+
 private:
     Delegate * mDelegate = nullptr;
 
     DeviceTypeResolver * mDeviceTypeResolver = nullptr;
 
     EntryListener * mEntryListener = nullptr;
+
+#if CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE > 0
+    CompiledSubject mCompiledSubjects[CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE] = {};
+    uint32_t mCompiledSubjectUseCount                                                = 0;
+#endif // CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE > 0
 };
 
 /**
@@ -421,7 +421,24 @@ constexpr DeviceTypeId invalidDeviceTypes[] = {
 class DeviceTypeResolver : public AccessControl::DeviceTypeResolver
 {
 public:
-    bool IsDeviceTypeOnEndpoint(DeviceTypeId deviceType, EndpointId endpoint) override { return false; }
+    bool IsDeviceTypeOnEndpoint(DeviceTypeId deviceType, EndpointId endpoint) override
+    {
+        return mHasDeviceType && deviceType == mDeviceType && endpoint == mEndpoint;
+    }
+
+    void SetDeviceTypeOnEndpoint(DeviceTypeId deviceType, EndpointId endpoint)
+    {
+        mHasDeviceType = true;
+        mDeviceType    = deviceType;
+        mEndpoint      = endpoint;
+    }
+
+    void ClearDeviceType() { mHasDeviceType = false; }
+
+private:
+    bool mHasDeviceType      = false;
+    DeviceTypeId mDeviceType = 0;
+    EndpointId mEndpoint     = kInvalidEndpointId;
 } testDeviceTypeResolver;
 
 // For testing, supports one subject and target, allows any value (valid or invalid)
@@ -1760,6 +1777,96 @@ void TestCheck(nlTestSuite * inSuite, void * inContext)
     }
 }
 
+CHIP_ERROR UpdateAccessControl(AccessControl & ac, size_t index, const EntryData & entryData)
+{
+    Entry entry;
+    ReturnErrorOnFailure(ac.PrepareEntry(entry));
+    ReturnErrorOnFailure(LoadEntry(entry, entryData));
+    return ac.UpdateEntry(index, entry);
+}
+
+void TestCheckCompiledSubjects(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr DeviceTypeId kDimmableLight = 0x0000'0101;
+
+    const SubjectDescriptor subjectDescriptor = { .fabricIndex = 1, .authMode = AuthMode::kCase, .subject = kOperationalNodeId1 };
+    const RequestPath onOffPath               = { .cluster = kOnOffCluster, .endpoint = 1 };
+    const RequestPath levelControlPath        = { .cluster = kLevelControlCluster, .endpoint = 1 };
+
+    EntryData data = {
+        .fabricIndex = 1,
+        .privilege   = Privilege::kOperate,
+        .authMode    = AuthMode::kCase,
+        .subjects    = { kOperationalNodeId1 },
+        .targets     = { { .flags = Target::kCluster, .cluster = kOnOffCluster } },
+    };
+    NL_TEST_ASSERT(inSuite, LoadAccessControl(accessControl, &data, 1) == CHIP_NO_ERROR);
+
+    // Repeated checks are answered from the compiled subject, and must give the same results.
+    for (int i = 0; i < 3; ++i)
+    {
+        NL_TEST_ASSERT(inSuite, accessControl.Check(subjectDescriptor, onOffPath, Privilege::kOperate) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, accessControl.Check(subjectDescriptor, onOffPath, Privilege::kView) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite,
+                       accessControl.Check(subjectDescriptor, onOffPath, Privilege::kManage) == CHIP_ERROR_ACCESS_DENIED);
+        NL_TEST_ASSERT(inSuite,
+                       accessControl.Check(subjectDescriptor, levelControlPath, Privilege::kView) == CHIP_ERROR_ACCESS_DENIED);
+    }
+
+    // Changes to the entries are seen by the next check, whichever API makes them.
+    data.targets[0].cluster = kLevelControlCluster;
+    NL_TEST_ASSERT(inSuite, UpdateAccessControl(accessControl, 0, data) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, accessControl.Check(subjectDescriptor, onOffPath, Privilege::kOperate) == CHIP_ERROR_ACCESS_DENIED);
+    NL_TEST_ASSERT(inSuite, accessControl.Check(subjectDescriptor, levelControlPath, Privilege::kOperate) == CHIP_NO_ERROR);
+
+    {
+        data.privilege = Privilege::kView;
+        Entry entry;
+        NL_TEST_ASSERT(inSuite, accessControl.PrepareEntry(entry) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, LoadEntry(entry, data) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, accessControl.UpdateEntry(nullptr, 1, 0, entry) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite,
+                   accessControl.Check(subjectDescriptor, levelControlPath, Privilege::kOperate) == CHIP_ERROR_ACCESS_DENIED);
+    NL_TEST_ASSERT(inSuite, accessControl.Check(subjectDescriptor, levelControlPath, Privilege::kView) == CHIP_NO_ERROR);
+
+    // Subjects on other fabrics, or with other CATs, are compiled separately.
+    {
+        SubjectDescriptor otherFabric = subjectDescriptor;
+        otherFabric.fabricIndex       = 2;
+        NL_TEST_ASSERT(inSuite,
+                       accessControl.Check(otherFabric, levelControlPath, Privilege::kView) == CHIP_ERROR_ACCESS_DENIED);
+
+        data.subjects[0] = kCASEAuthTagAsNodeId0;
+        NL_TEST_ASSERT(inSuite, UpdateAccessControl(accessControl, 0, data) == CHIP_NO_ERROR);
+        SubjectDescriptor withCat = subjectDescriptor;
+        withCat.cats.values[0]    = kCASEAuthTag0;
+        NL_TEST_ASSERT(inSuite, accessControl.Check(withCat, levelControlPath, Privilege::kView) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite,
+                       accessControl.Check(subjectDescriptor, levelControlPath, Privilege::kView) == CHIP_ERROR_ACCESS_DENIED);
+        data.subjects[0] = kOperationalNodeId1;
+    }
+
+    // Device types can come and go on an endpoint, so they are resolved on every check.
+    data.targets[0] = { .flags = Target::kDeviceType, .deviceType = kDimmableLight };
+    NL_TEST_ASSERT(inSuite, UpdateAccessControl(accessControl, 0, data) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   accessControl.Check(subjectDescriptor, levelControlPath, Privilege::kView) == CHIP_ERROR_ACCESS_DENIED);
+    testDeviceTypeResolver.SetDeviceTypeOnEndpoint(kDimmableLight, levelControlPath.endpoint);
+    NL_TEST_ASSERT(inSuite, accessControl.Check(subjectDescriptor, levelControlPath, Privilege::kView) == CHIP_NO_ERROR);
+    testDeviceTypeResolver.ClearDeviceType();
+    NL_TEST_ASSERT(inSuite,
+                   accessControl.Check(subjectDescriptor, levelControlPath, Privilege::kView) == CHIP_ERROR_ACCESS_DENIED);
+
+    // Deleting the entry denies access again.
+    data.targets[0] = { .flags = Target::kEndpoint, .endpoint = levelControlPath.endpoint };
+    NL_TEST_ASSERT(inSuite, UpdateAccessControl(accessControl, 0, data) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, accessControl.Check(subjectDescriptor, levelControlPath, Privilege::kView) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, accessControl.DeleteEntry(nullptr, 1, 0) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   accessControl.Check(subjectDescriptor, levelControlPath, Privilege::kView) == CHIP_ERROR_ACCESS_DENIED);
+}
+
 void TestCreateReadEntry(nlTestSuite * inSuite, void * inContext)
 {
     for (size_t i = 0; i < entryData1Count; ++i)
@@ -2235,6 +2342,7 @@ int TestAccessControl()
         NL_TEST_DEF("TestFabricFilteredReadEntry", TestFabricFilteredReadEntry),
         NL_TEST_DEF("TestFabricFilteredCreateEntry", TestFabricFilteredCreateEntry),
         NL_TEST_DEF("TestCheck", TestCheck),
+        NL_TEST_DEF("TestCheckCompiledSubjects", TestCheckCompiledSubjects),
         NL_TEST_SENTINEL()
     };
     // clang-format on
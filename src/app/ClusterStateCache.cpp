@@ -68,9 +68,10 @@ CHIP_ERROR ClusterStateCache::UpdateCache(const ConcreteDataAttributePath & aPat
                                           const StatusIB & aStatus)
 {
     AttributeState state;
+    size_t elementSize = 0;
     bool endpointIsNew = false;
 
-    if (mCache.find(aPath.mEndpointId) == mCache.end())
+    if (!HasEndpoint(aPath.mEndpointId))
     {
         //
         // Since we might potentially be creating a new entry at mCache[aPath.mEndpointId][aPath.mClusterId] that
@@ -82,10 +83,10 @@ CHIP_ERROR ClusterStateCache::UpdateCache(const ConcreteDataAttributePath & aPat
 
     if (apData)
     {
-        size_t elementSize = 0;
         ReturnErrorOnFailure(GetElementTLVSize(apData, elementSize));
 
-        if (mCacheData)
+        // The flat store makes its own copy of the data, in UpdateFlatStore().
+        if (mCacheData && mAttributeStorage == AttributeStorage::kMap)
         {
             Platform::ScopedMemoryBufferWithSize<uint8_t> backingBuffer;
             backingBuffer.Calloc(elementSize);
@@ -104,7 +105,7 @@ CHIP_ERROR ClusterStateCache::UpdateCache(const ConcreteDataAttributePath & aPat
         // Clear out the committed data version and only set it again once we have received all data for this cluster.
         // Otherwise, we may have incomplete data that looks like it's complete since it has a valid data version.
         //
-        mCache[aPath.mEndpointId][aPath.mClusterId].mCommittedDataVersion.ClearValue();
+        CommittedDataVersion(aPath.mEndpointId, aPath.mClusterId).ClearValue();
 
         // This commits a pending data version if the last report path is valid and it is different from the current path.
         if (mLastReportDataPath.IsValidConcreteClusterPath() && mLastReportDataPath != aPath)
@@ -125,7 +126,7 @@ CHIP_ERROR ClusterStateCache::UpdateCache(const ConcreteDataAttributePath & aPat
         // if this data item is encompassed by a wildcard path, let's go ahead and update its pending data version.
         if (foundEncompassingWildcardPath)
         {
-            mCache[aPath.mEndpointId][aPath.mClusterId].mPendingDataVersion = aPath.mDataVersion;
+            PendingDataVersion(aPath.mEndpointId, aPath.mClusterId) = aPath.mDataVersion;
         }
 
         mLastReportDataPath = aPath;
@@ -142,6 +143,11 @@ CHIP_ERROR ClusterStateCache::UpdateCache(const ConcreteDataAttributePath & aPat
         }
     }
 
+    if (mAttributeStorage == AttributeStorage::kFlat)
+    {
+        ReturnErrorOnFailure(UpdateFlatStore(aPath, apData, elementSize, aStatus));
+    }
+
     //
     // if the endpoint didn't exist previously, let's track the insertion
     // so that we can inform our callback of a new endpoint being added appropriately.
@@ -151,7 +157,10 @@ CHIP_ERROR ClusterStateCache::UpdateCache(const ConcreteDataAttributePath & aPat
         mAddedEndpoints.push_back(aPath.mEndpointId);
     }
 
-    mCache[aPath.mEndpointId][aPath.mClusterId].mAttributes[aPath.mAttributeId] = std::move(state);
+    if (mAttributeStorage == AttributeStorage::kMap)
+    {
+        mCache[aPath.mEndpointId][aPath.mClusterId].mAttributes[aPath.mAttributeId] = std::move(state);
+    }
 
     if (mCacheData)
     {
@@ -161,6 +170,51 @@ CHIP_ERROR ClusterStateCache::UpdateCache(const ConcreteDataAttributePath & aPat
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR ClusterStateCache::UpdateFlatStore(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData,
+                                              size_t aElementSize, const StatusIB & aStatus)
+{
+    if (!mCacheData)
+    {
+        mFlatStore.SetSize(aPath, apData ? aElementSize : SizeOfStatusIB(aStatus));
+    }
+    else if (apData)
+    {
+        ReturnErrorOnFailure(mFlatStore.SetData(aPath, *apData, aElementSize));
+    }
+    else
+    {
+        mFlatStore.SetStatus(aPath, aStatus);
+    }
+    return CHIP_NO_ERROR;
+}
+
+bool ClusterStateCache::HasEndpoint(EndpointId endpointId) const
+{
+    if (mAttributeStorage == AttributeStorage::kFlat)
+    {
+        return mFlatStore.HasEndpoint(endpointId);
+    }
+    return mCache.find(endpointId) != mCache.end();
+}
+
+Optional<DataVersion> & ClusterStateCache::PendingDataVersion(EndpointId endpointId, ClusterId clusterId)
+{
+    if (mAttributeStorage == AttributeStorage::kFlat)
+    {
+        return mFlatStore.FindOrAddCluster(endpointId, clusterId).mPendingDataVersion;
+    }
+    return mCache[endpointId][clusterId].mPendingDataVersion;
+}
+
+Optional<DataVersion> & ClusterStateCache::CommittedDataVersion(EndpointId endpointId, ClusterId clusterId)
+{
+    if (mAttributeStorage == AttributeStorage::kFlat)
+    {
+        return mFlatStore.FindOrAddCluster(endpointId, clusterId).mCommittedDataVersion;
+    }
+    return mCache[endpointId][clusterId].mCommittedDataVersion;
+}
+
 CHIP_ERROR ClusterStateCache::UpdateEventCache(const EventHeader & aEventHeader, TLV::TLVReader * apData, const StatusIB * apStatus)
 {
     if (apData)
@@ -212,6 +266,13 @@ void ClusterStateCache::OnReportBegin()
 {
     mLastReportDataPath = ConcreteClusterPath(kInvalidEndpointId, kInvalidClusterId);
     mChangedAttributeSet.clear();
+
+    // Attribute values may be repacked here: buffers from Get() are not to be held across async call boundaries,
+    // and the start of a new report is one.
+    if (mAttributeStorage == AttributeStorage::kFlat)
+    {
+        mFlatStore.Compact();
+    }
     mAddedEndpoints.clear();
     mCallback.OnReportBegin();
 }
@@ -223,11 +284,12 @@ void ClusterStateCache::CommitPendingDataVersion()
         return;
     }
 
-    auto & lastClusterInfo = mCache[mLastReportDataPath.mEndpointId][mLastReportDataPath.mClusterId];
-    if (lastClusterInfo.mPendingDataVersion.HasValue())
+    auto & pendingDataVersion = PendingDataVersion(mLastReportDataPath.mEndpointId, mLastReportDataPath.mClusterId);
+    if (pendingDataVersion.HasValue())
     {
-        lastClusterInfo.mCommittedDataVersion = lastClusterInfo.mPendingDataVersion;
-        lastClusterInfo.mPendingDataVersion.ClearValue();
+        // The cluster exists now, so this does not add anything that could move pendingDataVersion.
+        CommittedDataVersion(mLastReportDataPath.mEndpointId, mLastReportDataPath.mClusterId) = pendingDataVersion;
+        pendingDataVersion.ClearValue();
     }
 }
 
@@ -262,6 +324,16 @@ void ClusterStateCache::OnReportEnd()
 
 CHIP_ERROR ClusterStateCache::Get(const ConcreteAttributePath & path, TLV::TLVReader & reader) const
 {
+    if (mAttributeStorage == AttributeStorage::kFlat)
+    {
+        const auto * attribute = mFlatStore.FindAttribute(path);
+        VerifyOrReturnError(attribute != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+        VerifyOrReturnError(attribute->mKind != FlatAttributeStore::Attribute::Kind::kStatus, CHIP_ERROR_IM_STATUS_CODE_RECEIVED);
+        VerifyOrReturnError(attribute->mKind == FlatAttributeStore::Attribute::Kind::kData, CHIP_ERROR_KEY_NOT_FOUND);
+        reader.Init(mFlatStore.GetData(*attribute));
+        return reader.Next();
+    }
+
     CHIP_ERROR err;
     auto attributeState = GetAttributeState(path.mEndpointId, path.mClusterId, path.mAttributeId, err);
     ReturnErrorOnFailure(err);
@@ -397,6 +469,14 @@ void ClusterStateCache::OnAttributeData(const ConcreteDataAttributePath & aPath,
 CHIP_ERROR ClusterStateCache::GetVersion(const ConcreteClusterPath & aPath, Optional<DataVersion> & aVersion) const
 {
     VerifyOrReturnError(aPath.IsValidConcreteClusterPath(), CHIP_ERROR_INVALID_ARGUMENT);
+    if (mAttributeStorage == AttributeStorage::kFlat)
+    {
+        const auto * cluster = mFlatStore.FindCluster(aPath.mEndpointId, aPath.mClusterId);
+        VerifyOrReturnError(cluster != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+        aVersion = cluster->mCommittedDataVersion;
+        return CHIP_NO_ERROR;
+    }
+
     CHIP_ERROR err;
     auto clusterState = GetClusterState(aPath.mEndpointId, aPath.mClusterId, err);
     ReturnErrorOnFailure(err);
@@ -420,6 +500,15 @@ void ClusterStateCache::OnEventData(const EventHeader & aEventHeader, TLV::TLVRe
 
 CHIP_ERROR ClusterStateCache::GetStatus(const ConcreteAttributePath & path, StatusIB & status) const
 {
+    if (mAttributeStorage == AttributeStorage::kFlat)
+    {
+        const auto * attribute = mFlatStore.FindAttribute(path);
+        VerifyOrReturnError(attribute != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+        VerifyOrReturnError(attribute->mKind == FlatAttributeStore::Attribute::Kind::kStatus, CHIP_ERROR_INVALID_ARGUMENT);
+        status = attribute->mStatus;
+        return CHIP_NO_ERROR;
+    }
+
     CHIP_ERROR err;
 
     auto attributeState = GetAttributeState(path.mEndpointId, path.mClusterId, path.mAttributeId, err);
@@ -448,6 +537,31 @@ CHIP_ERROR ClusterStateCache::GetStatus(const ConcreteEventPath & path, StatusIB
 
 void ClusterStateCache::GetSortedFilters(std::vector<std::pair<DataVersionFilter, size_t>> & aVector) const
 {
+    // Only one of mFlatStore and mCache holds anything, depending on mAttributeStorage.
+    for (auto const & cluster : mFlatStore.GetClusters())
+    {
+        if (!cluster.mCommittedDataVersion.HasValue())
+        {
+            continue;
+        }
+
+        size_t clusterSize = 0;
+        for (auto const & attribute : mFlatStore.GetAttributes(cluster.mEndpointId, cluster.mClusterId))
+        {
+            // Stored data is exactly one anonymous element, so its length is the amount of value data.
+            clusterSize += (attribute.mKind == FlatAttributeStore::Attribute::Kind::kStatus) ? SizeOfStatusIB(attribute.mStatus)
+                                                                                            : attribute.mLength;
+        }
+
+        if (clusterSize == 0)
+        {
+            continue;
+        }
+
+        DataVersionFilter filter(cluster.mEndpointId, cluster.mClusterId, cluster.mCommittedDataVersion.Value());
+        aVector.push_back(std::make_pair(filter, clusterSize));
+    }
+
     for (auto const & endpointIter : mCache)
     {
         EndpointId endpointId = endpointIter.first;
@@ -24,6 +24,7 @@
 #include <app/AppConfig.h>
 #include <app/AttributePathParams.h>
 #include <app/BufferedReadCallback.h>
+#include <app/FlatAttributeStore.h>
 #include <app/ReadClient.h>
 #include <app/data-model/DecodableList.h>
 #include <app/data-model/Decode.h>
@@ -96,6 +97,19 @@ public:
         virtual void OnEndpointAdded(ClusterStateCache * cache, EndpointId endpointId){};
     };
 
+    /*
+     * How the cache stores attributes.
+     */
+    enum class AttributeStorage : uint8_t
+    {
+        // Nested maps of endpoints, clusters and attributes, with a separate allocation for each attribute value.
+        kMap,
+        // Flat arrays of clusters and attributes sorted by path, with attribute values packed into shared blocks (see
+        // FlatAttributeStore). Better suited to controllers caching many nodes, at the cost of attribute values moving
+        // when a new report begins, so the buffers returned by Get() must not be held across async call boundaries.
+        kFlat,
+    };
+
     /**
      *
      * @param [in] callback the derived callback which inherit from ReadClient::Callback
@@ -103,11 +117,12 @@ public:
      *             less than or equal to this value, skip those events
      * @param [in] cacheData boolean to decide whether this cache would store attribute/event data/status,
      *             the default is true.
+     * @param [in] attributeStorage how to store attributes, the default is AttributeStorage::kMap.
      */
     ClusterStateCache(Callback & callback, Optional<EventNumber> highestReceivedEventNumber = Optional<EventNumber>::Missing(),
-                      bool cacheData = true) :
+                      bool cacheData = true, AttributeStorage attributeStorage = AttributeStorage::kMap) :
         mCallback(callback),
-        mBufferedReader(*this), mCacheData(cacheData)
+        mBufferedReader(*this), mCacheData(cacheData), mAttributeStorage(attributeStorage)
     {
         mHighestReceivedEventNumber = highestReceivedEventNumber;
     }
@@ -366,6 +381,17 @@ public:
     template <typename IteratorFunc>
     CHIP_ERROR ForEachAttribute(EndpointId endpointId, ClusterId clusterId, IteratorFunc func) const
     {
+        if (mAttributeStorage == AttributeStorage::kFlat)
+        {
+            VerifyOrReturnError(mFlatStore.FindCluster(endpointId, clusterId) != nullptr, CHIP_ERROR_KEY_NOT_FOUND);
+            for (auto & attribute : mFlatStore.GetAttributes(endpointId, clusterId))
+            {
+                const ConcreteAttributePath path(endpointId, clusterId, attribute.mAttributeId);
+                ReturnErrorOnFailure(func(path));
+            }
+            return CHIP_NO_ERROR;
+        }
+
         CHIP_ERROR err;
 
         auto clusterState = GetClusterState(endpointId, clusterId, err);
@@ -396,6 +422,22 @@ public:
     template <typename IteratorFunc>
     CHIP_ERROR ForEachAttribute(ClusterId clusterId, IteratorFunc func) const
     {
+        if (mAttributeStorage == AttributeStorage::kFlat)
+        {
+            for (auto & cluster : mFlatStore.GetClusters())
+            {
+                if (cluster.mClusterId == clusterId)
+                {
+                    for (auto & attribute : mFlatStore.GetAttributes(cluster.mEndpointId, clusterId))
+                    {
+                        const ConcreteAttributePath path(cluster.mEndpointId, clusterId, attribute.mAttributeId);
+                        ReturnErrorOnFailure(func(path));
+                    }
+                }
+            }
+            return CHIP_NO_ERROR;
+        }
+
         for (auto & endpointIter : mCache)
         {
             for (auto & clusterIter : endpointIter.second)
@@ -429,8 +471,17 @@ public:
     template <typename IteratorFunc>
     CHIP_ERROR ForEachCluster(EndpointId endpointId, IteratorFunc func) const
     {
+        if (mAttributeStorage == AttributeStorage::kFlat)
+        {
+            for (auto & cluster : mFlatStore.GetClusters(endpointId))
+            {
+                ReturnErrorOnFailure(func(cluster.mClusterId));
+            }
+            return CHIP_NO_ERROR;
+        }
+
         auto endpointIter = mCache.find(endpointId);
-        if (endpointIter->first == endpointId)
+        if (endpointIter != mCache.end())
         {
             for (auto & clusterIter : endpointIter->second)
             {
@@ -591,11 +642,19 @@ private:
 
     const EventData * GetEventData(EventNumber number, CHIP_ERROR & err) const;
 
+    bool HasEndpoint(EndpointId endpointId) const;
+
+    // The data versions of a cluster, which is added to the cache if it is not there yet.
+    Optional<DataVersion> & PendingDataVersion(EndpointId endpointId, ClusterId clusterId);
+    Optional<DataVersion> & CommittedDataVersion(EndpointId endpointId, ClusterId clusterId);
+
     /*
      * Updates the state of an attribute in the cache given a reader. If the reader is null, the state is updated
      * with the provided status.
      */
     CHIP_ERROR UpdateCache(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData, const StatusIB & aStatus);
+    CHIP_ERROR UpdateFlatStore(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData, size_t aElementSize,
+                               const StatusIB & aStatus);
 
     /*
      * If apData is not null, updates the cached event set with the specified event header + payload.
@@ -663,6 +722,7 @@ private:
 
     Callback & mCallback;
     NodeState mCache;
+    FlatAttributeStore mFlatStore;
     std::set<ConcreteAttributePath> mChangedAttributeSet;
     std::set<AttributePathParams, Comparator> mRequestPathSet; // wildcard attribute request path only
     std::vector<EndpointId> mAddedEndpoints;
@@ -671,8 +731,9 @@ private:
     Optional<EventNumber> mHighestReceivedEventNumber;
     std::map<ConcreteEventPath, StatusIB> mEventStatusCache;
     BufferedReadCallback mBufferedReader;
-    ConcreteClusterPath mLastReportDataPath = ConcreteClusterPath(kInvalidEndpointId, kInvalidClusterId);
-    const bool mCacheData                   = true;
+    ConcreteClusterPath mLastReportDataPath  = ConcreteClusterPath(kInvalidEndpointId, kInvalidClusterId);
+    const bool mCacheData                    = true;
+    const AttributeStorage mAttributeStorage = AttributeStorage::kMap;
 };
 
 };     // namespace app
@@ -21,6 +21,7 @@
 #include <access/SubjectDescriptor.h>
 #include <app/EventManagement.h>
 #include <app/InteractionModelEngine.h>
+#include <app/PersistentEventLog.h>
 #include <app/RequiredPrivilege.h>
 #include <assert.h>
 #include <inttypes.h>
@@ -64,8 +65,10 @@ EventManagement & EventManagement::GetInstance()
 
 struct ReclaimEventCtx
 {
+    EventManagement * mpEventManagement = nullptr;
     CircularEventBuffer * mpEventBuffer = nullptr;
     size_t mSpaceNeededForMovedEvent    = 0;
+    CircularEventBuffer::IndexEntry mEvictedEvent;
 };
 
 /**
@@ -80,6 +83,79 @@ struct CopyAndAdjustDeltaTimeContext
     EventLoadOutContext * mpContext = nullptr;
 };
 
+/**
+ * @brief
+ *   A read-only TLV backing store over a range of bytes of a CircularEventBuffer, starting at an offset from its head.
+ *   The range may wrap around the end of the buffer storage.
+ */
+class CircularEventBufferRange : public TLV::TLVBackingStore
+{
+public:
+    CircularEventBufferRange(const CircularEventBuffer & aBuffer, uint32_t aOffset, uint32_t aLength) :
+        mpStorageEnd(aBuffer.GetQueue() + aBuffer.GetTotalDataLength())
+    {
+        uint32_t start = static_cast<uint32_t>((static_cast<size_t>(aBuffer.QueueHead() - aBuffer.GetQueue()) + aOffset) %
+                                               aBuffer.GetTotalDataLength());
+
+        mpStart        = aBuffer.GetQueue() + start;
+        mStartLength   = std::min(aLength, aBuffer.GetTotalDataLength() - start);
+        mpWrapped      = aBuffer.GetQueue();
+        mWrappedLength = aLength - mStartLength;
+    }
+
+    CHIP_ERROR OnInit(TLV::TLVReader & aReader, const uint8_t *& aBufStart, uint32_t & aBufLen) override
+    {
+        aBufStart = mpStart;
+        aBufLen   = mStartLength;
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR GetNextBuffer(TLV::TLVReader & aReader, const uint8_t *& aBufStart, uint32_t & aBufLen) override
+    {
+        // The reader asks for more data once it reached the end of the storage, if the range wraps around.
+        aBufLen = (aBufStart == mpStorageEnd) ? mWrappedLength : 0;
+        if (aBufLen != 0)
+        {
+            aBufStart = mpWrapped;
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR OnInit(TLV::TLVWriter & aWriter, uint8_t *& aBufStart, uint32_t & aBufLen) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+
+    CHIP_ERROR GetNewBuffer(TLV::TLVWriter & aWriter, uint8_t *& aBufStart, uint32_t & aBufLen) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+
+    CHIP_ERROR FinalizeBuffer(TLV::TLVWriter & aWriter, uint8_t * aBufStart, uint32_t aBufLen) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+
+private:
+    const uint8_t * const mpStorageEnd;
+    const uint8_t * mpStart;
+    uint32_t mStartLength;
+    const uint8_t * mpWrapped;
+    uint32_t mWrappedLength;
+};
+
+static bool IsInterestedEventPath(const ObjectList<EventPathParams> * apInterestedEventPaths, const ConcreteEventPath & aPath)
+{
+    for (auto * interestedPath = apInterestedEventPaths; interestedPath != nullptr; interestedPath = interestedPath->mpNext)
+    {
+        if (interestedPath->mValue.IsEventPathSupersetOf(aPath))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 void EventManagement::Init(Messaging::ExchangeManager * apExchangeManager, uint32_t aNumBuffers,
                            CircularEventBuffer * apCircularEventBuffer, const LogStorageResources * const apLogStorageResources,
                            MonotonicallyIncreasingCounter<EventNumber> * apEventNumberCounter,
@@ -136,7 +212,8 @@ CHIP_ERROR EventManagement::CopyToNextBuffer(CircularEventBuffer * apEventBuffer
     {
         return CHIP_ERROR_INVALID_ARGUMENT;
     }
-    CircularEventBuffer backup = *nextBuffer;
+    // Only the buffer state needs restoring on failure: the index is only updated once the copy succeeded.
+    TLVCircularBuffer backup = *nextBuffer;
 
     // Set up the next buffer s.t. it fails if needs to evict an element
     nextBuffer->mProcessEvictedElement = AlwaysFail;
@@ -159,7 +236,7 @@ CHIP_ERROR EventManagement::CopyToNextBuffer(CircularEventBuffer * apEventBuffer
 exit:
     if (err != CHIP_NO_ERROR)
     {
-        *nextBuffer = backup;
+        static_cast<TLVCircularBuffer &>(*nextBuffer) = backup;
     }
     return err;
 }
@@ -171,6 +248,8 @@ CHIP_ERROR EventManagement::EnsureSpaceInCircularBuffer(size_t aRequiredSpace, P
     CircularEventBuffer * eventBuffer = mpEventBuffer;
     ReclaimEventCtx ctx;
 
+    ctx.mpEventManagement = this;
+
     // Check that we have this much space in all our event buffers that might
     // hold the event. If we do not, that will prevent the event from being
     // properly evicted into higher-priority buffers. We want to discover
@@ -219,6 +298,7 @@ CHIP_ERROR EventManagement::EnsureSpaceInCircularBuffer(size_t aRequiredSpace, P
                     // this to fail.
                     err = CopyToNextBuffer(eventBuffer);
                     SuccessOrExit(err);
+                    eventBuffer->GetNextCircularEventBuffer()->AppendIndexEntry(ctx.mEvictedEvent);
                     // success; evict head unconditionally
                     eventBuffer->mProcessEvictedElement = nullptr;
                     err                                 = eventBuffer->EvictHead();
@@ -353,9 +433,10 @@ void EventManagement::CreateEventManagement(Messaging::ExchangeManager * apExcha
  */
 void EventManagement::DestroyEventManagement()
 {
-    sInstance.mState        = EventManagementStates::Shutdown;
-    sInstance.mpEventBuffer = nullptr;
-    sInstance.mpExchangeMgr = nullptr;
+    sInstance.mState               = EventManagementStates::Shutdown;
+    sInstance.mpEventBuffer        = nullptr;
+    sInstance.mpExchangeMgr        = nullptr;
+    sInstance.mpPersistentEventLog = nullptr;
 }
 
 CircularEventBuffer * EventManagement::GetPriorityBuffer(PriorityLevel aPriority) const
@@ -380,14 +461,15 @@ CHIP_ERROR EventManagement::CopyAndAdjustDeltaTime(const TLVReader & aReader, si
         // Does not go on the wire.
         return CHIP_NO_ERROR;
     }
-    if ((aReader.GetTag() == TLV::ContextTag(EventDataIB::Tag::kSystemTimestamp)) && !(ctx->mpContext->mFirst) &&
-        (ctx->mpContext->mCurrentTime.mType == ctx->mpContext->mPreviousTime.mType))
+    // A delta is only written from an earlier time of the same type: the previous event may be from another boot.
+    const bool isDelta = !(ctx->mpContext->mFirst) && (ctx->mpContext->mCurrentTime.mType == ctx->mpContext->mPreviousTime.mType) &&
+        (ctx->mpContext->mCurrentTime.mValue >= ctx->mpContext->mPreviousTime.mValue);
+    if ((aReader.GetTag() == TLV::ContextTag(EventDataIB::Tag::kSystemTimestamp)) && isDelta)
     {
         return ctx->mpWriter->Put(TLV::ContextTag(EventDataIB::Tag::kDeltaSystemTimestamp),
                                   ctx->mpContext->mCurrentTime.mValue - ctx->mpContext->mPreviousTime.mValue);
     }
-    if ((aReader.GetTag() == TLV::ContextTag(EventDataIB::Tag::kEpochTimestamp)) && !(ctx->mpContext->mFirst) &&
-        (ctx->mpContext->mCurrentTime.mType == ctx->mpContext->mPreviousTime.mType))
+    if ((aReader.GetTag() == TLV::ContextTag(EventDataIB::Tag::kEpochTimestamp)) && isDelta)
     {
         return ctx->mpWriter->Put(TLV::ContextTag(EventDataIB::Tag::kDeltaEpochTimestamp),
                                   ctx->mpContext->mCurrentTime.mValue - ctx->mpContext->mPreviousTime.mValue);
@@ -467,6 +549,16 @@ CHIP_ERROR EventManagement::LogEventPrivate(EventLoggingDelegate * apDelegate, c
     err = ConstructEvent(&ctxt, apDelegate, &opts);
     SuccessOrExit(err);
 
+    {
+        CircularEventBuffer::IndexEntry entry;
+        entry.mEventNumber = ctxt.mCurrentEventNumber;
+        entry.mClusterId   = opts.mPath.mClusterId;
+        entry.mEventId     = opts.mPath.mEventId;
+        entry.mEndpointId  = opts.mPath.mEndpointId;
+        entry.mLength      = static_cast<uint16_t>(writer.GetLengthWritten());
+        mpEventBuffer->AppendIndexEntry(entry);
+    }
+
     mBytesWritten += writer.GetLengthWritten();
 
 exit:
@@ -478,6 +570,10 @@ exit:
     else if (opts.mPriority >= CHIP_CONFIG_EVENT_GLOBAL_PRIORITY)
     {
         aEventNumber = mLastEventNumber;
+        if (mpPersistentEventLog != nullptr)
+        {
+            PersistEvents(aEventNumber, opts.mPriority, writer.GetLengthWritten());
+        }
         VendEventNumber();
         mLastEventTimestamp = timestamp;
 #if CHIP_CONFIG_EVENT_LOGGING_VERBOSE_DEBUG_LOGS
@@ -495,6 +591,84 @@ exit:
     return err;
 }
 
+void EventManagement::PersistEvents(EventNumber aEventNumber, PriorityLevel aPriority, uint32_t aLength)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    if (mNextEventToPersist < aEventNumber)
+    {
+        // Append the events that could not be appended before, up to this one.  The buffers hold them in event number order,
+        // from the buffer of the highest priority, unless they were dropped since.
+        for (CircularEventBuffer * buffer = GetPriorityBuffer(PriorityLevel::Critical); buffer != nullptr && err == CHIP_NO_ERROR;
+             buffer                       = buffer->GetPreviousCircularEventBuffer())
+        {
+            CircularEventBufferRange range(*buffer, 0, buffer->DataLength());
+            TLVReader reader;
+            err = reader.Init(range, buffer->DataLength());
+            if (err == CHIP_NO_ERROR)
+            {
+                err = TLV::Utilities::Iterate(reader, PersistBufferedEvent, this, false /*recurse*/);
+            }
+            if (err == CHIP_END_OF_TLV)
+            {
+                err = CHIP_NO_ERROR;
+            }
+        }
+    }
+    else if (mpPersistentEventLog->IsPersisted(aPriority))
+    {
+        CircularEventBufferRange range(*mpEventBuffer, mpEventBuffer->DataLength() - aLength, aLength);
+        TLVReader reader;
+        err = reader.Init(range, aLength);
+        if (err == CHIP_NO_ERROR)
+        {
+            err = reader.Next();
+        }
+        if (err == CHIP_NO_ERROR)
+        {
+            err = mpPersistentEventLog->Append(aEventNumber, reader);
+        }
+    }
+
+    if (err != CHIP_NO_ERROR)
+    {
+        // The event is still in the buffers, and is read from there until it is appended.
+        ChipLogError(EventLogging, "Failed to persist event 0x" ChipLogFormatX64 ": %" CHIP_ERROR_FORMAT,
+                     ChipLogValueX64(mNextEventToPersist), err.Format());
+        return;
+    }
+    mNextEventToPersist = aEventNumber + 1;
+}
+
+CHIP_ERROR EventManagement::PersistBufferedEvent(const TLVReader & aReader, size_t, void * apContext)
+{
+    EventManagement * const eventManagement = static_cast<EventManagement *>(apContext);
+    PersistentEventLog * const log          = eventManagement->mpPersistentEventLog;
+    EventEnvelopeContext event;
+    TLVReader reader;
+    TLVType containerType;
+    TLVType containerType1;
+
+    reader.Init(aReader);
+    ReturnErrorOnFailure(reader.EnterContainer(containerType));
+    ReturnErrorOnFailure(reader.Next());
+    ReturnErrorOnFailure(reader.EnterContainer(containerType1));
+    CHIP_ERROR err = TLV::Utilities::Iterate(reader, FetchEventParameters, &event, false /*recurse*/);
+    VerifyOrReturnError(err == CHIP_NO_ERROR || err == CHIP_END_OF_TLV, err);
+
+    // The events that were logged before the log was set may be in it already.
+    if (event.mEventNumber < eventManagement->mNextEventToPersist || !log->IsPersisted(event.mPriority) ||
+        event.mEventNumber < log->GetNextEventNumber())
+    {
+        return CHIP_NO_ERROR;
+    }
+
+    eventManagement->mNextEventToPersist = event.mEventNumber;
+    ReturnErrorOnFailure(log->Append(event.mEventNumber, aReader));
+    eventManagement->mNextEventToPersist = event.mEventNumber + 1;
+    return CHIP_NO_ERROR;
+}
+
 CHIP_ERROR EventManagement::CopyEvent(const TLVReader & aReader, TLVWriter & aWriter, EventLoadOutContext * apContext)
 {
     TLVReader reader;
@@ -539,19 +713,9 @@ CHIP_ERROR EventManagement::CheckEventContext(EventLoadOutContext * eventLoadOut
     }
 
     ConcreteEventPath path(event.mEndpointId, event.mClusterId, event.mEventId);
-    CHIP_ERROR ret = CHIP_ERROR_UNEXPECTED_EVENT;
+    CHIP_ERROR ret = CHIP_NO_ERROR;
 
-    for (auto * interestedPath = eventLoadOutContext->mpInterestedEventPaths; interestedPath != nullptr;
-         interestedPath        = interestedPath->mpNext)
-    {
-        if (interestedPath->mValue.IsEventPathSupersetOf(path))
-        {
-            ret = CHIP_NO_ERROR;
-            break;
-        }
-    }
-
-    ReturnErrorOnFailure(ret);
+    ReturnErrorCodeIf(!IsInterestedEventPath(eventLoadOutContext->mpInterestedEventPaths, path), CHIP_ERROR_UNEXPECTED_EVENT);
 
     Access::RequestPath requestPath{ .cluster = event.mClusterId, .endpoint = event.mEndpointId };
     Access::Privilege requestPrivilege = RequiredPrivilege::ForReadEvent(path);
@@ -638,29 +802,85 @@ CHIP_ERROR EventManagement::CopyEventsSince(const TLVReader & aReader, size_t aD
     return err;
 }
 
+CHIP_ERROR EventManagement::CopyPersistedEventsSince(const TLVReader & aReader, size_t aDepth, void * apContext)
+{
+    static_cast<EventLoadOutContext *>(apContext)->mFirst = true;
+    return CopyEventsSince(aReader, aDepth, apContext);
+}
+
+CHIP_ERROR EventManagement::FetchBufferEventsSince(CircularEventBuffer & aBuffer, EventLoadOutContext & aContext)
+{
+    const bool recurse = false;
+    uint32_t offset    = aBuffer.SyncIndex();
+
+    if (offset > 0)
+    {
+        CircularEventBufferRange range(aBuffer, 0, offset);
+        TLVReader reader;
+        ReturnErrorOnFailure(reader.Init(range, offset));
+        CHIP_ERROR err = TLV::Utilities::Iterate(reader, CopyEventsSince, &aContext, recurse);
+        VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
+    }
+
+    for (size_t i = 0; i < aBuffer.GetIndexEntryCount(); i++)
+    {
+        const CircularEventBuffer::IndexEntry & entry = aBuffer.GetIndexEntry(i);
+        ConcreteEventPath path(entry.mEndpointId, entry.mClusterId, entry.mEventId);
+
+        if (entry.mEventNumber >= aContext.mStartingEventNumber &&
+            IsInterestedEventPath(aContext.mpInterestedEventPaths, path))
+        {
+            CircularEventBufferRange range(aBuffer, offset, entry.mLength);
+            TLVReader reader;
+            ReturnErrorOnFailure(reader.Init(range, entry.mLength));
+            ReturnErrorOnFailure(reader.Next());
+            ReturnErrorOnFailure(CopyEventsSince(reader, 0, &aContext));
+        }
+        else
+        {
+            // CheckEventContext would exclude this event, so there is no need to decode it.
+            aContext.mCurrentEventNumber = entry.mEventNumber;
+        }
+        offset += entry.mLength;
+    }
+
+    return CHIP_NO_ERROR;
+}
+
 CHIP_ERROR EventManagement::FetchEventsSince(TLVWriter & aWriter, const ObjectList<EventPathParams> * apEventPathList,
                                              EventNumber & aEventMin, size_t & aEventCount,
                                              const Access::SubjectDescriptor & aSubjectDescriptor)
 {
-    // TODO: Add particular set of event Paths in FetchEventsSince so that we can filter the interested paths
-    CHIP_ERROR err     = CHIP_NO_ERROR;
-    const bool recurse = false;
-    TLVReader reader;
-    CircularEventBufferWrapper bufWrapper;
+    CHIP_ERROR err = CHIP_NO_ERROR;
     EventLoadOutContext context(aWriter, PriorityLevel::Invalid, aEventMin);
 
     context.mSubjectDescriptor     = aSubjectDescriptor;
     context.mpInterestedEventPaths = apEventPathList;
-    err                            = GetEventReader(reader, PriorityLevel::Critical, &bufWrapper);
-    SuccessOrExit(err);
 
-    err = TLV::Utilities::Iterate(reader, CopyEventsSince, &context, recurse);
+    // Read the persisted events that are no longer in the buffers first, as they are older than the events in the buffers
+    // that are left to read.
+    const EventNumber persistedEventsEnd = (mpPersistentEventLog != nullptr) ? GetPersistedEventsEnd() : 0;
+    if (aEventMin < persistedEventsEnd)
+    {
+        err = mpPersistentEventLog->ForEachEvent(aEventMin, persistedEventsEnd, CopyPersistedEventsSince, &context);
+        // The buffers hold the events from there on.
+        context.mStartingEventNumber = persistedEventsEnd;
+        // Nor is the timestamp of the first buffered event written as a delta from the last persisted one.
+        context.mFirst = true;
+    }
+
+    // Read the buffers the way GetEventReader does: from the one holding the oldest, most important events, to the one
+    // holding the newest events.
+    for (CircularEventBuffer * buffer = GetPriorityBuffer(PriorityLevel::Critical); buffer != nullptr && err == CHIP_NO_ERROR;
+         buffer                       = buffer->GetPreviousCircularEventBuffer())
+    {
+        err = FetchBufferEventsSince(*buffer, context);
+    }
     if (err == CHIP_END_OF_TLV)
     {
         err = CHIP_NO_ERROR;
     }
 
-exit:
     if (err == CHIP_ERROR_BUFFER_TOO_SMALL || err == CHIP_ERROR_NO_MEMORY)
     {
         // We failed to fetch the current event because the buffer is too small, we will start from this one the next time.
@@ -731,9 +951,65 @@ CHIP_ERROR EventManagement::FabricRemoved(FabricIndex aFabricIndex)
     {
         err = CHIP_NO_ERROR;
     }
+    if (err == CHIP_NO_ERROR && mpPersistentEventLog != nullptr)
+    {
+        err = mpPersistentEventLog->FabricRemoved(aFabricIndex);
+    }
     return err;
 }
 
+void EventManagement::SetPersistentEventLog(PersistentEventLog * apPersistentEventLog)
+{
+    mpPersistentEventLog = apPersistentEventLog;
+    // The events that are already in the buffers are appended along with the next event.
+    mPersistentEventLogEnd = (apPersistentEventLog != nullptr) ? GetOldestBufferedEventNumber() : 0;
+    mNextEventToPersist    = mPersistentEventLogEnd;
+}
+
+EventNumber EventManagement::GetPersistedEventsEnd()
+{
+    // A buffered event is only read from the log if it was appended to it, and not rotated out of it since.
+    EventNumber end                        = std::min(mPersistentEventLogEnd, mNextEventToPersist);
+    const EventNumber oldestBufferedNumber = GetOldestBufferedEventNumber();
+    if (oldestBufferedNumber < end && oldestBufferedNumber < mpPersistentEventLog->GetFirstEventNumber())
+    {
+        end = oldestBufferedNumber;
+    }
+    return end;
+}
+
+EventNumber EventManagement::GetOldestBufferedEventNumber()
+{
+    // The buffer of the highest priority holds the oldest events, see FetchEventsSince.
+    for (CircularEventBuffer * buffer = GetPriorityBuffer(PriorityLevel::Critical); buffer != nullptr;
+         buffer                       = buffer->GetPreviousCircularEventBuffer())
+    {
+        if (buffer->DataLength() == 0)
+        {
+            continue;
+        }
+        if (buffer->SyncIndex() == 0)
+        {
+            return buffer->GetIndexEntry(0).mEventNumber;
+        }
+
+        CircularEventBufferRange range(*buffer, 0, buffer->DataLength());
+        TLVReader reader;
+        EventReportIB::Parser report;
+        EventDataIB::Parser data;
+        EventNumber eventNumber = 0;
+        if (reader.Init(range, buffer->DataLength()) == CHIP_NO_ERROR && reader.Next() == CHIP_NO_ERROR &&
+            report.Init(reader) == CHIP_NO_ERROR && report.GetEventData(&data) == CHIP_NO_ERROR &&
+            data.GetEventNumber(&eventNumber) == CHIP_NO_ERROR)
+        {
+            return eventNumber;
+        }
+        // Rather read no persisted event than one that is also in the buffers.
+        return 0;
+    }
+    return mLastEventNumber;
+}
+
 CHIP_ERROR EventManagement::GetEventReader(TLVReader & aReader, PriorityLevel aPriority, CircularEventBufferWrapper * apBufWrapper)
 {
     CircularEventBuffer * buffer = GetPriorityBuffer(aPriority);
@@ -835,11 +1111,23 @@ CHIP_ERROR EventManagement::EvictEvent(TLVCircularBuffer & apBuffer, void * apAp
                         static_cast<unsigned>(eventBuffer->GetPriority()), ChipLogValueX64(context.mEventNumber),
                         static_cast<unsigned>(imp));
         ctx->mSpaceNeededForMovedEvent = 0;
+
+        EventManagement * const eventManagement = ctx->mpEventManagement;
+        if (eventManagement->mpPersistentEventLog != nullptr && eventManagement->mpPersistentEventLog->IsPersisted(imp))
+        {
+            eventManagement->mPersistentEventLogEnd = std::max(eventManagement->mPersistentEventLogEnd, context.mEventNumber + 1);
+        }
         return CHIP_NO_ERROR;
     }
 
     // event is not getting dropped. Note how much space it requires, and return.
     ctx->mSpaceNeededForMovedEvent = aReader.GetLengthRead();
+
+    ctx->mEvictedEvent.mEventNumber = context.mEventNumber;
+    ctx->mEvictedEvent.mClusterId   = context.mClusterId;
+    ctx->mEvictedEvent.mEventId     = context.mEventId;
+    ctx->mEvictedEvent.mEndpointId  = context.mEndpointId;
+    ctx->mEvictedEvent.mLength      = static_cast<uint16_t>(aReader.GetLengthRead());
     return CHIP_END_OF_TLV;
 }
 
@@ -856,6 +1144,65 @@ void CircularEventBuffer::Init(uint8_t * apBuffer, uint32_t aBufferLength, Circu
     mpPrev    = apPrev;
     mpNext    = apNext;
     mPriority = aPriorityLevel;
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    mIndexHead     = 0;
+    mIndexCount    = 0;
+    mIndexedLength = 0;
+#endif // CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+}
+
+// Events are only ever evicted from the head of the buffer and written at its tail, so the entries always describe the
+// newest events, and the entries of evicted events can be dropped lazily, from the lengths alone.
+static_assert(kMaxEventSizeReserve <= UINT16_MAX, "IndexEntry::mLength cannot hold the length of an event");
+
+void CircularEventBuffer::AppendIndexEntry(const IndexEntry & aEntry)
+{
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    if (mIndexCount == CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE)
+    {
+        mIndexedLength -= mIndex[mIndexHead].mLength;
+        mIndexHead = (mIndexHead + 1) % CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE;
+        mIndexCount--;
+    }
+    mIndex[(mIndexHead + mIndexCount) % CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE] = aEntry;
+    mIndexCount++;
+    mIndexedLength += aEntry.mLength;
+    SyncIndex();
+#endif // CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+}
+
+uint32_t CircularEventBuffer::SyncIndex()
+{
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    while (mIndexedLength > DataLength())
+    {
+        mIndexedLength -= mIndex[mIndexHead].mLength;
+        mIndexHead = (mIndexHead + 1) % CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE;
+        mIndexCount--;
+    }
+    return DataLength() - mIndexedLength;
+#else
+    return DataLength();
+#endif // CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+}
+
+size_t CircularEventBuffer::GetIndexEntryCount() const
+{
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    return mIndexCount;
+#else
+    return 0;
+#endif // CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+}
+
+const CircularEventBuffer::IndexEntry & CircularEventBuffer::GetIndexEntry(size_t aIndex) const
+{
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    VerifyOrDie(aIndex < mIndexCount);
+    return mIndex[(mIndexHead + aIndex) % CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE];
+#else
+    chipDie();
+#endif // CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
 }
 
 bool CircularEventBuffer::IsFinalDestinationForPriority(PriorityLevel aPriority) const
@@ -33,6 +33,7 @@
 #include <app/MessageDef/StatusIB.h>
 #include <app/ObjectList.h>
 #include <app/util/basic-types.h>
+#include <lib/core/CHIPConfig.h>
 #include <lib/core/TLVCircularBuffer.h>
 #include <lib/support/CHIPCounter.h>
 #include <messaging/ExchangeMgr.h>
@@ -70,6 +71,8 @@
 
 namespace chip {
 namespace app {
+class PersistentEventLog;
+
 inline constexpr const uint32_t kEventManagementProfile = 0x1;
 inline constexpr const uint32_t kFabricIndexTag         = 0x1;
 inline constexpr size_t kMaxEventSizeReserve            = 512;
@@ -128,6 +131,38 @@ public:
     void SetRequiredSpaceforEvicted(size_t aRequiredSpace) { mRequiredSpaceForEvicted = aRequiredSpace; }
     size_t GetRequiredSpaceforEvicted() const { return mRequiredSpaceForEvicted; }
 
+    /**
+     * @brief
+     *   The number and path of an event stored in the buffer, and the length of its encoding.
+     */
+    struct IndexEntry
+    {
+        EventNumber mEventNumber = 0;
+        ClusterId mClusterId     = 0;
+        EventId mEventId         = 0;
+        EndpointId mEndpointId   = 0;
+        uint16_t mLength         = 0;
+    };
+
+    /**
+     * @brief
+     *   Record the event that was just written at the tail of the buffer.  Once the index is full, the entry of the oldest
+     *   event is dropped.
+     */
+    void AppendIndexEntry(const IndexEntry & aEntry);
+
+    /**
+     * @brief
+     *   Drop the entries of the events evicted from the buffer.
+     *
+     * @return The number of bytes at the head of the buffer holding the oldest events, which have no entry.  The events with
+     *         an entry follow, in the order of GetIndexEntry().
+     */
+    uint32_t SyncIndex();
+
+    size_t GetIndexEntryCount() const;
+    const IndexEntry & GetIndexEntry(size_t aIndex) const;
+
     ~CircularEventBuffer() override = default;
 
 private:
@@ -139,6 +174,13 @@ private:
 
     size_t mRequiredSpaceForEvicted = 0; ///< Required space for previous buffer to evict event to new buffer
 
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    IndexEntry mIndex[CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE]; ///< Entries of the newest events, oldest first from mIndexHead
+    size_t mIndexHead       = 0;
+    size_t mIndexCount      = 0;
+    uint32_t mIndexedLength = 0; ///< The sum of the lengths of the entries
+#endif // CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+
     CHIP_ERROR OnInit(TLV::TLVWriter & writer, uint8_t *& bufStart, uint32_t & bufLen) override;
 };
 
@@ -368,6 +410,16 @@ public:
      */
     CHIP_ERROR FabricRemoved(FabricIndex aFabricIndex);
 
+    /**
+     * @brief
+     *   Set the persistent tier of the event log, or clear it with nullptr.
+     *
+     * The events whose priority the log persists are appended to it as they are logged.  FetchEventsSince reads the events
+     * that are no longer in the buffers from it, before the events in the buffers.  The events in the log that are older than
+     * the buffered events, such as the events logged before a reboot, are read from it too.
+     */
+    void SetPersistentEventLog(PersistentEventLog * apPersistentEventLog);
+
     /**
      * @brief
      *   Fetch the most recently vended Number for a particular priority level
@@ -484,6 +536,22 @@ private:
      */
     static CHIP_ERROR CopyEventsSince(const TLV::TLVReader & aReader, size_t aDepth, void * apContext);
 
+    /**
+     * @brief
+     *   Like #CopyEventsSince, for the events read from mpPersistentEventLog.  Their timestamps are written in full, as they
+     *   may have been logged in another boot than the previous event.
+     */
+    static CHIP_ERROR CopyPersistedEventsSince(const TLV::TLVReader & aReader, size_t aDepth, void * apContext);
+
+    /**
+     * @brief
+     *   Internal API used to implement #FetchEventsSince, for the events of one buffer
+     *
+     * The indexed events of the buffer that precede the starting event number or match none of the interested paths are
+     * skipped without being decoded.  The other events are passed to #CopyEventsSince.
+     */
+    static CHIP_ERROR FetchBufferEventsSince(CircularEventBuffer & aBuffer, EventLoadOutContext & aContext);
+
     /**
      * @brief Internal iterator function used to scan and filter though event logs
      *
@@ -545,6 +613,31 @@ private:
      */
     CircularEventBuffer * GetPriorityBuffer(PriorityLevel aPriority) const;
 
+    /**
+     * @brief
+     *   Get the number of the oldest event in the buffers, or the number the next event will get if they are empty.
+     */
+    EventNumber GetOldestBufferedEventNumber();
+
+    /**
+     * @brief
+     *   Get the number below which events are read from mpPersistentEventLog rather than from the buffers.
+     */
+    EventNumber GetPersistedEventsEnd();
+
+    /**
+     * @brief
+     *   Append the event that was just written, aLength bytes at the tail of mpEventBuffer, to mpPersistentEventLog, after
+     *   the buffered events that could not be appended before.
+     */
+    void PersistEvents(EventNumber aEventNumber, PriorityLevel aPriority, uint32_t aLength);
+
+    /**
+     * @brief
+     *   Iterator function used to append the buffered events from mNextEventToPersist to mpPersistentEventLog.
+     */
+    static CHIP_ERROR PersistBufferedEvent(const TLV::TLVReader & aReader, size_t aDepth, void * apContext);
+
     // EventBuffer for debug level,
     CircularEventBuffer * mpEventBuffer        = nullptr;
     Messaging::ExchangeManager * mpExchangeMgr = nullptr;
@@ -554,6 +647,14 @@ private:
     // The counter we're going to use for event numbers.
     MonotonicallyIncreasingCounter<EventNumber> * mpEventNumberCounter = nullptr;
 
+    PersistentEventLog * mpPersistentEventLog = nullptr;
+    // One past the last event of a persisted priority dropped from the buffers.  The buffered events below it are read from
+    // mpPersistentEventLog too, as long as it holds them, see GetPersistedEventsEnd.
+    EventNumber mPersistentEventLogEnd = 0;
+    // The events numbered below this were appended to mpPersistentEventLog, unless they are of a priority it does not
+    // persist, or were dropped from the buffers before they could be.
+    EventNumber mNextEventToPersist = 0;
+
     EventNumber mLastEventNumber = 0; ///< Last event Number vended
     Timestamp mLastEventTimestamp;    ///< The timestamp of the last event in this buffer
 
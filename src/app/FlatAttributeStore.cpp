@@ -0,0 +1,387 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/FlatAttributeStore.h>
+
+#include <lib/core/TLVWriter.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/SafeInt.h>
+
+#include <algorithm>
+#include <string.h>
+#include <utility>
+
+namespace chip {
+namespace app {
+
+namespace {
+
+constexpr uint32_t kBlockSize = 1024;
+
+// Larger values get a block of their own, so that a long list does not leave most of a shared block unused.
+constexpr uint32_t kMaxPackedValueLength = kBlockSize / 4;
+
+using ClusterKey   = uint64_t;
+using AttributeKey = std::pair<ClusterKey, AttributeId>;
+
+constexpr ClusterKey MakeClusterKey(EndpointId endpointId, ClusterId clusterId)
+{
+    return (static_cast<ClusterKey>(endpointId) << 32) | clusterId;
+}
+
+// The first key past all clusters of the endpoint of the given key.
+constexpr ClusterKey NextEndpointKey(ClusterKey key)
+{
+    return (key | 0xFFFF'FFFF) + 1;
+}
+
+ClusterKey KeyOf(const FlatAttributeStore::ClusterState & cluster)
+{
+    return MakeClusterKey(cluster.mEndpointId, cluster.mClusterId);
+}
+
+AttributeKey KeyOf(const FlatAttributeStore::Attribute & attribute)
+{
+    return AttributeKey(MakeClusterKey(attribute.mEndpointId, attribute.mClusterId), attribute.mAttributeId);
+}
+
+AttributeKey KeyOf(const ConcreteAttributePath & path)
+{
+    return AttributeKey(MakeClusterKey(path.mEndpointId, path.mClusterId), path.mAttributeId);
+}
+
+template <typename Iterator, typename Key>
+Iterator LowerBound(Iterator first, Iterator last, const Key & key)
+{
+    return std::lower_bound(first, last, key, [](const auto & item, const Key & k) { return KeyOf(item) < k; });
+}
+
+/*
+ * Find the position of the key in a sorted vector, or where it would go.  Reports visit paths in order, so the item
+ * after the one found last (hint) is checked before searching.
+ */
+template <typename Vector, typename Key>
+size_t FindPosition(const Vector & items, const Key & key, size_t & hint)
+{
+    if (hint < items.size() && KeyOf(items[hint]) == key)
+    {
+        return hint;
+    }
+    if (hint + 1 < items.size() && KeyOf(items[hint + 1]) == key)
+    {
+        return ++hint;
+    }
+    hint = static_cast<size_t>(LowerBound(items.begin(), items.end(), key) - items.begin());
+    return hint;
+}
+
+} // anonymous namespace
+
+struct FlatAttributeStore::Block
+{
+    Block * mPrev;
+    Block * mNext;
+    uint32_t mCapacity;
+    uint32_t mUsed;
+    uint32_t mLiveValues;
+
+    uint8_t * Data() { return reinterpret_cast<uint8_t *>(this + 1); }
+};
+
+FlatAttributeStore::~FlatAttributeStore()
+{
+    while (mBlocks != nullptr)
+    {
+        FreeBlock(mBlocks);
+    }
+}
+
+bool FlatAttributeStore::HasEndpoint(EndpointId endpointId) const
+{
+    if (mClusterHint < mClusters.size() && mClusters[mClusterHint].mEndpointId == endpointId)
+    {
+        return true;
+    }
+
+    auto cluster = LowerBound(mClusters.begin(), mClusters.end(), MakeClusterKey(endpointId, 0));
+    return cluster != mClusters.end() && cluster->mEndpointId == endpointId;
+}
+
+const FlatAttributeStore::ClusterState * FlatAttributeStore::FindCluster(EndpointId endpointId, ClusterId clusterId) const
+{
+    const ClusterKey key = MakeClusterKey(endpointId, clusterId);
+    auto cluster         = LowerBound(mClusters.begin(), mClusters.end(), key);
+    return (cluster != mClusters.end() && KeyOf(*cluster) == key) ? &*cluster : nullptr;
+}
+
+FlatAttributeStore::ClusterState & FlatAttributeStore::FindOrAddCluster(EndpointId endpointId, ClusterId clusterId)
+{
+    const ClusterKey key  = MakeClusterKey(endpointId, clusterId);
+    const size_t position = FindPosition(mClusters, key, mClusterHint);
+    if (position < mClusters.size() && KeyOf(mClusters[position]) == key)
+    {
+        return mClusters[position];
+    }
+
+    ClusterState state;
+    state.mEndpointId = endpointId;
+    state.mClusterId  = clusterId;
+    return *mClusters.insert(mClusters.begin() + static_cast<ptrdiff_t>(position), state);
+}
+
+const FlatAttributeStore::Attribute * FlatAttributeStore::FindAttribute(const ConcreteAttributePath & path) const
+{
+    const AttributeKey key = KeyOf(path);
+    auto attribute         = LowerBound(mAttributes.begin(), mAttributes.end(), key);
+    return (attribute != mAttributes.end() && KeyOf(*attribute) == key) ? &*attribute : nullptr;
+}
+
+FlatAttributeStore::Attribute & FlatAttributeStore::FindOrAddAttribute(const ConcreteAttributePath & path)
+{
+    const AttributeKey key = KeyOf(path);
+    const size_t position  = FindPosition(mAttributes, key, mAttributeHint);
+    if (position < mAttributes.size() && KeyOf(mAttributes[position]) == key)
+    {
+        return mAttributes[position];
+    }
+
+    // Every attribute belongs to a cluster, even if no data version was seen for it.
+    FindOrAddCluster(path.mEndpointId, path.mClusterId);
+
+    Attribute state;
+    state.mEndpointId  = path.mEndpointId;
+    state.mClusterId   = path.mClusterId;
+    state.mAttributeId = path.mAttributeId;
+    state.mKind        = Attribute::Kind::kSize;
+    state.mLength      = 0;
+    state.mOffset      = 0;
+    state.mBlock       = nullptr;
+    return *mAttributes.insert(mAttributes.begin() + static_cast<ptrdiff_t>(position), state);
+}
+
+CHIP_ERROR FlatAttributeStore::SetData(const ConcreteAttributePath & path, TLV::TLVReader & reader, size_t elementSize)
+{
+    VerifyOrReturnError(CanCastTo<uint32_t>(elementSize), CHIP_ERROR_NO_MEMORY);
+    const uint32_t length = static_cast<uint32_t>(elementSize);
+
+    Block * block;
+    uint32_t offset;
+    uint8_t * buffer = AllocateValue(length, block, offset);
+    VerifyOrReturnError(buffer != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    TLV::TLVWriter writer;
+    writer.Init(buffer, length);
+    CHIP_ERROR err = writer.CopyElement(TLV::AnonymousTag(), reader);
+    SuccessOrExit(err);
+    SuccessOrExit(err = writer.Finalize());
+    VerifyOrExit(writer.GetLengthWritten() == length, err = CHIP_ERROR_INTERNAL);
+
+    {
+        Attribute & attribute = FindOrAddAttribute(path);
+        ReleaseValue(attribute);
+        attribute.mKind   = Attribute::Kind::kData;
+        attribute.mLength = length;
+        attribute.mOffset = offset;
+        attribute.mBlock  = block;
+    }
+
+exit:
+    if (err != CHIP_NO_ERROR)
+    {
+        ReleaseValue(block, length);
+    }
+    return err;
+}
+
+void FlatAttributeStore::SetStatus(const ConcreteAttributePath & path, const StatusIB & status)
+{
+    Attribute & attribute = FindOrAddAttribute(path);
+    ReleaseValue(attribute);
+    attribute.mKind   = Attribute::Kind::kStatus;
+    attribute.mStatus = status;
+}
+
+void FlatAttributeStore::SetSize(const ConcreteAttributePath & path, size_t size)
+{
+    Attribute & attribute = FindOrAddAttribute(path);
+    ReleaseValue(attribute);
+    attribute.mKind   = Attribute::Kind::kSize;
+    attribute.mLength = static_cast<uint32_t>(std::min<size_t>(size, UINT32_MAX));
+}
+
+ByteSpan FlatAttributeStore::GetData(const Attribute & attribute) const
+{
+    VerifyOrReturnValue(attribute.mKind == Attribute::Kind::kData, ByteSpan());
+    return ByteSpan(attribute.mBlock->Data() + attribute.mOffset, attribute.mLength);
+}
+
+Span<const FlatAttributeStore::ClusterState> FlatAttributeStore::GetClusters(EndpointId endpointId) const
+{
+    const ClusterKey key = MakeClusterKey(endpointId, 0);
+    auto first           = LowerBound(mClusters.begin(), mClusters.end(), key);
+    auto last            = LowerBound(first, mClusters.end(), NextEndpointKey(key));
+    return Span<const ClusterState>(mClusters.data() + (first - mClusters.begin()), static_cast<size_t>(last - first));
+}
+
+Span<const FlatAttributeStore::Attribute> FlatAttributeStore::GetAttributes(EndpointId endpointId, ClusterId clusterId) const
+{
+    const ClusterKey key = MakeClusterKey(endpointId, clusterId);
+    auto first           = LowerBound(mAttributes.begin(), mAttributes.end(), AttributeKey(key, 0));
+    auto last            = LowerBound(first, mAttributes.end(), AttributeKey(key + 1, 0));
+    return Span<const Attribute>(mAttributes.data() + (first - mAttributes.begin()), static_cast<size_t>(last - first));
+}
+
+void FlatAttributeStore::Compact()
+{
+    // Leave some slack, so that a store that is being updated in place does not get repacked over and over.
+    if (mAllocatedBytes <= 2 * mLiveBytes + kBlockSize)
+    {
+        return;
+    }
+
+    // Pack into new blocks only; the old ones are freed as their last value moves out.
+    Block * previous = mCurrentBlock;
+    mCurrentBlock    = nullptr;
+    if (previous != nullptr && previous->mLiveValues == 0)
+    {
+        FreeBlock(previous);
+    }
+
+    for (auto & attribute : mAttributes)
+    {
+        if (attribute.mKind != Attribute::Kind::kData || attribute.mLength > kMaxPackedValueLength)
+        {
+            continue;
+        }
+
+        Block * block;
+        uint32_t offset;
+        uint8_t * buffer = AllocateValue(attribute.mLength, block, offset);
+        if (buffer == nullptr)
+        {
+            // Values that did not move yet just stay where they are.
+            return;
+        }
+
+        memcpy(buffer, attribute.mBlock->Data() + attribute.mOffset, attribute.mLength);
+        ReleaseValue(attribute.mBlock, attribute.mLength);
+        attribute.mOffset = offset;
+        attribute.mBlock  = block;
+    }
+}
+
+uint8_t * FlatAttributeStore::AllocateValue(uint32_t length, Block *& block, uint32_t & offset)
+{
+    if (length > kMaxPackedValueLength)
+    {
+        block = AllocateBlock(length);
+        VerifyOrReturnValue(block != nullptr, nullptr);
+    }
+    else
+    {
+        if (mCurrentBlock == nullptr || mCurrentBlock->mCapacity - mCurrentBlock->mUsed < length)
+        {
+            // The current block still holds live values, or it would have been reset; it is freed once they are gone.
+            Block * newBlock = AllocateBlock(kBlockSize);
+            VerifyOrReturnValue(newBlock != nullptr, nullptr);
+            mCurrentBlock = newBlock;
+        }
+        block = mCurrentBlock;
+    }
+
+    offset = block->mUsed;
+    block->mUsed += length;
+    block->mLiveValues++;
+    mLiveBytes += length;
+    return block->Data() + offset;
+}
+
+void FlatAttributeStore::ReleaseValue(Attribute & attribute)
+{
+    if (attribute.mKind == Attribute::Kind::kData)
+    {
+        ReleaseValue(attribute.mBlock, attribute.mLength);
+        attribute.mKind  = Attribute::Kind::kSize;
+        attribute.mBlock = nullptr;
+    }
+}
+
+void FlatAttributeStore::ReleaseValue(Block * block, uint32_t length)
+{
+    mLiveBytes -= length;
+    if (--block->mLiveValues > 0)
+    {
+        return;
+    }
+
+    if (block == mCurrentBlock)
+    {
+        block->mUsed = 0;
+    }
+    else
+    {
+        FreeBlock(block);
+    }
+}
+
+FlatAttributeStore::Block * FlatAttributeStore::AllocateBlock(uint32_t capacity)
+{
+    auto * block = static_cast<Block *>(Platform::MemoryAlloc(sizeof(Block) + capacity));
+    VerifyOrReturnValue(block != nullptr, nullptr);
+
+    block->mPrev       = nullptr;
+    block->mNext       = mBlocks;
+    block->mCapacity   = capacity;
+    block->mUsed       = 0;
+    block->mLiveValues = 0;
+    if (mBlocks != nullptr)
+    {
+        mBlocks->mPrev = block;
+    }
+    mBlocks = block;
+
+    mAllocatedBytes += capacity;
+    return block;
+}
+
+void FlatAttributeStore::FreeBlock(Block * block)
+{
+    if (block->mPrev != nullptr)
+    {
+        block->mPrev->mNext = block->mNext;
+    }
+    else
+    {
+        mBlocks = block->mNext;
+    }
+    if (block->mNext != nullptr)
+    {
+        block->mNext->mPrev = block->mPrev;
+    }
+    if (block == mCurrentBlock)
+    {
+        mCurrentBlock = nullptr;
+    }
+
+    mAllocatedBytes -= block->mCapacity;
+    Platform::MemoryFree(block);
+}
+
+} // namespace app
+} // namespace chip
@@ -0,0 +1,128 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <app/ConcreteAttributePath.h>
+#include <app/MessageDef/StatusIB.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/core/Optional.h>
+#include <lib/core/TLVReader.h>
+#include <lib/support/Span.h>
+
+#include <vector>
+
+namespace chip {
+namespace app {
+
+/*
+ * Attribute storage for ClusterStateCache that favors locality and few allocations over the nested maps the cache
+ * uses by default.
+ *
+ * Clusters and attributes are kept in two flat arrays sorted by path, so all attributes of a cluster are adjacent,
+ * and appending in path order (as wildcard reports arrive) does not move anything. Attribute values are packed into
+ * shared blocks instead of having an allocation each.
+ *
+ * A value stays at the same address until the attribute it belongs to is updated, or until Compact() is called.
+ */
+class FlatAttributeStore
+{
+public:
+    struct ClusterState
+    {
+        EndpointId mEndpointId;
+        ClusterId mClusterId;
+        Optional<DataVersion> mPendingDataVersion;
+        Optional<DataVersion> mCommittedDataVersion;
+    };
+
+    struct Block;
+
+    struct Attribute
+    {
+        enum class Kind : uint8_t
+        {
+            kStatus, // mStatus holds the status received for the attribute.
+            kData,   // mLength bytes of TLV data at mOffset in mBlock.
+            kSize,   // mLength is the size of TLV data that was not stored.
+        };
+
+        EndpointId mEndpointId;
+        ClusterId mClusterId;
+        AttributeId mAttributeId;
+        Kind mKind;
+        StatusIB mStatus;
+        uint32_t mLength;
+        uint32_t mOffset;
+        Block * mBlock;
+    };
+
+    FlatAttributeStore() = default;
+    ~FlatAttributeStore();
+
+    FlatAttributeStore(const FlatAttributeStore &)             = delete;
+    FlatAttributeStore & operator=(const FlatAttributeStore &) = delete;
+
+    bool HasEndpoint(EndpointId endpointId) const;
+
+    const ClusterState * FindCluster(EndpointId endpointId, ClusterId clusterId) const;
+    ClusterState & FindOrAddCluster(EndpointId endpointId, ClusterId clusterId);
+
+    const Attribute * FindAttribute(const ConcreteAttributePath & path) const;
+
+    /*
+     * Set the value of an attribute to the element the reader is positioned on, which must encode to exactly
+     * elementSize bytes with an anonymous tag.
+     */
+    CHIP_ERROR SetData(const ConcreteAttributePath & path, TLV::TLVReader & reader, size_t elementSize);
+    void SetStatus(const ConcreteAttributePath & path, const StatusIB & status);
+    void SetSize(const ConcreteAttributePath & path, size_t size);
+
+    ByteSpan GetData(const Attribute & attribute) const;
+
+    Span<const ClusterState> GetClusters() const { return Span<const ClusterState>(mClusters.data(), mClusters.size()); }
+    Span<const ClusterState> GetClusters(EndpointId endpointId) const;
+    Span<const Attribute> GetAttributes(EndpointId endpointId, ClusterId clusterId) const;
+
+    /*
+     * Repack the values into as few blocks as possible, in path order, if updates left too much unused space behind.
+     * This moves values, so it must not be called while a reader may point into the store.
+     */
+    void Compact();
+
+private:
+    Attribute & FindOrAddAttribute(const ConcreteAttributePath & path);
+    uint8_t * AllocateValue(uint32_t length, Block *& block, uint32_t & offset);
+    void ReleaseValue(Attribute & attribute);
+    void ReleaseValue(Block * block, uint32_t length);
+    Block * AllocateBlock(uint32_t capacity);
+    void FreeBlock(Block * block);
+
+    std::vector<ClusterState> mClusters;
+    std::vector<Attribute> mAttributes;
+    size_t mClusterHint    = 0;       // Where FindOrAddCluster() found or added a cluster last.
+    size_t mAttributeHint  = 0;       // Where FindOrAddAttribute() found or added an attribute last.
+    Block * mBlocks        = nullptr; // All blocks, most recently allocated first.
+    Block * mCurrentBlock  = nullptr; // The block new values are packed into.
+    size_t mAllocatedBytes = 0;
+    size_t mLiveBytes      = 0;
+};
+
+} // namespace app
+} // namespace chip
@@ -0,0 +1,332 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/FleetSubscriptionManager.h>
+
+#include <app/InteractionModelEngine.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#if CHIP_CONFIG_ENABLE_READ_CLIENT
+namespace chip {
+namespace app {
+
+CHIP_ERROR FleetSubscriptionManager::Init(Messaging::ExchangeManager * exchangeMgr, Delegate & delegate,
+                                          const Parameters & params)
+{
+    VerifyOrReturnError(mExchangeMgr == nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(exchangeMgr != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(params.attributePathCount != 0 || params.eventPathCount != 0, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(params.attributePathCount == 0 || params.attributePaths != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(params.eventPathCount == 0 || params.eventPaths != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(params.maxConcurrentEstablishments != 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    if (params.attributePathCount != 0)
+    {
+        mAttributePaths.Calloc(params.attributePathCount);
+        VerifyOrReturnError(mAttributePaths.Get() != nullptr, CHIP_ERROR_NO_MEMORY);
+        for (size_t i = 0; i < params.attributePathCount; i++)
+        {
+            mAttributePaths[i] = params.attributePaths[i];
+        }
+    }
+
+    if (params.eventPathCount != 0)
+    {
+        mEventPaths.Calloc(params.eventPathCount);
+        if (mEventPaths.Get() == nullptr)
+        {
+            mAttributePaths.Free();
+            return CHIP_ERROR_NO_MEMORY;
+        }
+        for (size_t i = 0; i < params.eventPathCount; i++)
+        {
+            mEventPaths[i] = params.eventPaths[i];
+        }
+    }
+
+    mExchangeMgr = exchangeMgr;
+    mSystemLayer = exchangeMgr->GetSessionManager()->SystemLayer();
+    mDelegate    = &delegate;
+    mParams      = params;
+    mStats       = Stats();
+
+    return CHIP_NO_ERROR;
+}
+
+void FleetSubscriptionManager::Shutdown()
+{
+    VerifyOrReturn(mExchangeMgr != nullptr);
+
+    mSystemLayer->CancelTimer(OnStartTimer, this);
+
+    // Destroying the ReadClients tears the subscriptions down without calling OnDone.
+    mNodes.ReleaseAll();
+    VerifyOrDie(mQueue.Empty());
+
+    mAttributePaths.Free();
+    mEventPaths.Free();
+    mExchangeMgr = nullptr;
+    mSystemLayer = nullptr;
+    mDelegate    = nullptr;
+    mStats       = Stats();
+}
+
+CHIP_ERROR FleetSubscriptionManager::AddNode(const ScopedNodeId & node)
+{
+    VerifyOrReturnError(mExchangeMgr != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(node.GetNodeId() != kUndefinedNodeId && node.GetFabricIndex() != kUndefinedFabricIndex,
+                        CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(FindNode(node) == nullptr, CHIP_ERROR_DUPLICATE_KEY_ID);
+
+    NodeSubscription * subscription = mNodes.CreateObject(*this, node);
+    VerifyOrReturnError(subscription != nullptr, CHIP_ERROR_NO_MEMORY);
+    mStats.nodes++;
+
+    Enqueue(*subscription, System::SystemClock().GetMonotonicTimestamp());
+    ScheduleStarts();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR FleetSubscriptionManager::RemoveNode(const ScopedNodeId & node)
+{
+    NodeSubscription * subscription = FindNode(node);
+    VerifyOrReturnError(subscription != nullptr, CHIP_ERROR_NOT_FOUND);
+
+    ReleaseNode(*subscription);
+    ScheduleStarts();
+    return CHIP_NO_ERROR;
+}
+
+FleetSubscriptionManager::NodeSubscription * FleetSubscriptionManager::FindNode(const ScopedNodeId & node)
+{
+    NodeSubscription * found = nullptr;
+    mNodes.ForEachActiveObject([&](NodeSubscription * subscription) {
+        if (subscription->GetNode() == node)
+        {
+            found = subscription;
+            return Loop::Break;
+        }
+        return Loop::Continue;
+    });
+    return found;
+}
+
+void FleetSubscriptionManager::Enqueue(NodeSubscription & node, System::Clock::Timestamp dueTime)
+{
+    SetState(node, State::kQueued);
+    node.mDueTime = dueTime;
+
+    // Nodes are mostly queued in due time order, so look for the insertion point from the back.
+    auto position = mQueue.end();
+    while (position != mQueue.begin())
+    {
+        auto previous = position;
+        --previous;
+        if (previous->mDueTime <= dueTime)
+        {
+            break;
+        }
+        position = previous;
+    }
+    mQueue.InsertBefore(position, &node);
+}
+
+void FleetSubscriptionManager::SetState(NodeSubscription & node, State state)
+{
+    if (node.mState == State::kEstablishing)
+    {
+        mStats.establishing--;
+    }
+    else if (node.mState == State::kActive)
+    {
+        mStats.active--;
+    }
+
+    node.mState = state;
+
+    if (state == State::kEstablishing)
+    {
+        mStats.establishing++;
+    }
+    else if (state == State::kActive)
+    {
+        mStats.active++;
+    }
+}
+
+void FleetSubscriptionManager::ReleaseNode(NodeSubscription & node)
+{
+    SetState(node, State::kQueued);
+    if (node.IsInList())
+    {
+        mQueue.Remove(&node);
+    }
+    mStats.nodes--;
+    mNodes.ReleaseObject(&node);
+}
+
+void FleetSubscriptionManager::ScheduleStarts()
+{
+    VerifyOrReturn(mExchangeMgr != nullptr);
+    mSystemLayer->CancelTimer(OnStartTimer, this);
+    VerifyOrReturn(!mQueue.Empty() && mStats.establishing < mParams.maxConcurrentEstablishments);
+
+    System::Clock::Timestamp now     = System::SystemClock().GetMonotonicTimestamp();
+    System::Clock::Timestamp dueTime = mQueue.begin()->mDueTime;
+    System::Clock::Timeout delay     = (dueTime > now) ? (dueTime - now) : System::Clock::kZero;
+
+    CHIP_ERROR err = mSystemLayer->StartTimer(delay, OnStartTimer, this);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DataManagement, "Failed to schedule fleet subscriptions: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
+
+void FleetSubscriptionManager::OnStartTimer(System::Layer * layer, void * context)
+{
+    static_cast<FleetSubscriptionManager *>(context)->StartDueNodes();
+}
+
+void FleetSubscriptionManager::StartDueNodes()
+{
+    System::Clock::Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+
+    while (!mQueue.Empty() && mStats.establishing < mParams.maxConcurrentEstablishments)
+    {
+        NodeSubscription & node = *mQueue.begin();
+        if (node.mDueTime > now)
+        {
+            break;
+        }
+
+        mQueue.Remove(&node);
+        SetState(node, State::kEstablishing);
+
+        CHIP_ERROR err = node.Start();
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(DataManagement, "Failed to subscribe to " ChipLogFormatScopedNodeId ": %" CHIP_ERROR_FORMAT,
+                         ChipLogValueScopedNodeId(node.GetNode()), err.Format());
+            ScopedNodeId failedNode = node.GetNode();
+            ReleaseNode(node);
+            mDelegate->OnSubscriptionDone(failedNode, err);
+        }
+    }
+
+    ScheduleStarts();
+}
+
+CHIP_ERROR FleetSubscriptionManager::NodeSubscription::Start()
+{
+    if (mClient)
+    {
+        // The subscription was lost: let the ReadClient resubscribe, with the session it still has unless that needs
+        // to be set up again.
+        return mClient->ScheduleResubscription(0, NullOptional, mReestablishCASE);
+    }
+
+    mClient = Platform::MakeUnique<ReadClient>(InteractionModelEngine::GetInstance(), mManager.mExchangeMgr,
+                                               mCache.GetBufferedCallback(), ReadClient::InteractionType::Subscribe);
+    VerifyOrReturnError(mClient, CHIP_ERROR_NO_MEMORY);
+
+    const Parameters & params = mManager.mParams;
+    ReadPrepareParams readParams;
+    readParams.mpAttributePathParamsList    = mManager.mAttributePaths.Get();
+    readParams.mAttributePathParamsListSize = mManager.mAttributePaths.AllocatedSize();
+    readParams.mpEventPathParamsList        = mManager.mEventPaths.Get();
+    readParams.mEventPathParamsListSize     = mManager.mEventPaths.AllocatedSize();
+    readParams.mMinIntervalFloorSeconds     = params.minIntervalFloorSeconds;
+    readParams.mMaxIntervalCeilingSeconds   = params.maxIntervalCeilingSeconds;
+    readParams.mIsFabricFiltered            = params.isFabricFiltered;
+    readParams.mKeepSubscriptions           = true;
+
+    CHIP_ERROR err = mClient->SendAutoResubscribeRequest(mNode, std::move(readParams));
+    if (err != CHIP_NO_ERROR)
+    {
+        mClient.reset();
+    }
+    return err;
+}
+
+void FleetSubscriptionManager::NodeSubscription::OnAttributeData(const ConcreteDataAttributePath & path, TLV::TLVReader * data,
+                                                                  const StatusIB & status)
+{
+    mManager.mStats.attributes++;
+    mManager.mDelegate->OnAttributeData(mNode, path, data, status);
+}
+
+void FleetSubscriptionManager::NodeSubscription::OnEventData(const EventHeader & header, TLV::TLVReader * data,
+                                                              const StatusIB * status)
+{
+    mManager.mStats.events++;
+    mManager.mDelegate->OnEventData(mNode, header, data, status);
+}
+
+void FleetSubscriptionManager::NodeSubscription::OnReportEnd()
+{
+    mManager.mStats.reports++;
+    mManager.mDelegate->OnReportEnd(mNode, mCache);
+}
+
+void FleetSubscriptionManager::NodeSubscription::OnSubscriptionEstablished(SubscriptionId subscriptionId)
+{
+    mManager.SetState(*this, State::kActive);
+    mManager.mStats.established++;
+    mLastError = CHIP_NO_ERROR;
+
+    mManager.ScheduleStarts();
+    mManager.mDelegate->OnSubscriptionEstablished(mNode, subscriptionId);
+}
+
+CHIP_ERROR FleetSubscriptionManager::NodeSubscription::OnResubscriptionNeeded(ReadClient * client, CHIP_ERROR terminationCause)
+{
+    mManager.mStats.lost++;
+    mReestablishCASE = (terminationCause == CHIP_ERROR_TIMEOUT);
+
+    // Same back-off as ReadClient::DefaultResubscribePolicy, but paced with the rest of the fleet.
+    uint32_t backoffMs = client->ComputeTimeTillNextSubscription();
+    ChipLogProgress(DataManagement,
+                    "Will resubscribe to " ChipLogFormatScopedNodeId " in %" PRIu32 "ms due to error %" CHIP_ERROR_FORMAT,
+                    ChipLogValueScopedNodeId(mNode), backoffMs, terminationCause.Format());
+    mManager.Enqueue(*this, System::SystemClock().GetMonotonicTimestamp() + System::Clock::Milliseconds32(backoffMs));
+    mManager.ScheduleStarts();
+
+    mManager.mDelegate->OnSubscriptionLost(mNode, terminationCause);
+    return CHIP_NO_ERROR;
+}
+
+void FleetSubscriptionManager::NodeSubscription::OnError(CHIP_ERROR error)
+{
+    mLastError = error;
+}
+
+void FleetSubscriptionManager::NodeSubscription::OnDone(ReadClient * client)
+{
+    FleetSubscriptionManager & manager = mManager;
+    ScopedNodeId node                  = mNode;
+    CHIP_ERROR error                   = mLastError;
+
+    // Releasing the node destroys the ReadClient, which is allowed from OnDone.
+    manager.ReleaseNode(*this);
+    manager.ScheduleStarts();
+    manager.mDelegate->OnSubscriptionDone(node, error);
+}
+
+} // namespace app
+} // namespace chip
+#endif // CHIP_CONFIG_ENABLE_READ_CLIENT
@@ -0,0 +1,217 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <app/AppConfig.h>
+#include <app/AttributePathParams.h>
+#include <app/ClusterStateCache.h>
+#include <app/EventPathParams.h>
+#include <app/ReadClient.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/ScopedNodeId.h>
+#include <lib/support/IntrusiveList.h>
+#include <lib/support/Pool.h>
+#include <lib/support/ScopedBuffer.h>
+#include <messaging/ExchangeMgr.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+
+#if CHIP_CONFIG_ENABLE_READ_CLIENT
+namespace chip {
+namespace app {
+
+/**
+ * Keeps subscriptions to the same paths of many nodes, as a controller monitoring a whole fleet does.
+ *
+ * All the nodes share one copy of the attribute and event paths, and report to a single delegate; each node only has
+ * the ReadClient and ClusterStateCache that hold its own subscription state.  The nodes come from a pool sized by
+ * CHIP_CONFIG_FLEET_SUBSCRIPTION_MAX_NODES when it is statically allocated.
+ *
+ * Subscriptions are established through ReadClient::SendAutoResubscribeRequest, which sets up the CASE sessions through
+ * the CASESessionManager of the InteractionModelEngine.  At most Parameters::maxConcurrentEstablishments nodes are
+ * being subscribed to at any time, so that a large fleet does not start all its CASE handshakes at once.  Nodes wait
+ * for their turn in a single queue, ordered by the time they are due; a lost subscription goes back in that queue
+ * after the fibonacci back-off of its ReadClient, instead of each ReadClient arming its own resubscription timer.
+ */
+class FleetSubscriptionManager
+{
+public:
+    /**
+     * Notified of what happens to the subscriptions of all the nodes of the fleet.  The callbacks are made from the
+     * ReadClient of the node, so they must not remove that node from the fleet.
+     */
+    class Delegate
+    {
+    public:
+        virtual ~Delegate() = default;
+
+        virtual void OnSubscriptionEstablished(const ScopedNodeId & node, SubscriptionId subscriptionId) {}
+
+        virtual void OnAttributeData(const ScopedNodeId & node, const ConcreteDataAttributePath & path, TLV::TLVReader * data,
+                                     const StatusIB & status)
+        {}
+
+        virtual void OnEventData(const ScopedNodeId & node, const EventHeader & header, TLV::TLVReader * data,
+                                 const StatusIB * status)
+        {}
+
+        /**
+         * Called once the data of a report of the node has all been delivered, with the cache holding the data received
+         * from that node so far (if Parameters::cacheData is set).
+         */
+        virtual void OnReportEnd(const ScopedNodeId & node, const ClusterStateCache & cache) {}
+
+        /**
+         * The subscription to the node terminated, or could not be established.  The node will be subscribed to again.
+         */
+        virtual void OnSubscriptionLost(const ScopedNodeId & node, CHIP_ERROR error) {}
+
+        /**
+         * The manager gave up on the node, which is no longer part of the fleet.  Not called for nodes removed by
+         * RemoveNode() or Shutdown().
+         */
+        virtual void OnSubscriptionDone(const ScopedNodeId & node, CHIP_ERROR error) {}
+    };
+
+    struct Parameters
+    {
+        // Copied by Init(); the caller does not need to keep them around.
+        const AttributePathParams * attributePaths = nullptr;
+        size_t attributePathCount                  = 0;
+        const EventPathParams * eventPaths         = nullptr;
+        size_t eventPathCount                      = 0;
+
+        uint16_t minIntervalFloorSeconds   = 0;
+        uint16_t maxIntervalCeilingSeconds = 0;
+        bool isFabricFiltered              = true;
+
+        // Whether the cache of each node keeps the data it received, or only tracks data versions and event numbers.
+        bool cacheData = true;
+
+        uint16_t maxConcurrentEstablishments = 8;
+    };
+
+    struct Stats
+    {
+        size_t nodes         = 0;
+        size_t active        = 0;
+        size_t establishing  = 0;
+        uint32_t established = 0;
+        uint32_t lost        = 0;
+        uint32_t reports     = 0;
+        uint32_t attributes  = 0;
+        uint32_t events      = 0;
+    };
+
+    FleetSubscriptionManager() = default;
+    ~FleetSubscriptionManager() { Shutdown(); }
+
+    FleetSubscriptionManager(const FleetSubscriptionManager &)             = delete;
+    FleetSubscriptionManager & operator=(const FleetSubscriptionManager &) = delete;
+
+    CHIP_ERROR Init(Messaging::ExchangeManager * exchangeMgr, Delegate & delegate, const Parameters & params);
+
+    /**
+     * Drops all the subscriptions, without notifying the delegate, and releases the paths.  Init() can be called again
+     * afterwards.
+     */
+    void Shutdown();
+
+    /**
+     * Adds a node to the fleet.  The node is subscribed to once enough of the nodes added before it are done
+     * establishing their subscriptions.
+     */
+    CHIP_ERROR AddNode(const ScopedNodeId & node);
+
+    /**
+     * Drops the subscription to a node, without notifying the delegate.
+     */
+    CHIP_ERROR RemoveNode(const ScopedNodeId & node);
+
+    const Stats & GetStats() const { return mStats; }
+
+private:
+    enum class State : uint8_t
+    {
+        kQueued,       // Waiting in mQueue to be subscribed to.
+        kEstablishing, // Subscribing, counted against the concurrency limit.
+        kActive,
+    };
+
+    class NodeSubscription : public ClusterStateCache::Callback, public IntrusiveListNodeBase<IntrusiveMode::AutoUnlink>
+    {
+    public:
+        NodeSubscription(FleetSubscriptionManager & manager, const ScopedNodeId & node) :
+            mManager(manager), mNode(node), mCache(*this, NullOptional, manager.mParams.cacheData)
+        {}
+
+        const ScopedNodeId & GetNode() const { return mNode; }
+
+    private:
+        friend class FleetSubscriptionManager;
+
+        CHIP_ERROR Start();
+
+        //// ClusterStateCache::Callback Implementation ////
+        void OnAttributeData(const ConcreteDataAttributePath & path, TLV::TLVReader * data, const StatusIB & status) override;
+        void OnEventData(const EventHeader & header, TLV::TLVReader * data, const StatusIB * status) override;
+        void OnReportEnd() override;
+        void OnSubscriptionEstablished(SubscriptionId subscriptionId) override;
+        CHIP_ERROR OnResubscriptionNeeded(ReadClient * client, CHIP_ERROR terminationCause) override;
+        void OnError(CHIP_ERROR error) override;
+        void OnDone(ReadClient * client) override;
+        // The paths are shared by the whole fleet, and released by the manager.
+        void OnDeallocatePaths(ReadPrepareParams && params) override {}
+
+        FleetSubscriptionManager & mManager;
+        ScopedNodeId mNode;
+        ClusterStateCache mCache;
+        Platform::UniquePtr<ReadClient> mClient;
+        State mState = State::kQueued;
+        System::Clock::Timestamp mDueTime;
+        bool mReestablishCASE = false;
+        CHIP_ERROR mLastError = CHIP_NO_ERROR;
+    };
+
+    NodeSubscription * FindNode(const ScopedNodeId & node);
+    void Enqueue(NodeSubscription & node, System::Clock::Timestamp dueTime);
+    // Moves the node to the given state, keeping the active and establishing counts up to date.
+    void SetState(NodeSubscription & node, State state);
+    void ReleaseNode(NodeSubscription & node);
+
+    // Starts the nodes that are due, within the concurrency limit, from the timer rather than from the call stack of a
+    // ReadClient callback.
+    void ScheduleStarts();
+    void StartDueNodes();
+    static void OnStartTimer(System::Layer * layer, void * context);
+
+    Messaging::ExchangeManager * mExchangeMgr = nullptr;
+    System::Layer * mSystemLayer              = nullptr;
+    Delegate * mDelegate                      = nullptr;
+    Parameters mParams;
+    Platform::ScopedMemoryBufferWithSize<AttributePathParams> mAttributePaths;
+    Platform::ScopedMemoryBufferWithSize<EventPathParams> mEventPaths;
+
+    ObjectPool<NodeSubscription, CHIP_CONFIG_FLEET_SUBSCRIPTION_MAX_NODES> mNodes;
+    IntrusiveList<NodeSubscription, IntrusiveMode::AutoUnlink> mQueue;
+    Stats mStats;
+};
+
+} // namespace app
+} // namespace chip
+#endif // CHIP_CONFIG_ENABLE_READ_CLIENT
@@ -0,0 +1,845 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines an implementation of SubscriptionResumptionStorage that
+ *      keeps an index of the persisted subscriptions in RAM, and shares the path
+ *      lists of the subscriptions that have identical paths.
+ */
+
+#include <app/IndexedSubscriptionResumptionStorage.h>
+
+#include <app/SimpleSubscriptionResumptionStorage.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/SafeInt.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <string.h>
+
+namespace chip {
+namespace app {
+
+static_assert(IndexedSubscriptionResumptionStorage::kMaxSubscriptions < UINT16_MAX, "Path list ids must fit in a uint16_t");
+
+constexpr TLV::Tag IndexedSubscriptionResumptionStorage::kSubscriptionsListTag;
+constexpr TLV::Tag IndexedSubscriptionResumptionStorage::kPathListsListTag;
+constexpr TLV::Tag IndexedSubscriptionResumptionStorage::kPeerNodeIdTag;
+constexpr TLV::Tag IndexedSubscriptionResumptionStorage::kFabricIndexTag;
+constexpr TLV::Tag IndexedSubscriptionResumptionStorage::kSubscriptionIdTag;
+constexpr TLV::Tag IndexedSubscriptionResumptionStorage::kMinIntervalTag;
+constexpr TLV::Tag IndexedSubscriptionResumptionStorage::kMaxIntervalTag;
+constexpr TLV::Tag IndexedSubscriptionResumptionStorage::kFabricFilteredTag;
+constexpr TLV::Tag IndexedSubscriptionResumptionStorage::kPathListIdTag;
+constexpr TLV::Tag IndexedSubscriptionResumptionStorage::kPathListHashTag;
+constexpr TLV::Tag IndexedSubscriptionResumptionStorage::kPathListLengthTag;
+constexpr TLV::Tag IndexedSubscriptionResumptionStorage::kAttributePathsListTag;
+constexpr TLV::Tag IndexedSubscriptionResumptionStorage::kEventPathsListTag;
+
+IndexedSubscriptionResumptionStorage::IndexedSubscriptionInfoIterator::IndexedSubscriptionInfoIterator(
+    IndexedSubscriptionResumptionStorage & storage) :
+    mStorage(storage)
+{}
+
+size_t IndexedSubscriptionResumptionStorage::IndexedSubscriptionInfoIterator::Count()
+{
+    return mStorage.Count();
+}
+
+bool IndexedSubscriptionResumptionStorage::IndexedSubscriptionInfoIterator::Next(SubscriptionInfo & output)
+{
+    while (true)
+    {
+        // Find the subscription that comes after the last one returned in (path list id, entry index) order, so that
+        // the subscriptions sharing a path list are returned one after the other, even if the index changes meanwhile.
+        const IndexEntry * next = nullptr;
+        size_t nextIndex        = 0;
+        for (size_t i = 0; i < kMaxSubscriptions; i++)
+        {
+            const IndexEntry & entry = mStorage.mEntries[i];
+            if (!entry.IsInUse())
+            {
+                continue;
+            }
+            if (mStarted && (entry.mPathListId < mPathListId || (entry.mPathListId == mPathListId && i <= mEntryIndex)))
+            {
+                continue;
+            }
+            if (next == nullptr || entry.mPathListId < next->mPathListId)
+            {
+                next      = &entry;
+                nextIndex = i;
+            }
+        }
+
+        if (next == nullptr)
+        {
+            return false;
+        }
+
+        mStarted    = true;
+        mPathListId = next->mPathListId;
+        mEntryIndex = nextIndex;
+
+        CHIP_ERROR err = CHIP_NO_ERROR;
+        if (mLoadedPathList != mPathListId)
+        {
+            mLoadedPathList = kInvalidPathListId;
+            if (mPathList.Get() == nullptr)
+            {
+                mPathList.Calloc(MaxPathListSize());
+            }
+            mPathListLength = static_cast<uint16_t>(MaxPathListSize());
+            err = (mPathList.Get() == nullptr) ? CHIP_ERROR_NO_MEMORY
+                                               : mStorage.LoadPathList(mPathListId, mPathList.Get(), mPathListLength);
+            if (err == CHIP_NO_ERROR)
+            {
+                mLoadedPathList = mPathListId;
+            }
+        }
+
+        if (err == CHIP_NO_ERROR)
+        {
+            err = DecodePathList(mPathList.Get(), mPathListLength, output);
+        }
+
+        if (err == CHIP_NO_ERROR)
+        {
+            output.mNodeId         = next->mNodeId;
+            output.mFabricIndex    = next->mFabricIndex;
+            output.mSubscriptionId = next->mSubscriptionId;
+            output.mMinInterval    = next->mMinInterval;
+            output.mMaxInterval    = next->mMaxInterval;
+            output.mFabricFiltered = next->mFabricFiltered;
+            return true;
+        }
+
+        ChipLogError(DataManagement, "Failed to load paths of subscription %" PRIu32 " error %" CHIP_ERROR_FORMAT,
+                     next->mSubscriptionId, err.Format());
+        if (err != CHIP_ERROR_NO_MEMORY)
+        {
+            mStorage.Delete(next->mNodeId, next->mFabricIndex, next->mSubscriptionId);
+        }
+    }
+}
+
+void IndexedSubscriptionResumptionStorage::IndexedSubscriptionInfoIterator::Release()
+{
+    mStorage.mSubscriptionInfoIterators.ReleaseObject(this);
+}
+
+CHIP_ERROR IndexedSubscriptionResumptionStorage::Init(PersistentStorageDelegate * storage)
+{
+    VerifyOrReturnError(storage != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    mStorage = storage;
+
+    CHIP_ERROR err = LoadIndex();
+    if (err != CHIP_NO_ERROR && err != CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    {
+        ChipLogError(DataManagement, "Failed to load subscription resumption index error %" CHIP_ERROR_FORMAT, err.Format());
+        for (auto & entry : mEntries)
+        {
+            entry = IndexEntry();
+        }
+        for (auto & pathList : mPathLists)
+        {
+            pathList = PathListEntry();
+        }
+        err = mStorage->SyncDeleteKeyValue(DefaultStorageKeyAllocator::SubscriptionResumptionIndex().KeyName());
+        VerifyOrReturnError(err == CHIP_NO_ERROR || err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND, err);
+    }
+
+    // Nothing to do unless this is the first time, or the previous import did not finish.
+    return ImportSimpleStorage();
+}
+
+SubscriptionResumptionStorage::SubscriptionInfoIterator * IndexedSubscriptionResumptionStorage::IterateSubscriptions()
+{
+    return mSubscriptionInfoIterators.CreateObject(*this);
+}
+
+size_t IndexedSubscriptionResumptionStorage::Count() const
+{
+    size_t count = 0;
+    for (const auto & entry : mEntries)
+    {
+        if (entry.IsInUse())
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t IndexedSubscriptionResumptionStorage::PathListCount() const
+{
+    size_t count = 0;
+    for (const auto & pathList : mPathLists)
+    {
+        if (pathList.mRefCount != 0)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+CHIP_ERROR IndexedSubscriptionResumptionStorage::LoadIndex()
+{
+    Platform::ScopedMemoryBuffer<uint8_t> backingBuffer;
+    backingBuffer.Calloc(MaxIndexSize());
+    ReturnErrorCodeIf(backingBuffer.Get() == nullptr, CHIP_ERROR_NO_MEMORY);
+
+    uint16_t len = static_cast<uint16_t>(MaxIndexSize());
+    ReturnErrorOnFailure(
+        mStorage->SyncGetKeyValue(DefaultStorageKeyAllocator::SubscriptionResumptionIndex().KeyName(), backingBuffer.Get(), len));
+
+    TLV::ScopedBufferTLVReader reader(std::move(backingBuffer), len);
+
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag()));
+    TLV::TLVType indexContainerType;
+    ReturnErrorOnFailure(reader.EnterContainer(indexContainerType));
+
+    // Subscriptions
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_List, kSubscriptionsListTag));
+    TLV::TLVType subscriptionsListType;
+    ReturnErrorOnFailure(reader.EnterContainer(subscriptionsListType));
+
+    bool dropped      = false;
+    size_t entryCount = 0;
+    CHIP_ERROR err;
+    while ((err = reader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag())) == CHIP_NO_ERROR)
+    {
+        TLV::TLVType subscriptionContainerType;
+        ReturnErrorOnFailure(reader.EnterContainer(subscriptionContainerType));
+
+        IndexEntry entry;
+        ReturnErrorOnFailure(reader.Next(kPeerNodeIdTag));
+        ReturnErrorOnFailure(reader.Get(entry.mNodeId));
+        ReturnErrorOnFailure(reader.Next(kFabricIndexTag));
+        ReturnErrorOnFailure(reader.Get(entry.mFabricIndex));
+        ReturnErrorOnFailure(reader.Next(kSubscriptionIdTag));
+        ReturnErrorOnFailure(reader.Get(entry.mSubscriptionId));
+        ReturnErrorOnFailure(reader.Next(kMinIntervalTag));
+        ReturnErrorOnFailure(reader.Get(entry.mMinInterval));
+        ReturnErrorOnFailure(reader.Next(kMaxIntervalTag));
+        ReturnErrorOnFailure(reader.Get(entry.mMaxInterval));
+        ReturnErrorOnFailure(reader.Next(kFabricFilteredTag));
+        ReturnErrorOnFailure(reader.Get(entry.mFabricFiltered));
+        ReturnErrorOnFailure(reader.Next(kPathListIdTag));
+        ReturnErrorOnFailure(reader.Get(entry.mPathListId));
+
+        ReturnErrorOnFailure(reader.ExitContainer(subscriptionContainerType));
+
+        // Drop what does not fit anymore, if CHIP_IM_MAX_NUM_SUBSCRIPTIONS was lowered since the index was saved.
+        if (entryCount < kMaxSubscriptions && entry.mPathListId < kMaxSubscriptions)
+        {
+            mEntries[entryCount++] = entry;
+        }
+        else
+        {
+            dropped = true;
+        }
+    }
+    VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
+    ReturnErrorOnFailure(reader.ExitContainer(subscriptionsListType));
+
+    // Path lists
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_List, kPathListsListTag));
+    TLV::TLVType pathListsListType;
+    ReturnErrorOnFailure(reader.EnterContainer(pathListsListType));
+
+    while ((err = reader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag())) == CHIP_NO_ERROR)
+    {
+        TLV::TLVType pathListContainerType;
+        ReturnErrorOnFailure(reader.EnterContainer(pathListContainerType));
+
+        uint16_t pathListId;
+        PathListEntry pathList;
+        ReturnErrorOnFailure(reader.Next(kPathListIdTag));
+        ReturnErrorOnFailure(reader.Get(pathListId));
+        ReturnErrorOnFailure(reader.Next(kPathListHashTag));
+        ReturnErrorOnFailure(reader.Get(pathList.mHash));
+        ReturnErrorOnFailure(reader.Next(kPathListLengthTag));
+        ReturnErrorOnFailure(reader.Get(pathList.mLength));
+
+        ReturnErrorOnFailure(reader.ExitContainer(pathListContainerType));
+
+        if (pathListId < kMaxSubscriptions)
+        {
+            mPathLists[pathListId] = pathList;
+        }
+    }
+    VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
+    ReturnErrorOnFailure(reader.ExitContainer(pathListsListType));
+
+    ReturnErrorOnFailure(reader.ExitContainer(indexContainerType));
+
+    // A path list record is never empty, so a zero length means the path list is unknown.
+    for (auto & entry : mEntries)
+    {
+        if (!entry.IsInUse())
+        {
+            continue;
+        }
+        if (mPathLists[entry.mPathListId].mLength == 0)
+        {
+            entry   = IndexEntry();
+            dropped = true;
+            continue;
+        }
+        mPathLists[entry.mPathListId].mRefCount++;
+    }
+
+    if (dropped)
+    {
+        ReturnErrorOnFailure(SaveIndex());
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR IndexedSubscriptionResumptionStorage::SaveIndex(FabricIndex excludedFabric)
+{
+    bool empty = true;
+    for (const auto & entry : mEntries)
+    {
+        if (entry.IsInUse() && entry.mFabricIndex != excludedFabric)
+        {
+            empty = false;
+            break;
+        }
+    }
+
+    // Without subscriptions, the index can be deleted as well.
+    if (empty)
+    {
+        CHIP_ERROR err = mStorage->SyncDeleteKeyValue(DefaultStorageKeyAllocator::SubscriptionResumptionIndex().KeyName());
+        return (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND) ? CHIP_NO_ERROR : err;
+    }
+
+    Platform::ScopedMemoryBuffer<uint8_t> backingBuffer;
+    backingBuffer.Calloc(MaxIndexSize());
+    ReturnErrorCodeIf(backingBuffer.Get() == nullptr, CHIP_ERROR_NO_MEMORY);
+
+    TLV::ScopedBufferTLVWriter writer(std::move(backingBuffer), MaxIndexSize());
+
+    TLV::TLVType indexContainerType;
+    ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, indexContainerType));
+
+    TLV::TLVType subscriptionsListType;
+    ReturnErrorOnFailure(writer.StartContainer(kSubscriptionsListTag, TLV::kTLVType_List, subscriptionsListType));
+    for (const auto & entry : mEntries)
+    {
+        if (!entry.IsInUse() || entry.mFabricIndex == excludedFabric)
+        {
+            continue;
+        }
+
+        TLV::TLVType subscriptionContainerType;
+        ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, subscriptionContainerType));
+        ReturnErrorOnFailure(writer.Put(kPeerNodeIdTag, entry.mNodeId));
+        ReturnErrorOnFailure(writer.Put(kFabricIndexTag, entry.mFabricIndex));
+        ReturnErrorOnFailure(writer.Put(kSubscriptionIdTag, entry.mSubscriptionId));
+        ReturnErrorOnFailure(writer.Put(kMinIntervalTag, entry.mMinInterval));
+        ReturnErrorOnFailure(writer.Put(kMaxIntervalTag, entry.mMaxInterval));
+        ReturnErrorOnFailure(writer.Put(kFabricFilteredTag, entry.mFabricFiltered));
+        ReturnErrorOnFailure(writer.Put(kPathListIdTag, entry.mPathListId));
+        ReturnErrorOnFailure(writer.EndContainer(subscriptionContainerType));
+    }
+    ReturnErrorOnFailure(writer.EndContainer(subscriptionsListType));
+
+    TLV::TLVType pathListsListType;
+    ReturnErrorOnFailure(writer.StartContainer(kPathListsListTag, TLV::kTLVType_List, pathListsListType));
+    for (uint16_t pathListId = 0; pathListId < kMaxSubscriptions; pathListId++)
+    {
+        const PathListEntry & pathList = mPathLists[pathListId];
+        if (pathList.mRefCount == 0)
+        {
+            continue;
+        }
+
+        TLV::TLVType pathListContainerType;
+        ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, pathListContainerType));
+        ReturnErrorOnFailure(writer.Put(kPathListIdTag, pathListId));
+        ReturnErrorOnFailure(writer.Put(kPathListHashTag, pathList.mHash));
+        ReturnErrorOnFailure(writer.Put(kPathListLengthTag, pathList.mLength));
+        ReturnErrorOnFailure(writer.EndContainer(pathListContainerType));
+    }
+    ReturnErrorOnFailure(writer.EndContainer(pathListsListType));
+
+    ReturnErrorOnFailure(writer.EndContainer(indexContainerType));
+
+    const auto len = writer.GetLengthWritten();
+    VerifyOrReturnError(CanCastTo<uint16_t>(len), CHIP_ERROR_BUFFER_TOO_SMALL);
+
+    writer.Finalize(backingBuffer);
+
+    return mStorage->SyncSetKeyValue(DefaultStorageKeyAllocator::SubscriptionResumptionIndex().KeyName(), backingBuffer.Get(),
+                                     static_cast<uint16_t>(len));
+}
+
+CHIP_ERROR IndexedSubscriptionResumptionStorage::ImportSimpleStorage()
+{
+    // SimpleSubscriptionResumptionStorage always saves its max count along with its subscriptions, and the import deletes
+    // it last.
+    VerifyOrReturnError(mStorage->SyncDoesKeyExist(DefaultStorageKeyAllocator::SubscriptionResumptionMaxCount().KeyName()),
+                        CHIP_NO_ERROR);
+
+    SimpleSubscriptionResumptionStorage simpleStorage;
+    ReturnErrorOnFailure(simpleStorage.Init(mStorage));
+
+    auto * iterator = simpleStorage.IterateSubscriptions();
+    VerifyOrReturnError(iterator != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    SubscriptionInfo subscriptionInfo;
+    size_t importedCount = 0;
+    CHIP_ERROR err       = CHIP_NO_ERROR;
+    while (err == CHIP_NO_ERROR && iterator->Next(subscriptionInfo))
+    {
+        // Subscriptions already in the index are replaced, in case the import is resumed.
+        IndexEntry * entry;
+        IndexEntry previous;
+        err = AddToIndex(subscriptionInfo, entry, previous);
+        if (err == CHIP_NO_ERROR)
+        {
+            if (previous.IsInUse())
+            {
+                ReleasePathList(previous.mPathListId);
+            }
+            importedCount++;
+        }
+    }
+    iterator->Release();
+
+    // The records of SimpleSubscriptionResumptionStorage stay until all of them made it into the index record, so that the
+    // next Init() tries again.
+    if (err == CHIP_NO_ERROR)
+    {
+        err = SaveIndex();
+    }
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DataManagement, "Failed to import persisted subscriptions error %" CHIP_ERROR_FORMAT, err.Format());
+        return err;
+    }
+
+    for (uint16_t subscriptionIndex = 0; subscriptionIndex < CHIP_IM_MAX_NUM_SUBSCRIPTIONS; subscriptionIndex++)
+    {
+        mStorage->SyncDeleteKeyValue(DefaultStorageKeyAllocator::SubscriptionResumption(subscriptionIndex).KeyName());
+    }
+    err = mStorage->SyncDeleteKeyValue(DefaultStorageKeyAllocator::SubscriptionResumptionMaxCount().KeyName());
+
+    ChipLogProgress(DataManagement, "Imported %u persisted subscriptions", static_cast<unsigned>(importedCount));
+    return err;
+}
+
+CHIP_ERROR IndexedSubscriptionResumptionStorage::AddToIndex(const SubscriptionInfo & subscriptionInfo, IndexEntry *& entry,
+                                                            IndexEntry & previous)
+{
+    // Replace the subscription if it is already there, or use the first free entry.
+    entry = nullptr;
+    for (auto & candidate : mEntries)
+    {
+        if (candidate.Matches(subscriptionInfo.mNodeId, subscriptionInfo.mFabricIndex, subscriptionInfo.mSubscriptionId))
+        {
+            entry = &candidate;
+            break;
+        }
+        if (entry == nullptr && !candidate.IsInUse())
+        {
+            entry = &candidate;
+        }
+    }
+    VerifyOrReturnError(entry != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    Platform::ScopedMemoryBuffer<uint8_t> backingBuffer;
+    backingBuffer.Calloc(MaxPathListSize());
+    ReturnErrorCodeIf(backingBuffer.Get() == nullptr, CHIP_ERROR_NO_MEMORY);
+
+    TLV::TLVWriter writer;
+    writer.Init(backingBuffer.Get(), MaxPathListSize());
+    ReturnErrorOnFailure(EncodePathList(writer, subscriptionInfo));
+    ReturnErrorOnFailure(writer.Finalize());
+
+    const auto len = writer.GetLengthWritten();
+    VerifyOrReturnError(CanCastTo<uint16_t>(len), CHIP_ERROR_BUFFER_TOO_SMALL);
+
+    uint16_t pathListId;
+    ReturnErrorOnFailure(FindOrSavePathList(backingBuffer.Get(), static_cast<uint16_t>(len), pathListId));
+
+    previous               = *entry;
+    entry->mNodeId         = subscriptionInfo.mNodeId;
+    entry->mFabricIndex    = subscriptionInfo.mFabricIndex;
+    entry->mSubscriptionId = subscriptionInfo.mSubscriptionId;
+    entry->mMinInterval    = subscriptionInfo.mMinInterval;
+    entry->mMaxInterval    = subscriptionInfo.mMaxInterval;
+    entry->mFabricFiltered = subscriptionInfo.mFabricFiltered;
+    entry->mPathListId     = pathListId;
+    mPathLists[pathListId].mRefCount++;
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR IndexedSubscriptionResumptionStorage::Save(SubscriptionInfo & subscriptionInfo)
+{
+    IndexEntry * entry;
+    IndexEntry previous;
+    ReturnErrorOnFailure(AddToIndex(subscriptionInfo, entry, previous));
+
+    CHIP_ERROR err = SaveIndex();
+    if (err != CHIP_NO_ERROR)
+    {
+        // Leave the index as it is stored.
+        ReleasePathList(entry->mPathListId);
+        *entry = previous;
+        return err;
+    }
+
+    // The path list of the replaced subscription is only released now that the index does not refer to it anymore.
+    if (previous.IsInUse())
+    {
+        ReleasePathList(previous.mPathListId);
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR IndexedSubscriptionResumptionStorage::Delete(NodeId nodeId, FabricIndex fabricIndex, SubscriptionId subscriptionId)
+{
+    for (auto & entry : mEntries)
+    {
+        if (!entry.Matches(nodeId, fabricIndex, subscriptionId))
+        {
+            continue;
+        }
+
+        IndexEntry removed = entry;
+        entry              = IndexEntry();
+
+        CHIP_ERROR err = SaveIndex();
+        if (err != CHIP_NO_ERROR)
+        {
+            entry = removed;
+            return err;
+        }
+
+        ReleasePathList(removed.mPathListId);
+        return CHIP_NO_ERROR;
+    }
+
+    return CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND;
+}
+
+CHIP_ERROR IndexedSubscriptionResumptionStorage::DeleteAll(FabricIndex fabricIndex)
+{
+    bool found = false;
+    for (const auto & entry : mEntries)
+    {
+        if (entry.IsInUse() && entry.mFabricIndex == fabricIndex)
+        {
+            found = true;
+            break;
+        }
+    }
+    VerifyOrReturnError(found, CHIP_NO_ERROR);
+
+    ReturnErrorOnFailure(SaveIndex(fabricIndex));
+
+    for (auto & entry : mEntries)
+    {
+        if (entry.IsInUse() && entry.mFabricIndex == fabricIndex)
+        {
+            uint16_t pathListId = entry.mPathListId;
+            entry               = IndexEntry();
+            ReleasePathList(pathListId);
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR IndexedSubscriptionResumptionStorage::LoadPathList(uint16_t pathListId, uint8_t * buffer, uint16_t & length)
+{
+    return mStorage->SyncGetKeyValue(DefaultStorageKeyAllocator::SubscriptionResumptionPathList(pathListId).KeyName(), buffer,
+                                     length);
+}
+
+CHIP_ERROR IndexedSubscriptionResumptionStorage::DeletePathList(uint16_t pathListId)
+{
+    return mStorage->SyncDeleteKeyValue(DefaultStorageKeyAllocator::SubscriptionResumptionPathList(pathListId).KeyName());
+}
+
+CHIP_ERROR IndexedSubscriptionResumptionStorage::FindOrSavePathList(const uint8_t * encoded, uint16_t length,
+                                                                    uint16_t & pathListId)
+{
+    const uint32_t hash = HashPathList(encoded, length);
+
+    Platform::ScopedMemoryBuffer<uint8_t> storedBuffer;
+    uint16_t freePathListId = kInvalidPathListId;
+    for (uint16_t candidateId = 0; candidateId < kMaxSubscriptions; candidateId++)
+    {
+        const PathListEntry & candidate = mPathLists[candidateId];
+        if (candidate.mRefCount == 0)
+        {
+            if (freePathListId == kInvalidPathListId)
+            {
+                freePathListId = candidateId;
+            }
+            continue;
+        }
+
+        if (candidate.mHash != hash || candidate.mLength != length)
+        {
+            continue;
+        }
+
+        // Only the stored path list tells whether the paths are really the same.
+        if (storedBuffer.Get() == nullptr)
+        {
+            storedBuffer.Calloc(length);
+            ReturnErrorCodeIf(storedBuffer.Get() == nullptr, CHIP_ERROR_NO_MEMORY);
+        }
+        uint16_t storedLength = length;
+        if (LoadPathList(candidateId, storedBuffer.Get(), storedLength) == CHIP_NO_ERROR && storedLength == length &&
+            memcmp(storedBuffer.Get(), encoded, length) == 0)
+        {
+            pathListId = candidateId;
+            return CHIP_NO_ERROR;
+        }
+    }
+
+    VerifyOrReturnError(freePathListId != kInvalidPathListId, CHIP_ERROR_NO_MEMORY);
+    ReturnErrorOnFailure(mStorage->SyncSetKeyValue(
+        DefaultStorageKeyAllocator::SubscriptionResumptionPathList(freePathListId).KeyName(), encoded, length));
+
+    mPathLists[freePathListId].mHash   = hash;
+    mPathLists[freePathListId].mLength = length;
+    pathListId                         = freePathListId;
+    return CHIP_NO_ERROR;
+}
+
+void IndexedSubscriptionResumptionStorage::ReleasePathList(uint16_t pathListId)
+{
+    VerifyOrReturn(pathListId < kMaxSubscriptions && mPathLists[pathListId].mRefCount > 0);
+
+    if (--mPathLists[pathListId].mRefCount == 0)
+    {
+        CHIP_ERROR err = DeletePathList(pathListId);
+        if (err != CHIP_NO_ERROR && err != CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+        {
+            ChipLogError(DataManagement, "Failed to delete subscription path list %u error %" CHIP_ERROR_FORMAT,
+                         static_cast<unsigned>(pathListId), err.Format());
+        }
+        mPathLists[pathListId] = PathListEntry();
+    }
+}
+
+CHIP_ERROR IndexedSubscriptionResumptionStorage::EncodePathList(TLV::TLVWriter & writer, const SubscriptionInfo & subscriptionInfo)
+{
+    TLV::TLVType pathListContainerType;
+    ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, pathListContainerType));
+
+    // Attribute paths
+    TLV::TLVType attributesListType;
+    ReturnErrorOnFailure(writer.StartContainer(kAttributePathsListTag, TLV::kTLVType_List, attributesListType));
+    for (size_t pathIndex = 0; pathIndex < subscriptionInfo.mAttributePaths.AllocatedSize(); pathIndex++)
+    {
+        const AttributePathParamsValues & path = subscriptionInfo.mAttributePaths[pathIndex];
+
+        TLV::TLVType attributeContainerType;
+        ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, attributeContainerType));
+        if (path.mEndpointId != kInvalidEndpointId)
+        {
+            ReturnErrorOnFailure(writer.Put(TLV::ContextTag(kEndpointIdTag), path.mEndpointId));
+        }
+        if (path.mClusterId != kInvalidClusterId)
+        {
+            ReturnErrorOnFailure(writer.Put(TLV::ContextTag(kClusterIdTag), path.mClusterId));
+        }
+        if (path.mAttributeId != kInvalidAttributeId)
+        {
+            ReturnErrorOnFailure(writer.Put(TLV::ContextTag(kAttributeIdTag), path.mAttributeId));
+        }
+        ReturnErrorOnFailure(writer.EndContainer(attributeContainerType));
+    }
+    ReturnErrorOnFailure(writer.EndContainer(attributesListType));
+
+    // Event paths
+    TLV::TLVType eventsListType;
+    ReturnErrorOnFailure(writer.StartContainer(kEventPathsListTag, TLV::kTLVType_List, eventsListType));
+    for (size_t pathIndex = 0; pathIndex < subscriptionInfo.mEventPaths.AllocatedSize(); pathIndex++)
+    {
+        const EventPathParamsValues & path = subscriptionInfo.mEventPaths[pathIndex];
+
+        TLV::TLVType eventContainerType;
+        ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, eventContainerType));
+        if (path.mEndpointId != kInvalidEndpointId)
+        {
+            ReturnErrorOnFailure(writer.Put(TLV::ContextTag(kEndpointIdTag), path.mEndpointId));
+        }
+        if (path.mClusterId != kInvalidClusterId)
+        {
+            ReturnErrorOnFailure(writer.Put(TLV::ContextTag(kClusterIdTag), path.mClusterId));
+        }
+        if (path.mEventId != kInvalidEventId)
+        {
+            ReturnErrorOnFailure(writer.Put(TLV::ContextTag(kEventIdTag), path.mEventId));
+        }
+        if (path.mIsUrgentEvent)
+        {
+            ReturnErrorOnFailure(writer.PutBoolean(TLV::ContextTag(kUrgentTag), true));
+        }
+        ReturnErrorOnFailure(writer.EndContainer(eventContainerType));
+    }
+    ReturnErrorOnFailure(writer.EndContainer(eventsListType));
+
+    return writer.EndContainer(pathListContainerType);
+}
+
+CHIP_ERROR IndexedSubscriptionResumptionStorage::DecodePathList(const uint8_t * encoded, uint16_t length,
+                                                                SubscriptionInfo & subscriptionInfo)
+{
+    TLV::TLVReader reader;
+    reader.Init(encoded, length);
+
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag()));
+    TLV::TLVType pathListContainerType;
+    ReturnErrorOnFailure(reader.EnterContainer(pathListContainerType));
+
+    // Attribute paths
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_List, kAttributePathsListTag));
+    TLV::TLVType attributesListType;
+    ReturnErrorOnFailure(reader.EnterContainer(attributesListType));
+
+    size_t pathCount = 0;
+    ReturnErrorOnFailure(reader.CountRemainingInContainer(&pathCount));
+
+    // If a stack struct is being reused to iterate, free the previous paths ScopedMemoryBuffer
+    subscriptionInfo.mAttributePaths.Free();
+    if (pathCount)
+    {
+        subscriptionInfo.mAttributePaths.Calloc(pathCount);
+        ReturnErrorCodeIf(subscriptionInfo.mAttributePaths.Get() == nullptr, CHIP_ERROR_NO_MEMORY);
+        for (size_t pathIndex = 0; pathIndex < pathCount; pathIndex++)
+        {
+            AttributePathParamsValues & path = subscriptionInfo.mAttributePaths[pathIndex];
+            path.mEndpointId                 = kInvalidEndpointId;
+            path.mClusterId                  = kInvalidClusterId;
+            path.mAttributeId                = kInvalidAttributeId;
+
+            ReturnErrorOnFailure(reader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag()));
+            TLV::TLVType attributeContainerType;
+            ReturnErrorOnFailure(reader.EnterContainer(attributeContainerType));
+
+            CHIP_ERROR err;
+            while ((err = reader.Next()) == CHIP_NO_ERROR)
+            {
+                VerifyOrReturnError(TLV::IsContextTag(reader.GetTag()), CHIP_ERROR_INVALID_TLV_TAG);
+                switch (TLV::TagNumFromTag(reader.GetTag()))
+                {
+                case kEndpointIdTag:
+                    ReturnErrorOnFailure(reader.Get(path.mEndpointId));
+                    break;
+                case kClusterIdTag:
+                    ReturnErrorOnFailure(reader.Get(path.mClusterId));
+                    break;
+                case kAttributeIdTag:
+                    ReturnErrorOnFailure(reader.Get(path.mAttributeId));
+                    break;
+                default:
+                    break;
+                }
+            }
+            VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
+
+            ReturnErrorOnFailure(reader.ExitContainer(attributeContainerType));
+        }
+    }
+    ReturnErrorOnFailure(reader.ExitContainer(attributesListType));
+
+    // Event paths
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_List, kEventPathsListTag));
+    TLV::TLVType eventsListType;
+    ReturnErrorOnFailure(reader.EnterContainer(eventsListType));
+
+    ReturnErrorOnFailure(reader.CountRemainingInContainer(&pathCount));
+
+    // If a stack struct is being reused to iterate, free the previous paths ScopedMemoryBuffer
+    subscriptionInfo.mEventPaths.Free();
+    if (pathCount)
+    {
+        subscriptionInfo.mEventPaths.Calloc(pathCount);
+        ReturnErrorCodeIf(subscriptionInfo.mEventPaths.Get() == nullptr, CHIP_ERROR_NO_MEMORY);
+        for (size_t pathIndex = 0; pathIndex < pathCount; pathIndex++)
+        {
+            EventPathParamsValues & path = subscriptionInfo.mEventPaths[pathIndex];
+            path.mEndpointId             = kInvalidEndpointId;
+            path.mClusterId              = kInvalidClusterId;
+            path.mEventId                = kInvalidEventId;
+            path.mIsUrgentEvent          = false;
+
+            ReturnErrorOnFailure(reader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag()));
+            TLV::TLVType eventContainerType;
+            ReturnErrorOnFailure(reader.EnterContainer(eventContainerType));
+
+            CHIP_ERROR err;
+            while ((err = reader.Next()) == CHIP_NO_ERROR)
+            {
+                VerifyOrReturnError(TLV::IsContextTag(reader.GetTag()), CHIP_ERROR_INVALID_TLV_TAG);
+                switch (TLV::TagNumFromTag(reader.GetTag()))
+                {
+                case kEndpointIdTag:
+                    ReturnErrorOnFailure(reader.Get(path.mEndpointId));
+                    break;
+                case kClusterIdTag:
+                    ReturnErrorOnFailure(reader.Get(path.mClusterId));
+                    break;
+                case kEventIdTag:
+                    ReturnErrorOnFailure(reader.Get(path.mEventId));
+                    break;
+                case kUrgentTag:
+                    ReturnErrorOnFailure(reader.Get(path.mIsUrgentEvent));
+                    break;
+                default:
+                    break;
+                }
+            }
+            VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
+
+            ReturnErrorOnFailure(reader.ExitContainer(eventContainerType));
+        }
+    }
+    ReturnErrorOnFailure(reader.ExitContainer(eventsListType));
+
+    return reader.ExitContainer(pathListContainerType);
+}
+
+uint32_t IndexedSubscriptionResumptionStorage::HashPathList(const uint8_t * encoded, uint16_t length)
+{
+    // 32-bit FNV-1a
+    uint32_t hash = 2166136261u;
+    for (uint16_t i = 0; i < length; i++)
+    {
+        hash ^= encoded[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+} // namespace app
+} // namespace chip
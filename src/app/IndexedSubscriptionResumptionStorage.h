@@ -0,0 +1,221 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines an implementation of SubscriptionResumptionStorage that
+ *      keeps an index of the persisted subscriptions in RAM, and shares the path
+ *      lists of the subscriptions that have identical paths.
+ */
+
+#pragma once
+
+#include <app/SubscriptionResumptionStorage.h>
+
+#include <lib/core/TLV.h>
+#include <lib/support/DefaultStorageKeyAllocator.h>
+#include <lib/support/Pool.h>
+
+namespace chip {
+namespace app {
+
+/**
+ * A SubscriptionResumptionStorage using PersistentStorageDelegate as its backend, that does not need to read the
+ * storage to find a subscription.
+ *
+ * All the subscriptions are described by a single index record, which Init() reads into RAM; the paths of the
+ * subscriptions are stored in separate path list records that subscriptions with identical paths share.  Saving a
+ * subscription writes the index record, and the path list record unless an identical one is already stored; iterating
+ * reads each path list record once, as the subscriptions are iterated over grouped by path list.
+ *
+ * Subscriptions persisted by SimpleSubscriptionResumptionStorage are imported by Init().  Their records are deleted once
+ * the index record holding all of them is written, and an import that does not finish is resumed by the next Init().
+ * The migration is one-way: SimpleSubscriptionResumptionStorage does not read the index, so going back to it after
+ * running this storage loses the persisted subscriptions.
+ *
+ * Servers using CommonCaseDeviceServerInitParams keep SimpleSubscriptionResumptionStorage, unless they inject an
+ * initialized instance of this one as subscriptionResumptionStorage before InitializeStaticResourcesBeforeServerInit().
+ */
+class IndexedSubscriptionResumptionStorage : public SubscriptionResumptionStorage
+{
+public:
+    static constexpr size_t kIteratorsMax     = CHIP_CONFIG_MAX_SUBSCRIPTION_RESUMPTION_STORAGE_CONCURRENT_ITERATORS;
+    static constexpr size_t kMaxSubscriptions = CHIP_IM_MAX_NUM_SUBSCRIPTIONS;
+
+    CHIP_ERROR Init(PersistentStorageDelegate * storage);
+
+    SubscriptionInfoIterator * IterateSubscriptions() override;
+
+    CHIP_ERROR Save(SubscriptionInfo & subscriptionInfo) override;
+
+    CHIP_ERROR Delete(NodeId nodeId, FabricIndex fabricIndex, SubscriptionId subscriptionId) override;
+
+    CHIP_ERROR DeleteAll(FabricIndex fabricIndex) override;
+
+protected:
+    static constexpr uint16_t kInvalidPathListId = UINT16_MAX;
+
+    struct IndexEntry
+    {
+        NodeId mNodeId;
+        FabricIndex mFabricIndex;
+        SubscriptionId mSubscriptionId;
+        uint16_t mMinInterval;
+        uint16_t mMaxInterval;
+        bool mFabricFiltered;
+        // kInvalidPathListId if the entry is free.
+        uint16_t mPathListId = kInvalidPathListId;
+
+        bool IsInUse() const { return mPathListId != kInvalidPathListId; }
+        bool Matches(NodeId nodeId, FabricIndex fabricIndex, SubscriptionId subscriptionId) const
+        {
+            return IsInUse() && mNodeId == nodeId && mFabricIndex == fabricIndex && mSubscriptionId == subscriptionId;
+        }
+    };
+
+    // Path lists are identified by their index in mPathLists.  The hash and length of the encoded path list let Save()
+    // find an identical path list without reading every path list record.
+    struct PathListEntry
+    {
+        uint32_t mHash     = 0;
+        uint16_t mLength   = 0;
+        uint16_t mRefCount = 0;
+    };
+
+    class IndexedSubscriptionInfoIterator : public SubscriptionInfoIterator
+    {
+    public:
+        IndexedSubscriptionInfoIterator(IndexedSubscriptionResumptionStorage & storage);
+        size_t Count() override;
+        bool Next(SubscriptionInfo & output) override;
+        void Release() override;
+
+    private:
+        IndexedSubscriptionResumptionStorage & mStorage;
+        // Position of the last subscription returned, in (path list id, entry index) order.
+        uint16_t mPathListId = 0;
+        size_t mEntryIndex   = 0;
+        bool mStarted        = false;
+        // Path list record of the last subscription returned.
+        Platform::ScopedMemoryBuffer<uint8_t> mPathList;
+        uint16_t mPathListLength = 0;
+        uint16_t mLoadedPathList = kInvalidPathListId;
+    };
+
+    size_t Count() const;
+    size_t PathListCount() const;
+
+    CHIP_ERROR LoadIndex();
+    // Writes the index record, leaving out the subscriptions of excludedFabric.
+    CHIP_ERROR SaveIndex(FabricIndex excludedFabric = kUndefinedFabricIndex);
+    CHIP_ERROR ImportSimpleStorage();
+
+    // Records the subscription in the in-RAM index, storing its path list if needed.  entry is set to the index entry
+    // used, and previous to what that entry held before.  The index record is not written.
+    CHIP_ERROR AddToIndex(const SubscriptionInfo & subscriptionInfo, IndexEntry *& entry, IndexEntry & previous);
+
+    CHIP_ERROR LoadPathList(uint16_t pathListId, uint8_t * buffer, uint16_t & length);
+    CHIP_ERROR DeletePathList(uint16_t pathListId);
+    // Returns the id of a stored path list encoded as the given bytes, storing it if there is none.
+    CHIP_ERROR FindOrSavePathList(const uint8_t * encoded, uint16_t length, uint16_t & pathListId);
+    void ReleasePathList(uint16_t pathListId);
+
+    static CHIP_ERROR EncodePathList(TLV::TLVWriter & writer, const SubscriptionInfo & subscriptionInfo);
+    static CHIP_ERROR DecodePathList(const uint8_t * encoded, uint16_t length, SubscriptionInfo & subscriptionInfo);
+    static uint32_t HashPathList(const uint8_t * encoded, uint16_t length);
+
+    static constexpr size_t MaxPathListSize()
+    {
+        // IM engine declares an attribute path pool and an event path pool, and each pool
+        // includes CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS_FOR_SUBSCRIPTIONS for subscriptions
+        return TLV::EstimateStructOverhead(
+            TLV::EstimateStructOverhead(sizeof(EndpointId), sizeof(ClusterId), sizeof(AttributeId)) *
+                CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS_FOR_SUBSCRIPTIONS,
+            TLV::EstimateStructOverhead(sizeof(EndpointId), sizeof(ClusterId), sizeof(EventId), sizeof(bool)) *
+                CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS_FOR_SUBSCRIPTIONS);
+    }
+
+    static constexpr size_t MaxIndexSize()
+    {
+        return TLV::EstimateStructOverhead(
+            TLV::EstimateStructOverhead(sizeof(NodeId), sizeof(FabricIndex), sizeof(SubscriptionId), sizeof(uint16_t),
+                                        sizeof(uint16_t), sizeof(bool), sizeof(uint16_t)) *
+                kMaxSubscriptions,
+            TLV::EstimateStructOverhead(sizeof(uint16_t), sizeof(uint32_t), sizeof(uint16_t)) * kMaxSubscriptions);
+    }
+
+    // Index record:
+    //   Structure of:
+    //     List of:
+    //       Structure of: (Subscription info)
+    //         Node ID
+    //         Fabric Index
+    //         Subscription ID
+    //         Min interval
+    //         Max interval
+    //         Fabric filtered boolean
+    //         Path list ID
+    //     List of:
+    //       Structure of: (Path list)
+    //         Path list ID
+    //         Hash of the path list record
+    //         Length of the path list record
+    //
+    // Path list record, one per path list ID, where wildcard path fields are omitted:
+    //   Structure of:
+    //     List of:
+    //       Structure of: (Attribute path)
+    //         Endpoint ID
+    //         Cluster ID
+    //         Attribute ID
+    //     List of:
+    //       Structure of: (Event path)
+    //         Endpoint ID
+    //         Cluster ID
+    //         Event ID
+    //         Urgent boolean, only if true
+
+    static constexpr TLV::Tag kSubscriptionsListTag = TLV::ContextTag(1);
+    static constexpr TLV::Tag kPathListsListTag     = TLV::ContextTag(2);
+
+    static constexpr TLV::Tag kPeerNodeIdTag     = TLV::ContextTag(1);
+    static constexpr TLV::Tag kFabricIndexTag    = TLV::ContextTag(2);
+    static constexpr TLV::Tag kSubscriptionIdTag = TLV::ContextTag(3);
+    static constexpr TLV::Tag kMinIntervalTag    = TLV::ContextTag(4);
+    static constexpr TLV::Tag kMaxIntervalTag    = TLV::ContextTag(5);
+    static constexpr TLV::Tag kFabricFilteredTag = TLV::ContextTag(6);
+    static constexpr TLV::Tag kPathListIdTag     = TLV::ContextTag(7);
+
+    static constexpr TLV::Tag kPathListHashTag   = TLV::ContextTag(8);
+    static constexpr TLV::Tag kPathListLengthTag = TLV::ContextTag(9);
+
+    static constexpr TLV::Tag kAttributePathsListTag = TLV::ContextTag(1);
+    static constexpr TLV::Tag kEventPathsListTag     = TLV::ContextTag(2);
+
+    static constexpr uint8_t kEndpointIdTag  = 1;
+    static constexpr uint8_t kClusterIdTag   = 2;
+    static constexpr uint8_t kAttributeIdTag = 3;
+    static constexpr uint8_t kEventIdTag     = 3;
+    static constexpr uint8_t kUrgentTag      = 4;
+
+    PersistentStorageDelegate * mStorage = nullptr;
+    IndexEntry mEntries[kMaxSubscriptions];
+    PathListEntry mPathLists[kMaxSubscriptions];
+    ObjectPool<IndexedSubscriptionInfoIterator, kIteratorsMax> mSubscriptionInfoIterators;
+};
+} // namespace app
+} // namespace chip
@@ -0,0 +1,514 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/PersistentEventLog.h>
+
+#include <app/EventManagement.h>
+#include <app/MessageDef/EventDataIB.h>
+#include <app/MessageDef/EventReportIB.h>
+#include <lib/core/CHIPEncoding.h>
+#include <lib/core/TLV.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/DefaultStorageKeyAllocator.h>
+#include <lib/support/ScopedBuffer.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <string.h>
+
+namespace chip {
+namespace app {
+
+static_assert(PersistentEventLog::kSegmentCount >= 2, "Rotating a single segment would drop every persisted event");
+static_assert(PersistentEventLog::kSegmentCount <= UINT8_MAX, "The segment count is stored as a uint8_t");
+static_assert(CHIP_CONFIG_PERSISTENT_EVENT_LOG_SEGMENT_SIZE <= UINT16_MAX, "A segment must fit in a storage value");
+static_assert(CHIP_CONFIG_PERSISTENT_EVENT_LOG_SEGMENT_SIZE > 2 * sizeof(EventNumber) + kMaxEventSizeReserve,
+              "A segment must hold an event of the largest size");
+
+namespace {
+
+constexpr TLV::Tag kFirstSegmentIdTag = TLV::ContextTag(1);
+constexpr TLV::Tag kSegmentCountTag   = TLV::ContextTag(2);
+constexpr size_t kIndexSize           = TLV::EstimateStructOverhead(sizeof(uint32_t), sizeof(uint8_t));
+
+CHIP_ERROR GetEventNumber(const TLV::TLVReader & aEvent, EventNumber & aEventNumber)
+{
+    EventReportIB::Parser report;
+    EventDataIB::Parser data;
+    ReturnErrorOnFailure(report.Init(aEvent));
+    ReturnErrorOnFailure(report.GetEventData(&data));
+    return data.GetEventNumber(&aEventNumber);
+}
+
+/**
+ * Set the fabric index of the event at the reader to kUndefinedFabricIndex if it is aFabricIndex, in the buffer the reader
+ * reads from, the way EventManagement::FabricRemovedCB does.
+ *
+ * @return Whether the event was changed.
+ */
+bool ScrubFabricIndex(const TLV::TLVReader & aEvent, uint8_t * apBuffer, FabricIndex aFabricIndex)
+{
+    TLV::TLVReader reader;
+    TLV::TLVType containerType;
+    reader.Init(aEvent);
+    VerifyOrReturnValue(reader.EnterContainer(containerType) == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(reader.Next(TLV::ContextTag(EventReportIB::Tag::kEventData)) == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(reader.EnterContainer(containerType) == CHIP_NO_ERROR, false);
+
+    while (reader.Next() == CHIP_NO_ERROR)
+    {
+        if (reader.GetTag() == TLV::ProfileTag(kEventManagementProfile, kFabricIndexTag))
+        {
+            uint8_t fabricIndex = 0;
+            VerifyOrReturnValue(reader.Get(fabricIndex) == CHIP_NO_ERROR && fabricIndex == aFabricIndex, false);
+            // The fabric index is encoded as a one byte integer, which ends where the reader stands.
+            apBuffer[reader.GetReadPoint() - apBuffer - 1] = kUndefinedFabricIndex;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+CHIP_ERROR PersistentEventLog::Init(PersistentStorageDelegate * apStorage, System::Layer * apSystemLayer,
+                                    PriorityLevel aMinPriority, System::Clock::Milliseconds32 aFlushDelay)
+{
+    VerifyOrReturnError(apStorage != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mpStorage == nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    mpStorage       = apStorage;
+    mpSystemLayer   = apSystemLayer;
+    mMinPriority    = aMinPriority;
+    mFlushDelay     = aFlushDelay;
+    mDirty          = false;
+    mFlushScheduled = false;
+    mSealedLength   = 0;
+    mDropPending    = false;
+
+    CHIP_ERROR err = LoadIndex();
+    if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    {
+        mFirstSegmentId = 0;
+        mSegmentCount   = 1;
+        err             = StoreIndex();
+    }
+    else if (err != CHIP_NO_ERROR)
+    {
+        // Start over, rather than leave the events logged from now on unpersisted.
+        ChipLogError(EventLogging, "Persistent event log index is invalid: %" CHIP_ERROR_FORMAT, err.Format());
+        mFirstSegmentId = 0;
+        mSegmentCount   = 1;
+        mpStorage->SyncDeleteKeyValue(DefaultStorageKeyAllocator::IMEventLogSegment(GetOpenSegmentId()).KeyName());
+        err = StoreIndex();
+    }
+    if (err != CHIP_NO_ERROR)
+    {
+        mpStorage = nullptr;
+        return err;
+    }
+
+    LoadSegments();
+    return CHIP_NO_ERROR;
+}
+
+void PersistentEventLog::Shutdown()
+{
+    VerifyOrReturn(mpStorage != nullptr);
+
+    if (mFlushScheduled)
+    {
+        mpSystemLayer->CancelTimer(OnFlushTimer, this);
+        mFlushScheduled = false;
+    }
+
+    CHIP_ERROR err = Flush();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(EventLogging, "Failed to write persistent event log: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+
+    mpStorage     = nullptr;
+    mpSystemLayer = nullptr;
+}
+
+CHIP_ERROR PersistentEventLog::Append(EventNumber aEventNumber, const TLV::TLVReader & aEvent)
+{
+    VerifyOrReturnError(mpStorage != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    SegmentRange & range = mRanges[mSegmentCount - 1];
+    VerifyOrReturnError(range.IsEmpty() || aEventNumber > range.mLast, CHIP_ERROR_INVALID_ARGUMENT);
+
+    TLV::TLVReader reader;
+    TLV::TLVWriter writer;
+    reader.Init(aEvent);
+    writer.Init(mOpenSegment + mOpenLength, static_cast<uint32_t>(kSegmentSize - mOpenLength));
+    CHIP_ERROR err = writer.CopyElement(reader);
+    if ((err == CHIP_ERROR_NO_MEMORY || err == CHIP_ERROR_BUFFER_TOO_SMALL) && !range.IsEmpty())
+    {
+        ReturnErrorOnFailure(Rotate());
+        return Append(aEventNumber, aEvent);
+    }
+    VerifyOrReturnError(err != CHIP_ERROR_NO_MEMORY, CHIP_ERROR_BUFFER_TOO_SMALL);
+    ReturnErrorOnFailure(err);
+    ReturnErrorOnFailure(writer.Finalize());
+
+    mOpenLength = static_cast<uint16_t>(mOpenLength + writer.GetLengthWritten());
+    if (range.IsEmpty())
+    {
+        range.mFirst = aEventNumber;
+    }
+    range.mLast = aEventNumber;
+    mDirty      = true;
+
+    ScheduleFlush(mFlushDelay);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR PersistentEventLog::Flush()
+{
+    VerifyOrReturnError(mpStorage != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    // The open segment is only listed in the index once the sealed one is written.
+    ReturnErrorOnFailure(WriteSealedSegment());
+    VerifyOrReturnError(mDirty, CHIP_NO_ERROR);
+
+    WriteHeader(mOpenSegment, mRanges[mSegmentCount - 1]);
+    ReturnErrorOnFailure(mpStorage->SyncSetKeyValue(DefaultStorageKeyAllocator::IMEventLogSegment(GetOpenSegmentId()).KeyName(),
+                                                    mOpenSegment, mOpenLength));
+    mDirty = false;
+    return CHIP_NO_ERROR;
+}
+
+EventNumber PersistentEventLog::GetFirstEventNumber() const
+{
+    for (size_t i = 0; i < mSegmentCount; i++)
+    {
+        if (!mRanges[i].IsEmpty())
+        {
+            return mRanges[i].mFirst;
+        }
+    }
+    return 0;
+}
+
+EventNumber PersistentEventLog::GetNextEventNumber() const
+{
+    for (size_t i = mSegmentCount; i > 0; i--)
+    {
+        if (!mRanges[i - 1].IsEmpty())
+        {
+            return mRanges[i - 1].mLast + 1;
+        }
+    }
+    return 0;
+}
+
+CHIP_ERROR PersistentEventLog::ForEachEvent(EventNumber aFirst, EventNumber aEnd, TLV::Utilities::IterateHandler aHandler,
+                                            void * apContext)
+{
+    VerifyOrReturnError(mpStorage != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    Platform::ScopedMemoryBuffer<uint8_t> segment;
+
+    for (size_t i = 0; i < mSegmentCount; i++)
+    {
+        const SegmentRange & range = mRanges[i];
+        if (range.IsEmpty() || range.mLast < aFirst || range.mFirst >= aEnd)
+        {
+            continue;
+        }
+
+        const uint8_t * data = mOpenSegment;
+        uint16_t length      = mOpenLength;
+        if (i + 2 == mSegmentCount && mSealedLength != 0)
+        {
+            data   = mSealedSegment;
+            length = mSealedLength;
+        }
+        else if (i + 1 < mSegmentCount)
+        {
+            if (segment.Get() == nullptr)
+            {
+                VerifyOrReturnError(segment.Alloc(kSegmentSize), CHIP_ERROR_NO_MEMORY);
+            }
+            CHIP_ERROR err = LoadSegment(mFirstSegmentId + static_cast<uint32_t>(i), segment.Get(), length);
+            if (err != CHIP_NO_ERROR)
+            {
+                ChipLogError(EventLogging,
+                             "Skipping persisted events 0x" ChipLogFormatX64 "-0x" ChipLogFormatX64 ": %" CHIP_ERROR_FORMAT,
+                             ChipLogValueX64(range.mFirst), ChipLogValueX64(range.mLast), err.Format());
+                continue;
+            }
+            data = segment.Get();
+        }
+
+        TLV::TLVReader reader;
+        CHIP_ERROR err;
+        reader.Init(data + kHeaderSize, static_cast<size_t>(length - kHeaderSize));
+        while ((err = reader.Next()) == CHIP_NO_ERROR)
+        {
+            EventNumber eventNumber = 0;
+            err                     = GetEventNumber(reader, eventNumber);
+            if (err != CHIP_NO_ERROR)
+            {
+                break;
+            }
+            VerifyOrReturnError(eventNumber < aEnd, CHIP_NO_ERROR);
+            if (eventNumber >= aFirst)
+            {
+                ReturnErrorOnFailure(aHandler(reader, 0, apContext));
+            }
+        }
+        if (err != CHIP_END_OF_TLV)
+        {
+            ChipLogError(EventLogging, "Persisted events are invalid: %" CHIP_ERROR_FORMAT, err.Format());
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR PersistentEventLog::FabricRemoved(FabricIndex aFabricIndex)
+{
+    VerifyOrReturnError(mpStorage != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    Platform::ScopedMemoryBuffer<uint8_t> segment;
+    VerifyOrReturnError(segment.Alloc(kSegmentSize), CHIP_ERROR_NO_MEMORY);
+    // Scrub the sealed segment in storage, along with the other full segments.
+    ReturnErrorOnFailure(WriteSealedSegment());
+
+    for (size_t i = 0; i < mSegmentCount; i++)
+    {
+        const bool isOpen = (i + 1 == mSegmentCount);
+        const uint32_t id = mFirstSegmentId + static_cast<uint32_t>(i);
+        uint8_t * data    = mOpenSegment;
+        uint16_t length   = mOpenLength;
+        bool changed      = false;
+
+        if (mRanges[i].IsEmpty() || (!isOpen && LoadSegment(id, segment.Get(), length) != CHIP_NO_ERROR))
+        {
+            continue;
+        }
+        if (!isOpen)
+        {
+            data = segment.Get();
+        }
+
+        TLV::TLVReader reader;
+        reader.Init(data + kHeaderSize, static_cast<size_t>(length - kHeaderSize));
+        while (reader.Next() == CHIP_NO_ERROR)
+        {
+            changed |= ScrubFabricIndex(reader, data, aFabricIndex);
+        }
+
+        if (changed && isOpen)
+        {
+            mDirty = true;
+            ReturnErrorOnFailure(Flush());
+        }
+        else if (changed)
+        {
+            ReturnErrorOnFailure(
+                mpStorage->SyncSetKeyValue(DefaultStorageKeyAllocator::IMEventLogSegment(id).KeyName(), data, length));
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR PersistentEventLog::LoadIndex()
+{
+    uint8_t buffer[kIndexSize];
+    uint16_t size = sizeof(buffer);
+    ReturnErrorOnFailure(mpStorage->SyncGetKeyValue(DefaultStorageKeyAllocator::IMEventLogIndex().KeyName(), buffer, size));
+
+    TLV::TLVReader reader;
+    TLV::TLVType containerType;
+    uint8_t segmentCount;
+    reader.Init(buffer, size);
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag()));
+    ReturnErrorOnFailure(reader.EnterContainer(containerType));
+    ReturnErrorOnFailure(reader.Next(kFirstSegmentIdTag));
+    ReturnErrorOnFailure(reader.Get(mFirstSegmentId));
+    ReturnErrorOnFailure(reader.Next(kSegmentCountTag));
+    ReturnErrorOnFailure(reader.Get(segmentCount));
+    ReturnErrorOnFailure(reader.ExitContainer(containerType));
+
+    VerifyOrReturnError(segmentCount > 0 && segmentCount <= kSegmentCount, CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+    mSegmentCount = segmentCount;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR PersistentEventLog::StoreIndex()
+{
+    uint8_t buffer[kIndexSize];
+    TLV::TLVWriter writer;
+    TLV::TLVType containerType;
+    writer.Init(buffer);
+    ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, containerType));
+    ReturnErrorOnFailure(writer.Put(kFirstSegmentIdTag, mFirstSegmentId));
+    ReturnErrorOnFailure(writer.Put(kSegmentCountTag, static_cast<uint8_t>(mSegmentCount)));
+    ReturnErrorOnFailure(writer.EndContainer(containerType));
+    ReturnErrorOnFailure(writer.Finalize());
+
+    return mpStorage->SyncSetKeyValue(DefaultStorageKeyAllocator::IMEventLogIndex().KeyName(), buffer,
+                                      static_cast<uint16_t>(writer.GetLengthWritten()));
+}
+
+void PersistentEventLog::LoadSegments()
+{
+    // Only the ranges of the sealed segments are kept in RAM; their events are read from storage when needed.
+    for (size_t i = 0; i + 1 < mSegmentCount; i++)
+    {
+        uint8_t header[kHeaderSize];
+        uint16_t size  = sizeof(header);
+        CHIP_ERROR err = mpStorage->SyncGetKeyValue(
+            DefaultStorageKeyAllocator::IMEventLogSegment(mFirstSegmentId + static_cast<uint32_t>(i)).KeyName(), header, size);
+
+        mRanges[i] = SegmentRange();
+        if ((err == CHIP_NO_ERROR && size == kHeaderSize) || err == CHIP_ERROR_BUFFER_TOO_SMALL)
+        {
+            mRanges[i].mFirst = Encoding::LittleEndian::Get64(header);
+            mRanges[i].mLast  = Encoding::LittleEndian::Get64(header + sizeof(EventNumber));
+        }
+    }
+
+    SegmentRange & open = mRanges[mSegmentCount - 1];
+    open                = SegmentRange();
+    mOpenLength         = kHeaderSize;
+    if (LoadSegment(GetOpenSegmentId(), mOpenSegment, mOpenLength) == CHIP_NO_ERROR)
+    {
+        open.mFirst = Encoding::LittleEndian::Get64(mOpenSegment);
+        open.mLast  = Encoding::LittleEndian::Get64(mOpenSegment + sizeof(EventNumber));
+    }
+    else
+    {
+        mOpenLength = kHeaderSize;
+    }
+}
+
+CHIP_ERROR PersistentEventLog::LoadSegment(uint32_t aSegmentId, uint8_t * apBuffer, uint16_t & aLength)
+{
+    aLength = kSegmentSize;
+    ReturnErrorOnFailure(
+        mpStorage->SyncGetKeyValue(DefaultStorageKeyAllocator::IMEventLogSegment(aSegmentId).KeyName(), apBuffer, aLength));
+    VerifyOrReturnError(aLength >= kHeaderSize, CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR PersistentEventLog::Rotate()
+{
+    VerifyOrReturnError(mSealedLength == 0, CHIP_ERROR_NO_MEMORY);
+
+    WriteHeader(mOpenSegment, mRanges[mSegmentCount - 1]);
+    memcpy(mSealedSegment, mOpenSegment, mOpenLength);
+    mSealedLength = mOpenLength;
+
+    if (mSegmentCount == kSegmentCount)
+    {
+        memmove(&mRanges[0], &mRanges[1], sizeof(mRanges[0]) * (kSegmentCount - 1));
+        mFirstSegmentId++;
+        mSegmentCount--;
+        mDropPending = true;
+    }
+
+    mRanges[mSegmentCount] = SegmentRange();
+    mSegmentCount++;
+    mOpenLength = kHeaderSize;
+    mDirty      = false;
+
+    if (mpSystemLayer == nullptr)
+    {
+        return WriteSealedSegment();
+    }
+    ScheduleFlush(System::Clock::kZero);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR PersistentEventLog::WriteSealedSegment()
+{
+    VerifyOrReturnError(mSealedLength != 0, CHIP_NO_ERROR);
+
+    // Until the index is stored, a reboot finds the sealed segment as the open one, and the deleted segment as unreadable.
+    ReturnErrorOnFailure(
+        mpStorage->SyncSetKeyValue(DefaultStorageKeyAllocator::IMEventLogSegment(GetOpenSegmentId() - 1).KeyName(),
+                                   mSealedSegment, mSealedLength));
+    if (mDropPending)
+    {
+        CHIP_ERROR err =
+            mpStorage->SyncDeleteKeyValue(DefaultStorageKeyAllocator::IMEventLogSegment(mFirstSegmentId - 1).KeyName());
+        VerifyOrReturnError(err == CHIP_NO_ERROR || err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND, err);
+        mDropPending = false;
+    }
+    ReturnErrorOnFailure(StoreIndex());
+    mSealedLength = 0;
+    return CHIP_NO_ERROR;
+}
+
+void PersistentEventLog::WriteHeader(uint8_t * apSegment, const SegmentRange & aRange)
+{
+    Encoding::LittleEndian::Put64(apSegment, aRange.mFirst);
+    Encoding::LittleEndian::Put64(apSegment + sizeof(EventNumber), aRange.mLast);
+}
+
+void PersistentEventLog::ScheduleFlush(System::Clock::Milliseconds32 aDelay)
+{
+    VerifyOrReturn(mpSystemLayer != nullptr);
+
+    // The flush is not pushed back by further events, so that a steady stream of events is still written every delay.  A
+    // sealed segment is written on the next turn of the event loop, to make room for the next one.
+    if (mFlushScheduled)
+    {
+        VerifyOrReturn(aDelay == System::Clock::kZero);
+        mpSystemLayer->CancelTimer(OnFlushTimer, this);
+        mFlushScheduled = false;
+    }
+    CHIP_ERROR err = mpSystemLayer->StartTimer(aDelay, OnFlushTimer, this);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(EventLogging, "Failed to schedule persistent event log write: %" CHIP_ERROR_FORMAT, err.Format());
+        return;
+    }
+    mFlushScheduled = true;
+}
+
+void PersistentEventLog::OnFlushTimer(System::Layer * apSystemLayer, void * apAppState)
+{
+    PersistentEventLog * log = static_cast<PersistentEventLog *>(apAppState);
+    log->mFlushScheduled     = false;
+
+    CHIP_ERROR err;
+    if (log->mSealedLength != 0)
+    {
+        // Only write the segment that was sealed, and leave the events appended since staged for the delay.
+        err = log->WriteSealedSegment();
+        if (log->mDirty)
+        {
+            log->ScheduleFlush(log->mFlushDelay);
+        }
+    }
+    else
+    {
+        err = log->Flush();
+    }
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(EventLogging, "Failed to write persistent event log: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
+
+} // namespace app
+} // namespace chip
@@ -0,0 +1,168 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <app/EventLoggingTypes.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/CHIPPersistentStorageDelegate.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/core/TLVReader.h>
+#include <lib/core/TLVUtilities.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+
+namespace chip {
+namespace app {
+
+/**
+ * @brief
+ *   A persistent tier for the events logged by EventManagement.
+ *
+ * Events are appended, in event number order, to segments of CHIP_CONFIG_PERSISTENT_EVENT_LOG_SEGMENT_SIZE bytes that are
+ * each stored under their own key of a PersistentStorageDelegate, along with an index key recording which segments exist.
+ * The newest segment is staged in RAM and written after a delay, so that events logged in a burst are written together and
+ * logging an event does not wait for storage.  Once it is full, it is sealed into a second RAM buffer and a new segment is
+ * started; the sealed segment is written, and the index updated, by the next flush rather than by Append.  Once there are
+ * CHIP_CONFIG_PERSISTENT_EVENT_LOG_SEGMENT_COUNT segments, the oldest one is deleted to make room for a new one.
+ *
+ * The log is only used from the Matter thread.
+ */
+class PersistentEventLog
+{
+public:
+    static constexpr uint16_t kSegmentSize = CHIP_CONFIG_PERSISTENT_EVENT_LOG_SEGMENT_SIZE;
+    static constexpr size_t kSegmentCount  = CHIP_CONFIG_PERSISTENT_EVENT_LOG_SEGMENT_COUNT;
+
+    /**
+     * @brief
+     *   Load the log from storage, or create an empty one.
+     *
+     * @param[in] apStorage     The storage holding the log.
+     * @param[in] apSystemLayer The layer used to write staged events after aFlushDelay.  If null, staged events are only
+     *                          written by Flush(), and by Append when their segment is full.
+     * @param[in] aMinPriority  The lowest priority of the events that are persisted.
+     * @param[in] aFlushDelay   The delay after which an appended event is written.
+     */
+    CHIP_ERROR Init(PersistentStorageDelegate * apStorage, System::Layer * apSystemLayer,
+                    PriorityLevel aMinPriority                = PriorityLevel::Info,
+                    System::Clock::Milliseconds32 aFlushDelay = System::Clock::Milliseconds32(
+                        CHIP_CONFIG_PERSISTENT_EVENT_LOG_FLUSH_DELAY_MS));
+
+    /**
+     * @brief
+     *   Write the staged events and stop using the storage.
+     */
+    void Shutdown();
+
+    bool IsPersisted(PriorityLevel aPriority) const { return mpStorage != nullptr && aPriority >= mMinPriority; }
+
+    /**
+     * @brief
+     *   Append an event, whose number must be greater than the number of the events already in the log.
+     *
+     * @param[in] aEventNumber The number of the event.
+     * @param[in] aEvent       A reader positioned on the EventReportIB element of the event, as stored by EventManagement.
+     *
+     * @retval #CHIP_ERROR_BUFFER_TOO_SMALL The event does not fit in a segment.
+     * @retval #CHIP_ERROR_NO_MEMORY        The segment is full, and the previous full segment was not written yet.
+     */
+    CHIP_ERROR Append(EventNumber aEventNumber, const TLV::TLVReader & aEvent);
+
+    /**
+     * @brief
+     *   Write the staged events now.
+     */
+    CHIP_ERROR Flush();
+
+    /**
+     * @brief
+     *   Get the number of the oldest event in the log, or 0 if it is empty.
+     */
+    EventNumber GetFirstEventNumber() const;
+
+    /**
+     * @brief
+     *   Get the number following the newest event in the log, below which events cannot be appended, or 0 if it is empty.
+     */
+    EventNumber GetNextEventNumber() const;
+
+    /**
+     * @brief
+     *   Call aHandler, in event number order, on the EventReportIB element of each event numbered from aFirst to aEnd,
+     *   excluded.  Segments that cannot be read from storage are skipped.
+     *
+     * @return The first error returned by aHandler, if any.
+     */
+    CHIP_ERROR ForEachEvent(EventNumber aFirst, EventNumber aEnd, TLV::Utilities::IterateHandler aHandler, void * apContext);
+
+    /**
+     * @brief
+     *   Invalidate the fabric index of the events of the given fabric, in every segment, the way
+     *   EventManagement::FabricRemoved does for the events in its buffers.
+     */
+    CHIP_ERROR FabricRemoved(FabricIndex aFabricIndex);
+
+private:
+    /**
+     * The numbers of the first and last events of a segment, stored at the start of the segment.  An empty segment has a
+     * first event number greater than its last.
+     */
+    struct SegmentRange
+    {
+        EventNumber mFirst = 1;
+        EventNumber mLast  = 0;
+
+        bool IsEmpty() const { return mFirst > mLast; }
+    };
+
+    static constexpr uint16_t kHeaderSize = 2 * sizeof(EventNumber);
+
+    uint32_t GetOpenSegmentId() const { return mFirstSegmentId + static_cast<uint32_t>(mSegmentCount - 1); }
+    CHIP_ERROR LoadIndex();
+    CHIP_ERROR StoreIndex();
+    void LoadSegments();
+    CHIP_ERROR LoadSegment(uint32_t aSegmentId, uint8_t * apBuffer, uint16_t & aLength);
+    CHIP_ERROR Rotate();
+    CHIP_ERROR WriteSealedSegment();
+    void WriteHeader(uint8_t * apSegment, const SegmentRange & aRange);
+    void ScheduleFlush(System::Clock::Milliseconds32 aDelay);
+    static void OnFlushTimer(System::Layer * apSystemLayer, void * apAppState);
+
+    PersistentStorageDelegate * mpStorage = nullptr;
+    System::Layer * mpSystemLayer         = nullptr;
+    PriorityLevel mMinPriority            = PriorityLevel::Info;
+    System::Clock::Milliseconds32 mFlushDelay;
+
+    uint32_t mFirstSegmentId = 0;
+    size_t mSegmentCount     = 0; ///< The number of segments, the last of which is staged in mOpenSegment
+    SegmentRange mRanges[kSegmentCount];
+
+    uint8_t mOpenSegment[kSegmentSize];
+    uint16_t mOpenLength = kHeaderSize; ///< The length of mOpenSegment in use, including the header
+    bool mDirty          = false;       ///< Whether mOpenSegment holds events that were not written yet
+    bool mFlushScheduled = false;
+
+    // The full segment before the open one, until the next flush writes it.  The segment it made room for, before
+    // mFirstSegmentId, is deleted along with it.
+    uint8_t mSealedSegment[kSegmentSize];
+    uint16_t mSealedLength = 0; ///< The length of mSealedSegment, or 0 if no segment is waiting to be written
+    bool mDropPending      = false;
+};
+
+} // namespace app
+} // namespace chip
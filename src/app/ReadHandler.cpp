@@ -115,6 +115,8 @@ void ReadHandler::ResumeSubscription(CASESessionManager & caseSessionManager,
             return;
         }
     }
+    InteractionModelEngine::GetInstance()->GetReportingEngine().AddInterestPaths(this);
+
     for (size_t i = 0; i < subscriptionInfo.mEventPaths.AllocatedSize(); i++)
     {
         EventPathParams eventPathParams = subscriptionInfo.mEventPaths[i].GetParams();
@@ -147,6 +149,7 @@ ReadHandler::~ReadHandler()
     {
         InteractionModelEngine::GetInstance()->GetReportingEngine().OnReportConfirm();
     }
+    InteractionModelEngine::GetInstance()->GetReportingEngine().RemoveInterestPaths(this);
     InteractionModelEngine::GetInstance()->ReleaseAttributePathList(mpAttributePathList);
     InteractionModelEngine::GetInstance()->ReleaseEventPathList(mpEventPathList);
     InteractionModelEngine::GetInstance()->ReleaseDataVersionFilterList(mpDataVersionFilterList);
@@ -484,6 +487,7 @@ CHIP_ERROR ReadHandler::ProcessAttributePaths(AttributePathIBs::Parser & aAttrib
     if (CHIP_END_OF_TLV == err)
     {
         InteractionModelEngine::GetInstance()->RemoveDuplicateConcreteAttributePath(mpAttributePathList);
+        InteractionModelEngine::GetInstance()->GetReportingEngine().AddInterestPaths(this);
         mAttributePathExpandIterator = AttributePathExpandIterator(mpAttributePathList);
         err                          = CHIP_NO_ERROR;
     }
@@ -826,6 +830,9 @@ void ReadHandler::ResetPathIterator()
 {
     mAttributePathExpandIterator = AttributePathExpandIterator(mpAttributePathList);
     mAttributeEncoderState       = AttributeValueEncoder::AttributeEncodeState();
+#if CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
+    mPendingAttributeReports = nullptr;
+#endif // CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
 }
 
 void ReadHandler::AttributePathIsDirty(const AttributePathParams & aAttributeChanged)
@@ -855,6 +862,9 @@ void ReadHandler::AttributePathIsDirty(const AttributePathParams & aAttributeCha
         // the state of the cluster as present on the server
         mAttributePathExpandIterator.ResetCurrentCluster();
         mAttributeEncoderState = AttributeValueEncoder::AttributeEncodeState();
+#if CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
+        mPendingAttributeReports = nullptr;
+#endif // CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
     }
 
     // ReportScheduler will take care of verifying the reportability of the handler and schedule the run
@@ -289,6 +289,9 @@ private:
 
         // Don't need the response for report data if true
         SuppressResponse = (1 << 5),
+
+        // The attribute paths of this handler are missing from the reporting engine's interest index.
+        InterestPathsNotIndexed = (1 << 6),
     };
 
     /**
@@ -409,6 +412,11 @@ private:
 
     const AttributeValueEncoder::AttributeEncodeState & GetAttributeEncodeState() const { return mAttributeEncoderState; }
     void SetAttributeEncodeState(const AttributeValueEncoder::AttributeEncodeState & aState) { mAttributeEncoderState = aState; }
+#if CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
+    bool HasPendingAttributeReports() const { return !mPendingAttributeReports.IsNull(); }
+    System::PacketBufferHandle TakePendingAttributeReports() { return std::move(mPendingAttributeReports); }
+    void SetPendingAttributeReports(System::PacketBufferHandle && aReports) { mPendingAttributeReports = std::move(aReports); }
+#endif // CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
     uint32_t GetLastWrittenEventsBytes() const { return mLastWrittenEventsBytes; }
 
     // Returns the number of interested paths, including wildcard and concrete paths.
@@ -563,6 +571,13 @@ private:
     // The size of AttributeEncoderState is 2 bytes for now.
     AttributeValueEncoder::AttributeEncodeState mAttributeEncoderState;
 
+#if CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
+    // AttributeReportIBs for the current path that were encoded past the end of the last report message, as a sequence of
+    // anonymous TLV elements.  They are sent before anything else in the next chunk, and mAttributeEncoderState is where
+    // encoding continues after them.
+    System::PacketBufferHandle mPendingAttributeReports;
+#endif // CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
+
     // Current Handler state
     HandlerState mState            = HandlerState::Idle;
     PriorityLevel mCurrentPriority = PriorityLevel::Invalid;
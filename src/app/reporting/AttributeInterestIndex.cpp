@@ -0,0 +1,83 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/reporting/AttributeInterestIndex.h>
+
+#include <lib/support/CodeUtils.h>
+
+namespace chip {
+namespace app {
+namespace reporting {
+
+CHIP_ERROR AttributeInterestIndex::Add(ReadHandler * apReadHandler, const ObjectList<AttributePathParams> * apPaths)
+{
+    for (auto * path = apPaths; path != nullptr; path = path->mpNext)
+    {
+        Entry * entry = mEntries.CreateObject(apReadHandler, &path->mValue);
+        VerifyOrReturnError(entry != nullptr, CHIP_ERROR_NO_MEMORY);
+
+        Entry *& list =
+            CanLookup(path->mValue) ? mBuckets[BucketFor(path->mValue.mEndpointId, path->mValue.mClusterId)] : mWildcardEntries;
+        entry->mpNext = list;
+        list          = entry;
+    }
+    return CHIP_NO_ERROR;
+}
+
+void AttributeInterestIndex::Remove(ReadHandler * apReadHandler)
+{
+    VerifyOrReturn(mEntries.Allocated() > 0);
+
+    for (auto & bucket : mBuckets)
+    {
+        RemoveFromList(bucket, apReadHandler);
+    }
+    RemoveFromList(mWildcardEntries, apReadHandler);
+}
+
+void AttributeInterestIndex::RemoveFromList(Entry *& aList, ReadHandler * apReadHandler)
+{
+    Entry ** link = &aList;
+    while (*link != nullptr)
+    {
+        Entry * entry = *link;
+        if (entry->mpReadHandler == apReadHandler)
+        {
+            *link = entry->mpNext;
+            mEntries.ReleaseObject(entry);
+        }
+        else
+        {
+            link = &entry->mpNext;
+        }
+    }
+}
+
+void AttributeInterestIndex::Clear()
+{
+    mEntries.ReleaseAll();
+    for (auto & bucket : mBuckets)
+    {
+        bucket = nullptr;
+    }
+    mWildcardEntries = nullptr;
+}
+
+} // namespace reporting
+} // namespace app
+} // namespace chip
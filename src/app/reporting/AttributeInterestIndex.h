@@ -0,0 +1,133 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines an index from the attribute paths read handlers are
+ *      interested in to those read handlers.
+ *
+ */
+
+#pragma once
+
+#include <app/AttributePathParams.h>
+#include <app/ObjectList.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/CHIPError.h>
+#include <lib/support/Iterators.h>
+#include <lib/support/Pool.h>
+
+namespace chip {
+namespace app {
+
+class ReadHandler;
+
+namespace reporting {
+
+/*
+ *  @class AttributeInterestIndex
+ *
+ *  @brief Maps attribute paths to the read handlers whose interest list contains an intersecting path, so that
+ *  Engine::SetDirty does not need to walk the path list of every read handler.
+ *
+ *  Paths with a concrete endpoint and cluster are hashed by (endpoint, cluster).  Paths with a wildcard endpoint or
+ *  cluster are kept on a separate list that every lookup visits; in practice there are few of them.
+ *
+ *  Entries point at the nodes of the handler's attribute path list, so a handler must be removed before its path
+ *  list is released.
+ */
+class AttributeInterestIndex
+{
+public:
+    AttributeInterestIndex() { Clear(); }
+
+    /**
+     * Add all the paths in apPaths for apReadHandler.
+     *
+     * @retval #CHIP_ERROR_NO_MEMORY if not all paths could be added; the caller should then Remove() the handler.
+     */
+    CHIP_ERROR Add(ReadHandler * apReadHandler, const ObjectList<AttributePathParams> * apPaths);
+
+    /**
+     * Remove all the paths of apReadHandler.  This visits every entry, so is meant for handler teardown only.
+     */
+    void Remove(ReadHandler * apReadHandler);
+
+    void Clear();
+
+    /**
+     * Call aFunction(ReadHandler *) for every indexed path intersecting aPath, which must have a concrete endpoint and
+     * cluster.  A handler with several intersecting paths is visited once per path.  aFunction must not modify the index.
+     */
+    template <typename Function>
+    Loop ForEachIntersecting(const AttributePathParams & aPath, Function && aFunction) const
+    {
+        for (const Entry * list : { mBuckets[BucketFor(aPath.mEndpointId, aPath.mClusterId)], mWildcardEntries })
+        {
+            for (const Entry * entry = list; entry != nullptr; entry = entry->mpNext)
+            {
+                if (entry->mpPath->Intersects(aPath) && aFunction(entry->mpReadHandler) == Loop::Break)
+                {
+                    return Loop::Break;
+                }
+            }
+        }
+        return Loop::Finish;
+    }
+
+    static bool CanLookup(const AttributePathParams & aPath)
+    {
+        return !aPath.HasWildcardEndpointId() && !aPath.HasWildcardClusterId();
+    }
+
+    size_t Size() const { return mEntries.Allocated(); }
+
+private:
+    static constexpr size_t kNumBuckets = CHIP_IM_SERVER_ATTRIBUTE_INTEREST_INDEX_BUCKETS;
+    static_assert(kNumBuckets > 0 && (kNumBuckets & (kNumBuckets - 1)) == 0,
+                  "CHIP_IM_SERVER_ATTRIBUTE_INTEREST_INDEX_BUCKETS must be a power of two");
+
+    struct Entry
+    {
+        Entry(ReadHandler * apReadHandler, const AttributePathParams * apPath) : mpReadHandler(apReadHandler), mpPath(apPath) {}
+
+        ReadHandler * mpReadHandler;
+        const AttributePathParams * mpPath;
+        Entry * mpNext = nullptr;
+    };
+
+    static size_t BucketFor(EndpointId aEndpointId, ClusterId aClusterId)
+    {
+        uint32_t hash = (static_cast<uint32_t>(aEndpointId) * 0x9E3779B1u) ^ aClusterId;
+        hash ^= hash >> 16;
+        hash *= 0x85EBCA6Bu;
+        hash ^= hash >> 13;
+        return hash & (kNumBuckets - 1);
+    }
+
+    void RemoveFromList(Entry *& aList, ReadHandler * apReadHandler);
+
+    Entry * mBuckets[kNumBuckets];
+    Entry * mWildcardEntries;
+
+    ObjectPool<Entry, CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS_FOR_READS + CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS_FOR_SUBSCRIPTIONS> mEntries;
+};
+
+} // namespace reporting
+} // namespace app
+} // namespace chip
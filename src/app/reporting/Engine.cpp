@@ -34,6 +34,57 @@ using namespace chip::Access;
 namespace chip {
 namespace app {
 namespace reporting {
+namespace {
+
+/**
+ * A small open-addressing table used to merge dirty paths in a single pass over the global dirty set: it maps an
+ * (endpoint, cluster) key to the first path seen with that key.
+ */
+template <typename T, size_t N>
+class DirtyPathsByKey
+{
+public:
+    static uint64_t MakeKey(EndpointId aEndpointId, ClusterId aClusterId)
+    {
+        return (static_cast<uint64_t>(aEndpointId) << 32) | aClusterId;
+    }
+
+    /**
+     * Returns the path previously stored under aKey, or stores apPath and returns nullptr if there is none.
+     */
+    T * FindOrInsert(uint64_t aKey, T * apPath)
+    {
+        size_t slot = static_cast<size_t>((aKey * 0x9E3779B97F4A7C15ull) >> 32) % kNumSlots;
+        for (size_t probes = 0; probes < kNumSlots; probes++, slot = (slot + 1) % kNumSlots)
+        {
+            if (mSlots[slot].mpPath == nullptr)
+            {
+                mSlots[slot] = { aKey, apPath };
+                return nullptr;
+            }
+            if (mSlots[slot].mKey == aKey)
+            {
+                return mSlots[slot].mpPath;
+            }
+        }
+        // Only reachable with more than N paths; leave the extra ones unmerged.
+        return nullptr;
+    }
+
+private:
+    // Twice the capacity of the dirty set keeps probe sequences short.
+    static constexpr size_t kNumSlots = 2 * N;
+
+    struct Slot
+    {
+        uint64_t mKey;
+        T * mpPath;
+    };
+    Slot mSlots[kNumSlots] = {};
+};
+
+} // namespace
+
 CHIP_ERROR Engine::Init()
 {
     mNumReportsInFlight = 0;
@@ -89,6 +140,103 @@ static bool IsOutOfWriterSpaceError(CHIP_ERROR err)
     return err == CHIP_ERROR_NO_MEMORY || err == CHIP_ERROR_BUFFER_TOO_SMALL;
 }
 
+#if CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
+static_assert(CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE <= UINT16_MAX, "Pending attribute reports must fit a packet buffer chain");
+
+CHIP_ERROR Engine::EncodePendingAttributeReports(ReadHandler * apReadHandler, const ConcreteReadAttributePath & aPath,
+                                                 AttributeValueEncoder::AttributeEncodeState & aEncodeState)
+{
+    System::PacketBufferHandle buffer = System::PacketBufferHandle::New(System::PacketBuffer::kMaxSizeWithoutReserve, 0);
+    VerifyOrReturnError(!buffer.IsNull(), CHIP_ERROR_NO_MEMORY);
+
+    System::PacketBufferTLVWriter writer;
+    writer.Init(std::move(buffer), /* useChainedBuffers = */ true, CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE);
+
+    // The reports are written into an anonymous array, the end of which is reserved by the writer, and are copied out of it
+    // one by one into the AttributeReportIBs of the following messages.
+    AttributeReportIBs::Builder attributeReportIBs;
+    ReturnErrorOnFailure(attributeReportIBs.Init(&writer));
+    const uint32_t emptyLength = writer.GetLengthWritten();
+
+    AttributeValueEncoder::AttributeEncodeState encodeState = aEncodeState;
+    CHIP_ERROR err = RetrieveClusterData(apReadHandler->GetSubjectDescriptor(), apReadHandler->IsFabricFiltered(),
+                                         attributeReportIBs, aPath, &encodeState);
+    if (err == CHIP_NO_ERROR)
+    {
+        encodeState = AttributeValueEncoder::AttributeEncodeState();
+    }
+    else if (!encodeState.AllowPartialData() || !IsOutOfWriterSpaceError(err))
+    {
+        return err;
+    }
+    VerifyOrReturnError(writer.GetLengthWritten() > emptyLength, CHIP_ERROR_BUFFER_TOO_SMALL);
+
+    ReturnErrorOnFailure(attributeReportIBs.EndOfAttributeReportIBs());
+    ReturnErrorOnFailure(writer.Finalize(&buffer));
+    apReadHandler->SetPendingAttributeReports(std::move(buffer));
+    aEncodeState = encodeState;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR Engine::CopyPendingAttributeReports(ReadHandler * apReadHandler, AttributeReportIBs::Builder & aAttributeReportIBs)
+{
+    System::PacketBufferHandle reports = apReadHandler->TakePendingAttributeReports();
+    System::TLVPacketBufferBackingStore backingStore(reports.Retain(), /* useChainedBuffers = */ true);
+    TLV::TLVReader reader;
+    TLV::TLVReader reportReader;
+    TLV::TLVType outerType;
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    reader.Init(backingStore);
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_Array, TLV::AnonymousTag()));
+    ReturnErrorOnFailure(reader.EnterContainer(outerType));
+    while ((err = reader.Next()) == CHIP_NO_ERROR)
+    {
+        TLV::TLVWriter backup;
+        aAttributeReportIBs.Checkpoint(backup);
+        // Copying moves the reader past the report, keep it on the report in case the copy does not fit.
+        reportReader.Init(reader);
+        err = aAttributeReportIBs.GetWriter()->CopyElement(reader);
+        if (err != CHIP_NO_ERROR)
+        {
+            aAttributeReportIBs.Rollback(backup);
+            break;
+        }
+    }
+    VerifyOrReturnError(err != CHIP_END_OF_TLV, CHIP_NO_ERROR);
+    // Anything but running out of space means the pending reports are not usable, drop them.
+    VerifyOrReturnError(IsOutOfWriterSpaceError(err), err);
+
+    // Keep the reports that did not fit for the next chunk.
+    ReturnErrorOnFailure(KeepPendingAttributeReports(apReadHandler, reportReader));
+    return err;
+}
+
+CHIP_ERROR Engine::KeepPendingAttributeReports(ReadHandler * apReadHandler, TLV::TLVReader & aReportReader)
+{
+    System::PacketBufferHandle buffer = System::PacketBufferHandle::New(System::PacketBuffer::kMaxSizeWithoutReserve, 0);
+    VerifyOrReturnError(!buffer.IsNull(), CHIP_ERROR_NO_MEMORY);
+
+    System::PacketBufferTLVWriter writer;
+    writer.Init(std::move(buffer), /* useChainedBuffers = */ true, CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE);
+
+    AttributeReportIBs::Builder attributeReportIBs;
+    ReturnErrorOnFailure(attributeReportIBs.Init(&writer));
+
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    do
+    {
+        ReturnErrorOnFailure(writer.CopyElement(aReportReader));
+    } while ((err = aReportReader.Next()) == CHIP_NO_ERROR);
+    VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
+
+    ReturnErrorOnFailure(attributeReportIBs.EndOfAttributeReportIBs());
+    ReturnErrorOnFailure(writer.Finalize(&buffer));
+    apReadHandler->SetPendingAttributeReports(std::move(buffer));
+    return CHIP_NO_ERROR;
+}
+#endif // CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
+
 CHIP_ERROR Engine::BuildSingleReportDataAttributeReportIBs(ReportDataMessage::Builder & aReportDataBuilder,
                                                            ReadHandler * apReadHandler, bool * apHasMoreChunks,
                                                            bool * apHasEncodedData)
@@ -135,6 +283,22 @@ CHIP_ERROR Engine::BuildSingleReportDataAttributeReportIBs(ReportDataMessage::Bu
         uint32_t attributesRead = 0;
 #endif
 
+#if CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
+        // Reports encoded ahead by the previous chunk come first, they belong to the path the iterator is on.
+        if (apReadHandler->HasPendingAttributeReports())
+        {
+            SuccessOrExit(err = CopyPendingAttributeReports(apReadHandler, attributeReportIBs));
+            // If the pending reports completed the attribute, move on to the next path, otherwise continue encoding it.
+            if (!apReadHandler->GetAttributeEncodeState().AllowPartialData())
+            {
+#if CONFIG_BUILD_FOR_HOST_UNIT_TEST
+                attributesRead++;
+#endif
+                apReadHandler->GetAttributePathExpandIterator()->Next();
+            }
+        }
+#endif // CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
+
         // For each path included in the interested path of the read handler...
         for (; apReadHandler->GetAttributePathExpandIterator()->Get(readPath);
              apReadHandler->GetAttributePathExpandIterator()->Next())
@@ -205,6 +369,11 @@ CHIP_ERROR Engine::BuildSingleReportDataAttributeReportIBs(ReportDataMessage::Bu
                     // back any partially-written AttributeReportIB instances, reset its error status).  Since AllowPartialData()
                     // is true, we may not have encoded a complete attribute value, but we did, if we encoded anything, encode a
                     // set of complete AttributeReportIB instances that represent part of the attribute value.
+#if CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
+                    // Encode the rest of the list now, so that the following chunks only need to copy it.  If that does not
+                    // work out, the next chunk encodes the list from encodeState as usual.
+                    static_cast<void>(EncodePendingAttributeReports(apReadHandler, pathForRetrieval, encodeState));
+#endif // CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
                     apReadHandler->SetAttributeEncodeState(encodeState);
                 }
                 else
@@ -729,33 +898,29 @@ bool Engine::ClearTombPaths()
 
 bool Engine::MergeDirtyPathsUnderSameCluster()
 {
-    mGlobalDirtySet.ForEachActiveObject([&](auto * outerPath) {
-        if (outerPath->HasWildcardClusterId() || outerPath->mGeneration == 0)
+    DirtyPathsByKey<AttributePathParamsWithGeneration, CHIP_IM_SERVER_MAX_NUM_DIRTY_SET> pathsByCluster;
+
+    mGlobalDirtySet.ForEachActiveObject([&](auto * path) {
+        if (path->HasWildcardClusterId() || path->mGeneration == 0)
         {
             return Loop::Continue;
         }
-        mGlobalDirtySet.ForEachActiveObject([&](auto * innerPath) {
-            if (innerPath == outerPath)
-            {
-                return Loop::Continue;
-            }
-            // We don't support paths with a wildcard endpoint + a concrete cluster in global dirty set, so we do a simple == check
-            // here.
-            if (innerPath->mEndpointId != outerPath->mEndpointId || innerPath->mClusterId != outerPath->mClusterId)
-            {
-                return Loop::Continue;
-            }
-            if (innerPath->mGeneration > outerPath->mGeneration)
-            {
-                outerPath->mGeneration = innerPath->mGeneration;
-            }
-            outerPath->SetWildcardAttributeId();
-
-            // The object pool does not allow us to release objects in a nested iteration, mark the path as a tomb by setting its
-            // generation to 0 and then clear it later.
-            innerPath->mGeneration = 0;
+        // We don't support paths with a wildcard endpoint + a concrete cluster in global dirty set, so the endpoint id is
+        // used as-is in the key.
+        auto * mergedPath = pathsByCluster.FindOrInsert(pathsByCluster.MakeKey(path->mEndpointId, path->mClusterId), path);
+        if (mergedPath == nullptr)
+        {
             return Loop::Continue;
-        });
+        }
+        if (path->mGeneration > mergedPath->mGeneration)
+        {
+            mergedPath->mGeneration = path->mGeneration;
+        }
+        mergedPath->SetWildcardAttributeId();
+
+        // The object pool does not allow us to release objects during iteration, mark the path as a tomb by setting its
+        // generation to 0 and then clear it later.
+        path->mGeneration = 0;
         return Loop::Continue;
     });
 
@@ -764,32 +929,28 @@ bool Engine::MergeDirtyPathsUnderSameCluster()
 
 bool Engine::MergeDirtyPathsUnderSameEndpoint()
 {
-    mGlobalDirtySet.ForEachActiveObject([&](auto * outerPath) {
-        if (outerPath->HasWildcardEndpointId() || outerPath->mGeneration == 0)
+    DirtyPathsByKey<AttributePathParamsWithGeneration, CHIP_IM_SERVER_MAX_NUM_DIRTY_SET> pathsByEndpoint;
+
+    mGlobalDirtySet.ForEachActiveObject([&](auto * path) {
+        if (path->HasWildcardEndpointId() || path->mGeneration == 0)
         {
             return Loop::Continue;
         }
-        mGlobalDirtySet.ForEachActiveObject([&](auto * innerPath) {
-            if (innerPath == outerPath)
-            {
-                return Loop::Continue;
-            }
-            if (innerPath->mEndpointId != outerPath->mEndpointId)
-            {
-                return Loop::Continue;
-            }
-            if (innerPath->mGeneration > outerPath->mGeneration)
-            {
-                outerPath->mGeneration = innerPath->mGeneration;
-            }
-            outerPath->SetWildcardClusterId();
-            outerPath->SetWildcardAttributeId();
-
-            // The object pool does not allow us to release objects in a nested iteration, mark the path as a tomb by setting its
-            // generation to 0 and then clear it later.
-            innerPath->mGeneration = 0;
+        auto * mergedPath = pathsByEndpoint.FindOrInsert(pathsByEndpoint.MakeKey(path->mEndpointId, kInvalidClusterId), path);
+        if (mergedPath == nullptr)
+        {
             return Loop::Continue;
-        });
+        }
+        if (path->mGeneration > mergedPath->mGeneration)
+        {
+            mergedPath->mGeneration = path->mGeneration;
+        }
+        mergedPath->SetWildcardClusterId();
+        mergedPath->SetWildcardAttributeId();
+
+        // The object pool does not allow us to release objects during iteration, mark the path as a tomb by setting its
+        // generation to 0 and then clear it later.
+        path->mGeneration = 0;
         return Loop::Continue;
     });
     return ClearTombPaths();
@@ -823,31 +984,82 @@ CHIP_ERROR Engine::InsertPathIntoDirtySet(const AttributePathParams & aAttribute
     return CHIP_NO_ERROR;
 }
 
+void Engine::AddInterestPaths(ReadHandler * apReadHandler)
+{
+#if CHIP_IM_SERVER_ATTRIBUTE_INTEREST_INDEX
+    RemoveInterestPaths(apReadHandler);
+
+    CHIP_ERROR err = mInterestIndex.Add(apReadHandler, apReadHandler->GetAttributePathList());
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DataManagement, "Failed to index attribute paths of ReadHandler %p: %" CHIP_ERROR_FORMAT, apReadHandler,
+                     err.Format());
+        mInterestIndex.Remove(apReadHandler);
+        apReadHandler->mFlags.Set(ReadHandler::ReadHandlerFlags::InterestPathsNotIndexed);
+        mNumUnindexedReadHandlers++;
+    }
+#endif // CHIP_IM_SERVER_ATTRIBUTE_INTEREST_INDEX
+}
+
+void Engine::RemoveInterestPaths(ReadHandler * apReadHandler)
+{
+#if CHIP_IM_SERVER_ATTRIBUTE_INTEREST_INDEX
+    if (apReadHandler->mFlags.Has(ReadHandler::ReadHandlerFlags::InterestPathsNotIndexed))
+    {
+        apReadHandler->mFlags.Clear(ReadHandler::ReadHandlerFlags::InterestPathsNotIndexed);
+        mNumUnindexedReadHandlers--;
+        return;
+    }
+    mInterestIndex.Remove(apReadHandler);
+#endif // CHIP_IM_SERVER_ATTRIBUTE_INTEREST_INDEX
+}
+
 CHIP_ERROR Engine::SetDirty(AttributePathParams & aAttributePath)
 {
     BumpDirtySetGeneration();
 
     bool intersectsInterestPath = false;
-    InteractionModelEngine::GetInstance()->mReadHandlers.ForEachActiveObject(
-        [&aAttributePath, &intersectsInterestPath](ReadHandler * handler) {
-            // We call AttributePathIsDirty for both read interactions and subscribe interactions, since we may send inconsistent
-            // attribute data between two chunks. AttributePathIsDirty will not schedule a new run for read handlers which are
-            // waiting for a response to the last message chunk for read interactions.
-            if (handler->CanStartReporting() || handler->IsAwaitingReportResponse())
+    auto markDirty              = [&aAttributePath, &intersectsInterestPath](ReadHandler * handler) {
+        // We call AttributePathIsDirty for both read interactions and subscribe interactions, since we may send inconsistent
+        // attribute data between two chunks. AttributePathIsDirty will not schedule a new run for read handlers which are
+        // waiting for a response to the last message chunk for read interactions.
+        if (handler->CanStartReporting() || handler->IsAwaitingReportResponse())
+        {
+            handler->AttributePathIsDirty(aAttributePath);
+            intersectsInterestPath = true;
+        }
+    };
+
+#if CHIP_IM_SERVER_ATTRIBUTE_INTEREST_INDEX
+    if (mNumUnindexedReadHandlers == 0 && AttributeInterestIndex::CanLookup(aAttributePath))
+    {
+        mInterestIndex.ForEachIntersecting(aAttributePath, [this, &markDirty](ReadHandler * handler) {
+            // A handler with several intersecting paths is visited more than once; AttributePathIsDirty() has already
+            // recorded the current generation in it the first time.
+            if (handler->mDirtyGeneration != GetDirtySetGeneration())
+            {
+                markDirty(handler);
+            }
+            return Loop::Continue;
+        });
+    }
+    else
+#endif // CHIP_IM_SERVER_ATTRIBUTE_INTEREST_INDEX
+    {
+        auto & readHandlers = InteractionModelEngine::GetInstance()->mReadHandlers;
+        readHandlers.ForEachActiveObject([&aAttributePath, &markDirty](ReadHandler * handler) {
+            for (auto object = handler->GetAttributePathList(); object != nullptr; object = object->mpNext)
             {
-                for (auto object = handler->GetAttributePathList(); object != nullptr; object = object->mpNext)
+                if (object->mValue.Intersects(aAttributePath))
                 {
-                    if (object->mValue.Intersects(aAttributePath))
-                    {
-                        handler->AttributePathIsDirty(aAttributePath);
-                        intersectsInterestPath = true;
-                        break;
-                    }
+                    markDirty(handler);
+                    break;
                 }
             }
 
             return Loop::Continue;
         });
+    }
 
     if (!intersectsInterestPath)
     {
@@ -27,6 +27,7 @@
 #include <access/AccessControl.h>
 #include <app/MessageDef/ReportDataMessage.h>
 #include <app/ReadHandler.h>
+#include <app/reporting/AttributeInterestIndex.h>
 #include <app/util/basic-types.h>
 #include <lib/core/CHIPCore.h>
 #include <lib/support/CodeUtils.h>
@@ -89,6 +90,18 @@ public:
      */
     CHIP_ERROR SetDirty(AttributePathParams & aAttributePathParams);
 
+    /**
+     * Add the attribute paths of a read handler to the index SetDirty uses to find interested read handlers.  Must be
+     * called once the handler's attribute path list is complete.
+     */
+    void AddInterestPaths(ReadHandler * apReadHandler);
+
+    /**
+     * Remove the attribute paths of a read handler from the interest index.  Must be called before the handler's
+     * attribute path list is released.
+     */
+    void RemoveInterestPaths(ReadHandler * apReadHandler);
+
     /**
      * @brief
      *  Schedule the event delivery
@@ -166,6 +179,24 @@ private:
                                    AttributeReportIBs::Builder & aAttributeReportIBs,
                                    const ConcreteReadAttributePath & aClusterInfo,
                                    AttributeValueEncoder::AttributeEncodeState * apEncoderState);
+#if CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
+    /**
+     * Continue encoding a list attribute that did not fit in the report message into packet buffers owned by the read handler,
+     * up to CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE bytes.  On success, the read handler holds an anonymous array of the encoded
+     * AttributeReportIBs and aEncodeState is where encoding has to continue after them.  On failure, nothing changes.
+     */
+    CHIP_ERROR EncodePendingAttributeReports(ReadHandler * apReadHandler, const ConcreteReadAttributePath & aPath,
+                                             AttributeValueEncoder::AttributeEncodeState & aEncodeState);
+    /**
+     * Copy as many of the read handler's pending AttributeReportIBs as fit into aAttributeReportIBs.  Returns an out of
+     * space error if some are left.
+     */
+    CHIP_ERROR CopyPendingAttributeReports(ReadHandler * apReadHandler, AttributeReportIBs::Builder & aAttributeReportIBs);
+    /**
+     * Re-encode the pending AttributeReportIBs from the one aReportReader is on into the read handler.
+     */
+    CHIP_ERROR KeepPendingAttributeReports(ReadHandler * apReadHandler, TLV::TLVReader & aReportReader);
+#endif // CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
     CHIP_ERROR CheckAccessDeniedEventPaths(TLV::TLVWriter & aWriter, bool & aHasEncodedData, ReadHandler * apReadHandler);
 
     // If version match, it means don't send, if version mismatch, it means send.
@@ -275,6 +306,13 @@ private:
      */
     uint64_t mDirtyGeneration = 1;
 
+#if CHIP_IM_SERVER_ATTRIBUTE_INTEREST_INDEX
+    AttributeInterestIndex mInterestIndex;
+
+    // Read handlers whose paths could not all be indexed.  While there are any, SetDirty walks every read handler.
+    uint32_t mNumUnindexedReadHandlers = 0;
+#endif
+
 #if CONFIG_BUILD_FOR_HOST_UNIT_TEST
     uint32_t mReservedSize          = 0;
     uint32_t mMaxAttributesPerChunk = UINT32_MAX;
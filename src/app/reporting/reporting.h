@@ -18,6 +18,7 @@
 #pragma once
 
 #include <app/ConcreteAttributePath.h>
+#include <lib/core/CHIPError.h>
 
 /** @brief Reporting Attribute Change
  *
@@ -37,3 +38,12 @@ void MatterReportingAttributeChangeCallback(const chip::app::ConcreteAttributePa
  * Same but only with an EndpointId, this is used when adding / enabling an endpoint during runtime.
  */
 void MatterReportingAttributeChangeCallback(chip::EndpointId endpoint);
+
+/*
+ * Same as MatterReportingAttributeChangeCallback(endpoint, clusterId, attributeId), but can be called from any thread
+ * without holding the Matter stack lock, e.g. by a bridge as soon as it learns that a bridged device changed.  The change
+ * is queued to the Matter thread, and reported from there.  Returns an error, e.g. CHIP_ERROR_NO_MEMORY, if the change
+ * could not be queued, in which case it is not reported.
+ */
+CHIP_ERROR MatterReportingAttributeChangeCallbackFromAnyThread(chip::EndpointId endpoint, chip::ClusterId clusterId,
+                                                               chip::AttributeId attributeId);
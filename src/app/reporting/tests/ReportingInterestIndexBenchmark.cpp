@@ -0,0 +1,166 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      A small benchmark for the lookup Engine::SetDirty() does to find the read handlers
+ *      interested in a dirty attribute, comparing the AttributeInterestIndex against the
+ *      linear walk over every handler's path list it replaces.
+ *
+ *      Each scenario subscribes one handler per endpoint to a few clusters on that endpoint,
+ *      plus a handler with a wildcard-endpoint path, and then marks one attribute on every
+ *      subscribed cluster dirty.  Each run prints one JSON object per scenario on stdout.
+ */
+
+#include <app/reporting/AttributeInterestIndex.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <system/SystemClock.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace chip;
+using namespace chip::app;
+using namespace chip::app::reporting;
+using namespace chip::System;
+
+namespace {
+
+constexpr uint32_t kDefaultIterations = 100;
+constexpr ClusterId kClusters[]       = { 0x0006, 0x0008, 0x0300, 0x0402 };
+
+// Each "handler" is just the path list it would own; the index and the linear scan never dereference the handler.
+struct FakeHandler
+{
+    std::vector<ObjectList<AttributePathParams>> mPaths;
+
+    ReadHandler * AsReadHandler() { return reinterpret_cast<ReadHandler *>(this); }
+};
+
+void Report(const char * method, uint32_t endpoints, size_t paths, uint32_t lookups, size_t matches,
+            Clock::Microseconds64 elapsed)
+{
+    const double seconds = static_cast<double>(elapsed.count()) / 1e6;
+    printf("{\"method\": \"%s\", \"endpoints\": %u, \"paths\": %u, \"lookups\": %u, \"matches\": %u, \"elapsed_us\": %llu, "
+           "\"lookups_per_sec\": %.0f}\n",
+           method, endpoints, static_cast<unsigned>(paths), lookups, static_cast<unsigned>(matches),
+           static_cast<unsigned long long>(elapsed.count()), seconds > 0 ? lookups / seconds : 0.0);
+}
+
+void Run(uint32_t endpoints, uint32_t iterations)
+{
+    std::vector<FakeHandler> handlers(endpoints + 1);
+    size_t numPaths = 0;
+
+    for (uint32_t endpoint = 0; endpoint < endpoints; endpoint++)
+    {
+        auto & paths = handlers[endpoint].mPaths;
+        paths.resize(ArraySize(kClusters));
+        for (size_t i = 0; i < ArraySize(kClusters); i++)
+        {
+            paths[i].mValue = AttributePathParams(static_cast<EndpointId>(endpoint), kClusters[i]);
+            paths[i].mpNext = (i + 1 < paths.size()) ? &paths[i + 1] : nullptr;
+        }
+        numPaths += paths.size();
+    }
+
+    AttributePathParams onOffEverywhere;
+    onOffEverywhere.mClusterId = kClusters[0];
+    handlers[endpoints].mPaths.resize(1);
+    handlers[endpoints].mPaths[0].mValue = onOffEverywhere;
+    numPaths++;
+
+    AttributeInterestIndex index;
+    for (auto & handler : handlers)
+    {
+        VerifyOrDie(index.Add(handler.AsReadHandler(), handler.mPaths.data()) == CHIP_NO_ERROR);
+    }
+
+    const uint32_t lookups = endpoints * static_cast<uint32_t>(ArraySize(kClusters)) * iterations;
+
+    {
+        size_t matches                    = 0;
+        const Clock::Microseconds64 start = SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            for (uint32_t endpoint = 0; endpoint < endpoints; endpoint++)
+            {
+                for (ClusterId cluster : kClusters)
+                {
+                    const AttributePathParams dirty(static_cast<EndpointId>(endpoint), cluster, 0);
+                    for (auto & handler : handlers)
+                    {
+                        for (auto * path = handler.mPaths.data(); path != nullptr; path = path->mpNext)
+                        {
+                            if (path->mValue.Intersects(dirty))
+                            {
+                                matches++;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        Report("linear_scan", endpoints, numPaths, lookups, matches, SystemClock().GetMonotonicMicroseconds64() - start);
+    }
+
+    {
+        size_t matches                    = 0;
+        const Clock::Microseconds64 start = SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            for (uint32_t endpoint = 0; endpoint < endpoints; endpoint++)
+            {
+                for (ClusterId cluster : kClusters)
+                {
+                    const AttributePathParams dirty(static_cast<EndpointId>(endpoint), cluster, 0);
+                    index.ForEachIntersecting(dirty, [&matches](ReadHandler *) {
+                        matches++;
+                        return Loop::Continue;
+                    });
+                }
+            }
+        }
+        Report("interest_index", endpoints, numPaths, lookups, matches, SystemClock().GetMonotonicMicroseconds64() - start);
+    }
+
+    index.Clear();
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    uint32_t iterations = kDefaultIterations;
+    if (argc > 1)
+    {
+        iterations = static_cast<uint32_t>(strtoul(argv[1], nullptr, 10));
+    }
+
+    VerifyOrDie(Platform::MemoryInit() == CHIP_NO_ERROR);
+
+    for (uint32_t endpoints : { 10u, 100u, 1000u })
+    {
+        Run(endpoints, iterations);
+    }
+
+    Platform::MemoryShutdown();
+    return 0;
+}
@@ -21,6 +21,7 @@
 
 #include <app/EventManagement.h>
 #include <app/InteractionModelEngine.h>
+#include <app/PersistentEventLog.h>
 #include <app/server/Dnssd.h>
 #include <app/server/EchoHandler.h>
 #include <app/util/DataModelHandler.h>
@@ -95,6 +96,9 @@ static uint8_t sDebugEventBuffer[CHIP_DEVICE_CONFIG_EVENT_LOGGING_DEBUG_BUFFER_S
 static uint8_t sCritEventBuffer[CHIP_DEVICE_CONFIG_EVENT_LOGGING_CRIT_BUFFER_SIZE];
 static ::chip::PersistedCounter<chip::EventNumber> sGlobalEventIdCounter;
 static ::chip::app::CircularEventBuffer sLoggingBuffer[CHIP_NUM_EVENT_LOGGING_BUFFERS];
+#if CHIP_CONFIG_ENABLE_PERSISTENT_EVENT_LOG
+static ::chip::app::PersistentEventLog sPersistentEventLog;
+#endif // CHIP_CONFIG_ENABLE_PERSISTENT_EVENT_LOG
 #endif // CHIP_CONFIG_ENABLE_SERVER_IM_EVENT
 
 CHIP_ERROR Server::Init(const ServerInitParams & initParams)
@@ -253,6 +257,20 @@ CHIP_ERROR Server::Init(const ServerInitParams & initParams)
                                                        &logStorageResources[0], &sGlobalEventIdCounter,
                                                        std::chrono::duration_cast<System::Clock::Milliseconds64>(mInitTimestamp));
     }
+
+#if CHIP_CONFIG_ENABLE_PERSISTENT_EVENT_LOG
+    // Events are still logged to the buffers if the persistent log cannot be used.
+    err = sPersistentEventLog.Init(mDeviceStorage, &DeviceLayer::SystemLayer());
+    if (err == CHIP_NO_ERROR)
+    {
+        chip::app::EventManagement::GetInstance().SetPersistentEventLog(&sPersistentEventLog);
+    }
+    else
+    {
+        ChipLogError(AppServer, "Failed to initialize the persistent event log: %" CHIP_ERROR_FORMAT, err.Format());
+        err = CHIP_NO_ERROR;
+    }
+#endif // CHIP_CONFIG_ENABLE_PERSISTENT_EVENT_LOG
 #endif // CHIP_CONFIG_ENABLE_SERVER_IM_EVENT
 
     // This initializes clusters, so should come after lower level initialization.
@@ -546,6 +564,10 @@ void Server::Shutdown()
 
     chip::Dnssd::Resolver::Instance().Shutdown();
     chip::app::InteractionModelEngine::GetInstance()->Shutdown();
+#if CHIP_CONFIG_ENABLE_SERVER_IM_EVENT && CHIP_CONFIG_ENABLE_PERSISTENT_EVENT_LOG
+    chip::app::EventManagement::GetInstance().SetPersistentEventLog(nullptr);
+    sPersistentEventLog.Shutdown();
+#endif // CHIP_CONFIG_ENABLE_SERVER_IM_EVENT && CHIP_CONFIG_ENABLE_PERSISTENT_EVENT_LOG
     mCommissioningWindowManager.Shutdown();
     mMessageCounterManager.Shutdown();
     mExchangeMgr.Shutdown();
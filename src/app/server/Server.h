@@ -261,9 +261,14 @@ struct CommonCaseDeviceServerInitParams : public ServerInitParams
         this->aclStorage = &sAclStorage;
 
 #if CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
-        ChipLogProgress(AppServer, "Initializing subscription resumption storage...");
-        ReturnErrorOnFailure(sSubscriptionResumptionStorage.Init(this->persistentStorageDelegate));
-        this->subscriptionResumptionStorage = &sSubscriptionResumptionStorage;
+        // Subscription resumption storage can be injected, e.g. an IndexedSubscriptionResumptionStorage, but defaults to
+        // SimpleSubscriptionResumptionStorage.
+        if (this->subscriptionResumptionStorage == nullptr)
+        {
+            ChipLogProgress(AppServer, "Initializing subscription resumption storage...");
+            ReturnErrorOnFailure(sSubscriptionResumptionStorage.Init(this->persistentStorageDelegate));
+            this->subscriptionResumptionStorage = &sSubscriptionResumptionStorage;
+        }
 #else
         ChipLogProgress(AppServer, "Subscription persistence not supported");
 #endif
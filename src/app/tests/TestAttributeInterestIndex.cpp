@@ -0,0 +1,186 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for the reporting AttributeInterestIndex
+ *
+ */
+
+#include <app/reporting/AttributeInterestIndex.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <nlunit-test.h>
+
+namespace chip {
+namespace app {
+namespace TestAttributeInterestIndex {
+
+using reporting::AttributeInterestIndex;
+
+// The index never dereferences the handlers, so any distinct addresses will do.
+ReadHandler * const kHandlerA = reinterpret_cast<ReadHandler *>(0x10);
+ReadHandler * const kHandlerB = reinterpret_cast<ReadHandler *>(0x20);
+
+struct Visited
+{
+    size_t mA = 0;
+    size_t mB = 0;
+};
+
+Visited Lookup(const AttributeInterestIndex & aIndex, EndpointId aEndpoint, ClusterId aCluster, AttributeId aAttribute)
+{
+    Visited visited;
+    aIndex.ForEachIntersecting(AttributePathParams(aEndpoint, aCluster, aAttribute), [&visited](ReadHandler * handler) {
+        (handler == kHandlerA ? visited.mA : visited.mB)++;
+        return Loop::Continue;
+    });
+    return visited;
+}
+
+void TestConcretePaths(nlTestSuite * apSuite, void * apContext)
+{
+    AttributeInterestIndex index;
+    constexpr EndpointId kEndpoint1           = 1;
+    constexpr EndpointId kEndpoint2           = 2;
+    ObjectList<AttributePathParams> pathsA[2] = { { AttributePathParams(kEndpoint1, 6, 0) },
+                                                  { AttributePathParams(kEndpoint2, 8) } };
+    ObjectList<AttributePathParams> pathsB[1] = { { AttributePathParams(kEndpoint1, 6) } };
+    pathsA[0].mpNext                          = &pathsA[1];
+
+    NL_TEST_ASSERT(apSuite, index.Add(kHandlerA, pathsA) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Add(kHandlerB, pathsB) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Size() == 3);
+
+    Visited visited = Lookup(index, 1, 6, 0);
+    NL_TEST_ASSERT(apSuite, visited.mA == 1 && visited.mB == 1);
+
+    visited = Lookup(index, 1, 6, 1);
+    NL_TEST_ASSERT(apSuite, visited.mA == 0 && visited.mB == 1);
+
+    visited = Lookup(index, 2, 8, 5);
+    NL_TEST_ASSERT(apSuite, visited.mA == 1 && visited.mB == 0);
+
+    visited = Lookup(index, 2, 6, 0);
+    NL_TEST_ASSERT(apSuite, visited.mA == 0 && visited.mB == 0);
+
+    index.Remove(kHandlerA);
+    NL_TEST_ASSERT(apSuite, index.Size() == 1);
+    visited = Lookup(index, 1, 6, 0);
+    NL_TEST_ASSERT(apSuite, visited.mA == 0 && visited.mB == 1);
+    visited = Lookup(index, 2, 8, 5);
+    NL_TEST_ASSERT(apSuite, visited.mA == 0 && visited.mB == 0);
+
+    index.Remove(kHandlerB);
+    NL_TEST_ASSERT(apSuite, index.Size() == 0);
+}
+
+void TestWildcardPaths(nlTestSuite * apSuite, void * apContext)
+{
+    AttributeInterestIndex index;
+    AttributePathParams anyEndpoint(ClusterId(6), kInvalidAttributeId);
+    ObjectList<AttributePathParams> pathsA[1] = { { anyEndpoint } };
+    ObjectList<AttributePathParams> pathsB[1] = { { AttributePathParams() } };
+
+    NL_TEST_ASSERT(apSuite, !AttributeInterestIndex::CanLookup(anyEndpoint));
+    NL_TEST_ASSERT(apSuite, AttributeInterestIndex::CanLookup(AttributePathParams(EndpointId(1), 6)));
+
+    NL_TEST_ASSERT(apSuite, index.Add(kHandlerA, pathsA) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Add(kHandlerB, pathsB) == CHIP_NO_ERROR);
+
+    Visited visited = Lookup(index, 3, 6, 0);
+    NL_TEST_ASSERT(apSuite, visited.mA == 1 && visited.mB == 1);
+
+    visited = Lookup(index, 3, 8, 0);
+    NL_TEST_ASSERT(apSuite, visited.mA == 0 && visited.mB == 1);
+
+    index.Clear();
+    NL_TEST_ASSERT(apSuite, index.Size() == 0);
+    visited = Lookup(index, 3, 6, 0);
+    NL_TEST_ASSERT(apSuite, visited.mA == 0 && visited.mB == 0);
+}
+
+void TestManyEndpoints(nlTestSuite * apSuite, void * apContext)
+{
+    // Enough (endpoint, cluster) pairs that lookups have to skip over other pairs hashed to the same bucket.
+    constexpr EndpointId kNumEndpoints = 40;
+    AttributeInterestIndex index;
+    ObjectList<AttributePathParams> paths[kNumEndpoints * 2];
+
+    for (EndpointId endpoint = 0; endpoint < kNumEndpoints; endpoint++)
+    {
+        paths[2 * endpoint].mValue     = AttributePathParams(endpoint, 6);
+        paths[2 * endpoint + 1].mValue = AttributePathParams(endpoint, 8);
+        paths[2 * endpoint].mpNext     = &paths[2 * endpoint + 1];
+        paths[2 * endpoint + 1].mpNext = nullptr;
+        ReadHandler * const handler    = (endpoint % 2 == 0) ? kHandlerA : kHandlerB;
+        NL_TEST_ASSERT(apSuite, index.Add(handler, &paths[2 * endpoint]) == CHIP_NO_ERROR);
+    }
+
+    for (EndpointId endpoint = 0; endpoint < kNumEndpoints; endpoint++)
+    {
+        for (ClusterId cluster : { 6u, 8u })
+        {
+            Visited visited = Lookup(index, endpoint, cluster, 0);
+            NL_TEST_ASSERT(apSuite, visited.mA + visited.mB == 1);
+            NL_TEST_ASSERT(apSuite, (endpoint % 2 == 0) ? visited.mA == 1 : visited.mB == 1);
+        }
+        Visited visited = Lookup(index, endpoint, 0x28, 0);
+        NL_TEST_ASSERT(apSuite, visited.mA == 0 && visited.mB == 0);
+    }
+
+    index.Remove(kHandlerA);
+    index.Remove(kHandlerB);
+    NL_TEST_ASSERT(apSuite, index.Size() == 0);
+}
+
+} // namespace TestAttributeInterestIndex
+} // namespace app
+} // namespace chip
+
+namespace {
+const nlTest sTests[] = { NL_TEST_DEF("TestConcretePaths", chip::app::TestAttributeInterestIndex::TestConcretePaths),
+                          NL_TEST_DEF("TestWildcardPaths", chip::app::TestAttributeInterestIndex::TestWildcardPaths),
+                          NL_TEST_DEF("TestManyEndpoints", chip::app::TestAttributeInterestIndex::TestManyEndpoints),
+                          NL_TEST_SENTINEL() };
+
+int Test_Setup(void * inContext)
+{
+    CHIP_ERROR error = chip::Platform::MemoryInit();
+    VerifyOrReturnError(error == CHIP_NO_ERROR, FAILURE);
+    return SUCCESS;
+}
+
+int Test_Teardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+} // namespace
+
+int TestAttributeInterestIndex()
+{
+    nlTestSuite theSuite = { "AttributeInterestIndex", &sTests[0], Test_Setup, Test_Teardown };
+
+    nlTestRunner(&theSuite, nullptr);
+
+    return (nlTestRunnerStats(&theSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestAttributeInterestIndex)
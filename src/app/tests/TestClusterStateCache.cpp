@@ -538,11 +538,11 @@ CacheValidator::CacheValidator(AttributeInstructionListType & instructionList,
     }
 }
 
-void RunAndValidateSequence(AttributeInstructionListType list)
+void RunAndValidateSequence(ClusterStateCache::AttributeStorage storage, AttributeInstructionListType list)
 {
     ForwardedDataCallbackValidator dataCallbackValidator;
     CacheValidator client(list, dataCallbackValidator);
-    ClusterStateCache cache(client);
+    ClusterStateCache cache(client, Optional<EventNumber>::Missing(), true /* cacheData */, storage);
 
     // In order for the cache to track our data versions, we need to claim to it
     // that we are dealing with a wildcard path.  And we need to do that before
@@ -625,7 +625,7 @@ void RunAndValidateSequence(AttributeInstructionListType list)
  * E1:A1 --- Endpoint 1, Attribute A, Version 1
  *
  */
-void TestCache(nlTestSuite * apSuite, void * apContext)
+void ValidateSequences(ClusterStateCache::AttributeStorage storage)
 {
     ChipLogProgress(DataManagement, "Validating various sequences of attribute data IBs...");
 
@@ -633,61 +633,200 @@ void TestCache(nlTestSuite * apSuite, void * apContext)
     // Validate a range of types and ensure that they can be successfully decoded.
     //
     ChipLogProgress(DataManagement, "E1:A1 --> E1:A1");
-    RunAndValidateSequence({ AttributeInstruction(
+    RunAndValidateSequence(storage, { AttributeInstruction(
 
         AttributeInstruction::kAttributeA, 1, AttributeInstruction::kData) });
 
     ChipLogProgress(DataManagement, "E1:B1 --> E1:B1");
-    RunAndValidateSequence({ AttributeInstruction(
+    RunAndValidateSequence(storage, { AttributeInstruction(
 
         AttributeInstruction::kAttributeB, 1, AttributeInstruction::kData) });
 
     ChipLogProgress(DataManagement, "E1:C1 --> E1:C1");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeC, 1, AttributeInstruction::kData) });
+    RunAndValidateSequence(storage, { AttributeInstruction(AttributeInstruction::kAttributeC, 1, AttributeInstruction::kData) });
 
     ChipLogProgress(DataManagement, "E1:D1 --> E1:D1");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
+    RunAndValidateSequence(storage, { AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
 
     //
     // Validate that a newer version of a data item over-rides the
     // previous copy.
     //
     ChipLogProgress(DataManagement, "E1:D1 E1:D2 --> E1:D2");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData),
-                             AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
+    RunAndValidateSequence(storage, { AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData),
+                                      AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
 
     //
     // Validate that a newer StatusIB over-rides a previous data value.
     //
     ChipLogProgress(DataManagement, "E1:D1 E1:D2s --> E1:D2s");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData),
-                             AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kStatus) });
+    RunAndValidateSequence(storage, { AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData),
+                                      AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kStatus) });
 
     //
     // Validate that a newer data value over-rides a previous status value.
     //
     ChipLogProgress(DataManagement, "E1:D1s E1:D2 --> E1:D2");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kStatus),
-                             AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
+    RunAndValidateSequence(storage, { AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kStatus),
+                                      AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
 
     //
     // Validate data across different endpoints.
     //
     ChipLogProgress(DataManagement, "E0:D1 E1:D2 --> E0:D1 E1:D2");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeD, 0, AttributeInstruction::kData),
-                             AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
+    RunAndValidateSequence(storage, { AttributeInstruction(AttributeInstruction::kAttributeD, 0, AttributeInstruction::kData),
+                                      AttributeInstruction(AttributeInstruction::kAttributeD, 1, AttributeInstruction::kData) });
 
     ChipLogProgress(DataManagement, "E0:A1 E0:B2 E0:A3 E0:B4 --> E0:A3 E0:B4");
-    RunAndValidateSequence({ AttributeInstruction(AttributeInstruction::kAttributeA, 0, AttributeInstruction::kData),
-                             AttributeInstruction(AttributeInstruction::kAttributeB, 0, AttributeInstruction::kData),
-                             AttributeInstruction(AttributeInstruction::kAttributeA, 0, AttributeInstruction::kData),
-                             AttributeInstruction(AttributeInstruction::kAttributeB, 0, AttributeInstruction::kData) });
+    RunAndValidateSequence(storage, { AttributeInstruction(AttributeInstruction::kAttributeA, 0, AttributeInstruction::kData),
+                                      AttributeInstruction(AttributeInstruction::kAttributeB, 0, AttributeInstruction::kData),
+                                      AttributeInstruction(AttributeInstruction::kAttributeA, 0, AttributeInstruction::kData),
+                                      AttributeInstruction(AttributeInstruction::kAttributeB, 0, AttributeInstruction::kData) });
+}
+
+void TestCache(nlTestSuite * apSuite, void * apContext)
+{
+    ValidateSequences(ClusterStateCache::AttributeStorage::kMap);
+}
+
+void TestCacheFlatStorage(nlTestSuite * apSuite, void * apContext)
+{
+    ValidateSequences(ClusterStateCache::AttributeStorage::kFlat);
+}
+
+class NullCallback : public ClusterStateCache::Callback
+{
+    void OnDone(ReadClient *) override {}
+};
+
+/*
+ * This validates that attribute values stay correct in the flat store while they are updated over many reports,
+ * with values of changing sizes, and values that are never updated spread over many blocks, which makes the store
+ * repack them.
+ */
+void TestFlatStorageUpdates(nlTestSuite * apSuite, void * apContext)
+{
+    constexpr EndpointId kNumEndpoints     = 16;
+    constexpr uint8_t kNumReports          = 64;
+    constexpr uint8_t kNumPinnedReports    = 32;
+    constexpr AttributeId kPinnedAttribute = 0x1000;
+    constexpr size_t kPinnedLength         = 64;
+
+    NullCallback callback;
+    ClusterStateCache cache(callback, Optional<EventNumber>::Missing(), true /* cacheData */,
+                            ClusterStateCache::AttributeStorage::kFlat);
+    ReadClient::Callback & readCallback = cache.GetBufferedCallback();
+
+    uint8_t octets[kNumReports + kNumEndpoints];
+    memset(octets, 'x', sizeof(octets));
+
+    for (uint8_t report = 0; report < kNumReports; report++)
+    {
+        readCallback.OnReportBegin();
+        for (EndpointId endpoint = 0; endpoint < kNumEndpoints; endpoint++)
+        {
+            uint8_t buf[128];
+            TLV::TLVWriter writer;
+            TLV::TLVReader reader;
+            ConcreteDataAttributePath path(endpoint, Clusters::UnitTesting::Id, Clusters::UnitTesting::Attributes::Int16u::Id);
+            path.mDataVersion.SetValue(report);
+
+            writer.Init(buf);
+            NL_TEST_ASSERT(apSuite, DataModel::Encode(writer, TLV::AnonymousTag(), static_cast<uint16_t>(report + endpoint)) ==
+                               CHIP_NO_ERROR);
+            reader.Init(buf, writer.GetLengthWritten());
+            NL_TEST_ASSERT(apSuite, reader.Next() == CHIP_NO_ERROR);
+            readCallback.OnAttributeData(path, &reader, StatusIB());
+
+            // Only some of the endpoints get a new octet string, of a different length every time.
+            if ((report + endpoint) % 3 == 0)
+            {
+                path.mAttributeId = Clusters::UnitTesting::Attributes::OctetString::Id;
+                writer.Init(buf);
+                NL_TEST_ASSERT(apSuite,
+                               DataModel::Encode(writer, TLV::AnonymousTag(), ByteSpan(octets, (report + endpoint) % 100)) ==
+                                   CHIP_NO_ERROR);
+                reader.Init(buf, writer.GetLengthWritten());
+                NL_TEST_ASSERT(apSuite, reader.Next() == CHIP_NO_ERROR);
+                readCallback.OnAttributeData(path, &reader, StatusIB());
+            }
+        }
+
+        // Early reports also add a value that is never updated again, on endpoint 0.
+        if (report < kNumPinnedReports)
+        {
+            uint8_t buf[128];
+            uint8_t pinned[kPinnedLength];
+            TLV::TLVWriter writer;
+            TLV::TLVReader reader;
+            ConcreteDataAttributePath path(0, Clusters::UnitTesting::Id, kPinnedAttribute + report);
+            path.mDataVersion.SetValue(report);
+
+            memset(pinned, report, sizeof(pinned));
+            writer.Init(buf);
+            NL_TEST_ASSERT(apSuite, DataModel::Encode(writer, TLV::AnonymousTag(), ByteSpan(pinned)) == CHIP_NO_ERROR);
+            reader.Init(buf, writer.GetLengthWritten());
+            NL_TEST_ASSERT(apSuite, reader.Next() == CHIP_NO_ERROR);
+            readCallback.OnAttributeData(path, &reader, StatusIB());
+        }
+        readCallback.OnReportEnd();
+
+        for (uint8_t pinnedReport = 0; pinnedReport < kNumPinnedReports && pinnedReport <= report; pinnedReport++)
+        {
+            const ConcreteAttributePath path(0, Clusters::UnitTesting::Id, kPinnedAttribute + pinnedReport);
+            TLV::TLVReader reader;
+            ByteSpan pinned;
+            NL_TEST_ASSERT(apSuite, cache.Get(path, reader) == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(apSuite, reader.Get(pinned) == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(apSuite, pinned.size() == kPinnedLength);
+            NL_TEST_ASSERT(apSuite, pinned.data()[0] == pinnedReport && pinned.data()[kPinnedLength - 1] == pinnedReport);
+        }
+
+        for (EndpointId endpoint = 0; endpoint < kNumEndpoints; endpoint++)
+        {
+            uint16_t int16u = 0;
+            NL_TEST_ASSERT(apSuite,
+                           cache.Get<Clusters::UnitTesting::Attributes::Int16u::TypeInfo>(endpoint, int16u) == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(apSuite, int16u == report + endpoint);
+
+            ByteSpan octetString;
+            CHIP_ERROR err = cache.Get<Clusters::UnitTesting::Attributes::OctetString::TypeInfo>(endpoint, octetString);
+            if (report >= (3 - endpoint % 3) % 3)
+            {
+                // The value was last set in the report where (report + endpoint) was last a multiple of 3.
+                const size_t lastSet = (report + endpoint) - (report + endpoint) % 3;
+                NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+                NL_TEST_ASSERT(apSuite, octetString.size() == lastSet % 100);
+            }
+        }
+    }
+
+    size_t numClusters = 0;
+    NL_TEST_ASSERT(apSuite, cache.ForEachCluster(kNumEndpoints - 1, [&numClusters](ClusterId clusterId) {
+        numClusters++;
+        return clusterId == Clusters::UnitTesting::Id ? CHIP_NO_ERROR : CHIP_ERROR_INTERNAL;
+    }) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, numClusters == 1);
+
+    size_t numAttributes = 0;
+    NL_TEST_ASSERT(apSuite, cache.ForEachAttribute(Clusters::UnitTesting::Id, [&numAttributes](const ConcreteAttributePath & path) {
+        numAttributes++;
+        return CHIP_NO_ERROR;
+    }) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, numAttributes == 2 * kNumEndpoints + kNumPinnedReports);
+
+    NL_TEST_ASSERT(apSuite,
+                   cache.ForEachAttribute(kNumEndpoints, Clusters::UnitTesting::Id, [](const ConcreteAttributePath & path) {
+                       return CHIP_NO_ERROR;
+                   }) == CHIP_ERROR_KEY_NOT_FOUND);
 }
 
 // clang-format off
 const nlTest sTests[] =
 {
     NL_TEST_DEF("TestCache", TestCache),
+    NL_TEST_DEF("TestCacheFlatStorage", TestCacheFlatStorage),
+    NL_TEST_DEF("TestFlatStorageUpdates", TestFlatStorageUpdates),
     NL_TEST_SENTINEL()
 };
 
@@ -0,0 +1,121 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/util/EndpointIndex.h>
+#include <lib/support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+using namespace chip;
+using namespace chip::app;
+
+namespace {
+
+using TestIndex = EndpointIndex<8>;
+
+void TestFind(nlTestSuite * apSuite, void * apContext)
+{
+    TestIndex index;
+    NL_TEST_ASSERT(apSuite, index.Find(1) == TestIndex::kInvalidIndex);
+
+    // Out of order, as dynamic endpoints are added.
+    NL_TEST_ASSERT(apSuite, index.Insert(0, 0) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Insert(13, 1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Insert(2, 3) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Insert(7, 2) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Count() == 4);
+
+    NL_TEST_ASSERT(apSuite, index.Find(0) == 0);
+    NL_TEST_ASSERT(apSuite, index.Find(13) == 1);
+    NL_TEST_ASSERT(apSuite, index.Find(7) == 2);
+    NL_TEST_ASSERT(apSuite, index.Find(2) == 3);
+    NL_TEST_ASSERT(apSuite, index.Find(1) == TestIndex::kInvalidIndex);
+    NL_TEST_ASSERT(apSuite, index.Find(14) == TestIndex::kInvalidIndex);
+
+    index.Remove(13, 1);
+    NL_TEST_ASSERT(apSuite, index.Find(13) == TestIndex::kInvalidIndex);
+    NL_TEST_ASSERT(apSuite, index.Find(7) == 2);
+    NL_TEST_ASSERT(apSuite, index.Count() == 3);
+
+    // Removing an endpoint at an index it is not at does nothing.
+    index.Remove(7, 3);
+    NL_TEST_ASSERT(apSuite, index.Find(7) == 2);
+
+    index.Clear();
+    NL_TEST_ASSERT(apSuite, index.Count() == 0);
+    NL_TEST_ASSERT(apSuite, index.Find(0) == TestIndex::kInvalidIndex);
+}
+
+void TestDuplicates(nlTestSuite * apSuite, void * apContext)
+{
+    TestIndex index;
+    NL_TEST_ASSERT(apSuite, index.Insert(5, 6) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Insert(5, 1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Insert(5, 4) == CHIP_NO_ERROR);
+
+    // Lowest index first, then the lowest one accepted.
+    NL_TEST_ASSERT(apSuite, index.Find(5) == 1);
+    NL_TEST_ASSERT(apSuite, index.Find(5, [](uint16_t i) { return i > 1; }) == 4);
+    NL_TEST_ASSERT(apSuite, index.Find(5, [](uint16_t i) { return i > 6; }) == TestIndex::kInvalidIndex);
+
+    index.Remove(5, 1);
+    NL_TEST_ASSERT(apSuite, index.Find(5) == 4);
+}
+
+void TestCapacity(nlTestSuite * apSuite, void * apContext)
+{
+    EndpointIndex<2> index;
+    NL_TEST_ASSERT(apSuite, index.Insert(1, 0) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Insert(2, 1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Insert(3, 2) == CHIP_ERROR_NO_MEMORY);
+    NL_TEST_ASSERT(apSuite, index.Find(3) == TestIndex::kInvalidIndex);
+
+    index.Remove(1, 0);
+    NL_TEST_ASSERT(apSuite, index.Insert(3, 2) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, index.Find(3) == 2);
+}
+
+// clang-format off
+const nlTest sTests[] =
+{
+    NL_TEST_DEF("TestFind", TestFind),
+    NL_TEST_DEF("TestDuplicates", TestDuplicates),
+    NL_TEST_DEF("TestCapacity", TestCapacity),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+} // namespace
+
+int TestEndpointIndex()
+{
+    // clang-format off
+    nlTestSuite theSuite =
+    {
+        "EndpointIndex",
+        &sTests[0],
+        nullptr,
+        nullptr
+    };
+    // clang-format on
+
+    nlTestRunner(&theSuite, nullptr);
+
+    return (nlTestRunnerStats(&theSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestEndpointIndex)
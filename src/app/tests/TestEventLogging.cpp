@@ -27,6 +27,7 @@
 #include <app/EventLoggingTypes.h>
 #include <app/EventManagement.h>
 #include <app/InteractionModelEngine.h>
+#include <app/MessageDef/EventReportIB.h>
 #include <app/ObjectList.h>
 #include <app/tests/AppTestContext.h>
 #include <lib/core/CHIPCore.h>
@@ -53,6 +54,8 @@ static const chip::ClusterId kLivenessClusterId   = 0x00000022;
 static const uint32_t kLivenessChangeEvent        = 1;
 static const chip::EndpointId kTestEndpointId1    = 2;
 static const chip::EndpointId kTestEndpointId2    = 3;
+static const chip::EndpointId kTestEndpointId3    = 4;
+static const chip::EndpointId kTestEndpointId4    = 5;
 static const chip::TLV::Tag kLivenessDeviceStatus = chip::TLV::ContextTag(1);
 
 static uint8_t gDebugEventBuffer[120];
@@ -317,9 +320,192 @@ static void CheckLogEventWithDiscardLowEvent(nlTestSuite * apSuite, void * apCon
     CheckLogState(apSuite, logMgmt, 3, chip::app::PriorityLevel::Debug);
 }
 
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+static void WriteIndexedElement(nlTestSuite * apSuite, chip::app::CircularEventBuffer & aBuffer, chip::EventNumber aEventNumber)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    chip::TLV::CircularTLVWriter writer;
+    chip::app::CircularEventBuffer::IndexEntry entry;
+
+    // A value this large is encoded on 8 bytes, making each element 9 bytes long.
+    writer.Init(aBuffer);
+    err = writer.Put(chip::TLV::AnonymousTag(), static_cast<uint64_t>(0x0100000000000000ULL + aEventNumber));
+    NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+    err = writer.Finalize();
+    NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, writer.GetLengthWritten() == 9);
+
+    entry.mEventNumber = aEventNumber;
+    entry.mEndpointId  = kTestEndpointId1;
+    entry.mClusterId   = kLivenessClusterId;
+    entry.mEventId     = kLivenessChangeEvent;
+    entry.mLength      = static_cast<uint16_t>(writer.GetLengthWritten());
+    aBuffer.AppendIndexEntry(entry);
+}
+
+static void CheckEventIndex(nlTestSuite * apSuite, void * apContext)
+{
+    constexpr size_t kElementCount = CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE + 2;
+    uint8_t storage[kElementCount * 9];
+    chip::app::CircularEventBuffer buffer;
+    chip::EventNumber eventNumber = 0;
+
+    buffer.Init(storage, sizeof(storage), nullptr, nullptr, chip::app::PriorityLevel::Critical);
+    NL_TEST_ASSERT(apSuite, buffer.SyncIndex() == 0);
+    NL_TEST_ASSERT(apSuite, buffer.GetIndexEntryCount() == 0);
+
+    // Fill the buffer: the entries of the two oldest elements are dropped from the full index.
+    for (; eventNumber < kElementCount; eventNumber++)
+    {
+        WriteIndexedElement(apSuite, buffer, eventNumber);
+    }
+    NL_TEST_ASSERT(apSuite, buffer.SyncIndex() == 2 * 9);
+    NL_TEST_ASSERT(apSuite, buffer.GetIndexEntryCount() == CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE);
+    NL_TEST_ASSERT(apSuite, buffer.GetIndexEntry(0).mEventNumber == 2);
+
+    // Make room for each new element by evicting the oldest one, like EventManagement does: the unindexed elements go first.
+    for (size_t i = 0; i < 3; i++, eventNumber++)
+    {
+        NL_TEST_ASSERT(apSuite, buffer.EvictHead() == CHIP_NO_ERROR);
+        WriteIndexedElement(apSuite, buffer, eventNumber);
+    }
+    NL_TEST_ASSERT(apSuite, buffer.DataLength() == sizeof(storage));
+    NL_TEST_ASSERT(apSuite, buffer.SyncIndex() == 2 * 9);
+    NL_TEST_ASSERT(apSuite, buffer.GetIndexEntryCount() == CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE);
+    NL_TEST_ASSERT(apSuite, buffer.GetIndexEntry(0).mEventNumber == 5);
+    NL_TEST_ASSERT(apSuite, buffer.GetIndexEntry(CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE - 1).mEventNumber == eventNumber - 1);
+    NL_TEST_ASSERT(apSuite, buffer.GetIndexEntry(0).mLength == 9);
+}
+
+// Fetch the events of aEndpointId since aEventMin into a buffer of aBufferSize bytes, calling FetchEventsSince again each
+// time the buffer is full, and return the number of events read into aEventNumbers.
+static size_t FetchEventNumbers(nlTestSuite * apSuite, chip::EndpointId aEndpointId, chip::EventNumber & aEventMin,
+                                size_t aBufferSize, chip::EventNumber * aEventNumbers, size_t aMaxEvents)
+{
+    chip::app::EventManagement & logMgmt = chip::app::EventManagement::GetInstance();
+    chip::app::ObjectList<chip::app::EventPathParams> path;
+    uint8_t backingStore[1024];
+    size_t numEvents = 0;
+    CHIP_ERROR err   = CHIP_NO_ERROR;
+
+    path.mValue.mEndpointId = aEndpointId;
+    path.mValue.mClusterId  = kLivenessClusterId;
+
+    do
+    {
+        chip::TLV::TLVWriter writer;
+        chip::TLV::TLVReader reader;
+        size_t eventCount = 0;
+
+        writer.Init(backingStore, aBufferSize);
+        err = logMgmt.FetchEventsSince(writer, &path, aEventMin, eventCount, chip::Access::SubjectDescriptor{});
+        NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR || err == CHIP_ERROR_BUFFER_TOO_SMALL);
+        // A buffer too small for even one event would never make progress.
+        NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR || eventCount > 0);
+        if (err != CHIP_NO_ERROR && eventCount == 0)
+        {
+            break;
+        }
+
+        reader.Init(backingStore, writer.GetLengthWritten());
+        while (reader.Next() == CHIP_NO_ERROR)
+        {
+            chip::app::EventReportIB::Parser report;
+            chip::app::EventDataIB::Parser data;
+            chip::app::EventPathIB::Parser eventPath;
+            chip::EventNumber eventNumber = 0;
+            chip::EndpointId endpointId   = chip::kInvalidEndpointId;
+
+            NL_TEST_ASSERT(apSuite, report.Init(reader) == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(apSuite, report.GetEventData(&data) == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(apSuite, data.GetEventNumber(&eventNumber) == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(apSuite, data.GetPath(&eventPath) == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(apSuite, eventPath.GetEndpoint(&endpointId) == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(apSuite, endpointId == aEndpointId);
+            if (numEvents < aMaxEvents)
+            {
+                aEventNumbers[numEvents] = eventNumber;
+            }
+            numEvents++;
+        }
+        NL_TEST_ASSERT(apSuite, eventCount <= numEvents);
+    } while (err == CHIP_ERROR_BUFFER_TOO_SMALL);
+
+    return numEvents;
+}
+
+static void CheckFetchEventsWithIndex(nlTestSuite * apSuite, void * apContext)
+{
+    chip::app::EventManagement & logMgmt = chip::app::EventManagement::GetInstance();
+    chip::app::EventOptions options;
+    TestEventGenerator testEventGenerator;
+    chip::EventNumber eid[6];
+    chip::EventNumber fetched[6];
+    chip::EventNumber eventMin;
+
+    // Alternate the endpoints of six Info events: the debug buffer keeps the last three, and the first three are evicted to
+    // the info buffer along with their index entries.
+    options.mPriority = chip::app::PriorityLevel::Info;
+    for (size_t i = 0; i < 6; i++)
+    {
+        options.mPath = { (i % 2 == 0) ? kTestEndpointId3 : kTestEndpointId4, kLivenessClusterId, kLivenessChangeEvent };
+        testEventGenerator.SetStatus(static_cast<int32_t>(i % 2));
+        NL_TEST_ASSERT(apSuite, logMgmt.LogEvent(&testEventGenerator, options, eid[i]) == CHIP_NO_ERROR);
+    }
+
+    chip::app::CircularEventBuffer & debugBuffer = gCircularEventBuffer[0];
+    chip::app::CircularEventBuffer & infoBuffer  = gCircularEventBuffer[1];
+    NL_TEST_ASSERT(apSuite, debugBuffer.SyncIndex() == 0);
+    NL_TEST_ASSERT(apSuite, debugBuffer.GetIndexEntryCount() == 3);
+    NL_TEST_ASSERT(apSuite, debugBuffer.GetIndexEntry(0).mEventNumber == eid[3]);
+    NL_TEST_ASSERT(apSuite, infoBuffer.SyncIndex() == 0);
+    NL_TEST_ASSERT(apSuite, infoBuffer.GetIndexEntryCount() == 3);
+    for (size_t i = 0; i < 3; i++)
+    {
+        const chip::app::CircularEventBuffer::IndexEntry & entry = infoBuffer.GetIndexEntry(i);
+        NL_TEST_ASSERT(apSuite, entry.mEventNumber == eid[i]);
+        NL_TEST_ASSERT(apSuite, entry.mEndpointId == ((i % 2 == 0) ? kTestEndpointId3 : kTestEndpointId4));
+        NL_TEST_ASSERT(apSuite, entry.mClusterId == kLivenessClusterId);
+        NL_TEST_ASSERT(apSuite, entry.mEventId == kLivenessChangeEvent);
+    }
+
+    // The events of the other endpoint are skipped, and so are the events before eventMin, including the last event:
+    // eventMin still moves past it.
+    eventMin = eid[0];
+    NL_TEST_ASSERT(apSuite, FetchEventNumbers(apSuite, kTestEndpointId3, eventMin, 1024, fetched, 6) == 3);
+    NL_TEST_ASSERT(apSuite, fetched[0] == eid[0] && fetched[1] == eid[2] && fetched[2] == eid[4]);
+    NL_TEST_ASSERT(apSuite, eventMin == eid[5] + 1);
+
+    eventMin = eid[1];
+    NL_TEST_ASSERT(apSuite, FetchEventNumbers(apSuite, kTestEndpointId3, eventMin, 1024, fetched, 6) == 2);
+    NL_TEST_ASSERT(apSuite, fetched[0] == eid[2] && fetched[1] == eid[4]);
+    NL_TEST_ASSERT(apSuite, eventMin == eid[5] + 1);
+
+    eventMin = eid[3];
+    NL_TEST_ASSERT(apSuite, FetchEventNumbers(apSuite, kTestEndpointId3, eventMin, 1024, fetched, 6) == 1);
+    NL_TEST_ASSERT(apSuite, fetched[0] == eid[4]);
+    NL_TEST_ASSERT(apSuite, eventMin == eid[5] + 1);
+
+    eventMin = eid[0];
+    NL_TEST_ASSERT(apSuite, FetchEventNumbers(apSuite, kTestEndpointId4, eventMin, 1024, fetched, 6) == 3);
+    NL_TEST_ASSERT(apSuite, fetched[0] == eid[1] && fetched[1] == eid[3] && fetched[2] == eid[5]);
+    NL_TEST_ASSERT(apSuite, eventMin == eid[5] + 1);
+
+    // A buffer holding a single event resumes each fetch after the last event read, across the skipped ones.
+    eventMin = eid[0];
+    NL_TEST_ASSERT(apSuite, FetchEventNumbers(apSuite, kTestEndpointId4, eventMin, 60, fetched, 6) == 3);
+    NL_TEST_ASSERT(apSuite, fetched[0] == eid[1] && fetched[1] == eid[3] && fetched[2] == eid[5]);
+    NL_TEST_ASSERT(apSuite, eventMin == eid[5] + 1);
+}
+#endif // CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+
 const nlTest sTests[] = {
     NL_TEST_DEF("CheckLogEventWithEvictToNextBuffer", CheckLogEventWithEvictToNextBuffer),
     NL_TEST_DEF("CheckLogEventWithDiscardLowEvent", CheckLogEventWithDiscardLowEvent),
+#if CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    NL_TEST_DEF("CheckEventIndex", CheckEventIndex),
+    NL_TEST_DEF("CheckFetchEventsWithIndex", CheckFetchEventsWithIndex),
+#endif // CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
     NL_TEST_SENTINEL(),
 };
 
@@ -0,0 +1,537 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/CASEClientPool.h>
+#include <app/CASESessionManager.h>
+#include <app/FleetSubscriptionManager.h>
+#include <app/InteractionModelEngine.h>
+#include <app/OperationalSessionSetupPool.h>
+#include <app/reporting/tests/MockReportScheduler.h>
+#include <app/tests/AppTestContext.h>
+#include <app/util/mock/Constants.h>
+#include <app/util/mock/Functions.h>
+#include <credentials/GroupDataProviderImpl.h>
+#include <lib/address_resolve/AddressResolve.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+#include <lib/support/UnitTestContext.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <system/SystemClock.h>
+
+#include <nlunit-test.h>
+
+using namespace chip;
+using namespace chip::app;
+
+namespace chip {
+namespace app {
+
+CHIP_ERROR ReadSingleClusterData(const Access::SubjectDescriptor & aSubjectDescriptor, bool aIsFabricFiltered,
+                                 const ConcreteReadAttributePath & aPath, AttributeReportIBs::Builder & aAttributeReports,
+                                 AttributeValueEncoder::AttributeEncodeState * apEncoderState)
+{
+    return Test::ReadSingleMockClusterData(aSubjectDescriptor.fabricIndex, aPath, aAttributeReports, apEncoderState);
+}
+
+bool IsClusterDataVersionEqual(const ConcreteClusterPath & aConcreteClusterPath, DataVersion aRequiredVersion)
+{
+    return false;
+}
+
+bool IsDeviceTypeOnEndpoint(DeviceTypeId deviceType, EndpointId endpoint)
+{
+    return false;
+}
+
+} // namespace app
+} // namespace chip
+
+namespace {
+
+constexpr size_t kFleetSize                = 4;
+constexpr NodeId kFleetNodeIdBase          = 0x1000;
+constexpr uint16_t kInitiatorSessionIdBase = 0x100;
+constexpr uint16_t kResponderSessionIdBase = 0x200;
+constexpr uint16_t kMaxIntervalSeconds     = 10;
+
+const AttributePathParams kAttributePath(Test::kMockEndpoint2, Test::MockClusterId(3), Test::MockAttributeId(1));
+
+System::Clock::Internal::MockClock gMockClock;
+System::Clock::ClockBase * gRealClock;
+
+class TestContext : public Test::AppContext
+{
+public:
+    static int SetUpTestSuite(void * context)
+    {
+        gRealClock = &System::SystemClock();
+        System::Clock::Internal::SetSystemClockForTesting(&gMockClock);
+        VerifyOrReturnError(AppContext::Initialize(context) == SUCCESS, FAILURE);
+
+        auto * ctx = static_cast<TestContext *>(context);
+        ctx->mGroupDataProvider.SetStorageDelegate(&ctx->mStorage);
+        ctx->mGroupDataProvider.SetSessionKeystore(&ctx->GetSessionKeystore());
+        VerifyOrReturnError(ctx->mGroupDataProvider.Init() == CHIP_NO_ERROR, FAILURE);
+
+        CASESessionManagerConfig config;
+        config.sessionInitParams.sessionManager    = &ctx->GetSecureSessionManager();
+        config.sessionInitParams.exchangeMgr       = &ctx->GetExchangeManager();
+        config.sessionInitParams.fabricTable       = &ctx->GetFabricTable();
+        config.sessionInitParams.groupDataProvider = &ctx->mGroupDataProvider;
+        config.clientPool                          = &ctx->mCASEClientPool;
+        config.sessionSetupPool                    = &ctx->mSessionSetupPool;
+        VerifyOrReturnError(ctx->mCASESessionManager.Init(&ctx->GetSystemLayer(), config) == CHIP_NO_ERROR, FAILURE);
+
+        // The nodes are only reachable over the sessions opened by ConnectNode(): fail the address lookups of the others
+        // right away rather than resolving them.
+        AddressResolve::Resolver::Instance().Shutdown();
+        return SUCCESS;
+    }
+
+    static int TearDownTestSuite(void * context)
+    {
+        auto * ctx = static_cast<TestContext *>(context);
+        ctx->mGroupDataProvider.Finish();
+        VerifyOrReturnError(AppContext::Finalize(context) == SUCCESS, FAILURE);
+        System::Clock::Internal::SetSystemClockForTesting(gRealClock);
+        return SUCCESS;
+    }
+
+    static int SetUp(void * context)
+    {
+        auto * ctx = static_cast<TestContext *>(context);
+        VerifyOrReturnError(ctx->InitEngine(true) == CHIP_NO_ERROR, FAILURE);
+        return SUCCESS;
+    }
+
+    static int TearDown(void * context)
+    {
+        auto * ctx = static_cast<TestContext *>(context);
+        for (size_t i = 0; i < kFleetSize; i++)
+        {
+            ctx->DisconnectNode(i);
+        }
+        InteractionModelEngine::GetInstance()->Shutdown();
+        return SUCCESS;
+    }
+
+    CHIP_ERROR InitEngine(bool withCASESessionManager)
+    {
+        return InteractionModelEngine::GetInstance()->Init(&GetExchangeManager(), &GetFabricTable(),
+                                                           reporting::GetDefaultReportScheduler(),
+                                                           withCASESessionManager ? &mCASESessionManager : nullptr);
+    }
+
+    ScopedNodeId GetNode(size_t index) { return ScopedNodeId(kFleetNodeIdBase + index, GetBobFabricIndex()); }
+
+    /**
+     * Opens a CASE session from Bob to the node, which is served by Alice.
+     */
+    CHIP_ERROR ConnectNode(size_t index)
+    {
+        const uint16_t initiatorSessionId = static_cast<uint16_t>(kInitiatorSessionIdBase + index);
+        const uint16_t responderSessionId = static_cast<uint16_t>(kResponderSessionIdBase + index);
+        const NodeId bobNodeId            = GetBobFabric()->GetNodeId();
+        const NodeId fleetNodeId          = GetNode(index).GetNodeId();
+
+        ReturnErrorOnFailure(GetSecureSessionManager().InjectCaseSessionWithTestKey(
+            mInitiatorSessions[index], initiatorSessionId, responderSessionId, bobNodeId, fleetNodeId, GetBobFabricIndex(),
+            GetAliceAddress(), CryptoContext::SessionRole::kInitiator));
+        return GetSecureSessionManager().InjectCaseSessionWithTestKey(mResponderSessions[index], responderSessionId,
+                                                                      initiatorSessionId, fleetNodeId, bobNodeId,
+                                                                      GetAliceFabricIndex(), GetBobAddress(),
+                                                                      CryptoContext::SessionRole::kResponder);
+    }
+
+    void DisconnectNode(size_t index)
+    {
+        for (SessionHolder * holder : { &mInitiatorSessions[index], &mResponderSessions[index] })
+        {
+            if (*holder)
+            {
+                holder->Get().Value()->AsSecureSession()->MarkForEviction();
+            }
+        }
+    }
+
+    /**
+     * Lets the time pass one second at a time, so that the reports and timers due within it are all processed in order.
+     */
+    void AdvanceClock(System::Clock::Seconds16 time, std::function<bool()> stopCondition = nullptr)
+    {
+        for (uint16_t i = 0; i < time.count(); i++)
+        {
+            gMockClock.AdvanceMonotonic(System::Clock::Seconds16(1));
+            DrainAndServiceIO();
+            if (stopCondition && stopCondition())
+            {
+                return;
+            }
+        }
+    }
+
+private:
+    TestPersistentStorageDelegate mStorage;
+    Credentials::GroupDataProviderImpl mGroupDataProvider;
+    CASEClientPool<kFleetSize> mCASEClientPool;
+    OperationalSessionSetupPool<kFleetSize> mSessionSetupPool;
+    CASESessionManager mCASESessionManager;
+    SessionHolder mInitiatorSessions[kFleetSize];
+    SessionHolder mResponderSessions[kFleetSize];
+};
+
+class TestFleetDelegate : public FleetSubscriptionManager::Delegate
+{
+public:
+    struct NodeEvents
+    {
+        uint32_t established = 0;
+        uint32_t attributes  = 0;
+        uint32_t reports     = 0;
+        uint32_t lost        = 0;
+        uint32_t done        = 0;
+        CHIP_ERROR lastError = CHIP_NO_ERROR;
+    };
+
+    explicit TestFleetDelegate(FleetSubscriptionManager & manager) : mManager(manager) {}
+
+    void OnSubscriptionEstablished(const ScopedNodeId & node, SubscriptionId subscriptionId) override
+    {
+        Events(node).established++;
+    }
+
+    void OnAttributeData(const ScopedNodeId & node, const ConcreteDataAttributePath & path, TLV::TLVReader * data,
+                         const StatusIB & status) override
+    {
+        Events(node).attributes++;
+        // The priming report of a node arrives while it is still being subscribed to.
+        mMaxEstablishing = std::max(mMaxEstablishing, mManager.GetStats().establishing);
+    }
+
+    void OnReportEnd(const ScopedNodeId & node, const ClusterStateCache & cache) override { Events(node).reports++; }
+
+    void OnSubscriptionLost(const ScopedNodeId & node, CHIP_ERROR error) override
+    {
+        Events(node).lost++;
+        Events(node).lastError = error;
+    }
+
+    void OnSubscriptionDone(const ScopedNodeId & node, CHIP_ERROR error) override
+    {
+        Events(node).done++;
+        Events(node).lastError = error;
+    }
+
+    NodeEvents & Events(const ScopedNodeId & node) { return mEvents[node.GetNodeId() - kFleetNodeIdBase]; }
+
+    uint32_t GetTotal(uint32_t NodeEvents::*counter) const
+    {
+        uint32_t total = 0;
+        for (const auto & events : mEvents)
+        {
+            total += events.*counter;
+        }
+        return total;
+    }
+
+    FleetSubscriptionManager & mManager;
+    NodeEvents mEvents[kFleetSize];
+    size_t mMaxEstablishing = 0;
+};
+
+FleetSubscriptionManager::Parameters MakeParameters(uint16_t maxConcurrentEstablishments)
+{
+    FleetSubscriptionManager::Parameters params;
+    params.attributePaths              = &kAttributePath;
+    params.attributePathCount          = 1;
+    params.maxIntervalCeilingSeconds   = kMaxIntervalSeconds;
+    params.maxConcurrentEstablishments = maxConcurrentEstablishments;
+    return params;
+}
+
+void TestFanOut(nlTestSuite * apSuite, void * apContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    FleetSubscriptionManager manager;
+    TestFleetDelegate delegate(manager);
+
+    NL_TEST_ASSERT(apSuite, manager.Init(&ctx.GetExchangeManager(), delegate, MakeParameters(0)) == CHIP_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(apSuite, manager.Init(&ctx.GetExchangeManager(), delegate, MakeParameters(2)) == CHIP_NO_ERROR);
+
+    for (size_t i = 0; i < kFleetSize; i++)
+    {
+        NL_TEST_ASSERT(apSuite, ctx.ConnectNode(i) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(apSuite, manager.AddNode(ctx.GetNode(i)) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(apSuite, manager.AddNode(ctx.GetNode(0)) == CHIP_ERROR_DUPLICATE_KEY_ID);
+
+    // The nodes are only subscribed to once the call stack unwinds.
+    NL_TEST_ASSERT(apSuite, manager.GetStats().nodes == kFleetSize);
+    NL_TEST_ASSERT(apSuite, manager.GetStats().establishing == 0);
+
+    ctx.GetIOContext().DriveIO();
+    NL_TEST_ASSERT(apSuite, manager.GetStats().establishing == 2);
+    NL_TEST_ASSERT(apSuite, manager.GetStats().active == 0);
+
+    ctx.DrainAndServiceIO();
+    NL_TEST_ASSERT(apSuite, manager.GetStats().active == kFleetSize);
+    NL_TEST_ASSERT(apSuite, manager.GetStats().establishing == 0);
+    NL_TEST_ASSERT(apSuite, manager.GetStats().established == kFleetSize);
+    NL_TEST_ASSERT(apSuite, manager.GetStats().attributes == kFleetSize);
+    NL_TEST_ASSERT(apSuite, delegate.mMaxEstablishing == 2);
+
+    for (size_t i = 0; i < kFleetSize; i++)
+    {
+        const auto & events = delegate.Events(ctx.GetNode(i));
+        NL_TEST_ASSERT(apSuite, events.established == 1);
+        NL_TEST_ASSERT(apSuite, events.attributes == 1);
+        NL_TEST_ASSERT(apSuite, events.reports == 1);
+        NL_TEST_ASSERT(apSuite, events.lost == 0 && events.done == 0);
+    }
+
+    // The subscriptions are kept alive by the empty reports sent at the max interval, which do not reach the delegate.
+    ctx.AdvanceClock(System::Clock::Seconds16(3 * kMaxIntervalSeconds));
+    NL_TEST_ASSERT(apSuite, manager.GetStats().active == kFleetSize);
+    NL_TEST_ASSERT(apSuite, delegate.GetTotal(&TestFleetDelegate::NodeEvents::lost) == 0);
+    NL_TEST_ASSERT(apSuite, manager.GetStats().reports == kFleetSize);
+
+    manager.Shutdown();
+    NL_TEST_ASSERT(apSuite, InteractionModelEngine::GetInstance()->GetNumActiveReadClients() == 0);
+}
+
+void TestResubscribeBackoff(nlTestSuite * apSuite, void * apContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    FleetSubscriptionManager manager;
+    TestFleetDelegate delegate(manager);
+    const ScopedNodeId lostNode = ctx.GetNode(1);
+    auto & lostEvents           = delegate.Events(lostNode);
+
+    NL_TEST_ASSERT(apSuite, manager.Init(&ctx.GetExchangeManager(), delegate, MakeParameters(2)) == CHIP_NO_ERROR);
+    for (size_t i = 0; i < 2; i++)
+    {
+        NL_TEST_ASSERT(apSuite, ctx.ConnectNode(i) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(apSuite, manager.AddNode(ctx.GetNode(i)) == CHIP_NO_ERROR);
+    }
+    ctx.DrainAndServiceIO();
+    NL_TEST_ASSERT(apSuite, manager.GetStats().active == 2);
+
+    // The subscription times out once the node goes away.  It is re-established right away, over a new CASE session,
+    // which cannot be set up: the next attempt waits for the back-off.
+    ctx.DisconnectNode(1);
+    ctx.AdvanceClock(System::Clock::Seconds16(6 * kMaxIntervalSeconds), [&]() { return lostEvents.lost >= 2; });
+    NL_TEST_ASSERT(apSuite, lostEvents.lost == 2);
+    NL_TEST_ASSERT(apSuite, lostEvents.done == 0);
+    NL_TEST_ASSERT(apSuite, manager.GetStats().lost == 2);
+    NL_TEST_ASSERT(apSuite, manager.GetStats().active == 1);
+    NL_TEST_ASSERT(apSuite, manager.GetStats().establishing == 0);
+    NL_TEST_ASSERT(apSuite, manager.GetStats().nodes == 2);
+
+    // The fibonacci back-off of the second retry is at least 30% of 10 seconds.
+    NL_TEST_ASSERT(apSuite, ctx.ConnectNode(1) == CHIP_NO_ERROR);
+    ctx.AdvanceClock(System::Clock::Seconds16(2));
+    NL_TEST_ASSERT(apSuite, lostEvents.established == 1);
+    NL_TEST_ASSERT(apSuite, manager.GetStats().active == 1);
+
+    ctx.AdvanceClock(System::Clock::Seconds16(9), [&]() { return lostEvents.established == 2; });
+    NL_TEST_ASSERT(apSuite, lostEvents.established == 2);
+    NL_TEST_ASSERT(apSuite, lostEvents.lost == 2);
+    NL_TEST_ASSERT(apSuite, manager.GetStats().active == 2);
+    NL_TEST_ASSERT(apSuite, manager.GetStats().established == 3);
+
+    // The other node kept its subscription all along.
+    const auto & otherEvents = delegate.Events(ctx.GetNode(0));
+    NL_TEST_ASSERT(apSuite, otherEvents.established == 1);
+    NL_TEST_ASSERT(apSuite, otherEvents.lost == 0 && otherEvents.done == 0);
+
+    manager.Shutdown();
+}
+
+void TestFailureIsolation(nlTestSuite * apSuite, void * apContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    FleetSubscriptionManager manager;
+    TestFleetDelegate delegate(manager);
+    const ScopedNodeId unreachableNode = ctx.GetNode(1);
+    auto & unreachableEvents           = delegate.Events(unreachableNode);
+
+    // One establishment at a time: the unreachable node must not hold up the others.
+    NL_TEST_ASSERT(apSuite, manager.Init(&ctx.GetExchangeManager(), delegate, MakeParameters(1)) == CHIP_NO_ERROR);
+    for (size_t i = 0; i < 3; i++)
+    {
+        if (ctx.GetNode(i) != unreachableNode)
+        {
+            NL_TEST_ASSERT(apSuite, ctx.ConnectNode(i) == CHIP_NO_ERROR);
+        }
+        NL_TEST_ASSERT(apSuite, manager.AddNode(ctx.GetNode(i)) == CHIP_NO_ERROR);
+    }
+
+    ctx.AdvanceClock(System::Clock::Seconds16(2));
+    NL_TEST_ASSERT(apSuite, manager.GetStats().active == 2);
+    NL_TEST_ASSERT(apSuite, manager.GetStats().nodes == 3);
+    NL_TEST_ASSERT(apSuite, unreachableEvents.established == 0);
+    NL_TEST_ASSERT(apSuite, unreachableEvents.lost == 2);
+    NL_TEST_ASSERT(apSuite, unreachableEvents.done == 0);
+
+    // The unreachable node keeps being retried on its own.
+    ctx.AdvanceClock(System::Clock::Seconds16(10));
+    NL_TEST_ASSERT(apSuite, unreachableEvents.lost == 3);
+
+    NL_TEST_ASSERT(apSuite, manager.RemoveNode(unreachableNode) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(apSuite, manager.RemoveNode(unreachableNode) == CHIP_ERROR_NOT_FOUND);
+    NL_TEST_ASSERT(apSuite, manager.GetStats().nodes == 2);
+
+    ctx.AdvanceClock(System::Clock::Seconds16(3 * kMaxIntervalSeconds));
+    NL_TEST_ASSERT(apSuite, unreachableEvents.lost == 3);
+    NL_TEST_ASSERT(apSuite, unreachableEvents.done == 0);
+
+    for (size_t i : { 0, 2 })
+    {
+        const auto & events = delegate.Events(ctx.GetNode(i));
+        NL_TEST_ASSERT(apSuite, events.established == 1);
+        NL_TEST_ASSERT(apSuite, events.lost == 0 && events.done == 0);
+    }
+    NL_TEST_ASSERT(apSuite, manager.GetStats().active == 2);
+
+    manager.Shutdown();
+}
+
+void TestStartFailure(nlTestSuite * apSuite, void * apContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    FleetSubscriptionManager manager;
+    TestFleetDelegate delegate(manager);
+
+    // Without a CASESessionManager, the subscriptions cannot be started at all: each node is given up on, and its slot
+    // goes to the next one.
+    InteractionModelEngine::GetInstance()->Shutdown();
+    NL_TEST_ASSERT(apSuite, ctx.InitEngine(false) == CHIP_NO_ERROR);
+
+    NL_TEST_ASSERT(apSuite, manager.Init(&ctx.GetExchangeManager(), delegate, MakeParameters(1)) == CHIP_NO_ERROR);
+    for (size_t i = 0; i < 3; i++)
+    {
+        NL_TEST_ASSERT(apSuite, ctx.ConnectNode(i) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(apSuite, manager.AddNode(ctx.GetNode(i)) == CHIP_NO_ERROR);
+    }
+
+    ctx.DrainAndServiceIO();
+    for (size_t i = 0; i < 3; i++)
+    {
+        const auto & events = delegate.Events(ctx.GetNode(i));
+        NL_TEST_ASSERT(apSuite, events.done == 1);
+        NL_TEST_ASSERT(apSuite, events.lastError == CHIP_ERROR_INCORRECT_STATE);
+        NL_TEST_ASSERT(apSuite, events.established == 0 && events.lost == 0);
+    }
+    NL_TEST_ASSERT(apSuite, manager.GetStats().nodes == 0);
+    NL_TEST_ASSERT(apSuite, manager.GetStats().establishing == 0);
+    NL_TEST_ASSERT(apSuite, InteractionModelEngine::GetInstance()->GetNumActiveReadClients() == 0);
+
+    manager.Shutdown();
+}
+
+void TestShutdownWhilePending(nlTestSuite * apSuite, void * apContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    FleetSubscriptionManager manager;
+    TestFleetDelegate delegate(manager);
+    auto * engine = InteractionModelEngine::GetInstance();
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        NL_TEST_ASSERT(apSuite, ctx.ConnectNode(i) == CHIP_NO_ERROR);
+    }
+
+    // All the nodes still queued.
+    NL_TEST_ASSERT(apSuite, manager.Init(&ctx.GetExchangeManager(), delegate, MakeParameters(1)) == CHIP_NO_ERROR);
+    for (size_t i = 0; i < 3; i++)
+    {
+        NL_TEST_ASSERT(apSuite, manager.AddNode(ctx.GetNode(i)) == CHIP_NO_ERROR);
+    }
+    manager.Shutdown();
+    NL_TEST_ASSERT(apSuite, manager.GetStats().nodes == 0);
+    NL_TEST_ASSERT(apSuite, manager.AddNode(ctx.GetNode(0)) == CHIP_ERROR_INCORRECT_STATE);
+    ctx.DrainAndServiceIO();
+    NL_TEST_ASSERT(apSuite, engine->GetNumActiveReadClients() == 0);
+
+    // One node being subscribed to, the others waiting for their turn.
+    NL_TEST_ASSERT(apSuite, manager.Init(&ctx.GetExchangeManager(), delegate, MakeParameters(1)) == CHIP_NO_ERROR);
+    for (size_t i = 0; i < 3; i++)
+    {
+        NL_TEST_ASSERT(apSuite, manager.AddNode(ctx.GetNode(i)) == CHIP_NO_ERROR);
+    }
+    ctx.GetIOContext().DriveIO();
+    NL_TEST_ASSERT(apSuite, manager.GetStats().establishing == 1);
+    NL_TEST_ASSERT(apSuite, engine->GetNumActiveReadClients() == 1);
+    manager.Shutdown();
+    NL_TEST_ASSERT(apSuite, manager.GetStats().establishing == 0);
+    NL_TEST_ASSERT(apSuite, engine->GetNumActiveReadClients() == 0);
+    ctx.DrainAndServiceIO();
+
+    // Active nodes, and the unreachable third one waiting for its back-off.
+    NL_TEST_ASSERT(apSuite, manager.Init(&ctx.GetExchangeManager(), delegate, MakeParameters(1)) == CHIP_NO_ERROR);
+    for (size_t i = 0; i < 3; i++)
+    {
+        NL_TEST_ASSERT(apSuite, manager.AddNode(ctx.GetNode(i)) == CHIP_NO_ERROR);
+    }
+    ctx.AdvanceClock(System::Clock::Seconds16(2));
+    NL_TEST_ASSERT(apSuite, manager.GetStats().active == 2);
+    NL_TEST_ASSERT(apSuite, delegate.Events(ctx.GetNode(2)).lost == 2);
+    manager.Shutdown();
+    NL_TEST_ASSERT(apSuite, engine->GetNumActiveReadClients() == 0);
+
+    // Nothing is reported for the nodes dropped by Shutdown().
+    const uint32_t established = delegate.GetTotal(&TestFleetDelegate::NodeEvents::established);
+    const uint32_t reports     = delegate.GetTotal(&TestFleetDelegate::NodeEvents::reports);
+    ctx.AdvanceClock(System::Clock::Seconds16(3 * kMaxIntervalSeconds));
+    NL_TEST_ASSERT(apSuite, delegate.GetTotal(&TestFleetDelegate::NodeEvents::established) == established);
+    NL_TEST_ASSERT(apSuite, delegate.GetTotal(&TestFleetDelegate::NodeEvents::reports) == reports);
+    NL_TEST_ASSERT(apSuite, delegate.GetTotal(&TestFleetDelegate::NodeEvents::lost) == 2);
+    NL_TEST_ASSERT(apSuite, delegate.GetTotal(&TestFleetDelegate::NodeEvents::done) == 0);
+    NL_TEST_ASSERT(apSuite, manager.GetStats().nodes == 0);
+}
+
+// clang-format off
+const nlTest sTests[] =
+{
+    NL_TEST_DEF("TestFanOut", TestFanOut),
+    NL_TEST_DEF("TestResubscribeBackoff", TestResubscribeBackoff),
+    NL_TEST_DEF("TestFailureIsolation", TestFailureIsolation),
+    NL_TEST_DEF("TestStartFailure", TestStartFailure),
+    NL_TEST_DEF("TestShutdownWhilePending", TestShutdownWhilePending),
+    NL_TEST_SENTINEL()
+};
+
+nlTestSuite sSuite =
+{
+    "TestFleetSubscriptionManager",
+    &sTests[0],
+    TestContext::SetUpTestSuite,
+    TestContext::TearDownTestSuite,
+    TestContext::SetUp,
+    TestContext::TearDown,
+};
+// clang-format on
+
+} // namespace
+
+int TestFleetSubscriptionManager()
+{
+    return chip::ExecuteTestsWithContext<TestContext>(&sSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestFleetSubscriptionManager)
@@ -0,0 +1,435 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <lib/support/UnitTestRegistration.h>
+#include <nlunit-test.h>
+
+#include <app/IndexedSubscriptionResumptionStorage.h>
+#include <app/SimpleSubscriptionResumptionStorage.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+
+#include <lib/support/DefaultStorageKeyAllocator.h>
+
+#include <string.h>
+
+using chip::DefaultStorageKeyAllocator;
+using SubscriptionInfo = chip::app::SubscriptionResumptionStorage::SubscriptionInfo;
+
+namespace {
+
+class IndexedSubscriptionResumptionStorageTest : public chip::app::IndexedSubscriptionResumptionStorage
+{
+public:
+    size_t TestPathListCount() const { return PathListCount(); }
+};
+
+// Storage that cannot write the index record while mFailIndexWrites is set.
+class FailingIndexStorage : public chip::TestPersistentStorageDelegate
+{
+public:
+    bool mFailIndexWrites = true;
+
+protected:
+    CHIP_ERROR SyncSetKeyValueInternal(const char * key, const void * value, uint16_t size) override
+    {
+        if (mFailIndexWrites && strcmp(key, DefaultStorageKeyAllocator::SubscriptionResumptionIndex().KeyName()) == 0)
+        {
+            return CHIP_ERROR_PERSISTED_STORAGE_FAILED;
+        }
+        return chip::TestPersistentStorageDelegate::SyncSetKeyValueInternal(key, value, size);
+    }
+};
+
+struct TestSubscriptionInfo : public SubscriptionInfo
+{
+    bool operator==(const SubscriptionInfo & that) const
+    {
+        if ((mNodeId != that.mNodeId) || (mFabricIndex != that.mFabricIndex) || (mSubscriptionId != that.mSubscriptionId) ||
+            (mMinInterval != that.mMinInterval) || (mMaxInterval != that.mMaxInterval) || (mFabricFiltered != that.mFabricFiltered))
+        {
+            return false;
+        }
+        if ((mAttributePaths.AllocatedSize() != that.mAttributePaths.AllocatedSize()) ||
+            (mEventPaths.AllocatedSize() != that.mEventPaths.AllocatedSize()))
+        {
+            return false;
+        }
+        for (size_t i = 0; i < mAttributePaths.AllocatedSize(); i++)
+        {
+            if ((mAttributePaths[i].mEndpointId != that.mAttributePaths[i].mEndpointId) ||
+                (mAttributePaths[i].mClusterId != that.mAttributePaths[i].mClusterId) ||
+                (mAttributePaths[i].mAttributeId != that.mAttributePaths[i].mAttributeId))
+            {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < mEventPaths.AllocatedSize(); i++)
+        {
+            if ((mEventPaths[i].mEndpointId != that.mEventPaths[i].mEndpointId) ||
+                (mEventPaths[i].mClusterId != that.mEventPaths[i].mClusterId) ||
+                (mEventPaths[i].mEventId != that.mEventPaths[i].mEventId) ||
+                (mEventPaths[i].mIsUrgentEvent != that.mEventPaths[i].mIsUrgentEvent))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+void InitSubscription(SubscriptionInfo & subscriptionInfo, chip::NodeId nodeId, chip::FabricIndex fabricIndex,
+                      chip::SubscriptionId subscriptionId, chip::EndpointId endpointId)
+{
+    subscriptionInfo.mNodeId         = nodeId;
+    subscriptionInfo.mFabricIndex    = fabricIndex;
+    subscriptionInfo.mSubscriptionId = subscriptionId;
+    subscriptionInfo.mMinInterval    = 1;
+    subscriptionInfo.mMaxInterval    = 60;
+    subscriptionInfo.mFabricFiltered = true;
+
+    subscriptionInfo.mAttributePaths.Calloc(2);
+    subscriptionInfo.mAttributePaths[0].mEndpointId  = endpointId;
+    subscriptionInfo.mAttributePaths[0].mClusterId   = 6;
+    subscriptionInfo.mAttributePaths[0].mAttributeId = 0;
+    // Wildcard attribute
+    subscriptionInfo.mAttributePaths[1].mEndpointId  = endpointId;
+    subscriptionInfo.mAttributePaths[1].mClusterId   = 8;
+    subscriptionInfo.mAttributePaths[1].mAttributeId = chip::kInvalidAttributeId;
+
+    subscriptionInfo.mEventPaths.Calloc(1);
+    // Wildcard endpoint and cluster
+    subscriptionInfo.mEventPaths[0].mEndpointId    = chip::kInvalidEndpointId;
+    subscriptionInfo.mEventPaths[0].mClusterId     = chip::kInvalidClusterId;
+    subscriptionInfo.mEventPaths[0].mEventId       = chip::kInvalidEventId;
+    subscriptionInfo.mEventPaths[0].mIsUrgentEvent = true;
+}
+
+void TestSharedPathLists(nlTestSuite * inSuite, void * inContext)
+{
+    chip::TestPersistentStorageDelegate storage;
+    IndexedSubscriptionResumptionStorageTest subscriptionStorage;
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.Init(&storage) == CHIP_NO_ERROR);
+
+    // Two subscriptions to endpoint 1 and one to endpoint 2.
+    TestSubscriptionInfo subscriptionInfo1;
+    InitSubscription(subscriptionInfo1, 1111, 1, 1, 1);
+    TestSubscriptionInfo subscriptionInfo2;
+    InitSubscription(subscriptionInfo2, 2222, 2, 2, 2);
+    TestSubscriptionInfo subscriptionInfo3;
+    InitSubscription(subscriptionInfo3, 3333, 1, 3, 1);
+
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.Save(subscriptionInfo1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.Save(subscriptionInfo2) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.Save(subscriptionInfo3) == CHIP_NO_ERROR);
+
+    // The index and two path lists.
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.TestPathListCount() == 2);
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 3);
+    NL_TEST_ASSERT(inSuite, storage.HasKey(DefaultStorageKeyAllocator::SubscriptionResumptionIndex().KeyName()));
+
+    // Subscriptions are iterated over grouped by path list.
+    auto * iterator = subscriptionStorage.IterateSubscriptions();
+    NL_TEST_ASSERT(inSuite, iterator->Count() == 3);
+    TestSubscriptionInfo subscriptionInfo;
+    NL_TEST_ASSERT(inSuite, iterator->Next(subscriptionInfo));
+    NL_TEST_ASSERT(inSuite, subscriptionInfo == subscriptionInfo1);
+    NL_TEST_ASSERT(inSuite, iterator->Next(subscriptionInfo));
+    NL_TEST_ASSERT(inSuite, subscriptionInfo == subscriptionInfo3);
+    NL_TEST_ASSERT(inSuite, iterator->Next(subscriptionInfo));
+    NL_TEST_ASSERT(inSuite, subscriptionInfo == subscriptionInfo2);
+    NL_TEST_ASSERT(inSuite, !iterator->Next(subscriptionInfo));
+    iterator->Release();
+
+    // Saving a subscription again replaces it.
+    InitSubscription(subscriptionInfo1, 1111, 1, 1, 2);
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.Save(subscriptionInfo1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.TestPathListCount() == 2);
+
+    // A path list goes away with the last subscription using it.
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.Delete(3333, 1, 3) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.Delete(3333, 1, 3) == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.TestPathListCount() == 1);
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 2);
+
+    iterator = subscriptionStorage.IterateSubscriptions();
+    NL_TEST_ASSERT(inSuite, iterator->Count() == 2);
+    NL_TEST_ASSERT(inSuite, iterator->Next(subscriptionInfo));
+    NL_TEST_ASSERT(inSuite, subscriptionInfo == subscriptionInfo1);
+    NL_TEST_ASSERT(inSuite, iterator->Next(subscriptionInfo));
+    NL_TEST_ASSERT(inSuite, subscriptionInfo == subscriptionInfo2);
+    NL_TEST_ASSERT(inSuite, !iterator->Next(subscriptionInfo));
+    iterator->Release();
+
+    // Nothing is left in storage once all the subscriptions are deleted.
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.DeleteAll(1) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.DeleteAll(2) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.DeleteAll(2) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.TestPathListCount() == 0);
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 0);
+}
+
+void TestReload(nlTestSuite * inSuite, void * inContext)
+{
+    chip::TestPersistentStorageDelegate storage;
+    TestSubscriptionInfo subscriptionInfo1;
+    InitSubscription(subscriptionInfo1, 1111, 1, 1, 1);
+    TestSubscriptionInfo subscriptionInfo2;
+    InitSubscription(subscriptionInfo2, 2222, 1, 2, 1);
+    subscriptionInfo2.mFabricFiltered = false;
+    subscriptionInfo2.mMaxInterval    = 3600;
+
+    {
+        IndexedSubscriptionResumptionStorageTest subscriptionStorage;
+        NL_TEST_ASSERT(inSuite, subscriptionStorage.Init(&storage) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, subscriptionStorage.Save(subscriptionInfo1) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, subscriptionStorage.Save(subscriptionInfo2) == CHIP_NO_ERROR);
+    }
+
+    IndexedSubscriptionResumptionStorageTest subscriptionStorage;
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.Init(&storage) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.TestPathListCount() == 1);
+
+    auto * iterator = subscriptionStorage.IterateSubscriptions();
+    NL_TEST_ASSERT(inSuite, iterator->Count() == 2);
+    TestSubscriptionInfo subscriptionInfo;
+    NL_TEST_ASSERT(inSuite, iterator->Next(subscriptionInfo));
+    NL_TEST_ASSERT(inSuite, subscriptionInfo == subscriptionInfo1);
+    NL_TEST_ASSERT(inSuite, iterator->Next(subscriptionInfo));
+    NL_TEST_ASSERT(inSuite, subscriptionInfo == subscriptionInfo2);
+    NL_TEST_ASSERT(inSuite, !iterator->Next(subscriptionInfo));
+    iterator->Release();
+
+    // A subscription whose path list cannot be read is dropped.
+    NL_TEST_ASSERT(inSuite,
+                   storage.SyncSetKeyValue(DefaultStorageKeyAllocator::SubscriptionResumptionPathList(0).KeyName(), "junk", 4) ==
+                       CHIP_NO_ERROR);
+    iterator = subscriptionStorage.IterateSubscriptions();
+    NL_TEST_ASSERT(inSuite, !iterator->Next(subscriptionInfo));
+    NL_TEST_ASSERT(inSuite, iterator->Count() == 0);
+    iterator->Release();
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 0);
+
+    // So is a corrupted index.
+    NL_TEST_ASSERT(inSuite,
+                   storage.SyncSetKeyValue(DefaultStorageKeyAllocator::SubscriptionResumptionIndex().KeyName(), "junk", 4) ==
+                       CHIP_NO_ERROR);
+    IndexedSubscriptionResumptionStorageTest corruptedStorage;
+    NL_TEST_ASSERT(inSuite, corruptedStorage.Init(&storage) == CHIP_NO_ERROR);
+    iterator = corruptedStorage.IterateSubscriptions();
+    NL_TEST_ASSERT(inSuite, iterator->Count() == 0);
+    iterator->Release();
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 0);
+}
+
+void TestMaxCount(nlTestSuite * inSuite, void * inContext)
+{
+    chip::TestPersistentStorageDelegate storage;
+    IndexedSubscriptionResumptionStorageTest subscriptionStorage;
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.Init(&storage) == CHIP_NO_ERROR);
+
+    SubscriptionInfo subscriptionInfo;
+    for (size_t i = 0; i < CHIP_IM_MAX_NUM_SUBSCRIPTIONS; i++)
+    {
+        InitSubscription(subscriptionInfo, 1111, 1, static_cast<chip::SubscriptionId>(i), static_cast<chip::EndpointId>(i));
+        NL_TEST_ASSERT(inSuite, subscriptionStorage.Save(subscriptionInfo) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.TestPathListCount() == CHIP_IM_MAX_NUM_SUBSCRIPTIONS);
+
+    InitSubscription(subscriptionInfo, 1111, 1, CHIP_IM_MAX_NUM_SUBSCRIPTIONS, 0);
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.Save(subscriptionInfo) == CHIP_ERROR_NO_MEMORY);
+
+    // Replacing a subscription still works when full.
+    InitSubscription(subscriptionInfo, 1111, 1, 0, 1);
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.Save(subscriptionInfo) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.TestPathListCount() == CHIP_IM_MAX_NUM_SUBSCRIPTIONS - 1);
+}
+
+void TestImportSimpleStorage(nlTestSuite * inSuite, void * inContext)
+{
+    chip::TestPersistentStorageDelegate storage;
+    TestSubscriptionInfo subscriptionInfo1;
+    InitSubscription(subscriptionInfo1, 1111, 1, 1, 1);
+    TestSubscriptionInfo subscriptionInfo2;
+    InitSubscription(subscriptionInfo2, 2222, 2, 2, 1);
+
+    {
+        chip::app::SimpleSubscriptionResumptionStorage simpleStorage;
+        NL_TEST_ASSERT(inSuite, simpleStorage.Init(&storage) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, simpleStorage.Save(subscriptionInfo1) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, simpleStorage.Save(subscriptionInfo2) == CHIP_NO_ERROR);
+    }
+
+    IndexedSubscriptionResumptionStorageTest subscriptionStorage;
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.Init(&storage) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.TestPathListCount() == 1);
+
+    // Only the index and the path list are left.
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 2);
+    NL_TEST_ASSERT(inSuite, !storage.HasKey(DefaultStorageKeyAllocator::SubscriptionResumptionMaxCount().KeyName()));
+
+    auto * iterator = subscriptionStorage.IterateSubscriptions();
+    NL_TEST_ASSERT(inSuite, iterator->Count() == 2);
+    TestSubscriptionInfo subscriptionInfo;
+    NL_TEST_ASSERT(inSuite, iterator->Next(subscriptionInfo));
+    NL_TEST_ASSERT(inSuite, subscriptionInfo == subscriptionInfo1);
+    NL_TEST_ASSERT(inSuite, iterator->Next(subscriptionInfo));
+    NL_TEST_ASSERT(inSuite, subscriptionInfo == subscriptionInfo2);
+    NL_TEST_ASSERT(inSuite, !iterator->Next(subscriptionInfo));
+    iterator->Release();
+}
+
+void TestImportSimpleStorageFailure(nlTestSuite * inSuite, void * inContext)
+{
+    FailingIndexStorage storage;
+    TestSubscriptionInfo subscriptionInfo1;
+    InitSubscription(subscriptionInfo1, 1111, 1, 1, 1);
+    TestSubscriptionInfo subscriptionInfo2;
+    InitSubscription(subscriptionInfo2, 2222, 2, 2, 2);
+
+    {
+        chip::app::SimpleSubscriptionResumptionStorage simpleStorage;
+        NL_TEST_ASSERT(inSuite, simpleStorage.Init(&storage) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, simpleStorage.Save(subscriptionInfo1) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, simpleStorage.Save(subscriptionInfo2) == CHIP_NO_ERROR);
+    }
+
+    // The legacy records stay until the index record is written.
+    {
+        IndexedSubscriptionResumptionStorageTest subscriptionStorage;
+        NL_TEST_ASSERT(inSuite, subscriptionStorage.Init(&storage) != CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, !storage.HasKey(DefaultStorageKeyAllocator::SubscriptionResumptionIndex().KeyName()));
+        NL_TEST_ASSERT(inSuite, storage.HasKey(DefaultStorageKeyAllocator::SubscriptionResumptionMaxCount().KeyName()));
+        NL_TEST_ASSERT(inSuite, storage.HasKey(DefaultStorageKeyAllocator::SubscriptionResumption(0).KeyName()));
+        NL_TEST_ASSERT(inSuite, storage.HasKey(DefaultStorageKeyAllocator::SubscriptionResumption(1).KeyName()));
+    }
+
+    // The next Init() tries again.
+    storage.mFailIndexWrites = false;
+    IndexedSubscriptionResumptionStorageTest subscriptionStorage;
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.Init(&storage) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.TestPathListCount() == 2);
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 3);
+    NL_TEST_ASSERT(inSuite, !storage.HasKey(DefaultStorageKeyAllocator::SubscriptionResumptionMaxCount().KeyName()));
+
+    auto * iterator = subscriptionStorage.IterateSubscriptions();
+    NL_TEST_ASSERT(inSuite, iterator->Count() == 2);
+    iterator->Release();
+}
+
+void TestResumeImportSimpleStorage(nlTestSuite * inSuite, void * inContext)
+{
+    chip::TestPersistentStorageDelegate storage;
+    TestSubscriptionInfo subscriptionInfo1;
+    InitSubscription(subscriptionInfo1, 1111, 1, 1, 1);
+    TestSubscriptionInfo subscriptionInfo2;
+    InitSubscription(subscriptionInfo2, 2222, 2, 2, 2);
+
+    {
+        chip::app::SimpleSubscriptionResumptionStorage simpleStorage;
+        NL_TEST_ASSERT(inSuite, simpleStorage.Init(&storage) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, simpleStorage.Save(subscriptionInfo1) == CHIP_NO_ERROR);
+    }
+    {
+        IndexedSubscriptionResumptionStorageTest subscriptionStorage;
+        NL_TEST_ASSERT(inSuite, subscriptionStorage.Init(&storage) == CHIP_NO_ERROR);
+    }
+
+    // Legacy records left next to the index, as if deleting them had been interrupted, are merged into the index.
+    {
+        chip::app::SimpleSubscriptionResumptionStorage simpleStorage;
+        NL_TEST_ASSERT(inSuite, simpleStorage.Init(&storage) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, simpleStorage.Save(subscriptionInfo1) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, simpleStorage.Save(subscriptionInfo2) == CHIP_NO_ERROR);
+    }
+
+    IndexedSubscriptionResumptionStorageTest subscriptionStorage;
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.Init(&storage) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, subscriptionStorage.TestPathListCount() == 2);
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 3);
+    NL_TEST_ASSERT(inSuite, !storage.HasKey(DefaultStorageKeyAllocator::SubscriptionResumptionMaxCount().KeyName()));
+
+    auto * iterator = subscriptionStorage.IterateSubscriptions();
+    NL_TEST_ASSERT(inSuite, iterator->Count() == 2);
+    TestSubscriptionInfo subscriptionInfo;
+    NL_TEST_ASSERT(inSuite, iterator->Next(subscriptionInfo));
+    NL_TEST_ASSERT(inSuite, subscriptionInfo == subscriptionInfo1);
+    NL_TEST_ASSERT(inSuite, iterator->Next(subscriptionInfo));
+    NL_TEST_ASSERT(inSuite, subscriptionInfo == subscriptionInfo2);
+    iterator->Release();
+}
+
+/**
+ *  Set up the test suite.
+ */
+int TestSubscription_Setup(void * inContext)
+{
+    VerifyOrReturnError(CHIP_NO_ERROR == chip::Platform::MemoryInit(), FAILURE);
+
+    return SUCCESS;
+}
+
+/**
+ *  Tear down the test suite.
+ */
+int TestSubscription_Teardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+// Test Suite
+
+/**
+ *  Test Suite that lists all the test functions.
+ */
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("TestSharedPathLists", TestSharedPathLists),
+    NL_TEST_DEF("TestReload", TestReload),
+    NL_TEST_DEF("TestMaxCount", TestMaxCount),
+    NL_TEST_DEF("TestImportSimpleStorage", TestImportSimpleStorage),
+    NL_TEST_DEF("TestImportSimpleStorageFailure", TestImportSimpleStorageFailure),
+    NL_TEST_DEF("TestResumeImportSimpleStorage", TestResumeImportSimpleStorage),
+
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+// clang-format off
+static nlTestSuite sSuite =
+{
+    "Test-CHIP-IndexedSubscriptionResumptionStorage",
+    &sTests[0],
+    &TestSubscription_Setup, &TestSubscription_Teardown
+};
+// clang-format on
+
+} // namespace
+
+/**
+ *  Main
+ */
+int TestIndexedSubscriptionResumptionStorage()
+{
+    // Run test suit against one context
+    nlTestRunner(&sSuite, nullptr);
+
+    return (nlTestRunnerStats(&sSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestIndexedSubscriptionResumptionStorage)
@@ -0,0 +1,721 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <lib/support/UnitTestContext.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <nlunit-test.h>
+
+#include <access/SubjectDescriptor.h>
+#include <app/EventLoggingDelegate.h>
+#include <app/EventManagement.h>
+#include <app/MessageDef/EventReportIB.h>
+#include <app/ObjectList.h>
+#include <app/PersistentEventLog.h>
+#include <app/tests/AppTestContext.h>
+#include <lib/support/CHIPCounter.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/DefaultStorageKeyAllocator.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+#include <system/SystemClock.h>
+
+#include <string.h>
+#include <vector>
+
+using namespace chip;
+using namespace chip::app;
+
+namespace {
+
+constexpr size_t kMaxTestEventSize = 256;
+constexpr size_t kPayloadSize      = 100;
+constexpr size_t kEventBufferSize  = 256;
+
+System::Clock::Internal::MockClock gMockClock;
+System::Clock::ClockBase * gRealClock;
+
+uint8_t gDebugEventBuffer[kEventBufferSize];
+uint8_t gInfoEventBuffer[kEventBufferSize];
+uint8_t gCritEventBuffer[kEventBufferSize];
+CircularEventBuffer gCircularEventBuffer[3];
+
+class TestContext : public Test::AppContext
+{
+public:
+    static int Initialize(void * context)
+    {
+        gRealClock = &System::SystemClock();
+        System::Clock::Internal::SetSystemClockForTesting(&gMockClock);
+        VerifyOrReturnError(AppContext::Initialize(context) == SUCCESS, FAILURE);
+        return SUCCESS;
+    }
+
+    static int Finalize(void * context)
+    {
+        VerifyOrReturnError(AppContext::Finalize(context) == SUCCESS, FAILURE);
+        System::Clock::Internal::SetSystemClockForTesting(gRealClock);
+        return SUCCESS;
+    }
+
+    /**
+     * Create the EventManagement instance with empty buffers, numbering the events from aFirstEventNumber, like a boot does.
+     */
+    void CreateEventManagement(EventNumber aFirstEventNumber)
+    {
+        const LogStorageResources logStorageResources[] = {
+            { &gDebugEventBuffer[0], sizeof(gDebugEventBuffer), PriorityLevel::Debug },
+            { &gInfoEventBuffer[0], sizeof(gInfoEventBuffer), PriorityLevel::Info },
+            { &gCritEventBuffer[0], sizeof(gCritEventBuffer), PriorityLevel::Critical },
+        };
+
+        memset(gDebugEventBuffer, 0, sizeof(gDebugEventBuffer));
+        memset(gInfoEventBuffer, 0, sizeof(gInfoEventBuffer));
+        memset(gCritEventBuffer, 0, sizeof(gCritEventBuffer));
+        VerifyOrDie(mEventCounter.Init(aFirstEventNumber) == CHIP_NO_ERROR);
+        EventManagement::CreateEventManagement(&GetExchangeManager(), ArraySize(logStorageResources), gCircularEventBuffer,
+                                               logStorageResources, &mEventCounter, System::Clock::kZero);
+    }
+
+    EventNumber GetNextEventNumber() { return mEventCounter.GetValue(); }
+
+private:
+    MonotonicallyIncreasingCounter<EventNumber> mEventCounter;
+};
+
+class TestEventGenerator : public EventLoggingDelegate
+{
+public:
+    CHIP_ERROR WriteEvent(TLV::TLVWriter & aWriter) override
+    {
+        TLV::TLVType containerType;
+        ReturnErrorOnFailure(
+            aWriter.StartContainer(TLV::ContextTag(EventDataIB::Tag::kData), TLV::kTLVType_Structure, containerType));
+        ReturnErrorOnFailure(aWriter.Put(TLV::ContextTag(1), mValue));
+        return aWriter.EndContainer(containerType);
+    }
+
+    uint32_t mValue = 0;
+};
+
+struct ReportedEvent
+{
+    EventNumber mEventNumber;
+    uint64_t mTimestamp;
+    bool mAbsoluteTimestamp;
+};
+
+struct LoggedEvent
+{
+    EventNumber mEventNumber;
+    FabricIndex mFabricIndex;
+};
+
+/**
+ * Encode an event the way EventManagement stores it, and position aReader on it.
+ */
+CHIP_ERROR EncodeEvent(uint8_t (&aBuffer)[kMaxTestEventSize], EventNumber aEventNumber, FabricIndex aFabricIndex,
+                       size_t aPayloadSize, TLV::TLVReader & aReader)
+{
+    uint8_t payload[kPayloadSize] = {};
+    TLV::TLVWriter writer;
+    EventReportIB::Builder report;
+    writer.Init(aBuffer);
+    ReturnErrorOnFailure(report.Init(&writer));
+    EventDataIB::Builder & data = report.CreateEventData();
+    ReturnErrorOnFailure(report.GetError());
+    EventPathIB::Builder & path = data.CreatePath();
+    ReturnErrorOnFailure(data.GetError());
+    ReturnErrorOnFailure(path.Endpoint(1).Cluster(0x28).Event(0).EndOfEventPathIB());
+    data.EventNumber(aEventNumber).Priority(to_underlying(PriorityLevel::Info)).SystemTimestamp(aEventNumber * 1000);
+    ReturnErrorOnFailure(data.GetError());
+    ReturnErrorOnFailure(
+        writer.PutBytes(TLV::ContextTag(EventDataIB::Tag::kData), payload, static_cast<uint32_t>(aPayloadSize)));
+    if (aFabricIndex != kUndefinedFabricIndex)
+    {
+        ReturnErrorOnFailure(writer.Put(TLV::ProfileTag(kEventManagementProfile, kFabricIndexTag), aFabricIndex));
+    }
+    ReturnErrorOnFailure(data.EndOfEventDataIB());
+    ReturnErrorOnFailure(report.EndOfEventReportIB());
+    ReturnErrorOnFailure(writer.Finalize());
+
+    aReader.Init(aBuffer, writer.GetLengthWritten());
+    return aReader.Next();
+}
+
+CHIP_ERROR AppendEvent(PersistentEventLog & aLog, EventNumber aEventNumber, FabricIndex aFabricIndex = kUndefinedFabricIndex,
+                       size_t aPayloadSize = 0)
+{
+    uint8_t buffer[kMaxTestEventSize];
+    TLV::TLVReader reader;
+    ReturnErrorOnFailure(EncodeEvent(buffer, aEventNumber, aFabricIndex, aPayloadSize, reader));
+    return aLog.Append(aEventNumber, reader);
+}
+
+CHIP_ERROR CollectEvent(const TLV::TLVReader & aReader, size_t aDepth, void * apContext)
+{
+    auto * events = static_cast<std::vector<LoggedEvent> *>(apContext);
+    LoggedEvent event{ 0, kUndefinedFabricIndex };
+    EventReportIB::Parser report;
+    EventDataIB::Parser data;
+    ReturnErrorOnFailure(report.Init(aReader));
+    ReturnErrorOnFailure(report.GetEventData(&data));
+    ReturnErrorOnFailure(data.GetEventNumber(&event.mEventNumber));
+
+    TLV::TLVReader reader;
+    data.GetReader(&reader);
+    while (reader.Next() == CHIP_NO_ERROR)
+    {
+        if (reader.GetTag() == TLV::ProfileTag(kEventManagementProfile, kFabricIndexTag))
+        {
+            ReturnErrorOnFailure(reader.Get(event.mFabricIndex));
+        }
+    }
+
+    events->push_back(event);
+    return CHIP_NO_ERROR;
+}
+
+std::vector<LoggedEvent> GetEvents(PersistentEventLog & aLog, EventNumber aFirst = 0, EventNumber aEnd = UINT64_MAX)
+{
+    std::vector<LoggedEvent> events;
+    aLog.ForEachEvent(aFirst, aEnd, CollectEvent, &events);
+    return events;
+}
+
+/**
+ * Log an event at aTimeMs, both in system and in epoch time, so that its timestamp is aTimeMs whichever is used.
+ */
+EventNumber LogTestEvent(nlTestSuite * inSuite, TestContext & aContext, PriorityLevel aPriority, uint64_t aTimeMs,
+                         bool aRunEventLoop = true)
+{
+    TestEventGenerator generator;
+    EventOptions options;
+    EventNumber eventNumber = 0;
+
+    gMockClock.SetMonotonic(System::Clock::Milliseconds64(aTimeMs));
+    gMockClock.SetClock_RealTime(System::Clock::Milliseconds64(aTimeMs));
+    options.mPath     = { 1, 0x28, 0 };
+    options.mPriority = aPriority;
+    generator.mValue  = static_cast<uint32_t>(aTimeMs);
+    NL_TEST_ASSERT(inSuite, EventManagement::GetInstance().LogEvent(&generator, options, eventNumber) == CHIP_NO_ERROR);
+
+    // Run the zero delay timer writing a full segment of the log, unless the test holds it back.
+    if (aRunEventLoop)
+    {
+        aContext.GetIOContext().DriveIO();
+    }
+    return eventNumber;
+}
+
+/**
+ * Read the events from aEventMin the way a ReadHandler does, in reports of aReportSize bytes, and reconstruct their timestamps
+ * from the deltas.
+ */
+std::vector<ReportedEvent> FetchEvents(nlTestSuite * inSuite, EventNumber aEventMin = 0, size_t aReportSize = 200)
+{
+    std::vector<ReportedEvent> events;
+    ObjectList<EventPathParams> paths;
+    EventNumber eventMin = aEventMin;
+    CHIP_ERROR err       = CHIP_NO_ERROR;
+
+    do
+    {
+        uint8_t buffer[kMaxTestEventSize * 2];
+        TLV::TLVWriter writer;
+        TLV::TLVReader reader;
+        size_t eventCount = 0;
+        uint64_t previous = 0;
+
+        VerifyOrDie(aReportSize <= sizeof(buffer));
+        writer.Init(buffer, aReportSize);
+        err = EventManagement::GetInstance().FetchEventsSince(writer, &paths, eventMin, eventCount, Access::SubjectDescriptor{});
+        NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR || err == CHIP_ERROR_BUFFER_TOO_SMALL || err == CHIP_ERROR_NO_MEMORY);
+        NL_TEST_ASSERT(inSuite, eventCount > 0 || err == CHIP_NO_ERROR);
+        VerifyOrReturnValue(eventCount > 0, events);
+
+        reader.Init(buffer, writer.GetLengthWritten());
+        while (reader.Next() == CHIP_NO_ERROR)
+        {
+            ReportedEvent event{ 0, 0, true };
+            EventReportIB::Parser report;
+            EventDataIB::Parser data;
+            uint64_t delta = 0;
+            NL_TEST_ASSERT(inSuite, report.Init(reader) == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, report.GetEventData(&data) == CHIP_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, data.GetEventNumber(&event.mEventNumber) == CHIP_NO_ERROR);
+            if (data.GetSystemTimestamp(&event.mTimestamp) != CHIP_NO_ERROR &&
+                data.GetEpochTimestamp(&event.mTimestamp) != CHIP_NO_ERROR)
+            {
+                NL_TEST_ASSERT(inSuite,
+                               data.GetDeltaSystemTimestamp(&delta) == CHIP_NO_ERROR ||
+                                   data.GetDeltaEpochTimestamp(&delta) == CHIP_NO_ERROR);
+                NL_TEST_ASSERT(inSuite, !events.empty());
+                event.mTimestamp         = previous + delta;
+                event.mAbsoluteTimestamp = false;
+            }
+            previous = event.mTimestamp;
+            events.push_back(event);
+        }
+    } while (err != CHIP_NO_ERROR);
+
+    return events;
+}
+
+/**
+ * Check that aEvents are the events numbered from aFirst to aEnd, excluded, and that each one has the timestamp returned by
+ * aTimeOf for its number.  A timestamp is only written as a delta from an earlier one.
+ */
+template <typename TimeOf>
+void CheckEvents(nlTestSuite * inSuite, const std::vector<ReportedEvent> & aEvents, EventNumber aFirst, EventNumber aEnd,
+                 TimeOf aTimeOf)
+{
+    NL_TEST_ASSERT(inSuite, aEvents.size() == aEnd - aFirst);
+    for (size_t i = 0; i < aEvents.size(); i++)
+    {
+        NL_TEST_ASSERT(inSuite, aEvents[i].mEventNumber == aFirst + i);
+        NL_TEST_ASSERT(inSuite, aEvents[i].mTimestamp == aTimeOf(aEvents[i].mEventNumber));
+        NL_TEST_ASSERT(inSuite, aEvents[i].mAbsoluteTimestamp || (i > 0 && aEvents[i].mTimestamp >= aEvents[i - 1].mTimestamp));
+    }
+}
+
+void TestAppendAndReload(nlTestSuite * inSuite, void * inContext)
+{
+    TestPersistentStorageDelegate storage;
+    PersistentEventLog log;
+
+    NL_TEST_ASSERT(inSuite, log.Init(&storage, nullptr) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, storage.HasKey(DefaultStorageKeyAllocator::IMEventLogIndex().KeyName()));
+    NL_TEST_ASSERT(inSuite, !log.IsPersisted(PriorityLevel::Debug));
+    NL_TEST_ASSERT(inSuite, log.IsPersisted(PriorityLevel::Info));
+    NL_TEST_ASSERT(inSuite, log.IsPersisted(PriorityLevel::Critical));
+
+    for (EventNumber eventNumber = 1; eventNumber <= 10; eventNumber++)
+    {
+        NL_TEST_ASSERT(inSuite, AppendEvent(log, eventNumber) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite, AppendEvent(log, 10) == CHIP_ERROR_INVALID_ARGUMENT);
+
+    // The events are staged in RAM until they are flushed, but can be read right away.
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 1);
+    std::vector<LoggedEvent> events = GetEvents(log, 3, 7);
+    NL_TEST_ASSERT(inSuite, events.size() == 4);
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        NL_TEST_ASSERT(inSuite, events[i].mEventNumber == 3 + i);
+    }
+
+    {
+        PersistentEventLog unflushedLog;
+        NL_TEST_ASSERT(inSuite, unflushedLog.Init(&storage, nullptr) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, GetEvents(unflushedLog).empty());
+        unflushedLog.Shutdown();
+    }
+
+    NL_TEST_ASSERT(inSuite, log.Flush() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 2);
+    NL_TEST_ASSERT(inSuite, AppendEvent(log, 11) == CHIP_NO_ERROR);
+    log.Shutdown();
+    NL_TEST_ASSERT(inSuite, AppendEvent(log, 12) == CHIP_ERROR_INCORRECT_STATE);
+
+    PersistentEventLog reloadedLog;
+    NL_TEST_ASSERT(inSuite, reloadedLog.Init(&storage, nullptr) == CHIP_NO_ERROR);
+    events = GetEvents(reloadedLog);
+    NL_TEST_ASSERT(inSuite, events.size() == 11);
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        NL_TEST_ASSERT(inSuite, events[i].mEventNumber == 1 + i);
+    }
+
+    NL_TEST_ASSERT(inSuite, AppendEvent(reloadedLog, 12) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, GetEvents(reloadedLog, 11).size() == 2);
+    reloadedLog.Shutdown();
+}
+
+void TestRotation(nlTestSuite * inSuite, void * inContext)
+{
+    TestPersistentStorageDelegate storage;
+    PersistentEventLog log;
+    const EventNumber lastEventNumber = 2 * PersistentEventLog::kSegmentCount * PersistentEventLog::kSegmentSize / kPayloadSize;
+
+    NL_TEST_ASSERT(inSuite, log.Init(&storage, nullptr) == CHIP_NO_ERROR);
+    for (EventNumber eventNumber = 1; eventNumber <= lastEventNumber; eventNumber++)
+    {
+        NL_TEST_ASSERT(inSuite, AppendEvent(log, eventNumber, kUndefinedFabricIndex, kPayloadSize) == CHIP_NO_ERROR);
+    }
+
+    // The oldest segments were deleted, and the newest events are kept.
+    NL_TEST_ASSERT(inSuite, log.Flush() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 1 + PersistentEventLog::kSegmentCount);
+    std::vector<LoggedEvent> events = GetEvents(log);
+    NL_TEST_ASSERT(inSuite, !events.empty() && events.size() < lastEventNumber);
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        NL_TEST_ASSERT(inSuite, events[i].mEventNumber == lastEventNumber - events.size() + 1 + i);
+    }
+    log.Shutdown();
+
+    PersistentEventLog reloadedLog;
+    NL_TEST_ASSERT(inSuite, reloadedLog.Init(&storage, nullptr) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, GetEvents(reloadedLog).size() == events.size());
+    NL_TEST_ASSERT(inSuite, GetEvents(reloadedLog, 0, lastEventNumber).size() == events.size() - 1);
+    reloadedLog.Shutdown();
+}
+
+void TestFabricRemoved(nlTestSuite * inSuite, void * inContext)
+{
+    TestPersistentStorageDelegate storage;
+    PersistentEventLog log;
+    const EventNumber lastEventNumber = PersistentEventLog::kSegmentSize / kPayloadSize;
+
+    NL_TEST_ASSERT(inSuite, log.Init(&storage, nullptr) == CHIP_NO_ERROR);
+    for (EventNumber eventNumber = 1; eventNumber <= lastEventNumber; eventNumber++)
+    {
+        const FabricIndex fabricIndex = static_cast<FabricIndex>(eventNumber % 3);
+        NL_TEST_ASSERT(inSuite, AppendEvent(log, eventNumber, fabricIndex, kPayloadSize) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() >= 2);
+
+    NL_TEST_ASSERT(inSuite, log.FabricRemoved(1) == CHIP_NO_ERROR);
+    log.Shutdown();
+
+    PersistentEventLog reloadedLog;
+    NL_TEST_ASSERT(inSuite, reloadedLog.Init(&storage, nullptr) == CHIP_NO_ERROR);
+    std::vector<LoggedEvent> events = GetEvents(reloadedLog);
+    NL_TEST_ASSERT(inSuite, events.size() == lastEventNumber);
+    for (const LoggedEvent & event : events)
+    {
+        const FabricIndex expected = (event.mEventNumber % 3 == 2) ? 2 : kUndefinedFabricIndex;
+        NL_TEST_ASSERT(inSuite, event.mFabricIndex == expected);
+    }
+    reloadedLog.Shutdown();
+}
+
+void TestUnreadableSegment(nlTestSuite * inSuite, void * inContext)
+{
+    TestPersistentStorageDelegate storage;
+    PersistentEventLog log;
+    const EventNumber lastEventNumber = PersistentEventLog::kSegmentSize / kPayloadSize;
+
+    NL_TEST_ASSERT(inSuite, log.Init(&storage, nullptr) == CHIP_NO_ERROR);
+    for (EventNumber eventNumber = 1; eventNumber <= lastEventNumber; eventNumber++)
+    {
+        NL_TEST_ASSERT(inSuite, AppendEvent(log, eventNumber, kUndefinedFabricIndex, kPayloadSize) == CHIP_NO_ERROR);
+    }
+    std::vector<LoggedEvent> events = GetEvents(log);
+    NL_TEST_ASSERT(inSuite, events.size() == lastEventNumber);
+
+    // The events of a segment that cannot be read are skipped.
+    storage.AddPoisonKey(DefaultStorageKeyAllocator::IMEventLogSegment(0).KeyName());
+    std::vector<LoggedEvent> remaining = GetEvents(log);
+    NL_TEST_ASSERT(inSuite, !remaining.empty() && remaining.size() < events.size());
+    NL_TEST_ASSERT(inSuite, remaining.back().mEventNumber == lastEventNumber);
+    storage.ClearPoisonKeys();
+    log.Shutdown();
+}
+
+void TestDeferredRotation(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    TestPersistentStorageDelegate storage;
+    PersistentEventLog log;
+    // More events than fit in a segment.
+    const EventNumber eventsPerSegment = PersistentEventLog::kSegmentSize / kPayloadSize;
+    EventNumber eventNumber            = 1;
+    CHIP_ERROR err                     = CHIP_NO_ERROR;
+
+    NL_TEST_ASSERT(inSuite, log.Init(&storage, &ctx.GetSystemLayer()) == CHIP_NO_ERROR);
+    for (; eventNumber <= eventsPerSegment; eventNumber++)
+    {
+        NL_TEST_ASSERT(inSuite, AppendEvent(log, eventNumber, kUndefinedFabricIndex, kPayloadSize) == CHIP_NO_ERROR);
+    }
+
+    // The full segment is sealed rather than written by Append, and its events can still be read.
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 1);
+    NL_TEST_ASSERT(inSuite, GetEvents(log).size() == eventsPerSegment);
+
+    // Once the next segment is full too, events cannot be appended until the sealed one is written.
+    while (eventNumber <= 3 * eventsPerSegment &&
+           (err = AppendEvent(log, eventNumber, kUndefinedFabricIndex, kPayloadSize)) == CHIP_NO_ERROR)
+    {
+        eventNumber++;
+    }
+    NL_TEST_ASSERT(inSuite, err == CHIP_ERROR_NO_MEMORY);
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 1);
+    NL_TEST_ASSERT(inSuite, log.GetNextEventNumber() == eventNumber);
+
+    // The event loop writes the sealed segment and the index, and leaves the open one staged.
+    ctx.GetIOContext().DriveIO();
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 2);
+    NL_TEST_ASSERT(inSuite, storage.HasKey(DefaultStorageKeyAllocator::IMEventLogSegment(0).KeyName()));
+    NL_TEST_ASSERT(inSuite, AppendEvent(log, eventNumber, kUndefinedFabricIndex, kPayloadSize) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, GetEvents(log).size() == eventNumber);
+
+    // The oldest segment is deleted along with the write of the segment it made room for.
+    for (eventNumber++; eventNumber <= (PersistentEventLog::kSegmentCount + 1) * eventsPerSegment; eventNumber++)
+    {
+        NL_TEST_ASSERT(inSuite, AppendEvent(log, eventNumber, kUndefinedFabricIndex, kPayloadSize) == CHIP_NO_ERROR);
+        ctx.GetIOContext().DriveIO();
+    }
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == PersistentEventLog::kSegmentCount);
+    NL_TEST_ASSERT(inSuite, !storage.HasKey(DefaultStorageKeyAllocator::IMEventLogSegment(0).KeyName()));
+
+    // The open segment is written after the flush delay.
+    gMockClock.AdvanceMonotonic(System::Clock::Milliseconds64(CHIP_CONFIG_PERSISTENT_EVENT_LOG_FLUSH_DELAY_MS));
+    ctx.GetIOContext().DriveIO();
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 1 + PersistentEventLog::kSegmentCount);
+
+    const std::vector<LoggedEvent> events = GetEvents(log);
+    NL_TEST_ASSERT(inSuite, !events.empty() && events.back().mEventNumber == eventNumber - 1);
+    log.Shutdown();
+
+    PersistentEventLog reloadedLog;
+    NL_TEST_ASSERT(inSuite, reloadedLog.Init(&storage, nullptr) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, GetEvents(reloadedLog).size() == events.size());
+    reloadedLog.Shutdown();
+}
+
+void TestFetchPersistedAndBufferedEvents(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    TestPersistentStorageDelegate storage;
+    PersistentEventLog log;
+    constexpr EventNumber kEventCount = 100;
+    std::vector<uint64_t> times;
+    auto timeOf = [&times](EventNumber aEventNumber) { return times[aEventNumber]; };
+
+    ctx.CreateEventManagement(0);
+    NL_TEST_ASSERT(inSuite, log.Init(&storage, &ctx.GetSystemLayer()) == CHIP_NO_ERROR);
+    EventManagement::GetInstance().SetPersistentEventLog(&log);
+
+    // The buffers only hold the newest events: the older ones are read from the log, and each event is read once.
+    for (EventNumber i = 0; i < kEventCount; i++)
+    {
+        times.push_back(1000000 + 10 * i);
+        LogTestEvent(inSuite, ctx, (i % 10 == 0) ? PriorityLevel::Critical : PriorityLevel::Info, times.back());
+    }
+    CheckEvents(inSuite, FetchEvents(inSuite), 0, kEventCount, timeOf);
+    CheckEvents(inSuite, FetchEvents(inSuite, 50), 50, kEventCount, timeOf);
+    CheckEvents(inSuite, FetchEvents(inSuite, 0, 2 * kMaxTestEventSize), 0, kEventCount, timeOf);
+    CheckEvents(inSuite, FetchEvents(inSuite, kEventCount - 1), kEventCount - 1, kEventCount, timeOf);
+
+    EventManagement::GetInstance().SetPersistentEventLog(nullptr);
+    EventManagement::DestroyEventManagement();
+    log.Shutdown();
+}
+
+void TestFailedAppend(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    TestPersistentStorageDelegate storage;
+    PersistentEventLog log;
+    std::vector<uint64_t> times;
+    EventNumber failedEventNumber = 0;
+    auto timeOf                   = [&times](EventNumber aEventNumber) { return times[aEventNumber]; };
+
+    ctx.CreateEventManagement(0);
+    NL_TEST_ASSERT(inSuite, log.Init(&storage, &ctx.GetSystemLayer()) == CHIP_NO_ERROR);
+    EventManagement::GetInstance().SetPersistentEventLog(&log);
+
+    // Hold the sealed segment back, by not running the event loop, until an event cannot be appended.
+    do
+    {
+        times.push_back(1000000 + 10 * times.size());
+        failedEventNumber = LogTestEvent(inSuite, ctx, PriorityLevel::Info, times.back(), false /* aRunEventLoop */);
+    } while (log.GetNextEventNumber() == failedEventNumber + 1 && times.size() < 1000);
+    NL_TEST_ASSERT(inSuite, log.GetNextEventNumber() == failedEventNumber);
+
+    // Neither is the Critical event logged next.  The Info events logged after it drop the oldest events that were not
+    // appended from the buffers, but not the Critical one.
+    times.push_back(1000000 + 10 * times.size());
+    const EventNumber criticalEventNumber =
+        LogTestEvent(inSuite, ctx, PriorityLevel::Critical, times.back(), false /* aRunEventLoop */);
+    EventNumber lastEventNumber = criticalEventNumber;
+    for (size_t i = 0; i < kEventBufferSize / 10; i++)
+    {
+        times.push_back(1000000 + 10 * times.size());
+        lastEventNumber = LogTestEvent(inSuite, ctx, PriorityLevel::Info, times.back(), false /* aRunEventLoop */);
+    }
+    NL_TEST_ASSERT(inSuite, log.GetNextEventNumber() == failedEventNumber);
+
+    // The appended events are read from the log, and the others from the buffers, as long as they hold them.
+    auto checkEvents = [&]() {
+        const std::vector<ReportedEvent> events = FetchEvents(inSuite);
+        NL_TEST_ASSERT(inSuite, events.size() > failedEventNumber + 1);
+        VerifyOrReturn(events.size() > failedEventNumber + 1);
+        CheckEvents(inSuite, std::vector<ReportedEvent>(events.begin(), events.begin() + failedEventNumber), 0,
+                    failedEventNumber, timeOf);
+        bool hasCriticalEvent = false;
+        for (size_t i = failedEventNumber; i < events.size(); i++)
+        {
+            NL_TEST_ASSERT(inSuite, events[i].mEventNumber > events[i - 1].mEventNumber);
+            NL_TEST_ASSERT(inSuite, events[i].mTimestamp == timeOf(events[i].mEventNumber));
+            hasCriticalEvent = hasCriticalEvent || events[i].mEventNumber == criticalEventNumber;
+        }
+        NL_TEST_ASSERT(inSuite, hasCriticalEvent);
+        NL_TEST_ASSERT(inSuite, events.back().mEventNumber == lastEventNumber);
+    };
+    checkEvents();
+
+    // Once the sealed segment is written, the buffered events are appended along with the next event.
+    ctx.GetIOContext().DriveIO();
+    times.push_back(1000000 + 10 * times.size());
+    lastEventNumber = LogTestEvent(inSuite, ctx, PriorityLevel::Info, times.back());
+    NL_TEST_ASSERT(inSuite, log.GetNextEventNumber() == lastEventNumber + 1);
+    NL_TEST_ASSERT(inSuite, GetEvents(log, criticalEventNumber, criticalEventNumber + 1).size() == 1);
+    checkEvents();
+
+    EventManagement::GetInstance().SetPersistentEventLog(nullptr);
+    EventManagement::DestroyEventManagement();
+    log.Shutdown();
+}
+
+void TestSetPersistentEventLog(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    TestPersistentStorageDelegate storage;
+    PersistentEventLog log;
+    constexpr EventNumber kEventCount = 100;
+    std::vector<uint64_t> times;
+    auto timeOf = [&times](EventNumber aEventNumber) { return times[aEventNumber]; };
+
+    ctx.CreateEventManagement(0);
+    for (EventNumber i = 0; i < 3; i++)
+    {
+        times.push_back(1000000 + 10 * i);
+        LogTestEvent(inSuite, ctx, PriorityLevel::Info, times.back());
+    }
+
+    // The events logged before the log was set are read from the buffers, until they are appended along with the next event.
+    NL_TEST_ASSERT(inSuite, log.Init(&storage, &ctx.GetSystemLayer()) == CHIP_NO_ERROR);
+    EventManagement::GetInstance().SetPersistentEventLog(&log);
+    NL_TEST_ASSERT(inSuite, log.GetNextEventNumber() == 0);
+    CheckEvents(inSuite, FetchEvents(inSuite), 0, 3, timeOf);
+
+    times.push_back(1000000 + 10 * times.size());
+    LogTestEvent(inSuite, ctx, PriorityLevel::Info, times.back());
+    NL_TEST_ASSERT(inSuite, log.GetFirstEventNumber() == 0);
+    NL_TEST_ASSERT(inSuite, log.GetNextEventNumber() == 4);
+
+    while (times.size() < kEventCount)
+    {
+        times.push_back(1000000 + 10 * times.size());
+        LogTestEvent(inSuite, ctx, PriorityLevel::Info, times.back());
+    }
+    CheckEvents(inSuite, FetchEvents(inSuite), 0, kEventCount, timeOf);
+
+    EventManagement::GetInstance().SetPersistentEventLog(nullptr);
+    EventManagement::DestroyEventManagement();
+    log.Shutdown();
+}
+
+void TestReportAfterReboot(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(inContext);
+    TestPersistentStorageDelegate storage;
+    constexpr EventNumber kEventCount = 60;
+    std::vector<uint64_t> times;
+    auto timeOf = [&times](EventNumber aEventNumber) { return times[aEventNumber]; };
+
+    {
+        PersistentEventLog log;
+        ctx.CreateEventManagement(0);
+        NL_TEST_ASSERT(inSuite, log.Init(&storage, &ctx.GetSystemLayer()) == CHIP_NO_ERROR);
+        EventManagement::GetInstance().SetPersistentEventLog(&log);
+        while (times.size() < kEventCount)
+        {
+            times.push_back(1000000 + 10 * times.size());
+            LogTestEvent(inSuite, ctx, PriorityLevel::Info, times.back());
+        }
+        EventManagement::GetInstance().SetPersistentEventLog(nullptr);
+        EventManagement::DestroyEventManagement();
+        log.Shutdown();
+    }
+
+    // After the reboot, the buffers are empty and the clock starts over, while the event numbers carry on.
+    PersistentEventLog log;
+    ctx.CreateEventManagement(kEventCount);
+    NL_TEST_ASSERT(inSuite, log.Init(&storage, &ctx.GetSystemLayer()) == CHIP_NO_ERROR);
+    EventManagement::GetInstance().SetPersistentEventLog(&log);
+    for (size_t i = 0; i < 5; i++)
+    {
+        times.push_back(100 + 10 * i);
+        LogTestEvent(inSuite, ctx, PriorityLevel::Info, times.back());
+    }
+    // The clock is set back within a boot too.
+    times.push_back(50);
+    LogTestEvent(inSuite, ctx, PriorityLevel::Info, times.back());
+
+    // The timestamps of the persisted events, and of the events read after one from another boot or with a later time, are
+    // absolute.
+    const EventNumber end = times.size();
+    CheckEvents(inSuite, FetchEvents(inSuite), 0, end, timeOf);
+    const std::vector<ReportedEvent> events = FetchEvents(inSuite, kEventCount - 2, 2 * kMaxTestEventSize);
+    CheckEvents(inSuite, events, kEventCount - 2, end, timeOf);
+    NL_TEST_ASSERT(inSuite, events.size() == end - kEventCount + 2);
+    VerifyOrReturn(events.size() == end - kEventCount + 2);
+    NL_TEST_ASSERT(inSuite, events[1].mAbsoluteTimestamp);
+    NL_TEST_ASSERT(inSuite, events[2].mAbsoluteTimestamp);
+    NL_TEST_ASSERT(inSuite, !events[3].mAbsoluteTimestamp);
+    NL_TEST_ASSERT(inSuite, events.back().mAbsoluteTimestamp);
+
+    EventManagement::GetInstance().SetPersistentEventLog(nullptr);
+    EventManagement::DestroyEventManagement();
+    log.Shutdown();
+}
+
+// Test Suite
+
+/**
+ *  Test Suite that lists all the test functions.
+ */
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("TestAppendAndReload", TestAppendAndReload),
+    NL_TEST_DEF("TestRotation", TestRotation),
+    NL_TEST_DEF("TestFabricRemoved", TestFabricRemoved),
+    NL_TEST_DEF("TestUnreadableSegment", TestUnreadableSegment),
+    NL_TEST_DEF("TestDeferredRotation", TestDeferredRotation),
+    NL_TEST_DEF("TestFetchPersistedAndBufferedEvents", TestFetchPersistedAndBufferedEvents),
+    NL_TEST_DEF("TestFailedAppend", TestFailedAppend),
+    NL_TEST_DEF("TestSetPersistentEventLog", TestSetPersistentEventLog),
+    NL_TEST_DEF("TestReportAfterReboot", TestReportAfterReboot),
+
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+// clang-format off
+static nlTestSuite sSuite =
+{
+    "Test-CHIP-PersistentEventLog",
+    &sTests[0],
+    TestContext::Initialize,
+    TestContext::Finalize
+};
+// clang-format on
+
+} // namespace
+
+/**
+ *  Main
+ */
+int TestPersistentEventLog()
+{
+    return chip::ExecuteTestsWithContext<TestContext>(&sSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestPersistentEventLog)
@@ -361,6 +361,9 @@ public:
     static void TestReadWildcard(nlTestSuite * apSuite, void * apContext);
     static void TestReadChunking(nlTestSuite * apSuite, void * apContext);
     static void TestSetDirtyBetweenChunks(nlTestSuite * apSuite, void * apContext);
+#if CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
+    static void TestReadChunkingPendingAttributeReports(nlTestSuite * apSuite, void * apContext);
+#endif // CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
     static void TestSubscribeRoundtrip(nlTestSuite * apSuite, void * apContext);
     static void TestSubscribeEarlyReport(nlTestSuite * apSuite, void * apContext);
     static void TestSubscribeUrgentWildcardEvent(nlTestSuite * apSuite, void * apContext);
@@ -1312,6 +1315,151 @@ void TestReadInteraction::TestReadChunking(nlTestSuite * apSuite, void * apConte
     NL_TEST_ASSERT(apSuite, ctx.GetExchangeManager().GetNumActiveExchanges() == 0);
 }
 
+#if CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
+void TestReadInteraction::TestReadChunkingPendingAttributeReports(nlTestSuite * apSuite, void * apContext)
+{
+    TestContext & ctx = *static_cast<TestContext *>(apContext);
+    CHIP_ERROR err    = CHIP_NO_ERROR;
+
+    Messaging::ReliableMessageMgr * rm = ctx.GetExchangeManager().GetReliableMessageMgr();
+    // Shouldn't have anything in the retransmit table when starting the test.
+    NL_TEST_ASSERT(apSuite, rm->TestGetCountRetransTable() == 0);
+
+    auto * engine = chip::app::InteractionModelEngine::GetInstance();
+    err           = engine->Init(&ctx.GetExchangeManager(), &ctx.GetFabricTable(), app::reporting::GetDefaultReportScheduler());
+    NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+
+    chip::app::AttributePathParams attributePathParams[1];
+    // Mock Attribute 4 is a big attribute, with kMockAttribute4ListLength large
+    // OCTET_STRING elements.
+    attributePathParams[0].mEndpointId  = Test::kMockEndpoint3;
+    attributePathParams[0].mClusterId   = Test::MockClusterId(2);
+    attributePathParams[0].mAttributeId = Test::MockAttributeId(4);
+
+    ReadPrepareParams readPrepareParams(ctx.GetSessionBobToAlice());
+    readPrepareParams.mpEventPathParamsList        = nullptr;
+    readPrepareParams.mEventPathParamsListSize     = 0;
+    readPrepareParams.mpAttributePathParamsList    = attributePathParams;
+    readPrepareParams.mAttributePathParamsListSize = 1;
+
+    // The list items that did not fit in the first chunk are encoded ahead into the read handler, and the following chunks
+    // send them from there.
+    {
+        class PendingReportsMockDelegate : public MockInteractionModelApp
+        {
+        public:
+            bool mHadPendingReportsAfterFirstChunk = false;
+
+        private:
+            void OnAttributeData(const ConcreteDataAttributePath & aPath, TLV::TLVReader * apData, const StatusIB & status) override
+            {
+                MockInteractionModelApp::OnAttributeData(aPath, apData, status);
+                if (mNumAttributeResponse == 1)
+                {
+                    ReadHandler * handler             = InteractionModelEngine::GetInstance()->ActiveHandlerAt(0);
+                    mHadPendingReportsAfterFirstChunk = handler != nullptr && handler->HasPendingAttributeReports();
+                }
+            }
+        };
+
+        PendingReportsMockDelegate delegate;
+        app::ReadClient readClient(chip::app::InteractionModelEngine::GetInstance(), &ctx.GetExchangeManager(), delegate,
+                                   chip::app::ReadClient::InteractionType::Read);
+
+        err = readClient.SendRequest(readPrepareParams);
+        NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+
+        ctx.DrainAndServiceIO();
+
+        NL_TEST_ASSERT(apSuite, delegate.mHadPendingReportsAfterFirstChunk);
+        NL_TEST_ASSERT(apSuite, delegate.mNumArrayItems == kMockAttribute4ListLength);
+        NL_TEST_ASSERT(apSuite, delegate.mGotReport);
+        NL_TEST_ASSERT(apSuite, !delegate.mReadError);
+        NL_TEST_ASSERT(apSuite, engine->GetNumActiveReadHandlers() == 0);
+        NL_TEST_ASSERT(apSuite, rm->TestGetCountRetransTable() == 0);
+    }
+
+    // The pending reports are released with the read handler when the read is abandoned between chunks.
+    {
+        MockInteractionModelApp delegate;
+        app::ReadClient readClient(chip::app::InteractionModelEngine::GetInstance(), &ctx.GetExchangeManager(), delegate,
+                                   chip::app::ReadClient::InteractionType::Read);
+
+        // Let the read request and the first chunk through, and drop the status response to the first chunk.
+        ctx.GetLoopback().mNumMessagesToAllowBeforeDropping = 2;
+        ctx.GetLoopback().mNumMessagesToDrop                = 1;
+
+        err = readClient.SendRequest(readPrepareParams);
+        NL_TEST_ASSERT(apSuite, err == CHIP_NO_ERROR);
+
+        ctx.DrainAndServiceIO();
+
+        NL_TEST_ASSERT(apSuite, ctx.GetLoopback().mDroppedMessageCount == 1);
+        NL_TEST_ASSERT(apSuite, engine->GetNumActiveReadHandlers() == 1);
+        ReadHandler * handler = engine->ActiveHandlerAt(0);
+        NL_TEST_ASSERT(apSuite, handler != nullptr && handler->HasPendingAttributeReports());
+
+        System::PacketBufferHandle pendingReports;
+        if (handler != nullptr && handler->HasPendingAttributeReports())
+        {
+            pendingReports = handler->mPendingAttributeReports.Retain();
+            NL_TEST_ASSERT(apSuite, !pendingReports.HasSoleOwnership());
+        }
+
+        ctx.ExpireSessionAliceToBob();
+        ctx.DrainAndServiceIO();
+        ctx.ExpireSessionBobToAlice();
+
+        NL_TEST_ASSERT(apSuite, engine->GetNumActiveReadHandlers() == 0);
+        NL_TEST_ASSERT(apSuite, !pendingReports.IsNull() && pendingReports.HasSoleOwnership());
+        NL_TEST_ASSERT(apSuite, engine->GetReportingEngine().GetNumReportsInFlight() == 0);
+
+        // The pending reports are an anonymous array of AttributeReportIBs, one per list item that did not fit the first chunk.
+        if (!pendingReports.IsNull())
+        {
+            System::TLVPacketBufferBackingStore backingStore(pendingReports.Retain(), /* useChainedBuffers = */ true);
+            TLV::TLVReader reader;
+            reader.Init(backingStore);
+            NL_TEST_ASSERT(apSuite, reader.Next(TLV::kTLVType_Array, TLV::AnonymousTag()) == CHIP_NO_ERROR);
+
+            AttributeReportIBs::Parser reportsParser;
+            NL_TEST_ASSERT(apSuite, reportsParser.Init(reader) == CHIP_NO_ERROR);
+            reportsParser.GetReader(&reader);
+
+            size_t numReports = 0;
+            while ((err = reader.Next()) == CHIP_NO_ERROR)
+            {
+                AttributeReportIB::Parser reportParser;
+                AttributeDataIB::Parser dataParser;
+                AttributePathIB::Parser pathParser;
+                ConcreteDataAttributePath path;
+                NL_TEST_ASSERT(apSuite, reportParser.Init(reader) == CHIP_NO_ERROR);
+                NL_TEST_ASSERT(apSuite, reportParser.GetAttributeData(&dataParser) == CHIP_NO_ERROR);
+                NL_TEST_ASSERT(apSuite, dataParser.GetPath(&pathParser) == CHIP_NO_ERROR);
+                NL_TEST_ASSERT(apSuite, pathParser.GetConcreteAttributePath(path) == CHIP_NO_ERROR);
+                NL_TEST_ASSERT(apSuite, path.mEndpointId == Test::kMockEndpoint3);
+                NL_TEST_ASSERT(apSuite, path.mAttributeId == Test::MockAttributeId(4));
+                NL_TEST_ASSERT(apSuite, path.IsListItemOperation());
+                numReports++;
+            }
+            NL_TEST_ASSERT(apSuite, err == CHIP_END_OF_TLV);
+            NL_TEST_ASSERT(apSuite, numReports > 0 && numReports < kMockAttribute4ListLength);
+        }
+        NL_TEST_ASSERT(apSuite, rm->TestGetCountRetransTable() == 0);
+
+        ctx.GetLoopback().mNumMessagesToAllowBeforeDropping = 0;
+        ctx.GetLoopback().mNumMessagesToDrop                = 0;
+        ctx.GetLoopback().mDroppedMessageCount              = 0;
+    }
+
+    NL_TEST_ASSERT(apSuite, engine->GetNumActiveReadClients() == 0);
+    engine->Shutdown();
+    NL_TEST_ASSERT(apSuite, ctx.GetExchangeManager().GetNumActiveExchanges() == 0);
+    ctx.CreateSessionAliceToBob();
+    ctx.CreateSessionBobToAlice();
+}
+#endif // CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
+
 void TestReadInteraction::TestSetDirtyBetweenChunks(nlTestSuite * apSuite, void * apContext)
 {
     TestContext & ctx = *static_cast<TestContext *>(apContext);
@@ -4971,6 +5119,9 @@ const nlTest sTests[] = {
     NL_TEST_DEF("TestReadWildcard", chip::app::TestReadInteraction::TestReadWildcard),
     NL_TEST_DEF("TestReadChunking", chip::app::TestReadInteraction::TestReadChunking),
     NL_TEST_DEF("TestSetDirtyBetweenChunks", chip::app::TestReadInteraction::TestSetDirtyBetweenChunks),
+#if CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
+    NL_TEST_DEF("TestReadChunkingPendingAttributeReports", chip::app::TestReadInteraction::TestReadChunkingPendingAttributeReports),
+#endif // CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE > 0
     NL_TEST_DEF("CheckReadClient", chip::app::TestReadInteraction::TestReadClient),
     NL_TEST_DEF("TestReadUnexpectedSubscriptionId", chip::app::TestReadInteraction::TestReadUnexpectedSubscriptionId),
     NL_TEST_DEF("CheckReadHandler", chip::app::TestReadInteraction::TestReadHandler),
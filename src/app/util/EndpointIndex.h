@@ -0,0 +1,137 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/support/CodeUtils.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace app {
+
+/**
+ * Maps endpoint ids to their index in the endpoint array of the attribute storage.
+ *
+ * The entries are kept sorted by endpoint id, then by index, so that a lookup is a binary search instead of a scan of
+ * the whole endpoint array.  Adding or removing an endpoint shifts the entries after it, which is cheap next to the
+ * lookups done for every attribute access.
+ *
+ * The same endpoint id may be recorded at several indices; lookups consider them in index order, as the scan of the
+ * endpoint array did.  Whether an endpoint is enabled is not recorded here, and is left to the caller to check.
+ */
+template <size_t kCapacity>
+class EndpointIndex
+{
+public:
+    static constexpr uint16_t kInvalidIndex = 0xFFFF;
+
+    void Clear() { mCount = 0; }
+
+    size_t Count() const { return mCount; }
+
+    /**
+     * Record that the given endpoint is at the given index of the endpoint array.
+     */
+    CHIP_ERROR Insert(EndpointId endpoint, uint16_t index)
+    {
+        VerifyOrReturnError(mCount < kCapacity, CHIP_ERROR_NO_MEMORY);
+
+        size_t position = LowerBound(endpoint, index);
+        for (size_t i = mCount; i > position; i--)
+        {
+            mEntries[i] = mEntries[i - 1];
+        }
+        mEntries[position] = { endpoint, index };
+        mCount++;
+        return CHIP_NO_ERROR;
+    }
+
+    /**
+     * Forget the given endpoint at the given index of the endpoint array, if it was recorded.
+     */
+    void Remove(EndpointId endpoint, uint16_t index)
+    {
+        size_t position = LowerBound(endpoint, index);
+        VerifyOrReturn(position < mCount && mEntries[position].endpoint == endpoint && mEntries[position].index == index);
+
+        mCount--;
+        for (size_t i = position; i < mCount; i++)
+        {
+            mEntries[i] = mEntries[i + 1];
+        }
+    }
+
+    /**
+     * Returns the lowest index of the given endpoint for which `accept(index)` is true, or kInvalidIndex if there is
+     * none.
+     */
+    template <typename Predicate>
+    uint16_t Find(EndpointId endpoint, Predicate && accept) const
+    {
+        for (size_t i = LowerBound(endpoint, 0); i < mCount && mEntries[i].endpoint == endpoint; i++)
+        {
+            if (accept(mEntries[i].index))
+            {
+                return mEntries[i].index;
+            }
+        }
+        return kInvalidIndex;
+    }
+
+    uint16_t Find(EndpointId endpoint) const
+    {
+        return Find(endpoint, [](uint16_t) { return true; });
+    }
+
+private:
+    struct Entry
+    {
+        EndpointId endpoint;
+        uint16_t index;
+    };
+
+    // Position of the first entry that is not before (endpoint, index).
+    size_t LowerBound(EndpointId endpoint, uint16_t index) const
+    {
+        size_t low  = 0;
+        size_t high = mCount;
+        while (low < high)
+        {
+            size_t middle       = low + (high - low) / 2;
+            const Entry & entry = mEntries[middle];
+            if (entry.endpoint < endpoint || (entry.endpoint == endpoint && entry.index < index))
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+    Entry mEntries[kCapacity];
+    size_t mCount = 0;
+};
+
+} // namespace app
+} // namespace chip
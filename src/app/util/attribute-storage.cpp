@@ -19,6 +19,7 @@
 #include <app/AttributePersistenceProvider.h>
 #include <app/InteractionModelEngine.h>
 #include <app/reporting/reporting.h>
+#include <app/util/EndpointIndex.h>
 #include <app/util/af.h>
 #include <app/util/attribute-storage.h>
 #include <app/util/config.h>
@@ -67,6 +68,15 @@ uint8_t singletonAttributeData[ACTUAL_SINGLETONS_SIZE];
 
 uint16_t emberEndpointCount = 0;
 
+// Index of emAfEndpoints by endpoint id, kept in sync with the endpoint ids of the entries.
+EndpointIndex<MAX_ENDPOINT_COUNT> endpointIndex;
+// Its lookups are returned as is by the functions below.
+static_assert(EndpointIndex<MAX_ENDPOINT_COUNT>::kInvalidIndex == kEmberInvalidEndpointIndex,
+              "EndpointIndex and the ember functions must agree on the invalid endpoint index");
+
+// Offset in attributeData of the attributes of each fixed endpoint.  Dynamic endpoints store their attributes externally.
+uint16_t fixedEndpointStorageOffsets[FIXED_ENDPOINT_COUNT + 1];
+
 // If we have attributes that are more than 4 bytes, then
 // we need this data block for the defaults
 #if (defined(GENERATED_DEFAULTS) && GENERATED_DEFAULTS_COUNT)
@@ -187,6 +197,8 @@ void emberAfEndpointConfigure()
 
     emberEndpointCount                = FIXED_ENDPOINT_COUNT;
     DataVersion * currentDataVersions = fixedEndpointDataVersions;
+    uint16_t currentStorageOffset     = 0;
+    endpointIndex.Clear();
     for (ep = 0; ep < FIXED_ENDPOINT_COUNT; ep++)
     {
         emAfEndpoints[ep].endpoint       = endpointNumber(ep);
@@ -200,6 +212,13 @@ void emberAfEndpointConfigure()
         // Increment currentDataVersions by 1 (slot) for every server cluster
         // this endpoint has.
         currentDataVersions += emberAfClusterCountByIndex(ep, /* server = */ true);
+
+        fixedEndpointStorageOffsets[ep] = currentStorageOffset;
+        currentStorageOffset =
+            static_cast<uint16_t>(currentStorageOffset + emAfEndpoints[ep].endpointType->endpointSize);
+
+        // Cannot fail: the index has room for all the endpoints.
+        VerifyOrDie(endpointIndex.Insert(emAfEndpoints[ep].endpoint, ep) == CHIP_NO_ERROR);
     }
 
 #if CHIP_DEVICE_CONFIG_DYNAMIC_ENDPOINT_COUNT
@@ -261,15 +280,18 @@ EmberAfStatus emberAfSetDynamicEndpoint(uint16_t index, EndpointId id, const Emb
     }
 
     index = static_cast<uint16_t>(realIndex);
-    for (uint16_t i = FIXED_ENDPOINT_COUNT; i < MAX_ENDPOINT_COUNT; i++)
+    if (endpointIndex.Find(id, [](uint16_t i) { return i >= emberAfFixedEndpointCount(); }) != kEmberInvalidEndpointIndex)
     {
-        if (emAfEndpoints[i].endpoint == id)
-        {
-            return EMBER_ZCL_STATUS_DUPLICATE_EXISTS;
-        }
+        return EMBER_ZCL_STATUS_DUPLICATE_EXISTS;
+    }
+
+    if (emAfEndpoints[index].endpoint != kInvalidEndpointId)
+    {
+        endpointIndex.Remove(emAfEndpoints[index].endpoint, index);
     }
+    emAfEndpoints[index].endpoint = id;
+    VerifyOrDie(endpointIndex.Insert(id, index) == CHIP_NO_ERROR);
 
-    emAfEndpoints[index].endpoint       = id;
     emAfEndpoints[index].deviceTypeList = deviceTypeList;
     emAfEndpoints[index].endpointType   = ep;
     emAfEndpoints[index].dataVersions   = dataVersionStorage.data();
@@ -308,6 +330,7 @@ EndpointId emberAfClearDynamicEndpoint(uint16_t index)
         ep = emAfEndpoints[index].endpoint;
         emberAfEndpointEnableDisable(ep, false);
         emAfEndpoints[index].endpoint = kInvalidEndpointId;
+        endpointIndex.Remove(ep, index);
     }
 
     return ep;
@@ -572,117 +595,103 @@ EmberAfStatus emAfReadOrWriteAttribute(EmberAfAttributeSearchRecord * attRecord,
 {
     assertChipStackLockedByCurrentThread();
 
-    uint16_t attributeOffsetIndex = 0;
-
-    for (uint16_t ep = 0; ep < emberAfEndpointCount(); ep++)
+    uint16_t ep = emberAfIndexFromEndpoint(attRecord->endpoint);
+    if (ep == kEmberInvalidEndpointIndex)
     {
-        // Is this a dynamic endpoint?
-        bool isDynamicEndpoint = (ep >= emberAfFixedEndpointCount());
+        return EMBER_ZCL_STATUS_UNSUPPORTED_ENDPOINT; // Sorry, endpoint was not found.
+    }
 
-        if (emAfEndpoints[ep].endpoint == attRecord->endpoint)
-        {
-            const EmberAfEndpointType * endpointType = emAfEndpoints[ep].endpointType;
-            uint8_t clusterIndex;
-            if (!emberAfEndpointIndexIsEnabled(ep))
-            {
-                continue;
-            }
-            for (clusterIndex = 0; clusterIndex < endpointType->clusterCount; clusterIndex++)
+    // Is this a dynamic endpoint?
+    bool isDynamicEndpoint = (ep >= emberAfFixedEndpointCount());
+
+    // Dynamic endpoints are external and don't factor into storage size
+    uint16_t attributeOffsetIndex = isDynamicEndpoint ? 0 : fixedEndpointStorageOffsets[ep];
+
+    const EmberAfEndpointType * endpointType = emAfEndpoints[ep].endpointType;
+    uint8_t clusterIndex;
+    for (clusterIndex = 0; clusterIndex < endpointType->clusterCount; clusterIndex++)
+    {
+        const EmberAfCluster * cluster = &(endpointType->cluster[clusterIndex]);
+        if (emAfMatchCluster(cluster, attRecord))
+        { // Got the cluster
+            uint16_t attrIndex;
+            for (attrIndex = 0; attrIndex < cluster->attributeCount; attrIndex++)
             {
-                const EmberAfCluster * cluster = &(endpointType->cluster[clusterIndex]);
-                if (emAfMatchCluster(cluster, attRecord))
-                { // Got the cluster
-                    uint16_t attrIndex;
-                    for (attrIndex = 0; attrIndex < cluster->attributeCount; attrIndex++)
+                const EmberAfAttributeMetadata * am = &(cluster->attributes[attrIndex]);
+                if (emAfMatchAttribute(cluster, am, attRecord))
+                { // Got the attribute
+                    // If passed metadata location is not null, populate
+                    if (metadata != nullptr)
                     {
-                        const EmberAfAttributeMetadata * am = &(cluster->attributes[attrIndex]);
-                        if (emAfMatchAttribute(cluster, am, attRecord))
-                        { // Got the attribute
-                            // If passed metadata location is not null, populate
-                            if (metadata != nullptr)
-                            {
-                                *metadata = am;
-                            }
+                        *metadata = am;
+                    }
 
+                    {
+                        uint8_t * attributeLocation = (am->mask & ATTRIBUTE_MASK_SINGLETON ? singletonAttributeLocation(am)
+                                                                                           : attributeData + attributeOffsetIndex);
+                        uint8_t *src, *dst;
+                        if (write)
+                        {
+                            src = buffer;
+                            dst = attributeLocation;
+                            if (!emberAfAttributeWriteAccessCallback(attRecord->endpoint, attRecord->clusterId, am->attributeId))
                             {
-                                uint8_t * attributeLocation =
-                                    (am->mask & ATTRIBUTE_MASK_SINGLETON ? singletonAttributeLocation(am)
-                                                                         : attributeData + attributeOffsetIndex);
-                                uint8_t *src, *dst;
-                                if (write)
-                                {
-                                    src = buffer;
-                                    dst = attributeLocation;
-                                    if (!emberAfAttributeWriteAccessCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                             am->attributeId))
-                                    {
-                                        return EMBER_ZCL_STATUS_UNSUPPORTED_ACCESS;
-                                    }
-                                }
-                                else
-                                {
-                                    if (buffer == nullptr)
-                                    {
-                                        return EMBER_ZCL_STATUS_SUCCESS;
-                                    }
-
-                                    src = attributeLocation;
-                                    dst = buffer;
-                                    if (!emberAfAttributeReadAccessCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                            am->attributeId))
-                                    {
-                                        return EMBER_ZCL_STATUS_UNSUPPORTED_ACCESS;
-                                    }
-                                }
-
-                                // Is the attribute externally stored?
-                                if (am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE)
-                                {
-                                    return (write ? emberAfExternalAttributeWriteCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                                          am, buffer)
-                                                  : emberAfExternalAttributeReadCallback(attRecord->endpoint, attRecord->clusterId,
-                                                                                         am, buffer, emberAfAttributeSize(am)));
-                                }
-
-                                // Internal storage is only supported for fixed endpoints
-                                if (!isDynamicEndpoint)
-                                {
-                                    return typeSensitiveMemCopy(attRecord->clusterId, dst, src, am, write, readLength);
-                                }
-
-                                return EMBER_ZCL_STATUS_FAILURE;
+                                return EMBER_ZCL_STATUS_UNSUPPORTED_ACCESS;
                             }
                         }
                         else
-                        { // Not the attribute we are looking for
-                            // Increase the index if attribute is not externally stored
-                            if (!(am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE) && !(am->mask & ATTRIBUTE_MASK_SINGLETON))
+                        {
+                            if (buffer == nullptr)
+                            {
+                                return EMBER_ZCL_STATUS_SUCCESS;
+                            }
+
+                            src = attributeLocation;
+                            dst = buffer;
+                            if (!emberAfAttributeReadAccessCallback(attRecord->endpoint, attRecord->clusterId, am->attributeId))
                             {
-                                attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + emberAfAttributeSize(am));
+                                return EMBER_ZCL_STATUS_UNSUPPORTED_ACCESS;
                             }
                         }
-                    }
 
-                    // Attribute is not in the cluster.
-                    return EMBER_ZCL_STATUS_UNSUPPORTED_ATTRIBUTE;
-                }
+                        // Is the attribute externally stored?
+                        if (am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE)
+                        {
+                            return (write ? emberAfExternalAttributeWriteCallback(attRecord->endpoint, attRecord->clusterId, am,
+                                                                                  buffer)
+                                          : emberAfExternalAttributeReadCallback(attRecord->endpoint, attRecord->clusterId, am,
+                                                                                 buffer, emberAfAttributeSize(am)));
+                        }
+
+                        // Internal storage is only supported for fixed endpoints
+                        if (!isDynamicEndpoint)
+                        {
+                            return typeSensitiveMemCopy(attRecord->clusterId, dst, src, am, write, readLength);
+                        }
 
-                // Not the cluster we are looking for
-                attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + cluster->clusterSize);
+                        return EMBER_ZCL_STATUS_FAILURE;
+                    }
+                }
+                else
+                { // Not the attribute we are looking for
+                    // Increase the index if attribute is not externally stored
+                    if (!(am->mask & ATTRIBUTE_MASK_EXTERNAL_STORAGE) && !(am->mask & ATTRIBUTE_MASK_SINGLETON))
+                    {
+                        attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + emberAfAttributeSize(am));
+                    }
+                }
             }
 
-            // Cluster is not in the endpoint.
-            return EMBER_ZCL_STATUS_UNSUPPORTED_CLUSTER;
+            // Attribute is not in the cluster.
+            return EMBER_ZCL_STATUS_UNSUPPORTED_ATTRIBUTE;
         }
 
-        // Not the endpoint we are looking for
-        // Dynamic endpoints are external and don't factor into storage size
-        if (!isDynamicEndpoint)
-        {
-            attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + emAfEndpoints[ep].endpointType->endpointSize);
-        }
+        // Not the cluster we are looking for
+        attributeOffsetIndex = static_cast<uint16_t>(attributeOffsetIndex + cluster->clusterSize);
     }
-    return EMBER_ZCL_STATUS_UNSUPPORTED_ENDPOINT; // Sorry, endpoint was not found.
+
+    // Cluster is not in the endpoint.
+    return EMBER_ZCL_STATUS_UNSUPPORTED_CLUSTER;
 }
 
 const EmberAfEndpointType * emberAfFindEndpointType(chip::EndpointId endpointId)
@@ -727,21 +736,12 @@ const EmberAfCluster * emberAfFindClusterInType(const EmberAfEndpointType * endp
 
 uint8_t emberAfClusterIndex(EndpointId endpoint, ClusterId clusterId, EmberAfClusterMask mask)
 {
-    for (uint16_t ep = 0; ep < emberAfEndpointCount(); ep++)
-    {
-        // Check the endpoint id first, because that way we avoid examining the
-        // endpoint type for endpoints that are not actually defined.
-        if (emAfEndpoints[ep].endpoint == endpoint)
-        {
-            const EmberAfEndpointType * endpointType = emAfEndpoints[ep].endpointType;
-            uint8_t index                            = 0xFF;
-            if (emberAfFindClusterInType(endpointType, clusterId, mask, &index) != nullptr)
-            {
-                return index;
-            }
-        }
-    }
-    return 0xFF;
+    uint8_t index = 0xFF;
+    endpointIndex.Find(endpoint, [clusterId, mask, &index](uint16_t ep) {
+        return ep < emberAfEndpointCount() &&
+            emberAfFindClusterInType(emAfEndpoints[ep].endpointType, clusterId, mask, &index) != nullptr;
+    });
+    return index;
 }
 
 // Returns whether the given endpoint has the server of the given cluster on it.
@@ -837,16 +837,10 @@ static uint16_t findIndexFromEndpoint(EndpointId endpoint, bool ignoreDisabledEn
         return kEmberInvalidEndpointIndex;
     }
 
-    uint16_t epi;
-    for (epi = 0; epi < emberAfEndpointCount(); epi++)
-    {
-        if (emAfEndpoints[epi].endpoint == endpoint &&
-            (!ignoreDisabledEndpoints || emAfEndpoints[epi].bitmask.Has(EmberAfEndpointOptions::isEnabled)))
-        {
-            return epi;
-        }
-    }
-    return kEmberInvalidEndpointIndex;
+    return endpointIndex.Find(endpoint, [ignoreDisabledEndpoints](uint16_t epi) {
+        return epi < emberAfEndpointCount() &&
+            (!ignoreDisabledEndpoints || emAfEndpoints[epi].bitmask.Has(EmberAfEndpointOptions::isEnabled));
+    });
 }
 
 uint16_t emberAfGetClusterServerEndpointIndex(EndpointId endpoint, ClusterId cluster, uint16_t fixedClusterServerEndpointCount)
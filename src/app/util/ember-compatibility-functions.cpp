@@ -45,6 +45,7 @@
 #include <lib/support/SafeInt.h>
 #include <lib/support/TypeTraits.h>
 #include <platform/LockTracker.h>
+#include <platform/PlatformManager.h>
 #include <protocols/interaction_model/Constants.h>
 
 #include <app-common/zap-generated/attribute-type.h>
@@ -1139,3 +1140,14 @@ void MatterReportingAttributeChangeCallback(EndpointId endpoint)
 
     InteractionModelEngine::GetInstance()->GetReportingEngine().SetDirty(info);
 }
+
+CHIP_ERROR MatterReportingAttributeChangeCallbackFromAnyThread(EndpointId endpoint, ClusterId clusterId, AttributeId attributeId)
+{
+    // The path travels in the event itself, so that notifying a change needs nothing but a slot in the event queue.  The
+    // POSIX event queue preallocates those, and only allocates from the heap when they are all in use.
+    DeviceLayer::ChipDeviceEvent event;
+    event.Type = DeviceLayer::DeviceEventType::kChipLambdaEvent;
+    event.LambdaEvent.Initialize(
+        [endpoint, clusterId, attributeId] { MatterReportingAttributeChangeCallback(endpoint, clusterId, attributeId); });
+    return DeviceLayer::PlatformMgr().PostEvent(&event);
+}
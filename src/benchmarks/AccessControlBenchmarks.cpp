@@ -0,0 +1,141 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "Benchmark.h"
+
+#include <access/AccessControl.h>
+#include <access/examples/ExampleAccessControlDelegate.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/support/CodeUtils.h>
+
+namespace chip {
+namespace {
+
+using namespace chip::Access;
+using Benchmark::State;
+
+using Entry  = AccessControl::Entry;
+using Target = Entry::Target;
+
+constexpr size_t kEntriesPerFabric  = CHIP_CONFIG_EXAMPLE_ACCESS_CONTROL_MAX_ENTRIES_PER_FABRIC;
+constexpr NodeId kOperationalNodeId = 0x1122334455667788;
+constexpr ClusterId kOnOffCluster   = 0x0006;
+
+class NoDeviceTypes : public AccessControl::DeviceTypeResolver
+{
+public:
+    bool IsDeviceTypeOnEndpoint(DeviceTypeId deviceType, EndpointId endpoint) override { return false; }
+};
+
+/**
+ * Fill the ACL with the given number of CASE entries, spread over as many fabrics as needed.  Every entry grants
+ * a different subject access to a different endpoint, and only the last one grants kOperationalNodeId access to
+ * the last endpoint, so a check for it has to look at every entry on its fabric.
+ */
+CHIP_ERROR FillAcl(AccessControl & accessControl, size_t numEntries)
+{
+    for (size_t i = 0; i < numEntries; i++)
+    {
+        const bool last = (i == numEntries - 1);
+        Entry entry;
+        ReturnErrorOnFailure(accessControl.PrepareEntry(entry));
+        ReturnErrorOnFailure(entry.SetAuthMode(AuthMode::kCase));
+        ReturnErrorOnFailure(entry.SetFabricIndex(static_cast<FabricIndex>(i / kEntriesPerFabric + 1)));
+        ReturnErrorOnFailure(entry.SetPrivilege(Privilege::kOperate));
+        ReturnErrorOnFailure(entry.AddSubject(nullptr, last ? kOperationalNodeId : kOperationalNodeId + i + 1));
+        ReturnErrorOnFailure(entry.AddTarget(
+            nullptr, Target{ Target::kCluster | Target::kEndpoint, kOnOffCluster, static_cast<EndpointId>(i + 1), 0 }));
+        ReturnErrorOnFailure(accessControl.CreateEntry(nullptr, entry));
+    }
+    return CHIP_NO_ERROR;
+}
+
+void AccessControl_Check(State & state)
+{
+    const size_t numEntries = static_cast<size_t>(state.Arg());
+    NoDeviceTypes deviceTypeResolver;
+    AccessControl accessControl;
+
+    if (accessControl.Init(Examples::GetAccessControlDelegate(), deviceTypeResolver) != CHIP_NO_ERROR ||
+        FillAcl(accessControl, numEntries) != CHIP_NO_ERROR)
+    {
+        state.SkipWithError("ACL setup failed");
+    }
+
+    SubjectDescriptor subjectDescriptor;
+    subjectDescriptor.fabricIndex = static_cast<FabricIndex>((numEntries - 1) / kEntriesPerFabric + 1);
+    subjectDescriptor.authMode    = AuthMode::kCase;
+    subjectDescriptor.subject     = kOperationalNodeId;
+    const RequestPath requestPath{ kOnOffCluster, static_cast<EndpointId>(numEntries) };
+
+    while (state.KeepRunning())
+    {
+        if (accessControl.Check(subjectDescriptor, requestPath, Privilege::kView) != CHIP_NO_ERROR)
+        {
+            state.SkipWithError("access was denied");
+            break;
+        }
+    }
+
+    accessControl.Finish();
+    state.SetItemsProcessed(state.Iterations());
+}
+// The example delegate holds at most kEntriesPerFabric entries for each of CHIP_CONFIG_MAX_FABRICS fabrics.
+CHIP_REGISTER_BENCHMARK_WITH_ARG(AccessControl_Check, 1)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(AccessControl_Check, 4)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(AccessControl_Check, 16)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(AccessControl_Check, 64)
+
+// Checks a different cluster on every iteration, as a wildcard read would, so results can't simply be remembered per path.
+void AccessControl_CheckManyPaths(State & state)
+{
+    constexpr uint32_t kNumClusters = 16;
+    const size_t numEntries         = static_cast<size_t>(state.Arg());
+    NoDeviceTypes deviceTypeResolver;
+    AccessControl accessControl;
+
+    if (accessControl.Init(Examples::GetAccessControlDelegate(), deviceTypeResolver) != CHIP_NO_ERROR ||
+        FillAcl(accessControl, numEntries) != CHIP_NO_ERROR)
+    {
+        state.SkipWithError("ACL setup failed");
+    }
+
+    SubjectDescriptor subjectDescriptor;
+    subjectDescriptor.fabricIndex = static_cast<FabricIndex>((numEntries - 1) / kEntriesPerFabric + 1);
+    subjectDescriptor.authMode    = AuthMode::kCase;
+    subjectDescriptor.subject     = kOperationalNodeId;
+
+    uint32_t iteration = 0;
+    while (state.KeepRunning())
+    {
+        const RequestPath requestPath{ kOnOffCluster + iteration++ % kNumClusters, static_cast<EndpointId>(numEntries) };
+        const CHIP_ERROR expected = (requestPath.cluster == kOnOffCluster) ? CHIP_NO_ERROR : CHIP_ERROR_ACCESS_DENIED;
+        if (accessControl.Check(subjectDescriptor, requestPath, Privilege::kView) != expected)
+        {
+            state.SkipWithError("unexpected check result");
+            break;
+        }
+    }
+
+    accessControl.Finish();
+    state.SetItemsProcessed(state.Iterations());
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(AccessControl_CheckManyPaths, 4)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(AccessControl_CheckManyPaths, 64)
+
+} // namespace
+} // namespace chip
@@ -0,0 +1,64 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "Benchmark.h"
+
+#include <app/AttributePathExpandIterator.h>
+#include <app/AttributePathParams.h>
+#include <app/ObjectList.h>
+#include <app/util/mock/Constants.h>
+
+namespace chip {
+namespace {
+
+using Benchmark::State;
+
+// Expands a list of paths against the default mock attribute storage, as the reporting engine does for every report it builds.
+void ExpandPaths(State & state, app::ObjectList<app::AttributePathParams> * paths)
+{
+    uint64_t numPaths = 0;
+    while (state.KeepRunning())
+    {
+        app::ConcreteAttributePath path;
+        for (app::AttributePathExpandIterator iterator(paths); iterator.Get(path); iterator.Next())
+        {
+            numPaths++;
+        }
+        Benchmark::DoNotOptimize(path);
+    }
+
+    state.SetItemsProcessed(numPaths);
+}
+
+void AttributePathExpandIterator_Wildcard(State & state)
+{
+    app::ObjectList<app::AttributePathParams> paths;
+    ExpandPaths(state, &paths);
+}
+CHIP_REGISTER_BENCHMARK(AttributePathExpandIterator_Wildcard)
+
+void AttributePathExpandIterator_WildcardEndpoint(State & state)
+{
+    app::ObjectList<app::AttributePathParams> paths;
+    paths.mValue.mClusterId   = Test::MockClusterId(2);
+    paths.mValue.mAttributeId = Test::MockAttributeId(1);
+    ExpandPaths(state, &paths);
+}
+CHIP_REGISTER_BENCHMARK(AttributePathExpandIterator_WildcardEndpoint)
+
+} // namespace
+} // namespace chip
@@ -0,0 +1,196 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace chip {
+namespace Benchmark {
+namespace {
+
+constexpr size_t kBenchmarksMax     = 256;
+constexpr uint64_t kMaxIterations   = 1000000000;
+constexpr int64_t kNoArg            = INT64_MIN;
+constexpr size_t kMaxNameLength     = 128;
+constexpr double kMinTimeMultiplier = 1.4;
+
+struct Registration
+{
+    const char * name;
+    Function function;
+    int64_t arg;
+};
+
+Registration gBenchmarks[kBenchmarksMax];
+size_t gNumBenchmarks = 0;
+
+void FormatName(const Registration & benchmark, char (&name)[kMaxNameLength])
+{
+    if (benchmark.arg == kNoArg)
+    {
+        snprintf(name, sizeof(name), "%s", benchmark.name);
+    }
+    else
+    {
+        snprintf(name, sizeof(name), "%s/%" PRId64, benchmark.name, benchmark.arg);
+    }
+}
+
+/**
+ * Run a benchmark with a growing number of iterations, until a run takes at least the minimum time.
+ */
+State RunBenchmark(const Registration & benchmark, const RunOptions & options)
+{
+    uint64_t iterations = 1;
+    while (true)
+    {
+        State state(iterations, benchmark.arg);
+        benchmark.function(state);
+        if (state.Error() == nullptr && state.Iterations() < iterations)
+        {
+            state.SkipWithError("benchmark stopped before running all iterations");
+        }
+
+        const auto elapsed = state.RealTime();
+        if (state.Error() != nullptr || elapsed >= options.minTime || iterations >= kMaxIterations)
+        {
+            return state;
+        }
+
+        // Aim a bit above the minimum time so the next run is likely the last one, but grow by at most 10x at a time.
+        double multiplier = 10;
+        if (elapsed.count() > 0)
+        {
+            const double target = static_cast<double>(std::chrono::nanoseconds(options.minTime).count()) * kMinTimeMultiplier;
+            multiplier          = std::min(10.0, target / static_cast<double>(elapsed.count()));
+        }
+        iterations = std::min(kMaxIterations,
+                              std::max(iterations + 1, static_cast<uint64_t>(static_cast<double>(iterations) * multiplier)));
+    }
+}
+
+void ReportJson(const char * name, const State & state, bool first)
+{
+    printf("%s\n    {\n      \"name\": \"%s\",\n      \"run_type\": \"iteration\",\n", first ? "" : ",", name);
+    if (state.Error() != nullptr)
+    {
+        printf("      \"error_occurred\": true,\n      \"error_message\": \"%s\"\n    }", state.Error());
+        return;
+    }
+
+    const double iterations = static_cast<double>(state.Iterations());
+    const double seconds    = static_cast<double>(state.RealTime().count()) / 1e9;
+    printf("      \"iterations\": %" PRIu64 ",\n      \"real_time\": %.3f,\n      \"cpu_time\": %.3f,\n      \"time_unit\": \"ns\"",
+           state.Iterations(), static_cast<double>(state.RealTime().count()) / iterations,
+           static_cast<double>(state.CpuTime().count()) / iterations);
+    if (state.BytesProcessed() > 0 && seconds > 0)
+    {
+        printf(",\n      \"bytes_per_second\": %.1f", static_cast<double>(state.BytesProcessed()) / seconds);
+    }
+    if (state.ItemsProcessed() > 0 && seconds > 0)
+    {
+        printf(",\n      \"items_per_second\": %.1f", static_cast<double>(state.ItemsProcessed()) / seconds);
+    }
+    for (const auto & counter : state.Counters())
+    {
+        if (counter.name != nullptr)
+        {
+            printf(",\n      \"%s\": %.1f", counter.name, counter.value);
+        }
+    }
+    printf("\n    }");
+}
+
+} // namespace
+
+size_t HeapBytesInUse()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+CHIP_ERROR Register(const char * name, Function function)
+{
+    return Register(name, function, kNoArg);
+}
+
+CHIP_ERROR Register(const char * name, Function function, int64_t arg)
+{
+    VerifyOrReturnError(gNumBenchmarks < kBenchmarksMax, CHIP_ERROR_NO_MEMORY);
+    gBenchmarks[gNumBenchmarks++] = { name, function, arg };
+    return CHIP_NO_ERROR;
+}
+
+int RunRegisteredBenchmarks(const RunOptions & options)
+{
+    int failures = 0;
+    bool first   = true;
+
+    printf("{\n  \"context\": {\n    \"min_time_ms\": %lld\n  },\n  \"benchmarks\": [",
+           static_cast<long long>(options.minTime.count()));
+
+    for (size_t i = 0; i < gNumBenchmarks; i++)
+    {
+        char name[kMaxNameLength];
+        FormatName(gBenchmarks[i], name);
+        if (options.filter != nullptr && strstr(name, options.filter) == nullptr)
+        {
+            continue;
+        }
+
+        State state = RunBenchmark(gBenchmarks[i], options);
+        ReportJson(name, state, first);
+        first = false;
+        fflush(stdout);
+
+        if (state.Error() != nullptr)
+        {
+            fprintf(stderr, "%-48s ERROR: %s\n", name, state.Error());
+            failures++;
+        }
+        else
+        {
+            fprintf(stderr, "%-48s %12.1f ns %12" PRIu64 " iterations", name,
+                    static_cast<double>(state.RealTime().count()) / static_cast<double>(state.Iterations()), state.Iterations());
+            for (const auto & counter : state.Counters())
+            {
+                if (counter.name != nullptr)
+                {
+                    fprintf(stderr, " %s=%.0f", counter.name, counter.value);
+                }
+            }
+            fprintf(stderr, "\n");
+        }
+    }
+
+    printf("\n  ]\n}\n");
+    return failures;
+}
+
+} // namespace Benchmark
+} // namespace chip
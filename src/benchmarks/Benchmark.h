@@ -0,0 +1,234 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      A minimal microbenchmark harness for the chip-benchmarks tool.
+ *
+ *      Benchmarks are plain functions taking a State, registered at static
+ *      initialization time, in the same way unit test suites are registered
+ *      with CHIP_REGISTER_TEST_SUITE.  The runner repeats each benchmark with
+ *      a growing iteration count until it runs for at least the minimum time,
+ *      then reports the time per iteration as JSON, in the format used by
+ *      Google Benchmark so that existing comparison tooling can diff runs.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/CodeUtils.h>
+
+#include <chrono>
+#include <ctime>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @def CHIP_REGISTER_BENCHMARK(FUNCTION)
+ *
+ * @brief
+ *   Registers a benchmark function of the signature void(*)(chip::Benchmark::State &),
+ *   reported under the name of the function.
+ *
+ * Example:
+ *
+ * @code
+ * void TLVWriter_EncodeStruct(chip::Benchmark::State & state)
+ * {
+ *     // setup
+ *     while (state.KeepRunning())
+ *     {
+ *         // code to measure
+ *     }
+ *     state.SetItemsProcessed(state.Iterations());
+ * }
+ *
+ * CHIP_REGISTER_BENCHMARK(TLVWriter_EncodeStruct)
+ * @endcode
+ */
+#define CHIP_REGISTER_BENCHMARK(FUNCTION)                                                                                          \
+    static void __attribute__((constructor)) RegisterBenchmark##FUNCTION(void)                                                     \
+    {                                                                                                                              \
+        VerifyOrDie(chip::Benchmark::Register(#FUNCTION, &FUNCTION) == CHIP_NO_ERROR);                                           \
+    }
+
+/**
+ * @def CHIP_REGISTER_BENCHMARK_WITH_ARG(FUNCTION, ARG)
+ *
+ * @brief
+ *   Registers a benchmark function for one value of its integer argument, available through
+ *   State::Arg() and reported as "FUNCTION/ARG".  Register the function once per value.
+ */
+#define CHIP_REGISTER_BENCHMARK_WITH_ARG(FUNCTION, ARG)                                                                            \
+    static void __attribute__((constructor)) RegisterBenchmark##FUNCTION##ARG(void)                                                \
+    {                                                                                                                              \
+        VerifyOrDie(chip::Benchmark::Register(#FUNCTION, &FUNCTION, ARG) == CHIP_NO_ERROR);                                      \
+    }
+
+namespace chip {
+namespace Benchmark {
+
+/**
+ * The state of one run of a benchmark: how many iterations to do, and what was measured.
+ */
+class State
+{
+public:
+    State(uint64_t iterations, int64_t arg) : mMaxIterations(iterations), mArg(arg) {}
+
+    /**
+     * Returns true while iterations remain.  Timing starts on the first call and stops on the last one.
+     */
+    bool KeepRunning()
+    {
+        if (mIterations < mMaxIterations)
+        {
+            if (mIterations == 0)
+            {
+                ResumeTiming();
+            }
+            mIterations++;
+            return true;
+        }
+        if (mRunning)
+        {
+            PauseTiming();
+        }
+        return false;
+    }
+
+    /**
+     * Exclude the code between PauseTiming() and ResumeTiming() from the measurement, e.g. per-iteration setup.
+     */
+    void PauseTiming()
+    {
+        mRealTime += std::chrono::steady_clock::now() - mRealStart;
+        mCpuTime += std::clock() - mCpuStart;
+        mRunning = false;
+    }
+
+    void ResumeTiming()
+    {
+        mRunning   = true;
+        mCpuStart  = std::clock();
+        mRealStart = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * Mark the benchmark as failed; it stops at the next KeepRunning() and reports the message instead of timings.
+     */
+    void SkipWithError(const char * message)
+    {
+        mError         = message;
+        mMaxIterations = 0;
+    }
+
+    void SetItemsProcessed(uint64_t items) { mItemsProcessed = items; }
+    void SetBytesProcessed(uint64_t bytes) { mBytesProcessed = bytes; }
+
+    /**
+     * Report an additional value measured by the benchmark, such as memory use, under the given name.
+     */
+    void SetCounter(const char * name, double value)
+    {
+        for (auto & counter : mCounters)
+        {
+            if (counter.name == nullptr || strcmp(counter.name, name) == 0)
+            {
+                counter.name  = name;
+                counter.value = value;
+                return;
+            }
+        }
+    }
+
+    uint64_t Iterations() const { return mIterations; }
+    int64_t Arg() const { return mArg; }
+
+    std::chrono::nanoseconds RealTime() const { return std::chrono::duration_cast<std::chrono::nanoseconds>(mRealTime); }
+    std::chrono::nanoseconds CpuTime() const
+    {
+        return std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>(mCpuTime) * 1e9 / CLOCKS_PER_SEC));
+    }
+    uint64_t ItemsProcessed() const { return mItemsProcessed; }
+    uint64_t BytesProcessed() const { return mBytesProcessed; }
+    const char * Error() const { return mError; }
+
+    struct Counter
+    {
+        const char * name = nullptr;
+        double value      = 0;
+    };
+
+    static constexpr size_t kMaxCounters = 4;
+    using CounterArray                   = Counter[kMaxCounters];
+    const CounterArray & Counters() const { return mCounters; }
+
+private:
+    uint64_t mMaxIterations;
+    uint64_t mIterations = 0;
+    int64_t mArg;
+    bool mRunning = false;
+
+    std::chrono::steady_clock::time_point mRealStart;
+    std::chrono::steady_clock::duration mRealTime = std::chrono::steady_clock::duration::zero();
+    std::clock_t mCpuStart                        = 0;
+    std::clock_t mCpuTime                         = 0;
+
+    uint64_t mItemsProcessed = 0;
+    uint64_t mBytesProcessed = 0;
+    const char * mError      = nullptr;
+    CounterArray mCounters;
+};
+
+typedef void (*Function)(State & state);
+
+CHIP_ERROR Register(const char * name, Function function);
+CHIP_ERROR Register(const char * name, Function function, int64_t arg);
+
+struct RunOptions
+{
+    // Only run benchmarks whose name contains this string, if not null.
+    const char * filter = nullptr;
+    // Grow the iteration count until a run takes at least this long.
+    std::chrono::milliseconds minTime = std::chrono::milliseconds(500);
+};
+
+/**
+ * Run the registered benchmarks and write the results as JSON to stdout.
+ *
+ * @return the number of benchmarks that failed.
+ */
+int RunRegisteredBenchmarks(const RunOptions & options);
+
+/**
+ * Returns the number of bytes currently allocated on the heap, or 0 if the platform cannot tell.
+ */
+size_t HeapBytesInUse();
+
+/**
+ * Prevent the compiler from optimizing away the computation of a value that is otherwise unused.
+ */
+template <typename T>
+inline void DoNotOptimize(const T & value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+} // namespace Benchmark
+} // namespace chip
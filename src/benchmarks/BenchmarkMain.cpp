@@ -0,0 +1,92 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Entry point of chip-benchmarks: runs the registered benchmarks and
+ *      writes their results as JSON to stdout, and a summary to stderr.
+ *
+ *      Usage: chip-benchmarks [--filter=<substring>] [--min-time-ms=<ms>] [--verbose]
+ */
+
+#include "Benchmark.h"
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+// Most hot paths log at progress level; keep those out of stdout and out of the measurements.
+void ErrorsOnlyLogRedirect(const char * module, uint8_t category, const char * msg, va_list args)
+{
+    if (category == chip::Logging::kLogCategory_Error)
+    {
+        fprintf(stderr, "CHIP:%s: ", module);
+        vfprintf(stderr, msg, args);
+        fprintf(stderr, "\n");
+    }
+}
+
+void PrintUsage(const char * progName)
+{
+    fprintf(stderr, "Usage: %s [--filter=<substring>] [--min-time-ms=<ms>] [--verbose]\n", progName);
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    chip::Benchmark::RunOptions options;
+    bool verbose = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--filter=", strlen("--filter=")) == 0)
+        {
+            options.filter = argv[i] + strlen("--filter=");
+        }
+        else if (strncmp(argv[i], "--min-time-ms=", strlen("--min-time-ms=")) == 0)
+        {
+            options.minTime = std::chrono::milliseconds(strtoul(argv[i] + strlen("--min-time-ms="), nullptr, 10));
+        }
+        else if (strcmp(argv[i], "--verbose") == 0)
+        {
+            verbose = true;
+        }
+        else
+        {
+            PrintUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!verbose)
+    {
+        chip::Logging::SetLogRedirectCallback(ErrorsOnlyLogRedirect);
+    }
+
+    VerifyOrDie(chip::Platform::MemoryInit() == CHIP_NO_ERROR);
+    int failures = chip::Benchmark::RunRegisteredBenchmarks(options);
+    chip::Platform::MemoryShutdown();
+
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,222 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "Benchmark.h"
+
+#include <app/ClusterStateCache.h>
+#include <lib/core/TLV.h>
+#include <lib/support/CodeUtils.h>
+
+namespace chip {
+namespace {
+
+using namespace chip::app;
+using Benchmark::State;
+using AttributeStorage = ClusterStateCache::AttributeStorage;
+
+constexpr size_t kClustersPerEndpoint   = 4;
+constexpr size_t kAttributesPerCluster  = 8;
+constexpr ClusterId kFirstClusterId     = 0x0006;
+constexpr AttributeId kFirstAttributeId = 0x0000;
+
+class NullCallback : public ClusterStateCache::Callback
+{
+public:
+    void OnDone(ReadClient *) override {}
+};
+
+/**
+ * Feeds a report with every attribute of the given number of endpoints into the cache, through the buffered
+ * callback chain a ReadClient would use.
+ */
+class ReportGenerator
+{
+public:
+    CHIP_ERROR Init()
+    {
+        TLV::TLVWriter writer;
+        writer.Init(mValue);
+        ReturnErrorOnFailure(writer.Put(TLV::AnonymousTag(), static_cast<uint16_t>(0x1234)));
+        ReturnErrorOnFailure(writer.Finalize());
+        mValueLength = writer.GetLengthWritten();
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR Generate(ReadClient::Callback & callback, size_t numEndpoints, DataVersion version)
+    {
+        callback.OnReportBegin();
+        for (size_t endpoint = 0; endpoint < numEndpoints; endpoint++)
+        {
+            for (size_t cluster = 0; cluster < kClustersPerEndpoint; cluster++)
+            {
+                for (size_t attribute = 0; attribute < kAttributesPerCluster; attribute++)
+                {
+                    ConcreteDataAttributePath path(static_cast<EndpointId>(endpoint),
+                                                   static_cast<ClusterId>(kFirstClusterId + cluster),
+                                                   static_cast<AttributeId>(kFirstAttributeId + attribute));
+                    path.mDataVersion.SetValue(version);
+
+                    TLV::TLVReader reader;
+                    reader.Init(mValue, mValueLength);
+                    ReturnErrorOnFailure(reader.Next());
+                    callback.OnAttributeData(path, &reader, StatusIB());
+                }
+            }
+        }
+        callback.OnReportEnd();
+        return CHIP_NO_ERROR;
+    }
+
+private:
+    uint8_t mValue[8];
+    uint32_t mValueLength = 0;
+};
+
+void IngestReport(State & state, AttributeStorage storage)
+{
+    const size_t numEndpoints = static_cast<size_t>(state.Arg());
+    NullCallback callback;
+    ClusterStateCache cache(callback, Optional<EventNumber>::Missing(), true /* cacheData */, storage);
+    ReportGenerator generator;
+    if (generator.Init() != CHIP_NO_ERROR)
+    {
+        state.SkipWithError("encoding failed");
+    }
+
+    // Every report after the first one updates attributes already in the cache, as a subscription does.
+    DataVersion version = 0;
+    while (state.KeepRunning())
+    {
+        if (generator.Generate(cache.GetBufferedCallback(), numEndpoints, ++version) != CHIP_NO_ERROR)
+        {
+            state.SkipWithError("generating the report failed");
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.Iterations() * numEndpoints * kClustersPerEndpoint * kAttributesPerCluster);
+}
+
+void ClusterStateCache_IngestReport(State & state)
+{
+    IngestReport(state, AttributeStorage::kMap);
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(ClusterStateCache_IngestReport, 1)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(ClusterStateCache_IngestReport, 16)
+
+void ClusterStateCache_IngestReportFlat(State & state)
+{
+    IngestReport(state, AttributeStorage::kFlat);
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(ClusterStateCache_IngestReportFlat, 1)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(ClusterStateCache_IngestReportFlat, 16)
+
+/**
+ * Measures setting up a subscription to a node from scratch: the priming report and a few updates, into a new
+ * cache.  The heap_bytes counter is the memory the cache holds at the end.
+ */
+void Subscribe(State & state, AttributeStorage storage)
+{
+    constexpr DataVersion kNumReports = 8;
+    const size_t numEndpoints         = static_cast<size_t>(state.Arg());
+    NullCallback callback;
+    ReportGenerator generator;
+    if (generator.Init() != CHIP_NO_ERROR)
+    {
+        state.SkipWithError("encoding failed");
+    }
+
+    size_t heapBytes = 0;
+    while (state.KeepRunning())
+    {
+        const size_t heapBytesBefore = Benchmark::HeapBytesInUse();
+        ClusterStateCache cache(callback, Optional<EventNumber>::Missing(), true /* cacheData */, storage);
+        for (DataVersion version = 1; version <= kNumReports; version++)
+        {
+            if (generator.Generate(cache.GetBufferedCallback(), numEndpoints, version) != CHIP_NO_ERROR)
+            {
+                state.SkipWithError("generating the report failed");
+                break;
+            }
+        }
+        heapBytes = Benchmark::HeapBytesInUse() - heapBytesBefore;
+    }
+
+    state.SetItemsProcessed(state.Iterations() * kNumReports * numEndpoints * kClustersPerEndpoint * kAttributesPerCluster);
+    state.SetCounter("heap_bytes", static_cast<double>(heapBytes));
+}
+
+void ClusterStateCache_Subscribe(State & state)
+{
+    Subscribe(state, AttributeStorage::kMap);
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(ClusterStateCache_Subscribe, 1)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(ClusterStateCache_Subscribe, 16)
+
+void ClusterStateCache_SubscribeFlat(State & state)
+{
+    Subscribe(state, AttributeStorage::kFlat);
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(ClusterStateCache_SubscribeFlat, 1)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(ClusterStateCache_SubscribeFlat, 16)
+
+void Get(State & state, AttributeStorage storage)
+{
+    const size_t numEndpoints = static_cast<size_t>(state.Arg());
+    NullCallback callback;
+    ClusterStateCache cache(callback, Optional<EventNumber>::Missing(), true /* cacheData */, storage);
+    ReportGenerator generator;
+    if (generator.Init() != CHIP_NO_ERROR || generator.Generate(cache.GetBufferedCallback(), numEndpoints, 1) != CHIP_NO_ERROR)
+    {
+        state.SkipWithError("populating the cache failed");
+    }
+
+    // Look up the attribute that was cached last.
+    const ConcreteAttributePath path(static_cast<EndpointId>(numEndpoints - 1),
+                                     static_cast<ClusterId>(kFirstClusterId + kClustersPerEndpoint - 1),
+                                     static_cast<AttributeId>(kFirstAttributeId + kAttributesPerCluster - 1));
+    while (state.KeepRunning())
+    {
+        TLV::TLVReader reader;
+        uint16_t value;
+        if (cache.Get(path, reader) != CHIP_NO_ERROR || reader.Get(value) != CHIP_NO_ERROR)
+        {
+            state.SkipWithError("attribute lookup failed");
+            break;
+        }
+        Benchmark::DoNotOptimize(value);
+    }
+
+    state.SetItemsProcessed(state.Iterations());
+}
+
+void ClusterStateCache_Get(State & state)
+{
+    Get(state, AttributeStorage::kMap);
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(ClusterStateCache_Get, 1)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(ClusterStateCache_Get, 16)
+
+void ClusterStateCache_GetFlat(State & state)
+{
+    Get(state, AttributeStorage::kFlat);
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(ClusterStateCache_GetFlat, 1)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(ClusterStateCache_GetFlat, 16)
+
+} // namespace
+} // namespace chip
@@ -0,0 +1,253 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "Benchmark.h"
+
+#include <crypto/CHIPCryptoPAL.h>
+#include <crypto/DefaultSessionKeystore.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/support/CodeUtils.h>
+#include <transport/CryptoContext.h>
+#include <transport/raw/MessageHeader.h>
+
+namespace chip {
+namespace {
+
+using Benchmark::State;
+
+constexpr size_t kMaxPayloadLength = 1024;
+constexpr NodeId kSourceNodeId     = 0x0123456789abcdef;
+constexpr size_t kAadLength        = 8; // Size of a unicast message header without source node ID
+
+/**
+ * A pair of session contexts sharing the test secret, as two ends of a session would after PASE or CASE.
+ */
+struct SessionContexts
+{
+    Crypto::DefaultSessionKeystore keystore;
+    CryptoContext initiator;
+    CryptoContext responder;
+
+    CHIP_ERROR Init()
+    {
+        ByteSpan secret(reinterpret_cast<const uint8_t *>(CHIP_CONFIG_TEST_SHARED_SECRET_VALUE),
+                        CHIP_CONFIG_TEST_SHARED_SECRET_LENGTH);
+        ReturnErrorOnFailure(initiator.InitFromSecret(keystore, secret, ByteSpan(),
+                                                      CryptoContext::SessionInfoType::kSessionEstablishment,
+                                                      CryptoContext::SessionRole::kInitiator));
+        return responder.InitFromSecret(keystore, secret, ByteSpan(), CryptoContext::SessionInfoType::kSessionEstablishment,
+                                        CryptoContext::SessionRole::kResponder);
+    }
+};
+
+PacketHeader MakeHeader(uint32_t messageCounter)
+{
+    PacketHeader header;
+    header.SetSessionId(0x1234).SetMessageCounter(messageCounter).SetSessionType(Header::SessionType::kUnicastSession);
+    return header;
+}
+
+void CryptoContext_Encrypt(State & state)
+{
+    const size_t length = static_cast<size_t>(state.Arg());
+    SessionContexts contexts;
+    uint8_t plaintext[kMaxPayloadLength];
+    uint8_t ciphertext[kMaxPayloadLength];
+    memset(plaintext, 0x5a, sizeof(plaintext));
+
+    if (length > kMaxPayloadLength || contexts.Init() != CHIP_NO_ERROR)
+    {
+        state.SkipWithError("session setup failed");
+    }
+
+    uint32_t messageCounter = 0;
+    while (state.KeepRunning())
+    {
+        PacketHeader header = MakeHeader(++messageCounter);
+        MessageAuthenticationCode mac;
+        CryptoContext::NonceStorage nonce;
+        CryptoContext::BuildNonce(nonce, header.GetSecurityFlags(), messageCounter, kSourceNodeId);
+        if (contexts.initiator.Encrypt(plaintext, length, ciphertext, nonce, header, mac) != CHIP_NO_ERROR)
+        {
+            state.SkipWithError("encryption failed");
+            break;
+        }
+        Benchmark::DoNotOptimize(ciphertext);
+    }
+
+    state.SetItemsProcessed(state.Iterations());
+    state.SetBytesProcessed(state.Iterations() * length);
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(CryptoContext_Encrypt, 64)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(CryptoContext_Encrypt, 1024)
+
+void CryptoContext_Decrypt(State & state)
+{
+    const size_t length = static_cast<size_t>(state.Arg());
+    SessionContexts contexts;
+    uint8_t plaintext[kMaxPayloadLength];
+    uint8_t ciphertext[kMaxPayloadLength];
+    memset(plaintext, 0x5a, sizeof(plaintext));
+
+    // Decrypt the same message over and over; replay protection lives in the session, not in CryptoContext.
+    PacketHeader header = MakeHeader(1);
+    MessageAuthenticationCode mac;
+    CryptoContext::NonceStorage nonce;
+    CryptoContext::BuildNonce(nonce, header.GetSecurityFlags(), header.GetMessageCounter(), kSourceNodeId);
+    if (length > kMaxPayloadLength || contexts.Init() != CHIP_NO_ERROR ||
+        contexts.initiator.Encrypt(plaintext, length, ciphertext, nonce, header, mac) != CHIP_NO_ERROR)
+    {
+        state.SkipWithError("session setup failed");
+    }
+
+    while (state.KeepRunning())
+    {
+        if (contexts.responder.Decrypt(ciphertext, length, plaintext, nonce, header, mac) != CHIP_NO_ERROR)
+        {
+            state.SkipWithError("decryption failed");
+            break;
+        }
+        Benchmark::DoNotOptimize(plaintext);
+    }
+
+    state.SetItemsProcessed(state.Iterations());
+    state.SetBytesProcessed(state.Iterations() * length);
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(CryptoContext_Decrypt, 64)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(CryptoContext_Decrypt, 1024)
+
+/**
+ * An AES-CCM key held by the default session keystore, either imported with CreateKey() as group and ICD keys are, or
+ * derived with DeriveSessionKeys() as session keys are. The backend may keep a cipher context for the latter.
+ */
+class AesCcmKey
+{
+public:
+    ~AesCcmKey()
+    {
+        if (mInitialized)
+        {
+            mKeystore.DestroyKey(mKey);
+        }
+    }
+
+    CHIP_ERROR Init(bool sessionKey)
+    {
+        ByteSpan secret(reinterpret_cast<const uint8_t *>(CHIP_CONFIG_TEST_SHARED_SECRET_VALUE),
+                        CHIP_CONFIG_TEST_SHARED_SECRET_LENGTH);
+
+        if (sessionKey)
+        {
+            Crypto::Aes128KeyHandle otherKey;
+            Crypto::AttestationChallenge challenge;
+            const uint8_t info[] = { 'S', 'e', 's', 's', 'i', 'o', 'n', 'K', 'e', 'y', 's' };
+            ReturnErrorOnFailure(mKeystore.DeriveSessionKeys(secret, ByteSpan(), ByteSpan(info), mKey, otherKey, challenge));
+            mKeystore.DestroyKey(otherKey);
+        }
+        else
+        {
+            Crypto::Aes128KeyByteArray keyMaterial;
+            memcpy(keyMaterial, secret.data(), sizeof(keyMaterial));
+            ReturnErrorOnFailure(mKeystore.CreateKey(keyMaterial, mKey));
+        }
+
+        mInitialized = true;
+        return CHIP_NO_ERROR;
+    }
+
+    const Crypto::Aes128KeyHandle & Get() const { return mKey; }
+
+private:
+    Crypto::DefaultSessionKeystore mKeystore;
+    Crypto::Aes128KeyHandle mKey;
+    bool mInitialized = false;
+};
+
+void RunAesCcm(State & state, bool sessionKey, bool decrypt)
+{
+    const size_t length = static_cast<size_t>(state.Arg());
+    AesCcmKey key;
+    uint8_t plaintext[kMaxPayloadLength];
+    uint8_t ciphertext[kMaxPayloadLength];
+    uint8_t aad[kAadLength];
+    uint8_t nonce[Crypto::kAES_CCM128_Nonce_Length] = {};
+    uint8_t tag[Crypto::kAES_CCM128_Tag_Length];
+    memset(plaintext, 0x5a, sizeof(plaintext));
+    memset(aad, 0xa5, sizeof(aad));
+
+    if (length > kMaxPayloadLength || key.Init(sessionKey) != CHIP_NO_ERROR ||
+        Crypto::AES_CCM_encrypt(plaintext, length, aad, sizeof(aad), key.Get(), nonce, sizeof(nonce), ciphertext, tag,
+                                sizeof(tag)) != CHIP_NO_ERROR)
+    {
+        state.SkipWithError("key setup failed");
+    }
+
+    while (state.KeepRunning())
+    {
+        CHIP_ERROR err;
+        if (decrypt)
+        {
+            err = Crypto::AES_CCM_decrypt(ciphertext, length, aad, sizeof(aad), tag, sizeof(tag), key.Get(), nonce, sizeof(nonce),
+                                          plaintext);
+        }
+        else
+        {
+            err = Crypto::AES_CCM_encrypt(plaintext, length, aad, sizeof(aad), key.Get(), nonce, sizeof(nonce), ciphertext, tag,
+                                          sizeof(tag));
+        }
+        if (err != CHIP_NO_ERROR)
+        {
+            state.SkipWithError("AES-CCM operation failed");
+            break;
+        }
+        Benchmark::DoNotOptimize(decrypt ? plaintext : ciphertext);
+    }
+
+    state.SetItemsProcessed(state.Iterations());
+    state.SetBytesProcessed(state.Iterations() * length);
+}
+
+// AES-CCM with the key set up for every message, to compare with session keys below. Run against each backend by
+// building with chip_crypto set to "openssl", "mbedtls" or "psa".
+void AesCcm_EncryptCreatedKey(State & state)
+{
+    RunAesCcm(state, false, false);
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(AesCcm_EncryptCreatedKey, 64)
+
+void AesCcm_DecryptCreatedKey(State & state)
+{
+    RunAesCcm(state, false, true);
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(AesCcm_DecryptCreatedKey, 64)
+
+void AesCcm_EncryptSessionKey(State & state)
+{
+    RunAesCcm(state, true, false);
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(AesCcm_EncryptSessionKey, 64)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(AesCcm_EncryptSessionKey, 1024)
+
+void AesCcm_DecryptSessionKey(State & state)
+{
+    RunAesCcm(state, true, true);
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(AesCcm_DecryptSessionKey, 64)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(AesCcm_DecryptSessionKey, 1024)
+
+} // namespace
+} // namespace chip
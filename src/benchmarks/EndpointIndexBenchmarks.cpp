@@ -0,0 +1,137 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "Benchmark.h"
+
+#include <app/util/EndpointIndex.h>
+#include <lib/core/DataModelTypes.h>
+
+#include <memory>
+
+namespace chip {
+namespace {
+
+using Benchmark::State;
+
+constexpr uint16_t kMaxEndpoints = 1000;
+
+/**
+ * The endpoint array of a bridge: a root endpoint, an aggregator, then dynamic endpoints whose ids were allocated in
+ * no particular order, as bridged devices come and go.  Every other endpoint is disabled.
+ */
+struct BridgeEndpoints
+{
+    struct Endpoint
+    {
+        EndpointId endpoint;
+        bool enabled;
+    };
+
+    explicit BridgeEndpoints(uint16_t count) : mCount(count)
+    {
+        for (uint16_t i = 0; i < mCount; i++)
+        {
+            mEndpoints[i] = { EndpointIdAt(i), i < 2 || (i % 2) == 0 };
+            VerifyOrDie(mIndex.Insert(mEndpoints[i].endpoint, i) == CHIP_NO_ERROR);
+        }
+    }
+
+    EndpointId EndpointIdAt(uint16_t i) const
+    {
+        // A permutation of [0, mCount) that keeps the root endpoint at index 0.
+        return static_cast<EndpointId>((static_cast<uint32_t>(i) * 7919u) % mCount);
+    }
+
+    // How emberAfIndexFromEndpoint used to look an enabled endpoint up.
+    uint16_t Scan(EndpointId endpoint) const
+    {
+        for (uint16_t i = 0; i < mCount; i++)
+        {
+            if (mEndpoints[i].endpoint == endpoint && mEndpoints[i].enabled)
+            {
+                return i;
+            }
+        }
+        return app::EndpointIndex<kMaxEndpoints>::kInvalidIndex;
+    }
+
+    uint16_t Find(EndpointId endpoint) const
+    {
+        return mIndex.Find(endpoint, [this](uint16_t i) { return mEndpoints[i].enabled; });
+    }
+
+    uint16_t mCount;
+    Endpoint mEndpoints[kMaxEndpoints];
+    app::EndpointIndex<kMaxEndpoints> mIndex;
+};
+
+// Looks up every endpoint in turn, as an attribute access or a wildcard path expansion over all the endpoints does.
+template <uint16_t (BridgeEndpoints::*Lookup)(EndpointId) const>
+void LookUpEndpoints(State & state)
+{
+    auto endpoints = std::make_unique<BridgeEndpoints>(static_cast<uint16_t>(state.Arg()));
+
+    uint64_t numLookups = 0;
+    while (state.KeepRunning())
+    {
+        for (uint16_t i = 0; i < endpoints->mCount; i++)
+        {
+            Benchmark::DoNotOptimize(((*endpoints).*Lookup)(endpoints->EndpointIdAt(i)));
+        }
+        numLookups += endpoints->mCount;
+    }
+
+    state.SetItemsProcessed(numLookups);
+}
+
+void EndpointLookup_Scan(State & state)
+{
+    LookUpEndpoints<&BridgeEndpoints::Scan>(state);
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(EndpointLookup_Scan, 10)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(EndpointLookup_Scan, 100)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(EndpointLookup_Scan, 1000)
+
+void EndpointLookup_Index(State & state)
+{
+    LookUpEndpoints<&BridgeEndpoints::Find>(state);
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(EndpointLookup_Index, 10)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(EndpointLookup_Index, 100)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(EndpointLookup_Index, 1000)
+
+// Adds and removes a dynamic endpoint, as a bridge does when a bridged device joins and leaves.
+void EndpointIndex_AddRemove(State & state)
+{
+    auto endpoints        = std::make_unique<BridgeEndpoints>(static_cast<uint16_t>(state.Arg() - 1));
+    const uint16_t index  = endpoints->mCount;
+    const EndpointId last = static_cast<EndpointId>(index / 2);
+
+    while (state.KeepRunning())
+    {
+        VerifyOrDie(endpoints->mIndex.Insert(last, index) == CHIP_NO_ERROR);
+        endpoints->mIndex.Remove(last, index);
+    }
+
+    state.SetItemsProcessed(state.Iterations());
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(EndpointIndex_AddRemove, 10)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(EndpointIndex_AddRemove, 100)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(EndpointIndex_AddRemove, 1000)
+
+} // namespace
+} // namespace chip
@@ -0,0 +1,134 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "Benchmark.h"
+
+#include <inet/IPAddress.h>
+#include <lib/dnssd/minimal_mdns/Parser.h>
+#include <lib/dnssd/minimal_mdns/RecordData.h>
+#include <lib/dnssd/minimal_mdns/ResponseBuilder.h>
+#include <lib/dnssd/minimal_mdns/records/IP.h>
+#include <lib/dnssd/minimal_mdns/records/Ptr.h>
+#include <lib/dnssd/minimal_mdns/records/Srv.h>
+#include <lib/dnssd/minimal_mdns/records/Txt.h>
+#include <system/SystemPacketBuffer.h>
+
+namespace chip {
+namespace {
+
+using namespace mdns::Minimal;
+using Benchmark::State;
+
+constexpr uint16_t kMatterPort = 5540;
+
+const QNamePart kServiceName[]  = { "_matter", "_tcp", "local" };
+const QNamePart kInstanceName[] = { "1122334455667788-0000000000000001", "_matter", "_tcp", "local" };
+const QNamePart kHostName[]     = { "AABBCCDDEEFF0011", "local" };
+const char * kTxtEntries[]      = { "SII=5000", "SAI=300", "SAT=4000", "T=1" };
+
+/**
+ * Decodes every record of the packet, as the operational discovery resolver does.
+ */
+class RecordDecoder : public ParserDelegate, public TxtRecordDelegate
+{
+public:
+    explicit RecordDecoder(const BytesRange & packet) : mPacket(packet) {}
+
+    void OnHeader(ConstHeaderRef & header) override {}
+    void OnQuery(const QueryData & data) override {}
+    void OnRecord(const BytesRange & name, const BytesRange & value) override { mNumRecords++; }
+
+    void OnResource(ResourceType type, const ResourceData & data) override
+    {
+        switch (data.GetType())
+        {
+        case QType::PTR: {
+            SerializedQNameIterator name;
+            mOk = mOk && ParsePtrRecord(data.GetData(), mPacket, &name);
+            break;
+        }
+        case QType::SRV: {
+            SrvRecord srv;
+            mOk = mOk && srv.Parse(data.GetData(), mPacket) && srv.GetPort() == kMatterPort;
+            break;
+        }
+        case QType::TXT:
+            mOk = mOk && ParseTxtRecord(data.GetData(), this);
+            break;
+        case QType::AAAA: {
+            Inet::IPAddress address;
+            mOk = mOk && ParseAAAARecord(data.GetData(), &address);
+            break;
+        }
+        default:
+            break;
+        }
+        mNumRecords++;
+    }
+
+    bool Ok() const { return mOk; }
+    size_t NumRecords() const { return mNumRecords; }
+
+private:
+    BytesRange mPacket;
+    bool mOk           = true;
+    size_t mNumRecords = 0;
+};
+
+// An operational node advertisement: PTR, SRV and TXT answers with an AAAA additional record.
+System::PacketBufferHandle BuildOperationalResponse()
+{
+    Inet::IPAddress address;
+    VerifyOrReturnValue(Inet::IPAddress::FromString("fd00::1234:5678", address), nullptr);
+
+    ResponseBuilder builder(System::PacketBufferHandle::New(System::PacketBuffer::kMaxSizeWithoutReserve, 0));
+    builder.AddRecord(ResourceType::kAnswer, PtrResourceRecord(kServiceName, kInstanceName))
+        .AddRecord(ResourceType::kAnswer, SrvResourceRecord(kInstanceName, kHostName, kMatterPort))
+        .AddRecord(ResourceType::kAnswer, TxtResourceRecord(kInstanceName, kTxtEntries))
+        .AddRecord(ResourceType::kAdditional, IPResourceRecord(kHostName, address));
+    VerifyOrReturnValue(builder.Ok(), nullptr);
+    return builder.ReleasePacket();
+}
+
+void MinimalMdns_ParseResponse(State & state)
+{
+    System::PacketBufferHandle packet = BuildOperationalResponse();
+    if (packet.IsNull())
+    {
+        state.SkipWithError("building the response failed");
+    }
+    const BytesRange packetRange =
+        packet.IsNull() ? BytesRange() : BytesRange(packet->Start(), packet->Start() + packet->DataLength());
+
+    while (state.KeepRunning())
+    {
+        RecordDecoder decoder(packetRange);
+        if (!ParsePacket(packetRange, &decoder) || !decoder.Ok())
+        {
+            state.SkipWithError("parsing the response failed");
+            break;
+        }
+        Benchmark::DoNotOptimize(decoder.NumRecords());
+    }
+
+    state.SetItemsProcessed(state.Iterations());
+    state.SetBytesProcessed(state.Iterations() * packetRange.Size());
+}
+CHIP_REGISTER_BENCHMARK(MinimalMdns_ParseResponse)
+
+} // namespace
+} // namespace chip
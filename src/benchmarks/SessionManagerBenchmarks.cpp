@@ -0,0 +1,127 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "Benchmark.h"
+
+#include <credentials/FabricTable.h>
+#include <credentials/PersistentStorageOpCertStore.h>
+#include <crypto/DefaultSessionKeystore.h>
+#include <crypto/PersistentStorageOperationalKeystore.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+#include <protocols/echo/Echo.h>
+#include <protocols/secure_channel/MessageCounterManager.h>
+#include <transport/SessionManager.h>
+#include <transport/TransportMgrBase.h>
+
+namespace chip {
+namespace {
+
+using Benchmark::State;
+
+constexpr size_t kMaxPayloadLength = 1024;
+constexpr NodeId kPeerNodeId       = NodeIdFromPAKEKeyId(kDefaultCommissioningPasscodeId);
+
+/**
+ * A SessionManager with a single injected PASE session.  No transport is attached, since PrepareMessage only
+ * builds and encrypts the message.
+ */
+class SessionManagerContext
+{
+public:
+    ~SessionManagerContext()
+    {
+        mSession.Release();
+        mSessionManager.Shutdown();
+        mFabricTable.Shutdown();
+        mOpKeyStore.Finish();
+        mOpCertStore.Finish();
+    }
+
+    CHIP_ERROR Init()
+    {
+        ReturnErrorOnFailure(mOpKeyStore.Init(&mStorage));
+        ReturnErrorOnFailure(mOpCertStore.Init(&mStorage));
+
+        FabricTable::InitParams initParams;
+        initParams.storage             = &mStorage;
+        initParams.operationalKeystore = &mOpKeyStore;
+        initParams.opCertStore         = &mOpCertStore;
+        ReturnErrorOnFailure(mFabricTable.Init(initParams));
+
+        ReturnErrorOnFailure(mSessionManager.Init(nullptr, &mTransportMgr, &mMessageCounterManager, &mStorage, &mFabricTable,
+                                                  mSessionKeystore));
+
+        Inet::IPAddress address;
+        VerifyOrReturnError(Inet::IPAddress::FromString("fe80::1", address), CHIP_ERROR_INTERNAL);
+        return mSessionManager.InjectPaseSessionWithTestKey(mSession, 1, kPeerNodeId, 2, kUndefinedFabricIndex,
+                                                            Transport::PeerAddress::UDP(address),
+                                                            CryptoContext::SessionRole::kInitiator);
+    }
+
+    SessionManager & GetSessionManager() { return mSessionManager; }
+    SessionHolder & GetSession() { return mSession; }
+
+private:
+    TestPersistentStorageDelegate mStorage;
+    PersistentStorageOperationalKeystore mOpKeyStore;
+    Credentials::PersistentStorageOpCertStore mOpCertStore;
+    FabricTable mFabricTable;
+    Crypto::DefaultSessionKeystore mSessionKeystore;
+    TransportMgrBase mTransportMgr;
+    secure_channel::MessageCounterManager mMessageCounterManager;
+    SessionManager mSessionManager;
+    SessionHolder mSession;
+};
+
+void SessionManager_PrepareMessage(State & state)
+{
+    const size_t length = static_cast<size_t>(state.Arg());
+    SessionManagerContext context;
+    uint8_t payload[kMaxPayloadLength];
+    memset(payload, 0x5a, sizeof(payload));
+
+    if (length > kMaxPayloadLength || context.Init() != CHIP_NO_ERROR)
+    {
+        state.SkipWithError("session setup failed");
+    }
+
+    while (state.KeepRunning())
+    {
+        // Allocating and filling the buffer is part of sending any message, so it is measured too.
+        System::PacketBufferHandle buffer = System::PacketBufferHandle::NewWithData(payload, length);
+        PayloadHeader payloadHeader;
+        payloadHeader.SetMessageType(Protocols::Echo::MsgType::EchoRequest).SetInitiator(true);
+        EncryptedPacketBufferHandle prepared;
+        if (buffer.IsNull() ||
+            context.GetSessionManager().PrepareMessage(context.GetSession().Get().Value(), payloadHeader, std::move(buffer),
+                                                       prepared) != CHIP_NO_ERROR)
+        {
+            state.SkipWithError("PrepareMessage failed");
+            break;
+        }
+        Benchmark::DoNotOptimize(prepared);
+    }
+
+    state.SetItemsProcessed(state.Iterations());
+    state.SetBytesProcessed(state.Iterations() * length);
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(SessionManager_PrepareMessage, 64)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(SessionManager_PrepareMessage, 1024)
+
+} // namespace
+} // namespace chip
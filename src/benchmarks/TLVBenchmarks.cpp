@@ -0,0 +1,173 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "Benchmark.h"
+
+#include <lib/core/TLV.h>
+#include <lib/support/CodeUtils.h>
+
+namespace chip {
+namespace {
+
+using Benchmark::State;
+
+constexpr size_t kNumListEntries = 8;
+const uint8_t kOctets[] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+
+// A structure shaped like a typical attribute report payload: scalars, strings and a list of small structs.
+CHIP_ERROR EncodeStruct(TLV::TLVWriter & writer)
+{
+    TLV::TLVType outer;
+    TLV::TLVType list;
+    TLV::TLVType entry;
+
+    ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outer));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(0), static_cast<uint8_t>(1)));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(1), static_cast<uint16_t>(0x1234)));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(2), static_cast<uint32_t>(0x12345678)));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(3), static_cast<uint64_t>(0x123456789abcdef0)));
+    ReturnErrorOnFailure(writer.PutBoolean(TLV::ContextTag(4), true));
+    ReturnErrorOnFailure(writer.PutString(TLV::ContextTag(5), "living room light"));
+    ReturnErrorOnFailure(writer.Put(TLV::ContextTag(6), ByteSpan(kOctets)));
+
+    ReturnErrorOnFailure(writer.StartContainer(TLV::ContextTag(7), TLV::kTLVType_Array, list));
+    for (size_t i = 0; i < kNumListEntries; i++)
+    {
+        ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, entry));
+        ReturnErrorOnFailure(writer.Put(TLV::ContextTag(0), static_cast<uint16_t>(i)));
+        ReturnErrorOnFailure(writer.Put(TLV::ContextTag(1), static_cast<int32_t>(-1000 * static_cast<int32_t>(i))));
+        ReturnErrorOnFailure(writer.EndContainer(entry));
+    }
+    ReturnErrorOnFailure(writer.EndContainer(list));
+
+    ReturnErrorOnFailure(writer.EndContainer(outer));
+    return writer.Finalize();
+}
+
+// Visits and decodes every element, as a cluster object decoder would.
+CHIP_ERROR DecodeStruct(TLV::TLVReader & reader, uint64_t & checksum)
+{
+    TLV::TLVType outer;
+    ReturnErrorOnFailure(reader.Next(TLV::kTLVType_Structure, TLV::AnonymousTag()));
+    ReturnErrorOnFailure(reader.EnterContainer(outer));
+
+    CHIP_ERROR err;
+    while ((err = reader.Next()) == CHIP_NO_ERROR)
+    {
+        switch (reader.GetType())
+        {
+        case TLV::kTLVType_UnsignedInteger: {
+            uint64_t value;
+            ReturnErrorOnFailure(reader.Get(value));
+            checksum += value;
+            break;
+        }
+        case TLV::kTLVType_Boolean: {
+            bool value;
+            ReturnErrorOnFailure(reader.Get(value));
+            checksum += value ? 1 : 0;
+            break;
+        }
+        case TLV::kTLVType_UTF8String:
+        case TLV::kTLVType_ByteString: {
+            ByteSpan value;
+            ReturnErrorOnFailure(reader.Get(value));
+            checksum += value.size();
+            break;
+        }
+        case TLV::kTLVType_Array: {
+            TLV::TLVType list;
+            ReturnErrorOnFailure(reader.EnterContainer(list));
+            while ((err = reader.Next()) == CHIP_NO_ERROR)
+            {
+                TLV::TLVType entry;
+                uint16_t index;
+                int32_t value;
+                ReturnErrorOnFailure(reader.EnterContainer(entry));
+                ReturnErrorOnFailure(reader.Next(TLV::ContextTag(0)));
+                ReturnErrorOnFailure(reader.Get(index));
+                ReturnErrorOnFailure(reader.Next(TLV::ContextTag(1)));
+                ReturnErrorOnFailure(reader.Get(value));
+                ReturnErrorOnFailure(reader.ExitContainer(entry));
+                checksum += index + static_cast<uint64_t>(value);
+            }
+            VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
+            ReturnErrorOnFailure(reader.ExitContainer(list));
+            break;
+        }
+        default:
+            return CHIP_ERROR_WRONG_TLV_TYPE;
+        }
+    }
+    VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
+    return reader.ExitContainer(outer);
+}
+
+void TLVWriter_EncodeStruct(State & state)
+{
+    uint8_t buffer[256];
+    uint32_t length = 0;
+
+    while (state.KeepRunning())
+    {
+        TLV::TLVWriter writer;
+        writer.Init(buffer);
+        if (EncodeStruct(writer) != CHIP_NO_ERROR)
+        {
+            state.SkipWithError("encoding failed");
+            break;
+        }
+        length = writer.GetLengthWritten();
+        Benchmark::DoNotOptimize(buffer);
+    }
+
+    state.SetItemsProcessed(state.Iterations());
+    state.SetBytesProcessed(state.Iterations() * length);
+}
+CHIP_REGISTER_BENCHMARK(TLVWriter_EncodeStruct)
+
+void TLVReader_DecodeStruct(State & state)
+{
+    uint8_t buffer[256];
+    TLV::TLVWriter writer;
+    writer.Init(buffer);
+    if (EncodeStruct(writer) != CHIP_NO_ERROR)
+    {
+        state.SkipWithError("encoding failed");
+    }
+    const uint32_t length = writer.GetLengthWritten();
+
+    while (state.KeepRunning())
+    {
+        TLV::TLVReader reader;
+        uint64_t checksum = 0;
+        reader.Init(buffer, length);
+        if (DecodeStruct(reader, checksum) != CHIP_NO_ERROR)
+        {
+            state.SkipWithError("decoding failed");
+            break;
+        }
+        Benchmark::DoNotOptimize(checksum);
+    }
+
+    state.SetItemsProcessed(state.Iterations());
+    state.SetBytesProcessed(state.Iterations() * length);
+}
+CHIP_REGISTER_BENCHMARK(TLVReader_DecodeStruct)
+
+} // namespace
+} // namespace chip
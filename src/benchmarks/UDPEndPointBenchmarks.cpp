@@ -0,0 +1,181 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "Benchmark.h"
+
+#include <inet/IPPacketInfo.h>
+#include <inet/UDPEndPoint.h>
+#include <inet/UDPEndPointImpl.h>
+#include <lib/support/CodeUtils.h>
+#include <system/SystemLayerImpl.h>
+
+#include <string.h>
+#include <utility>
+
+namespace chip {
+namespace {
+
+using Benchmark::State;
+
+constexpr size_t kMaxBatchSize     = 16;
+constexpr size_t kPayloadLength    = 64;
+constexpr auto kStallCheckInterval = System::Clock::Seconds32(1);
+
+/**
+ * A UDP endpoint bound to the IPv6 loopback address that sends datagrams to itself, serviced by its own system layer.
+ */
+class LoopbackContext
+{
+public:
+    ~LoopbackContext()
+    {
+        if (mEndPoint != nullptr)
+        {
+            mEndPoint->Free();
+        }
+        if (mSystemLayer.IsInitialized())
+        {
+            mSystemLayer.CancelTimer(OnStallCheck, this);
+            mUDPEndPointManager.Shutdown();
+            mSystemLayer.Shutdown();
+        }
+    }
+
+    CHIP_ERROR Init()
+    {
+        const Inet::IPAddress loopback = Inet::IPAddress::Loopback(Inet::IPAddressType::kIPv6);
+
+        ReturnErrorOnFailure(mSystemLayer.Init());
+        ReturnErrorOnFailure(mUDPEndPointManager.Init(mSystemLayer));
+        ReturnErrorOnFailure(mUDPEndPointManager.NewEndPoint(&mEndPoint));
+        ReturnErrorOnFailure(mEndPoint->Bind(Inet::IPAddressType::kIPv6, loopback, 0));
+        ReturnErrorOnFailure(mEndPoint->Listen(OnMessageReceived, nullptr, this));
+
+        mPktInfo.Clear();
+        mPktInfo.DestAddress = loopback;
+        mPktInfo.DestPort    = mEndPoint->GetBoundPort();
+
+        // Nothing is expected to be lost on loopback, but a lost datagram must fail the benchmark rather than hang it.
+        return mSystemLayer.StartTimer(kStallCheckInterval, OnStallCheck, this);
+    }
+
+    /**
+     * Send count datagrams, with a single SendMsgs() call if batched is set and one SendMsg() call each otherwise, then
+     * service the system layer until they have all been received.
+     */
+    CHIP_ERROR SendAndReceive(size_t count, bool batched)
+    {
+        Inet::IPPacketInfo pktInfos[kMaxBatchSize];
+        System::PacketBufferHandle msgs[kMaxBatchSize];
+        VerifyOrReturnError(count <= kMaxBatchSize, CHIP_ERROR_INVALID_ARGUMENT);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            pktInfos[i] = mPktInfo;
+            msgs[i]     = System::PacketBufferHandle::NewWithData(mPayload, sizeof(mPayload));
+            VerifyOrReturnError(!msgs[i].IsNull(), CHIP_ERROR_NO_MEMORY);
+        }
+
+        const uint64_t expectedCount = mReceivedCount + count;
+        if (batched)
+        {
+            size_t sentCount = 0;
+            ReturnErrorOnFailure(mEndPoint->SendMsgs(pktInfos, msgs, count, sentCount));
+        }
+        else
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                ReturnErrorOnFailure(mEndPoint->SendMsg(&pktInfos[i], std::move(msgs[i])));
+            }
+        }
+
+        while (mReceivedCount < expectedCount)
+        {
+            VerifyOrReturnError(!mStalled, CHIP_ERROR_TIMEOUT);
+            mSystemLayer.PrepareEvents();
+            mSystemLayer.WaitForEvents();
+            mSystemLayer.HandleEvents();
+        }
+
+        return CHIP_NO_ERROR;
+    }
+
+private:
+    static void OnMessageReceived(Inet::UDPEndPoint * endPoint, System::PacketBufferHandle && buffer,
+                                  const Inet::IPPacketInfo * pktInfo)
+    {
+        static_cast<LoopbackContext *>(endPoint->mAppState)->mReceivedCount++;
+    }
+
+    static void OnStallCheck(System::Layer * layer, void * appState)
+    {
+        auto * context = static_cast<LoopbackContext *>(appState);
+        context->mStalled |= (context->mReceivedCount == context->mReceivedCountAtLastCheck);
+        context->mReceivedCountAtLastCheck = context->mReceivedCount;
+        layer->StartTimer(kStallCheckInterval, OnStallCheck, appState);
+    }
+
+    System::LayerImpl mSystemLayer;
+    Inet::UDPEndPointManagerImpl mUDPEndPointManager;
+    Inet::UDPEndPoint * mEndPoint = nullptr;
+    Inet::IPPacketInfo mPktInfo;
+    uint8_t mPayload[kPayloadLength]   = {};
+    uint64_t mReceivedCount            = 0;
+    uint64_t mReceivedCountAtLastCheck = 0;
+    bool mStalled                      = false;
+};
+
+void RunLoopback(State & state, bool batched)
+{
+    const size_t batchSize = static_cast<size_t>(state.Arg());
+    LoopbackContext context;
+
+    if (batchSize > kMaxBatchSize || context.Init() != CHIP_NO_ERROR)
+    {
+        state.SkipWithError("loopback endpoint setup failed");
+    }
+
+    while (state.KeepRunning())
+    {
+        if (context.SendAndReceive(batchSize, batched) != CHIP_NO_ERROR)
+        {
+            state.SkipWithError("loopback send or receive failed");
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.Iterations() * batchSize);
+}
+
+// Datagrams sent one SendMsg() at a time, to compare with the batched send below.  Both go through the same receive
+// path, which reads as many datagrams per wakeup as are queued.
+void UDPEndPoint_LoopbackSendMsg(State & state)
+{
+    RunLoopback(state, false);
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(UDPEndPoint_LoopbackSendMsg, 1)
+CHIP_REGISTER_BENCHMARK_WITH_ARG(UDPEndPoint_LoopbackSendMsg, 8)
+
+void UDPEndPoint_LoopbackSendMsgs(State & state)
+{
+    RunLoopback(state, true);
+}
+CHIP_REGISTER_BENCHMARK_WITH_ARG(UDPEndPoint_LoopbackSendMsgs, 8)
+
+} // namespace
+} // namespace chip
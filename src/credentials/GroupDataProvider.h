@@ -311,12 +311,26 @@ public:
     // Decryption
     virtual GroupSessionIterator * IterateGroupSessions(uint16_t session_id)                        = 0;
     virtual Crypto::SymmetricKeyContext * GetKeyContext(FabricIndex fabric_index, GroupId group_id) = 0;
+    /**
+     *  Hint that `session`, obtained from a GroupSessionIterator, successfully decrypted a message. Implementations
+     *  that cache group sessions may use it to return that session first for later messages with the same session id.
+     *  Must be called before the iterator is released.
+     */
+    virtual void GroupSessionMatched(const GroupSession & session) {}
+
+    /**
+     *  Counter that changes whenever a key set is set or removed, including through RemoveFabric. Callers that keep
+     *  copies of key set material, such as the IPKs used to match CASE destination identifiers, compare it to know
+     *  when to reload them. Implementations must call KeySetsChanged() on every such change.
+     */
+    uint32_t GetKeySetGeneration() const { return mKeySetGeneration; }
 
     // Listener
     void SetListener(GroupListener * listener) { mListener = listener; };
     void RemoveListener() { mListener = nullptr; };
 
 protected:
+    void KeySetsChanged() { ++mKeySetGeneration; }
     void GroupAdded(FabricIndex fabric_index, const GroupInfo & new_group)
     {
         if (mListener)
@@ -333,7 +347,8 @@ protected:
     }
     const uint16_t mMaxGroupsPerFabric;
     const uint16_t mMaxGroupKeysPerFabric;
-    GroupListener * mListener = nullptr;
+    GroupListener * mListener  = nullptr;
+    uint32_t mKeySetGeneration = 0;
 };
 
 /**
@@ -815,6 +815,20 @@ struct KeySetData : PersistentData<kPersistentBufferMax>
 constexpr size_t GroupDataProvider::GroupInfo::kGroupNameMax;
 constexpr size_t GroupDataProviderImpl::kIteratorsMax;
 
+GroupDataProviderImpl::~GroupDataProviderImpl()
+{
+#if CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE > 0
+    // Finish() may not have been called and the session keystore may already be gone, so only free the cache entries;
+    // their key handles clear themselves.
+    while (mGroupSessionCache != nullptr)
+    {
+        CachedGroupSession * entry = mGroupSessionCache;
+        mGroupSessionCache         = entry->mNext;
+        mGroupSessionCachePool.ReleaseObject(entry);
+    }
+#endif // CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE > 0
+}
+
 CHIP_ERROR GroupDataProviderImpl::Init()
 {
     if (mStorage == nullptr || mSessionKeystore == nullptr)
@@ -832,6 +846,8 @@ void GroupDataProviderImpl::Finish()
     mKeySetIterators.ReleaseAll();
     mGroupSessionsIterator.ReleaseAll();
     mGroupKeyContexPool.ReleaseAll();
+    InvalidateGroupSessionCache();
+    KeySetsChanged();
 }
 
 void GroupDataProviderImpl::SetStorageDelegate(PersistentStorageDelegate * storage)
@@ -1349,6 +1365,7 @@ CHIP_ERROR GroupDataProviderImpl::RemoveEndpoints(chip::FabricIndex fabric_index
 CHIP_ERROR GroupDataProviderImpl::SetGroupKeyAt(chip::FabricIndex fabric_index, size_t index, const GroupKey & in_map)
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
+    InvalidateGroupSessionCache();
 
     FabricData fabric(fabric_index);
     KeyMapData map(fabric_index);
@@ -1415,6 +1432,7 @@ CHIP_ERROR GroupDataProviderImpl::GetGroupKeyAt(chip::FabricIndex fabric_index,
 CHIP_ERROR GroupDataProviderImpl::RemoveGroupKeyAt(chip::FabricIndex fabric_index, size_t index)
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
+    InvalidateGroupSessionCache();
 
     FabricData fabric(fabric_index);
     KeyMapData map;
@@ -1447,6 +1465,7 @@ CHIP_ERROR GroupDataProviderImpl::RemoveGroupKeyAt(chip::FabricIndex fabric_inde
 CHIP_ERROR GroupDataProviderImpl::RemoveGroupKeys(chip::FabricIndex fabric_index)
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
+    InvalidateGroupSessionCache();
 
     FabricData fabric(fabric_index);
     VerifyOrReturnError(CHIP_NO_ERROR == fabric.Load(mStorage), CHIP_ERROR_INVALID_FABRIC_INDEX);
@@ -1523,6 +1542,8 @@ CHIP_ERROR GroupDataProviderImpl::SetKeySet(chip::FabricIndex fabric_index, cons
                                             const KeySet & in_keyset)
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
+    InvalidateGroupSessionCache();
+    KeySetsChanged();
 
     FabricData fabric(fabric_index);
     KeySetData keyset;
@@ -1594,6 +1615,8 @@ CHIP_ERROR GroupDataProviderImpl::GetKeySet(chip::FabricIndex fabric_index, uint
 CHIP_ERROR GroupDataProviderImpl::RemoveKeySet(chip::FabricIndex fabric_index, uint16_t target_id)
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
+    InvalidateGroupSessionCache();
+    KeySetsChanged();
 
     FabricData fabric(fabric_index);
     KeySetData keyset;
@@ -1695,6 +1718,9 @@ void GroupDataProviderImpl::KeySetIteratorImpl::Release()
 
 CHIP_ERROR GroupDataProviderImpl::RemoveFabric(chip::FabricIndex fabric_index)
 {
+    InvalidateGroupSessionCache();
+    KeySetsChanged();
+
     FabricData fabric(fabric_index);
 
     // Fabric data defaults to zero, so if not entry is found, no mappings, or keys are removed
@@ -1839,12 +1865,40 @@ CHIP_ERROR GroupDataProviderImpl::GroupKeyContext::PrivacyDecrypt(const ByteSpan
 GroupDataProviderImpl::GroupSessionIterator * GroupDataProviderImpl::IterateGroupSessions(uint16_t session_id)
 {
     VerifyOrReturnError(IsInitialized(), nullptr);
-    return mGroupSessionsIterator.CreateObject(*this, session_id);
+
+    // Cache entries are only added or evicted while no iterator may be referring to them.
+    bool from_cache = IsGroupSessionCached(session_id) ||
+        (mGroupSessionsIterator.Allocated() == 0 && CacheGroupSessions(session_id));
+    return mGroupSessionsIterator.CreateObject(*this, session_id, from_cache);
+}
+
+void GroupDataProviderImpl::GroupSessionMatched(const GroupSession & session)
+{
+    CachedGroupSession ** link = &mGroupSessionCache;
+    for (; *link != nullptr; link = &(*link)->mNext)
+    {
+        CachedGroupSession * entry = *link;
+        if (&entry->mKeyContext == session.keyContext)
+        {
+            // Move to the front
+            *link              = entry->mNext;
+            entry->mNext       = mGroupSessionCache;
+            mGroupSessionCache = entry;
+            return;
+        }
+    }
 }
 
-GroupDataProviderImpl::GroupSessionIteratorImpl::GroupSessionIteratorImpl(GroupDataProviderImpl & provider, uint16_t session_id) :
-    mProvider(provider), mSessionId(session_id), mGroupKeyContext(provider)
+GroupDataProviderImpl::GroupSessionIteratorImpl::GroupSessionIteratorImpl(GroupDataProviderImpl & provider, uint16_t session_id,
+                                                                          bool from_cache) :
+    mProvider(provider), mFromCache(from_cache), mSessionId(session_id), mGroupKeyContext(provider)
 {
+    if (mFromCache)
+    {
+        mCached = provider.mGroupSessionCache;
+        return;
+    }
+
     FabricList fabric_list;
     ReturnOnFailure(fabric_list.Load(provider.mStorage));
     mFirstFabric = fabric_list.first_entry;
@@ -1857,9 +1911,22 @@ GroupDataProviderImpl::GroupSessionIteratorImpl::GroupSessionIteratorImpl(GroupD
 
 size_t GroupDataProviderImpl::GroupSessionIteratorImpl::Count()
 {
-    FabricData fabric(mFirstFabric);
     size_t count = 0;
 
+    if (mFromCache)
+    {
+        for (CachedGroupSession * entry = mProvider.mGroupSessionCache; entry != nullptr; entry = entry->mNext)
+        {
+            if (entry->mSessionId == mSessionId)
+            {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    FabricData fabric(mFirstFabric);
+
     for (size_t i = 0; i < mFabricTotal; i++, fabric.fabric_index = fabric.next)
     {
         if (CHIP_NO_ERROR != fabric.Load(mProvider.mStorage))
@@ -1897,6 +1964,36 @@ size_t GroupDataProviderImpl::GroupSessionIteratorImpl::Count()
 }
 
 bool GroupDataProviderImpl::GroupSessionIteratorImpl::Next(GroupSession & output)
+{
+    if (mFromCache)
+    {
+        for (; mCached != nullptr; mCached = mCached->mNext)
+        {
+            if (mCached->mSessionId == mSessionId)
+            {
+                output.fabric_index    = mCached->mFabricIndex;
+                output.group_id        = mCached->mGroupId;
+                output.security_policy = mCached->mSecurityPolicy;
+                output.keyContext      = &mCached->mKeyContext;
+                mCached                = mCached->mNext;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Crypto::GroupOperationalCredentials creds;
+    bool found = NextKey(output, creds);
+    if (found)
+    {
+        mGroupKeyContext.Initialize(creds.encryption_key, mSessionId, creds.privacy_key);
+        output.keyContext = &mGroupKeyContext;
+    }
+    Crypto::ClearSecretData(reinterpret_cast<uint8_t *>(&creds), sizeof(creds));
+    return found;
+}
+
+bool GroupDataProviderImpl::GroupSessionIteratorImpl::NextKey(GroupSession & output, Crypto::GroupOperationalCredentials & creds)
 {
     while (mFabricCount < mFabricTotal)
     {
@@ -1935,14 +2032,14 @@ bool GroupDataProviderImpl::GroupSessionIteratorImpl::Next(GroupSession & output
             continue;
         }
 
-        Crypto::GroupOperationalCredentials & creds = keyset.operational_keys[mKeyIndex++];
-        if (creds.hash == mSessionId)
+        Crypto::GroupOperationalCredentials & key = keyset.operational_keys[mKeyIndex++];
+        if (key.hash == mSessionId)
         {
-            mGroupKeyContext.Initialize(creds.encryption_key, mSessionId, creds.privacy_key);
+            creds                  = key;
             output.fabric_index    = fabric.fabric_index;
             output.group_id        = mapping.group_id;
             output.security_policy = keyset.policy;
-            output.keyContext      = &mGroupKeyContext;
+            output.keyContext      = nullptr;
             return true;
         }
     }
@@ -1956,6 +2053,120 @@ void GroupDataProviderImpl::GroupSessionIteratorImpl::Release()
     mProvider.mGroupSessionsIterator.ReleaseObject(this);
 }
 
+//
+// Group session cache
+//
+
+bool GroupDataProviderImpl::IsGroupSessionCached(uint16_t session_id) const
+{
+    for (CachedGroupSession * entry = mGroupSessionCache; entry != nullptr; entry = entry->mNext)
+    {
+        if (entry->mSessionId == session_id)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool GroupDataProviderImpl::CacheGroupSessions(uint16_t session_id)
+{
+#if CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE > 0
+    GroupSessionIteratorImpl iter(*this, session_id);
+    GroupSession session;
+    Crypto::GroupOperationalCredentials creds;
+    size_t count = 0;
+    bool cached  = true;
+
+    while (iter.NextKey(session, creds))
+    {
+        CachedGroupSession * entry = nullptr;
+        if (mGroupSessionCacheCount < CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE || EvictLeastRecentGroupSessions(session_id))
+        {
+            entry = mGroupSessionCachePool.CreateObject(*this);
+        }
+        if (entry == nullptr)
+        {
+            // More keys share this session id than the cache can hold
+            cached = false;
+            break;
+        }
+
+        entry->mKeyContext.Initialize(creds.encryption_key, session_id, creds.privacy_key);
+        entry->mSessionId      = session_id;
+        entry->mFabricIndex    = session.fabric_index;
+        entry->mGroupId        = session.group_id;
+        entry->mSecurityPolicy = session.security_policy;
+        entry->mNext           = mGroupSessionCache;
+        mGroupSessionCache     = entry;
+        mGroupSessionCacheCount++;
+        count++;
+    }
+    Crypto::ClearSecretData(reinterpret_cast<uint8_t *>(&creds), sizeof(creds));
+
+    // Only a complete set of keys may be cached, otherwise a partial set would hide the other keys from decryption.
+    if (!cached || !iter.IsComplete())
+    {
+        EvictGroupSessions(session_id);
+        return false;
+    }
+    return count > 0;
+#else
+    return false;
+#endif // CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE > 0
+}
+
+bool GroupDataProviderImpl::EvictLeastRecentGroupSessions(uint16_t keep_session_id)
+{
+    CachedGroupSession * last = mGroupSessionCache;
+    VerifyOrReturnError(last != nullptr, false);
+    while (last->mNext != nullptr)
+    {
+        last = last->mNext;
+    }
+    // New entries are added at the front, so this is only true if the whole cache holds keep_session_id.
+    VerifyOrReturnError(last->mSessionId != keep_session_id, false);
+
+    EvictGroupSessions(last->mSessionId);
+    return true;
+}
+
+void GroupDataProviderImpl::EvictGroupSessions(uint16_t session_id)
+{
+#if CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE > 0
+    CachedGroupSession ** link = &mGroupSessionCache;
+    while (*link != nullptr)
+    {
+        CachedGroupSession * entry = *link;
+        if (entry->mSessionId == session_id)
+        {
+            *link = entry->mNext;
+            entry->mKeyContext.ReleaseKeys();
+            mGroupSessionCachePool.ReleaseObject(entry);
+            mGroupSessionCacheCount--;
+        }
+        else
+        {
+            link = &entry->mNext;
+        }
+    }
+#endif // CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE > 0
+}
+
+void GroupDataProviderImpl::InvalidateGroupSessionCache()
+{
+#if CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE > 0
+    while (mGroupSessionCache != nullptr)
+    {
+        CachedGroupSession * entry = mGroupSessionCache;
+        mGroupSessionCache         = entry->mNext;
+        entry->mKeyContext.ReleaseKeys();
+        mGroupSessionCachePool.ReleaseObject(entry);
+    }
+    mGroupSessionCacheCount = 0;
+#endif // CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE > 0
+}
+
 namespace {
 
 GroupDataProvider * gGroupsProvider = nullptr;
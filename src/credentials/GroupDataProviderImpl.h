@@ -33,7 +33,7 @@ public:
     GroupDataProviderImpl(uint16_t maxGroupsPerFabric, uint16_t maxGroupKeysPerFabric) :
         GroupDataProvider(maxGroupsPerFabric, maxGroupKeysPerFabric)
     {}
-    ~GroupDataProviderImpl() override {}
+    ~GroupDataProviderImpl() override;
 
     /**
      * @brief Set the storage implementation used for non-volatile storage of configuration data.
@@ -96,6 +96,7 @@ public:
     // Decryption
     Crypto::SymmetricKeyContext * GetKeyContext(FabricIndex fabric_index, GroupId group_id) override;
     GroupSessionIterator * IterateGroupSessions(uint16_t session_id) override;
+    void GroupSessionMatched(const GroupSession & session) override;
 
 protected:
     class GroupInfoIteratorImpl : public GroupInfoIterator
@@ -205,6 +206,23 @@ protected:
         Crypto::Aes128KeyHandle mPrivacyKey;
     };
 
+    /**
+     * A group session whose keys are already loaded in the session keystore. For every session id present in the
+     * cache, the cache holds all the keys with that id, so iterating it is equivalent to iterating the storage.
+     */
+    struct CachedGroupSession
+    {
+        CachedGroupSession(GroupDataProviderImpl & provider) : mKeyContext(provider) {}
+
+        GroupKeyContext mKeyContext;
+        uint16_t mSessionId            = 0;
+        FabricIndex mFabricIndex       = kUndefinedFabricIndex;
+        GroupId mGroupId               = kUndefinedGroupId;
+        SecurityPolicy mSecurityPolicy = SecurityPolicy::kTrustFirst;
+        // Next entry, in order of most recent successful match.
+        CachedGroupSession * mNext = nullptr;
+    };
+
     class KeySetIteratorImpl : public KeySetIterator
     {
     public:
@@ -224,28 +242,42 @@ protected:
     class GroupSessionIteratorImpl : public GroupSessionIterator
     {
     public:
-        GroupSessionIteratorImpl(GroupDataProviderImpl & provider, uint16_t session_id);
+        GroupSessionIteratorImpl(GroupDataProviderImpl & provider, uint16_t session_id, bool from_cache = false);
         size_t Count() override;
         bool Next(GroupSession & output) override;
         void Release() override;
 
+        // Storage iteration only: finds the next key matching the session id without loading it in the keystore.
+        bool NextKey(GroupSession & output, Crypto::GroupOperationalCredentials & creds);
+        // Storage iteration only: true once all the keys of all the fabrics have been visited.
+        bool IsComplete() const { return mFabricCount >= mFabricTotal; }
+
     protected:
         GroupDataProviderImpl & mProvider;
-        uint16_t mSessionId      = 0;
-        FabricIndex mFirstFabric = kUndefinedFabricIndex;
-        FabricIndex mFabric      = kUndefinedFabricIndex;
-        uint16_t mFabricCount    = 0;
-        uint16_t mFabricTotal    = 0;
-        uint16_t mMapping        = 0;
-        uint16_t mMapCount       = 0;
-        uint16_t mKeyIndex       = 0;
-        uint16_t mKeyCount       = 0;
-        bool mFirstMap           = true;
+        CachedGroupSession * mCached = nullptr;
+        bool mFromCache              = false;
+        uint16_t mSessionId          = 0;
+        FabricIndex mFirstFabric     = kUndefinedFabricIndex;
+        FabricIndex mFabric          = kUndefinedFabricIndex;
+        uint16_t mFabricCount        = 0;
+        uint16_t mFabricTotal        = 0;
+        uint16_t mMapping            = 0;
+        uint16_t mMapCount           = 0;
+        uint16_t mKeyIndex           = 0;
+        uint16_t mKeyCount           = 0;
+        bool mFirstMap               = true;
         GroupKeyContext mGroupKeyContext;
     };
     bool IsInitialized() { return (mStorage != nullptr); }
     CHIP_ERROR RemoveEndpoints(FabricIndex fabric_index, GroupId group_id);
 
+    // Group session cache
+    bool IsGroupSessionCached(uint16_t session_id) const;
+    bool CacheGroupSessions(uint16_t session_id);
+    bool EvictLeastRecentGroupSessions(uint16_t keep_session_id);
+    void EvictGroupSessions(uint16_t session_id);
+    void InvalidateGroupSessionCache();
+
     PersistentStorageDelegate * mStorage       = nullptr;
     Crypto::SessionKeystore * mSessionKeystore = nullptr;
     ObjectPool<GroupInfoIteratorImpl, kIteratorsMax> mGroupInfoIterators;
@@ -254,6 +286,12 @@ protected:
     ObjectPool<KeySetIteratorImpl, kIteratorsMax> mKeySetIterators;
     ObjectPool<GroupSessionIteratorImpl, kIteratorsMax> mGroupSessionsIterator;
     ObjectPool<GroupKeyContext, kIteratorsMax> mGroupKeyContexPool;
+#if CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE > 0
+    ObjectPool<CachedGroupSession, CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE> mGroupSessionCachePool;
+#endif
+    // Most recently matched first
+    CachedGroupSession * mGroupSessionCache = nullptr;
+    size_t mGroupSessionCacheCount          = 0;
 };
 
 } // namespace Credentials
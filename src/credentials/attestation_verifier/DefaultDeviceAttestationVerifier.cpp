@@ -24,12 +24,17 @@
 #include <credentials/attestation_verifier/TestPAAStore.h>
 #include <crypto/CHIPCryptoPAL.h>
 
+#include <lib/asn1/ASN1.h>
+#include <lib/asn1/ASN1Macros.h>
 #include <lib/core/CHIPError.h>
 #include <lib/core/Global.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/ScopedBuffer.h>
 #include <lib/support/Span.h>
 
+#include <algorithm>
+#include <string.h>
+
 using namespace chip::Crypto;
 using chip::TestCerts::GetTestPaaRootStore;
 
@@ -308,8 +313,292 @@ AttestationVerificationResult MapError(CertificateChainValidationResult certific
         return AttestationVerificationResult::kInternalError;
     }
 }
+
+/**
+ * The fields of an X.509 attestation certificate needed to check that it was issued by another one.
+ */
+struct AttestationCertificateFields
+{
+    ByteSpan tbsCertificate;
+    ByteSpan issuer;
+    ByteSpan subject;
+    ASN1::ASN1UniversalTime notBefore;
+    ASN1::ASN1UniversalTime notAfter;
+    ByteSpan publicKey;
+    ByteSpan authorityKeyId;
+    ByteSpan subjectKeyId;
+    P256ECDSASignature signature;
+};
+
+CHIP_ERROR DecodeKeyIdentifierExtension(ASN1::ASN1Reader & reader, ASN1::OID extensionOID, AttestationCertificateFields & fields)
+{
+    using namespace ASN1;
+
+    CHIP_ERROR err = CHIP_NO_ERROR;
+
+    if (extensionOID == kOID_Extension_AuthorityKeyIdentifier)
+    {
+        // AuthorityKeyIdentifier ::= SEQUENCE { keyIdentifier [0] IMPLICIT KeyIdentifier OPTIONAL, ... }
+        ASN1_PARSE_ENTER_SEQUENCE
+        {
+            ASN1_PARSE_ELEMENT(kASN1TagClass_ContextSpecific, 0);
+            fields.authorityKeyId = ByteSpan(reader.GetValue(), reader.GetValueLen());
+        }
+        ASN1_SKIP_AND_EXIT_SEQUENCE;
+    }
+    else if (extensionOID == kOID_Extension_SubjectKeyIdentifier)
+    {
+        // SubjectKeyIdentifier ::= KeyIdentifier
+        ASN1_PARSE_ELEMENT(kASN1TagClass_Universal, kASN1UniversalTag_OctetString);
+        fields.subjectKeyId = ByteSpan(reader.GetValue(), reader.GetValueLen());
+    }
+
+exit:
+    return err;
+}
+
+/**
+ * Decode the fields of a DER encoded X.509 certificate signed with ECDSA with SHA-256 and holding a P-256 public key.
+ * The spans of the result point into the certificate.
+ */
+CHIP_ERROR DecodeAttestationCertificateFields(const ByteSpan & certificate, AttestationCertificateFields & fields)
+{
+    using namespace ASN1;
+
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    ASN1Reader reader;
+    OID oid;
+    const uint8_t * element;
+    uint32_t elementLen;
+
+    reader.Init(certificate);
+
+    // Certificate ::= SEQUENCE
+    ASN1_PARSE_ENTER_SEQUENCE
+    {
+        // tbsCertificate TBSCertificate
+        ASN1_PARSE_ELEMENT(kASN1TagClass_Universal, kASN1UniversalTag_Sequence);
+        ReturnErrorOnFailure(reader.GetConstructedType(element, elementLen));
+        fields.tbsCertificate = ByteSpan(element, elementLen);
+
+        ASN1_ENTER_SEQUENCE
+        {
+            // version [0] EXPLICIT Version, serialNumber CertificateSerialNumber, signature AlgorithmIdentifier
+            ASN1_PARSE_ELEMENT(kASN1TagClass_ContextSpecific, 0);
+            ASN1_PARSE_ELEMENT(kASN1TagClass_Universal, kASN1UniversalTag_Integer);
+            ASN1_PARSE_ELEMENT(kASN1TagClass_Universal, kASN1UniversalTag_Sequence);
+
+            // issuer Name
+            ASN1_PARSE_ELEMENT(kASN1TagClass_Universal, kASN1UniversalTag_Sequence);
+            ReturnErrorOnFailure(reader.GetConstructedType(element, elementLen));
+            fields.issuer = ByteSpan(element, elementLen);
+
+            // validity Validity
+            ASN1_PARSE_ENTER_SEQUENCE
+            {
+                ASN1_PARSE_TIME(fields.notBefore);
+                ASN1_PARSE_TIME(fields.notAfter);
+            }
+            ASN1_EXIT_SEQUENCE;
+
+            // subject Name
+            ASN1_PARSE_ELEMENT(kASN1TagClass_Universal, kASN1UniversalTag_Sequence);
+            ReturnErrorOnFailure(reader.GetConstructedType(element, elementLen));
+            fields.subject = ByteSpan(element, elementLen);
+
+            // subjectPublicKeyInfo SubjectPublicKeyInfo
+            ASN1_PARSE_ENTER_SEQUENCE
+            {
+                ASN1_PARSE_ENTER_SEQUENCE
+                {
+                    ASN1_PARSE_OBJECT_ID(oid);
+                    VerifyOrExit(oid == kOID_PubKeyAlgo_ECPublicKey, err = ASN1_ERROR_UNSUPPORTED_ENCODING);
+                    ASN1_PARSE_OBJECT_ID(oid);
+                    VerifyOrExit(oid == kOID_EllipticCurve_prime256v1, err = ASN1_ERROR_UNSUPPORTED_ENCODING);
+                }
+                ASN1_EXIT_SEQUENCE;
+
+                ASN1_PARSE_ELEMENT(kASN1TagClass_Universal, kASN1UniversalTag_BitString);
+                VerifyOrExit(reader.GetValueLen() == kP256_PublicKey_Length + 1 && reader.GetValue()[0] == 0,
+                             err = ASN1_ERROR_UNSUPPORTED_ENCODING);
+                fields.publicKey = ByteSpan(reader.GetValue() + 1, kP256_PublicKey_Length);
+            }
+            ASN1_EXIT_SEQUENCE;
+
+            // extensions [3] EXPLICIT Extensions
+            ASN1_PARSE_ENTER_CONSTRUCTED(kASN1TagClass_ContextSpecific, 3)
+            {
+                ASN1_PARSE_ENTER_SEQUENCE
+                {
+                    while ((err = reader.Next()) == CHIP_NO_ERROR)
+                    {
+                        // Extension ::= SEQUENCE { extnID, critical BOOLEAN DEFAULT FALSE, extnValue OCTET STRING }
+                        ASN1_ENTER_SEQUENCE
+                        {
+                            ASN1_PARSE_OBJECT_ID(oid);
+                            ASN1_PARSE_ANY;
+                            if (reader.GetClass() == kASN1TagClass_Universal && reader.GetTag() == kASN1UniversalTag_Boolean)
+                            {
+                                ASN1_PARSE_ANY;
+                            }
+                            if (oid == kOID_Extension_AuthorityKeyIdentifier || oid == kOID_Extension_SubjectKeyIdentifier)
+                            {
+                                ASN1_ENTER_ENCAPSULATED(kASN1TagClass_Universal, kASN1UniversalTag_OctetString)
+                                {
+                                    SuccessOrExit(err = DecodeKeyIdentifierExtension(reader, oid, fields));
+                                }
+                                ASN1_EXIT_ENCAPSULATED;
+                            }
+                        }
+                        ASN1_EXIT_SEQUENCE;
+                    }
+                    if (err != ASN1_END)
+                    {
+                        SuccessOrExit(err);
+                    }
+                }
+                ASN1_EXIT_SEQUENCE;
+            }
+            ASN1_EXIT_CONSTRUCTED;
+        }
+        ASN1_EXIT_SEQUENCE;
+
+        // signatureAlgorithm AlgorithmIdentifier
+        ASN1_PARSE_ENTER_SEQUENCE
+        {
+            ASN1_PARSE_OBJECT_ID(oid);
+            VerifyOrExit(oid == kOID_SigAlgo_ECDSAWithSHA256, err = ASN1_ERROR_UNSUPPORTED_ENCODING);
+        }
+        ASN1_SKIP_AND_EXIT_SEQUENCE;
+
+        // signatureValue BIT STRING, holding the DER encoded Ecdsa-Sig-Value
+        ASN1_PARSE_ELEMENT(kASN1TagClass_Universal, kASN1UniversalTag_BitString);
+        VerifyOrExit(reader.GetValueLen() > 1 && reader.GetValue()[0] == 0, err = ASN1_ERROR_INVALID_ENCODING);
+
+        MutableByteSpan rawSignature(fields.signature.Bytes(), fields.signature.Capacity());
+        ReturnErrorOnFailure(EcdsaAsn1SignatureToRaw(kP256_FE_Length,
+                                                     ByteSpan(reader.GetValue() + 1, reader.GetValueLen() - 1u), rawSignature));
+        ReturnErrorOnFailure(fields.signature.SetLength(rawSignature.size()));
+    }
+    ASN1_EXIT_SEQUENCE;
+
+exit:
+    return err;
+}
+
+int CompareTimes(const ASN1::ASN1UniversalTime & a, const ASN1::ASN1UniversalTime & b)
+{
+    const uint8_t aFields[] = { a.Month, a.Day, a.Hour, a.Minute, a.Second };
+    const uint8_t bFields[] = { b.Month, b.Day, b.Hour, b.Minute, b.Second };
+
+    if (a.Year != b.Year)
+    {
+        return (a.Year < b.Year) ? -1 : 1;
+    }
+    return memcmp(aFields, bFields, sizeof(aFields));
+}
+
 } // namespace
 
+CHIP_ERROR DefaultDACVerifier::SetVerifiedPaiCacheSize(size_t size)
+{
+    mVerifiedPais.Free();
+    mNumVerifiedPais         = 0;
+    mNextVerifiedPai         = 0;
+    mVerifiedPaiCacheSizeSet = true;
+
+    if (size > 0)
+    {
+        VerifyOrReturnError(mVerifiedPais.Calloc(size), CHIP_ERROR_NO_MEMORY);
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR DefaultDACVerifier::InitVerifiedPai(VerifiedPai & verifiedPai, const ByteSpan & paaDer, const ByteSpan & paiDer)
+{
+    AttestationCertificateFields paa;
+    AttestationCertificateFields pai;
+
+    ReturnErrorOnFailure(DecodeAttestationCertificateFields(paaDer, paa));
+    ReturnErrorOnFailure(DecodeAttestationCertificateFields(paiDer, pai));
+    VerifyOrReturnError(pai.subjectKeyId.size() == sizeof(verifiedPai.paiSkid), CHIP_ERROR_WRONG_CERT_TYPE);
+
+    ReturnErrorOnFailure(Hash_SHA256(pai.subject.data(), pai.subject.size(), verifiedPai.paiSubjectHash));
+    memcpy(verifiedPai.paiSkid, pai.subjectKeyId.data(), sizeof(verifiedPai.paiSkid));
+    memcpy(verifiedPai.paiPublicKey, pai.publicKey.data(), sizeof(verifiedPai.paiPublicKey));
+    verifiedPai.dacNotBeforeMin = (CompareTimes(pai.notBefore, paa.notBefore) > 0) ? pai.notBefore : paa.notBefore;
+    verifiedPai.dacNotBeforeMax = (CompareTimes(pai.notAfter, paa.notAfter) < 0) ? pai.notAfter : paa.notAfter;
+
+    return CHIP_NO_ERROR;
+}
+
+bool DefaultDACVerifier::IsIssuedByVerifiedPai(const VerifiedPai & verifiedPai, const ByteSpan & dacDer)
+{
+    AttestationCertificateFields dac;
+    uint8_t issuerHash[kSHA256_Hash_Length];
+
+    // The DAC is not part of what was cached, so it still goes through the crypto PAL checks of a DAC, which are as strict
+    // as those ValidateCertificateChain() applies to the leaf: encoding, version, signature algorithm, key usage, basic
+    // constraints and key identifiers.
+    VerifyOrReturnValue(VerifyAttestationCertificateFormat(dacDer, AttestationCertType::kDAC) == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(DecodeAttestationCertificateFields(dacDer, dac) == CHIP_NO_ERROR, false);
+    VerifyOrReturnValue(Hash_SHA256(dac.issuer.data(), dac.issuer.size(), issuerHash) == CHIP_NO_ERROR, false);
+
+    // The checks ValidateCertificateChain() makes on the DAC against its issuer: it names the PAI as its issuer, was issued
+    // while both the PAI and the PAA were valid, and is signed by the PAI key.
+    VerifyOrReturnValue(memcmp(issuerHash, verifiedPai.paiSubjectHash, sizeof(issuerHash)) == 0, false);
+    VerifyOrReturnValue(dac.authorityKeyId.data_equal(ByteSpan(verifiedPai.paiSkid)), false);
+    VerifyOrReturnValue(CompareTimes(dac.notBefore, verifiedPai.dacNotBeforeMin) >= 0 &&
+                            CompareTimes(dac.notBefore, verifiedPai.dacNotBeforeMax) <= 0,
+                        false);
+
+    P256PublicKey paiPublicKey(verifiedPai.paiPublicKey);
+    return paiPublicKey.ECDSA_validate_msg_signature(dac.tbsCertificate.data(), dac.tbsCertificate.size(), dac.signature) ==
+        CHIP_NO_ERROR;
+}
+
+CHIP_ERROR DefaultDACVerifier::ValidateAttestationCertificateChain(const ByteSpan & paaDer, const ByteSpan & paiDer,
+                                                                   const ByteSpan & dacDer,
+                                                                   CertificateChainValidationResult & result)
+{
+    if (!mVerifiedPaiCacheSizeSet)
+    {
+        ReturnErrorOnFailure(SetVerifiedPaiCacheSize(CHIP_CONFIG_DAC_VERIFIER_VERIFIED_PAI_CACHE_SIZE));
+    }
+
+    VerifiedPai verifiedPai;
+    bool hashed = mVerifiedPais.AllocatedSize() > 0 &&
+        Hash_SHA256(paiDer.data(), paiDer.size(), verifiedPai.paiHash) == CHIP_NO_ERROR &&
+        Hash_SHA256(paaDer.data(), paaDer.size(), verifiedPai.paaHash) == CHIP_NO_ERROR;
+
+    for (size_t i = 0; hashed && i < mNumVerifiedPais; i++)
+    {
+        if (memcmp(mVerifiedPais[i].paiHash, verifiedPai.paiHash, sizeof(verifiedPai.paiHash)) == 0 &&
+            memcmp(mVerifiedPais[i].paaHash, verifiedPai.paaHash, sizeof(verifiedPai.paaHash)) == 0)
+        {
+            // A DAC that fails the shortcut still goes through the full validation below, which gives the failure reason.
+            if (IsIssuedByVerifiedPai(mVerifiedPais[i], dacDer))
+            {
+                result = CertificateChainValidationResult::kSuccess;
+                return CHIP_NO_ERROR;
+            }
+            hashed = false;
+        }
+    }
+
+    ReturnErrorOnFailure(ValidateCertificateChain(paaDer.data(), paaDer.size(), paiDer.data(), paiDer.size(), dacDer.data(),
+                                                  dacDer.size(), result));
+
+    if (hashed && InitVerifiedPai(verifiedPai, paaDer, paiDer) == CHIP_NO_ERROR)
+    {
+        mVerifiedPais[mNextVerifiedPai] = verifiedPai;
+        mNextVerifiedPai                = (mNextVerifiedPai + 1) % mVerifiedPais.AllocatedSize();
+        mNumVerifiedPais                = std::min(mNumVerifiedPais + 1, mVerifiedPais.AllocatedSize());
+    }
+
+    return CHIP_NO_ERROR;
+}
+
 void DefaultDACVerifier::VerifyAttestationInformation(const DeviceAttestationVerifier::AttestationInfo & info,
                                                       Callback::Callback<OnAttestationInformationVerification> * onCompletion)
 {
@@ -413,9 +702,8 @@ void DefaultDACVerifier::VerifyAttestationInformation(const DeviceAttestationVer
 #endif
 
     CertificateChainValidationResult chainValidationResult;
-    VerifyOrExit(ValidateCertificateChain(paaDerBuffer.data(), paaDerBuffer.size(), info.paiDerBuffer.data(),
-                                          info.paiDerBuffer.size(), info.dacDerBuffer.data(), info.dacDerBuffer.size(),
-                                          chainValidationResult) == CHIP_NO_ERROR,
+    VerifyOrExit(ValidateAttestationCertificateChain(paaDerBuffer, info.paiDerBuffer, info.dacDerBuffer, chainValidationResult) ==
+                     CHIP_NO_ERROR,
                  attestationError = MapError(chainValidationResult));
 
     {
@@ -19,8 +19,10 @@
 #include <array>
 #include <credentials/attestation_verifier/DeviceAttestationVerifier.h>
 #include <crypto/CHIPCryptoPAL.h>
+#include <lib/asn1/ASN1.h>
 #include <lib/core/CHIPConfig.h>
 #include <lib/core/CHIPError.h>
+#include <lib/support/ScopedBuffer.h>
 #include <lib/support/Span.h>
 #include <stdlib.h>
 
@@ -76,11 +78,54 @@ public:
 
     CsaCdKeysTrustStore * GetCertificationDeclarationTrustStore() override { return &mCdKeysTrustStore; }
 
+    /**
+     * @brief Set how many PAI/PAA pairs whose chain validated are remembered, forgetting those remembered so far
+     *
+     * The DAC of a device whose PAI and PAA are remembered is validated against the PAI only: it goes through the crypto PAL
+     * checks of a DAC, and its issuer, key identifier, validity and signature are checked against the remembered PAI. The
+     * chain from the PAI to the PAA is not validated again. Zero disables this. Until this is called, the size is
+     * CHIP_CONFIG_DAC_VERIFIER_VERIFIED_PAI_CACHE_SIZE.
+     *
+     * @returns CHIP_ERROR_NO_MEMORY if the cache could not be allocated, in which case it is disabled.
+     */
+    CHIP_ERROR SetVerifiedPaiCacheSize(size_t size);
+
 protected:
     DefaultDACVerifier() {}
 
+    /**
+     * @brief Validate the DAC, PAI and PAA certificate chain
+     *
+     * If the chain from this PAI to this PAA was validated before, and is still remembered, only the DAC is validated
+     * against the PAI. See SetVerifiedPaiCacheSize().
+     */
+    CHIP_ERROR ValidateAttestationCertificateChain(const ByteSpan & paaDer, const ByteSpan & paiDer, const ByteSpan & dacDer,
+                                                   Crypto::CertificateChainValidationResult & result);
+
     CsaCdKeysTrustStore mCdKeysTrustStore;
     const AttestationTrustStore * mAttestationTrustStore;
+
+    struct VerifiedPai
+    {
+        uint8_t paiHash[Crypto::kSHA256_Hash_Length];
+        uint8_t paaHash[Crypto::kSHA256_Hash_Length];
+        uint8_t paiSubjectHash[Crypto::kSHA256_Hash_Length];
+        uint8_t paiSkid[Crypto::kSubjectKeyIdentifierLength];
+        uint8_t paiPublicKey[Crypto::kP256_PublicKey_Length];
+        // DACs must be issued while both the PAI and the PAA are valid.
+        ASN1::ASN1UniversalTime dacNotBeforeMin;
+        ASN1::ASN1UniversalTime dacNotBeforeMax;
+    };
+
+    // Set the fields of verifiedPai other than the certificate hashes.
+    static CHIP_ERROR InitVerifiedPai(VerifiedPai & verifiedPai, const ByteSpan & paaDer, const ByteSpan & paiDer);
+    static bool IsIssuedByVerifiedPai(const VerifiedPai & verifiedPai, const ByteSpan & dacDer);
+
+    // Replaced in round-robin order once full. Allocated on first use, so that constructing a verifier allocates nothing.
+    Platform::ScopedMemoryBufferWithSize<VerifiedPai> mVerifiedPais;
+    size_t mNumVerifiedPais       = 0;
+    size_t mNextVerifiedPai       = 0;
+    bool mVerifiedPaiCacheSizeSet = false;
 };
 
 /**
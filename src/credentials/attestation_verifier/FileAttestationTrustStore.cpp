@@ -20,6 +20,7 @@
 #include <cstdio>
 #include <cstring>
 #include <string>
+#include <utility>
 
 extern "C" {
 #include <dirent.h>
@@ -95,14 +96,12 @@ std::vector<std::vector<uint8_t>> LoadAllX509DerCerts(const char * trustStorePat
                         MutableByteSpan kidSpan{ kidBuf };
                         ByteSpan certSpan{ certificate.data(), certificate.size() };
 
-                        if (CHIP_NO_ERROR != VerifyAttestationCertificateFormat(certSpan, Crypto::AttestationCertType::kPAA))
+                        if (CHIP_NO_ERROR == VerifyAttestationCertificateFormat(certSpan, Crypto::AttestationCertType::kPAA) &&
+                            CHIP_NO_ERROR == Crypto::ExtractSKIDFromX509Cert(certSpan, kidSpan))
                         {
-                            continue;
-                        }
-
-                        if (CHIP_NO_ERROR == Crypto::ExtractSKIDFromX509Cert(certSpan, kidSpan))
-                        {
-                            certs.push_back(certificate);
+                            // Release the slack of the kMaxDERCertLength buffer the file was read into.
+                            certificate.shrink_to_fit();
+                            certs.push_back(std::move(certificate));
                         }
                     }
                 }
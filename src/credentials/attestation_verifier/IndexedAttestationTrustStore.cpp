@@ -0,0 +1,376 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#include "IndexedAttestationTrustStore.h"
+
+#include <credentials/attestation_verifier/FileAttestationTrustStore.h>
+#include <lib/asn1/ASN1.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+extern "C" {
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
+namespace chip {
+namespace Credentials {
+
+namespace {
+
+constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325;
+constexpr uint64_t kFnvPrime       = 0x100000001b3;
+
+void HashBytes(uint64_t & hash, const void * data, size_t length)
+{
+    const uint8_t * bytes = static_cast<const uint8_t *>(data);
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ bytes[i]) * kFnvPrime;
+    }
+}
+
+/**
+ * Hash what identifies the current version of a file. Files are hashed independently so that the fingerprint of a
+ * directory does not depend on the order in which it is listed.
+ *
+ * The times are hashed to the nanosecond, as a file rewritten within the same second, with the same size, is otherwise
+ * left unnoticed.
+ */
+uint64_t HashFileStatus(const char * name, const struct stat & status)
+{
+#if defined(__APPLE__)
+    const struct timespec & modified = status.st_mtimespec;
+    const struct timespec & changed  = status.st_ctimespec;
+#else
+    const struct timespec & modified = status.st_mtim;
+    const struct timespec & changed  = status.st_ctim;
+#endif
+
+    uint64_t hash = kFnvOffsetBasis;
+    HashBytes(hash, name, strlen(name));
+    HashBytes(hash, &status.st_ino, sizeof(status.st_ino));
+    HashBytes(hash, &status.st_size, sizeof(status.st_size));
+    HashBytes(hash, &modified.tv_sec, sizeof(modified.tv_sec));
+    HashBytes(hash, &modified.tv_nsec, sizeof(modified.tv_nsec));
+    HashBytes(hash, &changed.tv_sec, sizeof(changed.tv_sec));
+    HashBytes(hash, &changed.tv_nsec, sizeof(changed.tv_nsec));
+    return hash;
+}
+
+bool HasDerExtension(const char * filename)
+{
+    // Same rule as LoadAllX509DerCerts().
+    const char * dot = strrchr(filename, '.');
+    return dot != nullptr && dot != filename && strncmp(dot + 1, "der", strlen("der")) == 0;
+}
+
+CHIP_ERROR FingerprintDirectory(const std::string & path, uint64_t & fingerprint)
+{
+    DIR * dir = opendir(path.c_str());
+    VerifyOrReturnError(dir != nullptr, CHIP_ERROR_OPEN_FAILED);
+
+    dirent * entry;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        if (!HasDerExtension(entry->d_name))
+        {
+            continue;
+        }
+
+        struct stat status;
+        std::string filename = path + "/" + entry->d_name;
+        if (stat(filename.c_str(), &status) == 0)
+        {
+            fingerprint += HashFileStatus(entry->d_name, status);
+        }
+    }
+    closedir(dir);
+
+    return CHIP_NO_ERROR;
+}
+
+bool IsLess(const ByteSpan & a, const ByteSpan & b)
+{
+    return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+} // namespace
+
+struct IndexedAttestationTrustStore::Contents
+{
+    struct Entry
+    {
+        uint8_t mSkid[Crypto::kSubjectKeyIdentifierLength];
+        std::vector<uint8_t> mSubject;
+        // Points into mFileCerts or mBundle.
+        ByteSpan mDer;
+
+        ByteSpan GetSkid() const { return ByteSpan(mSkid); }
+        ByteSpan GetSubject() const { return ByteSpan(mSubject.data(), mSubject.size()); }
+    };
+
+    CHIP_ERROR ReadBundle(const std::string & path, uint64_t & fingerprint);
+    void AddCertificate(const ByteSpan & der);
+    void BuildIndexes();
+
+    std::vector<std::vector<uint8_t>> mFileCerts;
+    std::vector<uint8_t> mBundle;
+    // Sorted by SKID.
+    std::vector<Entry> mEntries;
+    // Indices into mEntries, sorted by subject.
+    std::vector<size_t> mBySubject;
+    uint64_t mFingerprint = 0;
+};
+
+CHIP_ERROR IndexedAttestationTrustStore::Contents::ReadBundle(const std::string & path, uint64_t & fingerprint)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    VerifyOrReturnError(fd >= 0, CHIP_ERROR_OPEN_FAILED);
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size < 0)
+    {
+        close(fd);
+        return CHIP_ERROR_OPEN_FAILED;
+    }
+    fingerprint += HashFileStatus(path.c_str(), status);
+
+    // The bundle is copied rather than memory mapped: a mapped file truncated while in use would fault on access.
+    mBundle.resize(static_cast<size_t>(status.st_size));
+    size_t length = 0;
+    while (length < mBundle.size())
+    {
+        ssize_t count = read(fd, mBundle.data() + length, mBundle.size() - length);
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (count < 0)
+        {
+            close(fd);
+            return CHIP_ERROR_READ_FAILED;
+        }
+        if (count == 0)
+        {
+            // Truncated since fstat(): what is left is parsed, and most likely rejected, below.
+            break;
+        }
+        length += static_cast<size_t>(count);
+    }
+    close(fd);
+    mBundle.resize(length);
+    mBundle.shrink_to_fit();
+
+    // The bundle is a sequence of DER certificates, each of which is a single top-level SEQUENCE. A bundle that does not
+    // parse as such, for example because it is being rewritten, is rejected as a whole.
+    ASN1::ASN1Reader reader;
+    CHIP_ERROR err;
+    reader.Init(mBundle.data(), mBundle.size());
+    while ((err = reader.Next()) == CHIP_NO_ERROR)
+    {
+        const uint8_t * der;
+        uint32_t derLength;
+        ReturnErrorOnFailure(reader.GetConstructedType(der, derLength));
+        AddCertificate(ByteSpan(der, derLength));
+    }
+
+    return (err == ASN1_END) ? CHIP_NO_ERROR : err;
+}
+
+void IndexedAttestationTrustStore::Contents::AddCertificate(const ByteSpan & der)
+{
+    Entry entry;
+    MutableByteSpan skid(entry.mSkid);
+
+    VerifyOrReturn(der.size() <= kMaxDERCertLength);
+    VerifyOrReturn(VerifyAttestationCertificateFormat(der, Crypto::AttestationCertType::kPAA) == CHIP_NO_ERROR);
+    VerifyOrReturn(Crypto::ExtractSKIDFromX509Cert(der, skid) == CHIP_NO_ERROR && skid.size() == sizeof(entry.mSkid));
+
+    // The subject cannot be longer than the certificate holding it.
+    entry.mSubject.resize(der.size());
+    MutableByteSpan subject(entry.mSubject.data(), entry.mSubject.size());
+    VerifyOrReturn(Crypto::ExtractSubjectFromX509Cert(der, subject) == CHIP_NO_ERROR);
+    entry.mSubject.resize(subject.size());
+    entry.mSubject.shrink_to_fit();
+
+    entry.mDer = der;
+    mEntries.push_back(std::move(entry));
+}
+
+void IndexedAttestationTrustStore::Contents::BuildIndexes()
+{
+    // Stable, so that the first of several certificates with the same key identifier or subject is the one found.
+    std::stable_sort(mEntries.begin(), mEntries.end(),
+                     [](const Entry & a, const Entry & b) { return IsLess(a.GetSkid(), b.GetSkid()); });
+
+    mBySubject.resize(mEntries.size());
+    for (size_t i = 0; i < mEntries.size(); i++)
+    {
+        mBySubject[i] = i;
+    }
+    std::stable_sort(mBySubject.begin(), mBySubject.end(),
+                     [this](size_t a, size_t b) { return IsLess(mEntries[a].GetSubject(), mEntries[b].GetSubject()); });
+}
+
+IndexedAttestationTrustStore::IndexedAttestationTrustStore() = default;
+
+IndexedAttestationTrustStore::~IndexedAttestationTrustStore() = default;
+
+CHIP_ERROR IndexedAttestationTrustStore::Init(const char * paaTrustStorePath, const char * paaBundlePath)
+{
+    VerifyOrReturnError(paaTrustStorePath != nullptr || paaBundlePath != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    mPaaTrustStorePath = (paaTrustStorePath != nullptr) ? paaTrustStorePath : "";
+    mPaaBundlePath     = (paaBundlePath != nullptr) ? paaBundlePath : "";
+    mContents.reset();
+
+    std::unique_ptr<Contents> contents;
+    ReturnErrorOnFailure(Load(contents));
+    mContents = std::move(contents);
+
+    ChipLogProgress(Crypto, "Loaded %u PAA certificates", static_cast<unsigned>(paaCount()));
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR IndexedAttestationTrustStore::Load(std::unique_ptr<Contents> & contents) const
+{
+    contents = std::make_unique<Contents>();
+
+    // Fingerprint the files before reading them, so that a change made while loading is picked up by the next check.
+    if (!mPaaTrustStorePath.empty())
+    {
+        ReturnErrorOnFailure(FingerprintDirectory(mPaaTrustStorePath, contents->mFingerprint));
+
+        contents->mFileCerts = LoadAllX509DerCerts(mPaaTrustStorePath.c_str());
+        for (const auto & certificate : contents->mFileCerts)
+        {
+            contents->AddCertificate(ByteSpan(certificate.data(), certificate.size()));
+        }
+    }
+
+    if (!mPaaBundlePath.empty())
+    {
+        ReturnErrorOnFailure(contents->ReadBundle(mPaaBundlePath, contents->mFingerprint));
+    }
+
+    VerifyOrReturnError(!contents->mEntries.empty(), CHIP_ERROR_CA_CERT_NOT_FOUND);
+    contents->BuildIndexes();
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR IndexedAttestationTrustStore::ReloadIfChanged(bool & reloaded)
+{
+    return Reload(reloaded);
+}
+
+CHIP_ERROR IndexedAttestationTrustStore::Reload(bool & reloaded) const
+{
+    reloaded = false;
+    VerifyOrReturnError(mContents != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    uint64_t fingerprint = 0;
+    if (!mPaaTrustStorePath.empty())
+    {
+        ReturnErrorOnFailure(FingerprintDirectory(mPaaTrustStorePath, fingerprint));
+    }
+    if (!mPaaBundlePath.empty())
+    {
+        struct stat status;
+        VerifyOrReturnError(stat(mPaaBundlePath.c_str(), &status) == 0, CHIP_ERROR_OPEN_FAILED);
+        fingerprint += HashFileStatus(mPaaBundlePath.c_str(), status);
+    }
+    ReturnErrorCodeIf(fingerprint == mContents->mFingerprint, CHIP_NO_ERROR);
+
+    // Only replace the current contents once the new ones are fully loaded.
+    std::unique_ptr<Contents> contents;
+    ReturnErrorOnFailure(Load(contents));
+    mContents = std::move(contents);
+    reloaded  = true;
+
+    ChipLogProgress(Crypto, "Reloaded %u PAA certificates", static_cast<unsigned>(paaCount()));
+    return CHIP_NO_ERROR;
+}
+
+void IndexedAttestationTrustStore::ReloadIfDue() const
+{
+    VerifyOrReturn(mReloadCheckInterval != System::Clock::kZero);
+
+    System::Clock::Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+    VerifyOrReturn(mLastReloadCheck == System::Clock::kZero || now - mLastReloadCheck >= mReloadCheckInterval);
+    mLastReloadCheck = now;
+
+    bool reloaded;
+    CHIP_ERROR err = Reload(reloaded);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Crypto, "Failed to reload PAA certificates, keeping the current ones: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
+
+size_t IndexedAttestationTrustStore::paaCount() const
+{
+    return (mContents != nullptr) ? mContents->mEntries.size() : 0;
+}
+
+CHIP_ERROR IndexedAttestationTrustStore::CopyPaa(size_t index, MutableByteSpan & outPaaDerBuffer) const
+{
+    return CopySpanToMutableSpan(mContents->mEntries[index].mDer, outPaaDerBuffer);
+}
+
+CHIP_ERROR IndexedAttestationTrustStore::GetProductAttestationAuthorityCert(const ByteSpan & skid,
+                                                                            MutableByteSpan & outPaaDerBuffer) const
+{
+    VerifyOrReturnError(!skid.empty() && (skid.data() != nullptr), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(skid.size() == Crypto::kSubjectKeyIdentifierLength, CHIP_ERROR_INVALID_ARGUMENT);
+
+    ReloadIfDue();
+    VerifyOrReturnError(mContents != nullptr, CHIP_ERROR_CA_CERT_NOT_FOUND);
+
+    const auto & entries = mContents->mEntries;
+    auto isLess          = [](const Contents::Entry & entry, const ByteSpan & key) { return IsLess(entry.GetSkid(), key); };
+    auto it              = std::lower_bound(entries.begin(), entries.end(), skid, isLess);
+    VerifyOrReturnError(it != entries.end() && it->GetSkid().data_equal(skid), CHIP_ERROR_CA_CERT_NOT_FOUND);
+
+    return CopyPaa(static_cast<size_t>(it - entries.begin()), outPaaDerBuffer);
+}
+
+CHIP_ERROR IndexedAttestationTrustStore::GetProductAttestationAuthorityCertBySubject(const ByteSpan & subject,
+                                                                                     MutableByteSpan & outPaaDerBuffer) const
+{
+    VerifyOrReturnError(!subject.empty() && (subject.data() != nullptr), CHIP_ERROR_INVALID_ARGUMENT);
+
+    ReloadIfDue();
+    VerifyOrReturnError(mContents != nullptr, CHIP_ERROR_CA_CERT_NOT_FOUND);
+
+    const auto & entries = mContents->mEntries;
+    const auto & index   = mContents->mBySubject;
+    auto isLess          = [&entries](size_t entry, const ByteSpan & key) { return IsLess(entries[entry].GetSubject(), key); };
+    auto it              = std::lower_bound(index.begin(), index.end(), subject, isLess);
+    VerifyOrReturnError(it != index.end() && entries[*it].GetSubject().data_equal(subject), CHIP_ERROR_CA_CERT_NOT_FOUND);
+
+    return CopyPaa(*it, outPaaDerBuffer);
+}
+
+} // namespace Credentials
+} // namespace chip
@@ -0,0 +1,103 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#pragma once
+
+#include <credentials/attestation_verifier/DeviceAttestationVerifier.h>
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/CHIPError.h>
+#include <lib/support/Span.h>
+#include <system/SystemClock.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace chip {
+namespace Credentials {
+
+/**
+ * @brief PAA trust store for commissioners that attest many devices against many roots
+ *
+ * PAA certificates are loaded from the `.der` files of a directory, like FileAttestationTrustStore does, and/or from a
+ * bundle file holding DER certificates back to back, which is read in a single buffer. Each certificate is parsed once
+ * at load time and indexed by subject key identifier and by subject, so lookups are a binary search.
+ *
+ * The sources can be reloaded when they change on disk: explicitly with ReloadIfChanged(), or on lookup once the
+ * interval set with SetReloadCheckInterval() has elapsed. A change is detected from the names, sizes and modification
+ * times of the files. If the new contents fail to load, the previous ones are kept.
+ *
+ * Not thread-safe: use it from the Matter thread only, like the DAC verifier that calls it.
+ */
+class IndexedAttestationTrustStore : public AttestationTrustStore
+{
+public:
+    IndexedAttestationTrustStore();
+    ~IndexedAttestationTrustStore() override;
+
+    /**
+     * @brief Load the PAA certificates of a directory and/or a bundle file
+     *
+     * @param[in] paaTrustStorePath Directory of `.der` PAA certificates, or nullptr.
+     * @param[in] paaBundlePath     File of concatenated DER PAA certificates, or nullptr.
+     *
+     * @returns CHIP_ERROR_INVALID_ARGUMENT if both paths are null, CHIP_ERROR_OPEN_FAILED if a source cannot be read,
+     *          an ASN1 error if the bundle is not a sequence of DER certificates, CHIP_ERROR_CA_CERT_NOT_FOUND if no usable
+     *          PAA certificate was found.
+     */
+    CHIP_ERROR Init(const char * paaTrustStorePath, const char * paaBundlePath = nullptr);
+
+    CHIP_ERROR GetProductAttestationAuthorityCert(const ByteSpan & skid, MutableByteSpan & outPaaDerBuffer) const override;
+
+    /**
+     * @brief Look up a PAA certificate by subject, as returned by Crypto::ExtractSubjectFromX509Cert()
+     *
+     * This matches the issuer of a PAI, as returned by Crypto::ExtractIssuerFromX509Cert(), for PAIs without an
+     * authority key identifier. The errors are those of GetProductAttestationAuthorityCert().
+     */
+    CHIP_ERROR GetProductAttestationAuthorityCertBySubject(const ByteSpan & subject, MutableByteSpan & outPaaDerBuffer) const;
+
+    /**
+     * @brief Reload the sources if any of their files were added, removed or modified since they were loaded
+     *
+     * @param[out] reloaded Set to whether the contents were replaced.
+     */
+    CHIP_ERROR ReloadIfChanged(bool & reloaded);
+
+    /**
+     * @brief Have lookups check for changes, and reload, at most once per interval. Zero, the default, disables it.
+     */
+    void SetReloadCheckInterval(System::Clock::Milliseconds64 interval) { mReloadCheckInterval = interval; }
+
+    size_t paaCount() const;
+
+private:
+    struct Contents;
+
+    CHIP_ERROR Load(std::unique_ptr<Contents> & contents) const;
+    CHIP_ERROR Reload(bool & reloaded) const;
+    void ReloadIfDue() const;
+    CHIP_ERROR CopyPaa(size_t index, MutableByteSpan & outPaaDerBuffer) const;
+
+    std::string mPaaTrustStorePath;
+    std::string mPaaBundlePath;
+    mutable std::unique_ptr<Contents> mContents;
+    System::Clock::Milliseconds64 mReloadCheckInterval = System::Clock::kZero;
+    mutable System::Clock::Timestamp mLastReloadCheck  = System::Clock::kZero;
+};
+
+} // namespace Credentials
+} // namespace chip
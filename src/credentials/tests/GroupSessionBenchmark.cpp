@@ -0,0 +1,215 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      A small benchmark for the group key lookup and trial decryption that
+ *      SessionManager::SecureGroupMessageDispatch() does for every incoming group
+ *      message, comparing the group session cache of GroupDataProviderImpl against
+ *      walking the group key tables in persistent storage.
+ *
+ *      Each scenario configures a number of fabrics, each with its own key set mapped
+ *      to several groups, and receives messages encrypted with a group key of the last
+ *      fabric.  Each run prints one JSON object per scenario on stdout.
+ */
+
+#include <credentials/GroupDataProviderImpl.h>
+#include <crypto/DefaultSessionKeystore.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+#include <system/SystemClock.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace chip;
+using namespace chip::Credentials;
+using namespace chip::System;
+
+namespace {
+
+constexpr uint32_t kDefaultIterations = 2000;
+constexpr uint16_t kGroupsPerFabric   = 4;
+constexpr KeysetId kKeysetId          = 0x0101;
+
+/**
+ * Gives access to the storage-backed group session iterator, to compare against the cached one.
+ */
+class BenchmarkGroupDataProvider : public GroupDataProviderImpl
+{
+public:
+    BenchmarkGroupDataProvider() : GroupDataProviderImpl(kGroupsPerFabric, 2) {}
+
+    GroupSessionIterator * IterateGroupSessionsFromStorage(uint16_t session_id)
+    {
+        return mGroupSessionsIterator.CreateObject(*this, session_id);
+    }
+};
+
+struct Message
+{
+    uint16_t mSessionId;
+    uint8_t mCiphertext[32];
+    uint8_t mMic[16];
+    uint8_t mNonce[13];
+    uint8_t mAad[16];
+};
+
+void Report(const char * method, uint32_t fabrics, uint32_t iterations, Clock::Microseconds64 elapsed)
+{
+    const double seconds = static_cast<double>(elapsed.count()) / 1e6;
+    printf("{\"method\": \"%s\", \"fabrics\": %u, \"groups_per_fabric\": %u, \"messages\": %u, \"elapsed_us\": %llu, "
+           "\"messages_per_sec\": %.0f}\n",
+           method, fabrics, kGroupsPerFabric, iterations, static_cast<unsigned long long>(elapsed.count()),
+           seconds > 0 ? iterations / seconds : 0.0);
+}
+
+CHIP_ERROR Configure(BenchmarkGroupDataProvider & provider, uint32_t fabrics)
+{
+    for (uint32_t fabric = 1; fabric <= fabrics; fabric++)
+    {
+        const FabricIndex fabricIndex       = static_cast<FabricIndex>(fabric);
+        const uint8_t compressedFabricId[8] = { 0x87, 0xe1, 0xb0, 0x04, 0xe2, 0x35, 0xa1, fabricIndex };
+
+        GroupDataProvider::KeySet keySet(kKeysetId, GroupDataProvider::SecurityPolicy::kTrustFirst, 3);
+        for (uint8_t i = 0; i < 3; i++)
+        {
+            keySet.epoch_keys[i].start_time = i;
+            memset(keySet.epoch_keys[i].key, static_cast<uint8_t>(fabric * 16 + i), sizeof(keySet.epoch_keys[i].key));
+        }
+        ReturnErrorOnFailure(provider.SetKeySet(fabricIndex, ByteSpan(compressedFabricId), keySet));
+
+        for (uint16_t group = 0; group < kGroupsPerFabric; group++)
+        {
+            ReturnErrorOnFailure(provider.SetGroupKeyAt(
+                fabricIndex, group, GroupDataProvider::GroupKey(static_cast<GroupId>(kMinApplicationGroupId + group), kKeysetId)));
+        }
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR Encrypt(BenchmarkGroupDataProvider & provider, FabricIndex fabric, GroupId group, Message & message)
+{
+    Crypto::SymmetricKeyContext * context = provider.GetKeyContext(fabric, group);
+    VerifyOrReturnError(context != nullptr, CHIP_ERROR_NOT_FOUND);
+
+    uint8_t plaintext[sizeof(message.mCiphertext)];
+    memset(plaintext, 0x5a, sizeof(plaintext));
+    memset(message.mNonce, 0x11, sizeof(message.mNonce));
+    memset(message.mAad, 0x22, sizeof(message.mAad));
+
+    MutableByteSpan ciphertext(message.mCiphertext);
+    MutableByteSpan mic(message.mMic);
+    message.mSessionId = context->GetKeyHash();
+    CHIP_ERROR err =
+        context->MessageEncrypt(ByteSpan(plaintext), ByteSpan(message.mAad), ByteSpan(message.mNonce), mic, ciphertext);
+    context->Release();
+    return err;
+}
+
+/**
+ * Mirror the key lookup of SecureGroupMessageDispatch(): try every candidate key until one decrypts the message.
+ */
+bool Receive(BenchmarkGroupDataProvider & provider, GroupDataProvider::GroupSessionIterator * iter, const Message & message)
+{
+    VerifyOrReturnError(iter != nullptr, false);
+
+    GroupDataProvider::GroupSession session;
+    bool decrypted = false;
+    while (!decrypted && iter->Next(session))
+    {
+        uint8_t plaintext[sizeof(message.mCiphertext)];
+        MutableByteSpan output(plaintext);
+        decrypted = session.keyContext->MessageDecrypt(ByteSpan(message.mCiphertext), ByteSpan(message.mAad),
+                                                       ByteSpan(message.mNonce), ByteSpan(message.mMic),
+                                                       output) == CHIP_NO_ERROR;
+    }
+    if (decrypted)
+    {
+        provider.GroupSessionMatched(session);
+    }
+    iter->Release();
+    return decrypted;
+}
+
+CHIP_ERROR Run(uint32_t fabrics, uint32_t iterations)
+{
+    TestPersistentStorageDelegate storage;
+    Crypto::DefaultSessionKeystore keystore;
+    BenchmarkGroupDataProvider provider;
+    provider.SetStorageDelegate(&storage);
+    provider.SetSessionKeystore(&keystore);
+    ReturnErrorOnFailure(provider.Init());
+
+    CHIP_ERROR err = Configure(provider, fabrics);
+    Message message;
+    if (err == CHIP_NO_ERROR)
+    {
+        err = Encrypt(provider, static_cast<FabricIndex>(fabrics), kMinApplicationGroupId + kGroupsPerFabric - 1, message);
+    }
+
+    if (err == CHIP_NO_ERROR)
+    {
+        const Clock::Microseconds64 start = SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t i = 0; i < iterations && err == CHIP_NO_ERROR; i++)
+        {
+            VerifyOrDo(Receive(provider, provider.IterateGroupSessionsFromStorage(message.mSessionId), message),
+                       err = CHIP_ERROR_DECODE_FAILED);
+        }
+        Report("storage", fabrics, iterations, SystemClock().GetMonotonicMicroseconds64() - start);
+    }
+
+    if (err == CHIP_NO_ERROR)
+    {
+        const Clock::Microseconds64 start = SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t i = 0; i < iterations && err == CHIP_NO_ERROR; i++)
+        {
+            VerifyOrDo(Receive(provider, provider.IterateGroupSessions(message.mSessionId), message),
+                       err = CHIP_ERROR_DECODE_FAILED);
+        }
+        Report("cache", fabrics, iterations, SystemClock().GetMonotonicMicroseconds64() - start);
+    }
+
+    provider.Finish();
+    return err;
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    uint32_t iterations = kDefaultIterations;
+    if (argc > 1)
+    {
+        iterations = static_cast<uint32_t>(strtoul(argv[1], nullptr, 10));
+    }
+
+    VerifyOrDie(Platform::MemoryInit() == CHIP_NO_ERROR);
+
+    for (uint32_t fabrics : { 1u, 4u, 16u })
+    {
+        CHIP_ERROR err = Run(fabrics, iterations);
+        if (err != CHIP_NO_ERROR)
+        {
+            fprintf(stderr, "group sessions (%u fabrics) failed: %" CHIP_ERROR_FORMAT "\n", fabrics, err.Format());
+        }
+    }
+
+    Platform::MemoryShutdown();
+    return 0;
+}
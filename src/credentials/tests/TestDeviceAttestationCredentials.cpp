@@ -27,6 +27,7 @@
 #include <credentials/examples/ExampleDACs.h>
 #include <credentials/examples/ExamplePAI.h>
 
+#include <lib/asn1/ASN1.h>
 #include <lib/core/CHIPError.h>
 #include <lib/support/CHIPMem.h>
 #include <lib/support/Span.h>
@@ -34,6 +35,9 @@
 
 #include <nlunit-test.h>
 
+#include <algorithm>
+#include <string.h>
+
 #include "CHIPAttCert_test_vectors.h"
 
 using namespace chip;
@@ -46,6 +50,97 @@ namespace {
 static const ByteSpan kExpectedDacPublicKey = DevelopmentCerts::kDacPublicKey;
 static const ByteSpan kExpectedPaiPublicKey = DevelopmentCerts::kPaiPublicKey;
 
+// The notBefore time of the test DACs, and one before that of their PAIs and PAAs.
+constexpr char kTestDacNotBefore[]   = "210628142343Z";
+constexpr char kNotBeforePaiAndPaa[] = "200628142343Z";
+
+class VerifiedPaiCacheTestVerifier : public DefaultDACVerifier
+{
+public:
+    VerifiedPaiCacheTestVerifier() : DefaultDACVerifier(GetTestAttestationTrustStore()) {}
+
+    using DefaultDACVerifier::ValidateAttestationCertificateChain;
+
+    size_t GetVerifiedPaiCount() const { return mNumVerifiedPais; }
+
+    // Whether the cached checks alone accept the DAC, without falling back to the whole chain validation.
+    bool IsIssuedByFirstVerifiedPai(const ByteSpan & dacDer) const
+    {
+        return mNumVerifiedPais > 0 && IsIssuedByVerifiedPai(mVerifiedPais[0], dacDer);
+    }
+
+    bool IsValid(const ByteSpan & paaDer, const ByteSpan & paiDer, const ByteSpan & dacDer)
+    {
+        CertificateChainValidationResult result = CertificateChainValidationResult::kInternalFrameworkError;
+        CHIP_ERROR err                          = ValidateAttestationCertificateChain(paaDer, paiDer, dacDer, result);
+        return err == CHIP_NO_ERROR && result == CertificateChainValidationResult::kSuccess;
+    }
+};
+
+CHIP_ERROR LoadKeypair(const ByteSpan & publicKey, const ByteSpan & privateKey, P256Keypair & keypair)
+{
+    P256SerializedKeypair serializedKeypair;
+    VerifyOrReturnError(publicKey.size() + privateKey.size() <= serializedKeypair.Capacity(), CHIP_ERROR_BUFFER_TOO_SMALL);
+    memcpy(serializedKeypair.Bytes(), publicKey.data(), publicKey.size());
+    memcpy(serializedKeypair.Bytes() + publicKey.size(), privateKey.data(), privateKey.size());
+    ReturnErrorOnFailure(serializedKeypair.SetLength(publicKey.size() + privateKey.size()));
+    return keypair.Deserialize(serializedKeypair);
+}
+
+/**
+ * Sign the TBSCertificate of a certificate again with signingKey, after replacing its notBefore time with newNotBefore
+ * if given. newNotBefore must be as long as kTestDacNotBefore.
+ */
+CHIP_ERROR ResignCertificate(const ByteSpan & certificate, P256Keypair & signingKey, MutableByteSpan & outCertificate,
+                             const char * newNotBefore = nullptr)
+{
+    ASN1::ASN1Reader reader;
+    ASN1::ASN1Writer writer;
+    const uint8_t * element;
+    uint32_t elementLen;
+    uint8_t tbs[kMaxDERCertLength];
+    size_t tbsLen;
+    ByteSpan signatureAlgorithm;
+    P256ECDSASignature signature;
+    uint8_t derSignatureBuf[kMax_ECDSA_Signature_Length_Der];
+    MutableByteSpan derSignature(derSignatureBuf);
+
+    // Certificate ::= SEQUENCE { tbsCertificate, signatureAlgorithm, signatureValue }
+    reader.Init(certificate);
+    ReturnErrorOnFailure(reader.Next());
+    ReturnErrorOnFailure(reader.EnterConstructedType());
+    ReturnErrorOnFailure(reader.Next());
+    ReturnErrorOnFailure(reader.GetConstructedType(element, elementLen));
+    VerifyOrReturnError(elementLen <= sizeof(tbs), CHIP_ERROR_BUFFER_TOO_SMALL);
+    memcpy(tbs, element, elementLen);
+    tbsLen = elementLen;
+    ReturnErrorOnFailure(reader.Next());
+    ReturnErrorOnFailure(reader.GetConstructedType(element, elementLen));
+    signatureAlgorithm = ByteSpan(element, elementLen);
+
+    if (newNotBefore != nullptr)
+    {
+        uint8_t * notBefore = std::search(tbs, tbs + tbsLen, kTestDacNotBefore, kTestDacNotBefore + strlen(kTestDacNotBefore));
+        VerifyOrReturnError(notBefore != tbs + tbsLen && strlen(newNotBefore) == strlen(kTestDacNotBefore),
+                            CHIP_ERROR_INVALID_ARGUMENT);
+        memcpy(notBefore, newNotBefore, strlen(newNotBefore));
+    }
+
+    ReturnErrorOnFailure(signingKey.ECDSA_sign_msg(tbs, tbsLen, signature));
+    ReturnErrorOnFailure(EcdsaRawSignatureToAsn1(kP256_FE_Length, ByteSpan(signature.ConstBytes(), signature.Length()),
+                                                 derSignature));
+
+    writer.Init(outCertificate);
+    ReturnErrorOnFailure(writer.StartConstructedType(ASN1::kASN1TagClass_Universal, ASN1::kASN1UniversalTag_Sequence));
+    ReturnErrorOnFailure(writer.PutConstructedType(tbs, static_cast<uint16_t>(tbsLen)));
+    ReturnErrorOnFailure(writer.PutConstructedType(signatureAlgorithm.data(), static_cast<uint16_t>(signatureAlgorithm.size())));
+    ReturnErrorOnFailure(writer.PutBitString(0, derSignature.data(), static_cast<uint16_t>(derSignature.size())));
+    ReturnErrorOnFailure(writer.EndConstructedType());
+    outCertificate.reduce_size(writer.GetLengthWritten());
+
+    return CHIP_NO_ERROR;
+}
+
 } // namespace
 
 static void TestDACProvidersExample_Providers(nlTestSuite * inSuite, void * inContext)
@@ -407,6 +502,120 @@ static void TestAttestationTrustStore(nlTestSuite * inSuite, void * inContext)
     }
 }
 
+static void TestDACVerifier_VerifiedPaiCache(nlTestSuite * inSuite, void * inContext)
+{
+    const ByteSpan paaFFF1   = TestCerts::sTestCert_PAA_FFF1_Cert;
+    const ByteSpan paaNoVID  = TestCerts::sTestCert_PAA_NoVID_Cert;
+    const ByteSpan paaResign = TestCerts::sTestCert_PAA_NoVID_ToResignPAIs_Cert;
+    const ByteSpan paiFFF1   = TestCerts::sTestCert_PAI_FFF1_8000_Cert;
+    const ByteSpan paiFFF2   = TestCerts::sTestCert_PAI_FFF2_8001_Cert;
+
+    VerifiedPaiCacheTestVerifier verifier;
+
+    // Disabled unless configured.
+    NL_TEST_ASSERT(inSuite, verifier.IsValid(paaFFF1, paiFFF1, TestCerts::sTestCert_DAC_FFF1_8000_0004_Cert));
+    NL_TEST_ASSERT(inSuite, verifier.GetVerifiedPaiCount() == 0);
+
+    NL_TEST_ASSERT(inSuite, verifier.SetVerifiedPaiCacheSize(2) == CHIP_NO_ERROR);
+
+    // The first DAC of a PAI goes through the whole chain and remembers the PAI, the following ones hit the cache.
+    NL_TEST_ASSERT(inSuite, verifier.IsValid(paaFFF1, paiFFF1, TestCerts::sTestCert_DAC_FFF1_8000_0004_Cert));
+    NL_TEST_ASSERT(inSuite, verifier.GetVerifiedPaiCount() == 1);
+    NL_TEST_ASSERT(inSuite, verifier.IsValid(paaFFF1, paiFFF1, TestCerts::sTestCert_DAC_FFF1_8000_0004_Cert));
+    NL_TEST_ASSERT(inSuite, verifier.IsValid(paaFFF1, paiFFF1, TestCerts::sTestCert_DAC_FFF1_8000_0005_Cert));
+    NL_TEST_ASSERT(inSuite, verifier.GetVerifiedPaiCount() == 1);
+    NL_TEST_ASSERT(inSuite, verifier.IsIssuedByFirstVerifiedPai(TestCerts::sTestCert_DAC_FFF1_8000_0005_Cert));
+    NL_TEST_ASSERT(inSuite, !verifier.IsIssuedByFirstVerifiedPai(TestCerts::sTestCert_DAC_FFF2_8001_0008_Cert));
+
+    // A DAC of another PAI does not validate against the remembered one.
+    NL_TEST_ASSERT(inSuite, !verifier.IsValid(paaFFF1, paiFFF1, TestCerts::sTestCert_DAC_FFF2_8001_0008_Cert));
+
+    // The cache is keyed by both the PAI and the PAA, and the oldest pair is replaced once full.
+    NL_TEST_ASSERT(inSuite, verifier.IsValid(paaNoVID, paiFFF2, TestCerts::sTestCert_DAC_FFF2_8001_0008_Cert));
+    NL_TEST_ASSERT(inSuite, verifier.GetVerifiedPaiCount() == 2);
+    NL_TEST_ASSERT(inSuite,
+                   verifier.IsValid(paaResign, TestCerts::sTestCert_PAI_FFF2_8001_Resigned_Cert,
+                                    TestCerts::sTestCert_DAC_FFF2_8001_0008_Cert));
+    NL_TEST_ASSERT(inSuite, verifier.GetVerifiedPaiCount() == 2);
+    NL_TEST_ASSERT(inSuite, verifier.IsValid(paaFFF1, paiFFF1, TestCerts::sTestCert_DAC_FFF1_8000_0006_Cert));
+
+    // A PAI that chains to another PAA than the remembered one is validated in full.
+    NL_TEST_ASSERT(inSuite, !verifier.IsValid(paaFFF1, paiFFF2, TestCerts::sTestCert_DAC_FFF2_8001_0008_Cert));
+
+    NL_TEST_ASSERT(inSuite, verifier.SetVerifiedPaiCacheSize(0) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, verifier.GetVerifiedPaiCount() == 0);
+    NL_TEST_ASSERT(inSuite, verifier.IsValid(paaFFF1, paiFFF1, TestCerts::sTestCert_DAC_FFF1_8000_0004_Cert));
+    NL_TEST_ASSERT(inSuite, verifier.GetVerifiedPaiCount() == 0);
+}
+
+static void TestDACVerifier_VerifiedPaiCacheRejectsBadDacs(nlTestSuite * inSuite, void * inContext)
+{
+    const ByteSpan paa = TestCerts::sTestCert_PAA_NoVID_Cert;
+    const ByteSpan pai = TestCerts::sTestCert_PAI_FFF2_8001_Cert;
+    const ByteSpan dac = TestCerts::sTestCert_DAC_FFF2_8001_0008_Cert;
+
+    P256Keypair paiKey;
+    P256Keypair otherPaiKey;
+    NL_TEST_ASSERT(inSuite,
+                   LoadKeypair(TestCerts::sTestCert_PAI_FFF2_8001_PublicKey, TestCerts::sTestCert_PAI_FFF2_8001_PrivateKey,
+                               paiKey) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, otherPaiKey.Initialize(ECPKeyTarget::ECDSA) == CHIP_NO_ERROR);
+
+    // Signed again by the PAI: a valid DAC, which checks the re-signing itself.
+    uint8_t resignedBuf[kMaxDERCertLength];
+    MutableByteSpan resigned(resignedBuf);
+    NL_TEST_ASSERT(inSuite, ResignCertificate(dac, paiKey, resigned) == CHIP_NO_ERROR);
+
+    // Signed by a PAI with the same subject, and the same key identifier, but another key.
+    uint8_t otherPaiDacBuf[kMaxDERCertLength];
+    MutableByteSpan otherPaiDac(otherPaiDacBuf);
+    NL_TEST_ASSERT(inSuite, ResignCertificate(dac, otherPaiKey, otherPaiDac) == CHIP_NO_ERROR);
+
+    // Signed by the PAI, but issued before the PAI and the PAA were valid.
+    uint8_t earlyDacBuf[kMaxDERCertLength];
+    MutableByteSpan earlyDac(earlyDacBuf);
+    NL_TEST_ASSERT(inSuite, ResignCertificate(dac, paiKey, earlyDac, kNotBeforePaiAndPaa) == CHIP_NO_ERROR);
+
+    // The last byte of the signature changed.
+    uint8_t tamperedDacBuf[kMaxDERCertLength];
+    memcpy(tamperedDacBuf, dac.data(), dac.size());
+    tamperedDacBuf[dac.size() - 1] ^= 0x01;
+    const ByteSpan tamperedDac(tamperedDacBuf, dac.size());
+
+    // A DAC of a PAI with the same subject as the valid one, presented with that PAI.
+    const ByteSpan sameSubjectPai = TestCerts::sTestCert_PAI_FFF2_8001_ResignedSKIDDiff_Cert;
+    const ByteSpan sameSubjectPaa = TestCerts::sTestCert_PAA_NoVID_ToResignPAIs_Cert;
+
+    // Each is rejected by the whole chain validation, and still once the PAI is remembered.
+    const size_t kCacheSizes[] = { 0, 1 };
+    VerifiedPaiCacheTestVerifier verifier;
+    for (size_t cacheSize : kCacheSizes)
+    {
+        NL_TEST_ASSERT(inSuite, verifier.SetVerifiedPaiCacheSize(cacheSize) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, verifier.IsValid(paa, pai, dac));
+        NL_TEST_ASSERT(inSuite, verifier.GetVerifiedPaiCount() == cacheSize);
+
+        NL_TEST_ASSERT(inSuite, verifier.IsValid(paa, pai, resigned));
+        NL_TEST_ASSERT(inSuite, !verifier.IsValid(paa, pai, otherPaiDac));
+        NL_TEST_ASSERT(inSuite, !verifier.IsValid(paa, pai, earlyDac));
+        NL_TEST_ASSERT(inSuite, !verifier.IsValid(paa, pai, tamperedDac));
+        NL_TEST_ASSERT(inSuite, !verifier.IsValid(sameSubjectPaa, sameSubjectPai, dac));
+        NL_TEST_ASSERT(inSuite, verifier.GetVerifiedPaiCount() == cacheSize);
+    }
+
+    NL_TEST_ASSERT(inSuite, verifier.IsIssuedByFirstVerifiedPai(dac));
+    NL_TEST_ASSERT(inSuite, verifier.IsIssuedByFirstVerifiedPai(resigned));
+    NL_TEST_ASSERT(inSuite, !verifier.IsIssuedByFirstVerifiedPai(otherPaiDac));
+    NL_TEST_ASSERT(inSuite, !verifier.IsIssuedByFirstVerifiedPai(earlyDac));
+    NL_TEST_ASSERT(inSuite, !verifier.IsIssuedByFirstVerifiedPai(tamperedDac));
+
+    // Failing the cached checks reports the reason found by the whole chain validation.
+    CertificateChainValidationResult result = CertificateChainValidationResult::kSuccess;
+    NL_TEST_ASSERT(inSuite,
+                   verifier.ValidateAttestationCertificateChain(paa, pai, tamperedDac, result) == CHIP_ERROR_CERT_NOT_TRUSTED);
+    NL_TEST_ASSERT(inSuite, result == CertificateChainValidationResult::kChainInvalid);
+}
+
 /**
  *  Set up the test suite.
  */
@@ -442,6 +651,8 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Test Example Device Attestation Information Verification", TestDACVerifierExample_AttestationInfoVerification),
     NL_TEST_DEF("Test Example Device Attestation Certification Declaration Verification", TestDACVerifierExample_CertDeclarationVerification),
     NL_TEST_DEF("Test Example Device Attestation Node Operational CSR Information Verification", TestDACVerifierExample_NocsrInformationVerification),
+    NL_TEST_DEF("Test DAC verifier cache of verified PAIs", TestDACVerifier_VerifiedPaiCache),
+    NL_TEST_DEF("Test DAC verifier cache of verified PAIs rejects bad DACs", TestDACVerifier_VerifiedPaiCacheRejectsBadDacs),
     NL_TEST_SENTINEL()
 };
 // clang-format on
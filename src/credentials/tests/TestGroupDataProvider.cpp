@@ -28,6 +28,7 @@
 #include <string.h>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 using namespace chip::Credentials;
 using GroupInfo      = GroupDataProvider::GroupInfo;
@@ -1196,6 +1197,93 @@ void TestGroupDecryption(nlTestSuite * apSuite, void * apContext)
     }
 }
 
+void TestGroupSessionCache(nlTestSuite * apSuite, void * apContext)
+{
+    GroupDataProvider * provider = GetGroupDataProvider();
+    NL_TEST_ASSERT(apSuite, provider);
+
+    // Reset test
+    ResetProvider(provider);
+
+    // The same epoch keys and compressed fabric id on both fabrics yield the same operational keys, so both group
+    // mappings match the same session id and either of them decrypts the message.
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetKeySet(kFabric1, kCompressedFabricId1, kKeySet1));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetKeySet(kFabric2, kCompressedFabricId1, kKeySet1));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetGroupKeyAt(kFabric1, 0, kGroup1Keyset1));
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->SetGroupKeyAt(kFabric2, 0, kGroup2Keyset1));
+
+    const uint8_t kMessage[]  = { 0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9 };
+    const uint8_t nonce[13]   = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x18, 0x1a, 0x1b, 0x1c };
+    const uint8_t aad[8]      = { 0x0a, 0x1a, 0x2a, 0x3a, 0x4a, 0x5a, 0x6a, 0x7a };
+    uint8_t mic[16]           = { 0 };
+    uint8_t ciphertext_buffer[sizeof(kMessage)];
+    uint8_t plaintext_buffer[sizeof(kMessage)];
+    MutableByteSpan ciphertext(ciphertext_buffer);
+    MutableByteSpan tag(mic);
+
+    Crypto::SymmetricKeyContext * key_context = provider->GetKeyContext(kFabric1, kGroup1);
+    NL_TEST_ASSERT(apSuite, nullptr != key_context);
+    if (nullptr == key_context)
+    {
+        return;
+    }
+    uint16_t session_id = key_context->GetKeyHash();
+    NL_TEST_ASSERT(apSuite,
+                   CHIP_NO_ERROR ==
+                       key_context->MessageEncrypt(ByteSpan(kMessage), ByteSpan(aad), ByteSpan(nonce), tag, ciphertext));
+    key_context->Release();
+
+    // Returns the fabrics of the sessions in iteration order, marking the last one as matched.
+    auto iterate = [&](std::vector<FabricIndex> & fabrics) {
+        fabrics.clear();
+        GroupSession session;
+        GroupSession last;
+        auto it = provider->IterateGroupSessions(session_id);
+        NL_TEST_ASSERT(apSuite, it);
+        if (it == nullptr)
+        {
+            return;
+        }
+        size_t count = it->Count();
+        while (it->Next(session))
+        {
+            MutableByteSpan plaintext(plaintext_buffer);
+            NL_TEST_ASSERT(apSuite,
+                           CHIP_NO_ERROR ==
+                               session.keyContext->MessageDecrypt(ciphertext, ByteSpan(aad), ByteSpan(nonce), tag, plaintext));
+            NL_TEST_ASSERT(apSuite, 0 == memcmp(plaintext.data(), kMessage, sizeof(kMessage)));
+            fabrics.push_back(session.fabric_index);
+            last = session;
+        }
+        NL_TEST_ASSERT(apSuite, count == fabrics.size());
+        if (!fabrics.empty())
+        {
+            provider->GroupSessionMatched(last);
+        }
+        it->Release();
+    };
+
+    std::vector<FabricIndex> first;
+    std::vector<FabricIndex> second;
+    iterate(first);
+    NL_TEST_ASSERT(apSuite, first.size() == 2);
+    iterate(second);
+    NL_TEST_ASSERT(apSuite, second.size() == 2);
+#if CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE >= 2
+    // The session matched last time comes first
+    NL_TEST_ASSERT(apSuite, first.size() == 2 && second.size() == 2 && second[0] == first[1] && second[1] == first[0]);
+#endif
+
+    // Changing the key mappings invalidates the cached sessions
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->RemoveGroupKeyAt(kFabric2, 0));
+    iterate(first);
+    NL_TEST_ASSERT(apSuite, first.size() == 1 && first[0] == kFabric1);
+
+    NL_TEST_ASSERT(apSuite, CHIP_NO_ERROR == provider->RemoveKeySet(kFabric1, kKeysetId1));
+    iterate(first);
+    NL_TEST_ASSERT(apSuite, first.empty());
+}
+
 } // namespace TestGroups
 } // namespace app
 } // namespace chip
@@ -1275,6 +1363,7 @@ const nlTest sTests[] = { NL_TEST_DEF("TestStorageDelegate", chip::app::TestGrou
                           NL_TEST_DEF("TestIpk", chip::app::TestGroups::TestIpk),
                           NL_TEST_DEF("TestPerFabricData", chip::app::TestGroups::TestPerFabricData),
                           NL_TEST_DEF("TestGroupDecryption", chip::app::TestGroups::TestGroupDecryption),
+                          NL_TEST_DEF("TestGroupSessionCache", chip::app::TestGroups::TestGroupSessionCache),
                           NL_TEST_SENTINEL() };
 } // namespace
 
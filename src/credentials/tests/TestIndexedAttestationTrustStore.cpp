@@ -0,0 +1,279 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#include <credentials/CHIPCert.h>
+#include <credentials/attestation_verifier/IndexedAttestationTrustStore.h>
+#include <credentials/attestation_verifier/TestPAAStore.h>
+#include <crypto/CHIPCryptoPAL.h>
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/Span.h>
+#include <lib/support/UnitTestRegistration.h>
+
+#include <nlunit-test.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "CHIPAttCert_test_vectors.h"
+
+using namespace chip;
+using namespace chip::Crypto;
+using namespace chip::Credentials;
+
+namespace {
+
+/**
+ * A PAA bundle file holding certificates back to back, removed when destroyed.
+ */
+class TestBundle
+{
+public:
+    ~TestBundle()
+    {
+        if (mPath[0] != '\0')
+        {
+            unlink(mPath);
+        }
+    }
+
+    CHIP_ERROR Write(std::initializer_list<ByteSpan> certificates)
+    {
+        int fd = mkstemp(mPath);
+        VerifyOrReturnError(fd >= 0, CHIP_ERROR_OPEN_FAILED);
+
+        FILE * file = fdopen(fd, "wb");
+        VerifyOrReturnError(file != nullptr, (close(fd), CHIP_ERROR_OPEN_FAILED));
+
+        bool written = true;
+        for (const auto & certificate : certificates)
+        {
+            written = written && fwrite(certificate.data(), 1, certificate.size(), file) == certificate.size();
+        }
+        written = (fclose(file) == 0) && written;
+
+        return written ? CHIP_NO_ERROR : CHIP_ERROR_WRITE_FAILED;
+    }
+
+    const char * GetPath() const { return mPath; }
+
+private:
+    char mPath[32] = "/tmp/paa-bundle-XXXXXX";
+};
+
+} // namespace
+
+static void TestIndexedAttestationTrustStore_LookupBySkid(nlTestSuite * inSuite, void * inContext)
+{
+    // PAA_NoVID and PAA_NoVID_ToResignPAIs have the same SKID, but different subjects.
+    NL_TEST_ASSERT(inSuite, TestCerts::sTestCert_PAA_NoVID_SKID.data_equal(TestCerts::sTestCert_PAA_NoVID_ToResignPAIs_SKID));
+
+    // Certificates that are not PAAs are skipped.
+    TestBundle bundle;
+    NL_TEST_ASSERT(inSuite,
+                   bundle.Write({ TestCerts::sTestCert_PAI_FFF1_8000_Cert, TestCerts::sTestCert_PAA_NoVID_Cert,
+                                  TestCerts::sTestCert_PAA_FFF1_Cert, TestCerts::sTestCert_PAA_NoVID_ToResignPAIs_Cert }) ==
+                       CHIP_NO_ERROR);
+
+    IndexedAttestationTrustStore trustStore;
+    NL_TEST_ASSERT(inSuite, trustStore.Init(nullptr, bundle.GetPath()) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, trustStore.paaCount() == 3);
+
+    // SKID that is not present
+    uint8_t kPaaGoodSkidNotPresent[] = { 0x6A, 0xFD, 0x22, 0x77, 0x1F, 0x51, 0x71, 0x1F, 0xEC, 0xBF,
+                                         0x16, 0x41, 0x97, 0x67, 0x10, 0xDC, 0xDC, 0x31, 0xA1, 0x71 };
+
+    struct TestCase
+    {
+        ByteSpan skidSpan;
+        ByteSpan expectedCertSpan;
+        CHIP_ERROR expectedResult;
+    };
+
+    const TestCase kTestCases[] = {
+        { TestCerts::sTestCert_PAA_FFF1_SKID, TestCerts::sTestCert_PAA_FFF1_Cert, CHIP_NO_ERROR },
+        // Of several PAAs with the same SKID, the first one loaded is found.
+        { TestCerts::sTestCert_PAA_NoVID_SKID, TestCerts::sTestCert_PAA_NoVID_Cert, CHIP_NO_ERROR },
+        { TestCerts::sTestCert_PAA_NoVID_SKID, TestCerts::sTestCert_PAA_NoVID_Cert, CHIP_ERROR_BUFFER_TOO_SMALL },
+        { TestCerts::sTestCert_PAI_FFF1_8000_SKID, ByteSpan(), CHIP_ERROR_CA_CERT_NOT_FOUND },
+        { ByteSpan(kPaaGoodSkidNotPresent), ByteSpan(), CHIP_ERROR_CA_CERT_NOT_FOUND },
+        { TestCerts::sTestCert_PAA_FFF1_SKID.SubSpan(1), ByteSpan(), CHIP_ERROR_INVALID_ARGUMENT },
+        { ByteSpan(), ByteSpan(), CHIP_ERROR_INVALID_ARGUMENT },
+    };
+
+    for (const auto & testCase : kTestCases)
+    {
+        uint8_t buf[kMaxDERCertLength];
+        MutableByteSpan paaCertSpan{ buf };
+        if (testCase.expectedResult == CHIP_ERROR_BUFFER_TOO_SMALL)
+        {
+            // Make the output much too small if checking for size handling
+            paaCertSpan = paaCertSpan.SubSpan(0, 16);
+        }
+
+        CHIP_ERROR result = trustStore.GetProductAttestationAuthorityCert(testCase.skidSpan, paaCertSpan);
+        NL_TEST_ASSERT(inSuite, result == testCase.expectedResult);
+
+        if (testCase.expectedResult == CHIP_NO_ERROR)
+        {
+            NL_TEST_ASSERT(inSuite, paaCertSpan.data_equal(testCase.expectedCertSpan));
+        }
+    }
+}
+
+static void TestIndexedAttestationTrustStore_LookupBySubject(nlTestSuite * inSuite, void * inContext)
+{
+    TestBundle bundle;
+    NL_TEST_ASSERT(inSuite,
+                   bundle.Write({ TestCerts::sTestCert_PAA_NoVID_Cert, TestCerts::sTestCert_PAA_NoVID_ToResignPAIs_Cert }) ==
+                       CHIP_NO_ERROR);
+
+    IndexedAttestationTrustStore trustStore;
+    NL_TEST_ASSERT(inSuite, trustStore.Init(nullptr, bundle.GetPath()) == CHIP_NO_ERROR);
+
+    // The PAAs with the same SKID are told apart by the issuer of the PAI.
+    const ByteSpan kTestCases[][2] = {
+        { TestCerts::sTestCert_PAI_FFF2_8001_Cert, TestCerts::sTestCert_PAA_NoVID_Cert },
+        { TestCerts::sTestCert_PAI_FFF2_8001_Resigned_Cert, TestCerts::sTestCert_PAA_NoVID_ToResignPAIs_Cert },
+    };
+
+    for (const auto & testCase : kTestCases)
+    {
+        uint8_t issuerBuf[kMaxDERCertLength];
+        MutableByteSpan issuer{ issuerBuf };
+        NL_TEST_ASSERT(inSuite, ExtractIssuerFromX509Cert(testCase[0], issuer) == CHIP_NO_ERROR);
+
+        uint8_t buf[kMaxDERCertLength];
+        MutableByteSpan paaCertSpan{ buf };
+        NL_TEST_ASSERT(inSuite, trustStore.GetProductAttestationAuthorityCertBySubject(issuer, paaCertSpan) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, paaCertSpan.data_equal(testCase[1]));
+    }
+
+    uint8_t subjectBuf[kMaxDERCertLength];
+    MutableByteSpan subject{ subjectBuf };
+    NL_TEST_ASSERT(inSuite, ExtractSubjectFromX509Cert(TestCerts::sTestCert_PAA_FFF1_Cert, subject) == CHIP_NO_ERROR);
+
+    uint8_t buf[kMaxDERCertLength];
+    MutableByteSpan paaCertSpan{ buf };
+    NL_TEST_ASSERT(inSuite,
+                   trustStore.GetProductAttestationAuthorityCertBySubject(subject, paaCertSpan) == CHIP_ERROR_CA_CERT_NOT_FOUND);
+}
+
+static void TestIndexedAttestationTrustStore_Reload(nlTestSuite * inSuite, void * inContext)
+{
+    TestBundle bundle;
+    NL_TEST_ASSERT(inSuite, bundle.Write({ TestCerts::sTestCert_PAA_FFF1_Cert }) == CHIP_NO_ERROR);
+
+    IndexedAttestationTrustStore trustStore;
+    NL_TEST_ASSERT(inSuite, trustStore.Init(nullptr, bundle.GetPath()) == CHIP_NO_ERROR);
+
+    bool reloaded = true;
+    NL_TEST_ASSERT(inSuite, trustStore.ReloadIfChanged(reloaded) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !reloaded);
+
+    // A bundle that no longer parses leaves the previous contents in place.
+    FILE * file = fopen(bundle.GetPath(), "ab");
+    NL_TEST_ASSERT(inSuite, file != nullptr && fputc(0x30, file) != EOF && fclose(file) == 0);
+    NL_TEST_ASSERT(inSuite, trustStore.ReloadIfChanged(reloaded) != CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !reloaded);
+
+    uint8_t buf[kMaxDERCertLength];
+    MutableByteSpan paaCertSpan{ buf };
+    NL_TEST_ASSERT(inSuite,
+                   trustStore.GetProductAttestationAuthorityCert(TestCerts::sTestCert_PAA_FFF1_SKID, paaCertSpan) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, paaCertSpan.data_equal(TestCerts::sTestCert_PAA_FFF1_Cert));
+}
+
+static void TestIndexedAttestationTrustStore_TruncatedBundle(nlTestSuite * inSuite, void * inContext)
+{
+    TestBundle bundle;
+    NL_TEST_ASSERT(inSuite, bundle.Write({ TestCerts::sTestCert_PAA_FFF1_Cert }) == CHIP_NO_ERROR);
+
+    IndexedAttestationTrustStore trustStore;
+    NL_TEST_ASSERT(inSuite, trustStore.Init(nullptr, bundle.GetPath()) == CHIP_NO_ERROR);
+
+    // The loaded certificates do not depend on the file any more: truncating it does not affect lookups.
+    NL_TEST_ASSERT(inSuite, truncate(bundle.GetPath(), 0) == 0);
+
+    uint8_t buf[kMaxDERCertLength];
+    MutableByteSpan paaCertSpan{ buf };
+    NL_TEST_ASSERT(inSuite,
+                   trustStore.GetProductAttestationAuthorityCert(TestCerts::sTestCert_PAA_FFF1_SKID, paaCertSpan) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, paaCertSpan.data_equal(TestCerts::sTestCert_PAA_FFF1_Cert));
+
+    // Nor does failing to reload the empty bundle.
+    bool reloaded = true;
+    NL_TEST_ASSERT(inSuite, trustStore.ReloadIfChanged(reloaded) == CHIP_ERROR_CA_CERT_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, !reloaded);
+    NL_TEST_ASSERT(inSuite, trustStore.paaCount() == 1);
+}
+
+/**
+ *  Set up the test suite.
+ */
+int TestIndexedAttestationTrustStore_Setup(void * inContext)
+{
+    CHIP_ERROR error = chip::Platform::MemoryInit();
+
+    if (error != CHIP_NO_ERROR)
+    {
+        return FAILURE;
+    }
+
+    return SUCCESS;
+}
+
+/**
+ *  Tear down the test suite.
+ */
+int TestIndexedAttestationTrustStore_Teardown(void * inContext)
+{
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+// clang-format off
+static const nlTest sTests[] = {
+    NL_TEST_DEF("Test PAA lookup by SKID", TestIndexedAttestationTrustStore_LookupBySkid),
+    NL_TEST_DEF("Test PAA lookup by subject", TestIndexedAttestationTrustStore_LookupBySubject),
+    NL_TEST_DEF("Test PAA bundle reload", TestIndexedAttestationTrustStore_Reload),
+    NL_TEST_DEF("Test PAA bundle truncated after load", TestIndexedAttestationTrustStore_TruncatedBundle),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+int TestIndexedAttestationTrustStore()
+{
+    // clang-format off
+    nlTestSuite theSuite =
+    {
+        "Indexed Attestation Trust Store",
+        &sTests[0],
+        TestIndexedAttestationTrustStore_Setup,
+        TestIndexedAttestationTrustStore_Teardown
+    };
+    // clang-format on
+    nlTestRunner(&theSuite, nullptr);
+    return (nlTestRunnerStats(&theSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestIndexedAttestationTrustStore);
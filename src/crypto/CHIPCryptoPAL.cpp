@@ -789,6 +789,21 @@ CHIP_ERROR AES_CTR_crypt(const uint8_t * input, size_t input_length, const Aes12
     return AES_CCM_encrypt(input, input_length, nullptr, 0, key, nonce, nonce_length, output, tag, kTagLen);
 }
 
+Aes128KeyHandle::~Aes128KeyHandle()
+{
+    // Keystores release the cipher context when the key is destroyed, but a handle may go away without that.
+    AES_CCM_ReleaseKeyContext(*this);
+    ClearSecretData(mContext.mOpaque);
+}
+
+#if !CHIP_CRYPTO_OPENSSL && !CHIP_CRYPTO_BORINGSSL && !CHIP_CRYPTO_MBEDTLS
+// Backends that keep no cipher context per key handle: PSA keys are already held by the PSA key store, and platform
+// backends bring their own AES-CCM.
+void AES_CCM_InitKeyContext(Aes128KeyHandle & key) {}
+
+void AES_CCM_ReleaseKeyContext(Aes128KeyHandle & key) {}
+#endif // !CHIP_CRYPTO_OPENSSL && !CHIP_CRYPTO_BORINGSSL && !CHIP_CRYPTO_MBEDTLS
+
 CHIP_ERROR GenerateCompressedFabricId(const Crypto::P256PublicKey & root_public_key, uint64_t fabric_id,
                                       MutableByteSpan & out_compressed_fabric_id)
 {
@@ -564,6 +564,19 @@ protected:
 
 using Aes128KeyByteArray = uint8_t[CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES];
 
+/**
+ * @brief Representation of an Aes128KeyHandle that holds raw key material
+ *
+ * This is how RawKeySessionKeystore fills key handles. The key comes first, so that such a handle can also be read as
+ * an Aes128KeyByteArray. mCipherContext is null, or points to a cipher context of the crypto backend with the key
+ * already set up, see AES_CCM_InitKeyContext().
+ */
+struct RawAes128Key
+{
+    Aes128KeyByteArray mKey;
+    void * mCipherContext;
+};
+
 /**
  * @brief Platform-specific AES key
  *
@@ -576,7 +589,7 @@ class Aes128KeyHandle
 {
 public:
     Aes128KeyHandle() = default;
-    ~Aes128KeyHandle() { ClearSecretData(mContext.mOpaque); }
+    ~Aes128KeyHandle();
 
     Aes128KeyHandle(const Aes128KeyHandle &) = delete;
     Aes128KeyHandle(Aes128KeyHandle &&)      = delete;
@@ -602,7 +615,7 @@ public:
     }
 
 private:
-    static constexpr size_t kContextSize = CHIP_CRYPTO_SYMMETRIC_KEY_LENGTH_BYTES;
+    static constexpr size_t kContextSize = sizeof(RawAes128Key);
 
     struct alignas(uintptr_t) OpaqueContext
     {
@@ -724,6 +737,28 @@ CHIP_ERROR AES_CCM_decrypt(const uint8_t * ciphertext, size_t ciphertext_length,
                            const uint8_t * tag, size_t tag_length, const Aes128KeyHandle & key, const uint8_t * nonce,
                            size_t nonce_length, uint8_t * plaintext);
 
+/**
+ * @brief Attach a cipher context with the key already set up to a key handle holding raw key material
+ *
+ * AES_CCM_encrypt() and AES_CCM_decrypt() reuse the context for this key, so that a message only costs the nonce and
+ * data processing instead of a full key setup. This is meant for keys that protect many messages, such as session
+ * keys. The context belongs to the handle: it must not be used from several threads at once, and must be released with
+ * AES_CCM_ReleaseKeyContext() before the handle is given other key material. Destroying the handle also releases it.
+ *
+ * This is best effort. Backends that keep no such context, or fail to allocate one, leave the handle as it is, and the
+ * key is then set up for every message.
+ *
+ * @param key Key handle holding raw key material, see RawAes128Key
+ */
+void AES_CCM_InitKeyContext(Aes128KeyHandle & key);
+
+/**
+ * @brief Release the cipher context attached by AES_CCM_InitKeyContext(), if any
+ *
+ * @param key Key handle holding raw key material, see RawAes128Key
+ */
+void AES_CCM_ReleaseKeyContext(Aes128KeyHandle & key);
+
 /**
  * @brief A function that implements AES-CTR encryption/decryption
  *
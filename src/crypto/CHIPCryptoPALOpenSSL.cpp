@@ -48,6 +48,7 @@
 #include <lib/support/BufferWriter.h>
 #include <lib/support/BytesToHex.h>
 #include <lib/support/CHIPArgParser.hpp>
+#include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/SafeInt.h>
 #include <lib/support/SafePointerCast.h>
@@ -146,6 +147,118 @@ static int _compareDaysAndSeconds(const int days, const int seconds)
     return 0;
 }
 
+#if !CHIP_CRYPTO_BORINGSSL
+
+/**
+ * An AES-CCM context with the key of a handle set up, for one direction. CCM binds the nonce and tag lengths to the
+ * key setup, so the context only serves messages with the lengths it was set up for.
+ */
+struct AesCcmCipherContext
+{
+    EVP_CIPHER_CTX * mContext = nullptr;
+    size_t mNonceLength       = 0;
+    size_t mTagLength         = 0;
+};
+
+/**
+ * The contexts attached to a key handle by AES_CCM_InitKeyContext(). Each is set up on first use, since a session key
+ * is normally only used in one direction.
+ */
+struct AesCcmKeyContext
+{
+    AesCcmCipherContext mEncrypt;
+    AesCcmCipherContext mDecrypt;
+};
+
+/**
+ * Set up an AES-128-CCM context for the given direction and lengths, with the key and, if not null, the nonce.  When
+ * decrypting, a non-null tag is the expected tag.
+ */
+static bool _initAesCcmContext(EVP_CIPHER_CTX * context, int enc, const Aes128KeyHandle & key, const uint8_t * nonce,
+                               size_t nonce_length, const uint8_t * tag, size_t tag_length)
+{
+    static_assert(kAES_CCM128_Key_Length == sizeof(Aes128KeyByteArray), "Unexpected key length");
+
+    // Casts are safe because the callers check nonce_length with CanCastTo, and tag_length against
+    // CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES.  Removing "const" from |tag| is safe as it is only read when decrypting.
+    return EVP_CipherInit_ex(context, EVP_aes_128_ccm(), nullptr, nullptr, nullptr, enc) == 1 &&
+        EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_IVLEN, static_cast<int>(nonce_length), nullptr) == 1 &&
+        EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_TAG, static_cast<int>(tag_length),
+                            const_cast<void *>(static_cast<const void *>(tag))) == 1 &&
+        EVP_CipherInit_ex(context, nullptr, nullptr, key.As<Aes128KeyByteArray>(), Uint8::to_const_uchar(nonce), enc) == 1;
+}
+
+/**
+ * Return the context attached to the key for the given direction, setting it up on first use, or nullptr if the key
+ * has no attached contexts or the context was set up for other lengths.
+ */
+static EVP_CIPHER_CTX * _getAesCcmKeyContext(const Aes128KeyHandle & key, int enc, size_t nonce_length, size_t tag_length)
+{
+    auto * keyContext = static_cast<AesCcmKeyContext *>(key.As<RawAes128Key>().mCipherContext);
+    VerifyOrReturnValue(keyContext != nullptr, nullptr);
+
+    AesCcmCipherContext & cipher = enc ? keyContext->mEncrypt : keyContext->mDecrypt;
+    if (cipher.mContext == nullptr)
+    {
+        EVP_CIPHER_CTX * context = EVP_CIPHER_CTX_new();
+        VerifyOrReturnValue(context != nullptr, nullptr);
+
+        if (!_initAesCcmContext(context, enc, key, nullptr, nonce_length, nullptr, tag_length))
+        {
+            EVP_CIPHER_CTX_free(context);
+            return nullptr;
+        }
+
+        cipher.mContext     = context;
+        cipher.mNonceLength = nonce_length;
+        cipher.mTagLength   = tag_length;
+    }
+
+    VerifyOrReturnValue(cipher.mNonceLength == nonce_length && cipher.mTagLength == tag_length, nullptr);
+    return cipher.mContext;
+}
+
+/**
+ * Free the context attached to the key for the given direction, after an operation failed and may have left it in a
+ * state that is unsafe to continue from. It is set up again on next use.
+ */
+static void _resetAesCcmKeyContext(const Aes128KeyHandle & key, int enc)
+{
+    auto * keyContext = static_cast<AesCcmKeyContext *>(key.As<RawAes128Key>().mCipherContext);
+    VerifyOrReturn(keyContext != nullptr);
+
+    AesCcmCipherContext & cipher = enc ? keyContext->mEncrypt : keyContext->mDecrypt;
+    EVP_CIPHER_CTX_free(cipher.mContext);
+    cipher = AesCcmCipherContext();
+}
+
+#endif // !CHIP_CRYPTO_BORINGSSL
+
+void AES_CCM_InitKeyContext(Aes128KeyHandle & key)
+{
+#if !CHIP_CRYPTO_BORINGSSL
+    RawAes128Key & rawKey = key.AsMutable<RawAes128Key>();
+    if (rawKey.mCipherContext == nullptr)
+    {
+        rawKey.mCipherContext = Platform::New<AesCcmKeyContext>();
+    }
+#endif // !CHIP_CRYPTO_BORINGSSL
+}
+
+void AES_CCM_ReleaseKeyContext(Aes128KeyHandle & key)
+{
+#if !CHIP_CRYPTO_BORINGSSL
+    RawAes128Key & rawKey = key.AsMutable<RawAes128Key>();
+    auto * keyContext     = static_cast<AesCcmKeyContext *>(rawKey.mCipherContext);
+    VerifyOrReturn(keyContext != nullptr);
+
+    EVP_CIPHER_CTX_free(keyContext->mEncrypt.mContext);
+    EVP_CIPHER_CTX_free(keyContext->mDecrypt.mContext);
+    Platform::Delete(keyContext);
+    rawKey.mCipherContext = nullptr;
+#endif // !CHIP_CRYPTO_BORINGSSL
+}
+
 CHIP_ERROR AES_CCM_encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
                            const Aes128KeyHandle & key, const uint8_t * nonce, size_t nonce_length, uint8_t * ciphertext,
                            uint8_t * tag, size_t tag_length)
@@ -156,9 +269,9 @@ CHIP_ERROR AES_CCM_encrypt(const uint8_t * plaintext, size_t plaintext_length, c
     const EVP_AEAD * aead  = nullptr;
 #else
     EVP_CIPHER_CTX * context = nullptr;
+    bool contextIsCached     = false;
     int bytesWritten         = 0;
     size_t ciphertext_length = 0;
-    const EVP_CIPHER * type  = nullptr;
 #endif
     CHIP_ERROR error = CHIP_NO_ERROR;
     int result       = 1;
@@ -213,27 +326,23 @@ CHIP_ERROR AES_CCM_encrypt(const uint8_t * plaintext, size_t plaintext_length, c
     VerifyOrExit(written_tag_len == tag_length, error = CHIP_ERROR_INTERNAL);
 #else
 
-    type = EVP_aes_128_ccm();
-
-    context = EVP_CIPHER_CTX_new();
-    VerifyOrExit(context != nullptr, error = CHIP_ERROR_NO_MEMORY);
-
-    // Pass in cipher
-    result = EVP_EncryptInit_ex(context, type, nullptr, nullptr, nullptr);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-
-    // Pass in nonce length.  Cast is safe because we checked with CanCastTo.
-    result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_IVLEN, static_cast<int>(nonce_length), nullptr);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-
-    // Pass in tag length. Cast is safe because we checked against CHIP_CRYPTO_AEAD_MIC_LENGTH_BYTES.
-    result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_TAG, static_cast<int>(tag_length), nullptr);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    // Reuse the context attached to the key if there is one, so that only the nonce needs passing in.
+    context = _getAesCcmKeyContext(key, 1, nonce_length, tag_length);
+    if (context != nullptr)
+    {
+        contextIsCached = true;
+        result          = EVP_EncryptInit_ex(context, nullptr, nullptr, nullptr, Uint8::to_const_uchar(nonce));
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    }
+    else
+    {
+        context = EVP_CIPHER_CTX_new();
+        VerifyOrExit(context != nullptr, error = CHIP_ERROR_NO_MEMORY);
 
-    // Pass in key + nonce
-    static_assert(kAES_CCM128_Key_Length == sizeof(Aes128KeyByteArray), "Unexpected key length");
-    result = EVP_EncryptInit_ex(context, nullptr, nullptr, key.As<Aes128KeyByteArray>(), Uint8::to_const_uchar(nonce));
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+        // Pass in cipher, nonce length, tag length, key and nonce
+        VerifyOrExit(_initAesCcmContext(context, 1, key, nonce, nonce_length, nullptr, tag_length),
+                     error = CHIP_ERROR_INTERNAL);
+    }
 
     // Pass in plain text length
     VerifyOrExit(CanCastTo<int>(plaintext_length), error = CHIP_ERROR_INVALID_ARGUMENT);
@@ -273,7 +382,14 @@ exit:
 #if CHIP_CRYPTO_BORINGSSL
         EVP_AEAD_CTX_free(context);
 #else
-        EVP_CIPHER_CTX_free(context);
+        if (!contextIsCached)
+        {
+            EVP_CIPHER_CTX_free(context);
+        }
+        else if (error != CHIP_NO_ERROR)
+        {
+            _resetAesCcmKeyContext(key, 1);
+        }
 #endif // CHIP_CRYPTO_BORINGSSL
         context = nullptr;
     }
@@ -291,8 +407,8 @@ CHIP_ERROR AES_CCM_decrypt(const uint8_t * ciphertext, size_t ciphertext_length,
 #else
 
     EVP_CIPHER_CTX * context = nullptr;
+    bool contextIsCached     = false;
     int bytesOutput          = 0;
-    const EVP_CIPHER * type  = nullptr;
 #endif // CHIP_CRYPTO_BORINGSSL
     CHIP_ERROR error = CHIP_NO_ERROR;
     int result       = 1;
@@ -343,32 +459,27 @@ CHIP_ERROR AES_CCM_decrypt(const uint8_t * ciphertext, size_t ciphertext_length,
                                       aad_length);
     VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
 #else
-    type = EVP_aes_128_ccm();
-
-    context = EVP_CIPHER_CTX_new();
-    VerifyOrExit(context != nullptr, error = CHIP_ERROR_NO_MEMORY);
-
-    // Pass in cipher
-    result = EVP_DecryptInit_ex(context, type, nullptr, nullptr, nullptr);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
-
-    // Pass in nonce length
     VerifyOrExit(CanCastTo<int>(nonce_length), error = CHIP_ERROR_INVALID_ARGUMENT);
-    result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_IVLEN, static_cast<int>(nonce_length), nullptr);
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
 
-    // Pass in expected tag
-    // Removing "const" from |tag| here should hopefully be safe as
-    // we're writing the tag, not reading.
-    VerifyOrExit(CanCastTo<int>(tag_length), error = CHIP_ERROR_INVALID_ARGUMENT);
-    result = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_TAG, static_cast<int>(tag_length),
+    // Reuse the context attached to the key if there is one, so that only the expected tag and the nonce need passing in.
+    context = _getAesCcmKeyContext(key, 0, nonce_length, tag_length);
+    if (context != nullptr)
+    {
+        contextIsCached = true;
+        result          = EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_CCM_SET_TAG, static_cast<int>(tag_length),
                                               const_cast<void *>(static_cast<const void *>(tag)));
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+        result = EVP_DecryptInit_ex(context, nullptr, nullptr, nullptr, Uint8::to_const_uchar(nonce));
+        VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+    }
+    else
+    {
+        context = EVP_CIPHER_CTX_new();
+        VerifyOrExit(context != nullptr, error = CHIP_ERROR_NO_MEMORY);
 
-    // Pass in key + nonce
-    static_assert(kAES_CCM128_Key_Length == sizeof(Aes128KeyByteArray), "Unexpected key length");
-    result = EVP_DecryptInit_ex(context, nullptr, nullptr, key.As<Aes128KeyByteArray>(), Uint8::to_const_uchar(nonce));
-    VerifyOrExit(result == 1, error = CHIP_ERROR_INTERNAL);
+        // Pass in cipher, nonce length, expected tag, key and nonce
+        VerifyOrExit(_initAesCcmContext(context, 0, key, nonce, nonce_length, tag, tag_length), error = CHIP_ERROR_INTERNAL);
+    }
 
     // Pass in cipher text length
     VerifyOrExit(CanCastTo<int>(ciphertext_length), error = CHIP_ERROR_INVALID_ARGUMENT);
@@ -402,7 +513,14 @@ exit:
 #if CHIP_CRYPTO_BORINGSSL
         EVP_AEAD_CTX_free(context);
 #else
-        EVP_CIPHER_CTX_free(context);
+        if (!contextIsCached)
+        {
+            EVP_CIPHER_CTX_free(context);
+        }
+        else if (error != CHIP_NO_ERROR)
+        {
+            _resetAesCcmKeyContext(key, 0);
+        }
 #endif // CHIP_CRYPTO_BORINGSSL
 
         context = nullptr;
@@ -45,6 +45,7 @@
 #include <lib/support/BufferWriter.h>
 #include <lib/support/BytesToHex.h>
 #include <lib/support/CHIPArgParser.hpp>
+#include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/SafeInt.h>
 #include <lib/support/SafePointerCast.h>
@@ -74,6 +75,45 @@ static bool _isValidTagLength(size_t tag_length)
     return false;
 }
 
+/**
+ * Return the CCM context attached to the key by AES_CCM_InitKeyContext(), with the key already set, or nullptr.
+ */
+static mbedtls_ccm_context * _getCcmKeyContext(const Aes128KeyHandle & key)
+{
+    return static_cast<mbedtls_ccm_context *>(key.As<RawAes128Key>().mCipherContext);
+}
+
+void AES_CCM_InitKeyContext(Aes128KeyHandle & key)
+{
+    RawAes128Key & rawKey = key.AsMutable<RawAes128Key>();
+    VerifyOrReturn(rawKey.mCipherContext == nullptr);
+
+    auto * context = Platform::New<mbedtls_ccm_context>();
+    VerifyOrReturn(context != nullptr);
+    mbedtls_ccm_init(context);
+
+    // Size of key is expressed in bits, hence the multiplication by 8.
+    if (mbedtls_ccm_setkey(context, MBEDTLS_CIPHER_ID_AES, rawKey.mKey, sizeof(Aes128KeyByteArray) * 8) != 0)
+    {
+        mbedtls_ccm_free(context);
+        Platform::Delete(context);
+        return;
+    }
+
+    rawKey.mCipherContext = context;
+}
+
+void AES_CCM_ReleaseKeyContext(Aes128KeyHandle & key)
+{
+    RawAes128Key & rawKey = key.AsMutable<RawAes128Key>();
+    auto * context        = static_cast<mbedtls_ccm_context *>(rawKey.mCipherContext);
+    VerifyOrReturn(context != nullptr);
+
+    mbedtls_ccm_free(context);
+    Platform::Delete(context);
+    rawKey.mCipherContext = nullptr;
+}
+
 CHIP_ERROR AES_CCM_encrypt(const uint8_t * plaintext, size_t plaintext_length, const uint8_t * aad, size_t aad_length,
                            const Aes128KeyHandle & key, const uint8_t * nonce, size_t nonce_length, uint8_t * ciphertext,
                            uint8_t * tag, size_t tag_length)
@@ -82,6 +122,7 @@ CHIP_ERROR AES_CCM_encrypt(const uint8_t * plaintext, size_t plaintext_length, c
     int result       = 1;
 
     mbedtls_ccm_context context;
+    mbedtls_ccm_context * cipherContext = nullptr;
     mbedtls_ccm_init(&context);
 
     VerifyOrExit(plaintext != nullptr || plaintext_length == 0, error = CHIP_ERROR_INVALID_ARGUMENT);
@@ -95,12 +136,19 @@ CHIP_ERROR AES_CCM_encrypt(const uint8_t * plaintext, size_t plaintext_length, c
         VerifyOrExit(aad != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
     }
 
-    // Size of key is expressed in bits, hence the multiplication by 8.
-    result = mbedtls_ccm_setkey(&context, MBEDTLS_CIPHER_ID_AES, key.As<Aes128KeyByteArray>(), sizeof(Aes128KeyByteArray) * 8);
-    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+    // Use the context attached to the key if there is one, so that the key schedule is not expanded again.
+    cipherContext = _getCcmKeyContext(key);
+    if (cipherContext == nullptr)
+    {
+        // Size of key is expressed in bits, hence the multiplication by 8.
+        result =
+            mbedtls_ccm_setkey(&context, MBEDTLS_CIPHER_ID_AES, key.As<Aes128KeyByteArray>(), sizeof(Aes128KeyByteArray) * 8);
+        VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+        cipherContext = &context;
+    }
 
     // Encrypt
-    result = mbedtls_ccm_encrypt_and_tag(&context, plaintext_length, Uint8::to_const_uchar(nonce), nonce_length,
+    result = mbedtls_ccm_encrypt_and_tag(cipherContext, plaintext_length, Uint8::to_const_uchar(nonce), nonce_length,
                                          Uint8::to_const_uchar(aad), aad_length, Uint8::to_const_uchar(plaintext),
                                          Uint8::to_uchar(ciphertext), Uint8::to_uchar(tag), tag_length);
     _log_mbedTLS_error(result);
@@ -119,6 +167,7 @@ CHIP_ERROR AES_CCM_decrypt(const uint8_t * ciphertext, size_t ciphertext_len, co
     int result       = 1;
 
     mbedtls_ccm_context context;
+    mbedtls_ccm_context * cipherContext = nullptr;
     mbedtls_ccm_init(&context);
 
     VerifyOrExit(plaintext != nullptr || ciphertext_len == 0, error = CHIP_ERROR_INVALID_ARGUMENT);
@@ -132,12 +181,19 @@ CHIP_ERROR AES_CCM_decrypt(const uint8_t * ciphertext, size_t ciphertext_len, co
         VerifyOrExit(aad != nullptr, error = CHIP_ERROR_INVALID_ARGUMENT);
     }
 
-    // Size of key is expressed in bits, hence the multiplication by 8.
-    result = mbedtls_ccm_setkey(&context, MBEDTLS_CIPHER_ID_AES, key.As<Aes128KeyByteArray>(), sizeof(Aes128KeyByteArray) * 8);
-    VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+    // Use the context attached to the key if there is one, so that the key schedule is not expanded again.
+    cipherContext = _getCcmKeyContext(key);
+    if (cipherContext == nullptr)
+    {
+        // Size of key is expressed in bits, hence the multiplication by 8.
+        result =
+            mbedtls_ccm_setkey(&context, MBEDTLS_CIPHER_ID_AES, key.As<Aes128KeyByteArray>(), sizeof(Aes128KeyByteArray) * 8);
+        VerifyOrExit(result == 0, error = CHIP_ERROR_INTERNAL);
+        cipherContext = &context;
+    }
 
     // Decrypt
-    result = mbedtls_ccm_auth_decrypt(&context, ciphertext_len, Uint8::to_const_uchar(nonce), nonce_length,
+    result = mbedtls_ccm_auth_decrypt(cipherContext, ciphertext_len, Uint8::to_const_uchar(nonce), nonce_length,
                                       Uint8::to_const_uchar(aad), aad_len, Uint8::to_const_uchar(ciphertext),
                                       Uint8::to_uchar(plaintext), Uint8::to_const_uchar(tag), tag_length);
     _log_mbedTLS_error(result);
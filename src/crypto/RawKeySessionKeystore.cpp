@@ -46,19 +46,33 @@ CHIP_ERROR RawKeySessionKeystore::DeriveSessionKeys(const ByteSpan & secret, con
     HKDF_sha_crypto hkdf;
     uint8_t keyMaterial[2 * sizeof(Aes128KeyByteArray) + AttestationChallenge::Capacity()];
 
+    // Do not keep contexts set up for the keys being replaced.
+    AES_CCM_ReleaseKeyContext(i2rKey);
+    AES_CCM_ReleaseKeyContext(r2iKey);
+
     ReturnErrorOnFailure(hkdf.HKDF_SHA256(secret.data(), secret.size(), salt.data(), salt.size(), info.data(), info.size(),
                                           keyMaterial, sizeof(keyMaterial)));
 
     Encoding::LittleEndian::Reader reader(keyMaterial, sizeof(keyMaterial));
 
-    return reader.ReadBytes(i2rKey.AsMutable<Aes128KeyByteArray>(), sizeof(Aes128KeyByteArray))
-        .ReadBytes(r2iKey.AsMutable<Aes128KeyByteArray>(), sizeof(Aes128KeyByteArray))
-        .ReadBytes(attestationChallenge.Bytes(), AttestationChallenge::Capacity())
-        .StatusCode();
+    ReturnErrorOnFailure(reader.ReadBytes(i2rKey.AsMutable<Aes128KeyByteArray>(), sizeof(Aes128KeyByteArray))
+                             .ReadBytes(r2iKey.AsMutable<Aes128KeyByteArray>(), sizeof(Aes128KeyByteArray))
+                             .ReadBytes(attestationChallenge.Bytes(), AttestationChallenge::Capacity())
+                             .StatusCode());
+
+#if CHIP_CONFIG_SESSION_KEY_CIPHER_CONTEXT
+    // Session keys are used for every message of the session, so set up their cipher contexts once. They are released
+    // by DestroyKey() when the session goes away.
+    AES_CCM_InitKeyContext(i2rKey);
+    AES_CCM_InitKeyContext(r2iKey);
+#endif // CHIP_CONFIG_SESSION_KEY_CIPHER_CONTEXT
+
+    return CHIP_NO_ERROR;
 }
 
 void RawKeySessionKeystore::DestroyKey(Aes128KeyHandle & key)
 {
+    AES_CCM_ReleaseKeyContext(key);
     ClearSecretData(key.AsMutable<Aes128KeyByteArray>());
 }
 
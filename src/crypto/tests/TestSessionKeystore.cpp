@@ -188,8 +188,108 @@ void TestDeriveSessionKeys(nlTestSuite * inSuite, void * inContext)
     }
 }
 
+void TestSessionKeysRoundTrip(nlTestSuite * inSuite, void * inContext)
+{
+    TestSessionKeystoreImpl keystore;
+    const DeriveSessionKeysTestVector & test = deriveSessionKeysTestVectors[0];
+
+    Aes128KeyHandle i2r;
+    Aes128KeyHandle r2i;
+    AttestationChallenge challenge;
+    NL_TEST_ASSERT_SUCCESS(
+        inSuite, keystore.DeriveSessionKeys(ToSpan(test.secret), ToSpan(test.salt), ToSpan(test.info), i2r, r2i, challenge));
+
+    // Session keys may keep a cipher context across messages, so encrypt and decrypt several messages with each key,
+    // including one that fails authentication and one with a different tag length.
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        Aes128KeyHandle & key  = (i % 2) ? r2i : i2r;
+        const size_t tagLength = (i == 5) ? 8 : kAES_CCM128_Tag_Length;
+
+        uint8_t nonce[kAES_CCM128_Nonce_Length] = { i };
+        uint8_t aad[4]                          = { 0xA0, 0xA1, 0xA2, i };
+        uint8_t plaintext[24];
+        uint8_t ciphertext[sizeof(plaintext)];
+        uint8_t decrypted[sizeof(plaintext)];
+        uint8_t tag[kAES_CCM128_Tag_Length];
+        memset(plaintext, i, sizeof(plaintext));
+
+        NL_TEST_ASSERT_SUCCESS(inSuite,
+                               AES_CCM_encrypt(plaintext, sizeof(plaintext), aad, sizeof(aad), key, nonce, sizeof(nonce),
+                                               ciphertext, tag, tagLength));
+
+        if (i == 2)
+        {
+            tag[0] ^= 0x01;
+            NL_TEST_ASSERT(inSuite,
+                           AES_CCM_decrypt(ciphertext, sizeof(ciphertext), aad, sizeof(aad), tag, tagLength, key, nonce,
+                                           sizeof(nonce), decrypted) != CHIP_NO_ERROR);
+            tag[0] ^= 0x01;
+        }
+
+        NL_TEST_ASSERT_SUCCESS(inSuite,
+                               AES_CCM_decrypt(ciphertext, sizeof(ciphertext), aad, sizeof(aad), tag, tagLength, key, nonce,
+                                               sizeof(nonce), decrypted));
+        NL_TEST_ASSERT(inSuite, memcmp(decrypted, plaintext, sizeof(plaintext)) == 0);
+    }
+
+    // The keys must still produce the expected output.
+    uint8_t ciphertext[sizeof(test.i2rCiphertext)];
+    NL_TEST_ASSERT_SUCCESS(inSuite,
+                           AES_CTR_crypt(test.plaintext, sizeof(test.plaintext), i2r, test.nonce, sizeof(test.nonce), ciphertext));
+    NL_TEST_ASSERT(inSuite, memcmp(ciphertext, test.i2rCiphertext, sizeof(test.i2rCiphertext)) == 0);
+    NL_TEST_ASSERT_SUCCESS(inSuite,
+                           AES_CTR_crypt(test.plaintext, sizeof(test.plaintext), r2i, test.nonce, sizeof(test.nonce), ciphertext));
+    NL_TEST_ASSERT(inSuite, memcmp(ciphertext, test.r2iCiphertext, sizeof(test.r2iCiphertext)) == 0);
+
+    keystore.DestroyKey(i2r);
+    keystore.DestroyKey(r2i);
+}
+
+#if !CHIP_CRYPTO_PSA
+void TestSessionKeysReleasedWithHandle(nlTestSuite * inSuite, void * inContext)
+{
+    TestSessionKeystoreImpl keystore;
+    const DeriveSessionKeysTestVector & test = deriveSessionKeysTestVectors[0];
+
+    // Session keys that are not passed to DestroyKey() release their cipher contexts when the handles are destroyed, or
+    // leak checkers would report them.
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        Aes128KeyHandle i2r;
+        Aes128KeyHandle r2i;
+        AttestationChallenge challenge;
+        NL_TEST_ASSERT_SUCCESS(
+            inSuite, keystore.DeriveSessionKeys(ToSpan(test.secret), ToSpan(test.salt), ToSpan(test.info), i2r, r2i, challenge));
+
+        uint8_t nonce[kAES_CCM128_Nonce_Length] = { i };
+        uint8_t plaintext[16]                   = { i };
+        uint8_t ciphertext[sizeof(plaintext)];
+        uint8_t tag[kAES_CCM128_Tag_Length];
+        NL_TEST_ASSERT_SUCCESS(inSuite,
+                               AES_CCM_encrypt(plaintext, sizeof(plaintext), nullptr, 0, i2r, nonce, sizeof(nonce), ciphertext,
+                                               tag, sizeof(tag)));
+        NL_TEST_ASSERT_SUCCESS(inSuite,
+                               AES_CCM_encrypt(plaintext, sizeof(plaintext), nullptr, 0, r2i, nonce, sizeof(nonce), ciphertext,
+                                               tag, sizeof(tag)));
+
+        // Releasing the context explicitly leaves nothing for the destructor to release.
+        if (i == 1)
+        {
+            AES_CCM_ReleaseKeyContext(i2r);
+            NL_TEST_ASSERT(inSuite, i2r.As<RawAes128Key>().mCipherContext == nullptr);
+        }
+    }
+}
+#endif // !CHIP_CRYPTO_PSA
+
 const nlTest sTests[] = { NL_TEST_DEF("Test basic import", TestBasicImport), NL_TEST_DEF("Test derive key", TestDeriveKey),
-                          NL_TEST_DEF("Test derive session keys", TestDeriveSessionKeys), NL_TEST_SENTINEL() };
+                          NL_TEST_DEF("Test derive session keys", TestDeriveSessionKeys),
+                          NL_TEST_DEF("Test session keys round trip", TestSessionKeysRoundTrip),
+#if !CHIP_CRYPTO_PSA
+                          NL_TEST_DEF("Test session keys released with handle", TestSessionKeysReleasedWithHandle),
+#endif
+                          NL_TEST_SENTINEL() };
 
 int Test_Setup(void * inContext)
 {
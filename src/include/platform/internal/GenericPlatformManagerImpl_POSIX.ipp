@@ -167,9 +167,13 @@ CHIP_ERROR GenericPlatformManagerImpl_POSIX<ImplClass>::_PostEvent(const ChipDev
     SystemLayer().ScheduleWork(&_DispatchEventViaScheduleWork, eventCopyP);
     return CHIP_NO_ERROR;
 #else
-    mChipEventQueue.Push(*event);
+    ReturnErrorOnFailure(mChipEventQueue.Push(*event));
 
-    SystemLayerSocketsLoop().Signal(); // Trigger wake select on CHIP thread
+    // Only the first event posted since the CHIP thread last drained the queue needs to wake it.
+    if (mChipEventQueue.RequestWakeup())
+    {
+        SystemLayerSocketsLoop().Signal(); // Trigger wake select on CHIP thread
+    }
     return CHIP_NO_ERROR;
 #endif // CHIP_SYSTEM_CONFIG_USE_LIBEV
 }
@@ -179,9 +183,11 @@ CHIP_ERROR GenericPlatformManagerImpl_POSIX<ImplClass>::_PostEvent(const ChipDev
 template <class ImplClass>
 void GenericPlatformManagerImpl_POSIX<ImplClass>::ProcessDeviceEvents()
 {
-    while (!mChipEventQueue.Empty())
+    mChipEventQueue.AcknowledgeWakeup();
+
+    ChipDeviceEvent event;
+    while (mChipEventQueue.Pop(event))
     {
-        const ChipDeviceEvent event = mChipEventQueue.PopFront();
         Impl()->DispatchEvent(&event);
     }
 }
@@ -272,6 +272,46 @@
 #endif
 #endif // INET_CONFIG_UDP_SOCKET_PKTINFO
 
+/**
+ *  @def INET_CONFIG_UDP_SOCKET_MMSG
+ *
+ *  @brief
+ *    Use recvmmsg() and sendmmsg() in the socket-based implementation of UDP
+ *    endpoints, to receive or send a batch of UDP packets with a single system
+ *    call.
+ *
+ *  @details
+ *    When this flag is set, a UDP endpoint reads up to
+ *    INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE pending packets each time its
+ *    socket becomes readable, and UDPEndPoint::SendMsgs() hands its messages
+ *    to the system in batches of that size. Otherwise, packets are received
+ *    one per socket event and sent one per system call.
+ */
+#ifndef INET_CONFIG_UDP_SOCKET_MMSG
+#if defined(__linux__)
+#define INET_CONFIG_UDP_SOCKET_MMSG 1
+#else
+#define INET_CONFIG_UDP_SOCKET_MMSG 0
+#endif
+#endif // INET_CONFIG_UDP_SOCKET_MMSG
+
+/**
+ *  @def INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE
+ *
+ *  @brief
+ *    The largest number of UDP packets received or sent with one system call
+ *    when INET_CONFIG_UDP_SOCKET_MMSG is set.
+ *
+ *  @details
+ *    A receive batch holds one packet buffer per packet for the duration of
+ *    the system call. The endpoint sizes its batches after the number of
+ *    packets it received the previous time, so that an idle endpoint does not
+ *    take this many buffers from the pool on every read.
+ */
+#ifndef INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE
+#define INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE 8
+#endif // INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE
+
 /**
  *  @def HAVE_SO_BINDTODEVICE
  *
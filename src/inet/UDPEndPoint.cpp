@@ -121,6 +121,50 @@ CHIP_ERROR UDPEndPoint::SendMsg(const IPPacketInfo * pktInfo, System::PacketBuff
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR UDPEndPoint::SendMsgs(const IPPacketInfo * pktInfos, System::PacketBufferHandle * msgs, size_t count, size_t & sentCount)
+{
+    sentCount = 0;
+
+    INET_FAULT_INJECT(FaultInjection::kFault_Send, ReleaseMsgs(msgs, count); return INET_ERROR_UNKNOWN_INTERFACE;);
+    INET_FAULT_INJECT(FaultInjection::kFault_SendNonCritical, ReleaseMsgs(msgs, count); return CHIP_ERROR_NO_MEMORY;);
+
+    ReturnErrorOnFailure(SendMsgsImpl(pktInfos, msgs, count, sentCount));
+
+    CHIP_SYSTEM_FAULT_INJECT_ASYNC_EVENT();
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR UDPEndPoint::SendMsgsImpl(const IPPacketInfo * pktInfos, System::PacketBufferHandle * msgs, size_t count,
+                                     size_t & sentCount)
+{
+    CHIP_ERROR firstError = CHIP_NO_ERROR;
+
+    sentCount = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        CHIP_ERROR err = SendMsgImpl(&pktInfos[i], std::move(msgs[i]));
+        if (err == CHIP_NO_ERROR)
+        {
+            sentCount++;
+        }
+        else if (firstError == CHIP_NO_ERROR)
+        {
+            firstError = err;
+        }
+    }
+
+    return firstError;
+}
+
+void UDPEndPoint::ReleaseMsgs(System::PacketBufferHandle * msgs, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        msgs[i] = nullptr;
+    }
+}
+
 void UDPEndPoint::Close()
 {
     if (mState != State::kClosed)
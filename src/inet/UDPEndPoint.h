@@ -227,6 +227,25 @@ public:
      */
     CHIP_ERROR SendMsg(const IPPacketInfo * pktInfo, chip::System::PacketBufferHandle && msg);
 
+    /**
+     * Send a batch of UDP messages.
+     *
+     *  Send each message of \c msgs as SendMsg() would, to the destination given by the entry of \c pktInfos with the same
+     *  index. A message that cannot be sent does not prevent the others from being sent. Where the platform supports it,
+     *  the messages are handed to the system with one call per batch rather than one call per message.
+     *
+     *  The buffers of all the messages are released.
+     *
+     * @param[in]   pktInfos    Source and destination information for each of the UDP messages.
+     * @param[in]   msgs        Packet buffers containing the UDP messages.
+     * @param[in]   count       Number of messages in \c pktInfos and \c msgs.
+     * @param[out]  sentCount   Number of messages queued for transmit.
+     *
+     * @retval  CHIP_NO_ERROR   Success: all the messages are queued for transmit.
+     * @retval  other           The error SendMsg() would have returned for the first message that could not be sent.
+     */
+    CHIP_ERROR SendMsgs(const IPPacketInfo * pktInfos, chip::System::PacketBufferHandle * msgs, size_t count, size_t & sentCount);
+
     /**
      * Close the endpoint.
      *
@@ -296,6 +315,12 @@ protected:
     virtual CHIP_ERROR ListenImpl()                                                                                           = 0;
     virtual CHIP_ERROR SendMsgImpl(const IPPacketInfo * pktInfo, chip::System::PacketBufferHandle && msg)                     = 0;
     virtual void CloseImpl()                                                                                                  = 0;
+
+    // Sends the messages one at a time through SendMsgImpl(); implementations that can send a batch at once override it.
+    virtual CHIP_ERROR SendMsgsImpl(const IPPacketInfo * pktInfos, chip::System::PacketBufferHandle * msgs, size_t count,
+                                    size_t & sentCount);
+
+    static void ReleaseMsgs(chip::System::PacketBufferHandle * msgs, size_t count);
 };
 
 template <>
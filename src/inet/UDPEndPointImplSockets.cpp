@@ -43,6 +43,7 @@
 #include <zephyr/net/socket.h>
 #endif // CHIP_SYSTEM_CONFIG_USE_ZEPHYR_SOCKETS
 
+#include <algorithm>
 #include <cerrno>
 #include <unistd.h>
 #include <utility>
@@ -278,7 +279,8 @@ CHIP_ERROR UDPEndPointImplSockets::ListenImpl()
     return layer->RequestCallbackOnPendingRead(mWatch);
 }
 
-CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, System::PacketBufferHandle && msg)
+CHIP_ERROR UDPEndPointImplSockets::InitSendMsgHeader(const IPPacketInfo * aPktInfo, const System::PacketBufferHandle & msg,
+                                                     struct msghdr & msgHeader, MsgHeaderStorage & storage)
 {
     // Ensure packet buffer is not null
     VerifyOrReturnError(!msg.IsNull(), CHIP_ERROR_INVALID_ARGUMENT);
@@ -293,22 +295,19 @@ CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, Sy
     // For now the entire message must fit within a single buffer.
     VerifyOrReturnError(!msg->HasChainedBuffer(), CHIP_ERROR_MESSAGE_TOO_LONG);
 
-    struct iovec msgIOV;
-    msgIOV.iov_base = msg->Start();
-    msgIOV.iov_len  = msg->DataLength();
+    storage.iov.iov_base = msg->Start();
+    storage.iov.iov_len  = msg->DataLength();
 
 #if defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
-    uint8_t controlData[256];
-    memset(controlData, 0, sizeof(controlData));
+    memset(storage.controlData, 0, sizeof(storage.controlData));
 #endif // defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
 
-    struct msghdr msgHeader;
     memset(&msgHeader, 0, sizeof(msgHeader));
-    msgHeader.msg_iov    = &msgIOV;
+    msgHeader.msg_iov    = &storage.iov;
     msgHeader.msg_iovlen = 1;
 
     // Construct a sockaddr_in/sockaddr_in6 structure containing the destination information.
-    SockAddr peerSockAddr;
+    SockAddr & peerSockAddr = storage.peerSockAddr;
     memset(&peerSockAddr, 0, sizeof(peerSockAddr));
     msgHeader.msg_name = &peerSockAddr;
     if (mAddrType == IPAddressType::kIPv6)
@@ -330,7 +329,6 @@ CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, Sy
         msgHeader.msg_namelen      = sizeof(sockaddr_in);
     }
 #endif // INET_CONFIG_ENABLE_IPV4
-
     // If the endpoint has been bound to a particular interface,
     // and the caller didn't supply a specific interface to send
     // on, use the bound interface. This appears to be necessary
@@ -351,8 +349,8 @@ CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, Sy
     if (intf.IsPresent() || aPktInfo->SrcAddress.Type() != IPAddressType::kAny)
     {
 #if defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
-        msgHeader.msg_control    = controlData;
-        msgHeader.msg_controllen = sizeof(controlData);
+        msgHeader.msg_control    = storage.controlData;
+        msgHeader.msg_controllen = sizeof(storage.controlData);
 
         struct cmsghdr * controlHdr      = CMSG_FIRSTHDR(&msgHeader);
         InterfaceId::PlatformType intfId = intf.GetPlatformInterface();
@@ -410,6 +408,15 @@ CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, Sy
     }
 #endif // INET_CONFIG_UDP_SOCKET_PKTINFO
 
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, System::PacketBufferHandle && msg)
+{
+    struct msghdr msgHeader;
+    MsgHeaderStorage storage;
+    ReturnErrorOnFailure(InitSendMsgHeader(aPktInfo, msg, msgHeader, storage));
+
     // Send IP packet.
     const ssize_t lenSent = sendmsg(mSocket, &msgHeader, 0);
     if (lenSent == -1)
@@ -423,6 +430,73 @@ CHIP_ERROR UDPEndPointImplSockets::SendMsgImpl(const IPPacketInfo * aPktInfo, Sy
     return CHIP_NO_ERROR;
 }
 
+#if INET_CONFIG_UDP_SOCKET_MMSG
+CHIP_ERROR UDPEndPointImplSockets::SendMsgsImpl(const IPPacketInfo * aPktInfos, System::PacketBufferHandle * msgs, size_t count,
+                                                size_t & sentCount)
+{
+    constexpr unsigned int kBatchSize = INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE;
+
+    CHIP_ERROR firstError = CHIP_NO_ERROR;
+    auto dropMsg          = [&](size_t msgIndex, CHIP_ERROR err) {
+        if (firstError == CHIP_NO_ERROR)
+        {
+            firstError = err;
+        }
+        msgs[msgIndex] = nullptr;
+    };
+
+    sentCount      = 0;
+    size_t nextMsg = 0;
+    while (nextMsg < count)
+    {
+        struct mmsghdr msgHeaders[kBatchSize];
+        MsgHeaderStorage storage[kBatchSize];
+        size_t msgIndexes[kBatchSize];
+        unsigned int batchCount = 0;
+
+        for (; nextMsg < count && batchCount < kBatchSize; nextMsg++)
+        {
+            memset(&msgHeaders[batchCount], 0, sizeof(msgHeaders[batchCount]));
+            CHIP_ERROR err =
+                InitSendMsgHeader(&aPktInfos[nextMsg], msgs[nextMsg], msgHeaders[batchCount].msg_hdr, storage[batchCount]);
+            if (err != CHIP_NO_ERROR)
+            {
+                dropMsg(nextMsg, err);
+                continue;
+            }
+            msgIndexes[batchCount++] = nextMsg;
+        }
+
+        // sendmmsg() stops at the first message it fails to send, and only reports the error if that message is the
+        // first one of the call: call it again for the rest of the batch, skipping the messages that fail.
+        unsigned int batchSent = 0;
+        while (batchSent < batchCount)
+        {
+            const int result = sendmmsg(mSocket, &msgHeaders[batchSent], batchCount - batchSent, 0);
+            if (result < 0)
+            {
+                dropMsg(msgIndexes[batchSent++], CHIP_ERROR_POSIX(errno));
+                continue;
+            }
+
+            for (int i = 0; i < result; i++, batchSent++)
+            {
+                const size_t msgIndex = msgIndexes[batchSent];
+                if (msgHeaders[batchSent].msg_len != msgs[msgIndex]->DataLength())
+                {
+                    dropMsg(msgIndex, CHIP_ERROR_OUTBOUND_MESSAGE_TOO_BIG);
+                    continue;
+                }
+                msgs[msgIndex] = nullptr;
+                sentCount++;
+            }
+        }
+    }
+
+    return firstError;
+}
+#endif // INET_CONFIG_UDP_SOCKET_MMSG
+
 void UDPEndPointImplSockets::CloseImpl()
 {
     if (mSocket != kInvalidSocketFd)
@@ -575,124 +649,207 @@ void UDPEndPointImplSockets::HandlePendingIO(System::SocketEvents events)
         return;
     }
 
+#if INET_CONFIG_UDP_SOCKET_MMSG
+    ReceiveMsgs();
+#else  // !INET_CONFIG_UDP_SOCKET_MMSG
+    ReceiveMsg();
+#endif // !INET_CONFIG_UDP_SOCKET_MMSG
+}
+
+void UDPEndPointImplSockets::ReceiveMsg()
+{
     CHIP_ERROR lStatus = CHIP_NO_ERROR;
     IPPacketInfo lPacketInfo;
     System::PacketBufferHandle lBuffer;
 
-    lPacketInfo.Clear();
-    lPacketInfo.DestPort  = mBoundPort;
-    lPacketInfo.Interface = mBoundIntfId;
-
     lBuffer = System::PacketBufferHandle::New(System::PacketBuffer::kMaxSizeWithoutReserve, 0);
 
     if (!lBuffer.IsNull())
     {
-        struct iovec msgIOV;
-        SockAddr lPeerSockAddr;
-        uint8_t controlData[256];
         struct msghdr msgHeader;
+        MsgHeaderStorage storage;
+        InitReceiveMsgHeader(lBuffer, msgHeader, storage);
 
-        msgIOV.iov_base = lBuffer->Start();
-        msgIOV.iov_len  = lBuffer->AvailableDataLength();
+        ssize_t rcvLen = recvmsg(mSocket, &msgHeader, MSG_DONTWAIT);
 
-        memset(&lPeerSockAddr, 0, sizeof(lPeerSockAddr));
+        if (rcvLen < 0)
+        {
+            lStatus = CHIP_ERROR_POSIX(errno);
+        }
+        else
+        {
+            lStatus = GetReceivedMsg(msgHeader, static_cast<size_t>(rcvLen), lBuffer, lPacketInfo);
+        }
+    }
+    else
+    {
+        lStatus = CHIP_ERROR_NO_MEMORY;
+    }
+
+    if (lStatus == CHIP_NO_ERROR)
+    {
+        lBuffer.RightSize();
+        OnMessageReceived(this, std::move(lBuffer), &lPacketInfo);
+    }
+    else
+    {
+        HandleReceiveError(lStatus);
+    }
+}
 
-        memset(&msgHeader, 0, sizeof(msgHeader));
+#if INET_CONFIG_UDP_SOCKET_MMSG
+void UDPEndPointImplSockets::ReceiveMsgs()
+{
+    constexpr unsigned int kBatchSize = INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE;
 
-        msgHeader.msg_name       = &lPeerSockAddr;
-        msgHeader.msg_namelen    = sizeof(lPeerSockAddr);
-        msgHeader.msg_iov        = &msgIOV;
-        msgHeader.msg_iovlen     = 1;
-        msgHeader.msg_control    = controlData;
-        msgHeader.msg_controllen = sizeof(controlData);
+    // Take up to twice as many buffers as there were packets the last time: the batch grows quickly under load, while an
+    // endpoint receiving the odd packet does not take a full batch of buffers from the pool for each of them.
+    const unsigned int batchSize = std::min(kBatchSize, 2 * mLastReceiveCount);
 
-        ssize_t rcvLen = recvmsg(mSocket, &msgHeader, MSG_DONTWAIT);
+    System::PacketBufferHandle buffers[kBatchSize];
+    struct mmsghdr msgHeaders[kBatchSize];
+    MsgHeaderStorage storage[kBatchSize];
+    unsigned int bufferCount = 0;
 
-        if (rcvLen < 0)
+    for (; bufferCount < batchSize; bufferCount++)
+    {
+        buffers[bufferCount] = System::PacketBufferHandle::New(System::PacketBuffer::kMaxSizeWithoutReserve, 0);
+        if (buffers[bufferCount].IsNull())
         {
-            lStatus = CHIP_ERROR_POSIX(errno);
+            break;
+        }
+        memset(&msgHeaders[bufferCount], 0, sizeof(msgHeaders[bufferCount]));
+        InitReceiveMsgHeader(buffers[bufferCount], msgHeaders[bufferCount].msg_hdr, storage[bufferCount]);
+    }
+
+    if (bufferCount == 0)
+    {
+        HandleReceiveError(CHIP_ERROR_NO_MEMORY);
+        return;
+    }
+
+    const int rcvCount = recvmmsg(mSocket, msgHeaders, bufferCount, MSG_DONTWAIT, nullptr);
+    if (rcvCount < 0)
+    {
+        HandleReceiveError(CHIP_ERROR_POSIX(errno));
+        return;
+    }
+    mLastReceiveCount = std::max(static_cast<unsigned int>(rcvCount), 1u);
+
+    // Return the buffers that were not filled before handing the packets up.
+    for (unsigned int i = static_cast<unsigned int>(rcvCount); i < bufferCount; i++)
+    {
+        buffers[i] = nullptr;
+    }
+
+    // The callbacks may close or free the endpoint: keep it around until all the packets are handled, and drop the
+    // packets left once it is no longer listening.
+    Retain();
+    for (unsigned int i = 0; i < static_cast<unsigned int>(rcvCount); i++)
+    {
+        if (mState != State::kListening || OnMessageReceived == nullptr)
+        {
+            break;
         }
-        else if (rcvLen > lBuffer->AvailableDataLength())
+
+        IPPacketInfo lPacketInfo;
+        CHIP_ERROR lStatus = GetReceivedMsg(msgHeaders[i].msg_hdr, msgHeaders[i].msg_len, buffers[i], lPacketInfo);
+        if (lStatus == CHIP_NO_ERROR)
         {
-            lStatus = CHIP_ERROR_INBOUND_MESSAGE_TOO_BIG;
+            buffers[i].RightSize();
+            OnMessageReceived(this, std::move(buffers[i]), &lPacketInfo);
         }
         else
         {
-            lBuffer->SetDataLength(static_cast<uint16_t>(rcvLen));
+            HandleReceiveError(lStatus);
+        }
+    }
+    Release();
+}
+#endif // INET_CONFIG_UDP_SOCKET_MMSG
 
-            if (lPeerSockAddr.any.sa_family == AF_INET6)
-            {
-                lPacketInfo.SrcAddress = IPAddress(lPeerSockAddr.in6.sin6_addr);
-                lPacketInfo.SrcPort    = ntohs(lPeerSockAddr.in6.sin6_port);
-            }
+void UDPEndPointImplSockets::InitReceiveMsgHeader(System::PacketBufferHandle & buffer, struct msghdr & msgHeader,
+                                                  MsgHeaderStorage & storage)
+{
+    storage.iov.iov_base = buffer->Start();
+    storage.iov.iov_len  = buffer->AvailableDataLength();
+
+    memset(&storage.peerSockAddr, 0, sizeof(storage.peerSockAddr));
+
+    memset(&msgHeader, 0, sizeof(msgHeader));
+
+    msgHeader.msg_name       = &storage.peerSockAddr;
+    msgHeader.msg_namelen    = sizeof(storage.peerSockAddr);
+    msgHeader.msg_iov        = &storage.iov;
+    msgHeader.msg_iovlen     = 1;
+    msgHeader.msg_control    = storage.controlData;
+    msgHeader.msg_controllen = sizeof(storage.controlData);
+}
+
+CHIP_ERROR UDPEndPointImplSockets::GetReceivedMsg(struct msghdr & msgHeader, size_t rcvLen, System::PacketBufferHandle & buffer,
+                                                  IPPacketInfo & packetInfo) const
+{
+    VerifyOrReturnError(rcvLen <= buffer->AvailableDataLength(), CHIP_ERROR_INBOUND_MESSAGE_TOO_BIG);
+    buffer->SetDataLength(static_cast<uint16_t>(rcvLen));
+
+    packetInfo.Clear();
+    packetInfo.DestPort  = mBoundPort;
+    packetInfo.Interface = mBoundIntfId;
+
+    const SockAddr & peerSockAddr = *static_cast<const SockAddr *>(msgHeader.msg_name);
+    if (peerSockAddr.any.sa_family == AF_INET6)
+    {
+        packetInfo.SrcAddress = IPAddress(peerSockAddr.in6.sin6_addr);
+        packetInfo.SrcPort    = ntohs(peerSockAddr.in6.sin6_port);
+    }
 #if INET_CONFIG_ENABLE_IPV4
-            else if (lPeerSockAddr.any.sa_family == AF_INET)
-            {
-                lPacketInfo.SrcAddress = IPAddress(lPeerSockAddr.in.sin_addr);
-                lPacketInfo.SrcPort    = ntohs(lPeerSockAddr.in.sin_port);
-            }
+    else if (peerSockAddr.any.sa_family == AF_INET)
+    {
+        packetInfo.SrcAddress = IPAddress(peerSockAddr.in.sin_addr);
+        packetInfo.SrcPort    = ntohs(peerSockAddr.in.sin_port);
+    }
 #endif // INET_CONFIG_ENABLE_IPV4
-            else
-            {
-                lStatus = CHIP_ERROR_INCORRECT_STATE;
-            }
-        }
+    else
+    {
+        return CHIP_ERROR_INCORRECT_STATE;
+    }
 
-        if (lStatus == CHIP_NO_ERROR)
-        {
-            for (struct cmsghdr * controlHdr = CMSG_FIRSTHDR(&msgHeader); controlHdr != nullptr;
-                 controlHdr                  = CMSG_NXTHDR(&msgHeader, controlHdr))
-            {
+    for (struct cmsghdr * controlHdr = CMSG_FIRSTHDR(&msgHeader); controlHdr != nullptr;
+         controlHdr                  = CMSG_NXTHDR(&msgHeader, controlHdr))
+    {
 #if INET_CONFIG_ENABLE_IPV4
 #ifdef IP_PKTINFO
-                if (controlHdr->cmsg_level == IPPROTO_IP && controlHdr->cmsg_type == IP_PKTINFO)
-                {
-                    auto * inPktInfo = reinterpret_cast<struct in_pktinfo *> CMSG_DATA(controlHdr);
-                    if (!CanCastTo<InterfaceId::PlatformType>(inPktInfo->ipi_ifindex))
-                    {
-                        lStatus = CHIP_ERROR_INCORRECT_STATE;
-                        break;
-                    }
-                    lPacketInfo.Interface   = InterfaceId(static_cast<InterfaceId::PlatformType>(inPktInfo->ipi_ifindex));
-                    lPacketInfo.DestAddress = IPAddress(inPktInfo->ipi_addr);
-                    continue;
-                }
+        if (controlHdr->cmsg_level == IPPROTO_IP && controlHdr->cmsg_type == IP_PKTINFO)
+        {
+            auto * inPktInfo = reinterpret_cast<struct in_pktinfo *> CMSG_DATA(controlHdr);
+            VerifyOrReturnError(CanCastTo<InterfaceId::PlatformType>(inPktInfo->ipi_ifindex), CHIP_ERROR_INCORRECT_STATE);
+            packetInfo.Interface   = InterfaceId(static_cast<InterfaceId::PlatformType>(inPktInfo->ipi_ifindex));
+            packetInfo.DestAddress = IPAddress(inPktInfo->ipi_addr);
+            continue;
+        }
 #endif // defined(IP_PKTINFO)
 #endif // INET_CONFIG_ENABLE_IPV4
 
 #ifdef IPV6_PKTINFO
-                if (controlHdr->cmsg_level == IPPROTO_IPV6 && controlHdr->cmsg_type == IPV6_PKTINFO)
-                {
-                    auto * in6PktInfo = reinterpret_cast<struct in6_pktinfo *> CMSG_DATA(controlHdr);
-                    if (!CanCastTo<InterfaceId::PlatformType>(in6PktInfo->ipi6_ifindex))
-                    {
-                        lStatus = CHIP_ERROR_INCORRECT_STATE;
-                        break;
-                    }
-                    lPacketInfo.Interface   = InterfaceId(static_cast<InterfaceId::PlatformType>(in6PktInfo->ipi6_ifindex));
-                    lPacketInfo.DestAddress = IPAddress(in6PktInfo->ipi6_addr);
-                    continue;
-                }
-#endif // defined(IPV6_PKTINFO)
-            }
+        if (controlHdr->cmsg_level == IPPROTO_IPV6 && controlHdr->cmsg_type == IPV6_PKTINFO)
+        {
+            auto * in6PktInfo = reinterpret_cast<struct in6_pktinfo *> CMSG_DATA(controlHdr);
+            VerifyOrReturnError(CanCastTo<InterfaceId::PlatformType>(in6PktInfo->ipi6_ifindex), CHIP_ERROR_INCORRECT_STATE);
+            packetInfo.Interface   = InterfaceId(static_cast<InterfaceId::PlatformType>(in6PktInfo->ipi6_ifindex));
+            packetInfo.DestAddress = IPAddress(in6PktInfo->ipi6_addr);
+            continue;
         }
-    }
-    else
-    {
-        lStatus = CHIP_ERROR_NO_MEMORY;
+#endif // defined(IPV6_PKTINFO)
     }
 
-    if (lStatus == CHIP_NO_ERROR)
-    {
-        lBuffer.RightSize();
-        OnMessageReceived(this, std::move(lBuffer), &lPacketInfo);
-    }
-    else
+    return CHIP_NO_ERROR;
+}
+
+void UDPEndPointImplSockets::HandleReceiveError(CHIP_ERROR status)
+{
+    if (OnReceiveError != nullptr && status != CHIP_ERROR_POSIX(EAGAIN))
     {
-        if (OnReceiveError != nullptr && lStatus != CHIP_ERROR_POSIX(EAGAIN))
-        {
-            OnReceiveError(this, lStatus, nullptr);
-        }
+        OnReceiveError(this, status, nullptr);
     }
 }
 
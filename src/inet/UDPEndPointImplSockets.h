@@ -52,14 +52,41 @@ private:
     CHIP_ERROR BindInterfaceImpl(IPAddressType addressType, InterfaceId interfaceId) override;
     CHIP_ERROR ListenImpl() override;
     CHIP_ERROR SendMsgImpl(const IPPacketInfo * pktInfo, chip::System::PacketBufferHandle && msg) override;
+#if INET_CONFIG_UDP_SOCKET_MMSG
+    CHIP_ERROR SendMsgsImpl(const IPPacketInfo * pktInfos, chip::System::PacketBufferHandle * msgs, size_t count,
+                            size_t & sentCount) override;
+#endif // INET_CONFIG_UDP_SOCKET_MMSG
     void CloseImpl() override;
 
+    // What the msghdr of a message being sent or received points to.
+    struct MsgHeaderStorage
+    {
+        struct iovec iov;
+        SockAddr peerSockAddr;
+        uint8_t controlData[256];
+    };
+
     CHIP_ERROR GetSocket(IPAddressType addressType);
+    CHIP_ERROR InitSendMsgHeader(const IPPacketInfo * pktInfo, const chip::System::PacketBufferHandle & msg,
+                                 struct msghdr & msgHeader, MsgHeaderStorage & storage);
     void HandlePendingIO(System::SocketEvents events);
     static void HandlePendingIO(System::SocketEvents events, intptr_t data);
+    void ReceiveMsg();
+#if INET_CONFIG_UDP_SOCKET_MMSG
+    void ReceiveMsgs();
+#endif // INET_CONFIG_UDP_SOCKET_MMSG
+    static void InitReceiveMsgHeader(chip::System::PacketBufferHandle & buffer, struct msghdr & msgHeader,
+                                     MsgHeaderStorage & storage);
+    CHIP_ERROR GetReceivedMsg(struct msghdr & msgHeader, size_t rcvLen, chip::System::PacketBufferHandle & buffer,
+                              IPPacketInfo & packetInfo) const;
+    void HandleReceiveError(CHIP_ERROR status);
 
     InterfaceId mBoundIntfId;
     uint16_t mBoundPort;
+#if INET_CONFIG_UDP_SOCKET_MMSG
+    // Number of packets read the last time the socket was readable, which sizes the next receive batch.
+    unsigned int mLastReceiveCount = 1;
+#endif // INET_CONFIG_UDP_SOCKET_MMSG
 
 #if CHIP_SYSTEM_CONFIG_USE_PLATFORM_MULTICAST_API
 public:
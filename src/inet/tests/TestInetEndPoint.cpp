@@ -361,6 +361,75 @@ static void TestInetEndPointInternal(nlTestSuite * inSuite, void * inContext)
     NL_TEST_ASSERT(inSuite, SYSTEM_STATS_TEST_HIGH_WATER_MARK(System::Stats::kInetLayer_NumTCPEps, 1));
 }
 
+#if INET_CONFIG_ENABLE_UDP_ENDPOINT
+static size_t sBatchReceivedCount  = 0;
+static uint32_t sBatchReceivedMask = 0;
+
+static void HandleBatchMessageReceived(UDPEndPoint * endPoint, PacketBufferHandle && buffer, const IPPacketInfo * pktInfo)
+{
+    sBatchReceivedCount++;
+    if (buffer->DataLength() == 1 && buffer->Start()[0] < 32)
+    {
+        sBatchReceivedMask |= (1u << buffer->Start()[0]);
+    }
+}
+
+// Test that a batch sent with SendMsgs arrives whole, over more than one send and receive batch.
+static void TestInetUDPBatch(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr size_t kMessageCount = 10;
+    const IPAddress loopback       = IPAddress::Loopback(IPAddressType::kIPv6);
+
+    UDPEndPoint * testUDPEP = nullptr;
+    CHIP_ERROR err          = gUDP.NewEndPoint(&testUDPEP);
+    NL_TEST_EXIT_ON_FAILED_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    err = testUDPEP->Bind(IPAddressType::kIPv6, loopback, 0);
+    if (err != CHIP_NO_ERROR)
+    {
+        // No IPv6 loopback interface to test over.
+        testUDPEP->Free();
+        return;
+    }
+    err = testUDPEP->Listen(HandleBatchMessageReceived, nullptr /*OnReceiveError*/);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    IPPacketInfo pktInfos[kMessageCount];
+    PacketBufferHandle msgs[kMessageCount];
+    for (size_t i = 0; i < kMessageCount; i++)
+    {
+        pktInfos[i].Clear();
+        pktInfos[i].DestAddress = loopback;
+        pktInfos[i].DestPort    = testUDPEP->GetBoundPort();
+
+        const uint8_t payload = static_cast<uint8_t>(i);
+        msgs[i]               = PacketBufferHandle::NewWithData(&payload, sizeof(payload));
+        NL_TEST_EXIT_ON_FAILED_ASSERT(inSuite, !msgs[i].IsNull());
+    }
+
+    sBatchReceivedCount = 0;
+    sBatchReceivedMask  = 0;
+
+    size_t sentCount = 0;
+    err              = testUDPEP->SendMsgs(pktInfos, msgs, kMessageCount, sentCount);
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sentCount == kMessageCount);
+    for (size_t i = 0; i < kMessageCount; i++)
+    {
+        NL_TEST_ASSERT(inSuite, msgs[i].IsNull());
+    }
+
+    for (int i = 0; i < 100 && sBatchReceivedCount < kMessageCount; i++)
+    {
+        ServiceEvents(10);
+    }
+    NL_TEST_ASSERT(inSuite, sBatchReceivedCount == kMessageCount);
+    NL_TEST_ASSERT(inSuite, sBatchReceivedMask == (1u << kMessageCount) - 1);
+
+    testUDPEP->Free();
+}
+#endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
+
 #if !CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
 // Test the Inet resource limitations.
 static void TestInetEndPointLimit(nlTestSuite * inSuite, void * inContext)
@@ -452,6 +521,9 @@ static const nlTest sTests[] = { NL_TEST_DEF("InetEndPoint::PreTest", TestInetPr
                                  NL_TEST_DEF("InetEndPoint::TestInetError", TestInetError),
                                  NL_TEST_DEF("InetEndPoint::TestInetInterface", TestInetInterface),
                                  NL_TEST_DEF("InetEndPoint::TestInetEndPoint", TestInetEndPointInternal),
+#if INET_CONFIG_ENABLE_UDP_ENDPOINT
+                                 NL_TEST_DEF("InetEndPoint::TestInetUDPBatch", TestInetUDPBatch),
+#endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
 #if !CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
                                  NL_TEST_DEF("InetEndPoint::TestEndPointLimit", TestInetEndPointLimit),
 #endif
@@ -27,6 +27,38 @@ namespace {
 
 static constexpr System::Clock::Timeout kInvalidTimeout{ System::Clock::Timeout::max() };
 
+static constexpr System::Clock::Seconds32 kDefaultAddressTtl{ CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_DEFAULT_TTL };
+
+/// Calls `callback` with the ResolveResult of every usable IP address of a resolved node.
+template <typename Callback>
+void ForEachResolveResult(const Dnssd::ResolvedNodeData & nodeData, Callback && callback)
+{
+    ResolveResult result;
+
+    result.address.SetPort(nodeData.resolutionData.port);
+    result.address.SetInterface(nodeData.resolutionData.interfaceId);
+    result.mrpRemoteConfig = nodeData.resolutionData.GetRemoteMRPConfig();
+    result.supportsTcp     = nodeData.resolutionData.supportsTcp;
+
+    if (nodeData.resolutionData.isICDOperatingAsLIT.HasValue())
+    {
+        result.isICDOperatingAsLIT = nodeData.resolutionData.isICDOperatingAsLIT.Value();
+    }
+
+    for (size_t i = 0; i < nodeData.resolutionData.numIPs; i++)
+    {
+#if !INET_CONFIG_ENABLE_IPV4
+        if (!nodeData.resolutionData.ipAddress[i].IsIPv6())
+        {
+            ChipLogError(Discovery, "Skipping IPv4 address during operational resolve.");
+            continue;
+        }
+#endif
+        result.address.SetIPAddress(nodeData.resolutionData.ipAddress[i]);
+        callback(result);
+    }
+}
+
 } // namespace
 
 void NodeLookupHandle::ResetForLookup(System::Clock::Timestamp now, const NodeLookupRequest & request)
@@ -34,6 +66,17 @@ void NodeLookupHandle::ResetForLookup(System::Clock::Timestamp now, const NodeLo
     mRequestStartTime = now;
     mRequest          = request;
     mResults          = NodeLookupResults();
+    mFromCache        = false;
+}
+
+void NodeLookupHandle::UseCachedResult(const ResolveResult & result)
+{
+    auto score = Dnssd::IPAddressSorter::ScoreIpAddress(result.address.GetIPAddress(), result.address.GetInterface());
+
+    mResults = NodeLookupResults();
+    mResults.UpdateResults(result, score);
+    mCachedAddress = result.address;
+    mFromCache     = true;
 }
 
 void NodeLookupHandle::LookupResult(const ResolveResult & result)
@@ -62,7 +105,8 @@ System::Clock::Timeout NodeLookupHandle::NextEventTimeout(System::Clock::Timesta
 {
     const System::Clock::Timestamp elapsed = now - mRequestStartTime;
 
-    if (elapsed < mRequest.GetMinLookupTime())
+    // A cached address completes the lookup without waiting for the minimal lookup time.
+    if (!mFromCache && elapsed < mRequest.GetMinLookupTime())
     {
         return mRequest.GetMinLookupTime() - elapsed;
     }
@@ -99,8 +143,9 @@ NodeLookupAction NodeLookupHandle::NextAction(System::Clock::Timestamp now)
 
     ChipLogProgress(Discovery, "Checking node lookup status after %lu ms", static_cast<unsigned long>(elapsed.count()));
 
-    // We are still within the minimal search time. Wait for more results.
-    if (elapsed < mRequest.GetMinLookupTime())
+    // We are still within the minimal search time. Wait for more results,
+    // unless we already have a cached address.
+    if (!mFromCache && elapsed < mRequest.GetMinLookupTime())
     {
         ChipLogProgress(Discovery, "Keeping DNSSD lookup active");
         return NodeLookupAction::KeepSearching();
@@ -185,8 +230,21 @@ CHIP_ERROR Resolver::LookupNode(const NodeLookupRequest & request, Impl::NodeLoo
 
     VerifyOrReturnError(mSystemLayer != nullptr, CHIP_ERROR_INCORRECT_STATE);
 
-    handle.ResetForLookup(mTimeSource.GetMonotonicTimestamp(), request);
+    const System::Clock::Timestamp now = mTimeSource.GetMonotonicTimestamp();
+
+    handle.ResetForLookup(now, request);
+
+    // Resolve the node even if its address is cached: the cached address
+    // completes the lookup right away, and the resolution revalidates it in
+    // the background for the next lookups.
     ReturnErrorOnFailure(Dnssd::Resolver::Instance().ResolveNodeId(request.GetPeerId()));
+
+    const ResolveResult * cachedResult = mAddressCache.Find(request.GetPeerId(), now);
+    if (cachedResult != nullptr)
+    {
+        handle.UseCachedResult(*cachedResult);
+    }
+
     mActiveLookups.PushBack(&handle);
     ReArmTimer();
     return CHIP_NO_ERROR;
@@ -195,6 +253,12 @@ CHIP_ERROR Resolver::LookupNode(const NodeLookupRequest & request, Impl::NodeLoo
 CHIP_ERROR Resolver::TryNextResult(Impl::NodeLookupHandle & handle)
 {
     VerifyOrReturnError(!mActiveLookups.Contains(&handle), CHIP_ERROR_INCORRECT_STATE);
+
+    if (handle.IsFromCache() && !handle.HasLookupResult())
+    {
+        RetryCachedResult(handle);
+    }
+
     VerifyOrReturnError(handle.HasLookupResult(), CHIP_ERROR_EMPTY);
 
     auto listener = handle.GetListener();
@@ -264,12 +328,15 @@ void Resolver::Shutdown()
     // internal list of active lookups is empty at this point.
     ReArmTimer();
 
+    mAddressCache.Clear();
     mSystemLayer = nullptr;
     Dnssd::Resolver::Instance().SetOperationalDelegate(nullptr);
 }
 
 void Resolver::OnOperationalNodeResolved(const Dnssd::ResolvedNodeData & nodeData)
 {
+    UpdateAddressCache(nodeData);
+
     auto it = mActiveLookups.begin();
     while (it != mActiveLookups.end())
     {
@@ -280,40 +347,55 @@ void Resolver::OnOperationalNodeResolved(const Dnssd::ResolvedNodeData & nodeDat
             continue;
         }
 
-        ResolveResult result;
+        ForEachResolveResult(nodeData, [&current](const ResolveResult & result) { current->LookupResult(result); });
 
-        result.address.SetPort(nodeData.resolutionData.port);
-        result.address.SetInterface(nodeData.resolutionData.interfaceId);
-        result.mrpRemoteConfig = nodeData.resolutionData.GetRemoteMRPConfig();
-        result.supportsTcp     = nodeData.resolutionData.supportsTcp;
+        HandleAction(current);
+    }
 
-        if (nodeData.resolutionData.isICDOperatingAsLIT.HasValue())
-        {
-            result.isICDOperatingAsLIT = nodeData.resolutionData.isICDOperatingAsLIT.Value();
-        }
+    ReArmTimer();
+}
 
-        for (size_t i = 0; i < nodeData.resolutionData.numIPs; i++)
-        {
-#if !INET_CONFIG_ENABLE_IPV4
-            if (!nodeData.resolutionData.ipAddress[i].IsIPv6())
-            {
-                ChipLogError(Discovery, "Skipping IPv4 address during operational resolve.");
-                continue;
-            }
-#endif
-            result.address.SetIPAddress(nodeData.resolutionData.ipAddress[i]);
-            current->LookupResult(result);
-        }
+void Resolver::UpdateAddressCache(const Dnssd::ResolvedNodeData & nodeData)
+{
+    const PeerId & peerId              = nodeData.operationalData.peerId;
+    const System::Clock::Seconds32 ttl = nodeData.resolutionData.ttl.ValueOr(kDefaultAddressTtl);
 
-        HandleAction(current);
+    if (ttl == System::Clock::kZero)
+    {
+        // The node is withdrawing its records (goodbye packet)
+        mAddressCache.Remove(peerId);
+        return;
     }
 
-    ReArmTimer();
+    NodeLookupResults results;
+    ForEachResolveResult(nodeData, [&results](const ResolveResult & result) {
+        results.UpdateResults(result,
+                              Dnssd::IPAddressSorter::ScoreIpAddress(result.address.GetIPAddress(), result.address.GetInterface()));
+    });
+    VerifyOrReturn(results.HasValidResult());
+
+    const System::Clock::Timestamp now = mTimeSource.GetMonotonicTimestamp();
+    mAddressCache.Update(peerId, results.ConsumeResult(), now, now + ttl);
+}
+
+void Resolver::RetryCachedResult(Impl::NodeLookupHandle & handle)
+{
+    const PeerId & peerId              = handle.GetRequest().GetPeerId();
+    const ResolveResult * cachedResult = mAddressCache.Find(peerId, mTimeSource.GetMonotonicTimestamp());
+
+    if (cachedResult != nullptr && cachedResult->address != handle.GetCachedAddress())
+    {
+        handle.UseCachedResult(*cachedResult);
+        return;
+    }
+
+    mAddressCache.Remove(peerId);
 }
 
 void Resolver::HandleAction(IntrusiveList<NodeLookupHandle>::Iterator & current)
 {
-    const NodeLookupAction action = current->NextAction(mTimeSource.GetMonotonicTimestamp());
+    const System::Clock::Timestamp now = mTimeSource.GetMonotonicTimestamp();
+    const NodeLookupAction action      = current->NextAction(now);
 
     if (action.Type() == NodeLookupResult::kKeepSearching)
     {
@@ -324,6 +406,10 @@ void Resolver::HandleAction(IntrusiveList<NodeLookupHandle>::Iterator & current)
     // final result, handle either success or failure
     const PeerId peerId     = current->GetRequest().GetPeerId();
     NodeListener * listener = current->GetListener();
+    [[maybe_unused]] const Tracing::DiscoveryInfoType discoveryType =
+        current->IsFromCache() ? Tracing::DiscoveryInfoType::kCacheHit : Tracing::DiscoveryInfoType::kResolutionDone;
+    [[maybe_unused]] const auto lookupTime =
+        std::chrono::duration_cast<System::Clock::Milliseconds32>(now - current->GetRequestStartTime());
     mActiveLookups.Erase(current);
 
     Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(peerId);
@@ -338,7 +424,7 @@ void Resolver::HandleAction(IntrusiveList<NodeLookupHandle>::Iterator & current)
         listener->OnNodeAddressResolutionFailed(peerId, action.ErrorResult());
         break;
     case NodeLookupResult::kLookupSuccess:
-        MATTER_LOG_NODE_DISCOVERED(Tracing::DiscoveryInfoType::kResolutionDone, &peerId, &action.ResolveResult());
+        MATTER_LOG_NODE_DISCOVERED(discoveryType, &peerId, &action.ResolveResult(), lookupTime);
         listener->OnNodeAddressResolved(peerId, action.ResolveResult());
         break;
     default:
@@ -363,6 +449,8 @@ void Resolver::HandleTimer()
 
 void Resolver::OnOperationalNodeResolutionFailed(const PeerId & peerId, CHIP_ERROR error)
 {
+    mAddressCache.Remove(peerId);
+
     auto it = mActiveLookups.begin();
     while (it != mActiveLookups.end())
     {
@@ -27,6 +27,7 @@ namespace AddressResolve {
 namespace Impl {
 
 inline constexpr uint8_t kNodeLookupResultsLen = CHIP_CONFIG_MDNS_RESOLVE_LOOKUP_RESULTS;
+inline constexpr size_t kAddressCacheSize      = CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE;
 
 enum class NodeLookupResult
 {
@@ -120,6 +121,113 @@ private:
     NodeLookupResult mResultType;
 };
 
+/// Keeps the best address DNS-SD resolved for a node, for as long as the
+/// records it was resolved from are valid.
+///
+/// Entries are per node and per fabric (i.e. keyed by PeerId). Once all entries
+/// are in use, the least recently used one is replaced.
+template <size_t kCapacity>
+class ResolvedAddressCache
+{
+public:
+    /// Returns the cached address of the given peer, or nullptr if none
+    /// is cached or the cached one has expired.
+    const ResolveResult * Find(const PeerId & peerId, System::Clock::Timestamp now)
+    {
+        Entry * entry = FindEntry(peerId);
+        VerifyOrReturnValue(entry != nullptr, nullptr);
+
+        if (now >= entry->expiry)
+        {
+            entry->inUse = false;
+            return nullptr;
+        }
+
+        entry->lastUsed = now;
+        return &entry->result;
+    }
+
+    /// Caches the address of the given peer until `expiry`.
+    void Update(const PeerId & peerId, const ResolveResult & result, System::Clock::Timestamp now,
+                System::Clock::Timestamp expiry)
+    {
+        VerifyOrReturn(kCapacity > 0);
+
+        Entry * entry = FindEntry(peerId);
+        if (entry == nullptr)
+        {
+            entry = FindFreeEntry(now);
+        }
+        VerifyOrReturn(entry != nullptr);
+
+        entry->peerId   = peerId;
+        entry->result   = result;
+        entry->expiry   = expiry;
+        entry->lastUsed = now;
+        entry->inUse    = true;
+    }
+
+    void Remove(const PeerId & peerId)
+    {
+        Entry * entry = FindEntry(peerId);
+        if (entry != nullptr)
+        {
+            entry->inUse = false;
+        }
+    }
+
+    void Clear()
+    {
+        for (auto & entry : mEntries)
+        {
+            entry.inUse = false;
+        }
+    }
+
+private:
+    struct Entry
+    {
+        PeerId peerId;
+        ResolveResult result;
+        System::Clock::Timestamp expiry;
+        System::Clock::Timestamp lastUsed;
+        bool inUse = false;
+    };
+
+    Entry * FindEntry(const PeerId & peerId)
+    {
+        for (auto & entry : mEntries)
+        {
+            if (entry.inUse && entry.peerId == peerId)
+            {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    /// Returns an unused or expired entry if any, otherwise the least recently used one.
+    Entry * FindFreeEntry(System::Clock::Timestamp now)
+    {
+        Entry * leastRecentlyUsed = nullptr;
+        for (auto & entry : mEntries)
+        {
+            if (!entry.inUse || now >= entry.expiry)
+            {
+                return &entry;
+            }
+            if (leastRecentlyUsed == nullptr || entry.lastUsed < leastRecentlyUsed->lastUsed)
+            {
+                leastRecentlyUsed = &entry;
+            }
+        }
+        return leastRecentlyUsed;
+    }
+
+    // A disabled cache still has one (never used) entry, as arrays cannot be empty.
+    Entry mEntries[kCapacity > 0 ? kCapacity : 1];
+};
+
 /// An implementation of a node lookup handle
 ///
 /// Keeps track of time requests as well as the current
@@ -133,6 +241,18 @@ public:
     /// Resets internal state (i.e. best address so far)
     void ResetForLookup(System::Clock::Timestamp now, const NodeLookupRequest & request);
 
+    /// Completes the lookup with a cached address as soon as possible,
+    /// without waiting for the minimal lookup time.
+    void UseCachedResult(const ResolveResult & result);
+
+    /// Was the lookup completed with a cached address?
+    bool IsFromCache() const { return mFromCache; }
+
+    /// The cached address the lookup was completed with, if IsFromCache().
+    const Transport::PeerAddress & GetCachedAddress() const { return mCachedAddress; }
+
+    System::Clock::Timestamp GetRequestStartTime() const { return mRequestStartTime; }
+
     /// Mark that a specific IP address has been found
     void LookupResult(const ResolveResult & result);
 
@@ -161,6 +281,8 @@ private:
     NodeLookupResults mResults;
     NodeLookupRequest mRequest; // active request to process
     System::Clock::Timestamp mRequestStartTime;
+    Transport::PeerAddress mCachedAddress;
+    bool mFromCache = false;
 };
 
 class Resolver : public ::chip::AddressResolve::Resolver, public Dnssd::OperationalResolveDelegate
@@ -200,9 +322,20 @@ private:
     /// be used after calling this method.
     void HandleAction(IntrusiveList<NodeLookupHandle>::Iterator & current);
 
+    /// Caches the best address of a resolved node, or forgets the cached
+    /// one if the node withdrew its records.
+    void UpdateAddressCache(const Dnssd::ResolvedNodeData & nodeData);
+
+    /// Called when the cached address a lookup was completed with did not
+    /// work out. Has the handle try the address DNS-SD revalidation cached since,
+    /// if different, otherwise forgets the cached address so that the next
+    /// lookup of the node is a complete one.
+    void RetryCachedResult(Impl::NodeLookupHandle & handle);
+
     System::Layer * mSystemLayer = nullptr;
     Time::TimeSource<Time::Source::kSystem> mTimeSource;
     IntrusiveList<NodeLookupHandle> mActiveLookups;
+    ResolvedAddressCache<kAddressCacheSize> mAddressCache;
 };
 
 } // namespace Impl
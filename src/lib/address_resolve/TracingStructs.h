@@ -36,6 +36,7 @@ enum class DiscoveryInfoType
     kIntermediateResult = 0, // Received intermediate address data
     kResolutionDone     = 1, // resolution completed
     kRetryDifferent     = 2, // Try a different/new IP address
+    kCacheHit           = 3, // resolution completed with a cached address
 };
 
 /// A node was discovered and we have information about it.
@@ -44,6 +45,9 @@ struct NodeDiscoveredInfo
     DiscoveryInfoType type;                             // separate callbacks depending on state
     const PeerId * peerId;                              // what peer was discovered
     const chip::AddressResolve::ResolveResult * result; // a SINGLE result representing the resolution
+
+    // Time since the lookup was requested, for the kResolutionDone and kCacheHit types
+    System::Clock::Milliseconds32 lookupTime = System::Clock::kZero;
 };
 
 /// A node lookup failed / give up on this discovery
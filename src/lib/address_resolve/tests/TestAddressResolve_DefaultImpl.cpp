@@ -200,9 +200,112 @@ void TestLookupResult(nlTestSuite * inSuite, void * inContext)
     NL_TEST_ASSERT(inSuite, !handle.HasLookupResult());
 }
 
+void TestCachedLookupResult(nlTestSuite * inSuite, void * inContext)
+{
+    using namespace chip::System::Clock::Literals;
+
+    ResolveResult cachedResult;
+    cachedResult.address = GetAddressWithMediumScore();
+
+    AddressResolve::NodeLookupHandle handle;
+
+    auto now     = System::SystemClock().GetMonotonicTimestamp();
+    auto request = NodeLookupRequest(chip::PeerId(1, 2));
+    request.SetMinLookupTime(200_ms32);
+    request.SetMaxLookupTime(1000_ms32);
+
+    // Without a cached address, the lookup waits for the minimal lookup time.
+    handle.ResetForLookup(now, request);
+    handle.LookupResult(cachedResult);
+    NL_TEST_ASSERT(inSuite, !handle.IsFromCache());
+    NL_TEST_ASSERT(inSuite, handle.NextEventTimeout(now) == 200_ms32);
+    NL_TEST_ASSERT(inSuite, handle.NextAction(now).Type() == Impl::NodeLookupResult::kKeepSearching);
+
+    // A cached address completes the lookup right away.
+    handle.ResetForLookup(now, request);
+    handle.UseCachedResult(cachedResult);
+    NL_TEST_ASSERT(inSuite, handle.IsFromCache());
+    NL_TEST_ASSERT(inSuite, handle.GetCachedAddress() == cachedResult.address);
+    NL_TEST_ASSERT(inSuite, handle.NextEventTimeout(now) == System::Clock::kZero);
+
+    Impl::NodeLookupAction action = handle.NextAction(now);
+    NL_TEST_ASSERT(inSuite, action.Type() == Impl::NodeLookupResult::kLookupSuccess);
+    NL_TEST_ASSERT(inSuite, action.ResolveResult().address == cachedResult.address);
+    NL_TEST_ASSERT(inSuite, !handle.HasLookupResult());
+
+    // A new lookup does not use the cache unless told to.
+    handle.ResetForLookup(now, request);
+    NL_TEST_ASSERT(inSuite, !handle.IsFromCache());
+}
+
+void TestResolvedAddressCache(nlTestSuite * inSuite, void * inContext)
+{
+    using namespace chip::System::Clock::Literals;
+
+    const PeerId peer1(1, 1);
+    const PeerId peer2(1, 2);
+    const PeerId peer3(2, 1); // same node id as peer1, other fabric
+
+    ResolveResult result1;
+    result1.address = GetAddressWithLowScore();
+    ResolveResult result2;
+    result2.address = GetAddressWithMediumScore();
+    ResolveResult result3;
+    result3.address = GetAddressWithHighScore();
+
+    Impl::ResolvedAddressCache<2> cache;
+    System::Clock::Timestamp now = 1000_ms64;
+
+    NL_TEST_ASSERT(inSuite, cache.Find(peer1, now) == nullptr);
+
+    cache.Update(peer1, result1, now, now + 120_s32);
+    cache.Update(peer2, result2, now, now + 10_s32);
+
+    const ResolveResult * found = cache.Find(peer1, now);
+    NL_TEST_ASSERT(inSuite, found != nullptr && found->address == result1.address);
+    found = cache.Find(peer2, now);
+    NL_TEST_ASSERT(inSuite, found != nullptr && found->address == result2.address);
+
+    // Entries are per fabric.
+    NL_TEST_ASSERT(inSuite, cache.Find(peer3, now) == nullptr);
+
+    // Updating an entry replaces its address.
+    cache.Update(peer1, result3, now, now + 120_s32);
+    found = cache.Find(peer1, now);
+    NL_TEST_ASSERT(inSuite, found != nullptr && found->address == result3.address);
+
+    // Entries expire with their TTL.
+    now += 10_s32;
+    NL_TEST_ASSERT(inSuite, cache.Find(peer2, now) == nullptr);
+    NL_TEST_ASSERT(inSuite, cache.Find(peer1, now) != nullptr);
+
+    // Once full, the least recently used entry is replaced.
+    cache.Update(peer2, result2, now, now + 120_s32);
+    now += 1_s32;
+    NL_TEST_ASSERT(inSuite, cache.Find(peer1, now) != nullptr);
+    cache.Update(peer3, result3, now, now + 120_s32);
+    NL_TEST_ASSERT(inSuite, cache.Find(peer1, now) != nullptr);
+    NL_TEST_ASSERT(inSuite, cache.Find(peer2, now) == nullptr);
+    NL_TEST_ASSERT(inSuite, cache.Find(peer3, now) != nullptr);
+
+    cache.Remove(peer3);
+    NL_TEST_ASSERT(inSuite, cache.Find(peer3, now) == nullptr);
+
+    cache.Update(peer1, result1, now, now + 120_s32);
+    cache.Clear();
+    NL_TEST_ASSERT(inSuite, cache.Find(peer1, now) == nullptr);
+
+    // A disabled cache keeps nothing.
+    Impl::ResolvedAddressCache<0> disabledCache;
+    disabledCache.Update(peer1, result1, now, now + 120_s32);
+    NL_TEST_ASSERT(inSuite, disabledCache.Find(peer1, now) == nullptr);
+}
+
 const nlTest sTests[] = {
-    NL_TEST_DEF("TestLookupResult", TestLookupResult), //
-    NL_TEST_SENTINEL()                                 //
+    NL_TEST_DEF("TestLookupResult", TestLookupResult),                 //
+    NL_TEST_DEF("TestCachedLookupResult", TestCachedLookupResult),     //
+    NL_TEST_DEF("TestResolvedAddressCache", TestResolvedAddressCache), //
+    NL_TEST_SENTINEL()                                                 //
 };
 
 } // namespace
@@ -734,6 +734,43 @@
 #define CHIP_CONFIG_MAX_FABRICS 16
 #endif // CHIP_CONFIG_MAX_FABRICS
 
+/**
+ * @def CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES
+ *
+ * @brief Number of CASE handshakes the CASE server can run at the same time
+ * as a responder.  Each of them reserves a secure session slot while waiting
+ * for a Sigma1.
+ *
+ */
+#ifndef CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES
+#define CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES 1
+#endif // CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES
+
+/**
+ * @def CHIP_CONFIG_CASE_SERVER_SIGMA1_QUEUE_SIZE
+ *
+ * @brief Number of Sigma1 messages the CASE server keeps, with their exchanges
+ * open, while all of its handshakes are in use.  Sigma1 messages that do not
+ * fit get a busy response.  0 disables the queue.
+ *
+ */
+#ifndef CHIP_CONFIG_CASE_SERVER_SIGMA1_QUEUE_SIZE
+#define CHIP_CONFIG_CASE_SERVER_SIGMA1_QUEUE_SIZE 0
+#endif // CHIP_CONFIG_CASE_SERVER_SIGMA1_QUEUE_SIZE
+
+/**
+ * @def CHIP_CONFIG_CASE_SERVER_SIGMA1_QUEUE_TIMEOUT_MS
+ *
+ * @brief How long a Sigma1 message waits for a CASE server handshake, in
+ * milliseconds, before it gets a busy response.  The initiator only waits a
+ * few seconds for the Sigma2, after which it sends a new Sigma1, which then
+ * takes the place of the waiting one.
+ *
+ */
+#ifndef CHIP_CONFIG_CASE_SERVER_SIGMA1_QUEUE_TIMEOUT_MS
+#define CHIP_CONFIG_CASE_SERVER_SIGMA1_QUEUE_TIMEOUT_MS 5000
+#endif // CHIP_CONFIG_CASE_SERVER_SIGMA1_QUEUE_TIMEOUT_MS
+
 /**
  * @def CHIP_CONFIG_SECURE_SESSION_POOL_SIZE
  *
@@ -743,7 +780,8 @@
  *
  * This is sized by default to cover the sum of the following:
  *  - At least 3 CASE sessions / fabric (Spec Ref: 4.13.2.8)
- *  - 1 reserved slot for CASEServer as a responder.
+ *  - 1 reserved slot for each concurrent CASEServer responder handshake
+ *    (CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES).
  *  - 1 reserved slot for PASE.
  *
  *  NOTE: On heap-based platforms, there is no pre-allocation of the pool.
@@ -753,9 +791,23 @@
  *
  */
 #ifndef CHIP_CONFIG_SECURE_SESSION_POOL_SIZE
-#define CHIP_CONFIG_SECURE_SESSION_POOL_SIZE (CHIP_CONFIG_MAX_FABRICS * 3 + 2)
+#define CHIP_CONFIG_SECURE_SESSION_POOL_SIZE (CHIP_CONFIG_MAX_FABRICS * 3 + CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES + 1)
 #endif // CHIP_CONFIG_SECURE_SESSION_POOL_SIZE
 
+/**
+ * @def CHIP_CONFIG_SESSION_KEY_CIPHER_CONTEXT
+ *
+ * @brief Whether session keys derived by RawKeySessionKeystore keep a cipher
+ * context of the crypto backend, with the key already set up, for the life of
+ * the session (see AES_CCM_InitKeyContext()).  This saves the key setup on
+ * every message, at the cost of a heap allocation per session key, so it is
+ * enabled by default only on platforms that allocate pools on the heap.
+ *
+ */
+#ifndef CHIP_CONFIG_SESSION_KEY_CIPHER_CONTEXT
+#define CHIP_CONFIG_SESSION_KEY_CIPHER_CONTEXT CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+#endif // CHIP_CONFIG_SESSION_KEY_CIPHER_CONTEXT
+
 /**
  *  @def CHIP_CONFIG_MAX_GROUP_DATA_PEERS
  *
@@ -918,6 +970,44 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_IM_SERVER_MAX_NUM_DIRTY_SET 8
 #endif
 
+/**
+ * @def CHIP_IM_SERVER_ATTRIBUTE_INTEREST_INDEX
+ *
+ * @brief Enables an index from subscribed/read attribute paths to their read handlers, so that marking an attribute dirty
+ *        only visits the read handlers interested in its endpoint and cluster instead of every path of every handler.
+ *        The index needs one entry per attribute path object, so it is enabled by default only when object pools are heap
+ *        allocated.
+ */
+#ifndef CHIP_IM_SERVER_ATTRIBUTE_INTEREST_INDEX
+#define CHIP_IM_SERVER_ATTRIBUTE_INTEREST_INDEX CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+#endif
+
+/**
+ * @def CHIP_IM_SERVER_ATTRIBUTE_INTEREST_INDEX_BUCKETS
+ *
+ * @brief Number of hash buckets of the attribute interest index, must be a power of two.
+ */
+#ifndef CHIP_IM_SERVER_ATTRIBUTE_INTEREST_INDEX_BUCKETS
+#define CHIP_IM_SERVER_ATTRIBUTE_INTEREST_INDEX_BUCKETS 64
+#endif
+
+/**
+ * @def CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE
+ *
+ * @brief Maximum number of bytes of attribute reports a read handler may encode ahead of the report message being built.
+ *        When a list attribute has to be chunked, the rest of the list is encoded into a chain of packet buffers of up
+ *        to this size right away, and later chunks copy it out instead of encoding the list again.  0 disables this.
+ *        Since the buffers are held between chunks, this is enabled by default only when packet buffers are heap
+ *        allocated rather than taken from a fixed pool shared with message I/O.
+ */
+#ifndef CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE
+#if CHIP_SYSTEM_CONFIG_PACKETBUFFER_POOL_SIZE == 0 && !CHIP_SYSTEM_CONFIG_USE_LWIP
+#define CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE 4096
+#else
+#define CHIP_IM_SERVER_REPORT_OVERFLOW_SIZE 0
+#endif
+#endif
+
 /**
  * @def CHIP_IM_MAX_NUM_WRITE_HANDLER
  *
@@ -1094,6 +1184,19 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_MAX_GROUP_CONCURRENT_ITERATORS 2
 #endif
 
+/**
+ * @def CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE
+ *
+ * @brief Defines the number of group keys kept loaded in RAM for decrypting incoming group messages
+ *
+ * Each entry holds the operational and privacy keys of one group key, indexed by session id and ordered by most
+ * recent successful decryption, so that incoming group messages do not need to read the group key tables from
+ * persistent storage and try every candidate key. Setting this to 0 disables the cache.
+ */
+#ifndef CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE
+#define CHIP_CONFIG_GROUP_SESSION_CACHE_SIZE 8
+#endif
+
 /**
  * @def CHIP_CONFIG_MAX_GROUP_NAME_LENGTH
  *
@@ -1193,6 +1296,31 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
     "Please enable at least one of CHIP_CONFIG_EXAMPLE_ACCESS_CONTROL_FAST_COPY_SUPPORT or CHIP_CONFIG_EXAMPLE_ACCESS_CONTROL_FLEXIBLE_COPY_SUPPORT"
 #endif
 
+/**
+ * @def CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE
+ *
+ * @brief Defines the number of subjects for which AccessControl keeps compiled access control entries
+ *
+ * A compiled subject holds the targets and privileges granted to one subject descriptor by the entries of its fabric,
+ * plus the privileges granted on the few paths it accessed most recently, so that checks for it need not go through
+ * the entries of the delegate. Compiled subjects are dropped whenever entries are created, updated or deleted.
+ * Setting this to 0 disables compilation.
+ */
+#ifndef CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE
+#define CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_SIZE 4
+#endif
+
+/**
+ * @def CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_MAX_GRANTS
+ *
+ * @brief Defines the number of grants, i.e. entry targets, a compiled subject can hold
+ *
+ * Checks for subjects with more grants than this go through the entries of the delegate.
+ */
+#ifndef CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_MAX_GRANTS
+#define CHIP_CONFIG_ACCESS_CONTROL_SUBJECT_CACHE_MAX_GRANTS 8
+#endif
+
 /**
  * @def CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE
  *
@@ -1223,6 +1351,66 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_EVENT_LOGGING_BYTE_THRESHOLD 512
 #endif /* CHIP_CONFIG_EVENT_LOGGING_BYTE_THRESHOLD */
 
+/**
+ * @def CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE
+ *
+ * @brief The number of events of each event logging buffer whose number and path are kept in RAM.
+ *
+ * Fetching events for a report skips the indexed events that do not match the requested paths without decoding them.
+ * The oldest events of a buffer holding more events than this are decoded to be checked, as they are without an index.
+ * Each entry takes 24 bytes on most platforms, for each of the three buffers, so the index trades RAM for the decode
+ * cost of filtered reads.  It pays off on devices with many subscriptions filtering large event buffers; constrained
+ * devices with small buffers gain little from it.  Disabled (0) by default; platforms opt in from their
+ * CHIPPlatformConfig.h.
+ */
+#ifndef CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE
+#define CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE 0
+#endif // CHIP_CONFIG_EVENT_LOGGING_INDEX_SIZE
+
+/**
+ * @def CHIP_CONFIG_ENABLE_PERSISTENT_EVENT_LOG
+ *
+ * @brief Enable the persistent event log tier of the server.
+ *
+ * Events of Info priority or higher are also written to the server's persistent storage, so they can still be reported
+ * once they were evicted from the event logging buffers, or after a reboot.
+ */
+#ifndef CHIP_CONFIG_ENABLE_PERSISTENT_EVENT_LOG
+#define CHIP_CONFIG_ENABLE_PERSISTENT_EVENT_LOG 0
+#endif // CHIP_CONFIG_ENABLE_PERSISTENT_EVENT_LOG
+
+/**
+ * @def CHIP_CONFIG_PERSISTENT_EVENT_LOG_SEGMENT_SIZE
+ *
+ * @brief The size in bytes of a segment of the persistent event log, each stored as one key.
+ *
+ * Events are staged in RAM in the newest segment, which is written once it is full or after
+ * CHIP_CONFIG_PERSISTENT_EVENT_LOG_FLUSH_DELAY_MS.  It must hold at least one event of the largest size.
+ */
+#ifndef CHIP_CONFIG_PERSISTENT_EVENT_LOG_SEGMENT_SIZE
+#define CHIP_CONFIG_PERSISTENT_EVENT_LOG_SEGMENT_SIZE 1024
+#endif // CHIP_CONFIG_PERSISTENT_EVENT_LOG_SEGMENT_SIZE
+
+/**
+ * @def CHIP_CONFIG_PERSISTENT_EVENT_LOG_SEGMENT_COUNT
+ *
+ * @brief The number of segments of the persistent event log.  The oldest segment is deleted to make room for a new one.
+ */
+#ifndef CHIP_CONFIG_PERSISTENT_EVENT_LOG_SEGMENT_COUNT
+#define CHIP_CONFIG_PERSISTENT_EVENT_LOG_SEGMENT_COUNT 8
+#endif // CHIP_CONFIG_PERSISTENT_EVENT_LOG_SEGMENT_COUNT
+
+/**
+ * @def CHIP_CONFIG_PERSISTENT_EVENT_LOG_FLUSH_DELAY_MS
+ *
+ * @brief The delay after which events staged in RAM are written to the persistent event log.
+ *
+ * Events logged within this delay are written together.  Events not yet written are lost on power loss.
+ */
+#ifndef CHIP_CONFIG_PERSISTENT_EVENT_LOG_FLUSH_DELAY_MS
+#define CHIP_CONFIG_PERSISTENT_EVENT_LOG_FLUSH_DELAY_MS 5000
+#endif // CHIP_CONFIG_PERSISTENT_EVENT_LOG_FLUSH_DELAY_MS
+
 /**
  * @def CHIP_CONFIG_ENABLE_SERVER_IM_EVENT
  *
@@ -1357,6 +1545,39 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_MDNS_RESOLVE_LOOKUP_RESULTS 1
 #endif // CHIP_CONFIG_MDNS_RESOLVE_LOOKUP_RESULTS
 
+/**
+ * @def CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE
+ *
+ * @brief Determines the maximum number of nodes whose resolved operational address is
+ *        kept by the address resolver after their lookup completes.
+ *
+ *        A lookup of a node whose address is cached completes right away with that
+ *        address, while DNS-SD revalidates it in the background. 0 disables the cache.
+ */
+#ifndef CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE
+#define CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE 0
+#endif // CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE
+
+/**
+ * @def CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_DEFAULT_TTL
+ *
+ * @brief How long, in seconds, a cached operational address is used when the DNS-SD
+ *        implementation does not report the TTL of the records it was resolved from.
+ */
+#ifndef CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_DEFAULT_TTL
+#define CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_DEFAULT_TTL 120
+#endif // CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_DEFAULT_TTL
+
+/**
+ * @def CHIP_CONFIG_FLEET_SUBSCRIPTION_MAX_NODES
+ *
+ * @brief The maximum number of nodes a FleetSubscriptionManager subscribes to, when
+ *        its node pool is statically allocated.  Heap-allocated pools are not limited.
+ */
+#ifndef CHIP_CONFIG_FLEET_SUBSCRIPTION_MAX_NODES
+#define CHIP_CONFIG_FLEET_SUBSCRIPTION_MAX_NODES 16
+#endif // CHIP_CONFIG_FLEET_SUBSCRIPTION_MAX_NODES
+
 /*
  * @def CHIP_CONFIG_NETWORK_COMMISSIONING_DEBUG_TEXT_BUFFER_SIZE
  *
@@ -1403,6 +1624,19 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_NUM_CD_KEY_SLOTS 5
 #endif // CHIP_CONFIG_NUM_CD_KEY_SLOTS
 
+/**
+ * @def CHIP_CONFIG_DAC_VERIFIER_VERIFIED_PAI_CACHE_SIZE
+ *
+ * @brief Number of PAI certificates whose chain to a PAA the default DAC verifier remembers, unless changed at runtime
+ *
+ * When attesting a device whose PAI and PAA are remembered, only the DAC is verified against the PAI, instead of
+ * verifying the whole DAC, PAI and PAA chain again. This is opt-in: by default the whole chain is always verified.
+ * See DefaultDACVerifier::SetVerifiedPaiCacheSize().
+ */
+#ifndef CHIP_CONFIG_DAC_VERIFIER_VERIFIED_PAI_CACHE_SIZE
+#define CHIP_CONFIG_DAC_VERIFIER_VERIFIED_PAI_CACHE_SIZE 0
+#endif // CHIP_CONFIG_DAC_VERIFIER_VERIFIED_PAI_CACHE_SIZE
+
 /**
  * @def CHIP_CONFIG_MAX_SUBSCRIPTION_RESUMPTION_STORAGE_CONCURRENT_ITERATORS
  *
@@ -24,6 +24,8 @@
 #include <lib/support/CHIPMemString.h>
 #include <tracing/macros.h>
 
+#include <algorithm>
+
 namespace chip {
 namespace Dnssd {
 
@@ -137,13 +139,15 @@ SerializedQNameIterator StoredServerName::Get() const
     return SerializedQNameIterator(BytesRange(mNameBuffer, mNameBuffer + sizeof(mNameBuffer)), mNameBuffer);
 }
 
-CHIP_ERROR IncrementalResolver::InitializeParsing(mdns::Minimal::SerializedQNameIterator name, const mdns::Minimal::SrvRecord & srv)
+CHIP_ERROR IncrementalResolver::InitializeParsing(mdns::Minimal::SerializedQNameIterator name, uint64_t ttlSeconds,
+                                                  const mdns::Minimal::SrvRecord & srv)
 {
     AutoInactiveResetter inactiveReset(*this);
 
     ReturnErrorOnFailure(mRecordName.Set(name));
     ReturnErrorOnFailure(mTargetHostName.Set(srv.GetName()));
     mCommonResolutionData.port = srv.GetPort();
+    OnRecordTtl(ttlSeconds);
 
     {
         // TODO: Chip code historically seems to assume that the host name is of the
@@ -246,6 +250,7 @@ CHIP_ERROR IncrementalResolver::OnRecord(Inet::InterfaceId interface, const Reso
             MATTER_TRACE_INSTANT("TXT not applicable", "Resolver");
             return CHIP_NO_ERROR;
         }
+        OnRecordTtl(data.GetTtlSeconds());
         return OnTxtRecord(data, packetRange);
     case QType::A: {
         if (data.GetName() != mTargetHostName.Get())
@@ -261,6 +266,7 @@ CHIP_ERROR IncrementalResolver::OnRecord(Inet::InterfaceId interface, const Reso
             return CHIP_ERROR_INVALID_ARGUMENT;
         }
 
+        OnRecordTtl(data.GetTtlSeconds());
         return OnIpAddress(interface, addr);
 #else
 #if CHIP_MINMDNS_HIGH_VERBOSITY
@@ -283,6 +289,7 @@ CHIP_ERROR IncrementalResolver::OnRecord(Inet::InterfaceId interface, const Reso
             return CHIP_ERROR_INVALID_ARGUMENT;
         }
 
+        OnRecordTtl(data.GetTtlSeconds());
         return OnIpAddress(interface, addr);
     }
     case QType::SRV: // SRV handled on creation, ignored for 'additional data'
@@ -341,6 +348,16 @@ CHIP_ERROR IncrementalResolver::OnIpAddress(Inet::InterfaceId interface, const I
     return CHIP_NO_ERROR;
 }
 
+void IncrementalResolver::OnRecordTtl(uint64_t ttlSeconds)
+{
+    const System::Clock::Seconds32 ttl(static_cast<uint32_t>(std::min<uint64_t>(ttlSeconds, UINT32_MAX)));
+
+    if (!mCommonResolutionData.ttl.HasValue() || (ttl < mCommonResolutionData.ttl.Value()))
+    {
+        mCommonResolutionData.ttl.SetValue(ttl);
+    }
+}
+
 CHIP_ERROR IncrementalResolver::Take(DiscoveredNodeData & outputData)
 {
     VerifyOrReturnError(IsActiveCommissionParse(), CHIP_ERROR_INCORRECT_STATE);
@@ -107,8 +107,11 @@ public:
     /// Start parsing a new record. SRV records are the records we are mainly
     /// interested on, after which TXT and A/AAAA are looked for.
     ///
+    /// [ttlSeconds] is the TTL of the SRV record.
+    ///
     /// If this function returns with error, the object will be in an inactive state.
-    CHIP_ERROR InitializeParsing(mdns::Minimal::SerializedQNameIterator name, const mdns::Minimal::SrvRecord & srv);
+    CHIP_ERROR InitializeParsing(mdns::Minimal::SerializedQNameIterator name, uint64_t ttlSeconds,
+                                 const mdns::Minimal::SrvRecord & srv);
 
     /// Notify that a new record is being processed.
     /// Will handle filtering and processing of data to determine if the entry is relevant for
@@ -178,6 +181,10 @@ private:
     /// Prerequisite: IP address belongs to the right nost name
     CHIP_ERROR OnIpAddress(Inet::InterfaceId interface, const Inet::IPAddress & addr);
 
+    /// Notify the TTL of a record that the data is parsed from: the parsed
+    /// data is valid for as long as the shortest lived of these records.
+    void OnRecordTtl(uint64_t ttlSeconds);
+
     using ParsedRecordSpecificData = Variant<OperationalNodeData, CommissionNodeData>;
 
     StoredServerName mRecordName;     // Record name for what is parsed (SRV/PTR/TXT)
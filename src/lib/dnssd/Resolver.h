@@ -53,6 +53,8 @@ struct CommonResolutionData
     Optional<System::Clock::Milliseconds32> mrpRetryIntervalIdle;
     Optional<System::Clock::Milliseconds32> mrpRetryIntervalActive;
     Optional<System::Clock::Milliseconds16> mrpRetryActiveThreshold;
+    // Shortest TTL of the records the data was resolved from, if the resolver knows it.
+    Optional<System::Clock::Seconds32> ttl;
 
     CommonResolutionData() { Reset(); }
 
@@ -87,6 +89,7 @@ struct CommonResolutionData
         mrpRetryIntervalActive  = NullOptional;
         mrpRetryActiveThreshold = NullOptional;
         isICDOperatingAsLIT     = NullOptional;
+        ttl                     = NullOptional;
         numIPs                  = 0;
         port                    = 0;
         supportsTcp             = false;
@@ -148,6 +151,10 @@ struct CommonResolutionData
         {
             ChipLogDetail(Discovery, "\tICD: not present");
         }
+        if (ttl.HasValue())
+        {
+            ChipLogDetail(Discovery, "\tTTL: %" PRIu32 " s", ttl.Value().count());
+        }
     }
 };
 
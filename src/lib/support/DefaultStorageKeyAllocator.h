@@ -202,12 +202,21 @@ public:
     // Event number counter.
     static StorageKeyName IMEventNumber() { return StorageKeyName::FromConst("g/im/ec"); }
 
+    // Persistent event log: index of the segments, and segments.
+    static StorageKeyName IMEventLogIndex() { return StorageKeyName::FromConst("g/im/el"); }
+    static StorageKeyName IMEventLogSegment(uint32_t id) { return StorageKeyName::Formatted("g/im/el/%" PRIx32, id); }
+
     // Subscription resumption
     static StorageKeyName SubscriptionResumption(size_t index)
     {
         return StorageKeyName::Formatted("g/su/%x", static_cast<unsigned>(index));
     }
     static StorageKeyName SubscriptionResumptionMaxCount() { return StorageKeyName::Formatted("g/sum"); }
+    static StorageKeyName SubscriptionResumptionIndex() { return StorageKeyName::FromConst("g/sui"); }
+    static StorageKeyName SubscriptionResumptionPathList(size_t index)
+    {
+        return StorageKeyName::Formatted("g/sup/%x", static_cast<unsigned>(index));
+    }
 
     // Number of scenes stored in a given endpoint's scene table, across all fabrics.
     static StorageKeyName EndpointSceneCountKey(EndpointId endpoint) { return StorageKeyName::Formatted("g/scc/e/%x", endpoint); }
@@ -21,11 +21,13 @@
  *
  */
 
+#include <algorithm>
 #include <errno.h>
 #include <inttypes.h>
 
 #include <lib/support/BitFlags.h>
 #include <lib/support/CHIPFaultInjection.h>
+#include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/logging/CHIPLogging.h>
 #include <messaging/ErrorCategory.h>
@@ -35,6 +37,7 @@
 #include <messaging/ReliableMessageContext.h>
 #include <messaging/ReliableMessageMgr.h>
 #include <platform/ConnectivityManager.h>
+#include <system/SystemStats.h>
 
 #if CHIP_CONFIG_ENABLE_ICD_SERVER
 #include <app/icd/ICDConfigurationData.h> // nogncheck
@@ -47,14 +50,16 @@ namespace chip {
 namespace Messaging {
 
 ReliableMessageMgr::RetransTableEntry::RetransTableEntry(ReliableMessageContext * rc) :
-    ec(*rc->GetExchangeContext()), nextRetransTime(0), sendCount(0)
+    ec(*rc->GetExchangeContext()), nextRetransTime(0), sendCount(0), retransQueueIndex(kNotInRetransQueue)
 {
     ec->SetWaitingForAck(true);
+    SYSTEM_STATS_INCREMENT(chip::System::Stats::kExchangeMgr_NumRetransEntries);
 }
 
 ReliableMessageMgr::RetransTableEntry::~RetransTableEntry()
 {
     ec->SetWaitingForAck(false);
+    SYSTEM_STATS_DECREMENT(chip::System::Stats::kExchangeMgr_NumRetransEntries);
 }
 
 ReliableMessageMgr::ReliableMessageMgr(ObjectPool<ExchangeContext, CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS> & contextPool) :
@@ -73,10 +78,16 @@ void ReliableMessageMgr::Shutdown()
     StopTimer();
 
     // Clear the retransmit table
+    mRetransQueueSize = 0;
     mRetransTable.ForEachActiveObject([&](auto * entry) {
         mRetransTable.ReleaseObject(entry);
         return Loop::Continue;
     });
+#if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+    Platform::MemoryFree(mRetransQueue);
+    mRetransQueue         = nullptr;
+    mRetransQueueCapacity = 0;
+#endif // CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
 
     mSystemLayer = nullptr;
 }
@@ -118,10 +129,12 @@ void ReliableMessageMgr::ExecuteActions()
         }
     });
 
-    // Retransmit / cancel anything in the retrans table whose retrans timeout has expired
-    mRetransTable.ForEachActiveObject([&](auto * entry) {
-        if (entry->nextRetransTime > now)
-            return Loop::Continue;
+    // Retransmit / cancel anything in the retrans table whose retrans timeout has expired.  Entries come out of the queue
+    // in nextRetransTime order, so we are done at the first one that is not due.  Each entry handled here is either
+    // released or rescheduled, and handling it may clear other entries, so always look at the head of the queue again.
+    while (mRetransQueueSize > 0 && mRetransQueue[0]->nextRetransTime <= now)
+    {
+        RetransTableEntry * entry = mRetransQueue[0];
 
         VerifyOrDie(!entry->retainedBuf.IsNull());
 
@@ -157,9 +170,9 @@ void ReliableMessageMgr::ExecuteActions()
             }
 
             // Do not StartTimer, we will schedule the timer at the end of the timer handler.
-            mRetransTable.ReleaseObject(entry);
+            ReleaseRetransEntry(*entry);
 
-            return Loop::Continue;
+            continue;
         }
 
         entry->sendCount++;
@@ -167,12 +180,11 @@ void ReliableMessageMgr::ExecuteActions()
                         "Retransmitting MessageCounter:" ChipLogFormatMessageCounter " on exchange " ChipLogFormatExchange
                         " Send Cnt %d",
                         messageCounter, ChipLogValueExchange(&entry->ec.Get()), entry->sendCount);
+        SYSTEM_STATS_COUNT_RETRANSMISSION();
 
         CalculateNextRetransTime(*entry);
         SendFromRetransTable(entry);
-
-        return Loop::Continue;
-    });
+    }
 
     TicklessDebugDumpRetransTable("ReliableMessageMgr::ExecuteActions Dumping mRetransTable entries after processing");
 }
@@ -198,7 +210,14 @@ CHIP_ERROR ReliableMessageMgr::AddToRetransTable(ReliableMessageContext * rc, Re
 {
     VerifyOrDie(!rc->IsWaitingForAck());
 
-    *rEntry = mRetransTable.CreateObject(rc);
+#if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+    // Every entry may end up in the retransmission queue, so make sure it can be scheduled before creating it.
+    *rEntry = nullptr;
+    if (ReserveRetransQueueSlot() == CHIP_NO_ERROR)
+#endif // CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+    {
+        *rEntry = mRetransTable.CreateObject(rc);
+    }
     if (*rEntry == nullptr)
     {
         ChipLogError(ExchangeManager, "mRetransTable Already Full");
@@ -269,6 +288,9 @@ System::Clock::Timestamp ReliableMessageMgr::GetBackoff(System::Clock::Timestamp
 
 void ReliableMessageMgr::StartRetransmision(RetransTableEntry * entry)
 {
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    entry->firstSendTime = System::SystemClock().GetMonotonicTimestamp();
+#endif // CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
     CalculateNextRetransTime(*entry);
     StartTimer();
 }
@@ -279,6 +301,11 @@ bool ReliableMessageMgr::CheckAndRemRetransTable(ReliableMessageContext * rc, ui
     mRetransTable.ForEachActiveObject([&](auto * entry) {
         if (entry->ec->GetReliableMessageContext() == rc && entry->retainedBuf.GetMessageCounter() == ackMessageCounter)
         {
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+            System::Clock::Milliseconds64 latency = System::SystemClock().GetMonotonicTimestamp() - entry->firstSendTime;
+            SYSTEM_STATS_RECORD_ACK_LATENCY(latency.count());
+#endif // CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
             // Clear the entry from the retransmision table.
             ClearRetransTable(*entry);
 
@@ -363,7 +390,7 @@ void ReliableMessageMgr::ClearRetransTable(ReliableMessageContext * rc)
 
 void ReliableMessageMgr::ClearRetransTable(RetransTableEntry & entry)
 {
-    mRetransTable.ReleaseObject(&entry);
+    ReleaseRetransEntry(entry);
     // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
     StartTimer();
 }
@@ -381,13 +408,10 @@ void ReliableMessageMgr::StartTimer()
     });
 
     // When do we need to next wake up for ReliableMessageProtocol retransmit?
-    mRetransTable.ForEachActiveObject([&](auto * entry) {
-        if (entry->nextRetransTime < nextWakeTime)
-        {
-            nextWakeTime = entry->nextRetransTime;
-        }
-        return Loop::Continue;
-    });
+    if (mRetransQueueSize > 0 && mRetransQueue[0]->nextRetransTime < nextWakeTime)
+    {
+        nextWakeTime = mRetransQueue[0]->nextRetransTime;
+    }
 
     StopTimer();
 
@@ -471,8 +495,119 @@ void ReliableMessageMgr::CalculateNextRetransTime(RetransTableEntry & entry)
 
     System::Clock::Timestamp backoff = ReliableMessageMgr::GetBackoff(baseTimeout, entry.sendCount);
     entry.nextRetransTime            = System::SystemClock().GetMonotonicTimestamp() + backoff;
+    ScheduleRetrans(entry);
+}
+
+void ReliableMessageMgr::ScheduleRetrans(RetransTableEntry & entry)
+{
+    if (entry.retransQueueIndex == kNotInRetransQueue)
+    {
+        // AddToRetransTable makes sure that there is a slot for every entry.
+#if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+        VerifyOrDie(mRetransQueueSize < mRetransQueueCapacity);
+#else
+        VerifyOrDie(mRetransQueueSize < CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE);
+#endif // CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+        SetRetransQueueSlot(mRetransQueueSize++, &entry);
+        SiftUpRetrans(entry.retransQueueIndex);
+        return;
+    }
+
+    // The time may have moved either way.
+    SiftUpRetrans(entry.retransQueueIndex);
+    SiftDownRetrans(entry.retransQueueIndex);
 }
 
+void ReliableMessageMgr::UnscheduleRetrans(RetransTableEntry & entry)
+{
+    uint16_t index = entry.retransQueueIndex;
+    VerifyOrReturn(index != kNotInRetransQueue);
+
+    entry.retransQueueIndex = kNotInRetransQueue;
+    mRetransQueueSize--;
+    if (index == mRetransQueueSize)
+    {
+        return;
+    }
+
+    // Fill the hole with the last entry, which may belong either above or below it.
+    RetransTableEntry * moved = mRetransQueue[mRetransQueueSize];
+    SetRetransQueueSlot(index, moved);
+    SiftUpRetrans(index);
+    SiftDownRetrans(moved->retransQueueIndex);
+}
+
+void ReliableMessageMgr::SiftUpRetrans(uint16_t index)
+{
+    RetransTableEntry * entry = mRetransQueue[index];
+    while (index > 0)
+    {
+        uint16_t parent = static_cast<uint16_t>((index - 1) / 2);
+        if (mRetransQueue[parent]->nextRetransTime <= entry->nextRetransTime)
+        {
+            break;
+        }
+        SetRetransQueueSlot(index, mRetransQueue[parent]);
+        index = parent;
+    }
+    SetRetransQueueSlot(index, entry);
+}
+
+void ReliableMessageMgr::SiftDownRetrans(uint16_t index)
+{
+    RetransTableEntry * entry = mRetransQueue[index];
+    while (true)
+    {
+        uint32_t child = 2 * static_cast<uint32_t>(index) + 1;
+        if (child >= mRetransQueueSize)
+        {
+            break;
+        }
+        if (child + 1 < mRetransQueueSize && mRetransQueue[child + 1]->nextRetransTime < mRetransQueue[child]->nextRetransTime)
+        {
+            child++;
+        }
+        if (entry->nextRetransTime <= mRetransQueue[child]->nextRetransTime)
+        {
+            break;
+        }
+        SetRetransQueueSlot(index, mRetransQueue[child]);
+        index = static_cast<uint16_t>(child);
+    }
+    SetRetransQueueSlot(index, entry);
+}
+
+void ReliableMessageMgr::SetRetransQueueSlot(uint16_t index, RetransTableEntry * entry)
+{
+    mRetransQueue[index]     = entry;
+    entry->retransQueueIndex = index;
+}
+
+void ReliableMessageMgr::ReleaseRetransEntry(RetransTableEntry & entry)
+{
+    UnscheduleRetrans(entry);
+    mRetransTable.ReleaseObject(&entry);
+}
+
+#if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+CHIP_ERROR ReliableMessageMgr::ReserveRetransQueueSlot()
+{
+    size_t needed = mRetransTable.Allocated() + 1;
+    VerifyOrReturnError(needed > mRetransQueueCapacity, CHIP_NO_ERROR);
+    VerifyOrReturnError(needed < kNotInRetransQueue, CHIP_ERROR_NO_MEMORY);
+
+    // Grow geometrically, so that a burst of new exchanges does not reallocate the queue each time.
+    size_t capacity = std::min<size_t>(std::max<size_t>(needed, 2 * static_cast<size_t>(mRetransQueueCapacity)),
+                                       kNotInRetransQueue - 1);
+    auto * queue = static_cast<RetransTableEntry **>(Platform::MemoryRealloc(mRetransQueue, capacity * sizeof(*mRetransQueue)));
+    VerifyOrReturnError(queue != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    mRetransQueue         = queue;
+    mRetransQueueCapacity = static_cast<uint16_t>(capacity);
+    return CHIP_NO_ERROR;
+}
+#endif // CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+
 #if CHIP_CONFIG_TEST
 int ReliableMessageMgr::TestGetCountRetransTable()
 {
@@ -483,6 +618,12 @@ int ReliableMessageMgr::TestGetCountRetransTable()
     });
     return count;
 }
+
+void ReliableMessageMgr::TestSetNextRetransTime(RetransTableEntry & entry, System::Clock::Timestamp nextRetransTime)
+{
+    entry.nextRetransTime = nextRetransTime;
+    ScheduleRetrans(entry);
+}
 #endif // CHIP_CONFIG_TEST
 
 } // namespace Messaging
@@ -65,6 +65,11 @@ public:
         System::Clock::Timestamp nextRetransTime; /**< A counter representing the next retransmission time for the message. */
         uint8_t sendCount;                        /**< The number of times we have tried to send this entry,
                                                        including both successfully and failure send. */
+        uint16_t retransQueueIndex;               /**< Position of the entry in the retransmission queue, or
+                                                       kNotInRetransQueue if it has not been scheduled. */
+#if CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
+        System::Clock::Timestamp firstSendTime; /**< When the message was first sent, to measure the ack latency. */
+#endif // CHIP_SYSTEM_CONFIG_PROVIDE_STATISTICS
     };
 
     ReliableMessageMgr(ObjectPool<ExchangeContext, CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS> & contextPool);
@@ -74,7 +79,7 @@ public:
     void Shutdown();
 
     /**
-     * Iterate through active exchange contexts and retrans table entries.  If an
+     * Iterate through active exchange contexts and due retrans table entries.  If an
      * action needs to be triggered by ReliableMessageProtocol time facilities,
      * execute that action.
      */
@@ -124,7 +129,7 @@ public:
     void StartRetransmision(RetransTableEntry * entry);
 
     /**
-     *  Iterate through active exchange contexts and retrans table entries. Clear the entry matching
+     *  Iterate through retrans table entries. Clear the entry matching
      *  the specified ExchangeContext and the message ID from the retransmision table.
      *
      *  @param[in]    rc                 A pointer to the ExchangeContext object.
@@ -160,7 +165,7 @@ public:
     void ClearRetransTable(RetransTableEntry & rEntry);
 
     /**
-     * Iterate through active exchange contexts and retrans table entries.
+     * Iterate through active exchange contexts and look at the earliest retransmission.
      * Determine how many ReliableMessageProtocol ticks we need to sleep before we
      * need to physically wake the CPU to perform an action.  Set a timer to go off
      * when we next need to wake the system.
@@ -203,6 +208,13 @@ public:
     {
         mRetransTable.ForEachActiveObject(std::forward<F>(functor));
     }
+
+    // Set the next retransmission time of an entry and move it to its new
+    // place in the retransmission queue, without restarting the timer.
+    void TestSetNextRetransTime(RetransTableEntry & entry, System::Clock::Timestamp nextRetransTime);
+
+    // The entry that is due first, or nullptr if nothing is scheduled.
+    RetransTableEntry * TestGetNextRetrans() { return (mRetransQueueSize > 0) ? mRetransQueue[0] : nullptr; }
 #endif // CHIP_CONFIG_TEST
 
 private:
@@ -214,6 +226,29 @@ private:
      */
     void CalculateNextRetransTime(RetransTableEntry & entry);
 
+    static constexpr uint16_t kNotInRetransQueue = UINT16_MAX;
+    static_assert(CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE < kNotInRetransQueue, "Retransmission queue index does not fit in uint16_t");
+
+    /**
+     * Add the entry to the retransmission queue, or move it to its new position if it is there already.  Must be called
+     * whenever the nextRetransTime of the entry changes.
+     */
+    void ScheduleRetrans(RetransTableEntry & entry);
+    /**
+     * Remove the entry from the retransmission queue, if it is there.
+     */
+    void UnscheduleRetrans(RetransTableEntry & entry);
+    void SiftUpRetrans(uint16_t index);
+    void SiftDownRetrans(uint16_t index);
+    void SetRetransQueueSlot(uint16_t index, RetransTableEntry * entry);
+    void ReleaseRetransEntry(RetransTableEntry & entry);
+#if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+    /**
+     * Make room in the retransmission queue for one more entry than mRetransTable holds now.
+     */
+    CHIP_ERROR ReserveRetransQueueSlot();
+#endif // CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+
     ObjectPool<ExchangeContext, CHIP_CONFIG_MAX_EXCHANGE_CONTEXTS> & mContextPool;
     chip::System::Layer * mSystemLayer;
 
@@ -232,6 +267,16 @@ private:
     // ReliableMessageProtocol Global tables for timer context
     ObjectPool<RetransTableEntry, CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE> mRetransTable;
 
+    // Binary min-heap of the scheduled entries of mRetransTable, by nextRetransTime, so that the next retransmission is
+    // always mRetransQueue[0].  With heap-backed pools, mRetransTable is not bounded, so the queue grows along with it.
+#if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+    RetransTableEntry ** mRetransQueue = nullptr;
+    uint16_t mRetransQueueCapacity     = 0;
+#else
+    RetransTableEntry * mRetransQueue[CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE];
+#endif // CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+    uint16_t mRetransQueueSize = 0;
+
     SessionUpdateDelegate * mSessionUpdateDelegate = nullptr;
 };
 
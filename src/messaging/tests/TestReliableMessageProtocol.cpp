@@ -32,6 +32,7 @@
 #include <messaging/ReliableMessageProtocolConfig.h>
 #include <protocols/Protocols.h>
 #include <protocols/echo/Echo.h>
+#include <system/SystemStats.h>
 #include <transport/SessionManager.h>
 #include <transport/TransportMgr.h>
 
@@ -306,6 +307,12 @@ class TestReliableMessageProtocol
 {
 public:
     static void CheckAddClearRetrans(nlTestSuite * inSuite, void * inContext);
+    static void CheckRetransQueueOrder(nlTestSuite * inSuite, void * inContext);
+    static void CheckRetransQueueRemoveMiddle(nlTestSuite * inSuite, void * inContext);
+    static void CheckRetransQueueReschedule(nlTestSuite * inSuite, void * inContext);
+#if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+    static void CheckRetransTableGrowsWithHeapPool(nlTestSuite * inSuite, void * inContext);
+#endif // CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
     static void CheckResendApplicationMessage(nlTestSuite * inSuite, void * inContext);
     static void CheckCloseExchangeAndResendApplicationMessage(nlTestSuite * inSuite, void * inContext);
     static void CheckFailedMessageRetainOnSend(nlTestSuite * inSuite, void * inContext);
@@ -344,14 +351,188 @@ void TestReliableMessageProtocol::CheckAddClearRetrans(nlTestSuite * inSuite, vo
 
     ReliableMessageMgr::RetransTableEntry * entry;
 
+    SYSTEM_STATS_RESET_HIGH_WATER_MARK_FOR_TESTING(System::Stats::kExchangeMgr_NumRetransEntries);
+
     rm->AddToRetransTable(rc, &entry);
     NL_TEST_ASSERT(inSuite, rm->TestGetCountRetransTable() == 1);
+    NL_TEST_ASSERT(inSuite, SYSTEM_STATS_TEST_IN_USE(System::Stats::kExchangeMgr_NumRetransEntries, 1));
     rm->ClearRetransTable(*entry);
     NL_TEST_ASSERT(inSuite, rm->TestGetCountRetransTable() == 0);
+    NL_TEST_ASSERT(inSuite, SYSTEM_STATS_TEST_IN_USE(System::Stats::kExchangeMgr_NumRetransEntries, 0));
+    NL_TEST_ASSERT(inSuite, SYSTEM_STATS_TEST_HIGH_WATER_MARK(System::Stats::kExchangeMgr_NumRetransEntries, 1));
 
     exchange->Close();
 }
 
+// Retransmission table entries, one per exchange, scheduled directly in the
+// retransmission queue.  The retransmission times are far enough in the
+// future that the retransmission timer never fires while a test runs.
+template <size_t N>
+class RetransQueueEntries
+{
+public:
+    RetransQueueEntries(nlTestSuite * inSuite, TestContext & ctx, MockAppDelegate & delegate) :
+        mSuite(inSuite), mRm(ctx.GetExchangeManager().GetReliableMessageMgr()),
+        mBase(System::SystemClock().GetMonotonicTimestamp() + 1000_s)
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            mExchanges[i] = ctx.NewExchangeToAlice(&delegate);
+            NL_TEST_ASSERT(inSuite, mExchanges[i] != nullptr);
+            CHIP_ERROR err = mRm->AddToRetransTable(mExchanges[i]->GetReliableMessageContext(), &mEntries[i]);
+            NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+        }
+    }
+
+    ~RetransQueueEntries()
+    {
+        for (auto * exchange : mExchanges)
+        {
+            exchange->Close();
+        }
+    }
+
+    ReliableMessageMgr::RetransTableEntry & Entry(size_t i) { return *mEntries[i]; }
+
+    // Schedule entry i to retransmit offset seconds after the base time.
+    void Schedule(size_t i, uint32_t offset)
+    {
+        mRm->TestSetNextRetransTime(*mEntries[i], mBase + System::Clock::Seconds64(offset));
+    }
+
+    // Take entries off the head of the queue until it is empty, checking that
+    // they come out at the expected offsets, in order.
+    template <size_t M>
+    void CheckDrain(const uint32_t (&expectedOffsets)[M])
+    {
+        for (uint32_t offset : expectedOffsets)
+        {
+            ReliableMessageMgr::RetransTableEntry * head = mRm->TestGetNextRetrans();
+            NL_TEST_ASSERT(mSuite, head != nullptr);
+            if (head == nullptr)
+            {
+                return;
+            }
+            NL_TEST_ASSERT(mSuite, head->nextRetransTime == mBase + System::Clock::Seconds64(offset));
+            mRm->ClearRetransTable(*head);
+        }
+        NL_TEST_ASSERT(mSuite, mRm->TestGetNextRetrans() == nullptr);
+        NL_TEST_ASSERT(mSuite, mRm->TestGetCountRetransTable() == 0);
+    }
+
+private:
+    nlTestSuite * mSuite;
+    ReliableMessageMgr * mRm;
+    System::Clock::Timestamp mBase;
+    ExchangeContext * mExchanges[N]                     = {};
+    ReliableMessageMgr::RetransTableEntry * mEntries[N] = {};
+};
+
+void TestReliableMessageProtocol::CheckRetransQueueOrder(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    MockAppDelegate mockAppDelegate(ctx);
+    RetransQueueEntries<9> entries(inSuite, ctx, mockAppDelegate);
+
+    // Schedule out of order, with a tie, so that most insertions have to move up the heap.
+    const uint32_t offsets[] = { 50, 80, 30, 70, 10, 90, 20, 60, 30 };
+    for (size_t i = 0; i < ArraySize(offsets); i++)
+    {
+        entries.Schedule(i, offsets[i]);
+    }
+
+    entries.CheckDrain({ 10, 20, 30, 30, 50, 60, 70, 80, 90 });
+}
+
+void TestReliableMessageProtocol::CheckRetransQueueRemoveMiddle(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    MockAppDelegate mockAppDelegate(ctx);
+    RetransQueueEntries<7> entries(inSuite, ctx, mockAppDelegate);
+    ReliableMessageMgr * rm = ctx.GetExchangeManager().GetReliableMessageMgr();
+
+    // None of these move when inserted, so entry i is at position i of the heap.
+    const uint32_t offsets[] = { 10, 50, 20, 60, 70, 30, 40 };
+    for (size_t i = 0; i < ArraySize(offsets); i++)
+    {
+        entries.Schedule(i, offsets[i]);
+        NL_TEST_ASSERT(inSuite, entries.Entry(i).retransQueueIndex == i);
+    }
+
+    // Removing an inner entry puts the last entry (at 40) in its place, and it has to move down below the entry at 30.
+    rm->ClearRetransTable(entries.Entry(2));
+    NL_TEST_ASSERT(inSuite, entries.Entry(5).retransQueueIndex == 2);
+    NL_TEST_ASSERT(inSuite, entries.Entry(6).retransQueueIndex == 5);
+
+    // Removing a leaf under the entry at 50 puts the entry at 40 in its place, and it has to move up.
+    rm->ClearRetransTable(entries.Entry(3));
+    NL_TEST_ASSERT(inSuite, entries.Entry(6).retransQueueIndex == 1);
+    NL_TEST_ASSERT(inSuite, entries.Entry(1).retransQueueIndex == 3);
+
+    entries.CheckDrain({ 10, 30, 40, 50, 70 });
+}
+
+void TestReliableMessageProtocol::CheckRetransQueueReschedule(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    MockAppDelegate mockAppDelegate(ctx);
+    RetransQueueEntries<7> entries(inSuite, ctx, mockAppDelegate);
+    ReliableMessageMgr * rm = ctx.GetExchangeManager().GetReliableMessageMgr();
+
+    for (size_t i = 0; i < 7; i++)
+    {
+        entries.Schedule(i, static_cast<uint32_t>(10 * (i + 1)));
+    }
+    NL_TEST_ASSERT(inSuite, rm->TestGetNextRetrans() == &entries.Entry(0));
+
+    // Backing off the head moves it down, and the next earliest takes its place.
+    entries.Schedule(0, 75);
+    NL_TEST_ASSERT(inSuite, rm->TestGetNextRetrans() == &entries.Entry(1));
+
+    // An earlier time moves a leaf up, but only as far as it needs to go.
+    entries.Schedule(6, 25);
+    NL_TEST_ASSERT(inSuite, entries.Entry(6).retransQueueIndex == 2);
+    NL_TEST_ASSERT(inSuite, rm->TestGetNextRetrans() == &entries.Entry(1));
+    entries.Schedule(5, 1);
+    NL_TEST_ASSERT(inSuite, rm->TestGetNextRetrans() == &entries.Entry(5));
+
+    // Rescheduling an entry at its current time leaves it where it is.
+    uint16_t index = entries.Entry(3).retransQueueIndex;
+    entries.Schedule(3, 40);
+    NL_TEST_ASSERT(inSuite, entries.Entry(3).retransQueueIndex == index);
+
+    entries.CheckDrain({ 1, 20, 25, 30, 40, 50, 75 });
+}
+
+#if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+void TestReliableMessageProtocol::CheckRetransTableGrowsWithHeapPool(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    // Heap-backed pools are not bounded by CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE,
+    // so neither is the retransmission queue.
+    constexpr size_t kCount = CHIP_CONFIG_RMP_RETRANS_TABLE_SIZE + 1;
+
+    MockAppDelegate mockAppDelegate(ctx);
+    RetransQueueEntries<kCount> entries(inSuite, ctx, mockAppDelegate);
+    ReliableMessageMgr * rm = ctx.GetExchangeManager().GetReliableMessageMgr();
+    NL_TEST_ASSERT(inSuite, rm->TestGetCountRetransTable() == static_cast<int>(kCount));
+
+    // Schedule in reverse, so that every entry goes to the top of the queue.
+    uint32_t expected[kCount];
+    for (size_t i = 0; i < kCount; i++)
+    {
+        entries.Schedule(i, static_cast<uint32_t>(kCount - i));
+        expected[i] = static_cast<uint32_t>(i + 1);
+    }
+
+    entries.CheckDrain(expected);
+}
+#endif // CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+
 /**
  * Tests MRP retransmission logic with the following scenario:
  *
@@ -2159,6 +2340,14 @@ int TestReliableMessageProtocol::InitializeTestCase(void * inContext)
 
 const nlTest sTests[] = {
     NL_TEST_DEF("Test ReliableMessageMgr::CheckAddClearRetrans", TestReliableMessageProtocol::CheckAddClearRetrans),
+    NL_TEST_DEF("Test ReliableMessageMgr::CheckRetransQueueOrder", TestReliableMessageProtocol::CheckRetransQueueOrder),
+    NL_TEST_DEF("Test ReliableMessageMgr::CheckRetransQueueRemoveMiddle",
+                TestReliableMessageProtocol::CheckRetransQueueRemoveMiddle),
+    NL_TEST_DEF("Test ReliableMessageMgr::CheckRetransQueueReschedule", TestReliableMessageProtocol::CheckRetransQueueReschedule),
+#if CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
+    NL_TEST_DEF("Test ReliableMessageMgr::CheckRetransTableGrowsWithHeapPool",
+                TestReliableMessageProtocol::CheckRetransTableGrowsWithHeapPool),
+#endif // CHIP_SYSTEM_CONFIG_POOL_USE_HEAP
     NL_TEST_DEF("Test ReliableMessageMgr::CheckResendApplicationMessage",
                 TestReliableMessageProtocol::CheckResendApplicationMessage),
     NL_TEST_DEF("Test ReliableMessageMgr::CheckCloseExchangeAndResendApplicationMessage",
@@ -50,3 +50,4 @@ struct ChipDeviceEvent;
 
 // ========== Platform-specific Configuration Overrides =========
 #define CHIP_CONFIG_MDNS_RESOLVE_LOOKUP_RESULTS 5
+#define CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE 64
@@ -24,30 +24,95 @@
 
 #include <platform/DeviceSafeQueue.h>
 
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+
 namespace chip {
 namespace DeviceLayer {
 namespace Internal {
 
-void DeviceSafeQueue::Push(const ChipDeviceEvent & event)
+DeviceSafeQueue::DeviceSafeQueue()
 {
-    std::unique_lock<std::mutex> lock(mEventQueueLock);
-    mEventQueue.push(event);
+    // All the preallocated nodes start on the free list, which mFreeList points to the start of.
+    for (uint32_t i = 0; i + 1 < kNumNodes; i++)
+    {
+        mNodes[i].nextFree.store(i + 1, std::memory_order_relaxed);
+    }
 }
 
-bool DeviceSafeQueue::Empty()
+DeviceSafeQueue::~DeviceSafeQueue()
 {
-    std::unique_lock<std::mutex> lock(mEventQueueLock);
-    return mEventQueue.empty();
+    ChipDeviceEvent event;
+    while (Pop(event))
+    {
+    }
+
+    if (mTail != &mStub)
+    {
+        ReleaseNode(mTail);
+    }
 }
 
-ChipDeviceEvent DeviceSafeQueue::PopFront()
+CHIP_ERROR DeviceSafeQueue::Push(const ChipDeviceEvent & event)
 {
-    std::unique_lock<std::mutex> lock(mEventQueueLock);
+    Node * node = AllocateNode();
+    VerifyOrReturnError(node != nullptr, CHIP_ERROR_NO_MEMORY);
+    node->next.store(nullptr, std::memory_order_relaxed);
+    node->event = event;
+
+    // Until the previous head is linked to the node, the consumer sees the queue end at the previous head.
+    Node * previous = mHead.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+    return CHIP_NO_ERROR;
+}
 
-    const ChipDeviceEvent event = mEventQueue.front();
-    mEventQueue.pop();
+bool DeviceSafeQueue::Pop(ChipDeviceEvent & event)
+{
+    Node * next = mTail->next.load(std::memory_order_acquire);
+    VerifyOrReturnValue(next != nullptr, false);
+
+    event         = next->event;
+    Node * popped = mTail;
+    mTail         = next;
+    if (popped != &mStub)
+    {
+        ReleaseNode(popped);
+    }
+    return true;
+}
+
+DeviceSafeQueue::Node * DeviceSafeQueue::AllocateNode()
+{
+    uint64_t head = mFreeList.load(std::memory_order_acquire);
+    while (FreeListIndex(head) != kNoFreeNode)
+    {
+        Node * node = &mNodes[FreeListIndex(head)];
+        if (mFreeList.compare_exchange_weak(head, FreeListHead(node->nextFree.load(std::memory_order_relaxed), head),
+                                            std::memory_order_acquire, std::memory_order_acquire))
+        {
+            return node;
+        }
+    }
+
+    // Every preallocated node holds an event that the event loop has not consumed yet.
+    return Platform::New<Node>();
+}
+
+void DeviceSafeQueue::ReleaseNode(Node * node)
+{
+    if (node < &mNodes[0] || node >= &mNodes[kNumNodes])
+    {
+        Platform::Delete(node);
+        return;
+    }
 
-    return event;
+    uint32_t index = static_cast<uint32_t>(node - &mNodes[0]);
+    uint64_t head  = mFreeList.load(std::memory_order_relaxed);
+    do
+    {
+        node->nextFree.store(FreeListIndex(head), std::memory_order_relaxed);
+    } while (!mFreeList.compare_exchange_weak(head, FreeListHead(index, head), std::memory_order_release,
+                                              std::memory_order_relaxed));
 }
 
 } // namespace Internal
@@ -24,8 +24,7 @@
 
 #pragma once
 
-#include <mutex>
-#include <queue>
+#include <atomic>
 
 #include <lib/core/CHIPCore.h>
 #include <platform/CHIPDeviceConfig.h>
@@ -39,24 +38,77 @@ namespace Internal {
  *  @class DeviceSafeQueue
  *
  *  @brief
- *      This class represents a thread-safe message queue implemented with C++ Standard Library, the message queue
- *      is used by the CHIP event loop to hold incoming messages. Each message is sequentially dequeued, decoded,
- *      and then an action is performed.
+ *      This class represents a thread-safe message queue used by the CHIP event loop to hold incoming messages. Each
+ *      message is sequentially dequeued, decoded, and then an action is performed.
  *
+ *      Any number of threads may push events, without taking a lock: an event is linked at the head of the queue with a
+ *      single atomic exchange.  Only the CHIP event loop may pop events.
+ *
+ *      Events are held in CHIP_DEVICE_CONFIG_MAX_EVENT_QUEUE_SIZE preallocated nodes, which producers take from a
+ *      lock-free free list.  Only when all of them are in use does Push() allocate a node from the heap, and it fails
+ *      with CHIP_ERROR_NO_MEMORY if that allocation fails.
+ *
+ *      So that a burst of events wakes the event loop only once, the queue also tracks whether a wakeup is pending:
+ *      the producer that gets true from RequestWakeup() signals the event loop, which calls AcknowledgeWakeup() before
+ *      draining the queue.
  */
 class DeviceSafeQueue
 {
 public:
-    DeviceSafeQueue()  = default;
-    ~DeviceSafeQueue() = default;
+    DeviceSafeQueue();
+    ~DeviceSafeQueue();
+
+    CHIP_ERROR Push(const ChipDeviceEvent & event);
 
-    void Push(const ChipDeviceEvent & event);
-    bool Empty();
-    ChipDeviceEvent PopFront();
+    /**
+     * Called by a producer after Push().  Returns true if the event loop must be signaled, i.e. if no other producer
+     * signaled it since it last acknowledged a wakeup.
+     */
+    bool RequestWakeup() { return !mWakeupPending.exchange(true, std::memory_order_acq_rel); }
+
+    /**
+     * Called by the event loop before draining the queue.  Events pushed before a wakeup is acknowledged are visible to
+     * the next Pop(); the producers of later events signal the event loop again.
+     */
+    void AcknowledgeWakeup() { mWakeupPending.exchange(false, std::memory_order_acq_rel); }
+
+    // Only called by the event loop.  Returns false if the queue is empty.
+    bool Pop(ChipDeviceEvent & event);
 
 private:
-    std::queue<ChipDeviceEvent> mEventQueue;
-    std::mutex mEventQueueLock;
+    struct Node
+    {
+        std::atomic<Node *> next{ nullptr };
+        std::atomic<uint32_t> nextFree{ kNoFreeNode }; // Index of the next node of the free list, while on the free list.
+        ChipDeviceEvent event;
+    };
+
+    static constexpr uint32_t kNoFreeNode = UINT32_MAX;
+    static constexpr size_t kNumNodes     = CHIP_DEVICE_CONFIG_MAX_EVENT_QUEUE_SIZE;
+    static_assert(kNumNodes > 0 && kNumNodes < kNoFreeNode, "Node index does not fit in uint32_t");
+
+    // The head of the free list packs the index of the first free node with a counter that changes on every update, so
+    // that a producer that read a stale head cannot swap it back in after other threads took and returned that node.
+    static constexpr uint64_t FreeListHead(uint32_t index, uint64_t previous)
+    {
+        return ((((previous >> 32) + 1) & UINT32_MAX) << 32) | index;
+    }
+    static constexpr uint32_t FreeListIndex(uint64_t head) { return static_cast<uint32_t>(head & UINT32_MAX); }
+
+    Node * AllocateNode();
+    // Only called by the event loop.
+    void ReleaseNode(Node * node);
+
+    // The producers link new nodes after mHead; the consumer pops the node after mTail, which becomes the new mTail.
+    // mTail is a node whose event has been consumed already, initially mStub.
+    std::atomic<Node *> mHead{ &mStub };
+    Node * mTail = &mStub;
+    Node mStub;
+
+    std::atomic<bool> mWakeupPending{ false };
+
+    Node mNodes[kNumNodes];
+    std::atomic<uint64_t> mFreeList{ 0 };
 
     DeviceSafeQueue(const DeviceSafeQueue &)             = delete;
     DeviceSafeQueue & operator=(const DeviceSafeQueue &) = delete;
@@ -55,6 +55,37 @@
 // These are configuration options that are unique to Linux platforms.
 // These can be overridden by the application as needed.
 
+/**
+ * CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+ *
+ * Store the KeyValueStoreManager data as an append-only log (see CHIPLinuxStorageLog.h)
+ * instead of an INI file that is rewritten on every write.  Set by the
+ * chip_linux_kvs_use_log build argument.
+ */
+#ifndef CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+#define CHIP_DEVICE_CONFIG_LINUX_KVS_LOG 0
+#endif // CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+
+/**
+ * CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_SYNC_INTERVAL_MS
+ *
+ * Maximum time a write to the log-structured KVS stays in the page cache before it is
+ * flushed with fdatasync().  Writes made within this window share a single flush.
+ */
+#ifndef CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_SYNC_INTERVAL_MS
+#define CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_SYNC_INTERVAL_MS 50
+#endif // CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_SYNC_INTERVAL_MS
+
+/**
+ * CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_COMPACTION_MIN_SIZE
+ *
+ * Size in bytes below which the log-structured KVS is never compacted.  Above it, the log
+ * is compacted once it is more than twice the size of the live data.
+ */
+#ifndef CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_COMPACTION_MIN_SIZE
+#define CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_COMPACTION_MIN_SIZE (64 * 1024)
+#endif // CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_COMPACTION_MIN_SIZE
+
 // ========== Platform-specific Configuration Overrides =========
 
 #ifndef CHIP_DEVICE_CONFIG_CHIP_TASK_STACK_SIZE
@@ -29,6 +29,9 @@
 #include <lib/support/ScopedBuffer.h>
 #include <platform/PersistedStorage.h>
 
+#include <string>
+#include <vector>
+
 namespace chip {
 namespace DeviceLayer {
 namespace Internal {
@@ -46,6 +49,11 @@ public:
     CHIP_ERROR GetBinaryBlobValue(const char * key, uint8_t * decodedData, size_t bufSize, size_t & decodedDataLen);
     bool HasValue(const char * key);
 
+    /**
+     * Retrieve the (unescaped) names of all keys in the default section.
+     */
+    CHIP_ERROR GetKeys(std::vector<std::string> & keys);
+
 protected:
     CHIP_ERROR AddEntry(const char * key, const char * value);
     CHIP_ERROR RemoveEntry(const char * key);
@@ -0,0 +1,644 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *         Provides a log-structured implementation of the Linux key-value store.
+ *
+ *         File layout: an 8-byte magic followed by records of the form
+ *
+ *             type (1) | key length (2) | value length (4) | CRC-32 (4) | key | value
+ *
+ *         with all integers little-endian and the CRC covering every other field.
+ *         Replay stops at the first truncated or corrupt record, which is how a
+ *         write interrupted by a crash shows up, and the file is cut back to the
+ *         last good record.
+ */
+
+#include <platform/Linux/CHIPLinuxStorageLog.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <lib/core/CHIPEncoding.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <platform/Linux/CHIPLinuxStorageIni.h>
+#include <system/SystemError.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+namespace {
+
+constexpr uint8_t kLogMagic[]   = { 'C', 'H', 'I', 'P', 'K', 'V', 'L', '1' };
+constexpr size_t kLogHeaderSize = sizeof(kLogMagic);
+
+constexpr size_t kRecordHeaderSize  = 11;
+constexpr size_t kRecordCrcOffset   = 7;
+constexpr uint8_t kRecordTypePut    = 1;
+constexpr uint8_t kRecordTypeDelete = 2;
+
+constexpr std::chrono::milliseconds kSyncInterval(CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_SYNC_INTERVAL_MS);
+
+uint32_t Crc32(uint32_t crc, const uint8_t * data, size_t len)
+{
+    static const std::array<uint32_t, 256> sTable = [] {
+        std::array<uint32_t, 256> table;
+        for (uint32_t i = 0; i < table.size(); i++)
+        {
+            uint32_t c = i;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+            }
+            table[i] = c;
+        }
+        return table;
+    }();
+
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++)
+    {
+        crc = sTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+size_t RecordSize(size_t keyLen, size_t valueLen)
+{
+    return kRecordHeaderSize + keyLen + valueLen;
+}
+
+void EncodeRecord(std::vector<uint8_t> & out, uint8_t type, const std::string & key, const void * value, size_t valueLen)
+{
+    const size_t start = out.size();
+    out.resize(start + RecordSize(key.size(), valueLen));
+
+    uint8_t * p = out.data() + start;
+    p[0]        = type;
+    Encoding::LittleEndian::Put16(p + 1, static_cast<uint16_t>(key.size()));
+    Encoding::LittleEndian::Put32(p + 3, static_cast<uint32_t>(valueLen));
+    memcpy(p + kRecordHeaderSize, key.data(), key.size());
+    if (valueLen > 0)
+    {
+        memcpy(p + kRecordHeaderSize + key.size(), value, valueLen);
+    }
+
+    uint32_t crc = Crc32(0, p, kRecordCrcOffset);
+    crc          = Crc32(crc, p + kRecordHeaderSize, key.size() + valueLen);
+    Encoding::LittleEndian::Put32(p + kRecordCrcOffset, crc);
+}
+
+CHIP_ERROR WriteAll(int fd, const uint8_t * data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t written = ::write(fd, data, len);
+        if (written < 0)
+        {
+            VerifyOrReturnError(errno == EINTR, CHIP_ERROR_POSIX(errno));
+            continue;
+        }
+        data += written;
+        len -= static_cast<size_t>(written);
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ReadAll(int fd, uint8_t * data, size_t len, off_t offset)
+{
+    while (len > 0)
+    {
+        ssize_t n = ::pread(fd, data, len, offset);
+        if (n < 0)
+        {
+            VerifyOrReturnError(errno == EINTR, CHIP_ERROR_POSIX(errno));
+            continue;
+        }
+        VerifyOrReturnError(n > 0, CHIP_ERROR_PERSISTED_STORAGE_FAILED);
+        data += n;
+        len -= static_cast<size_t>(n);
+        offset += n;
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ReadFile(const std::string & path, std::vector<uint8_t> & contents)
+{
+    contents.clear();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return (errno == ENOENT) ? CHIP_NO_ERROR : CHIP_ERROR_POSIX(errno);
+    }
+
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    struct stat st;
+    if (::fstat(fd, &st) != 0)
+    {
+        err = CHIP_ERROR_POSIX(errno);
+    }
+    else
+    {
+        contents.resize(static_cast<size_t>(st.st_size));
+        err = ReadAll(fd, contents.data(), contents.size(), 0);
+    }
+    ::close(fd);
+    return err;
+}
+
+// Make a rename() in the directory containing `path` durable.
+CHIP_ERROR SyncParentDirectory(const std::string & path)
+{
+    std::vector<char> pathCopy(path.begin(), path.end());
+    pathCopy.push_back('\0');
+
+    int fd = ::open(::dirname(pathCopy.data()), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    VerifyOrReturnError(fd >= 0, CHIP_ERROR_POSIX(errno));
+    CHIP_ERROR err = (::fsync(fd) == 0) ? CHIP_NO_ERROR : CHIP_ERROR_POSIX(errno);
+    ::close(fd);
+    return err;
+}
+
+/**
+ * Apply the records in `contents` to `index`, returning the length of the valid prefix of the log.
+ */
+size_t ReplayLog(const std::vector<uint8_t> & contents, std::map<std::string, std::vector<uint8_t>> & index)
+{
+    size_t offset = kLogHeaderSize;
+
+    while (contents.size() - offset >= kRecordHeaderSize)
+    {
+        const uint8_t * p       = contents.data() + offset;
+        const uint8_t type      = p[0];
+        const uint16_t keyLen   = Encoding::LittleEndian::Get16(p + 1);
+        const uint32_t valueLen = Encoding::LittleEndian::Get32(p + 3);
+        const uint32_t crc      = Encoding::LittleEndian::Get32(p + kRecordCrcOffset);
+
+        if ((type != kRecordTypePut && type != kRecordTypeDelete) || RecordSize(keyLen, valueLen) > contents.size() - offset)
+        {
+            break;
+        }
+
+        uint32_t computedCrc = Crc32(0, p, kRecordCrcOffset);
+        computedCrc          = Crc32(computedCrc, p + kRecordHeaderSize, keyLen + size_t(valueLen));
+        if (computedCrc != crc)
+        {
+            break;
+        }
+
+        const uint8_t * keyData   = p + kRecordHeaderSize;
+        const uint8_t * valueData = keyData + keyLen;
+        std::string key(reinterpret_cast<const char *>(keyData), keyLen);
+        if (type == kRecordTypePut)
+        {
+            index[key].assign(valueData, valueData + valueLen);
+        }
+        else
+        {
+            index.erase(key);
+        }
+
+        offset += RecordSize(keyLen, valueLen);
+    }
+
+    return offset;
+}
+
+} // namespace
+
+CHIP_ERROR ChipLinuxLogStorage::Init(const char * storeFile)
+{
+    VerifyOrReturnError(storeFile != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    ChipLogDetail(DeviceLayer, "ChipLinuxLogStorage::Init: Using KVS file: %s", storeFile);
+    if (mInitialized)
+    {
+        ChipLogError(DeviceLayer, "ChipLinuxLogStorage::Init: Attempt to re-initialize with KVS file: %s", storeFile);
+        return CHIP_NO_ERROR;
+    }
+
+    mPath.assign(storeFile);
+    mStats = Stats();
+    ReturnErrorOnFailure(Load());
+
+    mStopping    = false;
+    mInitialized = true;
+    mThread      = std::thread(&ChipLinuxLogStorage::BackgroundTask, this);
+
+    return CHIP_NO_ERROR;
+}
+
+void ChipLinuxLogStorage::Shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        VerifyOrReturn(mInitialized);
+        mStopping = true;
+    }
+    mWakeup.notify_all();
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+
+    CHIP_ERROR err = Sync();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DeviceLayer, "Failed to sync KVS file on shutdown: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+
+    std::lock_guard<std::mutex> fileLock(mFileLock);
+    std::lock_guard<std::mutex> lock(mLock);
+    if (mFd >= 0)
+    {
+        ::close(mFd);
+        mFd = -1;
+    }
+    mIndex.clear();
+    mLogSize     = 0;
+    mLiveBytes   = 0;
+    mSyncPending = false;
+    mInitialized = false;
+}
+
+CHIP_ERROR ChipLinuxLogStorage::Load()
+{
+    std::vector<uint8_t> contents;
+    ReturnErrorOnFailure(ReadFile(mPath, contents));
+
+    Index index;
+    if (contents.size() >= kLogHeaderSize && memcmp(contents.data(), kLogMagic, kLogHeaderSize) == 0)
+    {
+        const size_t validSize = ReplayLog(contents, index);
+
+        int fd = ::open(mPath.c_str(), O_RDWR | O_APPEND | O_CLOEXEC);
+        VerifyOrReturnError(fd >= 0, CHIP_ERROR_POSIX(errno));
+        if (validSize < contents.size())
+        {
+            // Most likely a write interrupted by a crash.  Drop it, otherwise records appended
+            // after it would never be replayed.
+            ChipLogError(DeviceLayer, "KVS file %s: discarding %u bytes of incomplete or corrupt records", mPath.c_str(),
+                         static_cast<unsigned>(contents.size() - validSize));
+            if (::ftruncate(fd, static_cast<off_t>(validSize)) != 0 || ::fsync(fd) != 0)
+            {
+                CHIP_ERROR err = CHIP_ERROR_POSIX(errno);
+                ::close(fd);
+                return err;
+            }
+        }
+
+        mIndex     = std::move(index);
+        mFd        = fd;
+        mLogSize   = validSize;
+        mLiveBytes = kLogHeaderSize;
+        for (const auto & entry : mIndex)
+        {
+            mLiveBytes += RecordSize(entry.first.size(), entry.second.size());
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    // Either a new store, or one written by ChipLinuxStorage: start a fresh log from its contents.
+    if (!contents.empty())
+    {
+        ReturnErrorOnFailure(ImportIniFile(index));
+        ChipLogProgress(DeviceLayer, "KVS file %s: converting %u keys from INI format", mPath.c_str(),
+                        static_cast<unsigned>(index.size()));
+    }
+
+    mLiveBytes = kLogHeaderSize;
+    for (const auto & entry : index)
+    {
+        mLiveBytes += RecordSize(entry.first.size(), entry.second.size());
+    }
+    ReturnErrorOnFailure(ReplaceLog(index, 0));
+    mIndex = std::move(index);
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ChipLinuxLogStorage::ImportIniFile(Index & index)
+{
+    ChipLinuxStorageIni ini;
+    std::vector<std::string> keys;
+
+    ReturnErrorOnFailure(ini.Init());
+    ReturnErrorOnFailure(ini.AddConfig(mPath));
+    ReturnErrorOnFailure(ini.GetKeys(keys));
+
+    for (const auto & key : keys)
+    {
+        size_t len     = 0;
+        CHIP_ERROR err = ini.GetBinaryBlobValue(key.c_str(), nullptr, 0, len);
+        VerifyOrReturnError(err == CHIP_NO_ERROR || err == CHIP_ERROR_BUFFER_TOO_SMALL, err);
+
+        std::vector<uint8_t> value(len);
+        ReturnErrorOnFailure(ini.GetBinaryBlobValue(key.c_str(), value.data(), value.size(), len));
+        value.resize(len);
+        index[key] = std::move(value);
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ChipLinuxLogStorage::ReadValue(const char * key, void * buf, size_t bufSize, size_t & outLen, size_t offset)
+{
+    VerifyOrReturnError(key != nullptr && (buf != nullptr || bufSize == 0), CHIP_ERROR_INVALID_ARGUMENT);
+
+    std::lock_guard<std::mutex> lock(mLock);
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+
+    auto it = mIndex.find(key);
+    VerifyOrReturnError(it != mIndex.end(), CHIP_ERROR_KEY_NOT_FOUND);
+
+    const std::vector<uint8_t> & value = it->second;
+    VerifyOrReturnError(offset <= value.size(), CHIP_ERROR_INVALID_ARGUMENT);
+
+    const size_t remaining = value.size() - offset;
+    outLen                 = std::min(bufSize, remaining);
+    if (outLen > 0)
+    {
+        memcpy(buf, value.data() + offset, outLen);
+    }
+
+    return (bufSize < remaining) ? CHIP_ERROR_BUFFER_TOO_SMALL : CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ChipLinuxLogStorage::WriteValue(const char * key, const void * data, size_t dataLen)
+{
+    VerifyOrReturnError(key != nullptr && (data != nullptr || dataLen == 0), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(dataLen <= UINT32_MAX, CHIP_ERROR_INVALID_ARGUMENT);
+
+    std::lock_guard<std::mutex> lock(mLock);
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+
+    std::string keyString(key);
+    ReturnErrorOnFailure(AppendRecord(kRecordTypePut, keyString, data, dataLen));
+
+    auto it = mIndex.find(keyString);
+    if (it != mIndex.end())
+    {
+        mLiveBytes -= RecordSize(it->first.size(), it->second.size());
+    }
+    else
+    {
+        it = mIndex.emplace(keyString, std::vector<uint8_t>()).first;
+    }
+
+    const uint8_t * bytes = static_cast<const uint8_t *>(data);
+    it->second.assign(bytes, bytes + dataLen);
+    mLiveBytes += RecordSize(keyString.size(), dataLen);
+    mStats.mLogicalBytes += keyString.size() + dataLen;
+
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ChipLinuxLogStorage::ClearValue(const char * key)
+{
+    VerifyOrReturnError(key != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    std::lock_guard<std::mutex> lock(mLock);
+    VerifyOrReturnError(mInitialized, CHIP_ERROR_INCORRECT_STATE);
+
+    auto it = mIndex.find(key);
+    VerifyOrReturnError(it != mIndex.end(), CHIP_ERROR_KEY_NOT_FOUND);
+
+    ReturnErrorOnFailure(AppendRecord(kRecordTypeDelete, it->first, nullptr, 0));
+
+    mLiveBytes -= RecordSize(it->first.size(), it->second.size());
+    mStats.mLogicalBytes += it->first.size();
+    mIndex.erase(it);
+
+    return CHIP_NO_ERROR;
+}
+
+bool ChipLinuxLogStorage::HasValue(const char * key)
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mInitialized && key != nullptr && mIndex.find(key) != mIndex.end();
+}
+
+CHIP_ERROR ChipLinuxLogStorage::AppendRecord(uint8_t type, const std::string & key, const void * value, size_t valueLen)
+{
+    VerifyOrReturnError(key.size() <= UINT16_MAX, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(mFd >= 0, CHIP_ERROR_INCORRECT_STATE);
+
+    std::vector<uint8_t> record;
+    EncodeRecord(record, type, key, value, valueLen);
+
+    CHIP_ERROR err = WriteAll(mFd, record.data(), record.size());
+    if (err != CHIP_NO_ERROR)
+    {
+        // Do not leave part of a record behind: replay would stop there and lose every later write.
+        if (::ftruncate(mFd, static_cast<off_t>(mLogSize)) != 0)
+        {
+            ChipLogError(DeviceLayer, "Failed to truncate KVS file after a failed write: %" CHIP_ERROR_FORMAT,
+                         CHIP_ERROR_POSIX(errno).Format());
+        }
+        return err;
+    }
+
+    mLogSize += record.size();
+    mStats.mAppendedBytes += record.size();
+    if (!mSyncPending || NeedsCompaction())
+    {
+        mSyncPending = true;
+        mWakeup.notify_one();
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+bool ChipLinuxLogStorage::NeedsCompaction() const
+{
+    // Compacting once at least half of the log is garbage keeps the file within twice the live
+    // size, and each compaction copies no more bytes than were appended since the previous one.
+    return mLogSize >= CHIP_DEVICE_CONFIG_LINUX_KVS_LOG_COMPACTION_MIN_SIZE && mLogSize >= 2 * mLiveBytes;
+}
+
+CHIP_ERROR ChipLinuxLogStorage::Sync()
+{
+    std::lock_guard<std::mutex> fileLock(mFileLock);
+
+    int fd;
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        VerifyOrReturnError(mFd >= 0, CHIP_ERROR_INCORRECT_STATE);
+        VerifyOrReturnError(mSyncPending, CHIP_NO_ERROR);
+        mSyncPending = false;
+        fd           = mFd;
+    }
+
+    // mFileLock keeps fd from being replaced, while writers may keep appending to it.
+    if (::fdatasync(fd) != 0)
+    {
+        CHIP_ERROR err = CHIP_ERROR_POSIX(errno);
+        std::lock_guard<std::mutex> lock(mLock);
+        mSyncPending = true;
+        return err;
+    }
+
+    std::lock_guard<std::mutex> lock(mLock);
+    mStats.mSyncs++;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR ChipLinuxLogStorage::Compact()
+{
+    std::lock_guard<std::mutex> fileLock(mFileLock);
+
+    Index snapshot;
+    size_t snapshotLogSize;
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        VerifyOrReturnError(mFd >= 0, CHIP_ERROR_INCORRECT_STATE);
+        snapshot        = mIndex;
+        snapshotLogSize = mLogSize;
+    }
+
+    return ReplaceLog(snapshot, snapshotLogSize);
+}
+
+/**
+ * Write `snapshot` to a temporary file, carry over any records appended to the current log after
+ * offset `snapshotLogSize`, and atomically replace the current log with it.
+ *
+ * Must be called with mFileLock held (or before the background thread is started).
+ */
+CHIP_ERROR ChipLinuxLogStorage::ReplaceLog(const Index & snapshot, size_t snapshotLogSize)
+{
+    const std::string tmpPath = mPath + ".tmp";
+
+    std::vector<uint8_t> contents(kLogMagic, kLogMagic + kLogHeaderSize);
+    for (const auto & entry : snapshot)
+    {
+        EncodeRecord(contents, kRecordTypePut, entry.first, entry.second.data(), entry.second.size());
+    }
+
+    int fd = ::open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    VerifyOrReturnError(fd >= 0, CHIP_ERROR_POSIX(errno));
+
+    // Most of the data is synced before taking mLock, so writers are only held up by the tail.
+    CHIP_ERROR err = WriteAll(fd, contents.data(), contents.size());
+    if (err == CHIP_NO_ERROR && ::fdatasync(fd) != 0)
+    {
+        err = CHIP_ERROR_POSIX(errno);
+    }
+
+    std::lock_guard<std::mutex> lock(mLock);
+
+    size_t newLogSize = contents.size();
+    if (err == CHIP_NO_ERROR && mFd >= 0 && mLogSize > snapshotLogSize)
+    {
+        std::vector<uint8_t> tail(mLogSize - snapshotLogSize);
+        err = ReadAll(mFd, tail.data(), tail.size(), static_cast<off_t>(snapshotLogSize));
+        if (err == CHIP_NO_ERROR)
+        {
+            err = WriteAll(fd, tail.data(), tail.size());
+        }
+        newLogSize += tail.size();
+    }
+    if (err == CHIP_NO_ERROR && ::fsync(fd) != 0)
+    {
+        err = CHIP_ERROR_POSIX(errno);
+    }
+    if (err == CHIP_NO_ERROR && ::rename(tmpPath.c_str(), mPath.c_str()) != 0)
+    {
+        err = CHIP_ERROR_POSIX(errno);
+    }
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DeviceLayer, "Failed to rewrite KVS file %s: %" CHIP_ERROR_FORMAT, mPath.c_str(), err.Format());
+        ::close(fd);
+        ::unlink(tmpPath.c_str());
+        return err;
+    }
+
+    err = SyncParentDirectory(mPath);
+    if (err != CHIP_NO_ERROR)
+    {
+        // The new log is already in place, so carry on; it just may not survive a power loss yet.
+        ChipLogError(DeviceLayer, "Failed to sync directory of KVS file %s: %" CHIP_ERROR_FORMAT, mPath.c_str(), err.Format());
+    }
+
+    if (mFd >= 0)
+    {
+        ::close(mFd);
+    }
+    mFd          = fd;
+    mLogSize     = newLogSize;
+    mSyncPending = false;
+    mStats.mCompactedBytes += newLogSize;
+    mStats.mCompactions++;
+
+    return CHIP_NO_ERROR;
+}
+
+ChipLinuxLogStorage::Stats ChipLinuxLogStorage::GetStats()
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    return mStats;
+}
+
+void ChipLinuxLogStorage::BackgroundTask()
+{
+    std::unique_lock<std::mutex> lock(mLock);
+
+    while (!mStopping)
+    {
+        if (!mSyncPending && !NeedsCompaction())
+        {
+            mWakeup.wait(lock);
+            continue;
+        }
+
+        // Let further writes accumulate so that they share a single fdatasync().  Writes are in the
+        // page cache as soon as they return, so only a power loss within this window can drop them.
+        mWakeup.wait_for(lock, kSyncInterval, [this] { return mStopping; });
+
+        const bool compact = NeedsCompaction();
+        lock.unlock();
+
+        CHIP_ERROR err = compact ? Compact() : Sync();
+        if (compact && err != CHIP_NO_ERROR)
+        {
+            err = Sync();
+        }
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(DeviceLayer, "Failed to sync KVS file: %" CHIP_ERROR_FORMAT, err.Format());
+        }
+
+        lock.lock();
+    }
+}
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -0,0 +1,138 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *         This file defines a log-structured key-value store for Linux.
+ *
+ *         Every write appends a single put or delete record to the store file
+ *         instead of rewriting it, and an in-memory index serves all reads.
+ *         A background thread batches fdatasync() calls and compacts the log
+ *         into a snapshot of the live keys once it has accumulated enough
+ *         overwritten or deleted records.
+ *
+ *         A store file in the INI format used by ChipLinuxStorage is imported
+ *         on first use and rewritten as a log.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <lib/core/CHIPError.h>
+#include <platform/CHIPDeviceConfig.h>
+
+namespace chip {
+namespace DeviceLayer {
+namespace Internal {
+
+class ChipLinuxLogStorage
+{
+public:
+    /**
+     * Counters describing how much data has been written to disk, used to measure
+     * write amplification: (mAppendedBytes + mCompactedBytes) / mLogicalBytes.
+     */
+    struct Stats
+    {
+        // Key and value bytes passed to WriteValue() / ClearValue().
+        uint64_t mLogicalBytes = 0;
+        // Record bytes appended to the log, including record headers.
+        uint64_t mAppendedBytes = 0;
+        // Bytes written while compacting the log.
+        uint64_t mCompactedBytes = 0;
+        uint32_t mCompactions    = 0;
+        uint32_t mSyncs          = 0;
+    };
+
+    ChipLinuxLogStorage() = default;
+    ~ChipLinuxLogStorage() { Shutdown(); }
+
+    ChipLinuxLogStorage(const ChipLinuxLogStorage &)             = delete;
+    ChipLinuxLogStorage & operator=(const ChipLinuxLogStorage &) = delete;
+
+    CHIP_ERROR Init(const char * storeFile);
+
+    /**
+     * Stop the background thread, flush any pending writes to disk and close the store file.
+     */
+    void Shutdown();
+
+    /**
+     * Read a value, starting at `offset`.
+     *
+     * @retval CHIP_ERROR_KEY_NOT_FOUND     if the key does not exist.
+     * @retval CHIP_ERROR_INVALID_ARGUMENT  if the offset is past the end of the value.
+     * @retval CHIP_ERROR_BUFFER_TOO_SMALL  if only part of the value fit in `buf`; `outLen` is the number of bytes copied.
+     */
+    CHIP_ERROR ReadValue(const char * key, void * buf, size_t bufSize, size_t & outLen, size_t offset = 0);
+    CHIP_ERROR WriteValue(const char * key, const void * data, size_t dataLen);
+    CHIP_ERROR ClearValue(const char * key);
+    bool HasValue(const char * key);
+
+    /**
+     * Make all writes so far durable without waiting for the background thread.
+     */
+    CHIP_ERROR Sync();
+
+    /**
+     * Rewrite the log so that it only contains the live keys.  This is normally done by
+     * the background thread once the log is large enough, see NeedsCompaction().
+     */
+    CHIP_ERROR Compact();
+
+    Stats GetStats();
+
+private:
+    using Index = std::map<std::string, std::vector<uint8_t>>;
+
+    bool NeedsCompaction() const;
+    CHIP_ERROR Load();
+    CHIP_ERROR ImportIniFile(Index & index);
+    CHIP_ERROR AppendRecord(uint8_t type, const std::string & key, const void * value, size_t valueLen);
+    CHIP_ERROR ReplaceLog(const Index & snapshot, size_t snapshotLogSize);
+    void BackgroundTask();
+
+    // Protects everything below, including appends to mFd.
+    std::mutex mLock;
+    // Serialises operations which replace or sync the store file, so that the background thread
+    // can fdatasync() without holding mLock.  Must be acquired before mLock.
+    std::mutex mFileLock;
+    std::condition_variable mWakeup;
+    std::thread mThread;
+
+    Index mIndex;
+    std::string mPath;
+    int mFd = -1;
+    // Current size of the log file and the size it would have after compaction.
+    size_t mLogSize   = 0;
+    size_t mLiveBytes = 0;
+    bool mSyncPending = false;
+    bool mStopping    = false;
+    bool mInitialized = false;
+    Stats mStats;
+};
+
+} // namespace Internal
+} // namespace DeviceLayer
+} // namespace chip
@@ -36,6 +36,42 @@ namespace PersistedStorage {
 
 KeyValueStoreManagerImpl KeyValueStoreManagerImpl::sInstance;
 
+#if CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+
+CHIP_ERROR KeyValueStoreManagerImpl::_Get(const char * key, void * value, size_t value_size, size_t * read_bytes_size,
+                                          size_t offset_bytes)
+{
+    size_t read_size = 0;
+
+    VerifyOrReturnError(value != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    // The log storage serves partial and offset reads straight from its in-memory index.
+    CHIP_ERROR err = mStorage.ReadValue(key, value, value_size, read_size, offset_bytes);
+    if (err == CHIP_ERROR_KEY_NOT_FOUND)
+    {
+        return CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND;
+    }
+    if ((err == CHIP_NO_ERROR || err == CHIP_ERROR_BUFFER_TOO_SMALL) && read_bytes_size != nullptr)
+    {
+        *read_bytes_size = read_size;
+    }
+    return err;
+}
+
+CHIP_ERROR KeyValueStoreManagerImpl::_Put(const char * key, const void * value, size_t value_size)
+{
+    // A single appended record; durability is batched by the storage's background thread.
+    return mStorage.WriteValue(key, value, value_size);
+}
+
+CHIP_ERROR KeyValueStoreManagerImpl::_Delete(const char * key)
+{
+    CHIP_ERROR err = mStorage.ClearValue(key);
+    return (err == CHIP_ERROR_KEY_NOT_FOUND) ? CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND : err;
+}
+
+#else // CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+
 CHIP_ERROR KeyValueStoreManagerImpl::_Get(const char * key, void * value, size_t value_size, size_t * read_bytes_size,
                                           size_t offset_bytes)
 {
@@ -110,6 +146,8 @@ exit:
     return err;
 }
 
+#endif // CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+
 } // namespace PersistedStorage
 } // namespace DeviceLayer
 } // namespace chip
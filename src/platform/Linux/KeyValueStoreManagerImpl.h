@@ -23,7 +23,11 @@
 
 #pragma once
 
+#include <platform/CHIPDeviceConfig.h>
 #include <platform/Linux/CHIPLinuxStorage.h>
+#if CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+#include <platform/Linux/CHIPLinuxStorageLog.h>
+#endif
 
 namespace chip {
 namespace DeviceLayer {
@@ -42,8 +46,19 @@ public:
     CHIP_ERROR _Delete(const char * key);
     CHIP_ERROR _Put(const char * key, const void * value, size_t value_size);
 
+#if CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+    /**
+     * Write amplification and sync counters of the log-structured backend.
+     */
+    DeviceLayer::Internal::ChipLinuxLogStorage::Stats GetStats() { return mStorage.GetStats(); }
+#endif
+
 private:
+#if CHIP_DEVICE_CONFIG_LINUX_KVS_LOG
+    DeviceLayer::Internal::ChipLinuxLogStorage mStorage;
+#else
     DeviceLayer::Internal::ChipLinuxStorage mStorage;
+#endif
 
     // ===== Members for internal use by the following friends.
     friend KeyValueStoreManager & KeyValueStoreMgr();
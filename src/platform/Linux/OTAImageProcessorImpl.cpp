@@ -21,10 +21,27 @@
 
 #include "OTAImageProcessorImpl.h"
 
+#include <lib/support/CodeUtils.h>
+#include <system/SystemError.h>
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 namespace chip {
 
+OTAImageProcessorImpl::~OTAImageProcessorImpl()
+{
+    StopWorker();
+    if (mFd >= 0)
+    {
+        close(mFd);
+    }
+}
+
 CHIP_ERROR OTAImageProcessorImpl::PrepareDownload()
 {
     if (mImageFile == nullptr)
@@ -63,7 +80,7 @@ CHIP_ERROR OTAImageProcessorImpl::Abort()
 
 CHIP_ERROR OTAImageProcessorImpl::ProcessBlock(ByteSpan & block)
 {
-    if (!mOfs.is_open() || !mOfs.good())
+    if (!mDownloadOpen)
     {
         return CHIP_ERROR_INTERNAL;
     }
@@ -125,19 +142,34 @@ void OTAImageProcessorImpl::HandlePrepareDownload(intptr_t context)
         return;
     }
 
-    unlink(imageProcessor->mImageFile);
-
     imageProcessor->mParams.downloadedBytes = 0;
     imageProcessor->mParams.totalFileBytes  = 0;
     imageProcessor->mHeaderParser.Init();
-    imageProcessor->mOfs.open(imageProcessor->mImageFile, std::ofstream::out | std::ofstream::ate | std::ofstream::app);
-    if (!imageProcessor->mOfs.good())
+    imageProcessor->mHasExpectedDigest = false;
+
+    // Whatever is left of a previous download is dropped.  The worker opens the file after it is done with that
+    // download, and HandleOpenCompleted reports the result to the downloader.
+    imageProcessor->mDownloadOpen = false;
+    imageProcessor->mFetchPending = false;
+    imageProcessor->mGeneration++;
+    imageProcessor->DiscardWrites();
+    imageProcessor->PostJob(JobType::kOpen);
+}
+
+void OTAImageProcessorImpl::HandleOpenCompleted(intptr_t context)
+{
+    auto * imageProcessor = reinterpret_cast<OTAImageProcessorImpl *>(context);
+    VerifyOrReturn(imageProcessor != nullptr && imageProcessor->mDownloader != nullptr);
+
+    CHIP_ERROR error = CHIP_NO_ERROR;
     {
-        imageProcessor->mDownloader->OnPreparedForDownload(CHIP_ERROR_OPEN_FAILED);
-        return;
+        std::lock_guard<std::mutex> lock(imageProcessor->mMutex);
+        VerifyOrReturn(imageProcessor->mOpenGeneration == imageProcessor->mGeneration);
+        error = imageProcessor->mOpenError;
     }
 
-    imageProcessor->mDownloader->OnPreparedForDownload(CHIP_NO_ERROR);
+    imageProcessor->mDownloadOpen = (error == CHIP_NO_ERROR);
+    imageProcessor->mDownloader->OnPreparedForDownload(error);
 }
 
 void OTAImageProcessorImpl::HandleFinalize(intptr_t context)
@@ -148,10 +180,19 @@ void OTAImageProcessorImpl::HandleFinalize(intptr_t context)
         return;
     }
 
-    imageProcessor->mOfs.close();
-    imageProcessor->ReleaseBlock();
+    // The worker writes what is left, checks the image digest and closes the file.
+    VerifyOrReturn(imageProcessor->mDownloadOpen, imageProcessor->ReleaseBlock());
+    imageProcessor->QueueFillBuffer();
+    {
+        std::lock_guard<std::mutex> lock(imageProcessor->mMutex);
+        imageProcessor->mVerifyDigest = imageProcessor->mHasExpectedDigest;
+        memcpy(imageProcessor->mFinalizeDigest, imageProcessor->mExpectedDigest, sizeof(imageProcessor->mFinalizeDigest));
+    }
+    imageProcessor->PostJob(JobType::kFinalize);
 
-    ChipLogProgress(SoftwareUpdate, "OTA image downloaded to %s", imageProcessor->mImageFile);
+    imageProcessor->mDownloadOpen = false;
+    imageProcessor->mFetchPending = false;
+    imageProcessor->ReleaseBlock();
 }
 
 void OTAImageProcessorImpl::HandleApply(intptr_t context)
@@ -162,9 +203,17 @@ void OTAImageProcessorImpl::HandleApply(intptr_t context)
     OTARequestorInterface * requestor = chip::GetRequestorInstance();
     VerifyOrReturn(requestor != nullptr);
 
+    // Finalize() returns before the image is written. Waiting here does not hold up anything, as the event loop is
+    // stopped right after.
+    imageProcessor->WaitForWorkerIdle();
+
     // Move the downloaded image to the location where the new image is to be executed from
     unlink(kImageExecPath);
-    rename(imageProcessor->mImageFile, kImageExecPath);
+    if (rename(imageProcessor->mImageFile, kImageExecPath) != 0)
+    {
+        ChipLogError(SoftwareUpdate, "Cannot move the downloaded image to %s: %s", kImageExecPath, strerror(errno));
+        return;
+    }
     chmod(kImageExecPath, S_IRUSR | S_IWUSR | S_IXUSR | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH);
 
     // Shutdown the stack and expect to boot into the new image once the event loop is stopped
@@ -180,8 +229,12 @@ void OTAImageProcessorImpl::HandleAbort(intptr_t context)
         return;
     }
 
-    imageProcessor->mOfs.close();
-    unlink(imageProcessor->mImageFile);
+    // The worker closes and removes the file once it is done with the jobs that are already running.
+    imageProcessor->mDownloadOpen = false;
+    imageProcessor->mFetchPending = false;
+    imageProcessor->mGeneration++;
+    imageProcessor->DiscardWrites();
+    imageProcessor->PostJob(JobType::kAbort);
     imageProcessor->ReleaseBlock();
 }
 
@@ -199,6 +252,9 @@ void OTAImageProcessorImpl::HandleProcessBlock(intptr_t context)
         return;
     }
 
+    // The download was aborted after the block was received.
+    VerifyOrReturn(imageProcessor->mDownloadOpen);
+
     ByteSpan block   = imageProcessor->mBlock;
     CHIP_ERROR error = imageProcessor->ProcessHeader(block);
     if (error != CHIP_NO_ERROR)
@@ -208,14 +264,79 @@ void OTAImageProcessorImpl::HandleProcessBlock(intptr_t context)
         return;
     }
 
-    if (!imageProcessor->mOfs.write(reinterpret_cast<const char *>(block.data()), static_cast<std::streamsize>(block.size())))
+    error = imageProcessor->AppendBlock(block);
+    if (error != CHIP_NO_ERROR)
     {
+        ChipLogError(SoftwareUpdate, "Cannot buffer block data: %" CHIP_ERROR_FORMAT, error.Format());
         imageProcessor->mDownloader->EndDownload(CHIP_ERROR_WRITE_FAILED);
         return;
     }
 
     imageProcessor->mParams.downloadedBytes += block.size();
-    imageProcessor->mDownloader->FetchNextData();
+
+    // When every buffer is waiting to be written, the next block is fetched once the worker frees one.
+    if (imageProcessor->HasFreeBuffer())
+    {
+        imageProcessor->mDownloader->FetchNextData();
+    }
+    else
+    {
+        imageProcessor->mFetchPending = true;
+    }
+}
+
+void OTAImageProcessorImpl::HandleWriteCompleted(intptr_t context)
+{
+    auto * imageProcessor = reinterpret_cast<OTAImageProcessorImpl *>(context);
+    VerifyOrReturn(imageProcessor != nullptr && imageProcessor->mDownloader != nullptr);
+    VerifyOrReturn(imageProcessor->mDownloadOpen);
+
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    {
+        std::lock_guard<std::mutex> lock(imageProcessor->mMutex);
+        if (imageProcessor->mWriteGeneration == imageProcessor->mGeneration)
+        {
+            error                       = imageProcessor->mWriteError;
+            imageProcessor->mWriteError = CHIP_NO_ERROR;
+        }
+    }
+
+    if (error != CHIP_NO_ERROR)
+    {
+        // The writes queued behind the failed one fail as well, and the download is only ended once.
+        ChipLogError(SoftwareUpdate, "Cannot write OTA image: %" CHIP_ERROR_FORMAT, error.Format());
+        imageProcessor->mDownloadOpen = false;
+        imageProcessor->mFetchPending = false;
+        imageProcessor->mDownloader->EndDownload(CHIP_ERROR_WRITE_FAILED);
+        return;
+    }
+
+    if (imageProcessor->mFetchPending && imageProcessor->HasFreeBuffer())
+    {
+        imageProcessor->mFetchPending = false;
+        imageProcessor->mDownloader->FetchNextData();
+    }
+}
+
+void OTAImageProcessorImpl::HandleFinalizeCompleted(intptr_t context)
+{
+    auto * imageProcessor = reinterpret_cast<OTAImageProcessorImpl *>(context);
+    VerifyOrReturn(imageProcessor != nullptr && imageProcessor->mDownloader != nullptr);
+
+    CHIP_ERROR error = CHIP_NO_ERROR;
+    {
+        std::lock_guard<std::mutex> lock(imageProcessor->mMutex);
+        VerifyOrReturn(imageProcessor->mFinalizeGeneration == imageProcessor->mGeneration);
+        error                          = imageProcessor->mFinalizeError;
+        imageProcessor->mFinalizeError = CHIP_NO_ERROR;
+    }
+
+    // The image file was removed by the worker: the downloader must not go on to apply it.
+    if (error != CHIP_NO_ERROR)
+    {
+        ChipLogError(SoftwareUpdate, "OTA image is unusable, ending the download: %" CHIP_ERROR_FORMAT, error.Format());
+        imageProcessor->mDownloader->EndDownload(error);
+    }
 }
 
 CHIP_ERROR OTAImageProcessorImpl::ProcessHeader(ByteSpan & block)
@@ -230,6 +351,12 @@ CHIP_ERROR OTAImageProcessorImpl::ProcessHeader(ByteSpan & block)
         ReturnErrorOnFailure(error);
 
         mParams.totalFileBytes = header.mPayloadSize;
+        mHasExpectedDigest     = (header.mImageDigestType == OTAImageDigestType::kSha256) &&
+            (header.mImageDigest.size() == sizeof(mExpectedDigest));
+        if (mHasExpectedDigest)
+        {
+            memcpy(mExpectedDigest, header.mImageDigest.data(), sizeof(mExpectedDigest));
+        }
         mHeaderParser.Clear();
     }
 
@@ -276,4 +403,266 @@ CHIP_ERROR OTAImageProcessorImpl::ReleaseBlock()
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR OTAImageProcessorImpl::AppendBlock(ByteSpan block)
+{
+    while (!block.empty())
+    {
+        if (mFillBuffer == nullptr)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (auto & buffer : mBuffers)
+            {
+                if (buffer.free)
+                {
+                    buffer.free   = false;
+                    buffer.length = 0;
+                    mFillBuffer   = &buffer;
+                    break;
+                }
+            }
+        }
+        VerifyOrReturnError(mFillBuffer != nullptr, CHIP_ERROR_NO_MEMORY);
+
+        const size_t length = std::min(block.size(), kWriteBufferSize - mFillBuffer->length);
+        memcpy(&mFillBuffer->data[mFillBuffer->length], block.data(), length);
+        mFillBuffer->length += length;
+        block = block.SubSpan(length);
+
+        if (mFillBuffer->length == kWriteBufferSize)
+        {
+            QueueFillBuffer();
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+void OTAImageProcessorImpl::QueueFillBuffer()
+{
+    VerifyOrReturn(mFillBuffer != nullptr);
+
+    WriteBuffer * buffer = mFillBuffer;
+    mFillBuffer          = nullptr;
+    if (buffer->length == 0)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        buffer->free = true;
+        return;
+    }
+
+    PostJob(JobType::kWrite, static_cast<uint8_t>(buffer - mBuffers));
+}
+
+bool OTAImageProcessorImpl::HasFreeBuffer()
+{
+    // A block of the same size as the last one still fits in the fill buffer.
+    if (mFillBuffer != nullptr && kWriteBufferSize - mFillBuffer->length >= mBlock.size())
+    {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    return std::any_of(std::begin(mBuffers), std::end(mBuffers), [](const WriteBuffer & buffer) { return buffer.free; });
+}
+
+void OTAImageProcessorImpl::DiscardWrites()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (size_t i = 0; i < mJobCount; i++)
+    {
+        const Job & job = mJobs[(mJobHead + i) % ArraySize(mJobs)];
+        if (job.type == JobType::kWrite)
+        {
+            mBuffers[job.buffer].free = true;
+        }
+    }
+    mJobCount = 0;
+
+    if (mFillBuffer != nullptr)
+    {
+        mFillBuffer->free = true;
+        mFillBuffer       = nullptr;
+    }
+}
+
+void OTAImageProcessorImpl::PostJob(JobType type, uint8_t buffer)
+{
+    if (!mWorker.joinable())
+    {
+        mWorker = std::thread(&OTAImageProcessorImpl::WorkerMain, this);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        // At most one job per buffer, plus opening and finalizing or aborting.
+        VerifyOrDie(mJobCount < ArraySize(mJobs));
+        mJobs[(mJobHead + mJobCount) % ArraySize(mJobs)] = Job{ type, buffer, mGeneration };
+        mJobCount++;
+    }
+    mJobCond.notify_one();
+}
+
+void OTAImageProcessorImpl::WaitForWorkerIdle()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mIdleCond.wait(lock, [this] { return mJobCount == 0 && !mWorkerBusy; });
+}
+
+void OTAImageProcessorImpl::StopWorker()
+{
+    VerifyOrReturn(mWorker.joinable());
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopWorker = true;
+    }
+    mJobCond.notify_one();
+    mWorker.join();
+}
+
+void OTAImageProcessorImpl::WorkerMain()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true)
+    {
+        mJobCond.wait(lock, [this] { return mStopWorker || mJobCount > 0; });
+        if (mStopWorker)
+        {
+            break;
+        }
+
+        const Job job = mJobs[mJobHead];
+        mJobHead      = (mJobHead + 1) % ArraySize(mJobs);
+        mJobCount--;
+        mWorkerBusy = true;
+
+        lock.unlock();
+        CHIP_ERROR error = RunJob(job);
+        lock.lock();
+
+        mWorkerBusy = false;
+        if (job.type == JobType::kOpen)
+        {
+            mOpenGeneration = job.generation;
+            mOpenError      = error;
+            DeviceLayer::PlatformMgr().ScheduleWork(HandleOpenCompleted, reinterpret_cast<intptr_t>(this));
+        }
+        else if (job.type == JobType::kWrite)
+        {
+            mBuffers[job.buffer].free = true;
+            if (error != CHIP_NO_ERROR)
+            {
+                mWriteGeneration = job.generation;
+                mWriteError      = error;
+            }
+            DeviceLayer::PlatformMgr().ScheduleWork(HandleWriteCompleted, reinterpret_cast<intptr_t>(this));
+        }
+        else if (job.type == JobType::kFinalize)
+        {
+            mFinalizeGeneration = job.generation;
+            mFinalizeError      = error;
+            DeviceLayer::PlatformMgr().ScheduleWork(HandleFinalizeCompleted, reinterpret_cast<intptr_t>(this));
+        }
+
+        if (mJobCount == 0)
+        {
+            mIdleCond.notify_all();
+        }
+    }
+}
+
+CHIP_ERROR OTAImageProcessorImpl::RunJob(const Job & job)
+{
+    switch (job.type)
+    {
+    case JobType::kOpen:
+        if (mFd >= 0)
+        {
+            close(mFd);
+        }
+        unlink(mImageFile);
+        mFd          = open(mImageFile, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+        mWorkerError = (mFd >= 0) ? mHash.Begin() : CHIP_ERROR_OPEN_FAILED;
+        return mWorkerError;
+
+    case JobType::kWrite:
+        // After a failed write, the download is ended and the next buffers are dropped.
+        if (mWorkerError == CHIP_NO_ERROR)
+        {
+            mWorkerError = WriteToFile(mBuffers[job.buffer]);
+        }
+        return mWorkerError;
+
+    case JobType::kFinalize: {
+        bool verifyDigest;
+        uint8_t expectedDigest[Crypto::kSHA256_Hash_Length];
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            verifyDigest = mVerifyDigest;
+            memcpy(expectedDigest, mFinalizeDigest, sizeof(expectedDigest));
+        }
+
+        if (mWorkerError == CHIP_NO_ERROR && fsync(mFd) != 0)
+        {
+            mWorkerError = CHIP_ERROR_POSIX(errno);
+        }
+        if (mFd >= 0)
+        {
+            close(mFd);
+            mFd = -1;
+        }
+
+        uint8_t digest[Crypto::kSHA256_Hash_Length];
+        MutableByteSpan digestSpan(digest);
+        if (mWorkerError == CHIP_NO_ERROR)
+        {
+            mWorkerError = mHash.Finish(digestSpan);
+        }
+        if (mWorkerError == CHIP_NO_ERROR && verifyDigest && memcmp(digest, expectedDigest, sizeof(digest)) != 0)
+        {
+            mWorkerError = CHIP_ERROR_INTEGRITY_CHECK_FAILED;
+        }
+
+        if (mWorkerError != CHIP_NO_ERROR)
+        {
+            ChipLogError(SoftwareUpdate, "Cannot finalize OTA image: %" CHIP_ERROR_FORMAT, mWorkerError.Format());
+            unlink(mImageFile);
+            return mWorkerError;
+        }
+
+        ChipLogProgress(SoftwareUpdate, "OTA image downloaded to %s", mImageFile);
+        return CHIP_NO_ERROR;
+    }
+
+    case JobType::kAbort:
+        if (mFd >= 0)
+        {
+            close(mFd);
+            mFd = -1;
+        }
+        unlink(mImageFile);
+        return CHIP_NO_ERROR;
+    }
+
+    return CHIP_ERROR_INTERNAL;
+}
+
+CHIP_ERROR OTAImageProcessorImpl::WriteToFile(const WriteBuffer & buffer)
+{
+    VerifyOrReturnError(mFd >= 0, CHIP_ERROR_INCORRECT_STATE);
+
+    size_t written = 0;
+    while (written < buffer.length)
+    {
+        ssize_t result = write(mFd, &buffer.data[written], buffer.length - written);
+        if (result < 0)
+        {
+            VerifyOrReturnError(errno == EINTR, CHIP_ERROR_POSIX(errno));
+            continue;
+        }
+        written += static_cast<size_t>(result);
+    }
+
+    return mHash.AddData(ByteSpan(buffer.data, buffer.length));
+}
+
 } // namespace chip
@@ -19,20 +19,32 @@
 #pragma once
 
 #include <app/clusters/ota-requestor/OTADownloader.h>
+#include <crypto/CHIPCryptoPAL.h>
 #include <lib/core/OTAImageHeader.h>
 #include <platform/CHIPDeviceLayer.h>
 #include <platform/OTAImageProcessor.h>
 
-#include <fstream>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace chip {
 
 // Full file path to where the new image will be executed from post-download
 static char kImageExecPath[] = "/tmp/ota.update";
 
+/**
+ * Writes the downloaded image to a file.
+ *
+ * Blocks are coalesced into large buffers on the event loop, and a worker thread writes the full buffers and hashes the
+ * image, so that a slow disk never stalls message processing.  When all the buffers are waiting to be written, the next
+ * block is not fetched from the OTADownloader until one of them is free again.
+ */
 class OTAImageProcessorImpl : public OTAImageProcessorInterface
 {
 public:
+    ~OTAImageProcessorImpl() override;
+
     //////////// OTAImageProcessorInterface Implementation ///////////////
     CHIP_ERROR PrepareDownload() override;
     CHIP_ERROR Finalize() override;
@@ -46,6 +58,35 @@ public:
     void SetOTAImageFile(const char * imageFile) { mImageFile = imageFile; }
 
 private:
+    friend class TestOTAImageProcessorImpl;
+
+    // Size of the writes to the image file.  Every write but the last one is at an offset that is a multiple of it.
+    static constexpr size_t kWriteBufferSize  = 64 * 1024;
+    static constexpr size_t kWriteBufferCount = 4;
+    static constexpr size_t kWriteAlignment   = 4096;
+
+    enum class JobType : uint8_t
+    {
+        kOpen,
+        kWrite,
+        kFinalize,
+        kAbort,
+    };
+
+    struct Job
+    {
+        JobType type;
+        uint8_t buffer;
+        uint32_t generation;
+    };
+
+    struct WriteBuffer
+    {
+        alignas(kWriteAlignment) uint8_t data[kWriteBufferSize];
+        size_t length = 0;
+        bool free     = true;
+    };
+
     //////////// Actual handlers for the OTAImageProcessorInterface ///////////////
     static void HandlePrepareDownload(intptr_t context);
     static void HandleFinalize(intptr_t context);
@@ -53,8 +94,29 @@ private:
     static void HandleAbort(intptr_t context);
     static void HandleProcessBlock(intptr_t context);
 
+    //////////// Completions of the worker jobs, run on the event loop ///////////////
+    static void HandleOpenCompleted(intptr_t context);
+    static void HandleWriteCompleted(intptr_t context);
+    static void HandleFinalizeCompleted(intptr_t context);
+
     CHIP_ERROR ProcessHeader(ByteSpan & block);
 
+    // Copies the block to the fill buffer, and hands the buffers that are full to the worker.
+    CHIP_ERROR AppendBlock(ByteSpan block);
+    void QueueFillBuffer();
+    bool HasFreeBuffer();
+    // Drops the buffered data and the jobs that the worker did not start.
+    void DiscardWrites();
+
+    // Must be called without holding mMutex.
+    void PostJob(JobType type, uint8_t buffer = 0);
+    void WaitForWorkerIdle();
+    void StopWorker();
+
+    void WorkerMain();
+    CHIP_ERROR RunJob(const Job & job);
+    CHIP_ERROR WriteToFile(const WriteBuffer & buffer);
+
     /**
      * Called to allocate memory for mBlock if necessary and set it to block
      */
@@ -65,11 +127,44 @@ private:
      */
     CHIP_ERROR ReleaseBlock();
 
-    std::ofstream mOfs;
     MutableByteSpan mBlock;
     OTADownloader * mDownloader;
     OTAImageHeaderParser mHeaderParser;
     const char * mImageFile = nullptr;
+
+    // Event loop state.  The generation changes with every download, so that completions of the jobs of an aborted
+    // download are ignored.
+    uint32_t mGeneration      = 0;
+    bool mDownloadOpen        = false;
+    bool mFetchPending        = false;
+    WriteBuffer * mFillBuffer = nullptr;
+    bool mHasExpectedDigest   = false;
+    uint8_t mExpectedDigest[Crypto::kSHA256_Hash_Length];
+
+    // Shared with the worker, guarded by mMutex.
+    std::mutex mMutex;
+    std::condition_variable mJobCond;
+    std::condition_variable mIdleCond;
+    Job mJobs[kWriteBufferCount + 2];
+    size_t mJobHead              = 0;
+    size_t mJobCount             = 0;
+    bool mWorkerBusy             = false;
+    bool mStopWorker             = false;
+    uint32_t mOpenGeneration     = 0;
+    CHIP_ERROR mOpenError        = CHIP_NO_ERROR;
+    uint32_t mWriteGeneration    = 0;
+    CHIP_ERROR mWriteError       = CHIP_NO_ERROR;
+    uint32_t mFinalizeGeneration = 0;
+    CHIP_ERROR mFinalizeError    = CHIP_NO_ERROR;
+    bool mVerifyDigest           = false; // Digest checked by the kFinalize job, copied when it is posted.
+    uint8_t mFinalizeDigest[Crypto::kSHA256_Hash_Length];
+    WriteBuffer mBuffers[kWriteBufferCount];
+
+    // Worker state.
+    std::thread mWorker;
+    int mFd                 = -1;
+    CHIP_ERROR mWorkerError = CHIP_NO_ERROR;
+    Crypto::Hash_SHA256_stream mHash;
 };
 
 } // namespace chip
@@ -0,0 +1,271 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test suite for the log-structured
+ *      Linux key-value store.
+ *
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <nlunit-test.h>
+
+#include <platform/Linux/CHIPLinuxStorage.h>
+#include <platform/Linux/CHIPLinuxStorageLog.h>
+
+using namespace chip;
+using namespace chip::DeviceLayer::Internal;
+
+namespace {
+
+char sStorePath[64];
+
+void RemoveStore()
+{
+    unlink(sStorePath);
+}
+
+off_t FileSize(const char * path)
+{
+    struct stat st;
+    return (stat(path, &st) == 0) ? st.st_size : -1;
+}
+
+// =================================
+//      Unit tests
+// =================================
+
+void TestLogStorage_ReadWrite(nlTestSuite * inSuite, void * inContext)
+{
+    RemoveStore();
+
+    ChipLinuxLogStorage storage;
+    NL_TEST_ASSERT(inSuite, storage.Init(sStorePath) == CHIP_NO_ERROR);
+
+    const char value[] = "0123456789";
+    char buf[16];
+    size_t len = 0;
+
+    NL_TEST_ASSERT(inSuite, storage.ReadValue("key", buf, sizeof(buf), len) == CHIP_ERROR_KEY_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, storage.WriteValue("key", value, 10) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, storage.HasValue("key"));
+
+    NL_TEST_ASSERT(inSuite, storage.ReadValue("key", buf, sizeof(buf), len) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, len == 10 && memcmp(buf, value, 10) == 0);
+
+    // Partial and offset reads.
+    NL_TEST_ASSERT(inSuite, storage.ReadValue("key", buf, 4, len) == CHIP_ERROR_BUFFER_TOO_SMALL);
+    NL_TEST_ASSERT(inSuite, len == 4 && memcmp(buf, value, 4) == 0);
+    NL_TEST_ASSERT(inSuite, storage.ReadValue("key", buf, sizeof(buf), len, 6) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, len == 4 && memcmp(buf, value + 6, 4) == 0);
+    NL_TEST_ASSERT(inSuite, storage.ReadValue("key", buf, sizeof(buf), len, 11) == CHIP_ERROR_INVALID_ARGUMENT);
+
+    // Empty values are valid.
+    NL_TEST_ASSERT(inSuite, storage.WriteValue("empty", nullptr, 0) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, storage.ReadValue("empty", buf, sizeof(buf), len) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, len == 0);
+
+    NL_TEST_ASSERT(inSuite, storage.ClearValue("key") == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, storage.ClearValue("key") == CHIP_ERROR_KEY_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, !storage.HasValue("key"));
+
+    storage.Shutdown();
+}
+
+void TestLogStorage_Reload(nlTestSuite * inSuite, void * inContext)
+{
+    RemoveStore();
+
+    {
+        ChipLinuxLogStorage storage;
+        NL_TEST_ASSERT(inSuite, storage.Init(sStorePath) == CHIP_NO_ERROR);
+        for (uint32_t i = 0; i < 100; i++)
+        {
+            NL_TEST_ASSERT(inSuite, storage.WriteValue("counter", &i, sizeof(i)) == CHIP_NO_ERROR);
+        }
+        NL_TEST_ASSERT(inSuite, storage.WriteValue("deleted", "x", 1) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, storage.ClearValue("deleted") == CHIP_NO_ERROR);
+    }
+
+    ChipLinuxLogStorage storage;
+    NL_TEST_ASSERT(inSuite, storage.Init(sStorePath) == CHIP_NO_ERROR);
+
+    uint32_t counter = 0;
+    size_t len       = 0;
+    NL_TEST_ASSERT(inSuite, storage.ReadValue("counter", &counter, sizeof(counter), len) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, len == sizeof(counter) && counter == 99);
+    NL_TEST_ASSERT(inSuite, !storage.HasValue("deleted"));
+
+    storage.Shutdown();
+}
+
+void TestLogStorage_TornWrite(nlTestSuite * inSuite, void * inContext)
+{
+    RemoveStore();
+
+    off_t goodSize;
+    {
+        ChipLinuxLogStorage storage;
+        NL_TEST_ASSERT(inSuite, storage.Init(sStorePath) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, storage.WriteValue("a", "1", 1) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, storage.WriteValue("b", "2", 1) == CHIP_NO_ERROR);
+        storage.Shutdown();
+        goodSize = FileSize(sStorePath);
+    }
+
+    // Simulate a crash in the middle of appending a record.
+    int fd = open(sStorePath, O_WRONLY | O_APPEND);
+    NL_TEST_ASSERT(inSuite, fd >= 0);
+    const uint8_t partialRecord[] = { 1, 1, 0, 8, 0, 0, 0, 0xde, 0xad };
+    NL_TEST_ASSERT(inSuite, write(fd, partialRecord, sizeof(partialRecord)) == static_cast<ssize_t>(sizeof(partialRecord)));
+    close(fd);
+
+    ChipLinuxLogStorage storage;
+    NL_TEST_ASSERT(inSuite, storage.Init(sStorePath) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, FileSize(sStorePath) == goodSize);
+    NL_TEST_ASSERT(inSuite, storage.HasValue("a") && storage.HasValue("b"));
+
+    // Writes after the discarded tail must survive the next reload.
+    NL_TEST_ASSERT(inSuite, storage.WriteValue("c", "3", 1) == CHIP_NO_ERROR);
+    storage.Shutdown();
+    NL_TEST_ASSERT(inSuite, storage.Init(sStorePath) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, storage.HasValue("c"));
+    storage.Shutdown();
+}
+
+void TestLogStorage_Compaction(nlTestSuite * inSuite, void * inContext)
+{
+    RemoveStore();
+
+    ChipLinuxLogStorage storage;
+    NL_TEST_ASSERT(inSuite, storage.Init(sStorePath) == CHIP_NO_ERROR);
+
+    // Repeatedly overwrite a small working set, as counters and subscription records do.
+    uint8_t value[64];
+    constexpr uint32_t kKeys   = 16;
+    constexpr uint32_t kWrites = 20000;
+    for (uint32_t i = 0; i < kWrites; i++)
+    {
+        char key[16];
+        snprintf(key, sizeof(key), "k%u", static_cast<unsigned>(i % kKeys));
+        memset(value, static_cast<int>(i), sizeof(value));
+        NL_TEST_ASSERT(inSuite, storage.WriteValue(key, value, sizeof(value)) == CHIP_NO_ERROR);
+    }
+    NL_TEST_ASSERT(inSuite, storage.Compact() == CHIP_NO_ERROR);
+
+    ChipLinuxLogStorage::Stats stats = storage.GetStats();
+    NL_TEST_ASSERT(inSuite, stats.mCompactions >= 1);
+
+    // Physical bytes per logical byte: record headers plus compaction copies. The log is compacted once it holds twice
+    // the live bytes, so compacting never copies more than was appended, and the headers add less than half again.
+    NL_TEST_ASSERT(inSuite, stats.mCompactedBytes <= stats.mAppendedBytes);
+    const double amplification =
+        static_cast<double>(stats.mAppendedBytes + stats.mCompactedBytes) / static_cast<double>(stats.mLogicalBytes);
+    NL_TEST_ASSERT(inSuite, amplification < 3.0);
+
+    // The file only holds the live keys after compacting, and they are all still readable.
+    NL_TEST_ASSERT(inSuite, FileSize(sStorePath) < static_cast<off_t>(kKeys * (sizeof(value) + 32) + 8));
+    storage.Shutdown();
+
+    NL_TEST_ASSERT(inSuite, storage.Init(sStorePath) == CHIP_NO_ERROR);
+    size_t len = 0;
+    NL_TEST_ASSERT(inSuite, storage.ReadValue("k15", value, sizeof(value), len) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, len == sizeof(value) && value[0] == static_cast<uint8_t>(kWrites - 1));
+    storage.Shutdown();
+}
+
+void TestLogStorage_ImportIni(nlTestSuite * inSuite, void * inContext)
+{
+    RemoveStore();
+
+    const uint8_t blob[] = { 0x00, 0x01, 0xfe, 0xff };
+    {
+        ChipLinuxStorage ini;
+        NL_TEST_ASSERT(inSuite, ini.Init(sStorePath) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, ini.WriteValueBin("g/fs/c", blob, sizeof(blob)) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, ini.WriteValueBin("key with spaces=", blob, 2) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, ini.Commit() == CHIP_NO_ERROR);
+    }
+
+    ChipLinuxLogStorage storage;
+    NL_TEST_ASSERT(inSuite, storage.Init(sStorePath) == CHIP_NO_ERROR);
+
+    uint8_t buf[8];
+    size_t len = 0;
+    NL_TEST_ASSERT(inSuite, storage.ReadValue("g/fs/c", buf, sizeof(buf), len) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, len == sizeof(blob) && memcmp(buf, blob, sizeof(blob)) == 0);
+    NL_TEST_ASSERT(inSuite, storage.ReadValue("key with spaces=", buf, sizeof(buf), len) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, len == 2 && memcmp(buf, blob, 2) == 0);
+    storage.Shutdown();
+}
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+const nlTest sTests[] = {
+    NL_TEST_DEF("Test LogStorage::ReadWrite", TestLogStorage_ReadWrite),
+    NL_TEST_DEF("Test LogStorage::Reload", TestLogStorage_Reload),
+    NL_TEST_DEF("Test LogStorage::TornWrite", TestLogStorage_TornWrite),
+    NL_TEST_DEF("Test LogStorage::Compaction", TestLogStorage_Compaction),
+    NL_TEST_DEF("Test LogStorage::ImportIni", TestLogStorage_ImportIni),
+    NL_TEST_SENTINEL(),
+};
+
+/**
+ *  Set up the test suite.
+ */
+int TestLinuxLogStorage_Setup(void * inContext)
+{
+    snprintf(sStorePath, sizeof(sStorePath), "/tmp/chip_kvs_log_test_%d", static_cast<int>(getpid()));
+    CHIP_ERROR error = chip::Platform::MemoryInit();
+    if (error != CHIP_NO_ERROR)
+        return FAILURE;
+    return SUCCESS;
+}
+
+/**
+ *  Tear down the test suite.
+ */
+int TestLinuxLogStorage_Teardown(void * inContext)
+{
+    RemoveStore();
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+} // namespace
+
+int TestLinuxLogStorage()
+{
+    nlTestSuite theSuite = { "Linux log storage tests", &sTests[0], TestLinuxLogStorage_Setup, TestLinuxLogStorage_Teardown };
+
+    // Run test suite against one context.
+    nlTestRunner(&theSuite, nullptr);
+    return nlTestRunnerStats(&theSuite);
+}
+
+CHIP_REGISTER_TEST_SUITE(TestLinuxLogStorage)
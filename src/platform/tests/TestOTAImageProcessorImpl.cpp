@@ -0,0 +1,716 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <platform/Linux/OTAImageProcessorImpl.h>
+
+#include <app/clusters/ota-requestor/OTADownloader.h>
+#include <app/clusters/ota-requestor/OTARequestorInterface.h>
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/OTAImageHeader.h>
+#include <lib/core/TLV.h>
+#include <lib/support/BufferWriter.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/Span.h>
+#include <lib/support/TypeTraits.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <platform/CHIPDeviceLayer.h>
+
+#include <nlunit-test.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace chip;
+using namespace chip::DeviceLayer;
+
+namespace {
+
+constexpr size_t kBlockSize = 1024;
+constexpr int kPipeSize     = 64 * 1024;
+
+constexpr auto kTimeout = std::chrono::seconds(5);
+// How long the download has to make no progress to be considered held up by the image processor.
+constexpr auto kStallTimeout = std::chrono::milliseconds(200);
+
+/**
+ * An OTA image whose payload is filled with a pattern, so that a payload written out of order does not match it.
+ */
+class TestImage
+{
+public:
+    CHIP_ERROR Build(size_t payloadSize, bool validDigest = true)
+    {
+        mPayload.resize(payloadSize);
+        for (size_t i = 0; i < payloadSize; i++)
+        {
+            mPayload[i] = static_cast<uint8_t>(i ^ (i >> 8) ^ (i >> 16));
+        }
+
+        uint8_t digest[Crypto::kSHA256_Hash_Length];
+        ReturnErrorOnFailure(Crypto::Hash_SHA256(mPayload.data(), mPayload.size(), digest));
+        if (!validDigest)
+        {
+            digest[0] ^= 0xFF;
+        }
+
+        uint8_t tlv[128];
+        TLV::TLVWriter writer;
+        TLV::TLVType outerType;
+        writer.Init(tlv);
+        ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, outerType));
+        ReturnErrorOnFailure(writer.Put(TLV::ContextTag(0), static_cast<uint16_t>(0xFFF1)));
+        ReturnErrorOnFailure(writer.Put(TLV::ContextTag(1), static_cast<uint16_t>(0x8001)));
+        ReturnErrorOnFailure(writer.Put(TLV::ContextTag(2), static_cast<uint32_t>(2)));
+        ReturnErrorOnFailure(writer.PutString(TLV::ContextTag(3), "2.0"));
+        ReturnErrorOnFailure(writer.Put(TLV::ContextTag(4), static_cast<uint64_t>(payloadSize)));
+        ReturnErrorOnFailure(writer.Put(TLV::ContextTag(8), to_underlying(OTAImageDigestType::kSha256)));
+        ReturnErrorOnFailure(writer.Put(TLV::ContextTag(9), ByteSpan(digest)));
+        ReturnErrorOnFailure(writer.EndContainer(outerType));
+        ReturnErrorOnFailure(writer.Finalize());
+
+        const uint32_t tlvSize = writer.GetLengthWritten();
+        uint8_t fixed[16];
+        Encoding::LittleEndian::BufferWriter fixedWriter(fixed, sizeof(fixed));
+        fixedWriter.Put32(kOTAImageFileIdentifier).Put64(sizeof(fixed) + tlvSize + payloadSize).Put32(tlvSize);
+        VerifyOrReturnError(fixedWriter.Fit(), CHIP_ERROR_BUFFER_TOO_SMALL);
+
+        mImage.assign(fixed, fixed + sizeof(fixed));
+        mImage.insert(mImage.end(), tlv, tlv + tlvSize);
+        mImage.insert(mImage.end(), mPayload.begin(), mPayload.end());
+        return CHIP_NO_ERROR;
+    }
+
+    ByteSpan GetImage() const { return ByteSpan(mImage.data(), mImage.size()); }
+
+    // The part of the payload that is in the first imageSize bytes of the image.
+    ByteSpan GetPayload(size_t imageSize) const
+    {
+        const size_t headerSize = mImage.size() - mPayload.size();
+        return ByteSpan(mPayload.data(), imageSize > headerSize ? imageSize - headerSize : 0);
+    }
+
+private:
+    std::vector<uint8_t> mImage;
+    std::vector<uint8_t> mPayload;
+};
+
+/**
+ * An image file, removed when destroyed.
+ */
+class TestFile
+{
+public:
+    ~TestFile() { unlink(mPath); }
+
+    CHIP_ERROR Create()
+    {
+        int fd = mkstemp(mPath);
+        VerifyOrReturnError(fd >= 0, CHIP_ERROR_OPEN_FAILED);
+        close(fd);
+        return CHIP_NO_ERROR;
+    }
+
+    const char * GetPath() const { return mPath; }
+
+    bool Exists() const { return access(mPath, F_OK) == 0; }
+
+    bool HasContent(ByteSpan content) const
+    {
+        FILE * file = fopen(mPath, "rb");
+        VerifyOrReturnValue(file != nullptr, false);
+
+        std::vector<uint8_t> data(content.size() + 1);
+        const size_t size = fread(data.data(), 1, data.size(), file);
+        fclose(file);
+
+        return ByteSpan(data.data(), size).data_equal(content);
+    }
+
+private:
+    char mPath[32] = "/tmp/ota-image-XXXXXX";
+};
+
+/**
+ * A pipe standing in for the image file, so that the test decides when the writes of the worker complete.  The worker
+ * opens the write end through /proc, which neither removes nor truncates it.
+ */
+class TestPipe
+{
+public:
+    ~TestPipe()
+    {
+        CloseWriteEnd();
+        if (mReader.joinable())
+        {
+            mReader.join();
+        }
+        CloseReadEnd();
+    }
+
+    CHIP_ERROR Open()
+    {
+        VerifyOrReturnError(pipe2(mFds, O_CLOEXEC) == 0, CHIP_ERROR_OPEN_FAILED);
+        VerifyOrReturnError(fcntl(mFds[1], F_SETPIPE_SZ, kPipeSize) >= 0, CHIP_ERROR_OPEN_FAILED);
+        snprintf(mPath, sizeof(mPath), "/proc/self/fd/%d", mFds[1]);
+        return CHIP_NO_ERROR;
+    }
+
+    const char * GetPath() const { return mPath; }
+
+    // Called once the worker has opened the image file, so that the reader sees the end of the file when the worker closes it.
+    void CloseWriteEnd() { Close(mFds[1]); }
+
+    // Writes fail once nothing can read them.
+    void CloseReadEnd() { Close(mFds[0]); }
+
+    void StartReading()
+    {
+        mReader = std::thread([this] {
+            uint8_t buffer[4096];
+            ssize_t result;
+            while ((result = read(mFds[0], buffer, sizeof(buffer))) != 0)
+            {
+                VerifyOrReturn(result > 0 || errno == EINTR);
+                mData.insert(mData.end(), buffer, buffer + std::max<ssize_t>(result, 0));
+            }
+        });
+    }
+
+    // Waits until the worker closes the image file, and returns what it wrote.
+    ByteSpan WaitForClose()
+    {
+        mReader.join();
+        return ByteSpan(mData.data(), mData.size());
+    }
+
+private:
+    static void Close(int & fd)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    int mFds[2]    = { -1, -1 };
+    char mPath[32] = "";
+    std::thread mReader;
+    std::vector<uint8_t> mData;
+};
+
+/**
+ * Hands the image to the image processor block by block, on the event loop, whenever the image processor fetches the next
+ * block.
+ */
+class TestDownloader : public OTADownloader
+{
+public:
+    void SetImage(ByteSpan image)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mImage        = image;
+        mOffset       = 0;
+        mPrepared     = false;
+        mPrepareError = CHIP_NO_ERROR;
+        mEndCount     = 0;
+        mEndReason    = CHIP_NO_ERROR;
+    }
+
+    // Sends the first block, once the image processor is prepared.
+    void Start()
+    {
+        PlatformMgr().ScheduleWork([](intptr_t context) { reinterpret_cast<TestDownloader *>(context)->SendNextBlock(); },
+                                   reinterpret_cast<intptr_t>(this));
+    }
+
+    CHIP_ERROR BeginPrepareDownload() override { return mImageProcessor->PrepareDownload(); }
+
+    CHIP_ERROR OnPreparedForDownload(CHIP_ERROR status) override
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mPrepared     = true;
+        mPrepareError = status;
+        mCond.notify_all();
+        return CHIP_NO_ERROR;
+    }
+
+    void OnDownloadTimeout() override {}
+
+    void EndDownload(CHIP_ERROR reason) override
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mEndCount++;
+        mEndReason = reason;
+        mCond.notify_all();
+    }
+
+    CHIP_ERROR FetchNextData() override { return SendNextBlock(); }
+
+    bool WaitForPrepared(CHIP_ERROR & error)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        VerifyOrReturnValue(mCond.wait_for(lock, kTimeout, [this] { return mPrepared; }), false);
+        error = mPrepareError;
+        return true;
+    }
+
+    bool WaitForEnd(CHIP_ERROR & reason)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        VerifyOrReturnValue(mCond.wait_for(lock, kTimeout, [this] { return mEndCount > 0; }), false);
+        reason = mEndReason;
+        return true;
+    }
+
+    bool WaitForOffset(size_t offset)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        return mCond.wait_for(lock, kTimeout, [this, offset] { return mOffset >= offset; });
+    }
+
+    // Waits until the image processor stops fetching blocks, and returns how much of the image it was sent.
+    size_t WaitForStall()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        size_t offset;
+        do
+        {
+            offset = mOffset;
+        } while (mCond.wait_for(lock, kStallTimeout, [this, offset] { return mOffset != offset; }));
+        return offset;
+    }
+
+    size_t GetEndCount()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mEndCount;
+    }
+
+private:
+    // The offset moves once the block is handed over, so that work scheduled after seeing it runs after the block is processed.
+    CHIP_ERROR SendNextBlock()
+    {
+        ByteSpan block;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            VerifyOrReturnError(mOffset < mImage.size(), CHIP_NO_ERROR);
+            block = mImage.SubSpan(mOffset, std::min(kBlockSize, mImage.size() - mOffset));
+        }
+
+        CHIP_ERROR error = mImageProcessor->ProcessBlock(block);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mOffset += block.size();
+        mCond.notify_all();
+        return error;
+    }
+
+    std::mutex mMutex;
+    std::condition_variable mCond;
+    ByteSpan mImage;
+    size_t mOffset           = 0;
+    bool mPrepared           = false;
+    CHIP_ERROR mPrepareError = CHIP_NO_ERROR;
+    size_t mEndCount         = 0;
+    CHIP_ERROR mEndReason    = CHIP_NO_ERROR;
+};
+
+/**
+ * The image processor only applies an image while an OTA requestor is running.
+ */
+class TestRequestor : public OTARequestorInterface
+{
+public:
+    void Reset() override {}
+    void HandleAnnounceOTAProvider(
+        app::CommandHandler * commandObj, const app::ConcreteCommandPath & commandPath,
+        const app::Clusters::OtaSoftwareUpdateRequestor::Commands::AnnounceOTAProvider::DecodableType & commandData) override
+    {}
+    CHIP_ERROR TriggerImmediateQuery(FabricIndex fabricIndex) override { return CHIP_ERROR_NOT_IMPLEMENTED; }
+    void TriggerImmediateQueryInternal() override {}
+    void DownloadUpdate() override {}
+    void DownloadUpdateDelayedOnUserConsent() override {}
+    void ApplyUpdate() override {}
+    void NotifyUpdateApplied() override {}
+    CHIP_ERROR GetUpdateStateProgressAttribute(EndpointId endpointId, app::DataModel::Nullable<uint8_t> & progress) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+    CHIP_ERROR GetUpdateStateAttribute(EndpointId endpointId, OTAUpdateStateEnum & state) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+    OTAUpdateStateEnum GetCurrentUpdateState() override { return OTAUpdateStateEnum::kApplying; }
+    uint32_t GetTargetVersion() override { return 2; }
+    void CancelImageUpdate() override {}
+    CHIP_ERROR ClearDefaultOtaProviderList(FabricIndex fabricIndex) override { return CHIP_ERROR_NOT_IMPLEMENTED; }
+    void SetCurrentProviderLocation(ProviderLocationType providerLocation) override {}
+    void SetMetadataForProvider(ByteSpan metadataForProvider) override {}
+    void GetProviderLocation(Optional<ProviderLocationType> & providerLocation) override {}
+    CHIP_ERROR AddDefaultOtaProvider(const ProviderLocationType & providerLocation) override { return CHIP_ERROR_NOT_IMPLEMENTED; }
+    ProviderLocationList::Iterator GetDefaultOTAProviderListIterator() override { return mProviders.Begin(); }
+
+private:
+    ProviderLocationList mProviders;
+};
+
+TestRequestor sRequestor;
+OTARequestorInterface * sRequestorInstance = nullptr;
+void (*sPreviousSigPipeHandler)(int);
+
+/**
+ * Work scheduled after the work under test, to know when the event loop has handled the latter.
+ */
+class EventLoopMarker
+{
+public:
+    EventLoopMarker() { PlatformMgr().ScheduleWork(Handle, reinterpret_cast<intptr_t>(this)); }
+
+    bool WaitHandled(std::chrono::milliseconds timeout = kTimeout)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        return mCond.wait_for(lock, timeout, [this] { return mHandled; });
+    }
+
+private:
+    static void Handle(intptr_t context)
+    {
+        auto * marker = reinterpret_cast<EventLoopMarker *>(context);
+        std::lock_guard<std::mutex> lock(marker->mMutex);
+        marker->mHandled = true;
+        marker->mCond.notify_all();
+    }
+
+    std::mutex mMutex;
+    std::condition_variable mCond;
+    bool mHandled = false;
+};
+
+} // namespace
+
+namespace chip {
+
+// The requestor is not part of the platform, so the test provides the instance the image processor looks up.
+void SetRequestorInstance(OTARequestorInterface * instance)
+{
+    sRequestorInstance = instance;
+}
+
+OTARequestorInterface * GetRequestorInstance()
+{
+    return sRequestorInstance;
+}
+
+class TestOTAImageProcessorImpl
+{
+public:
+    static void TestQueuedBlocksOrder(nlTestSuite * inSuite, void * inContext);
+    static void TestAbortWhileBlocksQueued(nlTestSuite * inSuite, void * inContext);
+    static void TestFinalizeAfterQueuedBlocks(nlTestSuite * inSuite, void * inContext);
+    static void TestApplyWaitsForWorker(nlTestSuite * inSuite, void * inContext);
+    static void TestWriteError(nlTestSuite * inSuite, void * inContext);
+
+private:
+    // Large enough for the pipe and every buffer to fill up before the whole image is sent.
+    static constexpr size_t kPayloadSize = 8 * OTAImageProcessorImpl::kWriteBufferSize;
+
+    static void PrepareDownload(nlTestSuite * inSuite, OTAImageProcessorImpl & processor, TestDownloader & downloader,
+                                const char * imageFile, ByteSpan image)
+    {
+        processor.SetOTADownloader(&downloader);
+        processor.SetOTAImageFile(imageFile);
+        downloader.SetImageProcessorDelegate(&processor);
+        downloader.SetImage(image);
+
+        CHIP_ERROR error = CHIP_ERROR_INTERNAL;
+        NL_TEST_ASSERT(inSuite, downloader.BeginPrepareDownload() == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, downloader.WaitForPrepared(error) && error == CHIP_NO_ERROR);
+    }
+
+    static size_t CountFreeBuffers(OTAImageProcessorImpl & processor)
+    {
+        std::lock_guard<std::mutex> lock(processor.mMutex);
+        return static_cast<size_t>(std::count_if(std::begin(processor.mBuffers), std::end(processor.mBuffers),
+                                                 [](const OTAImageProcessorImpl::WriteBuffer & buffer) { return buffer.free; }));
+    }
+
+    static size_t CountJobs(OTAImageProcessorImpl & processor)
+    {
+        std::lock_guard<std::mutex> lock(processor.mMutex);
+        return processor.mJobCount;
+    }
+
+    static bool IsWorkerIdle(OTAImageProcessorImpl & processor)
+    {
+        std::lock_guard<std::mutex> lock(processor.mMutex);
+        return processor.mJobCount == 0 && !processor.mWorkerBusy;
+    }
+};
+
+void TestOTAImageProcessorImpl::TestQueuedBlocksOrder(nlTestSuite * inSuite, void * inContext)
+{
+    TestImage image;
+    NL_TEST_ASSERT(inSuite, image.Build(kPayloadSize) == CHIP_NO_ERROR);
+
+    TestPipe pipe;
+    NL_TEST_ASSERT(inSuite, pipe.Open() == CHIP_NO_ERROR);
+
+    TestDownloader downloader;
+    OTAImageProcessorImpl processor;
+    PrepareDownload(inSuite, processor, downloader, pipe.GetPath(), image.GetImage());
+    pipe.CloseWriteEnd();
+    downloader.Start();
+
+    // Nothing reads the pipe, so the worker is held up and the image processor stops fetching once every buffer is queued.
+    const size_t offset = downloader.WaitForStall();
+    NL_TEST_ASSERT(inSuite, offset < image.GetImage().size());
+    NL_TEST_ASSERT(inSuite,
+                   image.GetPayload(offset).size() >=
+                       OTAImageProcessorImpl::kWriteBufferCount * OTAImageProcessorImpl::kWriteBufferSize);
+    NL_TEST_ASSERT(inSuite, CountFreeBuffers(processor) == 0);
+
+    // The download resumes as the queued buffers are written.
+    pipe.StartReading();
+    NL_TEST_ASSERT(inSuite, downloader.WaitForOffset(image.GetImage().size()));
+    NL_TEST_ASSERT(inSuite, EventLoopMarker().WaitHandled());
+    processor.WaitForWorkerIdle();
+    NL_TEST_ASSERT(inSuite, downloader.GetEndCount() == 0);
+
+    // A pipe cannot be synced, so the download is aborted rather than finalized to close the image file.
+    NL_TEST_ASSERT(inSuite, processor.Abort() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, pipe.WaitForClose().data_equal(image.GetPayload(image.GetImage().size())));
+}
+
+void TestOTAImageProcessorImpl::TestAbortWhileBlocksQueued(nlTestSuite * inSuite, void * inContext)
+{
+    TestImage image;
+    NL_TEST_ASSERT(inSuite, image.Build(kPayloadSize) == CHIP_NO_ERROR);
+
+    TestPipe pipe;
+    NL_TEST_ASSERT(inSuite, pipe.Open() == CHIP_NO_ERROR);
+
+    TestDownloader downloader;
+    OTAImageProcessorImpl processor;
+    PrepareDownload(inSuite, processor, downloader, pipe.GetPath(), image.GetImage());
+    pipe.CloseWriteEnd();
+    downloader.Start();
+
+    const size_t offset = downloader.WaitForStall();
+    NL_TEST_ASSERT(inSuite, offset < image.GetImage().size());
+
+    // The queued buffers are dropped right away, while the one being written is kept until the write completes.
+    NL_TEST_ASSERT(inSuite, processor.Abort() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, EventLoopMarker().WaitHandled());
+    NL_TEST_ASSERT(inSuite, CountFreeBuffers(processor) == OTAImageProcessorImpl::kWriteBufferCount - 1);
+    NL_TEST_ASSERT(inSuite, CountJobs(processor) == 1);
+
+    pipe.StartReading();
+    ByteSpan written = pipe.WaitForClose();
+    NL_TEST_ASSERT(inSuite, written.size() < image.GetPayload(offset).size());
+    NL_TEST_ASSERT(inSuite, written.size() % OTAImageProcessorImpl::kWriteBufferSize == 0);
+    NL_TEST_ASSERT(inSuite, written.data_equal(image.GetPayload(offset).SubSpan(0, written.size())));
+
+    // The completion of the last write neither fetches more data nor ends the download.
+    processor.WaitForWorkerIdle();
+    NL_TEST_ASSERT(inSuite, EventLoopMarker().WaitHandled());
+    NL_TEST_ASSERT(inSuite, downloader.WaitForStall() == offset);
+    NL_TEST_ASSERT(inSuite, downloader.GetEndCount() == 0);
+    NL_TEST_ASSERT(inSuite, CountFreeBuffers(processor) == OTAImageProcessorImpl::kWriteBufferCount);
+    NL_TEST_ASSERT(inSuite, processor.mFd < 0);
+}
+
+void TestOTAImageProcessorImpl::TestFinalizeAfterQueuedBlocks(nlTestSuite * inSuite, void * inContext)
+{
+    TestFile file;
+    NL_TEST_ASSERT(inSuite, file.Create() == CHIP_NO_ERROR);
+
+    // The payload does not end on a buffer boundary, so that Finalize() queues the partly filled buffer.
+    TestImage image;
+    NL_TEST_ASSERT(inSuite, image.Build(kPayloadSize + kBlockSize / 2) == CHIP_NO_ERROR);
+
+    TestDownloader downloader;
+    OTAImageProcessorImpl processor;
+    PrepareDownload(inSuite, processor, downloader, file.GetPath(), image.GetImage());
+    downloader.Start();
+    NL_TEST_ASSERT(inSuite, downloader.WaitForOffset(image.GetImage().size()));
+
+    // The digest is checked once every queued buffer is written.
+    NL_TEST_ASSERT(inSuite, processor.Finalize() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, EventLoopMarker().WaitHandled());
+    processor.WaitForWorkerIdle();
+    NL_TEST_ASSERT(inSuite, file.HasContent(image.GetPayload(image.GetImage().size())));
+    NL_TEST_ASSERT(inSuite, processor.mFd < 0);
+    NL_TEST_ASSERT(inSuite, EventLoopMarker().WaitHandled());
+    NL_TEST_ASSERT(inSuite, downloader.GetEndCount() == 0);
+
+    // An image that does not match its digest is removed, and the download is ended so that it is not applied.
+    TestImage corruptImage;
+    NL_TEST_ASSERT(inSuite, corruptImage.Build(kPayloadSize + kBlockSize / 2, false) == CHIP_NO_ERROR);
+
+    PrepareDownload(inSuite, processor, downloader, file.GetPath(), corruptImage.GetImage());
+    downloader.Start();
+    NL_TEST_ASSERT(inSuite, downloader.WaitForOffset(corruptImage.GetImage().size()));
+    NL_TEST_ASSERT(inSuite, processor.Finalize() == CHIP_NO_ERROR);
+
+    CHIP_ERROR reason = CHIP_NO_ERROR;
+    NL_TEST_ASSERT(inSuite, downloader.WaitForEnd(reason) && reason == CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+    processor.WaitForWorkerIdle();
+    NL_TEST_ASSERT(inSuite, !file.Exists());
+    NL_TEST_ASSERT(inSuite, EventLoopMarker().WaitHandled());
+    NL_TEST_ASSERT(inSuite, downloader.GetEndCount() == 1);
+}
+
+void TestOTAImageProcessorImpl::TestApplyWaitsForWorker(nlTestSuite * inSuite, void * inContext)
+{
+    TestImage image;
+    NL_TEST_ASSERT(inSuite, image.Build(kPayloadSize) == CHIP_NO_ERROR);
+
+    TestPipe pipe;
+    NL_TEST_ASSERT(inSuite, pipe.Open() == CHIP_NO_ERROR);
+
+    TestDownloader downloader;
+    OTAImageProcessorImpl processor;
+    PrepareDownload(inSuite, processor, downloader, pipe.GetPath(), image.GetImage());
+    pipe.CloseWriteEnd();
+    downloader.Start();
+
+    const size_t offset = downloader.WaitForStall();
+    NL_TEST_ASSERT(inSuite, offset < image.GetImage().size());
+
+    // The event loop is held up until the worker has written the queued buffers.  A pipe can neither be synced nor moved,
+    // so the image is not applied afterwards, and the event loop keeps running.
+    NL_TEST_ASSERT(inSuite, processor.Finalize() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, processor.Apply() == CHIP_NO_ERROR);
+    EventLoopMarker marker;
+    NL_TEST_ASSERT(inSuite, !marker.WaitHandled(kStallTimeout));
+
+    pipe.StartReading();
+    NL_TEST_ASSERT(inSuite, marker.WaitHandled());
+    NL_TEST_ASSERT(inSuite, IsWorkerIdle(processor));
+    NL_TEST_ASSERT(inSuite, pipe.WaitForClose().data_equal(image.GetPayload(offset)));
+}
+
+void TestOTAImageProcessorImpl::TestWriteError(nlTestSuite * inSuite, void * inContext)
+{
+    TestImage image;
+    NL_TEST_ASSERT(inSuite, image.Build(kPayloadSize) == CHIP_NO_ERROR);
+
+    TestPipe pipe;
+    NL_TEST_ASSERT(inSuite, pipe.Open() == CHIP_NO_ERROR);
+
+    TestDownloader downloader;
+    OTAImageProcessorImpl processor;
+    PrepareDownload(inSuite, processor, downloader, pipe.GetPath(), image.GetImage());
+
+    // The first write fails, as nothing reads the pipe anymore.
+    pipe.CloseWriteEnd();
+    pipe.CloseReadEnd();
+    downloader.Start();
+
+    CHIP_ERROR reason = CHIP_NO_ERROR;
+    NL_TEST_ASSERT(inSuite, downloader.WaitForEnd(reason) && reason == CHIP_ERROR_WRITE_FAILED);
+
+    // The download is ended once, and no more data is fetched.
+    const size_t offset = downloader.WaitForStall();
+    NL_TEST_ASSERT(inSuite, offset < image.GetImage().size());
+    NL_TEST_ASSERT(inSuite, downloader.GetEndCount() == 1);
+
+    // Ending the download aborts it.
+    NL_TEST_ASSERT(inSuite, processor.Abort() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, EventLoopMarker().WaitHandled());
+    processor.WaitForWorkerIdle();
+    NL_TEST_ASSERT(inSuite, EventLoopMarker().WaitHandled());
+    NL_TEST_ASSERT(inSuite, downloader.GetEndCount() == 1);
+    NL_TEST_ASSERT(inSuite, CountFreeBuffers(processor) == OTAImageProcessorImpl::kWriteBufferCount);
+    NL_TEST_ASSERT(inSuite, processor.mFd < 0);
+}
+
+} // namespace chip
+
+/**
+ *  Set up the test suite.
+ */
+int TestOTAImageProcessorImpl_Setup(void * inContext)
+{
+    VerifyOrReturnError(chip::Platform::MemoryInit() == CHIP_NO_ERROR, FAILURE);
+    VerifyOrReturnError(PlatformMgr().InitChipStack() == CHIP_NO_ERROR, FAILURE);
+    VerifyOrReturnError(PlatformMgr().StartEventLoopTask() == CHIP_NO_ERROR, FAILURE);
+
+    // Writes to a pipe without a reader fail rather than raise a signal.
+    sPreviousSigPipeHandler = signal(SIGPIPE, SIG_IGN);
+    SetRequestorInstance(&sRequestor);
+    return SUCCESS;
+}
+
+/**
+ *  Tear down the test suite.
+ */
+int TestOTAImageProcessorImpl_Teardown(void * inContext)
+{
+    SetRequestorInstance(nullptr);
+    signal(SIGPIPE, sPreviousSigPipeHandler);
+
+    PlatformMgr().StopEventLoopTask();
+    PlatformMgr().Shutdown();
+    chip::Platform::MemoryShutdown();
+    return SUCCESS;
+}
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+// clang-format off
+static const nlTest sTests[] = {
+    NL_TEST_DEF("Test queued blocks are written in order", TestOTAImageProcessorImpl::TestQueuedBlocksOrder),
+    NL_TEST_DEF("Test abort while blocks are queued", TestOTAImageProcessorImpl::TestAbortWhileBlocksQueued),
+    NL_TEST_DEF("Test finalize after queued blocks", TestOTAImageProcessorImpl::TestFinalizeAfterQueuedBlocks),
+    NL_TEST_DEF("Test apply waits for the worker", TestOTAImageProcessorImpl::TestApplyWaitsForWorker),
+    NL_TEST_DEF("Test write error ends the download", TestOTAImageProcessorImpl::TestWriteError),
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+int TestOTAImageProcessorImplSuite()
+{
+    // clang-format off
+    nlTestSuite theSuite =
+    {
+        "Linux OTA Image Processor",
+        &sTests[0],
+        TestOTAImageProcessorImpl_Setup,
+        TestOTAImageProcessorImpl_Teardown
+    };
+    // clang-format on
+    nlTestRunner(&theSuite, nullptr);
+    return (nlTestRunnerStats(&theSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestOTAImageProcessorImplSuite);
@@ -29,6 +29,9 @@
 #include <string.h>
 
 #include <atomic>
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+#include <thread>
+#endif
 
 #include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
@@ -188,6 +191,60 @@ static void TestPlatformMgr_RunEventLoopStopBeforeSleep(nlTestSuite * inSuite, v
     PlatformMgr().Shutdown();
 }
 
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+static std::atomic<int> sWorkRan{ 0 };
+
+static void CountWork(intptr_t)
+{
+    sWorkRan++;
+}
+
+static void TestPlatformMgr_ScheduleWorkFromThreads(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr int kNumThreads       = 4;
+    constexpr int kNumWorkPerThread = 1000;
+
+    sWorkRan = 0;
+
+    CHIP_ERROR err = PlatformMgr().InitChipStack();
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    err = PlatformMgr().StartEventLoopTask();
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    // Post work from several threads at once, none of them holding the stack lock.
+    std::atomic<int> numFailures{ 0 };
+    std::thread threads[kNumThreads];
+    for (auto & thread : threads)
+    {
+        thread = std::thread([&numFailures] {
+            for (int i = 0; i < kNumWorkPerThread; i++)
+            {
+                if (PlatformMgr().ScheduleWork(CountWork) != CHIP_NO_ERROR)
+                {
+                    numFailures++;
+                }
+            }
+        });
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    for (size_t t = 0; sWorkRan != kNumThreads * kNumWorkPerThread && t < 1000; t++)
+        chip::test_utils::SleepMillis(1);
+
+    NL_TEST_ASSERT(inSuite, numFailures == 0);
+    NL_TEST_ASSERT(inSuite, sWorkRan == kNumThreads * kNumWorkPerThread);
+
+    err = PlatformMgr().StopEventLoopTask();
+    NL_TEST_ASSERT(inSuite, err == CHIP_NO_ERROR);
+
+    PlatformMgr().Shutdown();
+}
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
 static void TestPlatformMgr_TryLockChipStack(nlTestSuite * inSuite, void * inContext)
 {
     bool locked = PlatformMgr().TryLockChipStack();
@@ -262,6 +319,9 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Test basic PlatformMgr::RunEventLoop", TestPlatformMgr_BasicRunEventLoop),
     NL_TEST_DEF("Test PlatformMgr::RunEventLoop with two tasks", TestPlatformMgr_RunEventLoopTwoTasks),
     NL_TEST_DEF("Test PlatformMgr::RunEventLoop with stop before sleep", TestPlatformMgr_RunEventLoopStopBeforeSleep),
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    NL_TEST_DEF("Test PlatformMgr::ScheduleWork from several threads", TestPlatformMgr_ScheduleWorkFromThreads),
+#endif
     NL_TEST_DEF("Test PlatformMgr::TryLockChipStack", TestPlatformMgr_TryLockChipStack),
     NL_TEST_DEF("Test PlatformMgr::AddEventHandler", TestPlatformMgr_AddEventHandler),
     NL_TEST_DEF("Test mock System::Layer", TestPlatformMgr_MockSystemLayer),
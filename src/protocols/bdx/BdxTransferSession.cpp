@@ -207,6 +207,8 @@ CHIP_ERROR TransferSession::AcceptTransfer(const TransferAcceptData & acceptData
     VerifyOrReturnError(acceptData.MaxBlockSize <= mTransferRequestData.MaxBlockSize, CHIP_ERROR_INVALID_ARGUMENT);
 
     mTransferMaxBlockSize = acceptData.MaxBlockSize;
+    // The mode is only resolved on receipt of the TransferInit when a single one is common to both nodes.
+    mControlMode = acceptData.ControlMode;
 
     if (mRole == TransferRole::kSender)
     {
@@ -293,6 +293,10 @@ public:
                                      System::Clock::Timestamp curTime);
 
     TransferControlFlags GetControlMode() const { return mControlMode; }
+    BitFlags<TransferControlFlags> GetProposedControlOptions() const
+    {
+        return BitFlags<TransferControlFlags>(mTransferRequestData.TransferCtlFlags);
+    }
     uint64_t GetStartOffset() const { return mStartOffset; }
     uint64_t GetTransferLength() const { return mTransferLength; }
     uint16_t GetTransferBlockSize() const { return mTransferMaxBlockSize; }
@@ -21,6 +21,7 @@
 #include <credentials/GroupDataProvider.h>
 #include <lib/core/CHIPError.h>
 #include <lib/support/BufferWriter.h>
+#include <lib/support/CodeUtils.h>
 #include <lib/support/Span.h>
 
 #include "CASEDestinationId.h"
@@ -62,4 +63,174 @@ CHIP_ERROR GenerateCaseDestinationId(const ByteSpan & ipk, const ByteSpan & init
     return err;
 }
 
+CHIP_ERROR CASEDestinationIdCache::FindLocalNode(const FabricTable & fabrics, Credentials::GroupDataProvider & groupDataProvider,
+                                                 const ByteSpan & destinationId, const ByteSpan & initiatorRandom,
+                                                 FabricIndex & outFabricIndex, NodeId & outNodeId, MutableByteSpan & outIpk)
+{
+    VerifyOrReturnError(initiatorRandom.size() == kSigmaParamRandomNumberSize, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(destinationId.size() == kSHA256_Hash_Length, CHIP_ERROR_KEY_NOT_FOUND);
+
+    Refresh(fabrics, groupDataProvider);
+
+    // Only the initiator random changes from one candidate fabric to the next.
+    uint8_t destinationMessage[kSigmaParamRandomNumberSize + kFabricMessageLen];
+    memcpy(destinationMessage, initiatorRandom.data(), kSigmaParamRandomNumberSize);
+
+    HMAC_sha hmac;
+    for (size_t entryIndex = 0; entryIndex < mNumEntries; ++entryIndex)
+    {
+        const Entry & entry = mEntries[entryIndex];
+        memcpy(&destinationMessage[kSigmaParamRandomNumberSize], entry.fabricMessage, kFabricMessageLen);
+
+        for (size_t keyIndex = 0; keyIndex < entry.numKeys; ++keyIndex)
+        {
+            uint8_t candidateDestinationId[kSHA256_Hash_Length];
+            CHIP_ERROR err = hmac.HMAC_SHA256(entry.keys[keyIndex], kIPKSize, destinationMessage, sizeof(destinationMessage),
+                                              candidateDestinationId, sizeof(candidateDestinationId));
+            if (err != CHIP_NO_ERROR || !destinationId.data_equal(ByteSpan(candidateDestinationId)))
+            {
+                continue;
+            }
+
+            ReturnErrorOnFailure(CopySpanToMutableSpan(ByteSpan(entry.keys[keyIndex]), outIpk));
+            outFabricIndex = entry.fabricIndex;
+            outNodeId      = entry.nodeId;
+            MoveToFront(entryIndex, keyIndex);
+            return CHIP_NO_ERROR;
+        }
+    }
+
+    return CHIP_ERROR_KEY_NOT_FOUND;
+}
+
+void CASEDestinationIdCache::Clear()
+{
+    for (auto & entry : mEntries)
+    {
+        ClearSecretData(entry.keys[0], sizeof(entry.keys));
+        entry = Entry();
+    }
+    mNumEntries        = 0;
+    mFabrics           = nullptr;
+    mGroupDataProvider = nullptr;
+    mKeySetGeneration  = 0;
+}
+
+bool CASEDestinationIdCache::IsCurrent(const Entry & entry, const FabricInfo & fabricInfo) const
+{
+    P256PublicKey rootPubKey;
+    return entry.fabricId == fabricInfo.GetFabricId() && entry.nodeId == fabricInfo.GetNodeId() &&
+        fabricInfo.FetchRootPubkey(rootPubKey) == CHIP_NO_ERROR &&
+        memcmp(entry.fabricMessage, rootPubKey.ConstBytes(), kP256_PublicKey_Length) == 0;
+}
+
+CHIP_ERROR CASEDestinationIdCache::Load(Entry & entry, const FabricInfo & fabricInfo,
+                                        Credentials::GroupDataProvider & groupDataProvider)
+{
+    P256PublicKey rootPubKey;
+    ReturnErrorOnFailure(fabricInfo.FetchRootPubkey(rootPubKey));
+
+    entry.fabricIndex = fabricInfo.GetFabricIndex();
+    entry.fabricId    = fabricInfo.GetFabricId();
+    entry.nodeId      = fabricInfo.GetNodeId();
+    entry.numKeys     = 0;
+
+    Encoding::LittleEndian::BufferWriter bbuf(entry.fabricMessage, sizeof(entry.fabricMessage));
+    bbuf.Put(rootPubKey.ConstBytes(), kP256_PublicKey_Length);
+    bbuf.Put64(entry.fabricId);
+    bbuf.Put64(entry.nodeId);
+    VerifyOrReturnError(bbuf.Fit(), CHIP_ERROR_BUFFER_TOO_SMALL);
+
+    // A fabric without a usable IPK stays in the cache with no keys, so that we do not look it up again.
+    Credentials::GroupDataProvider::KeySet ipkKeySet;
+    if (groupDataProvider.GetIpkKeySet(entry.fabricIndex, ipkKeySet) == CHIP_NO_ERROR && ipkKeySet.num_keys_used > 0 &&
+        ipkKeySet.num_keys_used <= Credentials::GroupDataProvider::KeySet::kEpochKeysMax)
+    {
+        for (size_t keyIndex = 0; keyIndex < ipkKeySet.num_keys_used; ++keyIndex)
+        {
+            memcpy(entry.keys[keyIndex], ipkKeySet.epoch_keys[keyIndex].key, kIPKSize);
+        }
+        entry.numKeys = ipkKeySet.num_keys_used;
+    }
+    ipkKeySet.ClearKeys();
+
+    return CHIP_NO_ERROR;
+}
+
+void CASEDestinationIdCache::Refresh(const FabricTable & fabrics, Credentials::GroupDataProvider & groupDataProvider)
+{
+    if (mFabrics != &fabrics || mGroupDataProvider != &groupDataProvider ||
+        mKeySetGeneration != groupDataProvider.GetKeySetGeneration())
+    {
+        Clear();
+        mFabrics           = &fabrics;
+        mGroupDataProvider = &groupDataProvider;
+        mKeySetGeneration  = groupDataProvider.GetKeySetGeneration();
+    }
+
+    // Drop the entries of fabrics that were removed or changed, keeping the order of the others.
+    size_t kept = 0;
+    for (size_t entryIndex = 0; entryIndex < mNumEntries; ++entryIndex)
+    {
+        const FabricInfo * fabricInfo = fabrics.FindFabricWithIndex(mEntries[entryIndex].fabricIndex);
+        if (fabricInfo == nullptr || !IsCurrent(mEntries[entryIndex], *fabricInfo))
+        {
+            continue;
+        }
+        if (kept != entryIndex)
+        {
+            mEntries[kept] = mEntries[entryIndex];
+        }
+        ++kept;
+    }
+    for (size_t entryIndex = kept; entryIndex < mNumEntries; ++entryIndex)
+    {
+        ClearSecretData(mEntries[entryIndex].keys[0], sizeof(mEntries[entryIndex].keys));
+        mEntries[entryIndex] = Entry();
+    }
+    mNumEntries = kept;
+
+    // Fabrics we have not seen yet go last.
+    for (const FabricInfo & fabricInfo : fabrics)
+    {
+        bool found = false;
+        for (size_t entryIndex = 0; entryIndex < mNumEntries && !found; ++entryIndex)
+        {
+            found = (mEntries[entryIndex].fabricIndex == fabricInfo.GetFabricIndex());
+        }
+        if (found || mNumEntries >= ArraySize(mEntries))
+        {
+            continue;
+        }
+        if (Load(mEntries[mNumEntries], fabricInfo, groupDataProvider) == CHIP_NO_ERROR)
+        {
+            ++mNumEntries;
+        }
+    }
+}
+
+void CASEDestinationIdCache::MoveToFront(size_t entryIndex, size_t keyIndex)
+{
+    Entry & entry = mEntries[entryIndex];
+    if (keyIndex > 0)
+    {
+        uint8_t key[kIPKSize];
+        memcpy(key, entry.keys[keyIndex], kIPKSize);
+        memmove(entry.keys[1], entry.keys[0], keyIndex * kIPKSize);
+        memcpy(entry.keys[0], key, kIPKSize);
+        ClearSecretData(key);
+    }
+
+    if (entryIndex > 0)
+    {
+        Entry matched = entry;
+        for (size_t i = entryIndex; i > 0; --i)
+        {
+            mEntries[i] = mEntries[i - 1];
+        }
+        mEntries[0] = matched;
+        ClearSecretData(matched.keys[0], sizeof(matched.keys));
+    }
+}
+
 } // namespace chip
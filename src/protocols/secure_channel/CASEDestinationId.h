@@ -34,4 +34,57 @@ inline constexpr uint16_t kIPKSize                    = Crypto::CHIP_CRYPTO_SYMM
 CHIP_ERROR GenerateCaseDestinationId(const ByteSpan & ipk, const ByteSpan & initiatorRandom, const ByteSpan & rootPubKey,
                                      FabricId fabricId, NodeId nodeId, MutableByteSpan & outDestinationId);
 
+/**
+ * Keeps what is needed to match the destination identifier of an incoming Sigma1 against the local fabrics: the IPK
+ * epoch keys of each fabric and the part of the destination message that only depends on the fabric (root public
+ * key, fabric ID and node ID).  This avoids reading the IPK key sets from storage for every Sigma1.
+ *
+ * Fabrics, and the keys within each fabric, are tried most recently matched first.  Entries are checked against the
+ * fabric table on every lookup, and are all reloaded when the key sets of the group data provider change.
+ */
+class CASEDestinationIdCache
+{
+public:
+    /**
+     * Find the local fabric and IPK that the initiator used to generate destinationId.
+     *
+     * @retval CHIP_ERROR_KEY_NOT_FOUND if no local fabric matches.
+     */
+    CHIP_ERROR FindLocalNode(const FabricTable & fabrics, Credentials::GroupDataProvider & groupDataProvider,
+                             const ByteSpan & destinationId, const ByteSpan & initiatorRandom, FabricIndex & outFabricIndex,
+                             NodeId & outNodeId, MutableByteSpan & outIpk);
+
+    /**
+     * Forget all the cached key material.
+     */
+    void Clear();
+
+private:
+    static constexpr size_t kFabricMessageLen = Crypto::kP256_PublicKey_Length + sizeof(FabricId) + sizeof(NodeId);
+
+    struct Entry
+    {
+        FabricIndex fabricIndex = kUndefinedFabricIndex;
+        FabricId fabricId       = kUndefinedFabricId;
+        NodeId nodeId           = kUndefinedNodeId;
+        // Root public key, fabric ID and node ID, as they follow the initiator random in the destination message.
+        uint8_t fabricMessage[kFabricMessageLen];
+        uint8_t numKeys = 0;
+        uint8_t keys[Credentials::GroupDataProvider::KeySet::kEpochKeysMax][kIPKSize];
+    };
+
+    bool IsCurrent(const Entry & entry, const FabricInfo & fabricInfo) const;
+    CHIP_ERROR Load(Entry & entry, const FabricInfo & fabricInfo, Credentials::GroupDataProvider & groupDataProvider);
+    void Refresh(const FabricTable & fabrics, Credentials::GroupDataProvider & groupDataProvider);
+    void MoveToFront(size_t entryIndex, size_t keyIndex);
+
+    // Most recently matched first.
+    Entry mEntries[CHIP_CONFIG_MAX_FABRICS];
+    size_t mNumEntries = 0;
+
+    const FabricTable * mFabrics                        = nullptr;
+    Credentials::GroupDataProvider * mGroupDataProvider = nullptr;
+    uint32_t mKeySetGeneration                          = 0;
+};
+
 } // namespace chip
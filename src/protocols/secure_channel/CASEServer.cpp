@@ -23,16 +23,28 @@
 #include <lib/support/logging/CHIPLogging.h>
 #include <transport/SessionManager.h>
 
+#include <algorithm>
+
 using namespace ::chip::Inet;
 using namespace ::chip::Transport;
 using namespace ::chip::Credentials;
 
 namespace chip {
 
-CHIP_ERROR CASEServer::ListenForSessionEstablishment(Messaging::ExchangeManager * exchangeManager, SessionManager * sessionManager,
-                                                     FabricTable * fabrics, SessionResumptionStorage * sessionResumptionStorage,
-                                                     Credentials::CertificateValidityPolicy * certificateValidityPolicy,
-                                                     Credentials::GroupDataProvider * responderGroupDataProvider)
+namespace {
+
+// A successful CASE handshake can take several seconds and some may time out (30 seconds or more).
+// TODO: Come up with better estimate: https://github.com/project-chip/connectedhomeip/issues/28288
+// For now, setting minimum wait time to 5000 milliseconds.
+constexpr System::Clock::Milliseconds16 kBusyMinimumWaitTime(5000);
+
+} // namespace
+
+CHIP_ERROR CASEServerBase::ListenForSessionEstablishment(Messaging::ExchangeManager * exchangeManager,
+                                                         SessionManager * sessionManager, FabricTable * fabrics,
+                                                         SessionResumptionStorage * sessionResumptionStorage,
+                                                         Credentials::CertificateValidityPolicy * certificateValidityPolicy,
+                                                         Credentials::GroupDataProvider * responderGroupDataProvider)
 {
     VerifyOrReturnError(exchangeManager != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrReturnError(sessionManager != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
@@ -45,56 +57,85 @@ CHIP_ERROR CASEServer::ListenForSessionEstablishment(Messaging::ExchangeManager
     mExchangeManager           = exchangeManager;
     mGroupDataProvider         = responderGroupDataProvider;
 
-    // Set up the group state provider that persists across all handshakes.
-    GetSession().SetGroupDataProvider(mGroupDataProvider);
+    for (auto & responder : mResponders)
+    {
+        responder.SetServer(this);
+        // Set up the group state provider and destination identifier cache that persist across all handshakes.
+        responder.GetSession().SetGroupDataProvider(mGroupDataProvider);
+        responder.GetSession().SetDestinationIdCache(&mDestinationIdCache);
+    }
 
     ChipLogProgress(Inet, "CASE Server enabling CASE session setups");
     mExchangeManager->RegisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1, this);
 
-    PrepareForSessionEstablishment();
+    for (auto & responder : mResponders)
+    {
+        responder.PrepareForSessionEstablishment();
+    }
 
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR CASEServer::InitCASEHandshake(Messaging::ExchangeContext * ec)
+void CASEServerBase::Shutdown()
+{
+    if (mExchangeManager != nullptr)
+    {
+        mExchangeManager->UnregisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1);
+        mExchangeManager = nullptr;
+    }
+
+    if (mSessionManager != nullptr)
+    {
+        if (mSessionManager->SystemLayer() != nullptr)
+        {
+            mSessionManager->SystemLayer()->CancelTimer(ProcessQueuedSigma1, this);
+            mSessionManager->SystemLayer()->CancelTimer(ExpireQueuedSigma1, this);
+        }
+        // Shutdown() runs again on destruction, possibly after the session manager is gone.
+        mSessionManager = nullptr;
+    }
+
+    while (mQueuedSigma1Count > 0)
+    {
+        DequeueSigma1(0).exchange->Close();
+    }
+
+    for (auto & responder : mResponders)
+    {
+        responder.Shutdown();
+    }
+
+    mDestinationIdCache.Clear();
+}
+
+CHIP_ERROR CASEServerBase::InitCASEHandshake(Messaging::ExchangeContext * ec, Responder & responder)
 {
     ReturnErrorCodeIf(ec == nullptr, CHIP_ERROR_INVALID_ARGUMENT);
 
     // Hand over the exchange context to the CASE session.
-    ec->SetDelegate(&GetSession());
+    ec->SetDelegate(&responder.GetSession());
+    responder.SetPeerAddress(ec->GetSessionHandle()->AsUnauthenticatedSession()->GetPeerAddress());
 
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR CASEServer::OnUnsolicitedMessageReceived(const PayloadHeader & payloadHeader, ExchangeDelegate *& newDelegate)
+CHIP_ERROR CASEServerBase::OnUnsolicitedMessageReceived(const PayloadHeader & payloadHeader, ExchangeDelegate *& newDelegate)
 {
     // TODO: assign newDelegate to CASESession, let CASESession handle future messages.
     newDelegate = this;
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR CASEServer::OnMessageReceived(Messaging::ExchangeContext * ec, const PayloadHeader & payloadHeader,
-                                         System::PacketBufferHandle && payload)
+CHIP_ERROR CASEServerBase::OnMessageReceived(Messaging::ExchangeContext * ec, const PayloadHeader & payloadHeader,
+                                             System::PacketBufferHandle && payload)
 {
-    if (GetSession().GetState() != CASESession::State::kInitialized)
+    for (size_t i = 0; i < mQueuedSigma1Count; i++)
     {
-        // We are in the middle of CASE handshake
-
-        // Invoke watchdog to fix any stuck handshakes
-        bool watchdogFired = GetSession().InvokeBackgroundWorkWatchdog();
-        if (!watchdogFired)
+        if (mQueuedSigma1[i].exchange == ec)
         {
-            // Handshake wasn't stuck, send the busy status report and let the existing handshake continue.
-
-            // A successful CASE handshake can take several seconds and some may time out (30 seconds or more).
-            // TODO: Come up with better estimate: https://github.com/project-chip/connectedhomeip/issues/28288
-            // For now, setting minimum wait time to 5000 milliseconds.
-            CHIP_ERROR err = SendBusyStatusReport(ec, System::Clock::Milliseconds16(5000));
-            if (err != CHIP_NO_ERROR)
-            {
-                ChipLogError(Inet, "Failed to send the busy status report, err:%" CHIP_ERROR_FORMAT, err.Format());
-            }
-            return err;
+            // The initiator is waiting for our Sigma2, there is nothing else it should send.  Keep waiting for a responder.
+            ChipLogError(Inet, "CASE Server ignoring message on exchange of waiting Sigma1 EC %p", ec);
+            return CHIP_NO_ERROR;
         }
     }
 
@@ -104,26 +145,239 @@ CHIP_ERROR CASEServer::OnMessageReceived(Messaging::ExchangeContext * ec, const
         return CHIP_ERROR_INCORRECT_STATE;
     }
 
-    ChipLogProgress(Inet, "CASE Server received Sigma1 message %s EC %p", ". Starting handshake.", ec);
+    const Transport::PeerAddress & peerAddress = ec->GetSessionHandle()->AsUnauthenticatedSession()->GetPeerAddress();
+
+    Responder * responder = FindAvailableResponder();
+    if (responder == nullptr)
+    {
+        // We are in the middle of CASE handshakes.  Invoke watchdog to fix any stuck ones.
+        for (auto & busyResponder : mResponders)
+        {
+            busyResponder.GetSession().InvokeBackgroundWorkWatchdog();
+        }
+        responder = FindAvailableResponder();
+    }
 
-    CHIP_ERROR err = InitCASEHandshake(ec);
-    SuccessOrExit(err);
+    // A peer only gets one handshake at a time, so that a single peer cannot take all responders or fill the queue.  If its
+    // Sigma1 is waiting, it gave up on it and tried again: the new one takes its place.
+    size_t queuedIndex = FindQueuedSigma1(peerAddress);
+    if (queuedIndex < mQueuedSigma1Count)
+    {
+        ChipLogProgress(Inet, "CASE Server received Sigma1 message %s EC %p", ". Replacing the waiting one.", ec);
+
+        QueuedSigma1 & sigma1                 = mQueuedSigma1[queuedIndex];
+        Messaging::ExchangeContext * previous = sigma1.exchange;
+        sigma1.exchange                       = ec;
+        sigma1.payloadHeader                  = payloadHeader;
+        sigma1.payload                        = std::move(payload);
+        sigma1.deadline                       = System::SystemClock().GetMonotonicTimestamp() + mSigma1QueueTimeout;
+        ec->WillSendMessage();
+        previous->Close();
+
+        ExpireQueuedSigma1();
+        return CHIP_NO_ERROR;
+    }
 
-    // TODO - Enable multiple concurrent CASE session establishment
-    // https://github.com/project-chip/connectedhomeip/issues/8342
+    // Sigma1 messages that are already waiting go first.
+    bool mustWait = (responder == nullptr || mQueuedSigma1Count > 0);
+    bool canWait  = (mQueuedSigma1Count < mQueuedSigma1.size());
+    if (HasHandshakeWithPeer(peerAddress) || (mustWait && !canWait))
+    {
+        // Send the busy status report and let the existing handshakes continue.
+        CHIP_ERROR err = SendBusyStatusReport(ec, kBusyMinimumWaitTime);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(Inet, "Failed to send the busy status report, err:%" CHIP_ERROR_FORMAT, err.Format());
+        }
+        return err;
+    }
 
-    err = GetSession().OnMessageReceived(ec, payloadHeader, std::move(payload));
-    SuccessOrExit(err);
+    if (mustWait)
+    {
+        ChipLogProgress(Inet, "CASE Server received Sigma1 message %s EC %p", ". Waiting for a handshake to finish.", ec);
+
+        QueuedSigma1 & sigma1 = mQueuedSigma1[mQueuedSigma1Count++];
+        sigma1.exchange       = ec;
+        sigma1.payloadHeader  = payloadHeader;
+        sigma1.payload        = std::move(payload);
+        sigma1.peerAddress    = peerAddress;
+        sigma1.deadline       = System::SystemClock().GetMonotonicTimestamp() + mSigma1QueueTimeout;
+
+        // Keep the exchange open until we get to respond.
+        ec->WillSendMessage();
+        ExpireQueuedSigma1();
+
+        // A responder may be available already, if the queue was still being processed.
+        OnResponderAvailable();
+        return CHIP_NO_ERROR;
+    }
 
-exit:
     // CASESession::OnMessageReceived guarantees that it will call
     // OnSessionEstablishmentError if it returns error, so nothing else to do here.
-    return err;
+    return StartHandshake(*responder, ec, payloadHeader, std::move(payload));
+}
+
+void CASEServerBase::OnExchangeClosing(Messaging::ExchangeContext * ec)
+{
+    // The exchange of a waiting Sigma1 is going away, e.g. because its session was released.
+    for (size_t i = 0; i < mQueuedSigma1Count; i++)
+    {
+        if (mQueuedSigma1[i].exchange == ec)
+        {
+            DequeueSigma1(i);
+            return;
+        }
+    }
+}
+
+CHIP_ERROR CASEServerBase::StartHandshake(Responder & responder, Messaging::ExchangeContext * ec,
+                                          const PayloadHeader & payloadHeader, System::PacketBufferHandle && payload)
+{
+    ChipLogProgress(Inet, "CASE Server received Sigma1 message %s EC %p", ". Starting handshake.", ec);
+
+    ReturnErrorOnFailure(InitCASEHandshake(ec, responder));
+
+    return responder.GetSession().OnMessageReceived(ec, payloadHeader, std::move(payload));
+}
+
+size_t CASEServerBase::GetActiveHandshakeCount()
+{
+    size_t count = 0;
+    for (auto & responder : mResponders)
+    {
+        if (!responder.IsAvailable())
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+CASEServerBase::Responder * CASEServerBase::FindAvailableResponder()
+{
+    for (auto & responder : mResponders)
+    {
+        if (responder.IsAvailable())
+        {
+            return &responder;
+        }
+    }
+    return nullptr;
+}
+
+bool CASEServerBase::HasHandshakeWithPeer(const Transport::PeerAddress & peerAddress)
+{
+    for (auto & responder : mResponders)
+    {
+        if (!responder.IsAvailable() && responder.GetPeerAddress() == peerAddress)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t CASEServerBase::FindQueuedSigma1(const Transport::PeerAddress & peerAddress) const
+{
+    size_t index = 0;
+    while (index < mQueuedSigma1Count && !(mQueuedSigma1[index].peerAddress == peerAddress))
+    {
+        index++;
+    }
+    return index;
+}
+
+void CASEServerBase::OnResponderAvailable()
+{
+    VerifyOrReturn(mQueuedSigma1Count > 0);
+
+    // Do not start the next handshake from within the callbacks of the one that just finished.
+    VerifyOrReturn(mSessionManager != nullptr && mSessionManager->SystemLayer() != nullptr);
+    CHIP_ERROR err = mSessionManager->SystemLayer()->StartTimer(System::Clock::kZero, ProcessQueuedSigma1, this);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Inet, "Failed to schedule waiting Sigma1 messages, err:%" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
+
+void CASEServerBase::ProcessQueuedSigma1(System::Layer * systemLayer, void * appState)
+{
+    static_cast<CASEServerBase *>(appState)->ProcessQueuedSigma1();
+}
+
+void CASEServerBase::ProcessQueuedSigma1()
+{
+    Responder * responder;
+    while (mQueuedSigma1Count > 0 && (responder = FindAvailableResponder()) != nullptr)
+    {
+        QueuedSigma1 sigma1 = DequeueSigma1(0);
+
+        CHIP_ERROR err = StartHandshake(*responder, sigma1.exchange, sigma1.payloadHeader, std::move(sigma1.payload));
+        if (err != CHIP_NO_ERROR)
+        {
+            // The CASE session has let go of the exchange, and since we are not within the handling of a message on it,
+            // nothing else is going to close it.
+            sigma1.exchange->Close();
+        }
+    }
+}
+
+CASEServerBase::QueuedSigma1 CASEServerBase::DequeueSigma1(size_t index)
+{
+    QueuedSigma1 sigma1;
+    VerifyOrDie(index < mQueuedSigma1Count);
+    sigma1 = std::move(mQueuedSigma1[index]);
+    for (size_t i = index + 1; i < mQueuedSigma1Count; i++)
+    {
+        mQueuedSigma1[i - 1] = std::move(mQueuedSigma1[i]);
+    }
+    mQueuedSigma1Count--;
+    mQueuedSigma1[mQueuedSigma1Count] = QueuedSigma1();
+    return sigma1;
+}
+
+void CASEServerBase::ExpireQueuedSigma1(System::Layer * systemLayer, void * appState)
+{
+    static_cast<CASEServerBase *>(appState)->ExpireQueuedSigma1();
+}
+
+void CASEServerBase::ExpireQueuedSigma1()
+{
+    const System::Clock::Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+    System::Clock::Timestamp nextDeadline;
+    bool hasNextDeadline = false;
+
+    for (size_t i = 0; i < mQueuedSigma1Count;)
+    {
+        if (mQueuedSigma1[i].deadline > now)
+        {
+            nextDeadline    = hasNextDeadline ? std::min(nextDeadline, mQueuedSigma1[i].deadline) : mQueuedSigma1[i].deadline;
+            hasNextDeadline = true;
+            i++;
+            continue;
+        }
+
+        // Let the initiator know to try again later, if it is still waiting.  Sending the status report closes the exchange.
+        ChipLogProgress(Inet, "CASE Server dropping Sigma1 message that waited too long, EC %p", mQueuedSigma1[i].exchange);
+        Messaging::ExchangeContext * ec = DequeueSigma1(i).exchange;
+        if (SendBusyStatusReport(ec, kBusyMinimumWaitTime) != CHIP_NO_ERROR)
+        {
+            ec->Close();
+        }
+    }
+
+    VerifyOrReturn(hasNextDeadline && mSessionManager != nullptr && mSessionManager->SystemLayer() != nullptr);
+    CHIP_ERROR err = mSessionManager->SystemLayer()->StartTimer(nextDeadline - now, ExpireQueuedSigma1, this);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Inet, "Failed to schedule the expiry of waiting Sigma1 messages, err:%" CHIP_ERROR_FORMAT, err.Format());
+    }
 }
 
-void CASEServer::PrepareForSessionEstablishment(const ScopedNodeId & previouslyEstablishedPeer)
+void CASEServerBase::Responder::PrepareForSessionEstablishment(const ScopedNodeId & previouslyEstablishedPeer)
 {
-    GetSession().Clear();
+    mPairingSession.Clear();
+    mPeerAddress = Transport::PeerAddress::Uninitialized();
 
     //
     // This releases our reference to a previously pinned session. If that was a successfully established session and is now
@@ -152,9 +406,10 @@ void CASEServer::PrepareForSessionEstablishment(const ScopedNodeId & previouslyE
     // TODO(#17568): Once session eviction is actually in place, this call should NEVER fail and if so, is a logic bug.
     // Dying here on failure is even more appropriate then.
     //
-    VerifyOrDie(GetSession().PrepareForSessionEstablishment(*mSessionManager, mFabrics, mSessionResumptionStorage,
-                                                            mCertificateValidityPolicy, this, previouslyEstablishedPeer,
-                                                            GetLocalMRPConfig()) == CHIP_NO_ERROR);
+    VerifyOrDie(mPairingSession.PrepareForSessionEstablishment(*mServer->mSessionManager, mServer->mFabrics,
+                                                               mServer->mSessionResumptionStorage,
+                                                               mServer->mCertificateValidityPolicy, this,
+                                                               previouslyEstablishedPeer, GetLocalMRPConfig()) == CHIP_NO_ERROR);
 
     //
     // PairingSession::mSecureSessionHolder is a weak-reference. If MarkForEviction is called on this session, the session is
@@ -166,7 +421,7 @@ void CASEServer::PrepareForSessionEstablishment(const ScopedNodeId & previouslyE
     //
     // Let's create a SessionHandle strong-reference to it to keep it resident.
     //
-    mPinnedSecureSession = GetSession().CopySecureSession();
+    mPinnedSecureSession = mPairingSession.CopySecureSession();
 
     //
     // If we've gotten this far, it means we have successfully allocated a SecureSession to back our next attempt. If we haven't,
@@ -175,21 +430,23 @@ void CASEServer::PrepareForSessionEstablishment(const ScopedNodeId & previouslyE
     VerifyOrDie(mPinnedSecureSession.HasValue());
 }
 
-void CASEServer::OnSessionEstablishmentError(CHIP_ERROR err)
+void CASEServerBase::Responder::OnSessionEstablishmentError(CHIP_ERROR err)
 {
     ChipLogError(Inet, "CASE Session establishment failed: %" CHIP_ERROR_FORMAT, err.Format());
 
     PrepareForSessionEstablishment();
+    mServer->OnResponderAvailable();
 }
 
-void CASEServer::OnSessionEstablished(const SessionHandle & session)
+void CASEServerBase::Responder::OnSessionEstablished(const SessionHandle & session)
 {
     ChipLogProgress(Inet, "CASE Session established to peer: " ChipLogFormatScopedNodeId,
                     ChipLogValueScopedNodeId(session->GetPeer()));
     PrepareForSessionEstablishment(session->GetPeer());
+    mServer->OnResponderAvailable();
 }
 
-CHIP_ERROR CASEServer::SendBusyStatusReport(Messaging::ExchangeContext * ec, System::Clock::Milliseconds16 minimumWaitTime)
+CHIP_ERROR CASEServerBase::SendBusyStatusReport(Messaging::ExchangeContext * ec, System::Clock::Milliseconds16 minimumWaitTime)
 {
     ChipLogProgress(Inet, "Already in the middle of CASE handshake, sending busy status report");
 
@@ -22,45 +22,40 @@
 #include <messaging/ExchangeDelegate.h>
 #include <messaging/ExchangeMgr.h>
 #include <protocols/secure_channel/CASESession.h>
+#include <protocols/secure_channel/SessionEstablishmentExchangeDispatch.h>
 #include <system/SystemClock.h>
+#include <transport/raw/PeerAddress.h>
+
+#include <array>
 
 namespace chip {
 
-class CASEServer : public SessionEstablishmentDelegate,
-                   public Messaging::UnsolicitedMessageHandler,
-                   public Messaging::ExchangeDelegate
+/**
+ * CASEServerBase listens for Sigma1 messages and runs the responder side of CASE handshakes.
+ *
+ * Several handshakes can run at the same time, each in its own CASESession.  When all of them are in use, Sigma1 messages
+ * can wait for one to become available, for up to CHIP_CONFIG_CASE_SERVER_SIGMA1_QUEUE_TIMEOUT_MS, after which they get a
+ * busy response.  For fairness, a peer (as identified by its address) only gets one handshake at a time, in progress or
+ * waiting: a new Sigma1 from a peer whose Sigma1 is waiting takes its place, and any other Sigma1 gets a busy response.
+ *
+ * The responders and the Sigma1 queue are provided by a derived class, see CASEServerImpl.
+ */
+class CASEServerBase : public Messaging::UnsolicitedMessageHandler, public Messaging::ExchangeDelegate
 {
 public:
-    CASEServer() {}
-    ~CASEServer() override { Shutdown(); }
-
     /*
-     * This method will shutdown this object, releasing the strong reference to the pinned SecureSession object.
-     * It will also unregister the unsolicited handler and clear out the session object (which will release the weak
-     * reference through the underlying SessionHolder).
+     * This method will shutdown this object, releasing the strong references to the pinned SecureSession objects.
+     * It will also unregister the unsolicited handler, close the exchanges of waiting Sigma1 messages and clear out the
+     * session objects (which will release the weak references through the underlying SessionHolders).
      *
      */
-    void Shutdown()
-    {
-        if (mExchangeManager != nullptr)
-        {
-            mExchangeManager->UnregisterUnsolicitedMessageHandlerForType(Protocols::SecureChannel::MsgType::CASE_Sigma1);
-            mExchangeManager = nullptr;
-        }
-
-        GetSession().Clear();
-        mPinnedSecureSession.ClearValue();
-    }
+    void Shutdown();
 
     CHIP_ERROR ListenForSessionEstablishment(Messaging::ExchangeManager * exchangeManager, SessionManager * sessionManager,
                                              FabricTable * fabrics, SessionResumptionStorage * sessionResumptionStorage,
                                              Credentials::CertificateValidityPolicy * policy,
                                              Credentials::GroupDataProvider * responderGroupDataProvider);
 
-    //////////// SessionEstablishmentDelegate Implementation ///////////////
-    void OnSessionEstablishmentError(CHIP_ERROR error) override;
-    void OnSessionEstablished(const SessionHandle & session) override;
-
     //// UnsolicitedMessageHandler Implementation ////
     CHIP_ERROR OnUnsolicitedMessageReceived(const PayloadHeader & payloadHeader, ExchangeDelegate *& newDelegate) override;
 
@@ -68,46 +63,146 @@ public:
     CHIP_ERROR OnMessageReceived(Messaging::ExchangeContext * ec, const PayloadHeader & payloadHeader,
                                  System::PacketBufferHandle && payload) override;
     void OnResponseTimeout(Messaging::ExchangeContext * ec) override {}
-    Messaging::ExchangeMessageDispatch & GetMessageDispatch() override { return GetSession().GetMessageDispatch(); }
+    void OnExchangeClosing(Messaging::ExchangeContext * ec) override;
+    Messaging::ExchangeMessageDispatch & GetMessageDispatch() override
+    {
+        return SessionEstablishmentExchangeDispatch::Instance();
+    }
 
-    CASESession & GetSession() { return mPairingSession; }
+    // Number of handshakes in progress, and number of Sigma1 messages waiting for one of them to finish.
+    size_t GetActiveHandshakeCount();
+    size_t GetQueuedSigma1Count() const { return mQueuedSigma1Count; }
+
+    // Number of handshakes that can run at the same time, and number of Sigma1 messages that can wait for one of them.
+    size_t GetMaxConcurrentHandshakes() const { return mResponders.size(); }
+    size_t GetSigma1QueueSize() const { return mQueuedSigma1.size(); }
+
+protected:
+    /**
+     * One responder CASESession, along with the state the server keeps for it.
+     */
+    class Responder : public SessionEstablishmentDelegate
+    {
+    public:
+        void SetServer(CASEServerBase * server) { mServer = server; }
+
+        CASESession & GetSession() { return mPairingSession; }
+        bool IsAvailable() { return mPairingSession.GetState() == CASESession::State::kInitialized; }
+
+        // Address of the peer the handshake is with, if there is one.
+        const Transport::PeerAddress & GetPeerAddress() const { return mPeerAddress; }
+        void SetPeerAddress(const Transport::PeerAddress & peerAddress) { mPeerAddress = peerAddress; }
+
+        /*
+         * This will clean up any state from a previous session establishment
+         * attempt (if any) and setup the machinery to listen for and handle
+         * any session handshakes there-after.
+         *
+         * If a session had previously been established successfully, previouslyEstablishedPeer
+         * should be set to the scoped node-id of the peer associated with that session.
+         *
+         */
+        void PrepareForSessionEstablishment(const ScopedNodeId & previouslyEstablishedPeer = ScopedNodeId());
+
+        void Shutdown()
+        {
+            mPairingSession.Clear();
+            mPinnedSecureSession.ClearValue();
+            mPeerAddress = Transport::PeerAddress::Uninitialized();
+        }
+
+        //////////// SessionEstablishmentDelegate Implementation ///////////////
+        void OnSessionEstablishmentError(CHIP_ERROR error) override;
+        void OnSessionEstablished(const SessionHandle & session) override;
+
+    private:
+        CASEServerBase * mServer = nullptr;
+
+        //
+        // When we're in the process of establishing a session, this is used
+        // to maintain an additional, strong reference to the underlying SecureSession.
+        // This is because the existing reference in PairingSession is a weak one
+        // (i.e a SessionHolder) and can lose its reference if the session is evicted
+        // for any reason.
+        //
+        // This initially points to a session that is not yet active. Upon activation, it
+        // transfers ownership of the session to the SecureSessionManager and this reference
+        // is released before simultaneously acquiring ownership of a new SecureSession.
+        //
+        Optional<SessionHandle> mPinnedSecureSession;
+
+        CASESession mPairingSession;
+        Transport::PeerAddress mPeerAddress = Transport::PeerAddress::Uninitialized();
+    };
+
+    /**
+     * A Sigma1 that is waiting for a responder.  Its exchange is kept open by WillSendMessage(), with this server as
+     * its delegate, until it is handed to a responder.
+     */
+    struct QueuedSigma1
+    {
+        Messaging::ExchangeContext * exchange = nullptr;
+        PayloadHeader payloadHeader;
+        System::PacketBufferHandle payload;
+        Transport::PeerAddress peerAddress;
+        System::Clock::Timestamp deadline; // Time after which the initiator has given up on its Sigma2
+    };
+
+    // The storage is owned by the derived class, which must call Shutdown() before destroying it.
+    CASEServerBase(Span<Responder> responders, Span<QueuedSigma1> queuedSigma1) :
+        mResponders(responders), mQueuedSigma1(queuedSigma1)
+    {}
+    ~CASEServerBase() override {}
 
 private:
+    friend class TestCASESession;
+
     Messaging::ExchangeManager * mExchangeManager                       = nullptr;
     SessionResumptionStorage * mSessionResumptionStorage                = nullptr;
     Credentials::CertificateValidityPolicy * mCertificateValidityPolicy = nullptr;
 
-    //
-    // When we're in the process of establishing a session, this is used
-    // to maintain an additional, strong reference to the underlying SecureSession.
-    // This is because the existing reference in PairingSession is a weak one
-    // (i.e a SessionHolder) and can lose its reference if the session is evicted
-    // for any reason.
-    //
-    // This initially points to a session that is not yet active. Upon activation, it
-    // transfers ownership of the session to the SecureSessionManager and this reference
-    // is released before simultaneously acquiring ownership of a new SecureSession.
-    //
-    Optional<SessionHandle> mPinnedSecureSession;
-
-    CASESession mPairingSession;
+    Span<Responder> mResponders;
     SessionManager * mSessionManager = nullptr;
 
+    // Waiting Sigma1 messages, oldest first.
+    Span<QueuedSigma1> mQueuedSigma1;
+    size_t mQueuedSigma1Count = 0;
+    System::Clock::Milliseconds32 mSigma1QueueTimeout{ CHIP_CONFIG_CASE_SERVER_SIGMA1_QUEUE_TIMEOUT_MS };
+
     FabricTable * mFabrics                              = nullptr;
     Credentials::GroupDataProvider * mGroupDataProvider = nullptr;
 
-    CHIP_ERROR InitCASEHandshake(Messaging::ExchangeContext * ec);
+    // Shared by the responders, to match the destination identifier of Sigma1 without reading the IPKs every time.
+    CASEDestinationIdCache mDestinationIdCache;
 
-    /*
-     * This will clean up any state from a previous session establishment
-     * attempt (if any) and setup the machinery to listen for and handle
-     * any session handshakes there-after.
-     *
-     * If a session had previously been established successfully, previouslyEstablishedPeer
-     * should be set to the scoped node-id of the peer associated with that session.
-     *
-     */
-    void PrepareForSessionEstablishment(const ScopedNodeId & previouslyEstablishedPeer = ScopedNodeId());
+    CHIP_ERROR InitCASEHandshake(Messaging::ExchangeContext * ec, Responder & responder);
+
+    // Returns a responder that can take a new handshake, or nullptr if all of them are in use.
+    Responder * FindAvailableResponder();
+
+    // Returns true if a handshake with the given peer is in progress.
+    bool HasHandshakeWithPeer(const Transport::PeerAddress & peerAddress);
+
+    // Returns the position of the waiting Sigma1 from the given peer, or mQueuedSigma1Count if there is none.
+    size_t FindQueuedSigma1(const Transport::PeerAddress & peerAddress) const;
+
+    // Hand the Sigma1 over to the responder, which takes care of the rest of the handshake.
+    CHIP_ERROR StartHandshake(Responder & responder, Messaging::ExchangeContext * ec, const PayloadHeader & payloadHeader,
+                              System::PacketBufferHandle && payload);
+
+    // Called by a responder once its handshake is over and it is ready for the next one.
+    void OnResponderAvailable();
+
+    // Start handshakes for waiting Sigma1 messages while there are available responders.
+    void ProcessQueuedSigma1();
+    static void ProcessQueuedSigma1(System::Layer * systemLayer, void * appState);
+
+    // Remove the waiting Sigma1 at the given position, moving the ones behind it forward.
+    QueuedSigma1 DequeueSigma1(size_t index);
+
+    // Send a busy response to the waiting Sigma1 messages that are past their deadline, and schedule the next deadline.
+    void ExpireQueuedSigma1();
+    static void ExpireQueuedSigma1(System::Layer * systemLayer, void * appState);
 
     // If we are in the middle of handshake and receive a Sigma1 then respond with Busy status code.
     // @param[in] ec              Exchange Context
@@ -117,4 +212,24 @@ private:
     CHIP_ERROR SendBusyStatusReport(Messaging::ExchangeContext * ec, System::Clock::Milliseconds16 minimumWaitTime);
 };
 
+/**
+ * A CASE server that runs up to kMaxConcurrentHandshakes handshakes at the same time, and keeps up to kSigma1QueueSize
+ * Sigma1 messages waiting for one of them.  A queue size of 0 disables the queue.
+ */
+template <size_t kMaxConcurrentHandshakes, size_t kSigma1QueueSize>
+class CASEServerImpl : public CASEServerBase
+{
+public:
+    static_assert(kMaxConcurrentHandshakes > 0, "The CASE server needs at least one responder");
+
+    CASEServerImpl() : CASEServerBase(Span<Responder>(mResponderStorage), Span<QueuedSigma1>(mQueuedSigma1Storage)) {}
+    ~CASEServerImpl() override { Shutdown(); }
+
+private:
+    Responder mResponderStorage[kMaxConcurrentHandshakes];
+    std::array<QueuedSigma1, kSigma1QueueSize> mQueuedSigma1Storage;
+};
+
+using CASEServer = CASEServerImpl<CHIP_CONFIG_CASE_SERVER_MAX_CONCURRENT_HANDSHAKES, CHIP_CONFIG_CASE_SERVER_SIGMA1_QUEUE_SIZE>;
+
 } // namespace chip
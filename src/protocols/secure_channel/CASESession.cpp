@@ -751,6 +751,13 @@ CHIP_ERROR CASESession::FindLocalNodeFromDestinationId(const ByteSpan & destinat
 {
     VerifyOrReturnError(mFabricsTable != nullptr, CHIP_ERROR_INCORRECT_STATE);
 
+    if (mDestinationIdCache != nullptr)
+    {
+        MutableByteSpan ipkSpan(mIPK);
+        return mDestinationIdCache->FindLocalNode(*mFabricsTable, *mGroupDataProvider, destinationId, initiatorRandom,
+                                                  mFabricIndex, mLocalNodeId, ipkSpan);
+    }
+
     bool found = false;
     for (const FabricInfo & fabricInfo : *mFabricsTable)
     {
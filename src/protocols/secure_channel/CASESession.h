@@ -117,6 +117,15 @@ public:
      */
     void SetGroupDataProvider(Credentials::GroupDataProvider * groupDataProvider) { mGroupDataProvider = groupDataProvider; }
 
+    /**
+     * @brief Set the cache used by the responder to match the destination identifier of Sigma1 against the local
+     *        fabrics, so that the IPKs do not have to be read from the Group Data Provider for every Sigma1.
+     *
+     * @param destinationIdCache - Pointer to the cache, shared by the responder sessions of a CASE server.  If nullptr,
+     *                             the IPKs are looked up for every Sigma1.
+     */
+    void SetDestinationIdCache(CASEDestinationIdCache * destinationIdCache) { mDestinationIdCache = destinationIdCache; }
+
     /**
      * Parse a sigma1 message.  This function will return success only if the
      * message passes schema checks.  Specifically:
@@ -293,6 +302,7 @@ private:
     Crypto::P256ECDHDerivedSecret mSharedSecret;
     Credentials::ValidationContext mValidContext;
     Credentials::GroupDataProvider * mGroupDataProvider = nullptr;
+    CASEDestinationIdCache * mDestinationIdCache        = nullptr;
 
     uint8_t mMessageDigest[Crypto::kSHA256_Hash_Length];
     uint8_t mIPK[kIPKSize];
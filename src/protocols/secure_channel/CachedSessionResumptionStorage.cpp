@@ -0,0 +1,384 @@
+/*
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <protocols/secure_channel/CachedSessionResumptionStorage.h>
+
+#include <algorithm>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+namespace chip {
+
+constexpr System::Clock::Milliseconds32 CachedSessionResumptionStorage::kDefaultFlushInterval;
+
+CachedSessionResumptionStorage::~CachedSessionResumptionStorage()
+{
+    // The backing storage may be gone already, so pending changes are only written by Shutdown().
+    if (mSystemLayer != nullptr && mFlushScheduled)
+    {
+        mSystemLayer->CancelTimer(OnFlushTimer, this);
+    }
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::Init(PersistentStorageDelegate * storage, System::Layer * systemLayer,
+                                                System::Clock::Timeout flushInterval)
+{
+    ReturnErrorOnFailure(SimpleSessionResumptionStorage::Init(storage));
+
+    mSystemLayer    = systemLayer;
+    mFlushInterval  = flushInterval;
+    mFlushScheduled = false;
+    mIndex.mSize    = 0;
+    mIndexLoaded    = false;
+    mIndexDirty     = false;
+    while (mNumRecords > 0)
+    {
+        ReleaseRecord(mRecords[0]);
+    }
+    return CHIP_NO_ERROR;
+}
+
+void CachedSessionResumptionStorage::Shutdown()
+{
+    if (mSystemLayer != nullptr && mFlushScheduled)
+    {
+        mSystemLayer->CancelTimer(OnFlushTimer, this);
+    }
+    mFlushScheduled = false;
+
+    if (HasPendingWrites())
+    {
+        CHIP_ERROR err = Flush();
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(SecureChannel, "Unable to write session resumption records on shutdown: %" CHIP_ERROR_FORMAT,
+                         err.Format());
+        }
+    }
+    mSystemLayer = nullptr;
+}
+
+bool CachedSessionResumptionStorage::HasPendingWrites() const
+{
+    if (mIndexDirty)
+    {
+        return true;
+    }
+    for (size_t i = 0; i < mNumRecords; ++i)
+    {
+        if (mRecords[i].stateDirty || mRecords[i].linkDirty)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::Flush()
+{
+    // The index goes first: a record must never be in storage without being listed by the stored index.
+    if (mIndexDirty)
+    {
+        CHIP_ERROR err = SimpleSessionResumptionStorage::SaveIndex(mIndex);
+        if (err != CHIP_NO_ERROR)
+        {
+            // Try again later.
+            ScheduleFlush();
+            return err;
+        }
+        mIndexDirty = false;
+    }
+
+    CHIP_ERROR firstErr = CHIP_NO_ERROR;
+    for (size_t i = 0; i < mNumRecords; ++i)
+    {
+        Record & record = mRecords[i];
+        if (record.stateDirty)
+        {
+            CHIP_ERROR err =
+                SimpleSessionResumptionStorage::SaveState(record.node, record.resumptionId, record.sharedSecret, record.peerCATs);
+            if (err != CHIP_NO_ERROR)
+            {
+                firstErr = (firstErr == CHIP_NO_ERROR) ? err : firstErr;
+                // Do not write a link to a state that is not there.
+                continue;
+            }
+            record.stateDirty = false;
+        }
+        if (record.linkDirty)
+        {
+            CHIP_ERROR err = SimpleSessionResumptionStorage::SaveLink(record.resumptionId, record.node);
+            if (err != CHIP_NO_ERROR)
+            {
+                firstErr = (firstErr == CHIP_NO_ERROR) ? err : firstErr;
+                continue;
+            }
+            record.linkDirty = false;
+        }
+    }
+
+    if (firstErr != CHIP_NO_ERROR)
+    {
+        // Try again later.
+        ScheduleFlush();
+    }
+    return firstErr;
+}
+
+void CachedSessionResumptionStorage::ScheduleFlush()
+{
+    // Do not push back a flush that is already scheduled, so that changes do not stay in memory for longer than the
+    // flush interval however often they are made.
+    VerifyOrReturn(mSystemLayer != nullptr && !mFlushScheduled);
+
+    CHIP_ERROR err = mSystemLayer->StartTimer(mFlushInterval, OnFlushTimer, this);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(SecureChannel, "Unable to schedule session resumption write-back: %" CHIP_ERROR_FORMAT, err.Format());
+        return;
+    }
+    mFlushScheduled = true;
+}
+
+void CachedSessionResumptionStorage::OnFlushTimer(System::Layer * systemLayer, void * appState)
+{
+    auto * self           = static_cast<CachedSessionResumptionStorage *>(appState);
+    self->mFlushScheduled = false;
+    CHIP_ERROR err        = self->Flush();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(SecureChannel, "Unable to write session resumption records: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::SaveIndex(const SessionIndex & index)
+{
+    mIndex       = index;
+    mIndexLoaded = true;
+    mIndexDirty  = true;
+    ScheduleFlush();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::LoadIndex(SessionIndex & index)
+{
+    if (!mIndexLoaded)
+    {
+        ReturnErrorOnFailure(SimpleSessionResumptionStorage::LoadIndex(mIndex));
+        mIndexLoaded = true;
+    }
+    index.mSize = mIndex.mSize;
+    std::copy(&mIndex.mNodes[0], &mIndex.mNodes[mIndex.mSize], &index.mNodes[0]);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::SaveLink(ConstResumptionIdView resumptionId, const ScopedNodeId & node)
+{
+    Record * record = FindRecord(node);
+    if (record == nullptr || !std::equal(record->resumptionId.begin(), record->resumptionId.end(), resumptionId.begin()))
+    {
+        // Links are saved right after their state, so this is not expected.  Keep it simple and write it through.
+        return SimpleSessionResumptionStorage::SaveLink(resumptionId, node);
+    }
+
+    record->hasLink   = true;
+    record->linkDirty = true;
+    ScheduleFlush();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::LoadLink(ConstResumptionIdView resumptionId, ScopedNodeId & node)
+{
+    Record * record = FindRecord(resumptionId);
+    if (record != nullptr && record->hasLink)
+    {
+        node = record->node;
+        return CHIP_NO_ERROR;
+    }
+
+    ReturnErrorOnFailure(SimpleSessionResumptionStorage::LoadLink(resumptionId, node));
+
+    // Lookups by resumption ID go on to load the state, so bring it in now and remember that the link exists.
+    ResumptionIdStorage stateResumptionId;
+    Crypto::P256ECDHDerivedSecret sharedSecret;
+    CATValues peerCATs;
+    if (LoadState(node, stateResumptionId, sharedSecret, peerCATs) == CHIP_NO_ERROR)
+    {
+        record = FindRecord(node);
+        if (record != nullptr && std::equal(stateResumptionId.begin(), stateResumptionId.end(), resumptionId.begin()))
+        {
+            record->hasLink = true;
+        }
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::DeleteLink(ConstResumptionIdView resumptionId)
+{
+    bool pendingOnly = false;
+    Record * record  = FindRecord(resumptionId);
+    if (record != nullptr && record->hasLink)
+    {
+        pendingOnly       = record->linkDirty;
+        record->hasLink   = false;
+        record->linkDirty = false;
+    }
+
+    CHIP_ERROR err = SimpleSessionResumptionStorage::DeleteLink(resumptionId);
+    if (pendingOnly && err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    {
+        // The link was never written, so there is nothing to delete.
+        return CHIP_NO_ERROR;
+    }
+    return err;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::SaveState(const ScopedNodeId & node, ConstResumptionIdView resumptionId,
+                                                     const Crypto::P256ECDHDerivedSecret & sharedSecret, const CATValues & peerCATs)
+{
+    Record * record = FindRecord(node);
+    if (record == nullptr)
+    {
+        record = AllocRecord();
+    }
+    if (record == nullptr)
+    {
+        return SimpleSessionResumptionStorage::SaveState(node, resumptionId, sharedSecret, peerCATs);
+    }
+
+    if (!std::equal(record->resumptionId.begin(), record->resumptionId.end(), resumptionId.begin()))
+    {
+        // A new resumption ID has no link until SaveLink is called.
+        record->hasLink   = false;
+        record->linkDirty = false;
+    }
+    record->node = node;
+    std::copy(resumptionId.begin(), resumptionId.end(), record->resumptionId.begin());
+    record->sharedSecret = sharedSecret;
+    record->peerCATs     = peerCATs;
+    record->stateDirty   = true;
+    ScheduleFlush();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::LoadState(const ScopedNodeId & node, ResumptionIdStorage & resumptionId,
+                                                     Crypto::P256ECDHDerivedSecret & sharedSecret, CATValues & peerCATs)
+{
+    Record * record = FindRecord(node);
+    if (record == nullptr)
+    {
+        ReturnErrorOnFailure(SimpleSessionResumptionStorage::LoadState(node, resumptionId, sharedSecret, peerCATs));
+
+        record = AllocRecord();
+        if (record != nullptr)
+        {
+            record->node         = node;
+            record->resumptionId = resumptionId;
+            record->sharedSecret = sharedSecret;
+            record->peerCATs     = peerCATs;
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    resumptionId = record->resumptionId;
+    sharedSecret = record->sharedSecret;
+    peerCATs     = record->peerCATs;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CachedSessionResumptionStorage::DeleteState(const ScopedNodeId & node)
+{
+    bool pendingOnly = false;
+    Record * record  = FindRecord(node);
+    if (record != nullptr)
+    {
+        pendingOnly = record->stateDirty;
+        ReleaseRecord(*record);
+    }
+
+    CHIP_ERROR err = SimpleSessionResumptionStorage::DeleteState(node);
+    if (pendingOnly && err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    {
+        // The state was never written, so there is nothing to delete.
+        return CHIP_NO_ERROR;
+    }
+    return err;
+}
+
+CachedSessionResumptionStorage::Record * CachedSessionResumptionStorage::FindRecord(const ScopedNodeId & node)
+{
+    for (size_t i = 0; i < mNumRecords; ++i)
+    {
+        if (mRecords[i].node == node)
+        {
+            return &mRecords[i];
+        }
+    }
+    return nullptr;
+}
+
+CachedSessionResumptionStorage::Record * CachedSessionResumptionStorage::FindRecord(ConstResumptionIdView resumptionId)
+{
+    for (size_t i = 0; i < mNumRecords; ++i)
+    {
+        if (std::equal(mRecords[i].resumptionId.begin(), mRecords[i].resumptionId.end(), resumptionId.begin()))
+        {
+            return &mRecords[i];
+        }
+    }
+    return nullptr;
+}
+
+CachedSessionResumptionStorage::Record * CachedSessionResumptionStorage::AllocRecord()
+{
+    if (mNumRecords == ArraySize(mRecords))
+    {
+        Record * victim = nullptr;
+        for (size_t i = 0; i < mNumRecords && victim == nullptr; ++i)
+        {
+            if (!mRecords[i].stateDirty && !mRecords[i].linkDirty)
+            {
+                victim = &mRecords[i];
+            }
+        }
+        if (victim == nullptr)
+        {
+            // Everything is pending, write it out so that records can be reused.
+            VerifyOrReturnValue(Flush() == CHIP_NO_ERROR, nullptr);
+            victim = &mRecords[0];
+        }
+        ReleaseRecord(*victim);
+    }
+
+    Record & record = mRecords[mNumRecords++];
+    record          = Record();
+    return &record;
+}
+
+void CachedSessionResumptionStorage::ReleaseRecord(Record & record)
+{
+    Record & last = mRecords[mNumRecords - 1];
+    if (&record != &last)
+    {
+        record = last;
+    }
+    last = Record();
+    mNumRecords--;
+}
+
+} // namespace chip
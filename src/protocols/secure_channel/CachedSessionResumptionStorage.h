@@ -0,0 +1,113 @@
+/*
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <protocols/secure_channel/SimpleSessionResumptionStorage.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+
+namespace chip {
+
+/**
+ * A SimpleSessionResumptionStorage that keeps the index and the resumption records in memory, and writes changes back to
+ * the PersistentStorageDelegate at most one flush interval after they are made.
+ *
+ * Lookups are served from memory once a record has been seen, so resuming sessions with known peers does not read
+ * storage, and saving a session does not decode and rewrite the whole index every time.
+ *
+ * Deletions are written through right away.  A flush writes the index first, then the records, so that every record in
+ * storage is always listed by the stored index (and is reached by DeleteAll) even if the device resets in the middle of
+ * a flush.  Records that were not flushed yet are lost on reset, which only means that the next session with that peer
+ * is not resumed.
+ */
+class CachedSessionResumptionStorage : public SimpleSessionResumptionStorage
+{
+public:
+    static constexpr System::Clock::Milliseconds32 kDefaultFlushInterval = System::Clock::Milliseconds32(5000);
+
+    ~CachedSessionResumptionStorage() override;
+
+    /**
+     * @param storage       Backing storage.
+     * @param systemLayer   Used to schedule flushes.  If nullptr, changes are only written by Flush() and Shutdown().
+     * @param flushInterval Longest time a change stays in memory only.
+     */
+    CHIP_ERROR Init(PersistentStorageDelegate * storage, System::Layer * systemLayer,
+                    System::Clock::Timeout flushInterval = kDefaultFlushInterval);
+
+    /**
+     * Write the pending changes and stop scheduling flushes.  Must be called before the system layer or the backing
+     * storage are shut down; destroying the object without calling it drops the pending changes.
+     */
+    void Shutdown();
+
+    /**
+     * Write the pending changes to storage now.
+     */
+    CHIP_ERROR Flush();
+
+    bool HasPendingWrites() const;
+
+    CHIP_ERROR SaveIndex(const SessionIndex & index) override;
+    CHIP_ERROR LoadIndex(SessionIndex & index) override;
+
+    CHIP_ERROR SaveLink(ConstResumptionIdView resumptionId, const ScopedNodeId & node) override;
+    CHIP_ERROR LoadLink(ConstResumptionIdView resumptionId, ScopedNodeId & node) override;
+    CHIP_ERROR DeleteLink(ConstResumptionIdView resumptionId) override;
+
+    CHIP_ERROR SaveState(const ScopedNodeId & node, ConstResumptionIdView resumptionId,
+                         const Crypto::P256ECDHDerivedSecret & sharedSecret, const CATValues & peerCATs) override;
+    CHIP_ERROR LoadState(const ScopedNodeId & node, ResumptionIdStorage & resumptionId,
+                         Crypto::P256ECDHDerivedSecret & sharedSecret, CATValues & peerCATs) override;
+    CHIP_ERROR DeleteState(const ScopedNodeId & node) override;
+
+private:
+    struct Record
+    {
+        ScopedNodeId node;
+        ResumptionIdStorage resumptionId;
+        Crypto::P256ECDHDerivedSecret sharedSecret;
+        CATValues peerCATs;
+        bool stateDirty = false; // State not written to storage yet.
+        bool hasLink    = false; // The resumption ID link to the node is known to exist, in storage or pending.
+        bool linkDirty  = false; // Link not written to storage yet.
+    };
+
+    Record * FindRecord(const ScopedNodeId & node);
+    Record * FindRecord(ConstResumptionIdView resumptionId);
+    // Returns a free record, evicting a clean one or flushing if needed.  Returns nullptr if no record can be freed.
+    Record * AllocRecord();
+    void ReleaseRecord(Record & record);
+
+    void ScheduleFlush();
+    static void OnFlushTimer(System::Layer * systemLayer, void * appState);
+
+    System::Layer * mSystemLayer          = nullptr;
+    System::Clock::Timeout mFlushInterval = kDefaultFlushInterval;
+    bool mFlushScheduled                  = false;
+
+    SessionIndex mIndex;
+    bool mIndexLoaded = false;
+    bool mIndexDirty  = false;
+
+    // Records of the most recently used sessions.  The index holds at most as many nodes, so this can hold all of them.
+    Record mRecords[CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE];
+    size_t mNumRecords = 0;
+};
+
+} // namespace chip
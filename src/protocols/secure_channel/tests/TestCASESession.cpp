@@ -21,6 +21,9 @@
  *      This file implements unit tests for the CASESession implementation.
  */
 
+#include <algorithm>
+#include <inttypes.h>
+
 #include <credentials/CHIPCert.h>
 #include <credentials/GroupDataProviderImpl.h>
 #include <credentials/PersistentStorageOpCertStore.h>
@@ -41,6 +44,7 @@
 #include <protocols/secure_channel/CASEServer.h>
 #include <protocols/secure_channel/CASESession.h>
 #include <stdarg.h>
+#include <system/SystemClock.h>
 
 #include "credentials/tests/CHIPCert_test_vectors.h"
 
@@ -325,8 +329,12 @@ public:
     static void SecurePairingHandshakeTest(nlTestSuite * inSuite, void * inContext);
     static void SecurePairingHandshakeServerTest(nlTestSuite * inSuite, void * inContext);
     static void ClientReceivesBusyTest(nlTestSuite * inSuite, void * inContext);
+    static void ConcurrentServerHandshakesTest(nlTestSuite * inSuite, void * inContext);
+    static void ServerSigma1QueueTest(nlTestSuite * inSuite, void * inContext);
+    static void ServerSigma1QueueTimeoutTest(nlTestSuite * inSuite, void * inContext);
     static void Sigma1ParsingTest(nlTestSuite * inSuite, void * inContext);
     static void DestinationIdTest(nlTestSuite * inSuite, void * inContext);
+    static void DestinationIdCacheTest(nlTestSuite * inSuite, void * inContext);
     static void SessionResumptionStorage(nlTestSuite * inSuite, void * inContext);
 #if CONFIG_BUILD_FOR_HOST_UNIT_TEST
     static void SimulateUpdateNOCInvalidatePendingEstablishment(nlTestSuite * inSuite, void * inContext);
@@ -584,10 +592,11 @@ void TestCASESession::ClientReceivesBusyTest(nlTestSuite * inSuite, void * inCon
 
     ServiceEvents(ctx);
 
-    // We should have one full handshake and one Sigma1 + Busy + ack.  If that
-    // ever changes (e.g. because our server starts supporting multiple parallel
-    // handshakes), this test needs to be fixed so that the server is still
-    // responding BUSY to the client.
+    // We should have one full handshake and one Sigma1 + Busy + ack.  Both
+    // clients come from the same address, and the server only runs one
+    // handshake per peer at a time, however many it can run in parallel.  If
+    // that ever changes, this test needs to be fixed so that the server is
+    // still responding BUSY to the client.
     NL_TEST_ASSERT(inSuite, loopback.mSentMessageCount == sTestCaseMessageCount + 3);
     NL_TEST_ASSERT(inSuite, delegateCommissioner1.mNumPairingComplete == 1);
     NL_TEST_ASSERT(inSuite, delegateCommissioner2.mNumPairingComplete == 0);
@@ -601,6 +610,339 @@ void TestCASESession::ClientReceivesBusyTest(nlTestSuite * inSuite, void * inCon
     gPairingServer.Shutdown();
 }
 
+namespace {
+
+// Every client comes from its own address, so the server tells them apart.
+Transport::PeerAddress GetClientAddress(TestContext & ctx, size_t index)
+{
+    return Transport::PeerAddress::UDP(ctx.GetBobAddress().GetIPAddress(), static_cast<uint16_t>(CHIP_PORT + 10 + index));
+}
+
+Optional<SessionHandle> NewClientSession(TestContext & ctx, size_t index)
+{
+    return ctx.GetSecureSessionManager().CreateUnauthenticatedSession(GetClientAddress(ctx, index),
+                                                                      GetLocalMRPConfig().ValueOr(GetDefaultMRPConfig()));
+}
+
+CHIP_ERROR EstablishSessionFromClient(TestContext & ctx, SessionManager & sessionManager, const SessionHandle & session,
+                                      CASESession & client, TestCASESecurePairingDelegate & delegate)
+{
+    ExchangeContext * exchange = ctx.GetExchangeManager().NewContext(session, &client);
+    VerifyOrReturnError(exchange != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    client.SetGroupDataProvider(&gCommissionerGroupDataProvider);
+    return client.EstablishSession(sessionManager, &gCommissionerFabrics, ScopedNodeId{ Node01_01, gCommissionerFabricIndex },
+                                   exchange, nullptr, nullptr, &delegate, NullOptional);
+}
+
+CHIP_ERROR EstablishSessionFromClient(TestContext & ctx, SessionManager & sessionManager, size_t index, CASESession & client,
+                                      TestCASESecurePairingDelegate & delegate)
+{
+    Optional<SessionHandle> session = NewClientSession(ctx, index);
+    VerifyOrReturnError(session.HasValue(), CHIP_ERROR_NO_MEMORY);
+    return EstablishSessionFromClient(ctx, sessionManager, session.Value(), client, delegate);
+}
+
+// Handshakes that were waiting for a responder run one after the other, each of them taking a few rounds of IO.
+void ServiceEventsUntilIdle(TestContext & ctx, CASEServerBase & server)
+{
+    ServiceEvents(ctx);
+    for (int i = 0; i < 10 && (server.GetActiveHandshakeCount() > 0 || server.GetQueuedSigma1Count() > 0); ++i)
+    {
+        ServiceEvents(ctx);
+    }
+}
+
+void RunConcurrentServerHandshakes(nlTestSuite * inSuite, TestContext & ctx, CASEServerBase & server)
+{
+    // Clients that get a busy response try again right away in the next round, until all of them are done.
+    constexpr size_t kNumClients = 4;
+
+    TemporarySessionManager sessionManager(inSuite, ctx);
+
+    TestCASESecurePairingDelegate delegates[kNumClients];
+    CASESession * clients[kNumClients] = {};
+
+    NL_TEST_ASSERT(inSuite,
+                   server.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetSecureSessionManager(), &gDeviceFabrics,
+                                                        nullptr, nullptr, &gDeviceGroupDataProvider) == CHIP_NO_ERROR);
+
+    // The server answers this many clients at once, by running their handshakes or by having their Sigma1 wait.
+    size_t capacity = server.GetMaxConcurrentHandshakes() + server.GetSigma1QueueSize();
+
+    System::Clock::Timestamp start = System::SystemClock().GetMonotonicTimestamp();
+
+    size_t numRounds   = 0;
+    size_t numComplete = 0;
+    while (numComplete < kNumClients && numRounds < kNumClients)
+    {
+        numRounds++;
+
+        size_t numPending = 0;
+        for (size_t i = 0; i < kNumClients; i++)
+        {
+            if (delegates[i].mNumPairingComplete > 0)
+            {
+                continue;
+            }
+
+            chip::Platform::Delete(clients[i]);
+            clients[i] = chip::Platform::New<CASESession>();
+            NL_TEST_ASSERT(inSuite, EstablishSessionFromClient(ctx, sessionManager, i, *clients[i], delegates[i]) == CHIP_NO_ERROR);
+            numPending++;
+        }
+
+        ServiceEventsUntilIdle(ctx, server);
+
+        size_t numCompleteBefore = numComplete;
+        numComplete              = 0;
+        for (auto & delegate : delegates)
+        {
+            numComplete += (delegate.mNumPairingComplete > 0) ? 1 : 0;
+        }
+
+        NL_TEST_ASSERT(inSuite, numComplete - numCompleteBefore >= std::min(numPending, capacity));
+    }
+
+    System::Clock::Milliseconds64 elapsed =
+        std::chrono::duration_cast<System::Clock::Milliseconds64>(System::SystemClock().GetMonotonicTimestamp() - start);
+    ChipLogProgress(SecureChannel, "Established %u CASE sessions in %u rounds, %" PRIu64 " ms", static_cast<unsigned>(numComplete),
+                    static_cast<unsigned>(numRounds), elapsed.count());
+
+    NL_TEST_ASSERT(inSuite, numComplete == kNumClients);
+    NL_TEST_ASSERT(inSuite, server.GetActiveHandshakeCount() == 0);
+    NL_TEST_ASSERT(inSuite, server.GetQueuedSigma1Count() == 0);
+
+    for (auto & delegate : delegates)
+    {
+        NL_TEST_ASSERT(inSuite, delegate.mNumPairingErrors == delegate.mNumBusyResponses);
+        // Nobody is turned away if the server can answer all clients at once.
+        NL_TEST_ASSERT(inSuite, kNumClients > capacity || delegate.mNumBusyResponses == 0);
+        delegate.GetSessionHolder().Release();
+    }
+    for (auto * client : clients)
+    {
+        chip::Platform::Delete(client);
+    }
+
+    server.Shutdown();
+}
+
+} // namespace
+
+void TestCASESession::ConcurrentServerHandshakesTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+
+    // The configured server, and servers that run several handshakes at once, with and without Sigma1 messages waiting.
+    RunConcurrentServerHandshakes(inSuite, ctx, gPairingServer);
+
+    CASEServerImpl<2, 2> queueingServer;
+    RunConcurrentServerHandshakes(inSuite, ctx, queueingServer);
+
+    CASEServerImpl<2, 0> busyServer;
+    RunConcurrentServerHandshakes(inSuite, ctx, busyServer);
+}
+
+void TestCASESession::ServerSigma1QueueTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+    TemporarySessionManager sessionManager(inSuite, ctx);
+
+    // One handshake at a time, with room for two Sigma1 messages to wait for it.
+    CASEServerImpl<1, 2> server;
+    NL_TEST_ASSERT(inSuite,
+                   server.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetSecureSessionManager(), &gDeviceFabrics,
+                                                        nullptr, nullptr, &gDeviceGroupDataProvider) == CHIP_NO_ERROR);
+
+    enum ClientAddress : size_t
+    {
+        kStalled,
+        kFirstWaiting,
+        kSecondWaiting,
+        kTurnedAway,
+        kThirdWaiting,
+        kFourthWaiting,
+        kAfterShutdown,
+    };
+
+    // The stalled client gives up on its handshake right after Sigma1, but keeps its session so that it still
+    // acknowledges the Sigma2.  The server then keeps its only responder waiting for a Sigma3 that never comes.
+    Optional<SessionHandle> stalledSession = NewClientSession(ctx, kStalled);
+    NL_TEST_ASSERT(inSuite, stalledSession.HasValue());
+
+    TestCASESecurePairingDelegate stalledDelegate, waitingDelegates[4], busyDelegates[2], afterShutdownDelegate;
+    CASESession stalledClient, waitingClients[4], busyClients[2], afterShutdownClient;
+
+    NL_TEST_ASSERT(inSuite,
+                   EstablishSessionFromClient(ctx, sessionManager, stalledSession.Value(), stalledClient, stalledDelegate) ==
+                       CHIP_NO_ERROR);
+    stalledClient.Clear();
+    NL_TEST_ASSERT(inSuite,
+                   EstablishSessionFromClient(ctx, sessionManager, kFirstWaiting, waitingClients[0], waitingDelegates[0]) ==
+                       CHIP_NO_ERROR);
+    ServiceEvents(ctx);
+
+    NL_TEST_ASSERT(inSuite, server.GetActiveHandshakeCount() == 1);
+    NL_TEST_ASSERT(inSuite, server.GetQueuedSigma1Count() == 1);
+    NL_TEST_ASSERT(inSuite, waitingDelegates[0].mNumPairingErrors == 0);
+
+    // A peer that tries again while its Sigma1 is waiting gets the place of the waiting one, rather than a second one.
+    Messaging::ExchangeContext * firstExchange = server.mQueuedSigma1[0].exchange;
+    waitingClients[0].Clear();
+    NL_TEST_ASSERT(inSuite,
+                   EstablishSessionFromClient(ctx, sessionManager, kFirstWaiting, waitingClients[0], waitingDelegates[0]) ==
+                       CHIP_NO_ERROR);
+    ServiceEvents(ctx);
+
+    NL_TEST_ASSERT(inSuite, waitingDelegates[0].mNumBusyResponses == 0);
+    NL_TEST_ASSERT(inSuite, server.GetQueuedSigma1Count() == 1);
+    NL_TEST_ASSERT(inSuite, server.mQueuedSigma1[0].peerAddress == GetClientAddress(ctx, kFirstWaiting));
+    NL_TEST_ASSERT(inSuite, server.mQueuedSigma1[0].exchange != firstExchange);
+
+    // A peer gets one handshake at a time, so a peer whose handshake is running gets a busy response even though there is
+    // still room to wait.  A peer that does not have one yet gets to wait, until there is no room left.
+    NL_TEST_ASSERT(inSuite,
+                   EstablishSessionFromClient(ctx, sessionManager, kStalled, busyClients[0], busyDelegates[0]) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   EstablishSessionFromClient(ctx, sessionManager, kSecondWaiting, waitingClients[1], waitingDelegates[1]) ==
+                       CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   EstablishSessionFromClient(ctx, sessionManager, kTurnedAway, busyClients[1], busyDelegates[1]) == CHIP_NO_ERROR);
+    ServiceEvents(ctx);
+
+    for (auto & delegate : busyDelegates)
+    {
+        NL_TEST_ASSERT(inSuite, delegate.mNumBusyResponses == 1);
+    }
+    NL_TEST_ASSERT(inSuite, waitingDelegates[1].mNumPairingErrors == 0);
+    NL_TEST_ASSERT(inSuite, server.GetActiveHandshakeCount() == 1);
+    NL_TEST_ASSERT(inSuite, server.GetQueuedSigma1Count() == 2);
+    NL_TEST_ASSERT(inSuite, server.mQueuedSigma1[0].peerAddress == GetClientAddress(ctx, kFirstWaiting));
+    NL_TEST_ASSERT(inSuite, server.mQueuedSigma1[1].peerAddress == GetClientAddress(ctx, kSecondWaiting));
+
+    // The exchange of a waiting Sigma1 going away takes it out of the queue, and the peer may then try again.
+    server.mQueuedSigma1[0].exchange->Close();
+    NL_TEST_ASSERT(inSuite, server.GetQueuedSigma1Count() == 1);
+    NL_TEST_ASSERT(inSuite, server.mQueuedSigma1[0].peerAddress == GetClientAddress(ctx, kSecondWaiting));
+
+    waitingClients[0].Clear();
+    NL_TEST_ASSERT(inSuite,
+                   EstablishSessionFromClient(ctx, sessionManager, kFirstWaiting, waitingClients[0], waitingDelegates[0]) ==
+                       CHIP_NO_ERROR);
+    ServiceEvents(ctx);
+
+    NL_TEST_ASSERT(inSuite, waitingDelegates[0].mNumPairingErrors == 0);
+    NL_TEST_ASSERT(inSuite, server.GetQueuedSigma1Count() == 2);
+    NL_TEST_ASSERT(inSuite, server.mQueuedSigma1[1].peerAddress == GetClientAddress(ctx, kFirstWaiting));
+
+    // Once the stalled handshake times out, the waiting Sigma1 messages get their handshakes, oldest first.
+    server.mResponders[0].OnSessionEstablishmentError(CHIP_ERROR_TIMEOUT);
+    ServiceEventsUntilIdle(ctx, server);
+
+    NL_TEST_ASSERT(inSuite, server.GetActiveHandshakeCount() == 0);
+    NL_TEST_ASSERT(inSuite, server.GetQueuedSigma1Count() == 0);
+    for (size_t i = 0; i < 2; i++)
+    {
+        NL_TEST_ASSERT(inSuite, waitingDelegates[i].mNumPairingComplete == 1);
+        NL_TEST_ASSERT(inSuite, waitingDelegates[i].mNumPairingErrors == 0);
+    }
+
+    // Shutting down closes the exchanges of the Sigma1 messages that are still waiting.
+    stalledClient.Clear();
+    NL_TEST_ASSERT(inSuite,
+                   EstablishSessionFromClient(ctx, sessionManager, stalledSession.Value(), stalledClient, stalledDelegate) ==
+                       CHIP_NO_ERROR);
+    stalledClient.Clear();
+    NL_TEST_ASSERT(inSuite,
+                   EstablishSessionFromClient(ctx, sessionManager, kThirdWaiting, waitingClients[2], waitingDelegates[2]) ==
+                       CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   EstablishSessionFromClient(ctx, sessionManager, kFourthWaiting, waitingClients[3], waitingDelegates[3]) ==
+                       CHIP_NO_ERROR);
+    ServiceEvents(ctx);
+
+    NL_TEST_ASSERT(inSuite, server.GetActiveHandshakeCount() == 1);
+    NL_TEST_ASSERT(inSuite, server.GetQueuedSigma1Count() == 2);
+
+    size_t numExchanges = ctx.GetExchangeManager().GetNumActiveExchanges();
+    server.Shutdown();
+    NL_TEST_ASSERT(inSuite, server.GetActiveHandshakeCount() == 0);
+    NL_TEST_ASSERT(inSuite, server.GetQueuedSigma1Count() == 0);
+    NL_TEST_ASSERT(inSuite, ctx.GetExchangeManager().GetNumActiveExchanges() < numExchanges);
+
+    // The server can start over after that.
+    waitingClients[2].Clear();
+    waitingClients[3].Clear();
+    NL_TEST_ASSERT(inSuite,
+                   server.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetSecureSessionManager(), &gDeviceFabrics,
+                                                        nullptr, nullptr, &gDeviceGroupDataProvider) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   EstablishSessionFromClient(ctx, sessionManager, kAfterShutdown, afterShutdownClient, afterShutdownDelegate) ==
+                       CHIP_NO_ERROR);
+    ServiceEventsUntilIdle(ctx, server);
+    NL_TEST_ASSERT(inSuite, afterShutdownDelegate.mNumPairingComplete == 1);
+
+    for (auto & delegate : waitingDelegates)
+    {
+        delegate.GetSessionHolder().Release();
+    }
+    afterShutdownDelegate.GetSessionHolder().Release();
+
+    server.Shutdown();
+}
+
+void TestCASESession::ServerSigma1QueueTimeoutTest(nlTestSuite * inSuite, void * inContext)
+{
+    TestContext & ctx = *reinterpret_cast<TestContext *>(inContext);
+    TemporarySessionManager sessionManager(inSuite, ctx);
+
+    CASEServerImpl<1, 2> server;
+    NL_TEST_ASSERT(inSuite,
+                   server.ListenForSessionEstablishment(&ctx.GetExchangeManager(), &ctx.GetSecureSessionManager(), &gDeviceFabrics,
+                                                        nullptr, nullptr, &gDeviceGroupDataProvider) == CHIP_NO_ERROR);
+    server.mSigma1QueueTimeout = System::Clock::Milliseconds32(100);
+
+    enum ClientAddress : size_t
+    {
+        kStalled,
+        kWaiting,
+    };
+
+    // As in ServerSigma1QueueTest, the stalled client keeps the only responder busy.
+    Optional<SessionHandle> stalledSession = NewClientSession(ctx, kStalled);
+    NL_TEST_ASSERT(inSuite, stalledSession.HasValue());
+
+    TestCASESecurePairingDelegate stalledDelegate, waitingDelegate;
+    CASESession stalledClient, waitingClient;
+
+    NL_TEST_ASSERT(inSuite,
+                   EstablishSessionFromClient(ctx, sessionManager, stalledSession.Value(), stalledClient, stalledDelegate) ==
+                       CHIP_NO_ERROR);
+    stalledClient.Clear();
+    NL_TEST_ASSERT(inSuite,
+                   EstablishSessionFromClient(ctx, sessionManager, kWaiting, waitingClient, waitingDelegate) == CHIP_NO_ERROR);
+    ServiceEvents(ctx);
+
+    NL_TEST_ASSERT(inSuite, server.GetActiveHandshakeCount() == 1);
+    NL_TEST_ASSERT(inSuite, server.GetQueuedSigma1Count() == 1);
+
+    // Past its deadline, the waiting Sigma1 is dropped with a busy response, while the handshake keeps its responder.
+    System::Clock::Timestamp start = System::SystemClock().GetMonotonicTimestamp();
+    while (server.GetQueuedSigma1Count() > 0 && System::SystemClock().GetMonotonicTimestamp() - start < System::Clock::Seconds16(5))
+    {
+        ServiceEvents(ctx);
+    }
+    ServiceEvents(ctx);
+
+    NL_TEST_ASSERT(inSuite, server.GetQueuedSigma1Count() == 0);
+    NL_TEST_ASSERT(inSuite, server.GetActiveHandshakeCount() == 1);
+    NL_TEST_ASSERT(inSuite, waitingDelegate.mNumBusyResponses == 1);
+    NL_TEST_ASSERT(inSuite, waitingDelegate.mNumPairingComplete == 0);
+
+    server.Shutdown();
+}
+
 struct Sigma1Params
 {
     // Purposefully not using constants like kSigmaParamRandomNumberSize that
@@ -676,6 +1018,75 @@ void TestCASESession::DestinationIdTest(nlTestSuite * inSuite, void * inContext)
     NL_TEST_ASSERT(inSuite, !destinationIdSpan.data_equal(ByteSpan(kExpectedDestinationIdFromSpec)));
 }
 
+void TestCASESession::DestinationIdCacheTest(nlTestSuite * inSuite, void * inContext)
+{
+    const FabricInfo * fabricInfo = gDeviceFabrics.FindFabricWithIndex(gDeviceFabricIndex);
+    NL_TEST_ASSERT(inSuite, fabricInfo != nullptr);
+    VerifyOrReturn(fabricInfo != nullptr);
+
+    Crypto::P256PublicKey rootPubKey;
+    NL_TEST_ASSERT(inSuite, fabricInfo->FetchRootPubkey(rootPubKey) == CHIP_NO_ERROR);
+
+    uint8_t initiatorRandom[kSigmaParamRandomNumberSize];
+    memset(initiatorRandom, 0x5a, sizeof(initiatorRandom));
+
+    // Destination identifier the initiator would send for the given epoch key of the IPK key set.
+    auto makeDestinationId = [&](size_t keyIndex, uint8_t (&destinationId)[kSHA256_Hash_Length]) {
+        GroupDataProvider::KeySet ipkKeySet;
+        NL_TEST_ASSERT(inSuite, gDeviceGroupDataProvider.GetIpkKeySet(gDeviceFabricIndex, ipkKeySet) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, keyIndex < ipkKeySet.num_keys_used);
+        MutableByteSpan destinationIdSpan(destinationId);
+        NL_TEST_ASSERT(inSuite,
+                       GenerateCaseDestinationId(ByteSpan(ipkKeySet.epoch_keys[keyIndex].key), ByteSpan(initiatorRandom),
+                                                 ByteSpan(rootPubKey.ConstBytes(), rootPubKey.Length()),
+                                                 fabricInfo->GetFabricId(), fabricInfo->GetNodeId(),
+                                                 destinationIdSpan) == CHIP_NO_ERROR);
+    };
+
+    CASEDestinationIdCache cache;
+    FabricIndex fabricIndex = kUndefinedFabricIndex;
+    NodeId nodeId           = kUndefinedNodeId;
+    uint8_t ipk[kIPKSize];
+    MutableByteSpan ipkSpan(ipk);
+
+    uint8_t destinationId0[kSHA256_Hash_Length];
+    makeDestinationId(0, destinationId0);
+    NL_TEST_ASSERT(inSuite,
+                   cache.FindLocalNode(gDeviceFabrics, gDeviceGroupDataProvider, ByteSpan(destinationId0),
+                                       ByteSpan(initiatorRandom), fabricIndex, nodeId, ipkSpan) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, fabricIndex == gDeviceFabricIndex);
+    NL_TEST_ASSERT(inSuite, nodeId == fabricInfo->GetNodeId());
+
+    // Another initiator random does not match.
+    uint8_t otherRandom[kSigmaParamRandomNumberSize];
+    memset(otherRandom, 0xa5, sizeof(otherRandom));
+    ipkSpan = MutableByteSpan(ipk);
+    NL_TEST_ASSERT(inSuite,
+                   cache.FindLocalNode(gDeviceFabrics, gDeviceGroupDataProvider, ByteSpan(destinationId0), ByteSpan(otherRandom),
+                                       fabricIndex, nodeId, ipkSpan) == CHIP_ERROR_KEY_NOT_FOUND);
+
+    // A new IPK epoch key is picked up once the key set changes, and the earlier one keeps matching.
+    NL_TEST_ASSERT(inSuite, InitTestIpk(gDeviceGroupDataProvider, *fabricInfo, /* numIpks= */ 2) == CHIP_NO_ERROR);
+    uint8_t destinationId1[kSHA256_Hash_Length];
+    makeDestinationId(1, destinationId1);
+    const uint8_t * lookups[] = { destinationId1, destinationId0, destinationId1 };
+    for (const uint8_t * destinationId : lookups)
+    {
+        ipkSpan = MutableByteSpan(ipk);
+        NL_TEST_ASSERT(inSuite,
+                       cache.FindLocalNode(gDeviceFabrics, gDeviceGroupDataProvider, ByteSpan(destinationId, kSHA256_Hash_Length),
+                                           ByteSpan(initiatorRandom), fabricIndex, nodeId, ipkSpan) == CHIP_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, fabricIndex == gDeviceFabricIndex);
+    }
+
+    // Back to a single epoch key, which drops the second one from the cache.
+    NL_TEST_ASSERT(inSuite, InitTestIpk(gDeviceGroupDataProvider, *fabricInfo, /* numIpks= */ 1) == CHIP_NO_ERROR);
+    ipkSpan = MutableByteSpan(ipk);
+    NL_TEST_ASSERT(inSuite,
+                   cache.FindLocalNode(gDeviceFabrics, gDeviceGroupDataProvider, ByteSpan(destinationId1),
+                                       ByteSpan(initiatorRandom), fabricIndex, nodeId, ipkSpan) == CHIP_ERROR_KEY_NOT_FOUND);
+}
+
 template <typename Params>
 static CHIP_ERROR EncodeSigma1(MutableByteSpan & buf)
 {
@@ -1179,8 +1590,12 @@ static const nlTest sTests[] =
     NL_TEST_DEF("Handshake",   chip::TestCASESession::SecurePairingHandshakeTest),
     NL_TEST_DEF("ServerHandshake", chip::TestCASESession::SecurePairingHandshakeServerTest),
     NL_TEST_DEF("ClientReceivesBusy", chip::TestCASESession::ClientReceivesBusyTest),
+    NL_TEST_DEF("ConcurrentServerHandshakes", chip::TestCASESession::ConcurrentServerHandshakesTest),
+    NL_TEST_DEF("ServerSigma1Queue", chip::TestCASESession::ServerSigma1QueueTest),
+    NL_TEST_DEF("ServerSigma1QueueTimeout", chip::TestCASESession::ServerSigma1QueueTimeoutTest),
     NL_TEST_DEF("Sigma1Parsing", chip::TestCASESession::Sigma1ParsingTest),
     NL_TEST_DEF("DestinationId", chip::TestCASESession::DestinationIdTest),
+    NL_TEST_DEF("DestinationIdCache", chip::TestCASESession::DestinationIdCacheTest),
     NL_TEST_DEF("SessionResumptionStorage", chip::TestCASESession::SessionResumptionStorage),
 #if CONFIG_BUILD_FOR_HOST_UNIT_TEST
     // This is compiled for host tests which is enough test coverage to ensure updating NOC invalidates
@@ -0,0 +1,261 @@
+/*
+ *    Copyright (c) 2023 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/DefaultStorageKeyAllocator.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+#include <lib/support/UnitTestRegistration.h>
+#include <nlunit-test.h>
+
+#include <protocols/secure_channel/CachedSessionResumptionStorage.h>
+#include <system/SystemClock.h>
+#include <transport/raw/tests/NetworkTestHelpers.h>
+
+namespace {
+
+constexpr chip::FabricIndex kFabric1 = 1;
+constexpr chip::FabricIndex kFabric2 = 2;
+
+struct TestVector
+{
+    chip::ScopedNodeId node;
+    chip::SessionResumptionStorage::ResumptionIdStorage resumptionId;
+    chip::Crypto::P256ECDHDerivedSecret sharedSecret;
+    chip::CATValues cats;
+};
+
+void MakeVector(TestVector & vector, chip::NodeId nodeId, chip::FabricIndex fabricIndex)
+{
+    vector.node = chip::ScopedNodeId(nodeId, fabricIndex);
+    vector.resumptionId.fill(static_cast<uint8_t>(nodeId));
+    vector.sharedSecret.SetLength(vector.sharedSecret.Capacity());
+    memset(vector.sharedSecret.Bytes(), static_cast<int>(nodeId + 0x80), vector.sharedSecret.Length());
+    vector.cats.values[0] = static_cast<chip::CASEAuthTag>(nodeId << 16 | 1);
+}
+
+bool IsStored(chip::SessionResumptionStorage & sessionStorage, const TestVector & vector)
+{
+    chip::SessionResumptionStorage::ResumptionIdStorage resumptionId;
+    chip::Crypto::P256ECDHDerivedSecret sharedSecret;
+    chip::CATValues cats;
+    if (sessionStorage.FindByScopedNodeId(vector.node, resumptionId, sharedSecret, cats) != CHIP_NO_ERROR ||
+        resumptionId != vector.resumptionId || cats != vector.cats ||
+        memcmp(sharedSecret.ConstBytes(), vector.sharedSecret.ConstBytes(), vector.sharedSecret.Length()) != 0)
+    {
+        return false;
+    }
+
+    chip::ScopedNodeId node;
+    return sessionStorage.FindByResumptionId(vector.resumptionId, node, sharedSecret, cats) == CHIP_NO_ERROR &&
+        node == vector.node;
+}
+
+void TestWriteBack(nlTestSuite * inSuite, void * inContext)
+{
+    chip::TestPersistentStorageDelegate storage;
+    chip::CachedSessionResumptionStorage sessionStorage;
+    NL_TEST_ASSERT(inSuite, sessionStorage.Init(&storage, nullptr) == CHIP_NO_ERROR);
+
+    TestVector vector;
+    MakeVector(vector, 1, kFabric1);
+    NL_TEST_ASSERT(inSuite,
+                   sessionStorage.Save(vector.node, vector.resumptionId, vector.sharedSecret, vector.cats) == CHIP_NO_ERROR);
+
+    // Nothing is written yet, but the record is found.
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 0);
+    NL_TEST_ASSERT(inSuite, sessionStorage.HasPendingWrites());
+    NL_TEST_ASSERT(inSuite, IsStored(sessionStorage, vector));
+
+    // Index, state and link.
+    NL_TEST_ASSERT(inSuite, sessionStorage.Flush() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !sessionStorage.HasPendingWrites());
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 3);
+
+    chip::SimpleSessionResumptionStorage reloaded;
+    NL_TEST_ASSERT(inSuite, reloaded.Init(&storage) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, IsStored(reloaded, vector));
+
+    // Lookups of known records do not go to storage.
+    storage.ClearStorage();
+    NL_TEST_ASSERT(inSuite, IsStored(sessionStorage, vector));
+
+    sessionStorage.Shutdown();
+}
+
+void TestDeleteBeforeFlush(nlTestSuite * inSuite, void * inContext)
+{
+    chip::TestPersistentStorageDelegate storage;
+    chip::CachedSessionResumptionStorage sessionStorage;
+    NL_TEST_ASSERT(inSuite, sessionStorage.Init(&storage, nullptr) == CHIP_NO_ERROR);
+
+    TestVector vectors[2];
+    MakeVector(vectors[0], 1, kFabric1);
+    MakeVector(vectors[1], 2, kFabric2);
+    for (auto & vector : vectors)
+    {
+        NL_TEST_ASSERT(inSuite,
+                       sessionStorage.Save(vector.node, vector.resumptionId, vector.sharedSecret, vector.cats) == CHIP_NO_ERROR);
+    }
+
+    NL_TEST_ASSERT(inSuite, sessionStorage.Delete(vectors[0].node) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sessionStorage.DeleteAll(kFabric2) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !IsStored(sessionStorage, vectors[0]));
+    NL_TEST_ASSERT(inSuite, !IsStored(sessionStorage, vectors[1]));
+
+    // Only the empty index is left to write.
+    NL_TEST_ASSERT(inSuite, sessionStorage.Flush() == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 1);
+    NL_TEST_ASSERT(inSuite, storage.HasKey(chip::DefaultStorageKeyAllocator::SessionResumptionIndex().KeyName()));
+
+    sessionStorage.Shutdown();
+}
+
+void TestFlushTimer(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr chip::System::Clock::Milliseconds32 kFlushInterval(1000);
+    chip::System::Clock::Internal::MockClock mockClock;
+    chip::System::Clock::ClockBase * realClock = &chip::System::SystemClock();
+    chip::System::Clock::Internal::SetSystemClockForTesting(&mockClock);
+
+    chip::Test::IOContext io;
+    NL_TEST_ASSERT(inSuite, io.Init() == CHIP_NO_ERROR);
+
+    chip::TestPersistentStorageDelegate storage;
+    chip::CachedSessionResumptionStorage sessionStorage;
+    NL_TEST_ASSERT(inSuite, sessionStorage.Init(&storage, &io.GetSystemLayer(), kFlushInterval) == CHIP_NO_ERROR);
+
+    TestVector vectors[2];
+    MakeVector(vectors[0], 1, kFabric1);
+    MakeVector(vectors[1], 2, kFabric1);
+    NL_TEST_ASSERT(inSuite,
+                   sessionStorage.Save(vectors[0].node, vectors[0].resumptionId, vectors[0].sharedSecret, vectors[0].cats) ==
+                       CHIP_NO_ERROR);
+
+    // Nothing is written before the flush interval has elapsed.
+    mockClock.AdvanceMonotonic(kFlushInterval - chip::System::Clock::Milliseconds32(1));
+    io.DriveIO();
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 0);
+    NL_TEST_ASSERT(inSuite, sessionStorage.HasPendingWrites());
+
+    // Then the timer writes the index, state and link.
+    mockClock.AdvanceMonotonic(chip::System::Clock::Milliseconds32(1));
+    io.DriveIO();
+    NL_TEST_ASSERT(inSuite, !sessionStorage.HasPendingWrites());
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 3);
+
+    // A later change schedules another flush.
+    NL_TEST_ASSERT(inSuite,
+                   sessionStorage.Save(vectors[1].node, vectors[1].resumptionId, vectors[1].sharedSecret, vectors[1].cats) ==
+                       CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sessionStorage.HasPendingWrites());
+    mockClock.AdvanceMonotonic(kFlushInterval);
+    io.DriveIO();
+    NL_TEST_ASSERT(inSuite, !sessionStorage.HasPendingWrites());
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 5);
+
+    chip::SimpleSessionResumptionStorage reloaded;
+    NL_TEST_ASSERT(inSuite, reloaded.Init(&storage) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, IsStored(reloaded, vectors[0]));
+    NL_TEST_ASSERT(inSuite, IsStored(reloaded, vectors[1]));
+
+    sessionStorage.Shutdown();
+    io.Shutdown();
+    chip::System::Clock::Internal::SetSystemClockForTesting(realClock);
+}
+
+void TestInterruptedFlush(nlTestSuite * inSuite, void * inContext)
+{
+    chip::TestPersistentStorageDelegate storage;
+    chip::CachedSessionResumptionStorage sessionStorage;
+    NL_TEST_ASSERT(inSuite, sessionStorage.Init(&storage, nullptr) == CHIP_NO_ERROR);
+
+    TestVector vectors[3];
+    MakeVector(vectors[0], 1, kFabric1);
+    MakeVector(vectors[1], 2, kFabric1);
+    MakeVector(vectors[2], 3, kFabric1);
+
+    NL_TEST_ASSERT(inSuite,
+                   sessionStorage.Save(vectors[0].node, vectors[0].resumptionId, vectors[0].sharedSecret, vectors[0].cats) ==
+                       CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sessionStorage.Flush() == CHIP_NO_ERROR);
+
+    // The state of the second record cannot be written, as if the device reset in the middle of the flush.  The third
+    // record is never flushed.
+    storage.AddPoisonKey(chip::SimpleSessionResumptionStorage::GetStorageKey(vectors[1].node).KeyName());
+    NL_TEST_ASSERT(inSuite,
+                   sessionStorage.Save(vectors[1].node, vectors[1].resumptionId, vectors[1].sharedSecret, vectors[1].cats) ==
+                       CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sessionStorage.Flush() != CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite,
+                   sessionStorage.Save(vectors[2].node, vectors[2].resumptionId, vectors[2].sharedSecret, vectors[2].cats) ==
+                       CHIP_NO_ERROR);
+    storage.ClearPoisonKeys();
+
+    // After the "reset", what made it to storage is consistent: the first record is there, and removing the fabric
+    // removes every key, so no record was written without being in the index.
+    chip::SimpleSessionResumptionStorage reloaded;
+    NL_TEST_ASSERT(inSuite, reloaded.Init(&storage) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, IsStored(reloaded, vectors[0]));
+    NL_TEST_ASSERT(inSuite, !IsStored(reloaded, vectors[1]));
+    NL_TEST_ASSERT(inSuite, !IsStored(reloaded, vectors[2]));
+
+    reloaded.DeleteAll(kFabric1);
+    NL_TEST_ASSERT(inSuite, storage.GetNumKeys() == 1);
+    NL_TEST_ASSERT(inSuite, storage.HasKey(chip::DefaultStorageKeyAllocator::SessionResumptionIndex().KeyName()));
+}
+
+} // namespace
+
+// Test Suite
+
+/**
+ *  Test Suite that lists all the test functions.
+ */
+// clang-format off
+static const nlTest sTests[] =
+{
+    NL_TEST_DEF("TestWriteBack", TestWriteBack),
+    NL_TEST_DEF("TestDeleteBeforeFlush", TestDeleteBeforeFlush),
+    NL_TEST_DEF("TestFlushTimer", TestFlushTimer),
+    NL_TEST_DEF("TestInterruptedFlush", TestInterruptedFlush),
+
+    NL_TEST_SENTINEL()
+};
+// clang-format on
+
+// clang-format off
+static nlTestSuite sSuite =
+{
+    "Test-CHIP-CachedSessionResumptionStorage",
+    &sTests[0],
+    nullptr,
+    nullptr,
+};
+// clang-format on
+
+/**
+ *  Main
+ */
+int TestCachedSessionResumptionStorage()
+{
+    // Run test suit against one context
+    nlTestRunner(&sSuite, nullptr);
+
+    return (nlTestRunnerStats(&sSuite));
+}
+
+CHIP_REGISTER_TEST_SUITE(TestCachedSessionResumptionStorage)
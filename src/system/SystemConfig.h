@@ -634,6 +634,18 @@ struct LwIPEvent;
 #define CHIP_SYSTEM_CONFIG_VALID_REAL_TIME_THRESHOLD 946684800
 #endif // CHIP_SYSTEM_CONFIG_VALID_REAL_TIME_THRESHOLD
 
+/**
+ *  @def CHIP_SYSTEM_CONFIG_USE_EPOLL
+ *
+ *  @brief
+ *      Use the Linux epoll(7) based System::Layer implementation (LayerImplEpoll).
+ *
+ *  Defaults to disabled; set through the chip_system_config_event_loop GN argument.
+ */
+#ifndef CHIP_SYSTEM_CONFIG_USE_EPOLL
+#define CHIP_SYSTEM_CONFIG_USE_EPOLL 0
+#endif // CHIP_SYSTEM_CONFIG_USE_EPOLL
+
 /**
  *  @def CHIP_SYSTEM_CONFIG_USE_POSIX_PIPE
  *
@@ -642,10 +654,12 @@ struct LwIPEvent;
  *
  *  Use the POSIX pipe() function to create an anonymous data stream.
  *
- *  Defaults to enabled if the system is using sockets (except for Zephyr RTOS).
+ *  Defaults to enabled if the system is using sockets (except for Zephyr RTOS, and for the epoll
+ *  System::Layer, which wakes up through an eventfd instead).
  */
 #ifndef CHIP_SYSTEM_CONFIG_USE_POSIX_PIPE
-#if (CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK) && !defined(__ZEPHYR__) && !defined(__MBED__)
+#if (CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_NETWORK_FRAMEWORK) && !defined(__ZEPHYR__) && !defined(__MBED__) &&    \
+    !CHIP_SYSTEM_CONFIG_USE_EPOLL
 #define CHIP_SYSTEM_CONFIG_USE_POSIX_PIPE 1
 #else
 #define CHIP_SYSTEM_CONFIG_USE_POSIX_PIPE 0
@@ -0,0 +1,545 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements Layer using epoll(7) and timerfd_create(2).
+ *
+ *      Unlike the select() implementation, the per-iteration cost is proportional to the number of ready file
+ *      descriptors rather than the number of watched ones, and file descriptor values are not limited by FD_SETSIZE.
+ */
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/TimeUtils.h>
+#include <platform/LockTracker.h>
+#include <system/SystemFaultInjection.h>
+#include <system/SystemLayer.h>
+#include <system/SystemLayerImplEpoll.h>
+
+#include <errno.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+// Choose an approximation of PTHREAD_NULL if pthread.h doesn't define one.
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING && !defined(PTHREAD_NULL)
+#define PTHREAD_NULL 0
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING && !defined(PTHREAD_NULL)
+
+namespace chip {
+namespace System {
+
+namespace {
+
+// The timerfd is registered with a null data pointer; socket watches always carry a non-null one.
+constexpr void * kTimerFdTag = nullptr;
+
+} // anonymous namespace
+
+CHIP_ERROR LayerImplEpoll::Init()
+{
+    CHIP_ERROR err        = CHIP_NO_ERROR;
+    struct epoll_event ev = {};
+
+    VerifyOrReturnError(mLayerState.SetInitializing(), CHIP_ERROR_INCORRECT_STATE);
+
+    RegisterPOSIXErrorFormatter();
+
+    for (auto & w : mSocketWatchPool)
+    {
+        w.Clear();
+    }
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    mHandleEventsThread = PTHREAD_NULL;
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+    mEpollFD = ::epoll_create1(EPOLL_CLOEXEC);
+    VerifyOrExit(mEpollFD >= 0, err = CHIP_ERROR_POSIX(errno));
+
+    mTimerFD = ::timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    VerifyOrExit(mTimerFD >= 0, err = CHIP_ERROR_POSIX(errno));
+
+    ev.events   = EPOLLIN;
+    ev.data.ptr = kTimerFdTag;
+    VerifyOrExit(::epoll_ctl(mEpollFD, EPOLL_CTL_ADD, mTimerFD, &ev) == 0, err = CHIP_ERROR_POSIX(errno));
+
+    mEpollTimeout = -1;
+    mEpollResult  = 0;
+    mTimerFdArmed = false;
+
+    // Create an event to allow an arbitrary thread to wake the thread in the event loop.
+    SuccessOrExit(err = mWakeEvent.Open(*this));
+
+    VerifyOrReturnError(mLayerState.SetInitialized(), CHIP_ERROR_INCORRECT_STATE);
+    return CHIP_NO_ERROR;
+
+exit:
+    if (mTimerFD >= 0)
+    {
+        ::close(mTimerFD);
+        mTimerFD = kInvalidFd;
+    }
+    if (mEpollFD >= 0)
+    {
+        ::close(mEpollFD);
+        mEpollFD = kInvalidFd;
+    }
+    mLayerState.ResetFromInitializing(); // Return to uninitialized state to permit a retry.
+    return err;
+}
+
+void LayerImplEpoll::Shutdown()
+{
+    VerifyOrReturn(mLayerState.SetShuttingDown());
+
+    mTimerList.Clear();
+    mTimerPool.ReleaseAll();
+
+    mWakeEvent.Close(*this);
+
+    if (mTimerFD >= 0)
+    {
+        VerifyOrDie(::close(mTimerFD) == 0);
+        mTimerFD = kInvalidFd;
+    }
+    if (mEpollFD >= 0)
+    {
+        VerifyOrDie(::close(mEpollFD) == 0);
+        mEpollFD = kInvalidFd;
+    }
+
+    mLayerState.ResetFromShuttingDown(); // Return to uninitialized state to permit re-initialization.
+}
+
+void LayerImplEpoll::Signal()
+{
+    /*
+     * Wake up the I/O thread by notifying the wake event.
+     *
+     * If this is being called from within an I/O event callback, then notifying can be skipped,
+     * since the I/O thread is already awake.
+     *
+     * Furthermore, we don't care if this fails as the only reasonably likely failure is that the event counter
+     * is saturated, in which case the epoll calling thread is going to wake up anyway.
+     */
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    if (pthread_equal(mHandleEventsThread, pthread_self()))
+    {
+        return;
+    }
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+    CHIP_ERROR status = mWakeEvent.Notify();
+    if (status != CHIP_NO_ERROR)
+    {
+        ChipLogError(chipSystemLayer, "System wake event notify failed: %" CHIP_ERROR_FORMAT, status.Format());
+    }
+}
+
+CHIP_ERROR LayerImplEpoll::StartTimer(Clock::Timeout delay, TimerCompleteCallback onComplete, void * appState)
+{
+    assertChipStackLockedByCurrentThread();
+
+    VerifyOrReturnError(mLayerState.IsInitialized(), CHIP_ERROR_INCORRECT_STATE);
+
+    CHIP_SYSTEM_FAULT_INJECT(FaultInjection::kFault_TimeoutImmediate, delay = System::Clock::kZero);
+
+    CancelTimer(onComplete, appState);
+
+    TimerList::Node * timer = mTimerPool.Create(*this, SystemClock().GetMonotonicTimestamp() + delay, onComplete, appState);
+    VerifyOrReturnError(timer != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    if (mTimerList.Add(timer) == timer)
+    {
+        // The new timer is the earliest, so the time until the next event has probably changed.
+        Signal();
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::ExtendTimerTo(Clock::Timeout delay, TimerCompleteCallback onComplete, void * appState)
+{
+    VerifyOrReturnError(delay.count() > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    assertChipStackLockedByCurrentThread();
+
+    Clock::Timeout remainingTime = mTimerList.GetRemainingTime(onComplete, appState);
+    if (remainingTime.count() < delay.count())
+    {
+        if (remainingTime == Clock::kZero)
+        {
+            // If remaining time is Clock::kZero, it might possible that our timer is in
+            // the mExpiredTimers list and about to be fired. Remove it from that list, since we are extending it.
+            mExpiredTimers.Remove(onComplete, appState);
+        }
+        return StartTimer(delay, onComplete, appState);
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+bool LayerImplEpoll::IsTimerActive(TimerCompleteCallback onComplete, void * appState)
+{
+    bool timerIsActive = (mTimerList.GetRemainingTime(onComplete, appState) > Clock::kZero);
+
+    if (!timerIsActive)
+    {
+        // check if the timer is in the mExpiredTimers list about to be fired.
+        for (TimerList::Node * timer = mExpiredTimers.Earliest(); timer != nullptr; timer = timer->mNextTimer)
+        {
+            if (timer->GetCallback().GetOnComplete() == onComplete && timer->GetCallback().GetAppState() == appState)
+            {
+                return true;
+            }
+        }
+    }
+
+    return timerIsActive;
+}
+
+void LayerImplEpoll::CancelTimer(TimerCompleteCallback onComplete, void * appState)
+{
+    assertChipStackLockedByCurrentThread();
+
+    VerifyOrReturn(mLayerState.IsInitialized());
+
+    TimerList::Node * timer = mTimerList.Remove(onComplete, appState);
+    if (timer == nullptr)
+    {
+        // The timer was not in our "will fire in the future" list, but it might
+        // be in the "we're about to fire these" chunk we already grabbed from
+        // that list.  Check for it there too, and if found there we still want
+        // to cancel it.
+        timer = mExpiredTimers.Remove(onComplete, appState);
+    }
+    VerifyOrReturn(timer != nullptr);
+
+    mTimerPool.Release(timer);
+    Signal();
+}
+
+CHIP_ERROR LayerImplEpoll::ScheduleWork(TimerCompleteCallback onComplete, void * appState)
+{
+    assertChipStackLockedByCurrentThread();
+
+    VerifyOrReturnError(mLayerState.IsInitialized(), CHIP_ERROR_INCORRECT_STATE);
+
+    // Same approach as LayerImplSelect::ScheduleWork(): use an expires-ASAP timer as a closure over
+    // `this`, onComplete and appState, without cancelling existing timers with the same callback and appState.
+    TimerList::Node * timer = mTimerPool.Create(*this, SystemClock().GetMonotonicTimestamp(), onComplete, appState);
+    VerifyOrReturnError(timer != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    if (mTimerList.Add(timer) == timer)
+    {
+        // The new timer is the earliest, so the time until the next event has probably changed.
+        Signal();
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::StartWatchingSocket(int fd, SocketWatchToken * tokenOut)
+{
+    // Find a free slot.
+    SocketWatch * watch = nullptr;
+    for (auto & w : mSocketWatchPool)
+    {
+        if (w.mFD == fd)
+        {
+            // Duplicate registration is an error.
+            return CHIP_ERROR_INVALID_ARGUMENT;
+        }
+        if ((w.mFD == kInvalidFd) && (watch == nullptr))
+        {
+            watch = &w;
+        }
+    }
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_ENDPOINT_POOL_FULL);
+
+    watch->mFD = fd;
+
+    *tokenOut = reinterpret_cast<SocketWatchToken>(watch);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::SetCallback(SocketWatchToken token, SocketWatchCallback callback, intptr_t data)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    watch->mCallback     = callback;
+    watch->mCallbackData = data;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::RequestCallbackOnPendingRead(SocketWatchToken token)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    watch->mPendingIO.Set(SocketEventFlags::kRead);
+    return UpdateEpollInterest(*watch);
+}
+
+CHIP_ERROR LayerImplEpoll::RequestCallbackOnPendingWrite(SocketWatchToken token)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    watch->mPendingIO.Set(SocketEventFlags::kWrite);
+    return UpdateEpollInterest(*watch);
+}
+
+CHIP_ERROR LayerImplEpoll::ClearCallbackOnPendingRead(SocketWatchToken token)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    watch->mPendingIO.Clear(SocketEventFlags::kRead);
+    return UpdateEpollInterest(*watch);
+}
+
+CHIP_ERROR LayerImplEpoll::ClearCallbackOnPendingWrite(SocketWatchToken token)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(token);
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    watch->mPendingIO.Clear(SocketEventFlags::kWrite);
+    return UpdateEpollInterest(*watch);
+}
+
+CHIP_ERROR LayerImplEpoll::StopWatchingSocket(SocketWatchToken * tokenInOut)
+{
+    SocketWatch * watch = reinterpret_cast<SocketWatch *>(*tokenInOut);
+    *tokenInOut         = InvalidSocketWatchToken();
+
+    VerifyOrReturnError(watch != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(watch->mFD >= 0, CHIP_ERROR_INCORRECT_STATE);
+
+    if (watch->mInEpollSet)
+    {
+        // The descriptor must still be open here (see LayerSockets::StopWatchingSocket()), but a failure only means the
+        // kernel has already dropped it from the interest list.
+        (void) ::epoll_ctl(mEpollFD, EPOLL_CTL_DEL, watch->mFD, nullptr);
+    }
+    watch->Clear();
+
+    // Unlike select(), epoll does not need to be woken up to stop watching the socket, since the interest list
+    // lives in the kernel.
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR LayerImplEpoll::UpdateEpollInterest(SocketWatch & watch)
+{
+    VerifyOrReturnError(watch.mFD >= 0, CHIP_ERROR_INCORRECT_STATE);
+
+    // Socket endpoints consume a single datagram (or a bounded amount of stream data) per callback, so watches are
+    // level-triggered: any data left in the socket is reported again on the next iteration.
+    struct epoll_event ev = {};
+    ev.events             = (watch.mPendingIO.Has(SocketEventFlags::kRead) ? EPOLLIN : 0u) |
+        (watch.mPendingIO.Has(SocketEventFlags::kWrite) ? EPOLLOUT : 0u);
+    ev.data.ptr = &watch;
+
+    int op;
+    if (ev.events == 0)
+    {
+        VerifyOrReturnError(watch.mInEpollSet, CHIP_NO_ERROR);
+        op = EPOLL_CTL_DEL;
+    }
+    else
+    {
+        op = watch.mInEpollSet ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    }
+
+    if (::epoll_ctl(mEpollFD, op, watch.mFD, &ev) != 0)
+    {
+        return CHIP_ERROR_POSIX(errno);
+    }
+    watch.mInEpollSet = (op != EPOLL_CTL_DEL);
+
+    return CHIP_NO_ERROR;
+}
+
+/**
+ *  Translate the event mask reported by epoll_wait() into SocketEvents.
+ *
+ *  Hang-up and error conditions are reported as both readable and writable so that the socket owner notices them
+ *  through its next I/O call, which mirrors how select() reports such descriptors.
+ *
+ *  @param[in]    epollEvents   The events field of a struct epoll_event.
+ */
+SocketEvents LayerImplEpoll::SocketEventsFromEpollEvents(uint32_t epollEvents)
+{
+    SocketEvents res;
+
+    if (epollEvents & (EPOLLIN | EPOLLHUP | EPOLLERR))
+        res.Set(SocketEventFlags::kRead);
+    if (epollEvents & (EPOLLOUT | EPOLLHUP | EPOLLERR))
+        res.Set(SocketEventFlags::kWrite);
+    if (epollEvents & EPOLLERR)
+        res.Set(SocketEventFlags::kExcept);
+
+    return res;
+}
+
+void LayerImplEpoll::ArmTimerFd(Clock::Timeout sleepTime)
+{
+    struct itimerspec spec = {};
+
+    // An all-zero it_value disarms a timerfd, so a due timer is handled by a zero epoll_wait() timeout instead.
+    if (sleepTime > Clock::kZero)
+    {
+        const Clock::Microseconds64 us = std::chrono::duration_cast<Clock::Microseconds64>(sleepTime);
+        spec.it_value.tv_sec           = static_cast<time_t>(us.count() / kMicrosecondsPerSecond);
+        spec.it_value.tv_nsec          = static_cast<long>((us.count() % kMicrosecondsPerSecond) * kNanosecondsPerMicrosecond);
+    }
+
+    if (::timerfd_settime(mTimerFD, 0, &spec, nullptr) != 0)
+    {
+        ChipLogError(chipSystemLayer, "timerfd_settime failed: %" CHIP_ERROR_FORMAT, CHIP_ERROR_POSIX(errno).Format());
+        mTimerFdArmed = false;
+        return;
+    }
+    mTimerFdArmed = (sleepTime > Clock::kZero);
+}
+
+void LayerImplEpoll::ConfirmTimerFd()
+{
+    // The timerfd is one-shot, so it is disarmed once it has expired.
+    mTimerFdArmed = false;
+
+    uint64_t expirations;
+    if (::read(mTimerFD, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+    {
+        ChipLogError(chipSystemLayer, "timerfd read failed: %" CHIP_ERROR_FORMAT, CHIP_ERROR_POSIX(errno).Format());
+    }
+}
+
+void LayerImplEpoll::PrepareEvents()
+{
+    assertChipStackLockedByCurrentThread();
+
+    const Clock::Timestamp currentTime = SystemClock().GetMonotonicTimestamp();
+
+    TimerList::Node * timer = mTimerList.Earliest();
+    if (timer != nullptr && timer->AwakenTime() <= currentTime)
+    {
+        // Already due: do not block at all.
+        mEpollTimeout = 0;
+        return;
+    }
+
+    mEpollTimeout = -1;
+    if (timer == nullptr)
+    {
+        // Leaving a stale deadline armed only costs a spurious wakeup, so avoid the syscall unless it is armed.
+        if (mTimerFdArmed)
+        {
+            ArmTimerFd(Clock::kZero);
+        }
+        return;
+    }
+
+    // Most loop iterations do not change the earliest deadline, so only reprogram the timerfd when it does.
+    if (!mTimerFdArmed || mTimerFdAwakenTime != timer->AwakenTime())
+    {
+        ArmTimerFd(timer->AwakenTime() - currentTime);
+        mTimerFdAwakenTime = timer->AwakenTime();
+    }
+}
+
+void LayerImplEpoll::WaitForEvents()
+{
+    mEpollResult = ::epoll_wait(mEpollFD, mEpollEvents, kEpollEventsMax, mEpollTimeout);
+}
+
+void LayerImplEpoll::HandleEvents()
+{
+    assertChipStackLockedByCurrentThread();
+
+    if (!IsEpollResultValid())
+    {
+        // EINTR is not an error worth reporting: timers and sockets will simply be serviced on the next iteration.
+        if (errno != EINTR)
+        {
+            ChipLogError(DeviceLayer, "epoll_wait failed: %" CHIP_ERROR_FORMAT, CHIP_ERROR_POSIX(errno).Format());
+        }
+        return;
+    }
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    mHandleEventsThread = pthread_self();
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+    // Obtain the list of currently expired timers. Any new timers added by timer callback are NOT handled on this pass,
+    // since that could result in infinite handling of new timers blocking any other progress.
+    VerifyOrDieWithMsg(mExpiredTimers.Empty(), DeviceLayer, "Re-entry into HandleEvents from a timer callback?");
+    mExpiredTimers          = mTimerList.ExtractEarlier(Clock::Timeout(1) + SystemClock().GetMonotonicTimestamp());
+    TimerList::Node * timer = nullptr;
+    while ((timer = mExpiredTimers.PopEarliest()) != nullptr)
+    {
+        mTimerPool.Invoke(timer);
+    }
+
+    for (int i = 0; i < mEpollResult; i++)
+    {
+        const struct epoll_event & ev = mEpollEvents[i];
+        if (ev.data.ptr == kTimerFdTag)
+        {
+            ConfirmTimerFd();
+            continue;
+        }
+
+        // A previous callback in this batch may have stopped watching this descriptor (or re-requested a different
+        // set of events), so only deliver what is still being asked for.
+        SocketWatch * watch = static_cast<SocketWatch *>(ev.data.ptr);
+        if (watch->mFD == kInvalidFd || watch->mCallback == nullptr)
+        {
+            continue;
+        }
+
+        SocketEvents events = SocketEventsFromEpollEvents(ev.events);
+        if (!watch->mPendingIO.Has(SocketEventFlags::kRead))
+        {
+            events.Clear(SocketEventFlags::kRead);
+        }
+        if (!watch->mPendingIO.Has(SocketEventFlags::kWrite))
+        {
+            events.Clear(SocketEventFlags::kWrite);
+        }
+        if (events.HasAny())
+        {
+            watch->mCallback(events, watch->mCallbackData);
+        }
+    }
+    mEpollResult = 0;
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    mHandleEventsThread = PTHREAD_NULL;
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+}
+
+void LayerImplEpoll::SocketWatch::Clear()
+{
+    mFD = kInvalidFd;
+    mPendingIO.ClearAll();
+    mCallback     = nullptr;
+    mCallbackData = 0;
+    mInEpollSet   = false;
+}
+
+} // namespace System
+} // namespace chip
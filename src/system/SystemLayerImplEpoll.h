@@ -0,0 +1,148 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file declares an implementation of System::Layer using Linux epoll(7),
+ *      with timers driven by a timerfd.
+ */
+
+#pragma once
+
+#include "system/SystemConfig.h"
+
+#if !CHIP_SYSTEM_CONFIG_USE_SOCKETS || CHIP_SYSTEM_CONFIG_USE_LIBEV || CHIP_SYSTEM_CONFIG_USE_DISPATCH
+#error "The epoll System::Layer requires sockets and is mutually exclusive with libev and dispatch"
+#endif
+
+#include <sys/epoll.h>
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+#include <atomic>
+#include <pthread.h>
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
+#include <lib/support/ObjectLifeCycle.h>
+#include <system/SystemLayer.h>
+#include <system/SystemTimer.h>
+#include <system/WakeEvent.h>
+
+namespace chip {
+namespace System {
+
+class LayerImplEpoll : public LayerSocketsLoop
+{
+public:
+    LayerImplEpoll() = default;
+    ~LayerImplEpoll() override { VerifyOrDie(mLayerState.Destroy()); }
+
+    // Layer overrides.
+    CHIP_ERROR Init() override;
+    void Shutdown() override;
+    bool IsInitialized() const override { return mLayerState.IsInitialized(); }
+    CHIP_ERROR StartTimer(Clock::Timeout delay, TimerCompleteCallback onComplete, void * appState) override;
+    CHIP_ERROR ExtendTimerTo(Clock::Timeout delay, TimerCompleteCallback onComplete, void * appState) override;
+    bool IsTimerActive(TimerCompleteCallback onComplete, void * appState) override;
+    void CancelTimer(TimerCompleteCallback onComplete, void * appState) override;
+    CHIP_ERROR ScheduleWork(TimerCompleteCallback onComplete, void * appState) override;
+
+    // LayerSocket overrides.
+    CHIP_ERROR StartWatchingSocket(int fd, SocketWatchToken * tokenOut) override;
+    CHIP_ERROR SetCallback(SocketWatchToken token, SocketWatchCallback callback, intptr_t data) override;
+    CHIP_ERROR RequestCallbackOnPendingRead(SocketWatchToken token) override;
+    CHIP_ERROR RequestCallbackOnPendingWrite(SocketWatchToken token) override;
+    CHIP_ERROR ClearCallbackOnPendingRead(SocketWatchToken token) override;
+    CHIP_ERROR ClearCallbackOnPendingWrite(SocketWatchToken token) override;
+    CHIP_ERROR StopWatchingSocket(SocketWatchToken * tokenInOut) override;
+    SocketWatchToken InvalidSocketWatchToken() override { return reinterpret_cast<SocketWatchToken>(nullptr); }
+
+    // LayerSocketLoop overrides.
+    void Signal() override;
+    void EventLoopBegins() override {}
+    void PrepareEvents() override;
+    void WaitForEvents() override;
+    void HandleEvents() override;
+    void EventLoopEnds() override {}
+
+    // Expose the result of WaitForEvents() for non-blocking socket implementations.
+    bool IsEpollResultValid() const { return mEpollResult >= 0; }
+
+protected:
+    static SocketEvents SocketEventsFromEpollEvents(uint32_t epollEvents);
+
+    static constexpr int kSocketWatchMax = (INET_CONFIG_ENABLE_TCP_ENDPOINT ? INET_CONFIG_NUM_TCP_ENDPOINTS : 0) +
+        (INET_CONFIG_ENABLE_UDP_ENDPOINT ? INET_CONFIG_NUM_UDP_ENDPOINTS : 0);
+
+    // One extra slot so that the timerfd never competes with sockets for room in a single epoll_wait() batch.
+    static constexpr int kEpollEventsMax = kSocketWatchMax + 1;
+
+    struct SocketWatch
+    {
+        void Clear();
+        int mFD;
+        SocketEvents mPendingIO;
+        SocketWatchCallback mCallback;
+        intptr_t mCallbackData;
+        // Whether mFD is currently part of the epoll interest list.
+        bool mInEpollSet;
+    };
+
+    /**
+     * Bring the epoll registration of a watch in line with its requested events.
+     *
+     * Watches with no requested events are removed from the interest list entirely, since epoll always reports
+     * EPOLLHUP and EPOLLERR and a level-triggered registration would otherwise spin on a hung-up socket.
+     */
+    CHIP_ERROR UpdateEpollInterest(SocketWatch & watch);
+
+    void ArmTimerFd(Clock::Timeout sleepTime);
+    void ConfirmTimerFd();
+
+    SocketWatch mSocketWatchPool[kSocketWatchMax];
+
+    TimerPool<TimerList::Node> mTimerPool;
+    TimerList mTimerList;
+    // List of expired timers being processed right now.  Stored in a member so
+    // we can cancel them.
+    TimerList mExpiredTimers;
+
+    int mEpollFD = kInvalidFd;
+    int mTimerFD = kInvalidFd;
+
+    // Timeout passed to epoll_wait(): 0 when a timer is already due, -1 otherwise (the timerfd wakes us up).
+    int mEpollTimeout = -1;
+
+    // Deadline the timerfd is currently programmed for, if any.
+    bool mTimerFdArmed = false;
+    Clock::Timestamp mTimerFdAwakenTime;
+
+    // Results from epoll_wait(), carried between WaitForEvents() and HandleEvents().
+    struct epoll_event mEpollEvents[kEpollEventsMax];
+    int mEpollResult = 0;
+
+    ObjectLifeCycle mLayerState;
+    WakeEvent mWakeEvent;
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+    std::atomic<pthread_t> mHandleEventsThread;
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+};
+
+using LayerImpl = LayerImplEpoll;
+
+} // namespace System
+} // namespace chip
@@ -54,11 +54,13 @@ static const Label sStatsStrings[chip::System::Stats::kNumEntries] = {
 #endif
     "Exchange contexts",
     "Unsolicited message handlers",
+    "Retransmission table entries",
     "Platform events",
 };
 
 count_t sResourcesInUse[kNumEntries];
 count_t sHighWatermarks[kNumEntries];
+MessagingCounters sMessagingCounters;
 
 const Label * GetStrings()
 {
@@ -75,6 +77,23 @@ count_t * GetHighWatermarks()
     return sHighWatermarks;
 }
 
+MessagingCounters & GetMessagingCounters()
+{
+    return sMessagingCounters;
+}
+
+void RecordAckLatency(uint64_t latencyMs)
+{
+    size_t bucket    = 0;
+    uint64_t limitMs = kAckLatencyBucket0LimitMs;
+    while (bucket < kNumAckLatencyBuckets - 1 && latencyMs >= limitMs)
+    {
+        bucket++;
+        limitMs *= 2;
+    }
+    sMessagingCounters.mAckLatencyHistogram[bucket]++;
+}
+
 void UpdateSnapshot(Snapshot & aSnapshot)
 {
     memcpy(&aSnapshot.mResourcesInUse, &sResourcesInUse, sizeof(aSnapshot.mResourcesInUse));
@@ -44,6 +44,7 @@
 #include <lwip/stats.h>
 #endif // CHIP_SYSTEM_CONFIG_USE_LWIP
 
+#include <stddef.h>
 #include <stdint.h>
 
 namespace chip {
@@ -68,6 +69,7 @@ enum
 #endif
     kExchangeMgr_NumContexts,
     kExchangeMgr_NumUMHandlers,
+    kExchangeMgr_NumRetransEntries,
     kPlatformMgr_NumEvents,
     kNumEntries
 };
@@ -97,6 +99,26 @@ void UpdateLwipPbufCounts(void);
 typedef const char * Label;
 const Label * GetStrings();
 
+/**
+ * Number of buckets of the acknowledgement latency histogram.  Bucket 0 counts latencies below
+ * kAckLatencyBucket0LimitMs, every following bucket has twice the limit of the previous one, and the last
+ * bucket counts everything else.
+ */
+constexpr size_t kNumAckLatencyBuckets       = 8;
+constexpr uint32_t kAckLatencyBucket0LimitMs = 64;
+
+/**
+ * Cumulative counters of the reliable messaging layer.  Unlike the resource counts above, these only grow.
+ */
+struct MessagingCounters
+{
+    uint32_t mRetransmissions;
+    uint32_t mAckLatencyHistogram[kNumAckLatencyBuckets];
+};
+
+MessagingCounters & GetMessagingCounters();
+void RecordAckLatency(uint64_t latencyMs);
+
 } // namespace Stats
 } // namespace System
 } // namespace chip
@@ -151,6 +173,18 @@ const Label * GetStrings();
 #define SYSTEM_STATS_UPDATE_LWIP_PBUF_COUNTS()
 #endif // CHIP_SYSTEM_CONFIG_USE_LWIP && LWIP_STATS && MEMP_STATS
 
+#define SYSTEM_STATS_COUNT_RETRANSMISSION()                                                                                        \
+    do                                                                                                                             \
+    {                                                                                                                              \
+        chip::System::Stats::GetMessagingCounters().mRetransmissions++;                                                            \
+    } while (0)
+
+#define SYSTEM_STATS_RECORD_ACK_LATENCY(latencyMs)                                                                                 \
+    do                                                                                                                             \
+    {                                                                                                                              \
+        chip::System::Stats::RecordAckLatency(latencyMs);                                                                          \
+    } while (0)
+
 // Additional macros for testing.
 #define SYSTEM_STATS_TEST_IN_USE(entry, expected) (chip::System::Stats::GetResourcesInUse()[entry] == (expected))
 #define SYSTEM_STATS_TEST_HIGH_WATER_MARK(entry, expected) (chip::System::Stats::GetHighWatermarks()[entry] == (expected))
@@ -172,6 +206,10 @@ const Label * GetStrings();
 
 #define SYSTEM_STATS_UPDATE_LWIP_PBUF_COUNTS()
 
+#define SYSTEM_STATS_COUNT_RETRANSMISSION()
+
+#define SYSTEM_STATS_RECORD_ACK_LATENCY(latencyMs)
+
 #define SYSTEM_STATS_TEST_IN_USE(entry, expected) (true)
 #define SYSTEM_STATS_TEST_HIGH_WATER_MARK(entry, expected) (true)
 #define SYSTEM_STATS_RESET_HIGH_WATER_MARK_FOR_TESTING(entry)
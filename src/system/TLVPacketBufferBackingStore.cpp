@@ -23,11 +23,26 @@
 
 #include <system/TLVPacketBufferBackingStore.h>
 
+#include <lib/support/CodeUtils.h>
 #include <lib/support/SafeInt.h>
 
 namespace chip {
 namespace System {
 
+namespace {
+
+bool BufferContains(const PacketBufferHandle & buffer, const uint8_t * p)
+{
+    return p >= buffer->Start() && p <= buffer->Start() + buffer->MaxDataLength();
+}
+
+bool BufferEndsAt(const PacketBufferHandle & buffer, const uint8_t * p)
+{
+    return buffer->Start() + buffer->DataLength() == p;
+}
+
+} // namespace
+
 CHIP_ERROR TLVPacketBufferBackingStore::OnInit(chip::TLV::TLVReader & reader, const uint8_t *& bufStart, uint32_t & bufLen)
 {
     bufStart = mHeadBuffer->Start();
@@ -39,6 +54,17 @@ CHIP_ERROR TLVPacketBufferBackingStore::GetNextBuffer(chip::TLV::TLVReader & rea
 {
     if (mUseChainedBuffers)
     {
+        if (mCurrentBuffer.IsNull() || !BufferEndsAt(mCurrentBuffer, bufStart))
+        {
+            // Another reader sharing this store (e.g. a copy made by TLVWriter::CopyElement) has moved on to a later
+            // buffer; find the buffer this reader has just finished.
+            mCurrentBuffer = mHeadBuffer.Retain();
+            while (!mCurrentBuffer.IsNull() && !BufferEndsAt(mCurrentBuffer, bufStart))
+            {
+                mCurrentBuffer.Advance();
+            }
+            VerifyOrReturnError(!mCurrentBuffer.IsNull(), CHIP_ERROR_INVALID_ARGUMENT);
+        }
         mCurrentBuffer.Advance();
     }
     else
@@ -71,6 +97,17 @@ CHIP_ERROR TLVPacketBufferBackingStore::FinalizeBuffer(chip::TLV::TLVWriter & wr
 {
     uint8_t * endPtr = bufStart + dataLen;
 
+    if (mUseChainedBuffers && !BufferContains(mCurrentBuffer, bufStart))
+    {
+        // The writer was rolled back to a checkpoint taken before it moved on to the current buffer.
+        mCurrentBuffer = mHeadBuffer.Retain();
+        while (!BufferContains(mCurrentBuffer, bufStart))
+        {
+            mCurrentBuffer.Advance();
+            VerifyOrReturnError(!mCurrentBuffer.IsNull(), CHIP_ERROR_INVALID_ARGUMENT);
+        }
+    }
+
     intptr_t length = endPtr - mCurrentBuffer->Start();
     if (!CanCastTo<uint16_t>(length))
     {
@@ -78,6 +115,16 @@ CHIP_ERROR TLVPacketBufferBackingStore::FinalizeBuffer(chip::TLV::TLVWriter & wr
     }
     mCurrentBuffer->SetDataLength(static_cast<uint16_t>(length), mHeadBuffer);
 
+    if (mUseChainedBuffers)
+    {
+        // Anything in the buffers after this one was written past a rollback point, so it is no longer part of the
+        // encoding.  The buffers stay in the chain and are reused if the writer needs more space.
+        for (PacketBufferHandle next = mCurrentBuffer->Next(); !next.IsNull(); next.Advance())
+        {
+            next->SetDataLength(0, mHeadBuffer);
+        }
+    }
+
     return CHIP_NO_ERROR;
 }
 
@@ -51,7 +51,8 @@ public:
      * @param[in]    useChainedBuffers
      *                       If true, advance to the next buffer in the chain once all data or space
      *                       in the current buffer has been consumed; a write will allocate new
-     *                       packet buffers if necessary.
+     *                       packet buffers if necessary.  Readers copied from a reader on a
+     *                       chained store may share it.
      *
      * @note This must take place before initializing a TLV class with this backing store.
      */
@@ -118,11 +119,14 @@ public:
      *                       If true, advance to the next buffer in the chain once all space
      *                       in the current buffer has been consumed. Once all existing buffers
      *                       have been used, new PacketBuffers will be allocated as necessary.
+     *                       The writer may be rolled back to a checkpoint in an earlier buffer
+     *                       of the chain.
+     * @param[in]    maxLen  The maximum number of bytes to write, across all buffers.
      */
-    void Init(chip::System::PacketBufferHandle && buffer, bool useChainedBuffers = false)
+    void Init(chip::System::PacketBufferHandle && buffer, bool useChainedBuffers = false, uint32_t maxLen = UINT32_MAX)
     {
         mBackingStore.Init(std::move(buffer), useChainedBuffers);
-        chip::TLV::TLVWriter::Init(mBackingStore);
+        chip::TLV::TLVWriter::Init(mBackingStore, maxLen);
     }
     /**
      * Finish the writing of a TLV encoding and release ownership of the underlying PacketBuffer.
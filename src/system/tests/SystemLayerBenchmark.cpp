@@ -0,0 +1,203 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      A small benchmark for the socket-based System::Layer event loop.
+ *
+ *      The event loop implementation is a build-time choice (see chip_system_config_event_loop
+ *      in src/system/system.gni), so comparing select() against epoll means running this tool
+ *      from two builds, e.g.:
+ *
+ *          gn gen out/select --args='chip_build_tools=true'
+ *          gn gen out/epoll  --args='chip_build_tools=true chip_system_config_event_loop="Epoll"'
+ *
+ *      Each run prints one JSON object per scenario on stdout.
+ */
+
+#include <lib/support/CHIPMem.h>
+#include <lib/support/CodeUtils.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayerImpl.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+using namespace chip;
+using namespace chip::System;
+
+namespace {
+
+#if CHIP_SYSTEM_CONFIG_USE_EPOLL
+constexpr char kImplName[] = "epoll";
+#else
+constexpr char kImplName[] = "select";
+#endif
+
+constexpr uint32_t kDefaultIterations = 100000;
+
+struct Pipe
+{
+    int mRead  = kInvalidFd;
+    int mWrite = kInvalidFd;
+    SocketWatchToken mToken;
+};
+
+struct PingPongState
+{
+    Pipe * mActive;
+    uint32_t mReceived;
+};
+
+void DrainAndCount(SocketEvents events, intptr_t data)
+{
+    PingPongState * state = reinterpret_cast<PingPongState *>(data);
+    uint8_t byte;
+    if (::read(state->mActive->mRead, &byte, sizeof(byte)) == 1)
+    {
+        state->mReceived++;
+    }
+}
+
+void IgnoreEvents(SocketEvents events, intptr_t data) {}
+
+void RunLoopOnce(LayerSocketsLoop & layer)
+{
+    layer.PrepareEvents();
+    layer.WaitForEvents();
+    layer.HandleEvents();
+}
+
+void Report(const char * scenario, uint32_t idleWatches, uint32_t iterations, Clock::Microseconds64 elapsed)
+{
+    const double seconds = static_cast<double>(elapsed.count()) / 1e6;
+    printf("{\"impl\": \"%s\", \"scenario\": \"%s\", \"idle_watches\": %u, \"iterations\": %u, \"elapsed_us\": %llu, "
+           "\"ops_per_sec\": %.0f}\n",
+           kImplName, scenario, idleWatches, iterations, static_cast<unsigned long long>(elapsed.count()),
+           seconds > 0 ? iterations / seconds : 0.0);
+}
+
+/**
+ * Measure dispatch of one readable descriptor while `idleCount` other descriptors are watched but never ready.
+ * select() pays for every watched descriptor on each iteration; epoll only for the ready one.
+ */
+CHIP_ERROR BenchmarkReadDispatch(LayerSocketsLoop & layer, uint32_t idleCount, uint32_t iterations)
+{
+    Pipe pipes[64];
+    VerifyOrReturnError(idleCount + 1 <= ArraySize(pipes), CHIP_ERROR_INVALID_ARGUMENT);
+
+    PingPongState state = { &pipes[0], 0 };
+    CHIP_ERROR err      = CHIP_NO_ERROR;
+    uint32_t opened     = 0;
+
+    for (; opened <= idleCount; opened++)
+    {
+        int fds[2];
+        VerifyOrExit(::pipe(fds) == 0, err = CHIP_ERROR_POSIX(errno));
+        pipes[opened].mRead  = fds[0];
+        pipes[opened].mWrite = fds[1];
+        SuccessOrExit(err = layer.StartWatchingSocket(pipes[opened].mRead, &pipes[opened].mToken));
+        SuccessOrExit(err = layer.SetCallback(pipes[opened].mToken, (opened == 0) ? DrainAndCount : IgnoreEvents,
+                                              reinterpret_cast<intptr_t>(&state)));
+        SuccessOrExit(err = layer.RequestCallbackOnPendingRead(pipes[opened].mToken));
+    }
+
+    {
+        const Clock::Microseconds64 start = SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            const uint8_t byte = 1;
+            VerifyOrExit(::write(state.mActive->mWrite, &byte, sizeof(byte)) == 1, err = CHIP_ERROR_POSIX(errno));
+            const uint32_t expected = state.mReceived + 1;
+            while (state.mReceived < expected)
+            {
+                RunLoopOnce(layer);
+            }
+        }
+        Report("read_dispatch", idleCount, iterations, SystemClock().GetMonotonicMicroseconds64() - start);
+    }
+
+exit:
+    for (uint32_t i = 0; i < opened; i++)
+    {
+        layer.StopWatchingSocket(&pipes[i].mToken);
+        ::close(pipes[i].mRead);
+        ::close(pipes[i].mWrite);
+    }
+    return err;
+}
+
+/**
+ * Measure the cost of ScheduleWork() round trips through the event loop, which exercises the timer path
+ * (timerfd for epoll, the select() timeout otherwise).
+ */
+CHIP_ERROR BenchmarkScheduleWork(LayerSocketsLoop & layer, uint32_t iterations)
+{
+    uint32_t completed = 0;
+
+    const Clock::Microseconds64 start = SystemClock().GetMonotonicMicroseconds64();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        ReturnErrorOnFailure(layer.ScheduleWork([](Layer *, void * appState) { (*static_cast<uint32_t *>(appState))++; },
+                                                &completed));
+        while (completed <= i)
+        {
+            RunLoopOnce(layer);
+        }
+    }
+    Report("schedule_work", 0, iterations, SystemClock().GetMonotonicMicroseconds64() - start);
+    return CHIP_NO_ERROR;
+}
+
+} // namespace
+
+int main(int argc, char * argv[])
+{
+    uint32_t iterations = kDefaultIterations;
+    if (argc > 1)
+    {
+        iterations = static_cast<uint32_t>(strtoul(argv[1], nullptr, 10));
+    }
+
+    VerifyOrDie(Platform::MemoryInit() == CHIP_NO_ERROR);
+
+    LayerImpl layer;
+    VerifyOrDie(layer.Init() == CHIP_NO_ERROR);
+
+    // The Matter event loop is not running, so the loop may be driven from this thread without the stack lock.
+    for (uint32_t idle : { 0u, 8u, 32u, 60u })
+    {
+        CHIP_ERROR err = BenchmarkReadDispatch(layer, idle, iterations);
+        if (err != CHIP_NO_ERROR)
+        {
+            fprintf(stderr, "read_dispatch(%u) failed: %" CHIP_ERROR_FORMAT "\n", idle, err.Format());
+        }
+    }
+
+    CHIP_ERROR err = BenchmarkScheduleWork(layer, iterations);
+    if (err != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "schedule_work failed: %" CHIP_ERROR_FORMAT "\n", err.Format());
+    }
+
+    layer.Shutdown();
+    Platform::MemoryShutdown();
+    return 0;
+}
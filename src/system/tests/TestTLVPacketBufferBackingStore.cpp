@@ -43,6 +43,8 @@ public:
 
     static void BasicEncodeDecode(nlTestSuite * inSuite, void * inContext);
     static void MultiBufferEncode(nlTestSuite * inSuite, void * inContext);
+    static void MultiBufferRollback(nlTestSuite * inSuite, void * inContext);
+    static void MultiBufferCopyElement(nlTestSuite * inSuite, void * inContext);
 };
 
 int TLVPacketBufferBackingStoreTest::TestSetup(void * inContext)
@@ -238,6 +240,132 @@ void TLVPacketBufferBackingStoreTest::MultiBufferEncode(nlTestSuite * inSuite, v
     NL_TEST_ASSERT(inSuite, error == CHIP_END_OF_TLV);
 }
 
+/**
+ * Test that a writer on chained buffers can be rolled back to a checkpoint in an earlier buffer.
+ */
+void TLVPacketBufferBackingStoreTest::MultiBufferRollback(nlTestSuite * inSuite, void * inContext)
+{
+    // Start with a buffer that only fits the first element.
+    auto buffer = PacketBufferHandle::New(2, 0);
+
+    PacketBufferTLVWriter writer;
+    writer.Init(std::move(buffer), /* useChainedBuffers = */ true);
+
+    CHIP_ERROR error = writer.Put(TLV::AnonymousTag(), static_cast<uint8_t>(7));
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+
+    TLV::TLVWriter backup = writer;
+
+    // Something that spans 2 more buffers, and is then rolled back.
+    uint8_t bytes[2000] = { 0 };
+    error               = writer.Put(TLV::AnonymousTag(), ByteSpan(bytes));
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+
+    static_cast<TLV::TLVWriter &>(writer) = backup;
+
+    error = writer.Put(TLV::AnonymousTag(), static_cast<uint8_t>(8));
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+
+    error = writer.Finalize(&buffer);
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, buffer->TotalLength() == 4);
+    NL_TEST_ASSERT(inSuite, buffer->DataLength() == 2);
+
+    System::TLVPacketBufferBackingStore backingStore(std::move(buffer), /* useChainedBuffers = */ true);
+    TLV::TLVReader reader;
+    reader.Init(backingStore);
+
+    uint8_t value;
+    error = reader.Next(TLV::kTLVType_UnsignedInteger, TLV::AnonymousTag());
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+    error = reader.Get(value);
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, value == 7);
+
+    error = reader.Next(TLV::kTLVType_UnsignedInteger, TLV::AnonymousTag());
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+    error = reader.Get(value);
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, value == 8);
+
+    error = reader.Next();
+    NL_TEST_ASSERT(inSuite, error == CHIP_END_OF_TLV);
+}
+
+/**
+ * Test that elements spanning chained buffers can be copied out with TLVWriter::CopyElement, which reads through a copy
+ * of the reader sharing its backing store.
+ */
+void TLVPacketBufferBackingStoreTest::MultiBufferCopyElement(nlTestSuite * inSuite, void * inContext)
+{
+    auto buffer = PacketBufferHandle::New(2, 0);
+
+    PacketBufferTLVWriter writer;
+    writer.Init(std::move(buffer), /* useChainedBuffers = */ true);
+
+    CHIP_ERROR error = writer.Put(TLV::AnonymousTag(), static_cast<uint8_t>(7));
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+
+    uint8_t bytes[2000] = { 0 };
+    error               = writer.Put(TLV::AnonymousTag(), ByteSpan(bytes));
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+
+    error = writer.Put(TLV::AnonymousTag(), static_cast<uint8_t>(8));
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+
+    error = writer.Finalize(&buffer);
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+
+    // 2 bytes per integer, and 1 control byte, 2 length bytes and 2000 bytes of data.
+    constexpr size_t totalSize = 2007;
+    NL_TEST_ASSERT(inSuite, buffer->TotalLength() == totalSize);
+
+    ScopedMemoryBuffer<uint8_t> buf;
+    NL_TEST_ASSERT(inSuite, buf.Calloc(totalSize));
+    TLV::TLVWriter copyWriter;
+    copyWriter.Init(buf.Get(), totalSize);
+
+    {
+        System::TLVPacketBufferBackingStore backingStore(std::move(buffer), /* useChainedBuffers = */ true);
+        TLV::TLVReader reader;
+        reader.Init(backingStore);
+        while ((error = reader.Next()) == CHIP_NO_ERROR)
+        {
+            error = copyWriter.CopyElement(reader);
+            NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+        }
+        NL_TEST_ASSERT(inSuite, error == CHIP_END_OF_TLV);
+    }
+
+    error = copyWriter.Finalize();
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, copyWriter.GetLengthWritten() == totalSize);
+
+    TLV::TLVReader reader;
+    reader.Init(buf.Get(), totalSize);
+
+    uint8_t value;
+    error = reader.Next(TLV::kTLVType_UnsignedInteger, TLV::AnonymousTag());
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+    error = reader.Get(value);
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, value == 7);
+
+    error = reader.Next(TLV::kTLVType_ByteString, TLV::AnonymousTag());
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, reader.GetLength() == sizeof(bytes));
+
+    error = reader.Next(TLV::kTLVType_UnsignedInteger, TLV::AnonymousTag());
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+    error = reader.Get(value);
+    NL_TEST_ASSERT(inSuite, error == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, value == 8);
+
+    error = reader.Next();
+    NL_TEST_ASSERT(inSuite, error == CHIP_END_OF_TLV);
+}
+
 /**
  *   Test Suite. It lists all the test functions.
  */
@@ -246,6 +374,8 @@ const nlTest sTests[] =
 {
     NL_TEST_DEF("BasicEncodeDecode",                    TLVPacketBufferBackingStoreTest::BasicEncodeDecode),
     NL_TEST_DEF("MultiBufferEncode",                    TLVPacketBufferBackingStoreTest::MultiBufferEncode),
+    NL_TEST_DEF("MultiBufferRollback",                  TLVPacketBufferBackingStoreTest::MultiBufferRollback),
+    NL_TEST_DEF("MultiBufferCopyElement",               TLVPacketBufferBackingStoreTest::MultiBufferCopyElement),
 
     NL_TEST_SENTINEL()
 };
@@ -355,11 +355,16 @@ void JsonBackend::LogNodeDiscovered(NodeDiscoveredInfo & info)
         value["type"] = "intermediate";
         break;
     case chip::Tracing::DiscoveryInfoType::kResolutionDone:
-        value["type"] = "done";
+        value["type"]           = "done";
+        value["lookup_time_ms"] = info.lookupTime.count();
         break;
     case chip::Tracing::DiscoveryInfoType::kRetryDifferent:
         value["type"] = "retry-different";
         break;
+    case chip::Tracing::DiscoveryInfoType::kCacheHit:
+        value["type"]           = "cache-hit";
+        value["lookup_time_ms"] = info.lookupTime.count();
+        break;
     }
 
     {
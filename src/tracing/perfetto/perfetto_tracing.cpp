@@ -103,7 +103,8 @@ void PerfettoBackend::LogNodeDiscovered(NodeDiscoveredInfo & info)
             "Matter", "NodeDiscovered Final",                             //
             "node_id", info.peerId->GetNodeId(),                          //
             "compressed_fabric_id", info.peerId->GetCompressedFabricId(), //
-            "address", address_buff                                       //
+            "address", address_buff,                                      //
+            "lookup_time_ms", info.lookupTime.count()                     //
         );
         break;
     case chip::Tracing::DiscoveryInfoType::kRetryDifferent:
@@ -114,6 +115,15 @@ void PerfettoBackend::LogNodeDiscovered(NodeDiscoveredInfo & info)
             "address", address_buff                                       //
         );
         break;
+    case chip::Tracing::DiscoveryInfoType::kCacheHit:
+        TRACE_EVENT_INSTANT(                                              //
+            "Matter", "NodeDiscovered Cache Hit",                         //
+            "node_id", info.peerId->GetNodeId(),                          //
+            "compressed_fabric_id", info.peerId->GetCompressedFabricId(), //
+            "address", address_buff,                                      //
+            "lookup_time_ms", info.lookupTime.count()                     //
+        );
+        break;
     }
 }
 
@@ -46,6 +46,7 @@ void SecureSession::Activate(const ScopedNodeId & localNode, const ScopedNodeId
     mPeerSessionId       = peerSessionId;
     mRemoteSessionParams = sessionParameters;
     SetFabricIndex(peerNode.GetFabricIndex());
+    mTable.PeerChanged(this); // Sessions are only indexed by peer once activated
     MarkActiveRx(); // Initialize SessionTimestamp and ActiveTimestamp per spec.
 
     Retain(); // This ref is released inside MarkForEviction
@@ -57,6 +58,19 @@ void SecureSession::Activate(const ScopedNodeId & localNode, const ScopedNodeId
     ChipLogDetail(Inet, "SecureSession[%p]: Activated - Type:%d LSID:%d", this, to_underlying(mSecureSessionType), mLocalSessionId);
 }
 
+CHIP_ERROR SecureSession::AdoptFabricIndex(FabricIndex fabricIndex)
+{
+    // It's not legal to augment session type for non-PASE
+    if (mSecureSessionType != Type::kPASE)
+    {
+        return CHIP_ERROR_INVALID_ARGUMENT;
+    }
+    mTable.PeerAboutToChange(this);
+    SetFabricIndex(fabricIndex);
+    mTable.PeerChanged(this);
+    return CHIP_NO_ERROR;
+}
+
 const char * SecureSession::StateToString(State state) const
 {
     switch (state)
@@ -0,0 +1,190 @@
+/*
+ *
+ *    Copyright (c) 2023 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#pragma once
+
+#include <lib/core/ScopedNodeId.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/Iterators.h>
+#include <transport/SecureSession.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace Transport {
+
+/**
+ * Smallest power of two that is at least `value`.
+ */
+constexpr size_t SecureSessionIndexSizeFor(size_t value)
+{
+    size_t size = 1;
+    while (size < value)
+    {
+        size <<= 1;
+    }
+    return size;
+}
+
+/**
+ * Indexes secure sessions by their local session ID.
+ */
+struct LocalSessionIdKey
+{
+    using Key = uint16_t;
+
+    static Key KeyOf(const SecureSession & session) { return session.GetLocalSessionId(); }
+
+    static size_t Hash(Key key)
+    {
+        uint32_t hash = static_cast<uint32_t>(key) * 0x9E3779B1u;
+        return static_cast<size_t>(hash ^ (hash >> 16));
+    }
+};
+
+/**
+ * Indexes secure sessions by the ScopedNodeId of their peer.
+ */
+struct PeerKey
+{
+    using Key = ScopedNodeId;
+
+    static Key KeyOf(const SecureSession & session) { return session.GetPeer(); }
+
+    static size_t Hash(const Key & key)
+    {
+        uint64_t hash = (key.GetNodeId() ^ (static_cast<uint64_t>(key.GetFabricIndex()) << 56)) * 0x9E3779B97F4A7C15ull;
+        hash ^= hash >> 32;
+        return static_cast<size_t>(hash ^ (hash >> 16));
+    }
+};
+
+/**
+ * An open-addressing (linear probing) hash index over the sessions of a SecureSessionTable.
+ *
+ * The index only stores pointers; the sessions are owned by the table.  The key of a session, as given by
+ * KeyTraits::KeyOf(), must not change while the session is in the index: remove it first, then add it back.
+ * Several sessions may share a key.
+ *
+ * Removal shifts the following entries of the probe sequence back instead of leaving tombstones, so lookups never
+ * degrade as sessions come and go.  At least one slot is always left empty so that every probe terminates.
+ */
+template <typename KeyTraits, size_t kNumSlots>
+class SecureSessionIndex
+{
+public:
+    using Key = typename KeyTraits::Key;
+
+    static_assert(kNumSlots >= 2 && (kNumSlots & (kNumSlots - 1)) == 0, "The number of slots must be a power of two");
+
+    SecureSessionIndex() { Clear(); }
+
+    /**
+     * Add a session to the index.
+     *
+     * @return false if the index is full.
+     */
+    bool Insert(SecureSession * session)
+    {
+        VerifyOrReturnValue(mCount + 1 < kNumSlots, false);
+
+        size_t slot = HomeSlot(KeyTraits::KeyOf(*session));
+        while (mSlots[slot] != nullptr)
+        {
+            slot = NextSlot(slot);
+        }
+        mSlots[slot] = session;
+        mCount++;
+        return true;
+    }
+
+    /**
+     * Remove a session from the index.  Does nothing if the session is not in the index.
+     */
+    void Remove(SecureSession * session)
+    {
+        size_t hole = HomeSlot(KeyTraits::KeyOf(*session));
+        while (mSlots[hole] != session)
+        {
+            VerifyOrReturn(mSlots[hole] != nullptr);
+            hole = NextSlot(hole);
+        }
+
+        // Move back every following entry of the cluster that would otherwise become unreachable from its home slot.
+        for (size_t slot = NextSlot(hole); mSlots[slot] != nullptr; slot = NextSlot(slot))
+        {
+            size_t home = HomeSlot(KeyTraits::KeyOf(*mSlots[slot]));
+            if (((slot - home) & kMask) >= ((slot - hole) & kMask))
+            {
+                mSlots[hole] = mSlots[slot];
+                hole         = slot;
+            }
+        }
+        mSlots[hole] = nullptr;
+        mCount--;
+    }
+
+    void Clear()
+    {
+        for (auto & slot : mSlots)
+        {
+            slot = nullptr;
+        }
+        mCount = 0;
+    }
+
+    /**
+     * Call function(SecureSession *) on every indexed session with the given key.  The function must not add or
+     * remove sessions, which includes releasing the last reference to one.
+     */
+    template <typename Function>
+    Loop ForEachMatching(const Key & key, Function && function) const
+    {
+        for (size_t slot = HomeSlot(key); mSlots[slot] != nullptr; slot = NextSlot(slot))
+        {
+            if (KeyTraits::KeyOf(*mSlots[slot]) == key && function(mSlots[slot]) == Loop::Break)
+            {
+                return Loop::Break;
+            }
+        }
+        return Loop::Finish;
+    }
+
+    SecureSession * Find(const Key & key) const
+    {
+        SecureSession * found = nullptr;
+        ForEachMatching(key, [&found](SecureSession * session) {
+            found = session;
+            return Loop::Break;
+        });
+        return found;
+    }
+
+    size_t Size() const { return mCount; }
+
+private:
+    static constexpr size_t kMask = kNumSlots - 1;
+
+    static size_t HomeSlot(const Key & key) { return KeyTraits::Hash(key) & kMask; }
+    static size_t NextSlot(size_t slot) { return (slot + 1) & kMask; }
+
+    SecureSession * mSlots[kNumSlots];
+    size_t mCount;
+};
+
+} // namespace Transport
+} // namespace chip
@@ -54,7 +54,13 @@ Optional<SessionHandle> SecureSessionTable::CreateNewSecureSessionForTest(Secure
 
     SecureSession * result = mEntries.CreateObject(*this, secureSessionType, localSessionId, localNodeId, peerNodeId, peerCATs,
                                                    peerSessionId, fabricIndex, config);
-    return result != nullptr ? MakeOptional<SessionHandle>(*result) : Optional<SessionHandle>::Missing();
+    VerifyOrReturnValue(result != nullptr, Optional<SessionHandle>::Missing());
+    result = IndexNewSession(result);
+    VerifyOrReturnValue(result != nullptr, Optional<SessionHandle>::Missing());
+
+    // Test sessions are created active, with their peer already known.
+    PeerChanged(result);
+    return MakeOptional<SessionHandle>(*result);
 }
 
 Optional<SessionHandle> SecureSessionTable::CreateNewSecureSession(SecureSession::Type secureSessionType,
@@ -80,6 +86,8 @@ Optional<SessionHandle> SecureSessionTable::CreateNewSecureSession(SecureSession
         allocated = EvictAndAllocate(sessionId.Value(), secureSessionType, sessionEvictionHint);
     }
 
+    VerifyOrReturnValue(allocated != nullptr, Optional<SessionHandle>::Missing());
+    allocated = IndexNewSession(allocated);
     VerifyOrReturnValue(allocated != nullptr, Optional<SessionHandle>::Missing());
 
     rv             = MakeOptional<SessionHandle>(*allocated);
@@ -89,6 +97,17 @@ Optional<SessionHandle> SecureSessionTable::CreateNewSecureSession(SecureSession
     return rv;
 }
 
+SecureSession * SecureSessionTable::IndexNewSession(SecureSession * session)
+{
+    if (!mLocalSessionIdIndex.Insert(session))
+    {
+        ChipLogError(SecureChannel, "Secure session index is full, releasing session with LSID: %d", session->GetLocalSessionId());
+        mEntries.ReleaseObject(session);
+        return nullptr;
+    }
+    return session;
+}
+
 SecureSession * SecureSessionTable::EvictAndAllocate(uint16_t localSessionId, SecureSession::Type secureSessionType,
                                                      const ScopedNodeId & sessionEvictionHint)
 {
@@ -312,65 +331,19 @@ void SecureSessionTable::DefaultEvictionPolicy(EvictionPolicyContext & evictionC
 
 Optional<SessionHandle> SecureSessionTable::FindSecureSessionByLocalKey(uint16_t localSessionId)
 {
-    SecureSession * result = nullptr;
-    mEntries.ForEachActiveObject([&](auto session) {
-        if (session->GetLocalSessionId() == localSessionId)
-        {
-            result = session;
-            return Loop::Break;
-        }
-        return Loop::Continue;
-    });
+    SecureSession * result = mLocalSessionIdIndex.Find(localSessionId);
     return result != nullptr ? MakeOptional<SessionHandle>(*result) : Optional<SessionHandle>::Missing();
 }
 
 Optional<uint16_t> SecureSessionTable::FindUnusedSessionId()
 {
-    uint16_t candidate_base = 0;
-    uint64_t candidate_mask = 0;
-    for (uint32_t i = 0; i <= kMaxSessionID; i += 64)
-    {
-        // candidate_base is the base session ID we are searching from.
-        // We have a 64-bit mask anchored at this ID and iterate over the
-        // whole session table, setting bits in the mask for in-use IDs.
-        // If we can iterate through the entire session table and have
-        // any bits clear in the mask, we have available session IDs.
-        candidate_base = static_cast<uint16_t>(i + mNextSessionId);
-        candidate_mask = 0;
-        {
-            uint16_t shift = static_cast<uint16_t>(kUnsecuredSessionId - candidate_base);
-            if (shift <= 63)
-            {
-                candidate_mask |= (1ULL << shift); // kUnsecuredSessionId is never available
-            }
-        }
-        mEntries.ForEachActiveObject([&](auto session) {
-            uint16_t shift = static_cast<uint16_t>(session->GetLocalSessionId() - candidate_base);
-            if (shift <= 63)
-            {
-                candidate_mask |= (1ULL << shift);
-            }
-            if (candidate_mask == UINT64_MAX)
-            {
-                return Loop::Break; // No bits clear means this bucket is full.
-            }
-            return Loop::Continue;
-        });
-        if (candidate_mask != UINT64_MAX)
-        {
-            break; // Any bit clear means we have an available ID in this bucket.
-        }
-    }
-    if (candidate_mask != UINT64_MAX)
+    uint16_t candidate = mNextSessionId;
+    for (uint32_t i = 0; i <= kMaxSessionID; i++, candidate++)
     {
-        uint16_t offset = 0;
-        while (candidate_mask & 1)
+        if (candidate != kUnsecuredSessionId && mLocalSessionIdIndex.Find(candidate) == nullptr)
         {
-            candidate_mask >>= 1;
-            ++offset;
+            return MakeOptional<uint16_t>(candidate);
         }
-        uint16_t available = static_cast<uint16_t>(candidate_base + offset);
-        return MakeOptional<uint16_t>(available);
     }
 
     return NullOptional;
@@ -22,6 +22,7 @@
 #include <lib/support/SortUtils.h>
 #include <system/TimeSource.h>
 #include <transport/SecureSession.h>
+#include <transport/SecureSessionIndex.h>
 
 namespace chip {
 namespace Transport {
@@ -39,7 +40,12 @@ inline constexpr uint16_t kUnsecuredSessionId = 0;
 class SecureSessionTable
 {
 public:
-    ~SecureSessionTable() { mEntries.ReleaseAll(); }
+    ~SecureSessionTable()
+    {
+        mLocalSessionIdIndex.Clear();
+        mPeerIndex.Clear();
+        mEntries.ReleaseAll();
+    }
 
     void Init() { mNextSessionId = chip::Crypto::GetRandU16(); }
 
@@ -76,7 +82,12 @@ public:
     CHECK_RETURN_VALUE
     Optional<SessionHandle> CreateNewSecureSession(SecureSession::Type secureSessionType, ScopedNodeId sessionEvictionHint);
 
-    void ReleaseSession(SecureSession * session) { mEntries.ReleaseObject(session); }
+    void ReleaseSession(SecureSession * session)
+    {
+        mLocalSessionIdIndex.Remove(session);
+        mPeerIndex.Remove(session);
+        mEntries.ReleaseObject(session);
+    }
 
     template <typename Function>
     Loop ForEachSession(Function && function)
@@ -84,6 +95,18 @@ public:
         return mEntries.ForEachActiveObject(std::forward<Function>(function));
     }
 
+    /**
+     * Call the provided function on every session whose peer is the given node, in no particular order.  Sessions
+     * that have not been activated yet have no peer and are never visited.
+     *
+     * The function must not cause sessions to be allocated or released.
+     */
+    template <typename Function>
+    Loop ForEachSessionWithPeer(const ScopedNodeId & peer, Function && function)
+    {
+        return mPeerIndex.ForEachMatching(peer, std::forward<Function>(function));
+    }
+
     /**
      * Get a secure session given its session ID.
      *
@@ -94,6 +117,16 @@ public:
     CHECK_RETURN_VALUE
     Optional<SessionHandle> FindSecureSessionByLocalKey(uint16_t localSessionId);
 
+    // Called by a SecureSession right before and right after its peer (node ID or fabric index) changes, to keep
+    // the peer index up to date.
+    // This is an internal API, using raw pointer to a session is allowed here.
+    void PeerAboutToChange(SecureSession * session) { mPeerIndex.Remove(session); }
+    void PeerChanged(SecureSession * session)
+    {
+        // Every session is in the local session ID index, which has the same number of slots, so this cannot fail.
+        VerifyOrDie(mPeerIndex.Insert(session));
+    }
+
     // Select SessionHolders which are pointing to a session with the same peer as the given session. Shift them to the given
     // session.
     // This is an internal API, using raw pointer to a session is allowed here.
@@ -243,22 +276,33 @@ private:
     /**
      * Find an available session ID that is unused in the secure session table.
      *
-     * The search algorithm iterates over the session ID space in the outer loop
-     * and the session table in the inner loop to locate an available session ID
-     * from the starting mNextSessionId clue.
-     *
-     * The outer-loop considers 64 session IDs in each iteration to give a
-     * runtime complexity of O(CHIP_CONFIG_PEER_CONNECTION_POOL_SIZE^2/64).  Speed up could be
-     * achieved with a sorted session table or additional storage.
+     * The search probes the local session ID index for successive session IDs,
+     * starting from the mNextSessionId clue.  Since at most Allocated() IDs are
+     * in use, an available one is found after at most Allocated() + 1 probes.
      *
      * @return an unused session ID if any is found, else NullOptional
      */
     CHECK_RETURN_VALUE
     Optional<uint16_t> FindUnusedSessionId();
 
+    /**
+     * Add a newly allocated session to the indexes, or release it if they are full.
+     *
+     * @return the session, or nullptr if it was released.
+     */
+    SecureSession * IndexNewSession(SecureSession * session);
+
+    // Twice as many slots as sessions keeps the probe sequences of the indexes short.
+    static constexpr size_t kIndexSlots = SecureSessionIndexSizeFor(2 * CHIP_CONFIG_SECURE_SESSION_POOL_SIZE);
+
     bool mRunningEvictionLogic = false;
     ObjectPool<SecureSession, CHIP_CONFIG_SECURE_SESSION_POOL_SIZE> mEntries;
 
+    // Every allocated session, by local session ID.
+    SecureSessionIndex<LocalSessionIdKey, kIndexSlots> mLocalSessionIdIndex;
+    // Every session that has been activated, by peer.
+    SecureSessionIndex<PeerKey, kIndexSlots> mPeerIndex;
+
     size_t GetMaxSessionTableSize() const
     {
 #if CONFIG_BUILD_FOR_HOST_UNIT_TEST
@@ -35,6 +35,7 @@
 #include <inttypes.h>
 #include <lib/core/CHIPKeyIds.h>
 #include <lib/core/Global.h>
+#include <lib/support/CHIPMemString.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/SafeInt.h>
 #include <lib/support/logging/CHIPLogging.h>
@@ -385,6 +386,37 @@ CHIP_ERROR SessionManager::SendPreparedMessage(const SessionHandle & sessionHand
         chip::Inet::IPAddress addr;
         bool interfaceFound = false;
 
+        // The copies for the different interfaces are handed to the transport in batches, so that they can leave in a
+        // single system call where the platform supports it.
+        constexpr size_t kBatchSize = INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE;
+        Transport::PeerAddress batchDestinations[kBatchSize];
+        PacketBufferHandle batchBufs[kBatchSize];
+        char batchNames[kBatchSize][chip::Inet::InterfaceId::kMaxIfNameLength];
+        size_t batchCount = 0;
+
+        auto sendBatch = [&]() {
+            if (mTransportMgr != nullptr && batchCount > 0)
+            {
+                size_t sentCount = 0;
+                CHIP_ERROR err   = mTransportMgr->SendMessages(batchDestinations, batchBufs, batchCount, sentCount);
+                if (CHIP_NO_ERROR != err)
+                {
+                    // The transport does not tell which messages failed: name all the interfaces of the batch.
+                    ChipLogError(Inet, "Failed to send Multicast message on %u of %u interfaces: %" CHIP_ERROR_FORMAT,
+                                 static_cast<unsigned>(batchCount - sentCount), static_cast<unsigned>(batchCount), err.Format());
+                    for (size_t i = 0; i < batchCount; i++)
+                    {
+                        ChipLogError(Inet, "Multicast message batch included interface %s", batchNames[i]);
+                    }
+                }
+                else
+                {
+                    ChipLogDetail(Inet, "Successfully send Multicast message on %u interfaces", static_cast<unsigned>(sentCount));
+                }
+            }
+            batchCount = 0;
+        };
+
         while (interfaceIt.Next())
         {
             char name[chip::Inet::InterfaceId::kMaxIfNameLength];
@@ -398,25 +430,35 @@ CHIP_ERROR SessionManager::SendPreparedMessage(const SessionHandle & sessionHand
 
                     interfaceFound             = true;
                     PacketBufferHandle tempBuf = msgBuf.CloneData();
-                    VerifyOrReturnError(!tempBuf.IsNull(), CHIP_ERROR_INVALID_ARGUMENT);
-                    VerifyOrReturnError(!tempBuf->HasChainedBuffer(), CHIP_ERROR_INVALID_MESSAGE_LENGTH);
+                    CHIP_ERROR err             = CHIP_NO_ERROR;
+                    if (tempBuf.IsNull())
+                    {
+                        err = CHIP_ERROR_INVALID_ARGUMENT;
+                    }
+                    else if (tempBuf->HasChainedBuffer())
+                    {
+                        err = CHIP_ERROR_INVALID_MESSAGE_LENGTH;
+                    }
+                    if (err != CHIP_NO_ERROR)
+                    {
+                        // Still send the copies queued for the previous interfaces, which went out one by one before.
+                        sendBatch();
+                        return err;
+                    }
 
-                    destination = &(multicastAddress.SetInterface(interfaceId));
-                    if (mTransportMgr != nullptr)
+                    batchDestinations[batchCount] = multicastAddress.SetInterface(interfaceId);
+                    Platform::CopyString(batchNames[batchCount], name);
+                    batchBufs[batchCount++] = std::move(tempBuf);
+                    if (batchCount == kBatchSize)
                     {
-                        if (CHIP_NO_ERROR != mTransportMgr->SendMessage(*destination, std::move(tempBuf)))
-                        {
-                            ChipLogError(Inet, "Failed to send Multicast message on interface %s", name);
-                        }
-                        else
-                        {
-                            ChipLogDetail(Inet, "Successfully send Multicast message on interface %s", name);
-                        }
+                        sendBatch();
                     }
                 }
             }
         }
 
+        sendBatch();
+
         if (!interfaceFound)
         {
             ChipLogError(Inet, "No valid Interface found.. Sending to the default one.. ");
@@ -482,9 +524,8 @@ void SessionManager::ExpireAllPASESessions()
 
 void SessionManager::MarkSessionsAsDefunct(const ScopedNodeId & node, const Optional<Transport::SecureSession::Type> & type)
 {
-    mSecureSessions.ForEachSession([&node, &type](auto session) {
-        if (session->IsActiveSession() && session->GetPeer() == node &&
-            (!type.HasValue() || type.Value() == session->GetSecureSessionType()))
+    mSecureSessions.ForEachSessionWithPeer(node, [&type](auto session) {
+        if (session->IsActiveSession() && (!type.HasValue() || type.Value() == session->GetSecureSessionType()))
         {
             session->MarkAsDefunct();
         }
@@ -494,10 +535,10 @@ void SessionManager::MarkSessionsAsDefunct(const ScopedNodeId & node, const Opti
 
 void SessionManager::UpdateAllSessionsPeerAddress(const ScopedNodeId & node, const Transport::PeerAddress & addr)
 {
-    mSecureSessions.ForEachSession([&node, &addr](auto session) {
+    mSecureSessions.ForEachSessionWithPeer(node, [&addr](auto session) {
         // Arguably we should only be updating active and defunct sessions, but there is no harm
         // in updating evicted sessions.
-        if (session->GetPeer() == node && Transport::SecureSession::Type::kCASE == session->GetSecureSessionType())
+        if (Transport::SecureSession::Type::kCASE == session->GetSecureSessionType())
         {
             session->SetPeerAddress(addr);
         }
@@ -916,6 +957,10 @@ void SessionManager::SecureGroupMessageDispatch(const PacketHeader & partialPack
         }
 #endif // CHIP_CONFIG_PRIVACY_ACCEPT_NONSPEC_SVE2
     }
+    if (decrypted)
+    {
+        groups->GroupSessionMatched(groupContext);
+    }
     iter->Release();
 
     if (!decrypted)
@@ -1010,9 +1055,8 @@ Optional<SessionHandle> SessionManager::FindSecureSessionForNode(ScopedNodeId pe
 {
     SecureSession * found = nullptr;
 
-    mSecureSessions.ForEachSession([&peerNodeId, &type, &found](auto session) {
-        if (session->IsActiveSession() && session->GetPeer() == peerNodeId &&
-            (!type.HasValue() || type.Value() == session->GetSecureSessionType()))
+    mSecureSessions.ForEachSessionWithPeer(peerNodeId, [&type, &found](auto session) {
+        if (session->IsActiveSession() && (!type.HasValue() || type.Value() == session->GetSecureSessionType()))
         {
             //
             // Select the active session with the most recent activity to return back to the caller.
@@ -30,6 +30,8 @@
 #include <transport/raw/MessageHeader.h>
 #include <transport/raw/PeerAddress.h>
 
+#include <utility>
+
 namespace chip {
 namespace Transport {
 
@@ -65,6 +67,39 @@ public:
      */
     virtual CHIP_ERROR SendMessage(const PeerAddress & address, System::PacketBufferHandle && msgBuf) = 0;
 
+    /**
+     * @brief Send a batch of messages, msgBufs[i] going to addresses[i].
+     *
+     * Every message is attempted even if an earlier one fails, and all buffers are released. Transports that can hand
+     * several datagrams to the network stack at once override this; the default sends them one by one.
+     *
+     * @param[out] sentCount  The number of messages that were sent.
+     *
+     * @return The error of the first message that could not be sent, if any.
+     */
+    virtual CHIP_ERROR SendMessages(const PeerAddress * addresses, System::PacketBufferHandle * msgBufs, size_t count,
+                                    size_t & sentCount)
+    {
+        CHIP_ERROR firstError = CHIP_NO_ERROR;
+
+        sentCount = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            CHIP_ERROR err = SendMessage(addresses[i], std::move(msgBufs[i]));
+            msgBufs[i]     = nullptr;
+            if (err == CHIP_NO_ERROR)
+            {
+                sentCount++;
+            }
+            else if (firstError == CHIP_NO_ERROR)
+            {
+                firstError = err;
+            }
+        }
+
+        return firstError;
+    }
+
     /**
      * Determine if this transport can SendMessage to the specified peer address.
      *
@@ -86,6 +86,12 @@ public:
         return SendMessageImpl<0>(address, std::move(msgBuf));
     }
 
+    CHIP_ERROR SendMessages(const PeerAddress * addresses, System::PacketBufferHandle * msgBufs, size_t count,
+                            size_t & sentCount) override
+    {
+        return SendMessagesImpl<0>(addresses, msgBufs, count, sentCount);
+    }
+
     CHIP_ERROR MulticastGroupJoinLeave(const Transport::PeerAddress & address, bool join) override
     {
         return MulticastGroupJoinLeaveImpl<0>(address, join);
@@ -208,6 +214,50 @@ private:
         return CHIP_ERROR_NO_MESSAGE_HANDLER;
     }
 
+    /**
+     * Recursive batch send implementation iterating through transport members.
+     *
+     * The batch is handed as a whole to the transport with index N if every message would be sent through it by
+     * SendMessageImpl, i.e. it is the first transport from index N or above that returns 'CanSendToPeer' for all the
+     * addresses. A batch that would be split between transports is sent one message at a time.
+     *
+     * @tparam N the index of the underlying transport to run SendMessages through.
+     */
+    template <size_t N, typename std::enable_if<(N < sizeof...(TransportTypes))>::type * = nullptr>
+    CHIP_ERROR SendMessagesImpl(const PeerAddress * addresses, System::PacketBufferHandle * msgBufs, size_t count,
+                                size_t & sentCount)
+    {
+        Base * base          = &std::get<N>(mTransports);
+        size_t sendableCount = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            if (base->CanSendToPeer(addresses[i]))
+            {
+                sendableCount++;
+            }
+        }
+
+        if (sendableCount == 0)
+        {
+            return SendMessagesImpl<N + 1>(addresses, msgBufs, count, sentCount);
+        }
+        if (sendableCount == count)
+        {
+            return base->SendMessages(addresses, msgBufs, count, sentCount);
+        }
+        return Base::SendMessages(addresses, msgBufs, count, sentCount);
+    }
+
+    /**
+     * SendMessagesImpl when N is out of range. Sends one message at a time, which reports the missing handler.
+     */
+    template <size_t N, typename std::enable_if<(N >= sizeof...(TransportTypes))>::type * = nullptr>
+    CHIP_ERROR SendMessagesImpl(const PeerAddress * addresses, System::PacketBufferHandle * msgBufs, size_t count,
+                                size_t & sentCount)
+    {
+        return Base::SendMessages(addresses, msgBufs, count, sentCount);
+    }
+
     /**
      * Recursive GroupJoinLeave implementation iterating through transport members.
      *
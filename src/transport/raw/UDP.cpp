@@ -105,11 +105,7 @@ CHIP_ERROR UDP::SendMessage(const Transport::PeerAddress & address, System::Pack
     VerifyOrReturnError(mUDPEndPoint != nullptr, CHIP_ERROR_INCORRECT_STATE);
 
     Inet::IPPacketInfo addrInfo;
-    addrInfo.Clear();
-
-    addrInfo.DestAddress = address.GetIPAddress();
-    addrInfo.DestPort    = address.GetPort();
-    addrInfo.Interface   = address.GetInterface();
+    GetPacketInfo(address, addrInfo);
 
     // Drop the message and return. Free the buffer.
     CHIP_FAULT_INJECT(FaultInjection::kFault_DropOutgoingUDPMsg, msgBuf = nullptr; return CHIP_ERROR_CONNECTION_ABORTED;);
@@ -117,6 +113,84 @@ CHIP_ERROR UDP::SendMessage(const Transport::PeerAddress & address, System::Pack
     return mUDPEndPoint->SendMsg(&addrInfo, std::move(msgBuf));
 }
 
+CHIP_ERROR UDP::SendMessages(const Transport::PeerAddress * addresses, System::PacketBufferHandle * msgBufs, size_t count,
+                             size_t & sentCount)
+{
+    constexpr size_t kBatchSize = INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE;
+
+    CHIP_ERROR firstError = CHIP_NO_ERROR;
+    auto recordError      = [&firstError](CHIP_ERROR err) {
+        if (firstError == CHIP_NO_ERROR)
+        {
+            firstError = err;
+        }
+    };
+
+    sentCount = 0;
+
+    if (mState != State::kInitialized || mUDPEndPoint == nullptr)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            msgBufs[i] = nullptr;
+        }
+        return CHIP_ERROR_INCORRECT_STATE;
+    }
+
+    size_t next = 0;
+    while (next < count)
+    {
+        // Gather the next batch, leaving out the messages that cannot go over UDP or are dropped on purpose.
+        Inet::IPPacketInfo addrInfos[kBatchSize];
+        System::PacketBufferHandle batchBufs[kBatchSize];
+        size_t batchCount = 0;
+
+        for (; next < count && batchCount < kBatchSize; next++)
+        {
+            bool drop = false;
+
+            if (addresses[next].GetTransportType() != Type::kUdp)
+            {
+                recordError(CHIP_ERROR_INVALID_ARGUMENT);
+                drop = true;
+            }
+
+            CHIP_FAULT_INJECT(FaultInjection::kFault_DropOutgoingUDPMsg, recordError(CHIP_ERROR_CONNECTION_ABORTED); drop = true;);
+
+            if (drop)
+            {
+                msgBufs[next] = nullptr;
+                continue;
+            }
+
+            GetPacketInfo(addresses[next], addrInfos[batchCount]);
+            batchBufs[batchCount++] = std::move(msgBufs[next]);
+        }
+
+        if (batchCount > 0)
+        {
+            size_t batchSentCount = 0;
+            CHIP_ERROR err        = mUDPEndPoint->SendMsgs(addrInfos, batchBufs, batchCount, batchSentCount);
+            sentCount += batchSentCount;
+            if (err != CHIP_NO_ERROR)
+            {
+                recordError(err);
+            }
+        }
+    }
+
+    return firstError;
+}
+
+void UDP::GetPacketInfo(const Transport::PeerAddress & address, Inet::IPPacketInfo & addrInfo)
+{
+    addrInfo.Clear();
+
+    addrInfo.DestAddress = address.GetIPAddress();
+    addrInfo.DestPort    = address.GetPort();
+    addrInfo.Interface   = address.GetInterface();
+}
+
 void UDP::OnUdpReceive(Inet::UDPEndPoint * endPoint, System::PacketBufferHandle && buffer, const Inet::IPPacketInfo * pktInfo)
 {
     CHIP_ERROR err          = CHIP_NO_ERROR;
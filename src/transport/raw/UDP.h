@@ -131,6 +131,13 @@ public:
 
     CHIP_ERROR SendMessage(const Transport::PeerAddress & address, System::PacketBufferHandle && msgBuf) override;
 
+    /**
+     * Send a batch of messages, handing up to INET_CONFIG_UDP_SOCKET_MMSG_BATCH_SIZE of them to the endpoint at a time
+     * so that they can go out in a single system call.
+     */
+    CHIP_ERROR SendMessages(const Transport::PeerAddress * addresses, System::PacketBufferHandle * msgBufs, size_t count,
+                            size_t & sentCount) override;
+
     CHIP_ERROR MulticastGroupJoinLeave(const Transport::PeerAddress & address, bool join) override;
 
     bool CanListenMulticast() override
@@ -145,6 +152,8 @@ public:
     }
 
 private:
+    static void GetPacketInfo(const Transport::PeerAddress & address, Inet::IPPacketInfo & addrInfo);
+
     // UDP message receive handler.
     static void OnUdpReceive(Inet::UDPEndPoint * endPoint, System::PacketBufferHandle && buffer,
                              const Inet::IPPacketInfo * pktInfo);
@@ -132,6 +132,125 @@ void TestFindByKeyId(nlTestSuite * inSuite, void * inContext)
     System::Clock::Internal::SetSystemClockForTesting(realClock);
 }
 
+void TestIndexes(nlTestSuite * inSuite, void * inContext)
+{
+    constexpr size_t kNumSessions = CHIP_CONFIG_SECURE_SESSION_POOL_SIZE;
+    SecureSessionTable connections;
+    Optional<SessionHandle> sessions[kNumSessions];
+    uint16_t localSessionIds[kNumSessions];
+    const ReliableMessageProtocolConfig kConfig(System::Clock::Milliseconds32(0), System::Clock::Milliseconds32(0),
+                                                System::Clock::Milliseconds16(0));
+
+    connections.Init();
+
+    // Allocate the whole table, and activate every other session as a CASE session with one of two peers.
+    for (size_t i = 0; i < kNumSessions; i++)
+    {
+        sessions[i] = connections.CreateNewSecureSession(SecureSession::Type::kCASE, ScopedNodeId());
+        NL_TEST_ASSERT(inSuite, sessions[i].HasValue());
+        localSessionIds[i] = sessions[i].Value()->AsSecureSession()->GetLocalSessionId();
+        NL_TEST_ASSERT(inSuite, localSessionIds[i] != kUnsecuredSessionId);
+
+        if (i % 2 == 0)
+        {
+            const NodeId peer = (i % 4 == 0) ? kCasePeer1NodeId : kCasePeer2NodeId;
+            sessions[i].Value()->AsSecureSession()->Activate(ScopedNodeId(kLocalNodeId, kFabricIndex),
+                                                             ScopedNodeId(peer, kFabricIndex), CATValues(), 1, kConfig);
+        }
+    }
+
+    for (size_t i = 0; i < kNumSessions; i++)
+    {
+        for (size_t j = 0; j < i; j++)
+        {
+            NL_TEST_ASSERT(inSuite, localSessionIds[i] != localSessionIds[j]);
+        }
+        auto found = connections.FindSecureSessionByLocalKey(localSessionIds[i]);
+        NL_TEST_ASSERT(inSuite, found.HasValue() && found.Value() == sessions[i].Value());
+    }
+
+    auto countPeerSessions = [&connections](NodeId peer) {
+        size_t count = 0;
+        connections.ForEachSessionWithPeer(ScopedNodeId(peer, kFabricIndex), [&count, peer](auto session) {
+            count += (session->GetPeerNodeId() == peer) ? 1 : 0;
+            return Loop::Continue;
+        });
+        return count;
+    };
+    NL_TEST_ASSERT(inSuite, countPeerSessions(kCasePeer1NodeId) == (kNumSessions + 3) / 4);
+    NL_TEST_ASSERT(inSuite, countPeerSessions(kCasePeer2NodeId) == (kNumSessions + 1) / 4);
+
+    // Release every third session; the others must still be found, and the released IDs must not.
+    for (size_t i = 0; i < kNumSessions; i += 3)
+    {
+        if (sessions[i].Value()->AsSecureSession()->IsActiveSession())
+        {
+            sessions[i].Value()->AsSecureSession()->MarkForEviction();
+        }
+        sessions[i].ClearValue();
+    }
+
+    size_t expectedPeer1 = 0;
+    size_t expectedPeer2 = 0;
+    for (size_t i = 0; i < kNumSessions; i++)
+    {
+        auto found = connections.FindSecureSessionByLocalKey(localSessionIds[i]);
+        NL_TEST_ASSERT(inSuite, found.HasValue() == sessions[i].HasValue());
+        if (sessions[i].HasValue() && i % 2 == 0)
+        {
+            ((i % 4 == 0) ? expectedPeer1 : expectedPeer2)++;
+        }
+    }
+    NL_TEST_ASSERT(inSuite, countPeerSessions(kCasePeer1NodeId) == expectedPeer1);
+    NL_TEST_ASSERT(inSuite, countPeerSessions(kCasePeer2NodeId) == expectedPeer2);
+
+    // New sessions reuse free slots without colliding with the remaining session IDs.
+    for (size_t i = 0; i < kNumSessions; i += 3)
+    {
+        sessions[i] = connections.CreateNewSecureSession(SecureSession::Type::kPASE, ScopedNodeId());
+        NL_TEST_ASSERT(inSuite, sessions[i].HasValue());
+        localSessionIds[i] = sessions[i].Value()->AsSecureSession()->GetLocalSessionId();
+    }
+    for (size_t i = 0; i < kNumSessions; i++)
+    {
+        for (size_t j = 0; j < i; j++)
+        {
+            NL_TEST_ASSERT(inSuite, localSessionIds[i] != localSessionIds[j]);
+        }
+        auto found = connections.FindSecureSessionByLocalKey(localSessionIds[i]);
+        NL_TEST_ASSERT(inSuite, found.HasValue() && found.Value() == sessions[i].Value());
+    }
+
+    // A PASE session that adopts a fabric moves to its new peer in the index.
+    SecureSession * pase               = sessions[0].Value()->AsSecureSession();
+    const ScopedNodeId kPasePeer       = ScopedNodeId(NodeIdFromPAKEKeyId(kDefaultCommissioningPasscodeId), kUndefinedFabricIndex);
+    const ScopedNodeId kPaseFabricPeer = ScopedNodeId(kPasePeer.GetNodeId(), kFabricIndex);
+    auto findPeer                      = [&connections](const ScopedNodeId & peer, SecureSession * target) {
+        bool found = false;
+        connections.ForEachSessionWithPeer(peer, [&found, target](auto session) {
+            found = (session == target);
+            return found ? Loop::Break : Loop::Continue;
+        });
+        return found;
+    };
+    pase->Activate(ScopedNodeId(), kPasePeer, CATValues(), 1, kConfig);
+    NL_TEST_ASSERT(inSuite, findPeer(kPasePeer, pase));
+    NL_TEST_ASSERT(inSuite, pase->AdoptFabricIndex(kFabricIndex) == CHIP_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !findPeer(kPasePeer, pase));
+    NL_TEST_ASSERT(inSuite, findPeer(kPaseFabricPeer, pase));
+
+    for (auto & session : sessions)
+    {
+        if (session.HasValue() && session.Value()->AsSecureSession()->IsActiveSession())
+        {
+            session.Value()->AsSecureSession()->MarkForEviction();
+        }
+        session.ClearValue();
+    }
+    NL_TEST_ASSERT(inSuite, countPeerSessions(kCasePeer1NodeId) == 0);
+    NL_TEST_ASSERT(inSuite, countPeerSessions(kCasePeer2NodeId) == 0);
+}
+
 struct ExpiredCallInfo
 {
     int callCount                   = 0;
@@ -158,6 +277,7 @@ static const nlTest sTests[] =
 {
     NL_TEST_DEF("BasicFunctionality", TestBasicFunctionality),
     NL_TEST_DEF("FindByKeyId", TestFindByKeyId),
+    NL_TEST_DEF("Indexes", TestIndexes),
     NL_TEST_SENTINEL()
 };
 // clang-format on